@@ -0,0 +1,2425 @@
+/*
+*********************************************************************************************************
+*                                            EXAMPLE CODE
+*
+*               This file is provided as an example on how to use Micrium products.
+*
+*               Please feel free to use any application code labeled as 'EXAMPLE CODE' in
+*               your application products.  Example code may be used as is, in whole or in
+*               part, or may be used as a reference only. This file can be modified as
+*               required to meet the end-product requirements.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                      USB HOST BENCHMARK SUITE
+*
+*                                     SIMULATED HOST CONTROLLER
+*
+* Filename : app_usbh_bench.c
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) The benchmarks run against three emulated devices connected to the simulated host
+*                controller: a bulk-only mass storage RAM disk on root port 1, a boot mouse on root port 2
+*                and a USB Attached SCSI RAM disk on root port 3.
+*
+*                (a) 'ctrl_rx'      USBH_CtrlRx() of the device descriptor.
+*                (b) 'bulk_rx'      USBH_BulkRx() / USBH_BulkTx() of the data stage of a SCSI READ(10) /
+*                    'bulk_tx'      WRITE(10) command, issued directly on the mass storage endpoints.
+*                                   Only the data stage is timed.
+*                (c) 'async_urb'    Chain of SCSI TEST UNIT READY commands issued with USBH_BulkTxAsync()
+*                                   and USBH_BulkRxAsync(), each URB being submitted from the completion
+*                                   callback of the previous one, through USBH_AsyncTask().
+*                (d) 'hid_report'   Input report supplied by the emulated mouse until its delivery to the
+*                                   callback registered with USBH_HID_RegRxCB(), through
+*                                   USBH_HID_DispatchReport(), and its decoding by the callback with
+*                                   USBH_HID_ReportDecode(). An 'hid_rx' record follows with the statistics
+*                                   of USBH_HID_RxStatGet().
+*                    'hid_rx_q'     Same, with the report read from the receive queue with USBH_HID_RxQ_Get(),
+*                                   when USBH_HID_CFG_RX_Q_LEN is not 0.
+*                (e) 'msc_rd'       USBH_MSC_Rd() / USBH_MSC_Wr() of 1 block (IOPS) and 128 blocks (MB/s).
+*                    'msc_wr'
+*                (f) 'msc_rd_async' USBH_MSC_RdAsync() / USBH_MSC_WrAsync() of 1 block and 128 blocks, with
+*                    'msc_wr_async' USBH_MSC_CFG_CMD_Q_LEN commands queued. Each completion queues the next
+*                                   command.
+*                    'msc_coh'      Coherence of the cache with asynchronous commands. A block read ahead by
+*                                   USBH_MSC_Rd() is written with USBH_MSC_WrAsync() and read again, and a block
+*                                   written with USBH_MSC_Wr() is read with USBH_MSC_RdAsync(). Data that does
+*                                   not match the data written counts as an error.
+*                (g) 'msc_rd_seq'   USBH_MSC_Rd() of 1 block at consecutive addresses, as a file system reads
+*                                   a file. Blocks are read ahead when USBH_MSC_CFG_CACHE_EN is DEF_ENABLED.
+*                (h) 'uas_rd'       USBH_UAS_Rd() / USBH_UAS_Wr() of 1 block and 128 blocks.
+*                    'uas_wr'
+*                (i) 'uas_rd_async' USBH_UAS_RdAsync() / USBH_UAS_WrAsync() of 1 block and 128 blocks, with
+*                    'uas_wr_async' USBH_UAS_CFG_CMD_Q_LEN tagged commands outstanding on the device.
+*
+*                The UAS benchmarks only run when APP_USBH_BENCH_CFG_UAS_EN is DEF_ENABLED (see
+*                'app_usbh_bench.h  DEFAULT CONFIGURATION  Note #2').
+*
+*            (2) Each result is printed on its own line as a JSON object:
+*
+*                    {"bench":"bulk_rx","xfer_len":4096,"iter":1024,"err_cnt":0,"us_tot":...,
+*                     "us_min":...,"us_avg":...,"us_max":...,"ops_per_s":...,"mb_per_s":...}
+*
+*                'us_*' are per-operation times in microseconds and 'mb_per_s' is in 10^6 octets per
+*                second. A first 'info' record gives the stack version and the simulation parameters; a
+*                last 'sim' record gives the statistics of the simulated host controller.
+*********************************************************************************************************
+*/
+
+#define  APP_USBH_BENCH_MODULE
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+#include  <cpu_core.h>
+#include  <lib_mem.h>
+#include  <app_usbh.h>
+#include  <usbh_core.h>
+#include  <usbh_msc.h>
+#include  <usbh_hid.h>
+#include  <usbh_hcd_sim.h>
+#include  <bsp_usbh_sim.h>
+#include  "app_usbh_bench.h"
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+#include  <usbh_uas.h>
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_USBH_BENCH_BLK_SIZE                          512u
+#define  APP_USBH_BENCH_BUF_LEN                         65536u
+#define  APP_USBH_BENCH_MSC_BLK_NBR_MAX      (APP_USBH_BENCH_BUF_LEN / APP_USBH_BENCH_BLK_SIZE)
+
+#define  APP_USBH_BENCH_CONN_TIMEOUT_MS                  5000u
+#define  APP_USBH_BENCH_XFER_TIMEOUT_MS                  5000u
+
+#define  APP_USBH_BENCH_PORT_MSC                            1u
+#define  APP_USBH_BENCH_PORT_HID                            2u
+#define  APP_USBH_BENCH_PORT_UAS                            3u
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+#define  APP_USBH_BENCH_DEV_NBR                             3u
+#else
+#define  APP_USBH_BENCH_DEV_NBR                             2u
+#endif
+
+#define  APP_USBH_BENCH_HID_USAGE_X                0x00010030u  /* Generic desktop X usage.                             */
+
+                                                                /* ---------------- BULK-ONLY TRANSPORT --------------- */
+#define  APP_USBH_BENCH_CBW_LEN                            31u
+#define  APP_USBH_BENCH_CSW_LEN                            13u
+#define  APP_USBH_BENCH_CBW_SIG                    0x43425355u
+#define  APP_USBH_BENCH_CBW_FLAGS_IN                     0x80u
+
+#define  APP_USBH_BENCH_SCSI_TEST_UNIT_READY             0x00u
+#define  APP_USBH_BENCH_SCSI_READ_10                     0x28u
+#define  APP_USBH_BENCH_SCSI_WRITE_10                    0x2Au
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL CONSTANTS
+*********************************************************************************************************
+*/
+
+static  const  CPU_INT32U  App_USBH_Bench_BulkLenTbl[] = {     /* Buf sizes of bulk benchmarks.                        */
+      512u,
+     4096u,
+    16384u,
+    65536u
+};
+
+
+/*
+*********************************************************************************************************
+*                                          LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_usbh_bench_result {
+    CPU_INT32U  Iter;                                           /* Nbr of operations.                                   */
+    CPU_INT32U  ErrCnt;                                         /* Nbr of failed operations.                            */
+    CPU_INT64U  OctetCnt;                                       /* Nbr of data octets xfer'd.                           */
+    CPU_INT64U  TotUs;                                          /* Time of all operations, in us.                       */
+    CPU_INT32U  MinUs;                                          /* Time of fastest operation, in us.                    */
+    CPU_INT32U  MaxUs;                                          /* Time of slowest operation, in us.                    */
+} APP_USBH_BENCH_RESULT;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  USBH_STK               App_USBH_Bench_AsyncTaskStk[USBH_CFG_ASYNC_TASK_NBR][USBH_OS_CFG_ASYNC_TASK_STK_SIZE];
+static  USBH_STK               App_USBH_Bench_HubTaskStk[USBH_OS_CFG_HUB_TASK_STK_SIZE];
+
+static  USBH_KERNEL_TASK_INFO  App_USBH_Bench_AsyncTaskInfo[USBH_CFG_ASYNC_TASK_NBR] = {
+    {
+        USBH_OS_CFG_ASYNC_TASK_PRIO,
+        App_USBH_Bench_AsyncTaskStk[0],
+        USBH_OS_CFG_ASYNC_TASK_STK_SIZE
+    },
+#if (USBH_CFG_ASYNC_TASK_NBR > 1u)
+    {
+        USBH_OS_CFG_ASYNC_TASK_PRIO + 1u,
+        App_USBH_Bench_AsyncTaskStk[1],
+        USBH_OS_CFG_ASYNC_TASK_STK_SIZE
+    },
+#endif
+#if (USBH_CFG_ASYNC_TASK_NBR > 2u)
+    {
+        USBH_OS_CFG_ASYNC_TASK_PRIO + 2u,
+        App_USBH_Bench_AsyncTaskStk[2],
+        USBH_OS_CFG_ASYNC_TASK_STK_SIZE
+    },
+#endif
+};
+
+static  USBH_KERNEL_TASK_INFO  App_USBH_Bench_HubTaskInfo = {
+    USBH_OS_CFG_HUB_TASK_PRIO,
+    App_USBH_Bench_HubTaskStk,
+    USBH_OS_CFG_HUB_TASK_STK_SIZE
+};
+
+static  USBH_HC_CFG            App_USBH_Bench_HC_Cfg = {
+    (CPU_ADDR)0u,                                               /* No HC reg's.                                         */
+    (CPU_ADDR)0u,                                               /* No dedicated mem.                                    */
+              0u,
+              DEF_ENABLED,                                      /* HC accesses sys mem directly.                        */
+              APP_USBH_BENCH_BUF_LEN,
+              4u,
+              4u,
+              0u,
+    (CPU_ADDR)0u,
+              0u,
+              4u
+};
+
+                                                                /* ----------------- EMULATED DEVICES ----------------- */
+static  USBH_SIM_MSC           App_USBH_Bench_SimMSC;
+static  USBH_SIM_HID           App_USBH_Bench_SimHID;
+static  CPU_INT08U             App_USBH_Bench_Disk[APP_USBH_BENCH_CFG_MSC_BLK_NBR * APP_USBH_BENCH_BLK_SIZE];
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+static  USBH_SIM_UAS           App_USBH_Bench_SimUAS;
+static  CPU_INT08U             App_USBH_Bench_UAS_Disk[APP_USBH_BENCH_CFG_MSC_BLK_NBR * APP_USBH_BENCH_BLK_SIZE];
+#endif
+
+                                                                /* ------------------ CLASS DEVICES ------------------- */
+static  CPU_INT08U             App_USBH_Bench_HC_Nbr;
+static  USBH_MSC_DEV          *App_USBH_Bench_MSC_DevPtr;
+static  USBH_HID_DEV          *App_USBH_Bench_HID_DevPtr;
+static  USBH_HSEM              App_USBH_Bench_ConnSem;
+static  USBH_HSEM              App_USBH_Bench_DisconnSem;
+static  CPU_INT64U             App_USBH_Bench_EnumUs;
+static  CPU_INT32U             App_USBH_Bench_HID_PollUs;
+
+                                                                /* ------------------- XFER BUFFERS ------------------- */
+static  CPU_INT08U             App_USBH_Bench_Buf[APP_USBH_BENCH_BUF_LEN];
+static  CPU_INT08U             App_USBH_Bench_CBW[APP_USBH_BENCH_CBW_LEN];
+static  CPU_INT08U             App_USBH_Bench_CSW[APP_USBH_BENCH_CSW_LEN];
+static  CPU_INT32U             App_USBH_Bench_Tag;
+
+                                                                /* ------------------- ASYNC CHAIN -------------------- */
+static  USBH_HSEM              App_USBH_Bench_AsyncSem;
+static  CPU_INT32U             App_USBH_Bench_AsyncCnt;
+static  USBH_ERR               App_USBH_Bench_AsyncErr;
+
+                                                                /* -------------------- HID REPORTS ------------------- */
+static  USBH_HSEM              App_USBH_Bench_HID_Sem;
+static  CPU_INT32S             App_USBH_Bench_HID_PosX;
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+                                                                /* ------------------ ASYNC MSC CMDS ------------------ */
+static  CPU_BOOLEAN            App_USBH_Bench_MSC_AsyncDirIn;
+static  CPU_INT16U             App_USBH_Bench_MSC_AsyncBlkNbr;
+static  CPU_INT32U             App_USBH_Bench_MSC_AsyncSubmitCnt;
+static  CPU_INT32U             App_USBH_Bench_MSC_AsyncCmplCnt;
+static  CPU_INT32U             App_USBH_Bench_MSC_AsyncErrCnt;
+static  CPU_BOOLEAN            App_USBH_Bench_MSC_AsyncDone;
+#endif
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+                                                                /* -------------------- UAS DEVICE -------------------- */
+static  USBH_UAS_DEV          *App_USBH_Bench_UAS_DevPtr;
+                                                                /* ------------------ ASYNC UAS CMDS ------------------ */
+static  CPU_BOOLEAN            App_USBH_Bench_UAS_AsyncDirIn;
+static  CPU_INT16U             App_USBH_Bench_UAS_AsyncBlkNbr;
+static  CPU_INT32U             App_USBH_Bench_UAS_AsyncSubmitCnt;
+static  CPU_INT32U             App_USBH_Bench_UAS_AsyncCmplCnt;
+static  CPU_INT32U             App_USBH_Bench_UAS_AsyncErrCnt;
+static  CPU_BOOLEAN            App_USBH_Bench_UAS_AsyncDone;
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  USBH_ERR    App_USBH_Bench_Setup         (void);
+
+static  USBH_ERR    App_USBH_Bench_CtrlRx        (void);
+
+static  USBH_ERR    App_USBH_Bench_Bulk          (CPU_BOOLEAN             dir_in,
+                                                  CPU_INT32U              xfer_len);
+
+static  USBH_ERR    App_USBH_Bench_Async         (void);
+
+static  USBH_ERR    App_USBH_Bench_HID           (void);
+
+static  USBH_ERR    App_USBH_Bench_Reconn        (void);
+
+static  USBH_ERR    App_USBH_Bench_MSC           (CPU_BOOLEAN             dir_in,
+                                                  CPU_INT16U              nbr_blks);
+
+static  USBH_ERR    App_USBH_Bench_MSC_Seq       (void);
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR    App_USBH_Bench_MSC_Async     (CPU_BOOLEAN             dir_in,
+                                                  CPU_INT16U              nbr_blks);
+
+static  CPU_BOOLEAN App_USBH_Bench_MSC_AsyncNxt  (CPU_BOOLEAN             cmpl,
+                                                  USBH_ERR                err);
+
+static  void        App_USBH_Bench_MSC_AsyncCmpl (USBH_MSC_DEV           *p_msc_dev,
+                                                  void                   *p_buf,
+                                                  CPU_INT32U              buf_len,
+                                                  CPU_INT32U              xfer_len,
+                                                  void                   *p_arg,
+                                                  USBH_ERR                err);
+
+static  USBH_ERR    App_USBH_Bench_MSC_Coh       (void);
+
+static  USBH_ERR    App_USBH_Bench_MSC_CohXfer   (CPU_BOOLEAN             dir_in,
+                                                  CPU_INT32U              lba,
+                                                  CPU_INT08U             *p_buf);
+
+static  void        App_USBH_Bench_MSC_CohCmpl   (USBH_MSC_DEV           *p_msc_dev,
+                                                  void                   *p_buf,
+                                                  CPU_INT32U              buf_len,
+                                                  CPU_INT32U              xfer_len,
+                                                  void                   *p_arg,
+                                                  USBH_ERR                err);
+#endif
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+static  USBH_ERR    App_USBH_Bench_UAS           (CPU_BOOLEAN             dir_in,
+                                                  CPU_INT16U              nbr_blks);
+
+static  USBH_ERR    App_USBH_Bench_UAS_Async     (CPU_BOOLEAN             dir_in,
+                                                  CPU_INT16U              nbr_blks);
+
+static  CPU_BOOLEAN App_USBH_Bench_UAS_AsyncNxt  (CPU_BOOLEAN             cmpl,
+                                                  USBH_ERR                err);
+
+static  void        App_USBH_Bench_UAS_AsyncCmpl (USBH_UAS_DEV           *p_uas_dev,
+                                                  void                   *p_buf,
+                                                  CPU_INT32U              buf_len,
+                                                  CPU_INT32U              xfer_len,
+                                                  void                   *p_arg,
+                                                  USBH_ERR                err);
+#endif
+
+static  void        App_USBH_Bench_SimStatPrint  (void);
+
+static  void        App_USBH_Bench_ClassNotify   (void                   *p_class_dev,
+                                                  CPU_INT08U              is_conn,
+                                                  void                   *p_ctx);
+
+static  void        App_USBH_Bench_AsyncTxCmpl   (USBH_EP                *p_ep,
+                                                  void                   *p_buf,
+                                                  CPU_INT32U              buf_len,
+                                                  CPU_INT32U              xfer_len,
+                                                  void                   *p_arg,
+                                                  USBH_ERR                err);
+
+static  void        App_USBH_Bench_AsyncRxCmpl   (USBH_EP                *p_ep,
+                                                  void                   *p_buf,
+                                                  CPU_INT32U              buf_len,
+                                                  CPU_INT32U              xfer_len,
+                                                  void                   *p_arg,
+                                                  USBH_ERR                err);
+
+static  void        App_USBH_Bench_HID_RxCB      (void                   *p_arg,
+                                                  void                   *p_buf,
+                                                  CPU_INT08U              buf_len,
+                                                  USBH_ERR                err);
+
+static  USBH_ERR    App_USBH_Bench_BOT_Cmd       (CPU_INT08U              op_code,
+                                                  CPU_INT32U              lba,
+                                                  CPU_INT32U              xfer_len,
+                                                  void                   *p_buf,
+                                                  CPU_INT64U             *p_data_us);
+
+static  void        App_USBH_Bench_CBW_Fmt       (CPU_INT08U              op_code,
+                                                  CPU_INT32U              lba,
+                                                  CPU_INT32U              xfer_len);
+
+static  void        App_USBH_Bench_ResultInit    (APP_USBH_BENCH_RESULT  *p_result);
+
+static  void        App_USBH_Bench_ResultAdd     (APP_USBH_BENCH_RESULT  *p_result,
+                                                  CPU_INT64U              op_us,
+                                                  CPU_INT32U              octets,
+                                                  USBH_ERR                err);
+
+static  void        App_USBH_Bench_ResultPrint   (const  CPU_CHAR        *p_name,
+                                                  CPU_INT32U              xfer_len,
+                                                  APP_USBH_BENCH_RESULT  *p_result);
+
+static  CPU_INT64U  App_USBH_Bench_TimeGet       (void);
+
+
+/*
+*********************************************************************************************************
+*                                     LOCAL CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_ASYNC_TASK_NBR > 3u)
+#error  "USBH_CFG_ASYNC_TASK_NBR               add task info for each async task in 'App_USBH_Bench_AsyncTaskInfo'"
+#endif
+
+#if (USBH_HCD_SIM_CFG_NBR_PORTS < 3u)
+#error  "USBH_HCD_SIM_CFG_NBR_PORTS            illegally #define'd in 'usbh_cfg.h' [MUST be >= 3 for benchmarks]"
+#endif
+
+#if ((CPU_CFG_TS_64_EN  != DEF_ENABLED) || \
+     (CPU_CFG_TS_TMR_EN != DEF_ENABLED))
+#error  "CPU_CFG_TS_64_EN/CPU_CFG_TS_TMR_EN    illegally #define'd in 'cpu_cfg.h' [MUST be DEF_ENABLED for benchmarks]"
+#endif
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           GLOBAL FUNCTION
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        App_USBH_Bench_Run()
+*
+* Description : Initialize the host stack on the simulated host controller, connect the emulated devices
+*               and run all benchmarks.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE,          if all benchmarks ran.
+*               Specific error code,    otherwise.
+*
+* Note(s)     : (1) Individual transfer errors do not stop a benchmark; they are counted in its 'err_cnt'.
+*********************************************************************************************************
+*/
+
+USBH_ERR  App_USBH_Bench_Run (void)
+{
+    USBH_ERR    err;
+    CPU_INT08U  ix;
+
+
+    err = App_USBH_Bench_Setup();
+    if (err != USBH_ERR_NONE) {
+        APP_USBH_BENCH_PRINTF("{\"bench\":\"setup\",\"err\":%u}\n", (unsigned int)err);
+        return (err);
+    }
+
+    APP_USBH_BENCH_PRINTF("{\"bench\":\"info\",\"version\":%u,\"hs\":%u,\"frm_period_us\":%u,\"frm_bw\":%u,"
+                          "\"hid_poll_us\":%u}\n",
+                          (unsigned int)USBH_VersionGet(),
+                          (unsigned int)(USBH_HCD_SIM_CFG_HS_EN == DEF_ENABLED),
+                          (unsigned int)APP_USBH_BENCH_CFG_FRM_PERIOD_US,
+                          (unsigned int)APP_USBH_BENCH_CFG_FRM_BW,
+                          (unsigned int)App_USBH_Bench_HID_PollUs);
+
+    APP_USBH_BENCH_PRINTF("{\"bench\":\"enum\",\"dev_cnt\":%u,\"us_tot\":%llu}\n",
+                          (unsigned int)APP_USBH_BENCH_DEV_NBR,
+                          (unsigned long long)App_USBH_Bench_EnumUs);
+
+    (void)USBH_SimHCD_StatClr(App_USBH_Bench_HC_Nbr);
+
+    err = App_USBH_Bench_CtrlRx();
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    for (ix = 0u; ix < (sizeof(App_USBH_Bench_BulkLenTbl) / sizeof(App_USBH_Bench_BulkLenTbl[0])); ix++) {
+        err = App_USBH_Bench_Bulk(DEF_TRUE,  App_USBH_Bench_BulkLenTbl[ix]);
+        if (err != USBH_ERR_NONE) {
+            return (err);
+        }
+        err = App_USBH_Bench_Bulk(DEF_FALSE, App_USBH_Bench_BulkLenTbl[ix]);
+        if (err != USBH_ERR_NONE) {
+            return (err);
+        }
+    }
+
+    err = App_USBH_Bench_Async();
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = App_USBH_Bench_HID();
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = App_USBH_Bench_MSC(DEF_TRUE,  1u);
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC(DEF_FALSE, 1u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC(DEF_TRUE,  APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC(DEF_FALSE, APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC_Seq();
+    }
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC_Async(DEF_TRUE,  1u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC_Async(DEF_FALSE, 1u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC_Async(DEF_TRUE,  APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC_Async(DEF_FALSE, APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_MSC_Coh();
+    }
+#endif
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS(DEF_TRUE,  1u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS(DEF_FALSE, 1u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS(DEF_TRUE,  APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS(DEF_FALSE, APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS_Async(DEF_TRUE,  1u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS_Async(DEF_FALSE, 1u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS_Async(DEF_TRUE,  APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_UAS_Async(DEF_FALSE, APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+    }
+#endif
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_Reconn();                          /* Must be last: HID dev is re-created.                 */
+    }
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    App_USBH_Bench_SimStatPrint();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTION
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                       App_USBH_Bench_Setup()
+*
+* Description : Initialize the host stack, add the simulated host controller and connect the emulated
+*               devices.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE,              if all devices are ready.
+*               USBH_ERR_DEV_NOT_RESPONDING if a device was not connected in time.
+*               Specific error code,        otherwise.
+*
+* Note(s)     : (1) The UAS class driver is registered before the mass storage class driver, so that it
+*                   selects the UAS alternate setting of the UAS RAM disk (see 'usbh_uas.h  Note #4').
+*
+*               (2) All emulated devices are attached at once, like on a kiosk that boots with its devices
+*                   plugged in. The time until all of them are configured is reported as the 'enum' bench.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_Setup (void)
+{
+    CPU_INT32U  nbr_blks;
+    CPU_INT32U  blk_size;
+    CPU_INT08U  dev_ix;
+    CPU_INT64U  ts;
+    USBH_ERR    err;
+
+
+    err = USBH_Init( App_USBH_Bench_AsyncTaskInfo,
+                    &App_USBH_Bench_HubTaskInfo);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_OS_SemCreate(&App_USBH_Bench_ConnSem, 0u);
+    if (err == USBH_ERR_NONE) {
+        err = USBH_OS_SemCreate(&App_USBH_Bench_DisconnSem, 0u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = USBH_OS_SemCreate(&App_USBH_Bench_AsyncSem, 0u);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = USBH_OS_SemCreate(&App_USBH_Bench_HID_Sem, 0u);
+    }
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+    err = USBH_ClassDrvReg(&USBH_UAS_ClassDrv,                  /* See Note #1.                                         */
+                            App_USBH_Bench_ClassNotify,
+                           (void *)&USBH_UAS_ClassDrv);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+#endif
+
+    err = USBH_ClassDrvReg(&USBH_MSC_ClassDrv,
+                            App_USBH_Bench_ClassNotify,
+                           (void *)&USBH_MSC_ClassDrv);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_ClassDrvReg(&USBH_HID_ClassDrv,
+                            App_USBH_Bench_ClassNotify,
+                           (void *)&USBH_HID_ClassDrv);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    App_USBH_Bench_HC_Nbr = USBH_HC_Add(&App_USBH_Bench_HC_Cfg,
+                                        &USBH_SimHCD_DrvAPI,
+                                        &USBH_SimHCD_RH_API,
+                                        &USBH_DrvBSP_Sim,
+                                        &err);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    (void)USBH_SimHCD_FrmPeriodSet(App_USBH_Bench_HC_Nbr, APP_USBH_BENCH_CFG_FRM_PERIOD_US);
+    (void)USBH_SimHCD_FrmBW_Set(App_USBH_Bench_HC_Nbr, APP_USBH_BENCH_CFG_FRM_BW);
+
+    err = USBH_HC_Start(App_USBH_Bench_HC_Nbr);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* ------------- CONNECT EMULATED DEVICES ------------- */
+    USBH_SimDev_MSC_Init(&App_USBH_Bench_SimMSC,
+                         (USBH_HCD_SIM_CFG_HS_EN == DEF_ENABLED) ? USBH_DEV_SPD_HIGH : USBH_DEV_SPD_FULL,
+                          App_USBH_Bench_Disk,
+                          APP_USBH_BENCH_BLK_SIZE,
+                          APP_USBH_BENCH_CFG_MSC_BLK_NBR,
+                          0u);
+    USBH_SimDev_HID_Init(&App_USBH_Bench_SimHID,
+                          USBH_SIM_HID_TYPE_MOUSE,
+                          DEF_DISABLED,
+                          0u);
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+    USBH_SimDev_UAS_Init(&App_USBH_Bench_SimUAS,
+                         (USBH_HCD_SIM_CFG_HS_EN == DEF_ENABLED) ? USBH_DEV_SPD_HIGH : USBH_DEV_SPD_FULL,
+                          App_USBH_Bench_UAS_Disk,
+                          APP_USBH_BENCH_BLK_SIZE,
+                          APP_USBH_BENCH_CFG_MSC_BLK_NBR,
+                          0u);
+#endif
+
+    ts  = App_USBH_Bench_TimeGet();                             /* See Note #2.                                         */
+    err = USBH_SimHCD_PortConn(App_USBH_Bench_HC_Nbr, APP_USBH_BENCH_PORT_MSC, &App_USBH_Bench_SimMSC.Dev);
+    if (err == USBH_ERR_NONE) {
+        err = USBH_SimHCD_PortConn(App_USBH_Bench_HC_Nbr, APP_USBH_BENCH_PORT_HID, &App_USBH_Bench_SimHID.Dev);
+    }
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+    if (err == USBH_ERR_NONE) {
+        err = USBH_SimHCD_PortConn(App_USBH_Bench_HC_Nbr, APP_USBH_BENCH_PORT_UAS, &App_USBH_Bench_SimUAS.MSC.Dev);
+    }
+#endif
+    for (dev_ix = 0u; (dev_ix < APP_USBH_BENCH_DEV_NBR) && (err == USBH_ERR_NONE); dev_ix++) {
+        err = USBH_OS_SemWait(App_USBH_Bench_ConnSem, APP_USBH_BENCH_CONN_TIMEOUT_MS);
+    }
+    App_USBH_Bench_EnumUs = App_USBH_Bench_TimeGet() - ts;
+    if ((err                       != USBH_ERR_NONE) ||
+        (App_USBH_Bench_MSC_DevPtr == (USBH_MSC_DEV *)0) ||
+        (App_USBH_Bench_HID_DevPtr == (USBH_HID_DEV *)0)) {
+        return (USBH_ERR_DEV_NOT_RESPONDING);
+    }
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+    if (App_USBH_Bench_UAS_DevPtr == (USBH_UAS_DEV *)0) {
+        return (USBH_ERR_DEV_NOT_RESPONDING);
+    }
+#endif
+                                                                /* ---------------- INIT CLASS DEVICES ---------------- */
+    err = USBH_MSC_Init(App_USBH_Bench_MSC_DevPtr, 0u);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_MSC_CapacityRd( App_USBH_Bench_MSC_DevPtr,       /* Read capacity and xfer limits, like a file sys.      */
+                               0u,
+                              &nbr_blks,
+                              &blk_size);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+    if ((nbr_blks != APP_USBH_BENCH_CFG_MSC_BLK_NBR) ||
+        (blk_size != APP_USBH_BENCH_BLK_SIZE)) {
+        return (USBH_ERR_DEV_NOT_RESPONDING);
+    }
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+    err = USBH_UAS_Init(App_USBH_Bench_UAS_DevPtr, 0u);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_UAS_CapacityRd( App_USBH_Bench_UAS_DevPtr,
+                               0u,
+                              &nbr_blks,
+                              &blk_size);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+    if ((nbr_blks != APP_USBH_BENCH_CFG_MSC_BLK_NBR) ||
+        (blk_size != APP_USBH_BENCH_BLK_SIZE)) {
+        return (USBH_ERR_DEV_NOT_RESPONDING);
+    }
+#endif
+
+    err = USBH_HID_IdleSet(App_USBH_Bench_HID_DevPtr, 0u, 0u);  /* Report only on change.                               */
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_HID_Init(App_USBH_Bench_HID_DevPtr);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* Set polling interval before rx starts.               */
+    err = USBH_HID_PollIntervalSet( App_USBH_Bench_HID_DevPtr,
+                                    APP_USBH_BENCH_CFG_HID_POLL_US,
+                                   &App_USBH_Bench_HID_PollUs);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_HID_RegRxCB(App_USBH_Bench_HID_DevPtr,
+                           0u,
+                           App_USBH_Bench_HID_RxCB,
+                           (void *)0);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_USBH_Bench_CtrlRx()
+*
+* Description : Measure the round-trip time of a control IN transfer.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_CtrlRx (void)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             ts;
+    CPU_INT32U             i;
+    CPU_INT16U             len;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    for (i = 0u; i < APP_USBH_BENCH_CFG_CTRL_ITER; i++) {
+        ts  = App_USBH_Bench_TimeGet();
+        len = USBH_CtrlRx(App_USBH_Bench_MSC_DevPtr->DevPtr,
+                          USBH_REQ_GET_DESC,
+                         (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_STD | USBH_REQ_RECIPIENT_DEV),
+                         (USBH_DESC_TYPE_DEV << 8u),
+                          0u,
+                          App_USBH_Bench_Buf,
+                          USBH_LEN_DESC_DEV,
+                          APP_USBH_BENCH_XFER_TIMEOUT_MS,
+                         &err);
+        App_USBH_Bench_ResultAdd(&result, App_USBH_Bench_TimeGet() - ts, len, err);
+    }
+
+    App_USBH_Bench_ResultPrint("ctrl_rx", USBH_LEN_DESC_DEV, &result);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_USBH_Bench_Bulk()
+*
+* Description : Measure the bulk IN or OUT throughput for a buffer size.
+*
+* Argument(s) : dir_in      DEF_TRUE for USBH_BulkRx(), DEF_FALSE for USBH_BulkTx().
+*
+*               xfer_len    Buffer size, multiple of the block size.
+*
+* Return(s)   : USBH_ERR_NONE.
+*
+* Note(s)     : (1) The mass storage class driver is idle during the benchmarks, so its endpoints can be
+*                   used directly.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_Bulk (CPU_BOOLEAN  dir_in,
+                                       CPU_INT32U   xfer_len)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             data_us;
+    CPU_INT32U             iter;
+    CPU_INT32U             i;
+    CPU_INT32U             lba;
+    CPU_INT32U             blk_nbr;
+    CPU_INT08U             op_code;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    iter    = APP_USBH_BENCH_CFG_BULK_TOT_LEN / xfer_len;
+    blk_nbr = xfer_len / APP_USBH_BENCH_BLK_SIZE;
+    op_code = (dir_in == DEF_TRUE) ? APP_USBH_BENCH_SCSI_READ_10 : APP_USBH_BENCH_SCSI_WRITE_10;
+
+    for (i = 0u; i < iter; i++) {                               /* See Note #1.                                         */
+        lba = (i * blk_nbr) % (APP_USBH_BENCH_CFG_MSC_BLK_NBR - APP_USBH_BENCH_MSC_BLK_NBR_MAX);
+        err = App_USBH_Bench_BOT_Cmd(op_code, lba, xfer_len, App_USBH_Bench_Buf, &data_us);
+        App_USBH_Bench_ResultAdd(&result, data_us, xfer_len, err);
+    }
+
+    App_USBH_Bench_ResultPrint((dir_in == DEF_TRUE) ? "bulk_rx" : "bulk_tx", xfer_len, &result);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_USBH_Bench_Async()
+*
+* Description : Measure the turnaround of asynchronous URBs completed by USBH_AsyncTask().
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE,      if the chain completed.
+*               Specific error,     otherwise.
+*
+* Note(s)     : (1) The result counts URBs: each TEST UNIT READY command is made of a CBW and a CSW URB.
+*                   Per-URB times are averaged over the chain.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_Async (void)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             ts;
+    CPU_INT64U             tot_us;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    App_USBH_Bench_AsyncCnt = 0u;
+    App_USBH_Bench_AsyncErr = USBH_ERR_NONE;
+    App_USBH_Bench_CBW_Fmt(APP_USBH_BENCH_SCSI_TEST_UNIT_READY, 0u, 0u);
+
+    ts  = App_USBH_Bench_TimeGet();
+    err = USBH_BulkTxAsync(&App_USBH_Bench_MSC_DevPtr->BulkOutEP,
+                           (void *)App_USBH_Bench_CBW,
+                            APP_USBH_BENCH_CBW_LEN,
+                            App_USBH_Bench_AsyncTxCmpl,
+                           (void *)0);
+    if (err == USBH_ERR_NONE) {
+        err = USBH_OS_SemWait(App_USBH_Bench_AsyncSem,
+                              APP_USBH_BENCH_XFER_TIMEOUT_MS * 10u);
+    }
+    tot_us = App_USBH_Bench_TimeGet() - ts;
+
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_AsyncErr;
+    }
+                                                                /* See Note #1.                                         */
+    result.Iter     = App_USBH_Bench_AsyncCnt * 2u;
+    result.ErrCnt   = (err == USBH_ERR_NONE) ? 0u : 1u;
+    result.OctetCnt = (CPU_INT64U)App_USBH_Bench_AsyncCnt * (APP_USBH_BENCH_CBW_LEN + APP_USBH_BENCH_CSW_LEN);
+    result.TotUs    = tot_us;
+    if (result.Iter != 0u) {
+        result.MinUs = (CPU_INT32U)(tot_us / result.Iter);
+        result.MaxUs = result.MinUs;
+    }
+
+    App_USBH_Bench_ResultPrint("async_urb", APP_USBH_BENCH_CBW_LEN, &result);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_USBH_Bench_HID()
+*
+* Description : Measure the rate of HID input reports dispatched to the application.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE.
+*
+* Note(s)     : (1) Each report is supplied once the previous one has been dispatched, so the time of a
+*                   report covers the interrupt IN transfer, its completion and the dispatch. With a
+*                   free-running controller, the poll of the interrupt endpoint is not delayed by the
+*                   polling interval (see 'usbh_hcd_sim.c  USBH_SimHCD_FrmSkip()').
+*
+*               (2) The reports of 'hid_report' also filled the receive queue. It is emptied first.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_HID (void)
+{
+    APP_USBH_BENCH_RESULT  result;
+    USBH_HID_RX_STAT       stat;
+    CPU_INT08U             report[3];
+    CPU_INT64U             ts;
+    CPU_INT32U             i;
+    USBH_ERR               err;
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    CPU_INT08U             report_rx[3];
+    CPU_INT08U             report_id;
+    CPU_INT08U             len;
+#endif
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    report[0] = 0u;
+    report[2] = 0u;
+    for (i = 0u; i < APP_USBH_BENCH_CFG_HID_ITER; i++) {        /* See Note #1.                                         */
+        report[1] = (CPU_INT08U)i;
+
+        ts  = App_USBH_Bench_TimeGet();
+        err = USBH_SimDev_HID_ReportSet(&App_USBH_Bench_SimHID, report, sizeof(report));
+        if (err == USBH_ERR_NONE) {
+            err = USBH_SimHCD_Wake(App_USBH_Bench_HC_Nbr);
+        }
+        if (err == USBH_ERR_NONE) {
+            err = USBH_OS_SemWait(App_USBH_Bench_HID_Sem, APP_USBH_BENCH_XFER_TIMEOUT_MS);
+        }
+        if ((err                     == USBH_ERR_NONE) &&       /* Check decoded X displacement (signed).               */
+            (App_USBH_Bench_HID_PosX != (CPU_INT32S)(CPU_INT08S)report[1])) {
+            err = USBH_ERR_UNKNOWN;
+        }
+        App_USBH_Bench_ResultAdd(&result, App_USBH_Bench_TimeGet() - ts, sizeof(report), err);
+    }
+
+    App_USBH_Bench_ResultPrint("hid_report", sizeof(report), &result);
+
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    do {                                                        /* See Note #2.                                         */
+        (void)USBH_HID_RxQ_Get(App_USBH_Bench_HID_DevPtr,
+                               &report_id,
+                               report_rx,
+                               sizeof(report_rx),
+                               (CPU_INT32U *)0,
+                               1u,
+                               &err);
+    } while (err == USBH_ERR_NONE);
+
+    App_USBH_Bench_ResultInit(&result);
+
+    for (i = 0u; i < APP_USBH_BENCH_CFG_HID_ITER; i++) {
+        report[1] = (CPU_INT08U)(i + 1u);
+
+        ts  = App_USBH_Bench_TimeGet();
+        err = USBH_SimDev_HID_ReportSet(&App_USBH_Bench_SimHID, report, sizeof(report));
+        if (err == USBH_ERR_NONE) {
+            err = USBH_SimHCD_Wake(App_USBH_Bench_HC_Nbr);
+        }
+        if (err == USBH_ERR_NONE) {
+            len = USBH_HID_RxQ_Get(App_USBH_Bench_HID_DevPtr,
+                                   &report_id,
+                                   report_rx,
+                                   sizeof(report_rx),
+                                   (CPU_INT32U *)0,
+                                   APP_USBH_BENCH_XFER_TIMEOUT_MS,
+                                   &err);
+            if ((err           == USBH_ERR_NONE ) &&            /* Check report read from queue.                        */
+                ((len          != sizeof(report)) ||
+                 (report_rx[1] != report[1]     ))) {
+                err = USBH_ERR_UNKNOWN;
+            }
+        }
+        App_USBH_Bench_ResultAdd(&result, App_USBH_Bench_TimeGet() - ts, sizeof(report), err);
+    }
+
+    App_USBH_Bench_ResultPrint("hid_rx_q", sizeof(report), &result);
+#endif
+
+    err = USBH_HID_RxStatGet(App_USBH_Bench_HID_DevPtr, &stat);
+    if (err == USBH_ERR_NONE) {
+        APP_USBH_BENCH_PRINTF("{\"bench\":\"hid_rx\",\"rx_cnt\":%u,\"drop_cnt\":%u,\"q_ovf_cnt\":%u,\"q_lvl_max\":%u,"
+                              "\"arm_err_cnt\":%u,\"buf_armed_nbr\":%u}\n",
+                              (unsigned int)stat.RxCnt,
+                              (unsigned int)stat.DropCnt,
+                              (unsigned int)stat.Q_OvfCnt,
+                              (unsigned int)stat.Q_LvlMax,
+                              (unsigned int)stat.ArmErrCnt,
+                              (unsigned int)stat.BufArmedNbr);
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_USBH_Bench_Reconn()
+*
+* Description : Measure the time to reconnect the HID device, from its attach to its class notification and
+*               the initialization of its HID class instance.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE,              if the HID device is connected again.
+*               USBH_ERR_DEV_NOT_RESPONDING if the HID device was not connected in time.
+*
+* Note(s)     : (1) The time includes the debounce, reset & reset recovery delays of the hub, which
+*                   dominate with the simulated controller. The enumeration descriptor cache hits are
+*                   reported separately when the cache is enabled, followed by the HID report descriptor
+*                   cache hits.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_Reconn (void)
+{
+    APP_USBH_BENCH_RESULT   result;
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+    USBH_DESC_CACHE_STAT    stat;
+#endif
+    USBH_HID_RD_CACHE_STAT  rd_stat;
+    CPU_INT64U              ts;
+    CPU_INT32U              i;
+    USBH_ERR                err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    for (i = 0u; i < APP_USBH_BENCH_CFG_RECONN_ITER; i++) {
+        err = USBH_SimHCD_PortDisconn(App_USBH_Bench_HC_Nbr, APP_USBH_BENCH_PORT_HID);
+        if (err == USBH_ERR_NONE) {
+            err = USBH_OS_SemWait(App_USBH_Bench_DisconnSem, APP_USBH_BENCH_CONN_TIMEOUT_MS);
+        }
+        if (err != USBH_ERR_NONE) {
+            break;
+        }
+
+        (void)USBH_HID_RefRel(App_USBH_Bench_HID_DevPtr);
+        App_USBH_Bench_HID_DevPtr = (USBH_HID_DEV *)0;
+
+        ts  = App_USBH_Bench_TimeGet();                         /* See Note #1.                                         */
+        err = USBH_SimHCD_PortConn(App_USBH_Bench_HC_Nbr, APP_USBH_BENCH_PORT_HID, &App_USBH_Bench_SimHID.Dev);
+        if (err == USBH_ERR_NONE) {
+            err = USBH_OS_SemWait(App_USBH_Bench_ConnSem, APP_USBH_BENCH_CONN_TIMEOUT_MS);
+        }
+        if (err == USBH_ERR_NONE) {
+            err = USBH_HID_Init(App_USBH_Bench_HID_DevPtr);     /* Report desc is found in HID report desc cache.       */
+        }
+        App_USBH_Bench_ResultAdd(&result, App_USBH_Bench_TimeGet() - ts, 0u, err);
+        if (err != USBH_ERR_NONE) {
+            break;
+        }
+    }
+
+    App_USBH_Bench_ResultPrint("reconn", 0u, &result);
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+    USBH_DescCacheStatGet(&stat);
+    APP_USBH_BENCH_PRINTF("{\"bench\":\"desc_cache\",\"hit_cnt\":%u,\"miss_cnt\":%u,\"invalid_cnt\":%u}\n",
+                          (unsigned int)stat.HitCnt,
+                          (unsigned int)stat.MissCnt,
+                          (unsigned int)stat.InvalidCnt);
+#endif
+
+    USBH_HID_RD_CacheStatGet(&rd_stat);
+    APP_USBH_BENCH_PRINTF("{\"bench\":\"hid_rd_cache\",\"hit_cnt\":%u,\"miss_cnt\":%u,\"evict_cnt\":%u}\n",
+                          (unsigned int)rd_stat.HitCnt,
+                          (unsigned int)rd_stat.MissCnt,
+                          (unsigned int)rd_stat.EvictCnt);
+
+    if (App_USBH_Bench_HID_DevPtr == (USBH_HID_DEV *)0) {
+        return (USBH_ERR_DEV_NOT_RESPONDING);
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_USBH_Bench_MSC()
+*
+* Description : Measure the mass storage class read or write rate for a transfer size.
+*
+* Argument(s) : dir_in      DEF_TRUE for USBH_MSC_Rd(), DEF_FALSE for USBH_MSC_Wr().
+*
+*               nbr_blks    Number of blocks per command.
+*
+* Return(s)   : USBH_ERR_NONE.
+*
+* Note(s)     : (1) Block addresses are spread over the disk with a prime stride.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_MSC (CPU_BOOLEAN  dir_in,
+                                      CPU_INT16U   nbr_blks)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             ts;
+    CPU_INT32U             i;
+    CPU_INT32U             lba;
+    CPU_INT32U             xfer_len;
+    CPU_INT32U             len;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    xfer_len = (CPU_INT32U)nbr_blks * APP_USBH_BENCH_BLK_SIZE;
+    for (i = 0u; i < APP_USBH_BENCH_CFG_MSC_ITER; i++) {
+        lba = (i * 97u) % (APP_USBH_BENCH_CFG_MSC_BLK_NBR - nbr_blks);  /* See Note #1.                              */
+        ts  =  App_USBH_Bench_TimeGet();
+        if (dir_in == DEF_TRUE) {
+            len = USBH_MSC_Rd(App_USBH_Bench_MSC_DevPtr,
+                              0u,
+                              lba,
+                              nbr_blks,
+                              APP_USBH_BENCH_BLK_SIZE,
+                              App_USBH_Bench_Buf,
+                             &err);
+        } else {
+            len = USBH_MSC_Wr(App_USBH_Bench_MSC_DevPtr,
+                              0u,
+                              lba,
+                              nbr_blks,
+                              APP_USBH_BENCH_BLK_SIZE,
+                              App_USBH_Bench_Buf,
+                             &err);
+        }
+        if ((err == USBH_ERR_NONE) &&
+            (len != xfer_len)) {
+            err = USBH_ERR_UNKNOWN;
+        }
+        App_USBH_Bench_ResultAdd(&result, App_USBH_Bench_TimeGet() - ts, len, err);
+    }
+
+    App_USBH_Bench_ResultPrint((dir_in == DEF_TRUE) ? "msc_rd" : "msc_wr", xfer_len, &result);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      App_USBH_Bench_MSC_Seq()
+*
+* Description : Measure the mass storage class read rate of consecutive single blocks.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_MSC_Seq (void)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             ts;
+    CPU_INT32U             i;
+    CPU_INT32U             len;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    for (i = 0u; i < APP_USBH_BENCH_CFG_MSC_ITER; i++) {
+        ts  = App_USBH_Bench_TimeGet();
+        len = USBH_MSC_Rd(App_USBH_Bench_MSC_DevPtr,
+                          0u,
+                          i % APP_USBH_BENCH_CFG_MSC_BLK_NBR,
+                          1u,
+                          APP_USBH_BENCH_BLK_SIZE,
+                          App_USBH_Bench_Buf,
+                         &err);
+        if ((err == USBH_ERR_NONE) &&
+            (len != APP_USBH_BENCH_BLK_SIZE)) {
+            err = USBH_ERR_UNKNOWN;
+        }
+        App_USBH_Bench_ResultAdd(&result, App_USBH_Bench_TimeGet() - ts, len, err);
+    }
+
+    App_USBH_Bench_ResultPrint("msc_rd_seq", APP_USBH_BENCH_BLK_SIZE, &result);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     App_USBH_Bench_MSC_Async()
+*
+* Description : Measure the mass storage class read or write rate with queued asynchronous commands.
+*
+* Argument(s) : dir_in      DEF_TRUE for USBH_MSC_RdAsync(), DEF_FALSE for USBH_MSC_WrAsync().
+*
+*               nbr_blks    Number of blocks per command.
+*
+* Return(s)   : USBH_ERR_NONE,      if all commands completed.
+*               Specific error,     otherwise.
+*
+* Note(s)     : (1) The commands share the transfer buffer; only the rate is measured. Per-command times
+*                   are averaged over the run.
+*
+*               (2) The dirty cached blocks are written back first, so that the commands queued from the
+*                   completions do not write back blocks (see USBH_MSC_RdAsync() Note #4).
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  App_USBH_Bench_MSC_Async (CPU_BOOLEAN  dir_in,
+                                            CPU_INT16U   nbr_blks)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             ts;
+    CPU_INT64U             tot_us;
+    CPU_INT32U             xfer_len;
+    CPU_INT08U             ix;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    App_USBH_Bench_MSC_AsyncDirIn     = dir_in;
+    App_USBH_Bench_MSC_AsyncBlkNbr    = nbr_blks;
+    App_USBH_Bench_MSC_AsyncSubmitCnt = 0u;
+    App_USBH_Bench_MSC_AsyncCmplCnt   = 0u;
+    App_USBH_Bench_MSC_AsyncErrCnt    = 0u;
+    App_USBH_Bench_MSC_AsyncDone      = DEF_FALSE;
+    xfer_len                          = (CPU_INT32U)nbr_blks * APP_USBH_BENCH_BLK_SIZE;
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+    err = USBH_MSC_CacheFlush(App_USBH_Bench_MSC_DevPtr, 0u);   /* See Note #2.                                         */
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+#endif
+
+    ts = App_USBH_Bench_TimeGet();
+    for (ix = 0u; ix < USBH_MSC_CFG_CMD_Q_LEN; ix++) {          /* Fill the cmd Q of the dev.                           */
+        if (App_USBH_Bench_MSC_AsyncNxt(DEF_FALSE, USBH_ERR_NONE) == DEF_TRUE) {
+            (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+        }
+    }
+
+    err    = USBH_OS_SemWait(App_USBH_Bench_AsyncSem,
+                             APP_USBH_BENCH_XFER_TIMEOUT_MS * 10u);
+    tot_us = App_USBH_Bench_TimeGet() - ts;
+
+    result.Iter     = App_USBH_Bench_MSC_AsyncCmplCnt;          /* See Note #1.                                         */
+    result.ErrCnt   = App_USBH_Bench_MSC_AsyncErrCnt;
+    result.OctetCnt = (CPU_INT64U)(result.Iter - result.ErrCnt) * xfer_len;
+    result.TotUs    = tot_us;
+    if (result.Iter != 0u) {
+        result.MinUs = (CPU_INT32U)(tot_us / result.Iter);
+        result.MaxUs = result.MinUs;
+    }
+
+    App_USBH_Bench_ResultPrint((dir_in == DEF_TRUE) ? "msc_rd_async" : "msc_wr_async", xfer_len, &result);
+
+    return (err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_MSC_AsyncNxt()
+*
+* Description : Account for a completed asynchronous command and queue the next one.
+*
+* Argument(s) : cmpl        DEF_TRUE if a command completed, DEF_FALSE to only queue a command.
+*
+*               err         Status of the completed command.
+*
+* Return(s)   : DEF_TRUE,   if the run is over.
+*               DEF_FALSE,  otherwise.
+*
+* Note(s)     : (1) The counters are updated from the benchmark task and from the asynchronous task. A
+*                   command is counted as submitted before it is queued, since it may complete first.
+*
+*               (2) The run stops queuing commands after the first error.
+*
+*               (3) The end of the run is reported once, by the caller that observes the last completion.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  CPU_BOOLEAN  App_USBH_Bench_MSC_AsyncNxt (CPU_BOOLEAN  cmpl,
+                                                  USBH_ERR     err)
+{
+    CPU_BOOLEAN  submit;
+    CPU_BOOLEAN  done;
+    CPU_INT32U   lba;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    if (cmpl == DEF_TRUE) {
+        App_USBH_Bench_MSC_AsyncCmplCnt++;
+        if (err != USBH_ERR_NONE) {
+            App_USBH_Bench_MSC_AsyncErrCnt++;
+        }
+    }
+    submit = ((App_USBH_Bench_MSC_AsyncErrCnt    == 0u) &&      /* See Note #2.                                         */
+              (App_USBH_Bench_MSC_AsyncSubmitCnt <  APP_USBH_BENCH_CFG_MSC_ITER)) ? DEF_TRUE : DEF_FALSE;
+    if (submit == DEF_TRUE) {
+        lba = (App_USBH_Bench_MSC_AsyncSubmitCnt * 97u) %
+              (APP_USBH_BENCH_CFG_MSC_BLK_NBR - App_USBH_Bench_MSC_AsyncBlkNbr);
+        App_USBH_Bench_MSC_AsyncSubmitCnt++;
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (submit == DEF_TRUE) {
+        if (App_USBH_Bench_MSC_AsyncDirIn == DEF_TRUE) {
+            err = USBH_MSC_RdAsync(App_USBH_Bench_MSC_DevPtr,
+                                   0u,
+                                   lba,
+                                   App_USBH_Bench_MSC_AsyncBlkNbr,
+                                   APP_USBH_BENCH_BLK_SIZE,
+                                   App_USBH_Bench_Buf,
+                                   App_USBH_Bench_MSC_AsyncCmpl,
+                                   (void *)0);
+        } else {
+            err = USBH_MSC_WrAsync(App_USBH_Bench_MSC_DevPtr,
+                                   0u,
+                                   lba,
+                                   App_USBH_Bench_MSC_AsyncBlkNbr,
+                                   APP_USBH_BENCH_BLK_SIZE,
+                                   App_USBH_Bench_Buf,
+                                   App_USBH_Bench_MSC_AsyncCmpl,
+                                   (void *)0);
+        }
+    }
+
+    CPU_CRITICAL_ENTER();
+    if ((submit == DEF_TRUE) &&
+        (err    != USBH_ERR_NONE)) {                            /* Count a failed submission as a failed cmd.           */
+        App_USBH_Bench_MSC_AsyncCmplCnt++;
+        App_USBH_Bench_MSC_AsyncErrCnt++;
+        submit = DEF_FALSE;
+    }
+    done = DEF_FALSE;
+    if ((submit                          == DEF_FALSE)                         &&
+        (App_USBH_Bench_MSC_AsyncDone    == DEF_FALSE)                         &&
+        (App_USBH_Bench_MSC_AsyncCmplCnt == App_USBH_Bench_MSC_AsyncSubmitCnt)) {
+        App_USBH_Bench_MSC_AsyncDone = DEF_TRUE;                /* See Note #3.                                         */
+        done                         = DEF_TRUE;
+    }
+    CPU_CRITICAL_EXIT();
+
+    return (done);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                   App_USBH_Bench_MSC_AsyncCmpl()
+*
+* Description : Asynchronous mass storage command completed; queue the next one or end the run.
+*
+* Argument(s) : p_msc_dev   Pointer to MSC device.
+*
+*               p_buf       Pointer to data buffer.
+*
+*               buf_len     Length of data buffer.
+*
+*               xfer_len    Number of octets transferred.
+*
+*               p_arg       Unused.
+*
+*               err         Command status.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  App_USBH_Bench_MSC_AsyncCmpl (USBH_MSC_DEV  *p_msc_dev,
+                                            void          *p_buf,
+                                            CPU_INT32U     buf_len,
+                                            CPU_INT32U     xfer_len,
+                                            void          *p_arg,
+                                            USBH_ERR       err)
+{
+    (void)p_msc_dev;
+    (void)p_buf;
+    (void)p_arg;
+
+    if ((err      == USBH_ERR_NONE) &&
+        (xfer_len != buf_len)) {
+        err = USBH_ERR_UNKNOWN;
+    }
+
+    if (App_USBH_Bench_MSC_AsyncNxt(DEF_TRUE, err) == DEF_TRUE) {
+        (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      App_USBH_Bench_MSC_Coh()
+*
+* Description : Check that asynchronous mass storage commands see and leave coherent cached data.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE.
+*
+* Note(s)     : (1) The second of two consecutive reads is sequential: the blocks that follow it are read
+*                   ahead into the cache when USBH_MSC_CFG_CACHE_EN is DEF_ENABLED.
+*
+*               (2) The block written asynchronously was read ahead; a stale cached copy would be returned
+*                   by the following read.
+*
+*               (3) The block written synchronously stays dirty in the cache; the asynchronous read must
+*                   return it.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  App_USBH_Bench_MSC_Coh (void)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT08U            *p_wr;
+    CPU_INT08U            *p_rd;
+    CPU_INT64U             ts;
+    CPU_INT32U             i;
+    CPU_INT32U             lba;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    p_wr = &App_USBH_Bench_Buf[0u];
+    p_rd = &App_USBH_Bench_Buf[APP_USBH_BENCH_BLK_SIZE];
+
+    for (i = 0u; i < APP_USBH_BENCH_CFG_MSC_ITER; i++) {
+        lba = (i * 97u) % (APP_USBH_BENCH_CFG_MSC_BLK_NBR - 4u);
+        ts  =  App_USBH_Bench_TimeGet();
+                                                                /* See Note #1.                                         */
+        (void)USBH_MSC_Rd(App_USBH_Bench_MSC_DevPtr, 0u, lba,      1u, APP_USBH_BENCH_BLK_SIZE, p_rd, &err);
+        if (err == USBH_ERR_NONE) {
+            (void)USBH_MSC_Rd(App_USBH_Bench_MSC_DevPtr, 0u, lba + 1u, 1u, APP_USBH_BENCH_BLK_SIZE, p_rd, &err);
+        }
+
+        if (err == USBH_ERR_NONE) {                             /* See Note #2.                                         */
+            Mem_Set((void *)p_wr, (CPU_INT08U)i, APP_USBH_BENCH_BLK_SIZE);
+            err = App_USBH_Bench_MSC_CohXfer(DEF_FALSE, lba + 2u, p_wr);
+        }
+        if (err == USBH_ERR_NONE) {
+            (void)USBH_MSC_Rd(App_USBH_Bench_MSC_DevPtr, 0u, lba + 2u, 1u, APP_USBH_BENCH_BLK_SIZE, p_rd, &err);
+        }
+        if ((err == USBH_ERR_NONE) &&
+            (Mem_Cmp((void *)p_rd, (void *)p_wr, APP_USBH_BENCH_BLK_SIZE) == DEF_NO)) {
+            err = USBH_ERR_UNKNOWN;
+        }
+
+        if (err == USBH_ERR_NONE) {                             /* See Note #3.                                         */
+            Mem_Set((void *)p_wr, (CPU_INT08U)~i, APP_USBH_BENCH_BLK_SIZE);
+            (void)USBH_MSC_Wr(App_USBH_Bench_MSC_DevPtr, 0u, lba + 3u, 1u, APP_USBH_BENCH_BLK_SIZE, p_wr, &err);
+        }
+        if (err == USBH_ERR_NONE) {
+            err = App_USBH_Bench_MSC_CohXfer(DEF_TRUE, lba + 3u, p_rd);
+        }
+        if ((err == USBH_ERR_NONE) &&
+            (Mem_Cmp((void *)p_rd, (void *)p_wr, APP_USBH_BENCH_BLK_SIZE) == DEF_NO)) {
+            err = USBH_ERR_UNKNOWN;
+        }
+
+        App_USBH_Bench_ResultAdd(&result,
+                                  App_USBH_Bench_TimeGet() - ts,
+                                 (err == USBH_ERR_NONE) ? APP_USBH_BENCH_BLK_SIZE : 0u,
+                                  err);
+    }
+
+    App_USBH_Bench_ResultPrint("msc_coh", APP_USBH_BENCH_BLK_SIZE, &result);
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_MSC_CohXfer()
+*
+* Description : Read or write one block asynchronously and wait for its completion.
+*
+* Argument(s) : dir_in      DEF_TRUE for USBH_MSC_RdAsync(), DEF_FALSE for USBH_MSC_WrAsync().
+*
+*               lba         Block address.
+*
+*               p_buf       Pointer to data buffer.
+*
+* Return(s)   : USBH_ERR_NONE,      if the block was transferred.
+*               Specific error,     otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  App_USBH_Bench_MSC_CohXfer (CPU_BOOLEAN   dir_in,
+                                              CPU_INT32U    lba,
+                                              CPU_INT08U   *p_buf)
+{
+    USBH_ERR  err;
+
+
+    App_USBH_Bench_AsyncErr = USBH_ERR_NONE;
+
+    if (dir_in == DEF_TRUE) {
+        err = USBH_MSC_RdAsync(App_USBH_Bench_MSC_DevPtr,
+                               0u,
+                               lba,
+                               1u,
+                               APP_USBH_BENCH_BLK_SIZE,
+                               (void *)p_buf,
+                               App_USBH_Bench_MSC_CohCmpl,
+                               (void *)0);
+    } else {
+        err = USBH_MSC_WrAsync(App_USBH_Bench_MSC_DevPtr,
+                               0u,
+                               lba,
+                               1u,
+                               APP_USBH_BENCH_BLK_SIZE,
+                               (void *)p_buf,
+                               App_USBH_Bench_MSC_CohCmpl,
+                               (void *)0);
+    }
+
+    if (err == USBH_ERR_NONE) {
+        err = USBH_OS_SemWait(App_USBH_Bench_AsyncSem,
+                              APP_USBH_BENCH_XFER_TIMEOUT_MS);
+    }
+    if (err == USBH_ERR_NONE) {
+        err = App_USBH_Bench_AsyncErr;
+    }
+
+    return (err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_MSC_CohCmpl()
+*
+* Description : Asynchronous block transfer of the coherence check completed.
+*
+* Argument(s) : p_msc_dev   Pointer to MSC device.
+*
+*               p_buf       Pointer to data buffer.
+*
+*               buf_len     Length of data buffer.
+*
+*               xfer_len    Number of octets transferred.
+*
+*               p_arg       Unused.
+*
+*               err         Command status.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  App_USBH_Bench_MSC_CohCmpl (USBH_MSC_DEV  *p_msc_dev,
+                                          void          *p_buf,
+                                          CPU_INT32U     buf_len,
+                                          CPU_INT32U     xfer_len,
+                                          void          *p_arg,
+                                          USBH_ERR       err)
+{
+    (void)p_msc_dev;
+    (void)p_buf;
+    (void)p_arg;
+
+    if ((err      == USBH_ERR_NONE) &&
+        (xfer_len != buf_len)) {
+        err = USBH_ERR_UNKNOWN;
+    }
+
+    App_USBH_Bench_AsyncErr = err;
+    (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        App_USBH_Bench_UAS()
+*
+* Description : Measure the USB Attached SCSI read or write rate for a transfer size.
+*
+* Argument(s) : dir_in      DEF_TRUE for USBH_UAS_Rd(), DEF_FALSE for USBH_UAS_Wr().
+*
+*               nbr_blks    Number of blocks per command.
+*
+* Return(s)   : USBH_ERR_NONE.
+*
+* Note(s)     : (1) See App_USBH_Bench_MSC() Note #1.
+*********************************************************************************************************
+*/
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+static  USBH_ERR  App_USBH_Bench_UAS (CPU_BOOLEAN  dir_in,
+                                      CPU_INT16U   nbr_blks)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             ts;
+    CPU_INT32U             i;
+    CPU_INT32U             lba;
+    CPU_INT32U             xfer_len;
+    CPU_INT32U             len;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    xfer_len = (CPU_INT32U)nbr_blks * APP_USBH_BENCH_BLK_SIZE;
+    for (i = 0u; i < APP_USBH_BENCH_CFG_MSC_ITER; i++) {
+        lba = (i * 97u) % (APP_USBH_BENCH_CFG_MSC_BLK_NBR - nbr_blks);  /* See Note #1.                              */
+        ts  =  App_USBH_Bench_TimeGet();
+        if (dir_in == DEF_TRUE) {
+            len = USBH_UAS_Rd(App_USBH_Bench_UAS_DevPtr,
+                              0u,
+                              lba,
+                              nbr_blks,
+                              APP_USBH_BENCH_BLK_SIZE,
+                              App_USBH_Bench_Buf,
+                             &err);
+        } else {
+            len = USBH_UAS_Wr(App_USBH_Bench_UAS_DevPtr,
+                              0u,
+                              lba,
+                              nbr_blks,
+                              APP_USBH_BENCH_BLK_SIZE,
+                              App_USBH_Bench_Buf,
+                             &err);
+        }
+        if ((err == USBH_ERR_NONE) &&
+            (len != xfer_len)) {
+            err = USBH_ERR_UNKNOWN;
+        }
+        App_USBH_Bench_ResultAdd(&result, App_USBH_Bench_TimeGet() - ts, len, err);
+    }
+
+    App_USBH_Bench_ResultPrint((dir_in == DEF_TRUE) ? "uas_rd" : "uas_wr", xfer_len, &result);
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                     App_USBH_Bench_UAS_Async()
+*
+* Description : Measure the USB Attached SCSI read or write rate with tagged asynchronous commands.
+*
+* Argument(s) : dir_in      DEF_TRUE for USBH_UAS_RdAsync(), DEF_FALSE for USBH_UAS_WrAsync().
+*
+*               nbr_blks    Number of blocks per command.
+*
+* Return(s)   : USBH_ERR_NONE,      if all commands completed.
+*               Specific error,     otherwise.
+*
+* Note(s)     : (1) See App_USBH_Bench_MSC_Async() Note #1.
+*********************************************************************************************************
+*/
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+static  USBH_ERR  App_USBH_Bench_UAS_Async (CPU_BOOLEAN  dir_in,
+                                            CPU_INT16U   nbr_blks)
+{
+    APP_USBH_BENCH_RESULT  result;
+    CPU_INT64U             ts;
+    CPU_INT64U             tot_us;
+    CPU_INT32U             xfer_len;
+    CPU_INT08U             ix;
+    USBH_ERR               err;
+
+
+    App_USBH_Bench_ResultInit(&result);
+
+    App_USBH_Bench_UAS_AsyncDirIn     = dir_in;
+    App_USBH_Bench_UAS_AsyncBlkNbr    = nbr_blks;
+    App_USBH_Bench_UAS_AsyncSubmitCnt = 0u;
+    App_USBH_Bench_UAS_AsyncCmplCnt   = 0u;
+    App_USBH_Bench_UAS_AsyncErrCnt    = 0u;
+    App_USBH_Bench_UAS_AsyncDone      = DEF_FALSE;
+    xfer_len                          = (CPU_INT32U)nbr_blks * APP_USBH_BENCH_BLK_SIZE;
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+    err = USBH_MSC_CacheFlush(App_USBH_Bench_MSC_DevPtr, 0u);   /* See Note #2.                                         */
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+#endif
+
+    ts = App_USBH_Bench_TimeGet();
+    for (ix = 0u; ix < USBH_UAS_CFG_CMD_Q_LEN; ix++) {          /* Fill the cmd Q of the dev.                           */
+        if (App_USBH_Bench_UAS_AsyncNxt(DEF_FALSE, USBH_ERR_NONE) == DEF_TRUE) {
+            (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+        }
+    }
+
+    err    = USBH_OS_SemWait(App_USBH_Bench_AsyncSem,
+                             APP_USBH_BENCH_XFER_TIMEOUT_MS * 10u);
+    tot_us = App_USBH_Bench_TimeGet() - ts;
+
+    result.Iter     = App_USBH_Bench_UAS_AsyncCmplCnt;          /* See Note #1.                                         */
+    result.ErrCnt   = App_USBH_Bench_UAS_AsyncErrCnt;
+    result.OctetCnt = (CPU_INT64U)(result.Iter - result.ErrCnt) * xfer_len;
+    result.TotUs    = tot_us;
+    if (result.Iter != 0u) {
+        result.MinUs = (CPU_INT32U)(tot_us / result.Iter);
+        result.MaxUs = result.MinUs;
+    }
+
+    App_USBH_Bench_ResultPrint((dir_in == DEF_TRUE) ? "uas_rd_async" : "uas_wr_async", xfer_len, &result);
+
+    return (err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_UAS_AsyncNxt()
+*
+* Description : Account for a completed asynchronous UAS command and issue the next one.
+*
+* Argument(s) : cmpl        DEF_TRUE if a command completed, DEF_FALSE to only issue a command.
+*
+*               err         Status of the completed command.
+*
+* Return(s)   : DEF_TRUE,   if the run is over.
+*               DEF_FALSE,  otherwise.
+*
+* Note(s)     : (1) See App_USBH_Bench_MSC_AsyncNxt() Notes #1, #2 and #3.
+*********************************************************************************************************
+*/
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+static  CPU_BOOLEAN  App_USBH_Bench_UAS_AsyncNxt (CPU_BOOLEAN  cmpl,
+                                                  USBH_ERR     err)
+{
+    CPU_BOOLEAN  submit;
+    CPU_BOOLEAN  done;
+    CPU_INT32U   lba;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    if (cmpl == DEF_TRUE) {
+        App_USBH_Bench_UAS_AsyncCmplCnt++;
+        if (err != USBH_ERR_NONE) {
+            App_USBH_Bench_UAS_AsyncErrCnt++;
+        }
+    }
+    submit = ((App_USBH_Bench_UAS_AsyncErrCnt    == 0u) &&
+              (App_USBH_Bench_UAS_AsyncSubmitCnt <  APP_USBH_BENCH_CFG_MSC_ITER)) ? DEF_TRUE : DEF_FALSE;
+    if (submit == DEF_TRUE) {
+        lba = (App_USBH_Bench_UAS_AsyncSubmitCnt * 97u) %
+              (APP_USBH_BENCH_CFG_MSC_BLK_NBR - App_USBH_Bench_UAS_AsyncBlkNbr);
+        App_USBH_Bench_UAS_AsyncSubmitCnt++;
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (submit == DEF_TRUE) {
+        if (App_USBH_Bench_UAS_AsyncDirIn == DEF_TRUE) {
+            err = USBH_UAS_RdAsync(App_USBH_Bench_UAS_DevPtr,
+                                   0u,
+                                   lba,
+                                   App_USBH_Bench_UAS_AsyncBlkNbr,
+                                   APP_USBH_BENCH_BLK_SIZE,
+                                   App_USBH_Bench_Buf,
+                                   App_USBH_Bench_UAS_AsyncCmpl,
+                                   (void *)0);
+        } else {
+            err = USBH_UAS_WrAsync(App_USBH_Bench_UAS_DevPtr,
+                                   0u,
+                                   lba,
+                                   App_USBH_Bench_UAS_AsyncBlkNbr,
+                                   APP_USBH_BENCH_BLK_SIZE,
+                                   App_USBH_Bench_Buf,
+                                   App_USBH_Bench_UAS_AsyncCmpl,
+                                   (void *)0);
+        }
+    }
+
+    CPU_CRITICAL_ENTER();
+    if ((submit == DEF_TRUE) &&
+        (err    != USBH_ERR_NONE)) {                            /* Count a failed submission as a failed cmd.           */
+        App_USBH_Bench_UAS_AsyncCmplCnt++;
+        App_USBH_Bench_UAS_AsyncErrCnt++;
+        submit = DEF_FALSE;
+    }
+    done = DEF_FALSE;
+    if ((submit                          == DEF_FALSE)                         &&
+        (App_USBH_Bench_UAS_AsyncDone    == DEF_FALSE)                         &&
+        (App_USBH_Bench_UAS_AsyncCmplCnt == App_USBH_Bench_UAS_AsyncSubmitCnt)) {
+        App_USBH_Bench_UAS_AsyncDone = DEF_TRUE;
+        done                         = DEF_TRUE;
+    }
+    CPU_CRITICAL_EXIT();
+
+    return (done);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                   App_USBH_Bench_UAS_AsyncCmpl()
+*
+* Description : Asynchronous UAS command completed; issue the next one or end the run.
+*
+* Argument(s) : p_uas_dev   Pointer to UAS device.
+*
+*               p_buf       Pointer to data buffer.
+*
+*               buf_len     Length of data buffer.
+*
+*               xfer_len    Number of octets transferred.
+*
+*               p_arg       Unused.
+*
+*               err         Command status.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+static  void  App_USBH_Bench_UAS_AsyncCmpl (USBH_UAS_DEV  *p_uas_dev,
+                                            void          *p_buf,
+                                            CPU_INT32U     buf_len,
+                                            CPU_INT32U     xfer_len,
+                                            void          *p_arg,
+                                            USBH_ERR       err)
+{
+    (void)p_uas_dev;
+    (void)p_buf;
+    (void)p_arg;
+
+    if ((err      == USBH_ERR_NONE) &&
+        (xfer_len != buf_len)) {
+        err = USBH_ERR_UNKNOWN;
+    }
+
+    if (App_USBH_Bench_UAS_AsyncNxt(DEF_TRUE, err) == DEF_TRUE) {
+        (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_SimStatPrint()
+*
+* Description : Print the statistics of the simulated host controller.
+*
+* Argument(s) : None.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_SimStatPrint (void)
+{
+    USBH_HCD_SIM_STAT  stat;
+
+
+    if (USBH_SimHCD_StatGet(App_USBH_Bench_HC_Nbr, &stat) != USBH_ERR_NONE) {
+        return;
+    }
+
+    APP_USBH_BENCH_PRINTF("{\"bench\":\"sim\",\"frm_cnt\":%u,\"xact_cnt\":%u,\"nak_cnt\":%u,\"stall_cnt\":%u,"
+                          "\"err_cnt\":%u,\"urb_cnt\":%u,\"octet_cnt\":%llu,\"bw_limit_cnt\":%u}\n",
+                          (unsigned int)stat.FrmCnt,
+                          (unsigned int)stat.XactCnt,
+                          (unsigned int)stat.NakCnt,
+                          (unsigned int)stat.StallCnt,
+                          (unsigned int)stat.ErrCnt,
+                          (unsigned int)stat.URB_Cnt,
+                          (unsigned long long)stat.OctetCnt,
+                          (unsigned int)stat.BW_LimitCnt);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_ClassNotify()
+*
+* Description : Handle device state change notification of the mass storage, UAS and HID class drivers.
+*
+* Argument(s) : p_class_dev     Pointer to class device.
+*
+*               is_conn         Device state.
+*
+*               p_ctx           Pointer to class driver the device belongs to.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_ClassNotify (void        *p_class_dev,
+                                          CPU_INT08U   is_conn,
+                                          void        *p_ctx)
+{
+    if (is_conn != USBH_CLASS_DEV_STATE_CONN) {
+        if (is_conn == USBH_CLASS_DEV_STATE_DISCONN) {
+            (void)USBH_OS_SemPost(App_USBH_Bench_DisconnSem);
+        }
+        return;
+    }
+
+    if (p_ctx == (void *)&USBH_MSC_ClassDrv) {
+        App_USBH_Bench_MSC_DevPtr = (USBH_MSC_DEV *)p_class_dev;
+        (void)USBH_MSC_RefAdd(App_USBH_Bench_MSC_DevPtr);
+#if (APP_USBH_BENCH_CFG_UAS_EN == DEF_ENABLED)
+    } else if (p_ctx == (void *)&USBH_UAS_ClassDrv) {
+        App_USBH_Bench_UAS_DevPtr = (USBH_UAS_DEV *)p_class_dev;
+        (void)USBH_UAS_RefAdd(App_USBH_Bench_UAS_DevPtr);
+#endif
+    } else {
+        App_USBH_Bench_HID_DevPtr = (USBH_HID_DEV *)p_class_dev;
+        (void)USBH_HID_RefAdd(App_USBH_Bench_HID_DevPtr);
+    }
+
+    (void)USBH_OS_SemPost(App_USBH_Bench_ConnSem);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_AsyncTxCmpl()
+*
+* Description : CBW of the asynchronous chain sent; receive its CSW.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               p_buf       Pointer to CBW.
+*
+*               buf_len     CBW length.
+*
+*               xfer_len    Number of octets sent.
+*
+*               p_arg       Unused.
+*
+*               err         Transfer status.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_AsyncTxCmpl (USBH_EP     *p_ep,
+                                          void        *p_buf,
+                                          CPU_INT32U   buf_len,
+                                          CPU_INT32U   xfer_len,
+                                          void        *p_arg,
+                                          USBH_ERR     err)
+{
+    (void)p_ep;
+    (void)p_buf;
+    (void)buf_len;
+    (void)xfer_len;
+
+    if (err == USBH_ERR_NONE) {
+        err = USBH_BulkRxAsync(&App_USBH_Bench_MSC_DevPtr->BulkInEP,
+                               (void *)App_USBH_Bench_CSW,
+                                APP_USBH_BENCH_CSW_LEN,
+                                App_USBH_Bench_AsyncRxCmpl,
+                                p_arg);
+    }
+
+    if (err != USBH_ERR_NONE) {
+        App_USBH_Bench_AsyncErr = err;
+        (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                    App_USBH_Bench_AsyncRxCmpl()
+*
+* Description : CSW of the asynchronous chain received; send the next CBW or end the chain.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               p_buf       Pointer to CSW.
+*
+*               buf_len     CSW length.
+*
+*               xfer_len    Number of octets received.
+*
+*               p_arg       Unused.
+*
+*               err         Transfer status.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_AsyncRxCmpl (USBH_EP     *p_ep,
+                                          void        *p_buf,
+                                          CPU_INT32U   buf_len,
+                                          CPU_INT32U   xfer_len,
+                                          void        *p_arg,
+                                          USBH_ERR     err)
+{
+    (void)p_ep;
+    (void)p_buf;
+    (void)buf_len;
+
+    if ((err      == USBH_ERR_NONE) &&
+        (xfer_len != APP_USBH_BENCH_CSW_LEN)) {
+        err = USBH_ERR_UNKNOWN;
+    }
+
+    if (err == USBH_ERR_NONE) {
+        App_USBH_Bench_AsyncCnt++;
+        if (App_USBH_Bench_AsyncCnt >= APP_USBH_BENCH_CFG_ASYNC_ITER) {
+            (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+            return;
+        }
+
+        err = USBH_BulkTxAsync(&App_USBH_Bench_MSC_DevPtr->BulkOutEP,
+                               (void *)App_USBH_Bench_CBW,
+                                APP_USBH_BENCH_CBW_LEN,
+                                App_USBH_Bench_AsyncTxCmpl,
+                                p_arg);
+    }
+
+    if (err != USBH_ERR_NONE) {
+        App_USBH_Bench_AsyncErr = err;
+        (void)USBH_OS_SemPost(App_USBH_Bench_AsyncSem);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                      App_USBH_Bench_HID_RxCB()
+*
+* Description : HID input report dispatched to the application.
+*
+* Argument(s) : p_arg       Unused.
+*
+*               p_buf       Pointer to report.
+*
+*               buf_len     Report length.
+*
+*               err         Reception status.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_HID_RxCB (void        *p_arg,
+                                       void        *p_buf,
+                                       CPU_INT08U   buf_len,
+                                       USBH_ERR     err)
+{
+    USBH_HID_USAGE_VAL  usage_val[8];
+    CPU_INT16U          nbr_usage_val;
+    CPU_INT16U          ix;
+
+
+    (void)p_arg;
+
+    if (err != USBH_ERR_NONE) {
+        return;
+    }
+
+    App_USBH_Bench_HID_PosX = -1;
+    nbr_usage_val           =  USBH_HID_ReportDecode(App_USBH_Bench_HID_DevPtr,
+                                                     0u,
+                                                     p_buf,
+                                                     buf_len,
+                                                     usage_val,
+                                                     sizeof(usage_val) / sizeof(usage_val[0]),
+                                                    &err);
+    if (err == USBH_ERR_NONE) {
+        for (ix = 0u; ix < nbr_usage_val; ix++) {
+            if (usage_val[ix].Usage == APP_USBH_BENCH_HID_USAGE_X) {
+                App_USBH_Bench_HID_PosX = usage_val[ix].Val;
+            }
+        }
+    }
+
+    (void)USBH_OS_SemPost(App_USBH_Bench_HID_Sem);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      App_USBH_Bench_BOT_Cmd()
+*
+* Description : Execute a bulk-only transport command directly on the mass storage endpoints.
+*
+* Argument(s) : op_code     SCSI operation code.
+*
+*               lba         Logical block address.
+*
+*               xfer_len    Length of data stage, in octets.
+*
+*               p_buf       Pointer to data buffer.
+*
+*               p_data_us   Variable that will receive the time of the data stage, in us.
+*
+* Return(s)   : USBH_ERR_NONE,      if the command succeeded.
+*               USBH_ERR_UNKNOWN,   if the CSW reports a failure.
+*               Specific error,     otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  App_USBH_Bench_BOT_Cmd (CPU_INT08U   op_code,
+                                          CPU_INT32U   lba,
+                                          CPU_INT32U   xfer_len,
+                                          void        *p_buf,
+                                          CPU_INT64U  *p_data_us)
+{
+    CPU_INT64U  ts;
+    CPU_INT32U  len;
+    USBH_ERR    err;
+
+
+   *p_data_us = 0u;
+
+    App_USBH_Bench_CBW_Fmt(op_code, lba, xfer_len);
+    (void)USBH_BulkTx(&App_USBH_Bench_MSC_DevPtr->BulkOutEP,
+                      (void *)App_USBH_Bench_CBW,
+                       APP_USBH_BENCH_CBW_LEN,
+                       APP_USBH_BENCH_XFER_TIMEOUT_MS,
+                      &err);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    ts = App_USBH_Bench_TimeGet();
+    if (op_code == APP_USBH_BENCH_SCSI_READ_10) {
+        len = USBH_BulkRx(&App_USBH_Bench_MSC_DevPtr->BulkInEP,
+                           p_buf,
+                           xfer_len,
+                           APP_USBH_BENCH_XFER_TIMEOUT_MS,
+                          &err);
+    } else {
+        len = USBH_BulkTx(&App_USBH_Bench_MSC_DevPtr->BulkOutEP,
+                           p_buf,
+                           xfer_len,
+                           APP_USBH_BENCH_XFER_TIMEOUT_MS,
+                          &err);
+    }
+   *p_data_us = App_USBH_Bench_TimeGet() - ts;
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    (void)USBH_BulkRx(&App_USBH_Bench_MSC_DevPtr->BulkInEP,
+                      (void *)App_USBH_Bench_CSW,
+                       APP_USBH_BENCH_CSW_LEN,
+                       APP_USBH_BENCH_XFER_TIMEOUT_MS,
+                      &err);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    if ((len                        != xfer_len) ||
+        (App_USBH_Bench_CSW[12]     != 0u)) {                   /* bCSWStatus.                                          */
+        return (USBH_ERR_UNKNOWN);
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      App_USBH_Bench_CBW_Fmt()
+*
+* Description : Format a command block wrapper with a 10-octet SCSI command.
+*
+* Argument(s) : op_code     SCSI operation code.
+*
+*               lba         Logical block address.
+*
+*               xfer_len    Length of data stage, in octets.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) See 'Universal Serial Bus Mass Storage Class Bulk-Only Transport', Section 5.1.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_CBW_Fmt (CPU_INT08U  op_code,
+                                      CPU_INT32U  lba,
+                                      CPU_INT32U  xfer_len)
+{
+    CPU_INT08U  *p_cbw;
+    CPU_INT16U   blk_nbr;
+
+
+    p_cbw   = App_USBH_Bench_CBW;
+    blk_nbr = (CPU_INT16U)(xfer_len / APP_USBH_BENCH_BLK_SIZE);
+
+    Mem_Clr((void *)p_cbw, APP_USBH_BENCH_CBW_LEN);
+    App_USBH_Bench_Tag++;
+                                                                /* See Note #1.                                         */
+    MEM_VAL_SET_INT32U_LITTLE(&p_cbw[0], APP_USBH_BENCH_CBW_SIG);
+    MEM_VAL_SET_INT32U_LITTLE(&p_cbw[4], App_USBH_Bench_Tag);
+    MEM_VAL_SET_INT32U_LITTLE(&p_cbw[8], xfer_len);
+    p_cbw[12] = (op_code == APP_USBH_BENCH_SCSI_READ_10) ? APP_USBH_BENCH_CBW_FLAGS_IN : 0u;
+    p_cbw[13] = 0u;                                             /* LUN.                                                 */
+
+    if (op_code == APP_USBH_BENCH_SCSI_TEST_UNIT_READY) {
+        p_cbw[14] = 6u;
+        p_cbw[15] = op_code;
+    } else {
+        p_cbw[14] = 10u;
+        p_cbw[15] = op_code;
+        MEM_VAL_SET_INT32U_BIG(&p_cbw[17], lba);
+        MEM_VAL_SET_INT16U_BIG(&p_cbw[22], blk_nbr);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                     App_USBH_Bench_ResultInit()
+*
+* Description : Initialize a benchmark result.
+*
+* Argument(s) : p_result    Pointer to result.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_ResultInit (APP_USBH_BENCH_RESULT  *p_result)
+{
+    Mem_Clr((void *)p_result, sizeof(APP_USBH_BENCH_RESULT));
+    p_result->MinUs = DEF_INT_32U_MAX_VAL;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      App_USBH_Bench_ResultAdd()
+*
+* Description : Add an operation to a benchmark result.
+*
+* Argument(s) : p_result    Pointer to result.
+*
+*               op_us       Time of operation, in us.
+*
+*               octets      Number of data octets transferred.
+*
+*               err         Status of operation.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_ResultAdd (APP_USBH_BENCH_RESULT  *p_result,
+                                        CPU_INT64U              op_us,
+                                        CPU_INT32U              octets,
+                                        USBH_ERR                err)
+{
+    CPU_INT32U  us;
+
+
+    us = (op_us > DEF_INT_32U_MAX_VAL) ? DEF_INT_32U_MAX_VAL : (CPU_INT32U)op_us;
+
+    p_result->Iter++;
+    p_result->TotUs    += op_us;
+    p_result->OctetCnt += octets;
+    p_result->MinUs     = DEF_MIN(p_result->MinUs, us);
+    p_result->MaxUs     = DEF_MAX(p_result->MaxUs, us);
+    if (err != USBH_ERR_NONE) {
+        p_result->ErrCnt++;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                     App_USBH_Bench_ResultPrint()
+*
+* Description : Print a benchmark result (see 'app_usbh_bench.c  Note #2').
+*
+* Argument(s) : p_name      Benchmark name.
+*
+*               xfer_len    Transfer length of each operation, in octets.
+*
+*               p_result    Pointer to result.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) An octet per microsecond is 1 MB/s: 'mb_per_s' is printed with 3 decimals from the
+*                   number of octets per millisecond.
+*********************************************************************************************************
+*/
+
+static  void  App_USBH_Bench_ResultPrint (const  CPU_CHAR        *p_name,
+                                          CPU_INT32U              xfer_len,
+                                          APP_USBH_BENCH_RESULT  *p_result)
+{
+    CPU_INT64U  tot_us;
+    CPU_INT64U  ops_per_s;
+    CPU_INT64U  kb_per_s;
+    CPU_INT32U  avg_us;
+
+
+    tot_us    = (p_result->TotUs == 0u) ? 1u : p_result->TotUs;
+    ops_per_s = ((CPU_INT64U)p_result->Iter * 1000000u) / tot_us;
+    kb_per_s  = (p_result->OctetCnt * 1000u) / tot_us;          /* See Note #1.                                         */
+    avg_us    = (p_result->Iter == 0u) ? 0u : (CPU_INT32U)(p_result->TotUs / p_result->Iter);
+    if (p_result->Iter == 0u) {
+        p_result->MinUs = 0u;
+    }
+
+    APP_USBH_BENCH_PRINTF("{\"bench\":\"%s\",\"xfer_len\":%u,\"iter\":%u,\"err_cnt\":%u,\"us_tot\":%llu,"
+                          "\"us_min\":%u,\"us_avg\":%u,\"us_max\":%u,\"ops_per_s\":%llu,\"mb_per_s\":%llu.%03u}\n",
+                          p_name,
+                          (unsigned int)xfer_len,
+                          (unsigned int)p_result->Iter,
+                          (unsigned int)p_result->ErrCnt,
+                          (unsigned long long)p_result->TotUs,
+                          (unsigned int)p_result->MinUs,
+                          (unsigned int)avg_us,
+                          (unsigned int)p_result->MaxUs,
+                          (unsigned long long)ops_per_s,
+                          (unsigned long long)(kb_per_s / 1000u),
+                          (unsigned int)(kb_per_s % 1000u));
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_USBH_Bench_TimeGet()
+*
+* Description : Get the current time.
+*
+* Argument(s) : None.
+*
+* Return(s)   : Time, in us.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  App_USBH_Bench_TimeGet (void)
+{
+    return (CPU_TS64_to_uSec(CPU_TS_Get64()));
+}
+
+
+/*
+*********************************************************************************************************
+*                                                  END
+*********************************************************************************************************
+*/
@@ -0,0 +1,191 @@
+/*
+*********************************************************************************************************
+*                                            EXAMPLE CODE
+*
+*               This file is provided as an example on how to use Micrium products.
+*
+*               Please feel free to use any application code labeled as 'EXAMPLE CODE' in
+*               your application products.  Example code may be used as is, in whole or in
+*               part, or may be used as a reference only. This file can be modified as
+*               required to meet the end-product requirements.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                      USB HOST BENCHMARK SUITE
+*
+*                                     SIMULATED HOST CONTROLLER
+*
+* Filename : app_usbh_bench.h
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) The benchmark suite runs the host stack against the simulated host controller and its
+*                emulated devices (see 'HCD/Sim/usbh_hcd_sim.h'). It needs no USB hardware and is meant to
+*                be run on a Linux host with the POSIX OS port.
+*
+*            (2) Each result is printed as one JSON object per line (see 'app_usbh_bench.c  Note #2'), so
+*                that results of two releases can be compared with 'Tools/usbh_bench_cmp.py'.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  APP_USBH_BENCH_MODULE_PRESENT
+#define  APP_USBH_BENCH_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <lib_def.h>
+#include  <app_cfg.h>
+#include  <usbh_cfg.h>
+#include  <usbh_err.h>
+
+
+/*
+*********************************************************************************************************
+*                                               EXTERNS
+*********************************************************************************************************
+*/
+
+#ifdef   APP_USBH_BENCH_MODULE
+#define  APP_USBH_BENCH_EXT
+#else
+#define  APP_USBH_BENCH_EXT  extern
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        DEFAULT CONFIGURATION
+*
+* Note(s) : (1) The benchmarks may be configured from 'app_cfg.h':
+*
+*               (a) APP_USBH_BENCH_CFG_CTRL_ITER        Nbr of control transfers.
+*
+*               (b) APP_USBH_BENCH_CFG_BULK_TOT_LEN     Nbr of octets transferred per bulk buffer size.
+*
+*               (c) APP_USBH_BENCH_CFG_ASYNC_ITER       Nbr of asynchronous commands, of 2 URBs each.
+*
+*               (d) APP_USBH_BENCH_CFG_HID_ITER         Nbr of HID reports.
+*
+*               (e) APP_USBH_BENCH_CFG_MSC_ITER         Nbr of MSC reads and writes per transfer size.
+*
+*               (f) APP_USBH_BENCH_CFG_MSC_BLK_NBR      Nbr of 512-octet blocks of the emulated disk.
+*
+*               (g) APP_USBH_BENCH_CFG_FRM_PERIOD_US    Frame period of the simulated host controller. 0
+*                   APP_USBH_BENCH_CFG_FRM_BW           and unlimited bandwidth measure the stack alone,
+*                                                       without any bus timing (see 'usbh_hcd_sim.h').
+*
+*               (h) APP_USBH_BENCH_CFG_RECONN_ITER      Nbr of disconnections & reconnections of the HID device.
+*
+*               (i) APP_USBH_BENCH_CFG_HID_POLL_US      Polling interval of the HID device, in microseconds. 0
+*                                                       uses the interval of its endpoint descriptor.
+*
+*               (j) APP_USBH_BENCH_PRINTF               Output function of the results.
+*
+*               (k) APP_USBH_BENCH_CFG_UAS_EN           DEF_ENABLED to connect the emulated UAS disk and run
+*                                                       the 'uas_*' benchmarks (see Note #2).
+*
+*           (2) The UAS class driver requires USBH_CFG_MAX_NBR_EPS >= 4 (see 'usbh_uas.h  Note #2'). The
+*               UAS benchmarks are disabled by default when 'usbh_cfg.h' sets fewer endpoints, as the
+*               template does; 'Class/UAS/usbh_uas.c' is then not linked with the program.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_USBH_BENCH_CFG_CTRL_ITER
+#define  APP_USBH_BENCH_CFG_CTRL_ITER                   1000u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_BULK_TOT_LEN
+#define  APP_USBH_BENCH_CFG_BULK_TOT_LEN             4194304u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_ASYNC_ITER
+#define  APP_USBH_BENCH_CFG_ASYNC_ITER                  1000u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_HID_ITER
+#define  APP_USBH_BENCH_CFG_HID_ITER                    1000u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_MSC_ITER
+#define  APP_USBH_BENCH_CFG_MSC_ITER                     500u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_MSC_BLK_NBR
+#define  APP_USBH_BENCH_CFG_MSC_BLK_NBR                 4096u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_FRM_PERIOD_US
+#define  APP_USBH_BENCH_CFG_FRM_PERIOD_US                  0u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_FRM_BW
+#define  APP_USBH_BENCH_CFG_FRM_BW                         0u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_RECONN_ITER
+#define  APP_USBH_BENCH_CFG_RECONN_ITER                   10u
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_HID_POLL_US
+#define  APP_USBH_BENCH_CFG_HID_POLL_US                    0u
+#endif
+
+#ifndef  APP_USBH_BENCH_PRINTF
+#define  APP_USBH_BENCH_PRINTF                        printf
+#endif
+
+#ifndef  APP_USBH_BENCH_CFG_UAS_EN
+#if     (USBH_CFG_MAX_NBR_EPS >= 4u)
+#define  APP_USBH_BENCH_CFG_UAS_EN               DEF_ENABLED
+#else
+#define  APP_USBH_BENCH_CFG_UAS_EN              DEF_DISABLED
+#endif
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+USBH_ERR  App_USBH_Bench_Run(void);
+
+
+/*
+*********************************************************************************************************
+*                                        CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+#if     (APP_USBH_BENCH_CFG_MSC_BLK_NBR < 256u)
+#error  "APP_USBH_BENCH_CFG_MSC_BLK_NBR        illegally #define'd in 'app_cfg.h' [MUST be >= 256]"
+#endif
+
+#if     (APP_USBH_BENCH_CFG_BULK_TOT_LEN < 65536u)
+#error  "APP_USBH_BENCH_CFG_BULK_TOT_LEN       illegally #define'd in 'app_cfg.h' [MUST be >= 65536]"
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              MODULE END
+*********************************************************************************************************
+*/
+
+#endif
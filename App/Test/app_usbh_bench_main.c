@@ -0,0 +1,85 @@
+/*
+*********************************************************************************************************
+*                                            EXAMPLE CODE
+*
+*               This file is provided as an example on how to use Micrium products.
+*
+*               Please feel free to use any application code labeled as 'EXAMPLE CODE' in
+*               your application products.  Example code may be used as is, in whole or in
+*               part, or may be used as a reference only. This file can be modified as
+*               required to meet the end-product requirements.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                      USB HOST BENCHMARK SUITE
+*
+*                                            POSIX PROGRAM
+*
+* Filename : app_usbh_bench_main.c
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) Entry point of the benchmark program on a POSIX host. It is linked with the core, hub and
+*                class sources, the simulated host controller ('HCD/Sim'), the POSIX OS port ('OS/POSIX')
+*                and the POSIX ports of uC/CPU and uC/LIB, for instance:
+*
+*                    cc -O2 -o usbh_bench App/Test/app_usbh_bench_main.c App/Test/app_usbh_bench.c
+*                       Source/usbh_core.c Source/usbh_hub.c Source/usbh_class.c
+*                       Class/MSC/usbh_msc.c Class/UAS/usbh_uas.c
+*                       Class/HID/usbh_hid.c Class/HID/usbh_hidparser.c
+*                       HCD/Sim/usbh_hcd_sim.c HCD/Sim/usbh_sim_dev.c HCD/Sim/bsp_usbh_sim.c
+*                       OS/POSIX/usbh_os.c
+*                       <uC/CPU and uC/LIB sources> -I<cfg dir> ... -lpthread
+*
+*                    ./usbh_bench > results.json
+*
+*                '<cfg dir>' holds 'app_cfg.h' and 'usbh_cfg.h'. The UAS benchmarks need USBH_CFG_MAX_NBR_EPS
+*                >= 4 in 'usbh_cfg.h'; with the template value of 3, they are disabled and
+*                'Class/UAS/usbh_uas.c' must be left out of the build (see 'app_usbh_bench.h  DEFAULT
+*                CONFIGURATION  Note #2').
+*
+*            (2) The process exit status is 0 if all benchmarks ran, 1 otherwise.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu_core.h>
+#include  <lib_mem.h>
+#include  "app_usbh_bench.h"
+
+
+/*
+*********************************************************************************************************
+*                                               main()
+*
+* Description : Initialize uC/CPU and uC/LIB, then run the benchmarks.
+*
+* Argument(s) : None.
+*
+* Return(s)   : Process exit status (see 'app_usbh_bench_main.c  Note #2').
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+int  main (void)
+{
+    USBH_ERR  err;
+
+
+    CPU_Init();
+    Mem_Init();
+
+    err = App_USBH_Bench_Run();
+
+    return ((err == USBH_ERR_NONE) ? 0 : 1);
+}
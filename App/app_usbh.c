@@ -56,7 +56,7 @@
 *********************************************************************************************************
 */
 
-static  USBH_STK  App_USBH_AsyncTaskStk[USBH_OS_CFG_ASYNC_TASK_STK_SIZE];
+static  USBH_STK  App_USBH_AsyncTaskStk[USBH_CFG_ASYNC_TASK_NBR][USBH_OS_CFG_ASYNC_TASK_STK_SIZE];
 static  USBH_STK  App_USBH_HubTaskStk[USBH_OS_CFG_HUB_TASK_STK_SIZE];
 
 
@@ -66,10 +66,27 @@ static  USBH_STK  App_USBH_HubTaskStk[USBH_OS_CFG_HUB_TASK_STK_SIZE];
 *********************************************************************************************************
 */
 
-USBH_KERNEL_TASK_INFO  AsyncTaskInfo = {                        /* ---------------- INFO ON ASYNC TASK ---------------- */
-    USBH_OS_CFG_ASYNC_TASK_PRIO,                                /* Async task priority.                                 */
-    App_USBH_AsyncTaskStk,                                      /* Ptr to async task stack.                             */
-    USBH_OS_CFG_ASYNC_TASK_STK_SIZE                             /* Size of async task stack.                            */
+                                                                /* --------------- INFO ON ASYNC TASKS ---------------- */
+USBH_KERNEL_TASK_INFO  AsyncTaskInfo[USBH_CFG_ASYNC_TASK_NBR] = {
+    {
+        USBH_OS_CFG_ASYNC_TASK_PRIO,                            /* Async task priority.                                 */
+        App_USBH_AsyncTaskStk[0],                               /* Ptr to async task stack.                             */
+        USBH_OS_CFG_ASYNC_TASK_STK_SIZE                         /* Size of async task stack.                            */
+    },
+#if (USBH_CFG_ASYNC_TASK_NBR > 1u)
+    {
+        USBH_OS_CFG_ASYNC_TASK_PRIO + 1u,                       /* Lower prio for ctrl/bulk completions.                */
+        App_USBH_AsyncTaskStk[1],
+        USBH_OS_CFG_ASYNC_TASK_STK_SIZE
+    },
+#endif
+#if (USBH_CFG_ASYNC_TASK_NBR > 2u)
+    {
+        USBH_OS_CFG_ASYNC_TASK_PRIO + 2u,
+        App_USBH_AsyncTaskStk[2],
+        USBH_OS_CFG_ASYNC_TASK_STK_SIZE
+    },
+#endif
 };
 
 USBH_KERNEL_TASK_INFO  HubTaskInfo = {                          /* ----------------- INFO ON HUB TASK ----------------- */
@@ -92,6 +109,10 @@ USBH_KERNEL_TASK_INFO  HubTaskInfo = {                          /* -------------
 *********************************************************************************************************
 */
 
+#if (USBH_CFG_ASYNC_TASK_NBR > 3u)
+#error  "USBH_CFG_ASYNC_TASK_NBR               add task info for each async task in 'AsyncTaskInfo'"
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -119,7 +140,7 @@ CPU_BOOLEAN  App_USBH_Init (void)
     APP_TRACE_INFO(("=  USB HOST INITIALIZATION  =\r\n"));
     APP_TRACE_INFO(("=============================\r\n"));
 
-    err = USBH_Init(&AsyncTaskInfo,
+    err = USBH_Init( AsyncTaskInfo,
                     &HubTaskInfo);
     if (err != USBH_ERR_NONE) {
         APP_TRACE_DBG(("...could not initialize USB HOST Stack  w/err = %d\r\n\r\n", err));
@@ -185,7 +185,9 @@
                                                                 /*  The maximum number of endpoints that an interface...*/
                                                                 /*  ... can contain. The number of endpoints greatly ...*/
                                                                 /*  ... depends on the device's class, but should ...   */
-                                                                /*  ... generally be around two or three.               */
+                                                                /*  ... generally be around two or three. The UAS ...   */
+                                                                /*  ... class driver requires at least four (see ...    */
+                                                                /*  ... 'usbh_uas.h').                                  */
 #define  USBH_CFG_MAX_NBR_EPS                              3u
 
                                                                 /*  Maximum configuration descriptor length             */
@@ -216,6 +218,22 @@
                                                                 /*  The maximum number of extra URB used for streaming. */
 #define  USBH_CFG_MAX_EXTRA_URB_PER_DEV                    1u
 
+                                                                /*  Maximum number of queued URB per endpoint           */
+                                                                /*  The maximum number of transfers that can be ...     */
+                                                                /*  ... outstanding on a single endpoint. The extra ... */
+                                                                /*  ... URB pool holds at least this number - 1 ...     */
+                                                                /*  ... URBs per device.                                */
+#define  USBH_CFG_MAX_QUEUED_URB_PER_EP                    4u
+
+                                                                /*  Number of scatter-gather bounce buffers             */
+                                                                /*  Bounce buffers used by scatter-gather xfers on ...  */
+                                                                /*  ... HC that cannot map the segments. 0 disables ... */
+                                                                /*  ... the fallback.                                   */
+#define  USBH_CFG_SG_BOUNCE_BUF_NBR                        1u
+
+                                                                /*  Length of scatter-gather bounce buffers             */
+#define  USBH_CFG_SG_BOUNCE_BUF_LEN                     4096u
+
                                                                 /*  Maximum number of USB hub                           */
                                                                 /*  The maximum number of external and root hub that ...*/
                                                                 /*  ... can be connected.                               */
@@ -231,6 +249,51 @@
                                                                 /* ... retries before tearing down a device             */
 #define  USBH_CFG_MAX_NUM_DEV_RECONN                       3u
 
+                                                                /* Asynchronous completion batching                     */
+                                                                /* When enabled, the async task detaches every ...      */
+                                                                /* ... completed URB in a single critical section ...   */
+                                                                /* ... and completes the whole batch per wakeup.        */
+#define  USBH_CFG_ASYNC_BATCH_EN                 DEF_ENABLED
+
+                                                                /* Number of asynchronous completion tasks              */
+                                                                /* Each task owns its own completion queue. ...         */
+                                                                /* ... One task info per worker must be passed ...      */
+                                                                /* ... to USBH_Init(), highest priority first. ...      */
+                                                                /* ... Set to 2 or 3 to split intr/isoc, ctrl and ...   */
+                                                                /* ... bulk completions over separate tasks.            */
+#define  USBH_CFG_ASYNC_TASK_NBR                           1u
+
+                                                                /* Asynchronous completion routing mode                 */
+                                                                /* Default routing of endpoints to the async ...        */
+                                                                /* ... tasks. See 'usbh_core.h' for modes.              */
+#define  USBH_CFG_ASYNC_TASK_ROUTE        USBH_ASYNC_ROUTE_EP_TYPE
+
+                                                                /* Transfer trace                                       */
+                                                                /* When enabled, a binary record is added to the ...    */
+                                                                /* ... trace ring at each step of every URB. ...        */
+                                                                /* ... Requires CPU_CFG_TS_32_EN.                       */
+#define  USBH_CFG_TRACE_EN                      DEF_DISABLED
+
+                                                                /* Number of records in the trace ring                  */
+                                                                /* Must be a power of 2.                                */
+#define  USBH_CFG_TRACE_REC_NBR                          256u
+
+                                                                /* Transfer statistics                                  */
+                                                                /* When enabled, byte, URB, error and latency ...       */
+                                                                /* ... counters are kept per endpoint and per ...       */
+                                                                /* ... device. Requires CPU_CFG_TS_32_EN.               */
+#define  USBH_CFG_STAT_EN                       DEF_DISABLED
+
+                                                                /* Enumeration descriptor cache                         */
+                                                                /* When enabled, the cfg desc of recently conn'd ...    */
+                                                                /* ... devs are kept and reused on reconnection ...     */
+                                                                /* ... of the same dev. See 'usbh_core.c'.              */
+#define  USBH_CFG_DESC_CACHE_EN                 DEF_DISABLED
+
+                                                                /* Number of entries in the descriptor cache            */
+                                                                /* Each entry holds the cfg desc of one device.         */
+#define  USBH_CFG_DESC_CACHE_NBR                           4u
+
 
 /*
 *********************************************************************************************************
@@ -277,6 +340,11 @@
                                                                 /*  The maximum number of HID usage in local.           */
 #define  USBH_HID_CFG_MAX_NBR_USAGE                       15u
 
+                                                                /*  Maximum number of input report fields               */
+                                                                /*  The maximum number of input report elements ...     */
+                                                                /*  ... decoded by USBH_HID_ReportDecode().             */
+#define  USBH_HID_CFG_MAX_NBR_FIELD                       32u
+
                                                                 /*  Maximum length of transmission buffer               */
                                                                 /*  The maximum length of buffer used for OUT reports.  */
 #define  USBH_HID_CFG_MAX_TX_BUF_SIZE                     64u
@@ -285,6 +353,16 @@
                                                                 /*  The maximum length of buffer used for IN reports.   */
 #define  USBH_HID_CFG_MAX_RX_BUF_SIZE                    128u
 
+                                                                /*  Number of reception buffers                         */
+                                                                /*  The number of IN transfers kept queued per ...      */
+                                                                /*  ... device, between 1 and 8.                        */
+#define  USBH_HID_CFG_RX_BUF_NBR                           2u
+
+                                                                /*  Length of input report queue                        */
+                                                                /*  The number of reports kept per device for ...       */
+                                                                /*  ... USBH_HID_RxQ_Get(). 0 disables the queue.       */
+#define  USBH_HID_CFG_RX_Q_LEN                             0u
+
                                                                 /*  Maximum number of callbacks for device              */
                                                                 /*  The maximum length of buffer used for IN reports.   */
 #define  USBH_HID_CFG_MAX_NBR_RXCB                         2u
@@ -294,17 +372,25 @@
                                                                 /*  ... report descriptor.                              */
 #define  USBH_HID_CFG_MAX_REPORT_DESC_LEN                400u
 
+                                                                /*  Number of parsed report descriptors                 */
+                                                                /*  The number of report descriptors kept parsed ...    */
+                                                                /*  ... and shared by devices with the same one. ...    */
+                                                                /*  ... Saves memory only when lower than ...           */
+                                                                /*  ... USBH_HID_CFG_MAX_DEV.                           */
+#define  USBH_HID_CFG_MAX_NBR_RD                           5u
+
                                                                 /*  Maximum error count                                 */
                                                                 /*  The maximum number of error that can occur.         */
 #define  USBH_HID_CFG_MAX_ERR_CNT                          5u
 
                                                                 /*  Maximum global collection for push/pop items        */
-                                                                /*  The maximum number of global push/pop items.        */
+                                                                /*  The maximum number of global push/pop items, ...    */
+                                                                /*  ... used to size the shared parser arena.           */
 #define  USBH_HID_CFG_MAX_GLOBAL                           2u
 
                                                                 /*  Maximum collections for open/close collection       */
                                                                 /*  The maximum number of collections for open/close ...*/
-                                                                /*  ... collection.                                     */
+                                                                /*  ... collection, used to size the parser arena.      */
 #define  USBH_HID_CFG_MAX_COLL                            10u
 
 
@@ -319,6 +405,80 @@
                                                                 /*  ... connected at the same time.                     */
 #define  USBH_MSC_CFG_MAX_DEV                              1u
 
+                                                                /*  Pipelined Bulk-Only Transport                       */
+                                                                /*  Enable the submission of the CBW, data and CSW ...  */
+                                                                /*  ... stages of commands back to back.                */
+#define  USBH_MSC_CFG_PIPE_EN                    DEF_ENABLED
+
+                                                                /*  Command queue length                                */
+                                                                /*  Number of commands that can be queued per MSC ...   */
+                                                                /*  ... device when pipelining is enabled.              */
+#define  USBH_MSC_CFG_CMD_Q_LEN                            2u
+
+                                                                /*  Read priority                                       */
+                                                                /*  Max number of reads started ahead of a queued ...   */
+                                                                /*  ... write of another LUN, 0 to 254. 0 disables ...  */
+                                                                /*  ... priority.                                       */
+#define  USBH_MSC_CFG_RD_PRIO_MAX                          4u
+
+                                                                /*  Block cache                                         */
+                                                                /*  Cache the blocks read and written by ...            */
+                                                                /*  ... USBH_MSC_Rd() / USBH_MSC_Wr().                  */
+#define  USBH_MSC_CFG_CACHE_EN                  DEF_DISABLED
+
+                                                                /*  Number of cached blocks                             */
+                                                                /*  Number of blocks cached per MSC device.             */
+#define  USBH_MSC_CFG_CACHE_BLK_NBR                       32u
+
+                                                                /*  Cached block size                                   */
+                                                                /*  Largest block size, in octets, that is cached.      */
+#define  USBH_MSC_CFG_CACHE_BLK_SIZE                     512u
+
+                                                                /*  Cache transfer size                                 */
+                                                                /*  Number of blocks read ahead or written back ...     */
+                                                                /*  ... by a single command.                            */
+#define  USBH_MSC_CFG_CACHE_XFER_BLK_NBR                   8u
+
+                                                                /*  Maximum number of LUNs                              */
+                                                                /*  Number of LUNs per MSC device whose last sense ...  */
+                                                                /*  ... data and command format are kept.               */
+#define  USBH_MSC_CFG_MAX_LUN                              1u
+
+                                                                /*  Transient error retries                             */
+                                                                /*  Max number of retries of a read or write failed ... */
+                                                                /*  ... with UNIT ATTENTION or NOT READY. 0 disables.   */
+#define  USBH_MSC_CFG_RETRY_NBR                            3u
+
+                                                                /*  Transient error retry delay                         */
+                                                                /*  Delay, in ms, before the first NOT READY retry, ... */
+                                                                /*  ... doubled on each following retry.                */
+#define  USBH_MSC_CFG_RETRY_DLY_MS                        10u
+
+
+/*
+*********************************************************************************************************
+*                                USB ATTACHED SCSI (UAS) CONFIGURATION
+*
+* Note(s) : (1) A UAS interface has four endpoints. USBH_CFG_MAX_NBR_EPS must be set to 4 or more when the
+*               UAS class driver is used.
+*********************************************************************************************************
+*/
+
+                                                                /*  Maximum number of UAS devices                       */
+                                                                /*  The maximum number of UAS devices that can be ...   */
+                                                                /*  ... connected at the same time.                     */
+#define  USBH_UAS_CFG_MAX_DEV                              1u
+
+                                                                /*  Command queue length                                */
+                                                                /*  Number of tagged commands that can be ...           */
+                                                                /*  ... outstanding per UAS device.                     */
+#define  USBH_UAS_CFG_CMD_Q_LEN                            4u
+
+                                                                /*  Maximum number of LUNs                              */
+                                                                /*  Number of LUNs per UAS device whose command ...     */
+                                                                /*  ... format and transfer limit are kept.             */
+#define  USBH_UAS_CFG_MAX_LUN                              1u
+
 
 /*
 *********************************************************************************************************
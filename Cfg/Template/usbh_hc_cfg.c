@@ -78,7 +78,10 @@ USBH_HC_CFG  USBH_HC_TemplateCfg = {
               1024u,                                            /* Data buf max len.                                    */
               2u,                                               /* Max nbr opened bulk EP.                              */
               2u,                                               /* Max nbr opened intr EP.                              */
-              2u                                                /* Max nbr opened isoc EP.                              */
+              2u,                                               /* Max nbr opened isoc EP.                              */
+    (CPU_ADDR)0x00000000u,                                      /* Start addr of sys mem reachable by HC DMA.           */
+              0u,                                               /* Size of sys mem reachable by HC DMA (0 = none).      */
+              4u                                                /* Alignment required for HC DMA data buf.              */
 };
 
 
@@ -35,6 +35,7 @@
 #include  "usbh_hid.h"
 #include  "usbh_hidparser.h"
 #include  "../../Source/usbh_core.h"
+#include  <cpu_core.h>
 
 
 /*
@@ -114,6 +115,16 @@
 #define  USBH_HID_REPORT_TYPE_FEATURE                   0x03u
 
 
+/*
+*********************************************************************************************************
+*                                     REPORT DESCRIPTOR HASH (FNV-1a)
+*********************************************************************************************************
+*/
+
+#define  USBH_HID_RD_HASH_INIT                    0x811C9DC5u
+#define  USBH_HID_RD_HASH_PRIME                   0x01000193u
+
+
 /*
 *********************************************************************************************************
 *                                           LOCAL CONSTANTS
@@ -141,8 +152,16 @@
 *********************************************************************************************************
 */
 
-static  USBH_HID_DEV  USBH_HID_DevArr[USBH_HID_CFG_MAX_DEV];
-static  MEM_POOL      USBH_HID_DevPool;
+static  USBH_HID_DEV            USBH_HID_DevArr[USBH_HID_CFG_MAX_DEV];
+static  MEM_POOL                USBH_HID_DevPool;
+
+                                                                /* Report desc cache.                                   */
+static  USBH_HID_RD             USBH_HID_RD_Tbl[USBH_HID_CFG_MAX_NBR_RD];
+                                                                /* Report desc rd buf.                                  */
+static  CPU_INT08U              USBH_HID_RD_Buf[USBH_HID_CFG_MAX_REPORT_DESC_LEN];
+static  USBH_HMUTEX             USBH_HID_RD_Mutex;              /* Protects report desc cache and parser.               */
+static  CPU_INT32U              USBH_HID_RD_UseSeq;             /* Seq nbr of last report desc cache use.               */
+static  USBH_HID_RD_CACHE_STAT  USBH_HID_RD_CacheStat;
 
 
 /*
@@ -183,6 +202,38 @@ static  CPU_INT32U   USBH_HID_RxData           (USBH_HID_DEV  *p_hid_dev,
                                                 CPU_INT16U     timeout_ms,
                                                 USBH_ERR      *p_err);
 
+static  USBH_ERR     USBH_HID_RxCB_Add         (USBH_HID_DEV        *p_hid_dev,
+                                                CPU_INT08U           report_id,
+                                                USBH_HID_RXCB_FNCT   async_fnct,
+                                                USBH_HID_CHNG_FNCT   chng_fnct,
+                                                void                *p_async_arg,
+                                                CPU_INT08U           filter,
+                                                CPU_INT32U           dead_band);
+
+static  void         USBH_HID_ChngProcess      (USBH_HID_DEV        *p_hid_dev,
+                                                USBH_HID_RXCB       *p_rx_cb,
+                                                CPU_INT08U          *p_buf,
+                                                CPU_INT08U           buf_len);
+
+static  void         USBH_HID_ChngAdd          (USBH_HID_DEV        *p_hid_dev,
+                                                USBH_HID_RXCB       *p_rx_cb,
+                                                CPU_INT16U          *p_chng_cnt,
+                                                CPU_INT32U           usage,
+                                                CPU_INT32S           val_old,
+                                                CPU_INT32S           val_new);
+
+static  CPU_BOOLEAN  USBH_HID_ArrUsageIsSel    (USBH_HID_DEV        *p_hid_dev,
+                                                USBH_HID_REPORT_ID  *p_report_id,
+                                                CPU_INT08U          *p_buf,
+                                                CPU_INT32U           bit_len,
+                                                CPU_INT32U           usage);
+
+static  CPU_INT32U   USBH_HID_FieldUsageGet    (USBH_HID_FIELD      *p_field,
+                                                CPU_INT32S           val);
+
+static  CPU_INT32S   USBH_HID_FieldRd          (USBH_HID_FIELD      *p_field,
+                                                CPU_INT08U          *p_buf);
+
 static  USBH_ERR     USBH_HID_MemReadHIDDesc   (USBH_HID_DEV  *p_hid_dev);
 
 static  void         USBH_HID_IntrRxCB         (USBH_EP       *p_ep,
@@ -200,7 +251,19 @@ static  void         USBH_HID_DispatchReport   (USBH_HID_DEV  *p_hid_dev,
 
 static  USBH_ERR     USBH_HID_ProcessReportDesc(USBH_HID_DEV  *p_hid_dev);
 
-static  USBH_ERR     USBH_HID_RxReportAsync    (USBH_HID_DEV  *p_hid_dev);
+static  void         USBH_HID_RD_Release       (USBH_HID_DEV  *p_hid_dev);
+
+static  USBH_ERR     USBH_HID_RxStart          (USBH_HID_DEV  *p_hid_dev);
+
+static  USBH_ERR     USBH_HID_RxReportAsync    (USBH_HID_DEV  *p_hid_dev,
+                                                CPU_INT08U     buf_ix);
+
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+static  CPU_BOOLEAN  USBH_HID_RxQ_Put          (USBH_HID_DEV  *p_hid_dev,
+                                                CPU_INT08U     report_id,
+                                                CPU_INT08U    *p_report,
+                                                CPU_INT08U     report_len);
+#endif
 
 
 /*
@@ -263,10 +326,12 @@ USBH_CLASS_DRV  USBH_HID_ClassDrv = {
 *               USBH_ERR_NONE,                          If HID device successfully locked.
 *               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
 *
-*                                                       ----- RETURNED BY USBH_HID_CreateReportID -----
-*               USBH_ERR_ALLOC,                         if report ID cannot be allocated.
+*                                                       ----- RETURNED BY USBH_HID_ProcessReportDesc() : -----
+*               USBH_ERR_ALLOC,                         if report ID, report field or report descriptor cache
+*                                                       entry cannot be allocated.
 *
-* Note(s)     : None.
+* Note(s)     : (1) The parsed report descriptor is taken from the report descriptor cache if a device with
+*                   the same report descriptor was initialized before (see USBH_HID_ProcessReportDesc()).
 *********************************************************************************************************
 */
 
@@ -284,14 +349,14 @@ USBH_ERR  USBH_HID_Init (USBH_HID_DEV  *p_hid_dev)
         return (err);
     }
 
-    err = USBH_HID_ProcessReportDesc(p_hid_dev);                /* Read and parse report desc.                          */
-    if (err == USBH_ERR_NONE) {
-        err = USBH_HID_CreateReportID(p_hid_dev);               /* Create report ID list.                               */
+    p_hid_dev->IsInit = DEF_FALSE;
+    USBH_HID_RD_Release(p_hid_dev);                             /* Release report desc of prev init, if any.            */
 
-        if (err == USBH_ERR_NONE) {
-            p_hid_dev->MaxReportPtr = USBH_HID_MaxReport(p_hid_dev, USBH_HID_MAIN_ITEM_TAG_IN);
-            p_hid_dev->IsInit       = DEF_TRUE;
-        }
+    err = USBH_HID_ProcessReportDesc(p_hid_dev);                /* Read and parse report desc (see Note #1).            */
+    if (err == USBH_ERR_NONE) {
+        p_hid_dev->Usage        = p_hid_dev->RD_Ptr->Usage;
+        p_hid_dev->MaxReportPtr = USBH_HID_MaxReport(p_hid_dev->RD_Ptr, USBH_HID_MAIN_ITEM_TAG_IN);
+        p_hid_dev->IsInit       = DEF_TRUE;
     }
 
     USBH_HID_DevUnlock(p_hid_dev);
@@ -451,8 +516,8 @@ USBH_ERR  USBH_HID_GetReportIDArray (USBH_HID_DEV         *p_hid_dev,
         return (USBH_ERR_DEV_NOT_READY);
     }
 
-   *p_report_id     = p_hid_dev->ReportID;                      /* Rtn report ID struct array base addr.                */
-   *p_nbr_report_id = p_hid_dev->NbrReportID;                   /* Rtn nbr of report ID struct.                         */
+   *p_report_id     = p_hid_dev->RD_Ptr->ReportID;              /* Rtn report ID struct array base addr.                */
+   *p_nbr_report_id = p_hid_dev->RD_Ptr->NbrReportID;           /* Rtn nbr of report ID struct.                         */
 
     USBH_HID_DevUnlock(p_hid_dev);
 
@@ -509,8 +574,8 @@ USBH_ERR  USBH_HID_GetAppCollArray (USBH_HID_DEV        *p_hid_dev,
         return (USBH_ERR_DEV_NOT_READY);
     }
 
-   *p_app_coll     = p_hid_dev->AppColl;                        /* Return  App collection structure array base address  */
-   *p_nbr_app_coll = p_hid_dev->NbrAppColl;                     /* Return the number of App collection structure        */
+   *p_app_coll     = p_hid_dev->RD_Ptr->AppColl;                /* Return  App collection structure array base address  */
+   *p_nbr_app_coll = p_hid_dev->RD_Ptr->NbrAppColl;             /* Return the number of App collection structure        */
 
     USBH_HID_DevUnlock(p_hid_dev);
 
@@ -761,7 +826,8 @@ CPU_INT08U  USBH_HID_TxReport (USBH_HID_DEV  *p_hid_dev,
 *               USBH_ERR_NONE,                  If HID device successfully locked.
 *               USBH_ERR_DEV_NOT_READY,         If HID device not ready.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Every received report is delivered, unless the callback is set to only receive changed
+*                   reports with USBH_HID_RxFilterSet().
 *********************************************************************************************************
 */
 
@@ -770,10 +836,7 @@ USBH_ERR  USBH_HID_RegRxCB (USBH_HID_DEV        *p_hid_dev,
                             USBH_HID_RXCB_FNCT   async_fnct,
                             void                *p_async_arg)
 {
-    CPU_INT08U      ix;
-    CPU_INT32U      report_len_bytes;
-    USBH_HID_RXCB  *p_rx_cb;
-    USBH_ERR        err;
+    USBH_ERR  err;
 
 
     if ((p_hid_dev  == (USBH_HID_DEV     *)0) ||
@@ -781,66 +844,13 @@ USBH_ERR  USBH_HID_RegRxCB (USBH_HID_DEV        *p_hid_dev,
         return (USBH_ERR_INVALID_ARG);
     }
 
-    err = USBH_HID_DevLock(p_hid_dev);
-    if (err != USBH_ERR_NONE) {
-        return (err);
-    }
-
-    if (p_hid_dev->IsInit == DEF_FALSE) {
-        USBH_HID_DevUnlock(p_hid_dev);
-        return (USBH_ERR_DEV_NOT_READY);
-    }
-
-    if (p_hid_dev->MaxReportPtr == (USBH_HID_REPORT_ID *)0) {
-        USBH_HID_DevUnlock(p_hid_dev);
-        return (USBH_ERR_HID_NOT_IN_REPORT);
-    }
-                                                                /* Check max buf size to recv data.                     */
-    report_len_bytes = (p_hid_dev->MaxReportPtr->Size / 8u);
-    if ((p_hid_dev->MaxReportPtr->Size % 8u) != 0u) {
-        report_len_bytes++;
-    }
-
-    if (report_len_bytes > USBH_HID_CFG_MAX_RX_BUF_SIZE) {
-        USBH_HID_DevUnlock(p_hid_dev);
-        return (USBH_ERR_ALLOC);
-    }
-
-    for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {       /* Check already reg callback with same report id.      */
-
-        if ((p_hid_dev->RxCB[ix].InUse    == DEF_TRUE) &&
-            (p_hid_dev->RxCB[ix].ReportID == report_id)) {
-            USBH_HID_DevUnlock(p_hid_dev);
-            return (USBH_ERR_HID_REPORT_ID);
-        }
-    }
-
-    p_rx_cb = (USBH_HID_RXCB *)0;                               /* Search for empty callback structure.                 */
-    for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {
-
-        if (p_hid_dev->RxCB[ix].InUse == DEF_FALSE) {
-            p_rx_cb = &p_hid_dev->RxCB[ix];
-            break;
-        }
-    }
-
-    if (p_rx_cb == (USBH_HID_RXCB *)0) {
-        USBH_HID_DevUnlock(p_hid_dev);
-        return (USBH_ERR_ALLOC);
-    }
-                                                                /* Fill callback structure.                             */
-    p_rx_cb->ReportID    = report_id;
-    p_rx_cb->AsyncFnct   = async_fnct;
-    p_rx_cb->AsyncArgPtr = p_async_arg;
-    p_rx_cb->InUse       = DEF_TRUE;
-
-    if (p_hid_dev->RxInProg == DEF_FALSE) {                     /* Receive Async if not started                         */
-        err = USBH_HID_RxReportAsync(p_hid_dev);
-    } else {
-        err = USBH_ERR_NONE;
-    }
-
-    USBH_HID_DevUnlock(p_hid_dev);
+    err = USBH_HID_RxCB_Add(p_hid_dev,
+                            report_id,
+                            async_fnct,
+                            (USBH_HID_CHNG_FNCT)0,
+                            p_async_arg,
+                            USBH_HID_RX_FILTER_NONE,
+                            0u);
 
     return (err);
 }
@@ -909,69 +919,76 @@ USBH_ERR  USBH_HID_UnregRxCB (USBH_HID_DEV  *p_hid_dev,
 
 /*
 *********************************************************************************************************
-*                                       USBH_HID_ProtocolSet()
+*                                       USBH_HID_RegRxChngCB()
 *
-* Description : Set protocol (boot/report descriptor) of HID device.
+* Description : Register a callback function to receive the usages of a report that changed.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : p_hid_dev        Pointer to HID device.
 *
-*               protocol        Protocol to set.
+*               report_id        Report id.
 *
-* Return(s)   : USBH_ERR_NONE,                          If protocol is successfully set.
-*               USBH_ERR_DEV_NOT_READY,                 If device is not ready.
-*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'.
+*               chng_fnct        Callback function.
 *
-*                                                       ----- RETURNED BY USBH_CtrlTx() : -----
-*               USBH_ERR_UNKNOWN                        Unknown error occurred.
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               USBH_ERR_HC_IO,                         Root hub input/output error.
-*               USBH_ERR_EP_STALL,                      Root hub does not support request.
-*               Host controller drivers error code,     Otherwise.
+*               p_arg            Pointer to context that will be passed to callback function.
 *
-*                                                       ----- RETURNED BY USBH_HID_DevLock -----
-*               USBH_ERR_NONE,                          If HID device successfully locked.
-*               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
+*               dead_band        Smallest change of an absolute axis that is delivered, minus 1. 0 delivers
+*                                every change.
 *
-* Note(s)     : For more information on the 'Set_Protocol' request, see 'Device Class Definition for
-*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.6'.
+* Return(s)   : USBH_ERR_NONE,                  If callback successfully registered.
+*               USBH_ERR_INVALID_ARG,           If invalid argument passed to 'chng_fnct'/'p_hid_dev'.
+*               USBH_ERR_DEV_NOT_READY,         If device is not ready.
+*               USBH_ERR_HID_NOT_IN_REPORT,     If incorrect report descriptor provided by device.
+*               USBH_ERR_ALLOC,                 If rx callback cannot be allocated.
+*               USBH_ERR_HID_REPORT_ID,         If callback with same report ID is already registered.
+*
+*                                               ----- RETURNED BY USBH_HID_DevLock -----
+*               USBH_ERR_NONE,                  If HID device successfully locked.
+*               USBH_ERR_DEV_NOT_READY,         If HID device not ready.
+*
+* Note(s)     : (1) Each received report is decoded (see USBH_HID_ReportDecode()) and compared with the
+*                   values last delivered. The callback is only invoked when at least one usage changed,
+*                   with the list of changed usages and their old and new values:
+*
+*                   (a) A variable element is delivered when its value changed. The value of a relative
+*                       element is a change by itself: it is delivered when not 0, with an old value of 0.
+*
+*                   (b) An absolute variable element of more than 1 bit (an axis) is only delivered when
+*                       it differs from its last delivered value by more than 'dead_band'.
+*
+*                   (c) A usage selected by an array element is delivered as (usage, 0, 1) when it gets
+*                       selected, and as (usage, 1, 0) when it is no longer selected.
+*
+*                   (d) The first report received after registration delivers all variable elements, with
+*                       an old value of 0, and all selected usages.
+*
+*               (2) The list is held by the HID device and is only valid during the callback. A report that
+*                   changes more than USBH_HID_CFG_MAX_NBR_FIELD usages is delivered in several calls.
+*
+*               (3) Errors are reported to the callback with an empty list, as for USBH_HID_RegRxCB().
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_HID_ProtocolSet (USBH_HID_DEV  *p_hid_dev,
-                                CPU_INT16U     protocol)
+USBH_ERR  USBH_HID_RegRxChngCB (USBH_HID_DEV        *p_hid_dev,
+                                CPU_INT08U           report_id,
+                                USBH_HID_CHNG_FNCT   chng_fnct,
+                                void                *p_arg,
+                                CPU_INT32U           dead_band)
 {
     USBH_ERR  err;
 
 
-    if (p_hid_dev == (USBH_HID_DEV *)0) {
+    if ((p_hid_dev == (USBH_HID_DEV     *)0) ||
+        (chng_fnct == (USBH_HID_CHNG_FNCT)0)) {
         return (USBH_ERR_INVALID_ARG);
     }
 
-    err = USBH_HID_DevLock(p_hid_dev);
-    if (err != USBH_ERR_NONE) {
-        return (err);
-    }
-
-    if (p_hid_dev->IsInit == DEF_FALSE) {
-        USBH_HID_DevUnlock(p_hid_dev);
-        return (USBH_ERR_DEV_NOT_READY);
-    }
-
-    (void)USBH_CtrlTx(        p_hid_dev->DevPtr,                /* Send Set protocol request.                           */
-                              USBH_HID_REQ_SET_PROTOCOL,
-                             (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
-                              protocol,
-                              p_hid_dev->IfNbr,
-                      (void *)0,
-                              0u,
-                              USBH_CFG_STD_REQ_TIMEOUT,
-                             &err);
-    if (err == USBH_ERR_NONE) {
-        p_hid_dev->Boot = DEF_TRUE;
-    }
-
-    USBH_HID_DevUnlock(p_hid_dev);
+    err = USBH_HID_RxCB_Add(p_hid_dev,
+                            report_id,
+                            (USBH_HID_RXCB_FNCT)0,
+                            chng_fnct,
+                            p_arg,
+                            USBH_HID_RX_FILTER_USAGE,
+                            dead_band);
 
     return (err);
 }
@@ -979,39 +996,42 @@ USBH_ERR  USBH_HID_ProtocolSet (USBH_HID_DEV  *p_hid_dev,
 
 /*
 *********************************************************************************************************
-*                                       USBH_HID_ProtocolGet()
+*                                       USBH_HID_RxFilterSet()
 *
-* Description : Get protocol (boot/report) of the HID device.
+* Description : Set the callback registered for the given report ID to only receive changed reports.
 *
 * Argument(s) : p_hid_dev       Pointer to HID device.
 *
-*               p_protocol      Variable that will receive protocol of the device.
+*               report_id       Report id.
 *
-* Return(s)   : USBH_ERR_NONE,                          If protocol was successfully retrieved.
-*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'.
-*               USBH_ERR_DEV_NOT_READY,                 If device is not ready.
+*               en              DEF_ENABLED,  to deliver only the reports that changed.
+*                               DEF_DISABLED, to deliver every report.
 *
-*                                                       ----- RETURNED BY USBH_CtrlRx() : -----
-*               USBH_ERR_UNKNOWN,                       Unknown error occurred.
-*               USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
-*               USBH_ERR_HC_IO,                         Root hub input/output error.
-*               USBH_ERR_EP_STALL,                      Root hub does not support request.
-*               Host controller drivers error code,     Otherwise.
+*               dead_band       Smallest change of an absolute axis that makes a report change, minus 1.
+*
+* Return(s)   : USBH_ERR_NONE                           If success
+*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'.
+*               USBH_ERR_DEV_NOT_READY                  If the device is not ready
+*               USBH_ERR_HID_REPORT_ID                  If no callback registered with USBH_HID_RegRxCB()
+*                                                       for report ID.
 *
 *                                                       ----- RETURNED BY USBH_HID_DevLock -----
 *               USBH_ERR_NONE,                          If HID device successfully locked.
 *               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
 *
-* Note(s)     : For more information on the 'Get_Protocol' request, see 'Device Class Definition for
-*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.5'.
+* Note(s)     : (1) A report changes when one of its usages changes, as described in USBH_HID_RegRxChngCB()
+*                   Note #1. Constant (padding) bits are ignored. The first report received after this call
+*                   is always delivered.
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_HID_ProtocolGet (USBH_HID_DEV  *p_hid_dev,
-                                CPU_INT16U    *p_protocol)
+USBH_ERR  USBH_HID_RxFilterSet (USBH_HID_DEV  *p_hid_dev,
+                                CPU_INT08U     report_id,
+                                CPU_BOOLEAN    en,
+                                CPU_INT32U     dead_band)
 {
-    USBH_ERR  err;
+    CPU_INT08U  ix;
+    USBH_ERR    err;
 
 
     if (p_hid_dev == (USBH_HID_DEV *)0) {
@@ -1028,68 +1048,66 @@ USBH_ERR  USBH_HID_ProtocolGet (USBH_HID_DEV  *p_hid_dev,
         return (USBH_ERR_DEV_NOT_READY);
     }
 
-    (void)USBH_CtrlRx(        p_hid_dev->DevPtr,                /* Send Get protocol request.                           */
-                              USBH_HID_REQ_GET_PROTOCOL,
-                             (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
-                              0u,
-                              p_hid_dev->IfNbr,
-                      (void *)p_protocol,
-                              1u,
-                              USBH_CFG_STD_REQ_TIMEOUT,
-                             &err);
+    for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {
+
+        if ((p_hid_dev->RxCB[ix].InUse     == DEF_TRUE             ) &&
+            (p_hid_dev->RxCB[ix].ReportID  == report_id            ) &&
+            (p_hid_dev->RxCB[ix].AsyncFnct != (USBH_HID_RXCB_FNCT)0)) {
+
+            p_hid_dev->RxCB[ix].Filter    = (en == DEF_ENABLED) ? USBH_HID_RX_FILTER_REPORT
+                                                                : USBH_HID_RX_FILTER_NONE;
+            p_hid_dev->RxCB[ix].DeadBand  =  dead_band;
+            p_hid_dev->RxCB[ix].LastValid =  DEF_FALSE;
+            USBH_HID_DevUnlock(p_hid_dev);
+
+            return (USBH_ERR_NONE);
+        }
+    }
 
     USBH_HID_DevUnlock(p_hid_dev);
 
-    return (err);
+    return (USBH_ERR_HID_REPORT_ID);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_HID_IdleSet()
+*                                        USBH_HID_RxStatGet()
 *
-* Description : Set idle state duration for a given report ID.
+* Description : Get input report statistics of HID device.
 *
 * Argument(s) : p_hid_dev       Pointer to HID device.
 *
-*               report_id       Report id.
-*
-*               dur             Duration of the idle state in milliseconds.
-*
-* Return(s)   : USBH_ERR_NONE,                          If duration is successfully set.
-*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'/'dur'.
-*               USBH_ERR_DEV_NOT_READY.                 If device is not ready.
+*               p_stat          Pointer to structure that will receive the statistics.
 *
-*                                                       ----- RETURNED BY USBH_CtrlTx() : -----
-*               USBH_ERR_UNKNOWN                        Unknown error occurred.
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               USBH_ERR_HC_IO,                         Root hub input/output error.
-*               USBH_ERR_EP_STALL,                      Root hub does not support request.
-*               Host controller drivers error code,     Otherwise.
+* Return(s)   : USBH_ERR_NONE,                          If statistics successfully copied.
+*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'.
+*               USBH_ERR_NULL_PTR,                      If invalid null pointer passed to 'p_stat'.
+*               USBH_ERR_DEV_NOT_READY,                 If device is not ready.
 *
 *                                                       ----- RETURNED BY USBH_HID_DevLock -----
 *               USBH_ERR_NONE,                          If HID device successfully locked.
 *               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
 *
-* Note(s)     : For more information on the 'Set_Idle' request, see 'Device Class Definition for
-*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.4'.
+* Note(s)     : (1) A non-zero 'DropCnt' means that reports were received for a report ID with no callback
+*                   while the receive queue was disabled or full. A non-zero 'ArmErrCnt' means that the
+*                   polling of the device was interrupted.
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_HID_IdleSet (USBH_HID_DEV  *p_hid_dev,
-                            CPU_INT08U     report_id,
-                            CPU_INT32U     dur)
+USBH_ERR  USBH_HID_RxStatGet (USBH_HID_DEV      *p_hid_dev,
+                              USBH_HID_RX_STAT  *p_stat)
 {
-    USBH_ERR  err;
+    CPU_INT08U  buf_ix;
+    USBH_ERR    err;
 
 
     if (p_hid_dev == (USBH_HID_DEV *)0) {
         return (USBH_ERR_INVALID_ARG);
     }
 
-    if (dur > USBH_HID_MAX_DUR) {
-        return (USBH_ERR_INVALID_ARG);
+    if (p_stat == (USBH_HID_RX_STAT *)0) {
+        return (USBH_ERR_NULL_PTR);
     }
 
     err = USBH_HID_DevLock(p_hid_dev);
@@ -1097,68 +1115,82 @@ USBH_ERR  USBH_HID_IdleSet (USBH_HID_DEV  *p_hid_dev,
         return (err);
     }
 
-    dur = dur / USBH_HID_DUR_RESOLUTION;                        /* Convert into resolution units.                       */
-                                                                /* Send class-specific request.                         */
-    (void)USBH_CtrlTx(        p_hid_dev->DevPtr,
-                              USBH_HID_REQ_SET_IDLE,
-                             (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
-                             (((dur << 8u) & 0xFF00u) | report_id),
-                              p_hid_dev->IfNbr,
-                      (void *)0,
-                              0u,
-                              USBH_CFG_STD_REQ_TIMEOUT,
-                             &err);
-    if (err == USBH_ERR_EP_STALL) {
-        (void)USBH_EP_Reset(           p_hid_dev->DevPtr,
-                            (USBH_EP *)0);
+    if (p_hid_dev->IsInit == DEF_FALSE) {
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_DEV_NOT_READY);
+    }
+
+   *p_stat             = p_hid_dev->RxStat;
+    p_stat->BufArmedNbr = 0u;
+    for (buf_ix = 0u; buf_ix < USBH_HID_CFG_RX_BUF_NBR; buf_ix++) {
+        if (DEF_BIT_IS_SET(p_hid_dev->RxBufArmed, DEF_BIT(buf_ix)) == DEF_YES) {
+            p_stat->BufArmedNbr++;
+        }
     }
 
     USBH_HID_DevUnlock(p_hid_dev);
 
-    return (err);
+    return (USBH_ERR_NONE);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_HID_IdleGet()
+*                                         USBH_HID_RxQ_Get()
 *
-* Description : Get idle duration for given report ID.
+* Description : Get oldest input report from receive queue of HID device, waiting for one if queue is empty.
 *
 * Argument(s) : p_hid_dev       Pointer to HID device.
 *
-*               report_id       Report id.
+*               p_report_id     Pointer to variable that will receive the report ID.
 *
-*               p_err           Variable that will receive the return error code from this function.
+*               p_buf           Pointer to buffer that will receive the report.
 *
-*                   USBH_ERR_NONE                           Idle duration successfully retrieved.
-*                   USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_hid_dev'.
-*                   USBH_ERR_DEV_NOT_READY                  Device is not ready.
+*               buf_len         Buffer length, in octets.
 *
-*                                                           ----- RETURNED BY USBH_CtrlRx() : -----
-*                   USBH_ERR_UNKNOWN,                       Unknown error occurred.
-*                   USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
-*                   USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
-*                   USBH_ERR_HC_IO,                         Root hub input/output error.
-*                   USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               p_ts            Pointer to variable that will receive the reception timestamp, from
+*                               CPU_TS_Get32(). Can be DEF_NULL.
+*
+*               timeout_ms      Timeout, in milliseconds. 0 means wait forever.
+*
+*               p_err           Variable that will receive the return error code from this function.
+*                   USBH_ERR_NONE,                          Report successfully received.
+*                   USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_hid_dev'.
+*                   USBH_ERR_NULL_PTR,                      Invalid null pointer passed to 'p_buf' or
+*                                                           'p_report_id'.
+*                   USBH_ERR_DEV_NOT_READY,                 Device is not ready or was disconnected.
+*                   USBH_ERR_OS_TIMEOUT,                    No report received before timeout.
+*
+*                                                           ----- RETURNED BY USBH_HID_RxStart() : -----
+*                   USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                   USBH_ERR_ALLOC                          URB cannot be allocated.
 *                   Host controller drivers error code,     Otherwise.
 *
-*                                                           ----- RETURNED BY USBH_HID_DevLock -----
-*                   USBH_ERR_NONE,                          If HID device successfully locked.
-*                   USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
+* Return(s)   : Number of octets copied in 'p_buf'.
 *
-* Return(s)   : Idle duration in milliseconds.
+* Note(s)     : (1) Every input report received asynchronously is queued, whether a callback is registered
+*                   for its report ID or not. Reception is started if not already started.
 *
-* Note(s)     : For more information on the 'Get_Idle' request, see 'Device Class Definition for
-*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.3'.
+*               (2) p_buf contains only the report data without the report id. A report longer than
+*                   'buf_len' is truncated.
+*
+*               (3) A task waiting on an empty queue returns with USBH_ERR_DEV_NOT_READY when the device is
+*                   disconnected.
 *********************************************************************************************************
 */
 
-CPU_INT32U  USBH_HID_IdleGet (USBH_HID_DEV  *p_hid_dev,
-                              CPU_INT08U     report_id,
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+CPU_INT08U  USBH_HID_RxQ_Get (USBH_HID_DEV  *p_hid_dev,
+                              CPU_INT08U    *p_report_id,
+                              void          *p_buf,
+                              CPU_INT08U     buf_len,
+                              CPU_INT32U    *p_ts,
+                              CPU_INT16U     timeout_ms,
                               USBH_ERR      *p_err)
 {
-    CPU_INT32U  dur;
+    USBH_HID_RX_REPORT  *p_entry;
+    CPU_INT08U           len;
+    USBH_ERR             err;
 
 
     if (p_hid_dev == (USBH_HID_DEV *)0) {
@@ -1166,6 +1198,13 @@ CPU_INT32U  USBH_HID_IdleGet (USBH_HID_DEV  *p_hid_dev,
         return (0u);
     }
 
+    if ((p_report_id == (CPU_INT08U *)0) ||
+        (p_buf       == (void       *)0) ||
+        (buf_len     ==               0u)) {
+       *p_err = USBH_ERR_NULL_PTR;
+        return (0u);
+    }
+
    *p_err = USBH_HID_DevLock(p_hid_dev);
     if (*p_err != USBH_ERR_NONE) {
         return (0u);
@@ -1177,45 +1216,62 @@ CPU_INT32U  USBH_HID_IdleGet (USBH_HID_DEV  *p_hid_dev,
         return (0u);
     }
 
-    (void)USBH_CtrlRx(         p_hid_dev->DevPtr,               /* Send the class-specific request.                     */
-                               USBH_HID_REQ_GET_IDLE,
-                              (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
-                               report_id,
-                               p_hid_dev->IfNbr,
-                      (void *)&dur,
-                               1u,
-                               USBH_CFG_STD_REQ_TIMEOUT,
-                               p_err);
+    if (p_hid_dev->RxInProg == DEF_FALSE) {                     /* See Note #1.                                         */
+       *p_err = USBH_HID_RxStart(p_hid_dev);
+        if (*p_err != USBH_ERR_NONE) {
+            USBH_HID_DevUnlock(p_hid_dev);
+            return (0u);
+        }
+    }
 
-    dur = (dur) * USBH_HID_DUR_RESOLUTION;                      /* Convert to ms.                             */
+    while (p_hid_dev->RxQ_Cnt == 0u) {                          /* Sem cnt may exceed nbr of queued reports.            */
+        USBH_HID_DevUnlock(p_hid_dev);
+
+        err = USBH_OS_SemWait(p_hid_dev->RxQ_Sem, timeout_ms);
+        if (err == USBH_ERR_OS_TIMEOUT) {
+           *p_err = err;
+            return (0u);
+        }
+
+       *p_err = USBH_HID_DevLock(p_hid_dev);                    /* Fails if dev has been disconn.                       */
+        if (*p_err != USBH_ERR_NONE) {
+            return (0u);
+        }
+    }
+
+    p_entry = &p_hid_dev->RxQ[p_hid_dev->RxQ_OutIx];
+    len     = DEF_MIN(p_entry->Len, buf_len);                   /* See Note #2.                                         */
+
+    Mem_Copy(        p_buf,
+             (void *)p_entry->Buf,
+                     len);
+   *p_report_id = p_entry->ReportID;
+    if (p_ts != (CPU_INT32U *)0) {
+       *p_ts = p_entry->TS;
+    }
+
+    p_hid_dev->RxQ_OutIx++;
+    if (p_hid_dev->RxQ_OutIx >= USBH_HID_CFG_RX_Q_LEN) {
+        p_hid_dev->RxQ_OutIx = 0u;
+    }
+    p_hid_dev->RxQ_Cnt--;
 
     USBH_HID_DevUnlock(p_hid_dev);
 
-    return (dur);
-}
+   *p_err = USBH_ERR_NONE;
 
+    return (len);
+}
+#endif
 
-/*
-*********************************************************************************************************
-*********************************************************************************************************
-*                                           LOCAL FUNCTION
-*********************************************************************************************************
-*********************************************************************************************************
-*/
 
 /*
 *********************************************************************************************************
-*                                        USBH_HID_GlobalInit()
-*
-* Description : This function is used to initialize the global variables
+*                                     USBH_HID_RD_CacheStatGet()
 *
-* Argument(s) : p_err       Variable that will receive the return error code from this function.
-*                           USBH_ERR_NONE,                  Idle duration successfully retrieved.
-*                           USBH_ERR_INVALID_ARG,           Invalid argument passed to 'p_hid_dev'.
-*                           USBH_ERR_DEV_NOT_READY,         Device is not ready.
+* Description : Get a snapshot of the report descriptor cache statistics.
 *
-*                                                           ----- RETURNED BY USBH_HID_ParserGlobalInit -----
-*                           USBH_ERR_ALLOC,                 if global item or collection list allocation failed.
+* Argument(s) : p_stat          Pointer to structure that will receive the statistics.
 *
 * Return(s)   : None.
 *
@@ -1223,509 +1279,1594 @@ CPU_INT32U  USBH_HID_IdleGet (USBH_HID_DEV  *p_hid_dev,
 *********************************************************************************************************
 */
 
-static  void  USBH_HID_GlobalInit (USBH_ERR  *p_err)
+void  USBH_HID_RD_CacheStatGet (USBH_HID_RD_CACHE_STAT  *p_stat)
 {
-    CPU_INT08U  ix;
-    LIB_ERR     err_lib;
-    CPU_SIZE_T  octets_reqd;
-
-                                                                /* --------------- INIT HID DEV STRUCT ---------------- */
-    for (ix = 0u; ix < USBH_HID_CFG_MAX_DEV; ix++) {
-        (void)USBH_OS_MutexCreate(&USBH_HID_DevArr[ix].HMutex); /* Mutex for protection from multiple app access.       */
-    }
-
-    Mem_PoolCreate (       &USBH_HID_DevPool,                   /* POOL for managing HID dev struct.                    */
-                    (void *)USBH_HID_DevArr,
-                            sizeof(USBH_HID_DEV) * USBH_HID_CFG_MAX_DEV,
-                            USBH_HID_CFG_MAX_DEV,
-                            sizeof(USBH_HID_DEV),
-                            sizeof(CPU_ALIGN),
-                           &octets_reqd,
-                           &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
-       *p_err = USBH_ERR_ALLOC;
+    if (p_stat == (USBH_HID_RD_CACHE_STAT *)0) {
         return;
     }
 
-   *p_err = USBH_HID_ParserGlobalInit();                        /* Init HID parser struct.                              */
+    (void)USBH_OS_MutexLock(USBH_HID_RD_Mutex);
+   *p_stat = USBH_HID_RD_CacheStat;
+    (void)USBH_OS_MutexUnlock(USBH_HID_RD_Mutex);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_HID_ProbeIF()
-*
-* Description : Determine if the interface is HID class interface.
-*
-* Argument(s) : p_dev       Pointer to USB device.
+*                                       USBH_HID_ProtocolSet()
 *
-*               p_if        Pointer to interface.
+* Description : Set protocol (boot/report descriptor) of HID device.
 *
-*               p_err       Variable that will receive the return error code from this function.
-*                           USBH_ERR_NONE                       Interface is of HID type.
-*                           USBH_ERR_DEV_ALLOC                  Cannot allocate HID device.
-*                           USBH_ERR_CLASS_DRV_NOT_FOUND        Interface is not of HID type.
+* Argument(s) : p_hid_dev       Pointer to HID device.
 *
-*                                                               ----- RETURNED BY USBH_IF_DescGet() : -----
-*                           USBH_ERR_INVALID_ARG,               Invalid argument passed to 'alt_ix'.
+*               protocol        Protocol to set.
 *
-*                                                               ----- RETURNED BY USBH_IntrInOpen() : -----
-*                           USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
-*                           USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
-*                           USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
-*                           Host controller drivers error,      Otherwise.
+* Return(s)   : USBH_ERR_NONE,                          If protocol is successfully set.
+*               USBH_ERR_DEV_NOT_READY,                 If device is not ready.
+*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'.
 *
-*                                                               ----- RETURNED BY USBH_IntrOutOpen() : -----
-*                           USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
-*                           USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
-*                           USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
-*                           Host controller drivers error,      Otherwise.
+*                                                       ----- RETURNED BY USBH_CtrlTx() : -----
+*               USBH_ERR_UNKNOWN                        Unknown error occurred.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
 *
-* Return(s)   : p_hid_dev,      If device has a HID class interface.
-*               0,              Otherwise.
+*                                                       ----- RETURNED BY USBH_HID_DevLock -----
+*               USBH_ERR_NONE,                          If HID device successfully locked.
+*               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
 *
-* Note(s)     : None.
+* Note(s)     : For more information on the 'Set_Protocol' request, see 'Device Class Definition for
+*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.6'.
 *********************************************************************************************************
 */
 
-static  void  *USBH_HID_ProbeIF (USBH_DEV  *p_dev,
-                                 USBH_IF   *p_if,
-                                 USBH_ERR  *p_err)
+USBH_ERR  USBH_HID_ProtocolSet (USBH_HID_DEV  *p_hid_dev,
+                                CPU_INT16U     protocol)
 {
-    USBH_IF_DESC   p_if_desc;
-    USBH_HID_DEV  *p_hid_dev;
-    LIB_ERR        err_lib;
+    USBH_ERR  err;
 
 
-   *p_err = USBH_IF_DescGet(p_if, 0u, &p_if_desc);              /* Get IF desc from IF.                                 */
-    if (*p_err != USBH_ERR_NONE) {
-        return ((void *)0);
+    if (p_hid_dev == (USBH_HID_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
     }
-                                                                /* Check for HID class code.                            */
-    if (p_if_desc.bInterfaceClass == USBH_CLASS_CODE_HID){
-                                                                /* Alloc a dev from HID dev pool.                       */
-        p_hid_dev = (USBH_HID_DEV *)Mem_PoolBlkGet(           &USBH_HID_DevPool,
-                                                   (CPU_SIZE_T)sizeof(USBH_HID_DEV),
-                                                              &err_lib);
-        if (err_lib != LIB_MEM_ERR_NONE) {
-           *p_err = USBH_ERR_DEV_ALLOC;
-            return ((void *)0);
-        }
 
-        USBH_HID_DevClr(p_hid_dev);
-        p_hid_dev->State    = USBH_CLASS_DEV_STATE_CONN;
-        p_hid_dev->RxInProg = DEF_FALSE;
-        p_hid_dev->IsInit   = DEF_FALSE;
-        p_hid_dev->DevPtr   = p_dev;
-        p_hid_dev->IfPtr    = p_if;
-        p_hid_dev->IfNbr    = p_if_desc.bInterfaceNumber;
-        p_hid_dev->SubClass = p_if_desc.bInterfaceSubClass;
-        p_hid_dev->Protocol = p_if_desc.bInterfaceProtocol;
+    err = USBH_HID_DevLock(p_hid_dev);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
 
-       *p_err = USBH_IntrInOpen(p_hid_dev->DevPtr,              /* Open intr IN EP.                                     */
-                                p_hid_dev->IfPtr,
-                               &p_hid_dev->IntrInEP);
-        if (*p_err != USBH_ERR_NONE) {
-            Mem_PoolBlkFree(       &USBH_HID_DevPool,
-                            (void *)p_hid_dev,
-                                   &err_lib);
-            return ((void *)0);
-        }
+    if (p_hid_dev->IsInit == DEF_FALSE) {
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_DEV_NOT_READY);
+    }
 
-       *p_err = USBH_IntrOutOpen(p_hid_dev->DevPtr,             /* Try to open optional intr OUT EP.                    */
-                                 p_hid_dev->IfPtr,
-                                &p_hid_dev->IntrOutEP);
-        if (*p_err != USBH_ERR_NONE) {
-            p_hid_dev->IsOutEP_Present = DEF_FALSE;
-           *p_err                      = USBH_ERR_NONE;
-        } else {
-            p_hid_dev->IsOutEP_Present = DEF_TRUE;
-        }
-    } else {
-        p_hid_dev = (USBH_HID_DEV *)0;
-       *p_err     =  USBH_ERR_CLASS_DRV_NOT_FOUND;
+    (void)USBH_CtrlTx(        p_hid_dev->DevPtr,                /* Send Set protocol request.                           */
+                              USBH_HID_REQ_SET_PROTOCOL,
+                             (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
+                              protocol,
+                              p_hid_dev->IfNbr,
+                      (void *)0,
+                              0u,
+                              USBH_CFG_STD_REQ_TIMEOUT,
+                             &err);
+    if (err == USBH_ERR_NONE) {
+        p_hid_dev->Boot = DEF_TRUE;
     }
 
-    return ((void *)p_hid_dev);
+    USBH_HID_DevUnlock(p_hid_dev);
+
+    return (err);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_HID_Disconn()
+*                                       USBH_HID_ProtocolGet()
 *
-* Description : Handle disconnection of HID device.
+* Description : Get protocol (boot/report) of the HID device.
 *
-* Argument(s) : p_class_dev     Pointer to HID device.
+* Argument(s) : p_hid_dev       Pointer to HID device.
 *
-* Return(s)   : None.
+*               p_protocol      Variable that will receive protocol of the device.
 *
-* Note(s)     : None
+* Return(s)   : USBH_ERR_NONE,                          If protocol was successfully retrieved.
+*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'.
+*               USBH_ERR_DEV_NOT_READY,                 If device is not ready.
+*
+*                                                       ----- RETURNED BY USBH_CtrlRx() : -----
+*               USBH_ERR_UNKNOWN,                       Unknown error occurred.
+*               USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+*                                                       ----- RETURNED BY USBH_HID_DevLock -----
+*               USBH_ERR_NONE,                          If HID device successfully locked.
+*               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
+*
+* Note(s)     : For more information on the 'Get_Protocol' request, see 'Device Class Definition for
+*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.5'.
 *********************************************************************************************************
 */
 
-static  void  USBH_HID_Disconn (void  *p_class_dev)
+USBH_ERR  USBH_HID_ProtocolGet (USBH_HID_DEV  *p_hid_dev,
+                                CPU_INT16U    *p_protocol)
 {
-    LIB_ERR        err_lib;
-    USBH_HID_DEV  *p_hid_dev;
+    USBH_ERR  err;
 
 
-    p_hid_dev = (USBH_HID_DEV *)p_class_dev;
+    if (p_hid_dev == (USBH_HID_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
 
-    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
+    err = USBH_HID_DevLock(p_hid_dev);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
 
-    p_hid_dev->State = USBH_CLASS_DEV_STATE_DISCONN;
+    if (p_hid_dev->IsInit == DEF_FALSE) {
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_DEV_NOT_READY);
+    }
 
-                                                                /* -------------------- CLOSE EPS --------------------- */
+    (void)USBH_CtrlRx(        p_hid_dev->DevPtr,                /* Send Get protocol request.                           */
+                              USBH_HID_REQ_GET_PROTOCOL,
+                             (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
+                              0u,
+                              p_hid_dev->IfNbr,
+                      (void *)p_protocol,
+                              1u,
+                              USBH_CFG_STD_REQ_TIMEOUT,
+                             &err);
+
+    USBH_HID_DevUnlock(p_hid_dev);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HID_IdleSet()
+*
+* Description : Set idle state duration for a given report ID.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+*               report_id       Report id.
+*
+*               dur             Duration of the idle state in milliseconds.
+*
+* Return(s)   : USBH_ERR_NONE,                          If duration is successfully set.
+*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'/'dur'.
+*               USBH_ERR_DEV_NOT_READY.                 If device is not ready.
+*
+*                                                       ----- RETURNED BY USBH_CtrlTx() : -----
+*               USBH_ERR_UNKNOWN                        Unknown error occurred.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+*                                                       ----- RETURNED BY USBH_HID_DevLock -----
+*               USBH_ERR_NONE,                          If HID device successfully locked.
+*               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
+*
+* Note(s)     : For more information on the 'Set_Idle' request, see 'Device Class Definition for
+*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.4'.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_HID_IdleSet (USBH_HID_DEV  *p_hid_dev,
+                            CPU_INT08U     report_id,
+                            CPU_INT32U     dur)
+{
+    USBH_ERR  err;
+
+
+    if (p_hid_dev == (USBH_HID_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    if (dur > USBH_HID_MAX_DUR) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err = USBH_HID_DevLock(p_hid_dev);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    dur = dur / USBH_HID_DUR_RESOLUTION;                        /* Convert into resolution units.                       */
+                                                                /* Send class-specific request.                         */
+    (void)USBH_CtrlTx(        p_hid_dev->DevPtr,
+                              USBH_HID_REQ_SET_IDLE,
+                             (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
+                             (((dur << 8u) & 0xFF00u) | report_id),
+                              p_hid_dev->IfNbr,
+                      (void *)0,
+                              0u,
+                              USBH_CFG_STD_REQ_TIMEOUT,
+                             &err);
+    if (err == USBH_ERR_EP_STALL) {
+        (void)USBH_EP_Reset(           p_hid_dev->DevPtr,
+                            (USBH_EP *)0);
+    }
+
+    USBH_HID_DevUnlock(p_hid_dev);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HID_IdleGet()
+*
+* Description : Get idle duration for given report ID.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+*               report_id       Report id.
+*
+*               p_err           Variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE                           Idle duration successfully retrieved.
+*                   USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_hid_dev'.
+*                   USBH_ERR_DEV_NOT_READY                  Device is not ready.
+*
+*                                                           ----- RETURNED BY USBH_CtrlRx() : -----
+*                   USBH_ERR_UNKNOWN,                       Unknown error occurred.
+*                   USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
+*                   USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
+*                   USBH_ERR_HC_IO,                         Root hub input/output error.
+*                   USBH_ERR_EP_STALL,                      Root hub does not support request.
+*                   Host controller drivers error code,     Otherwise.
+*
+*                                                           ----- RETURNED BY USBH_HID_DevLock -----
+*                   USBH_ERR_NONE,                          If HID device successfully locked.
+*                   USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
+*
+* Return(s)   : Idle duration in milliseconds.
+*
+* Note(s)     : For more information on the 'Get_Idle' request, see 'Device Class Definition for
+*               Human Interface Devices (HID), 6/27/01, Version 1.11, section 7.2.3'.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_HID_IdleGet (USBH_HID_DEV  *p_hid_dev,
+                              CPU_INT08U     report_id,
+                              USBH_ERR      *p_err)
+{
+    CPU_INT32U  dur;
+
+
+    if (p_hid_dev == (USBH_HID_DEV *)0) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (0u);
+    }
+
+   *p_err = USBH_HID_DevLock(p_hid_dev);
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
+    }
+
+    if (p_hid_dev->IsInit == DEF_FALSE) {
+        USBH_HID_DevUnlock(p_hid_dev);
+       *p_err = USBH_ERR_DEV_NOT_READY;
+        return (0u);
+    }
+
+    (void)USBH_CtrlRx(         p_hid_dev->DevPtr,               /* Send the class-specific request.                     */
+                               USBH_HID_REQ_GET_IDLE,
+                              (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
+                               report_id,
+                               p_hid_dev->IfNbr,
+                      (void *)&dur,
+                               1u,
+                               USBH_CFG_STD_REQ_TIMEOUT,
+                               p_err);
+
+    dur = (dur) * USBH_HID_DUR_RESOLUTION;                      /* Convert to ms.                             */
+
+    USBH_HID_DevUnlock(p_hid_dev);
+
+    return (dur);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_HID_PollIntervalSet()
+*
+* Description : Set the interval at which the interrupt IN endpoint of HID device is polled.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+*               interval_us     Polling interval, in microseconds (see Note #1). 0 restores the interval of the
+*                               endpoint descriptor.
+*
+*               p_interval_us   Pointer to variable that will receive the polling interval achieved, in
+*                               microseconds (see Note #2). May be DEF_NULL.
+*
+* Return(s)   : USBH_ERR_NONE,                          If polling interval successfully set.
+*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'p_hid_dev'.
+*               USBH_ERR_EP_INVALID_STATE,              If reception of reports is in progress (see Note #3).
+*
+*                                                       ----- RETURNED BY USBH_HID_DevLock -----
+*               USBH_ERR_NONE,                          If HID device successfully locked.
+*               USBH_ERR_DEV_NOT_READY,                 If HID device not ready.
+*
+*                                                       ----- RETURNED BY USBH_IntrInIntervalOpen() : -----
+*                                                       ----- OR BY USBH_IntrInOpen() (see Note #4) : -----
+*               USBH_ERR_EP_ALLOC                       If USBH_CFG_MAX_NBR_EPS reached.
+*               USBH_ERR_OS_SIGNAL_CREATE,              if mutex or semaphore creation failed.
+*               Host controller drivers error,          Otherwise.
+*
+* Note(s)     : (1) A shorter interval than the one of the endpoint descriptor lowers the input latency of
+*                   the device (e.g. gaming input devices), a longer one saves bus bandwidth and host
+*                   controller activity for devices reporting often (e.g. sensors). Devices may not provide
+*                   new data at a shorter interval than the one of their endpoint descriptor.
+*
+*               (2) The interval is limited to what the bus speed of the device allows & may be rounded by
+*                   the host controller driver (see 'usbh_core.c  USBH_IntrInIntervalOpen()').
+*
+*               (3) The interrupt IN endpoint is re-opened at the new interval, which is only possible while
+*                   no report is being received on it, e.g. after USBH_HID_Init() & before the first receive
+*                   callback is registered with USBH_HID_RegRxCB() or USBH_HID_RegRxChngCB().
+*
+*               (4) If the endpoint cannot be opened at the new interval, it is re-opened at the interval of
+*                   its descriptor and the error of USBH_IntrInIntervalOpen() is returned. If this also
+*                   fails, the endpoint is left closed, the error of USBH_IntrInOpen() is returned and the
+*                   achieved interval is 0.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_HID_PollIntervalSet (USBH_HID_DEV  *p_hid_dev,
+                                    CPU_INT32U     interval_us,
+                                    CPU_INT32U    *p_interval_us)
+{
+    USBH_ERR  err;
+    USBH_ERR  err_open;
+
+
+    if (p_hid_dev == (USBH_HID_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err = USBH_HID_DevLock(p_hid_dev);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    if (p_hid_dev->RxInProg == DEF_TRUE) {                      /* See Note #3.                                         */
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_EP_INVALID_STATE);
+    }
+
+    (void)USBH_EP_Close(&p_hid_dev->IntrInEP);                  /* Re-open intr IN EP at new interval.                  */
+
+    err      = USBH_IntrInIntervalOpen(p_hid_dev->DevPtr,
+                                       p_hid_dev->IfPtr,
+                                       interval_us,
+                                      &p_hid_dev->IntrInEP);
+    err_open = err;
+    if (err != USBH_ERR_NONE) {                                 /* Fall back to interval of EP desc (see Note #4).      */
+        err_open = USBH_IntrInOpen(p_hid_dev->DevPtr,
+                                   p_hid_dev->IfPtr,
+                                  &p_hid_dev->IntrInEP);
+        if (err_open != USBH_ERR_NONE) {
+            err = err_open;
+        }
+    }
+
+    if (p_interval_us != (CPU_INT32U *)0) {                     /* See Note #2.                                         */
+        if (err_open == USBH_ERR_NONE) {
+           *p_interval_us = USBH_EP_IntervalGet(&p_hid_dev->IntrInEP);
+        } else {
+           *p_interval_us = 0u;                                 /* EP left closed.                                      */
+        }
+    }
+
+    USBH_HID_DevUnlock(p_hid_dev);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_HID_ReportDecode()
+*
+* Description : Decode an input report into (usage, value) pairs.
+*
+* Argument(s) : p_hid_dev           Pointer to HID device.
+*
+*               report_id           Report ID of the report.
+*
+*               p_buf               Pointer to report, without report ID prefix, as passed to the callback
+*                                   registered with USBH_HID_RegRxCB().
+*
+*               buf_len             Report length, in octets.
+*
+*               p_usage_val         Pointer to array that will receive the (usage, value) pairs.
+*
+*               nbr_usage_val       Number of entries of 'p_usage_val'.
+*
+*               p_err               Variable that will receive the return error code from this function.
+*                                   USBH_ERR_NONE,                  Report successfully decoded.
+*                                   USBH_ERR_INVALID_ARG,           Invalid argument passed to 'p_hid_dev' /
+*                                                                   'p_buf' / 'p_usage_val'.
+*                                   USBH_ERR_DEV_NOT_READY,         Device is not ready.
+*                                   USBH_ERR_HID_REPORT_ID,         No input report with given report ID.
+*                                   USBH_ERR_ALLOC,                 'p_usage_val' too small, report partially
+*                                                                   decoded.
+*
+* Return(s)   : Number of (usage, value) pairs stored in 'p_usage_val'.
+*
+* Note(s)     : (1) Fields are decoded from the table built when the device is initialized (see
+*                   'usbh_hidparser.c  USBH_HID_CreateFieldTbl()'), in a single pass over the report. The
+*                   table is not modified afterwards, so the device is not locked, and this function may
+*                   be called from a report callback.
+*
+*               (2) A variable element returns its usage and its value, sign extended if the logical
+*                   minimum is negative.
+*
+*               (3) An array element returns the usage it selects, with a value of 1. Elements whose index
+*                   is out of the logical range, or that select usage ID 0 (no event), are skipped.
+*
+*               (4) Elements not entirely contained in 'buf_len' octets are skipped.
+*
+*               (5) The report layout is the one of the report descriptor. A device set to the boot
+*                   protocol only follows it if its report descriptor describes the boot report.
+*********************************************************************************************************
+*/
+
+CPU_INT16U  USBH_HID_ReportDecode (USBH_HID_DEV        *p_hid_dev,
+                                   CPU_INT08U           report_id,
+                                   void                *p_buf,
+                                   CPU_INT08U           buf_len,
+                                   USBH_HID_USAGE_VAL  *p_usage_val,
+                                   CPU_INT16U           nbr_usage_val,
+                                   USBH_ERR            *p_err)
+{
+    USBH_HID_REPORT_ID  *p_report_id;
+    USBH_HID_FIELD      *p_field;
+    USBH_HID_FIELD      *p_field_end;
+    CPU_INT32U           bit_len;
+    CPU_INT32U           usage;
+    CPU_INT32S           val;
+    CPU_INT16U           cnt;
+    CPU_INT08U           report_id_ix;
+
+
+    if ((p_hid_dev   == (USBH_HID_DEV       *)0) ||
+        (p_buf       == (void               *)0) ||
+        (p_usage_val == (USBH_HID_USAGE_VAL *)0)) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (0u);
+    }
+
+    if (p_hid_dev->IsInit == DEF_FALSE) {                       /* See Note #1.                                         */
+       *p_err = USBH_ERR_DEV_NOT_READY;
+        return (0u);
+    }
+
+    p_report_id = (USBH_HID_REPORT_ID *)0;
+    for (report_id_ix = 0u; report_id_ix < p_hid_dev->RD_Ptr->NbrReportID; report_id_ix++) {
+        if ((p_hid_dev->RD_Ptr->ReportID[report_id_ix].ReportID == report_id) &&
+            (p_hid_dev->RD_Ptr->ReportID[report_id_ix].Type     == USBH_HID_MAIN_ITEM_TAG_IN)) {
+            p_report_id = &p_hid_dev->RD_Ptr->ReportID[report_id_ix];
+            break;
+        }
+    }
+
+    if (p_report_id == (USBH_HID_REPORT_ID *)0) {
+       *p_err = USBH_ERR_HID_REPORT_ID;
+        return (0u);
+    }
+
+    bit_len     = (CPU_INT32U)buf_len * DEF_OCTET_NBR_BITS;
+    p_field     = &p_hid_dev->RD_Ptr->Field[p_report_id->FieldIx];
+    p_field_end =  p_field + p_report_id->NbrField;
+    cnt         =  0u;
+   *p_err       =  USBH_ERR_NONE;
+
+    for (; p_field < p_field_end; p_field++) {
+        if (((CPU_INT32U)p_field->BitOff + p_field->BitSize) > bit_len) {
+            continue;                                           /* See Note #4.                                         */
+        }
+
+        val   = USBH_HID_FieldRd(p_field, (CPU_INT08U *)p_buf);
+        usage = USBH_HID_FieldUsageGet(p_field, val);           /* See Note #2.                                         */
+
+        if (p_field->IsArray == DEF_TRUE) {                     /* See Note #3.                                         */
+            if (usage == 0u) {
+                continue;
+            }
+            val = 1;
+        }
+
+        if (cnt >= nbr_usage_val) {
+           *p_err = USBH_ERR_ALLOC;
+            break;
+        }
+
+        p_usage_val[cnt].Usage = usage;
+        p_usage_val[cnt].Val   = val;
+        cnt++;
+    }
+
+    return (cnt);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTION
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_HID_GlobalInit()
+*
+* Description : This function is used to initialize the global variables
+*
+* Argument(s) : p_err       Variable that will receive the return error code from this function.
+*                           USBH_ERR_NONE,                  Idle duration successfully retrieved.
+*                           USBH_ERR_INVALID_ARG,           Invalid argument passed to 'p_hid_dev'.
+*                           USBH_ERR_DEV_NOT_READY,         Device is not ready.
+*
+*                           USBH_ERR_OS_SIGNAL_CREATE,      if report descriptor cache mutex creation failed.
+*
+*                                                           ----- RETURNED BY USBH_HID_ParserGlobalInit -----
+*                           USBH_ERR_NONE.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HID_GlobalInit (USBH_ERR  *p_err)
+{
+    CPU_INT08U  ix;
+    LIB_ERR     err_lib;
+    CPU_SIZE_T  octets_reqd;
+
+                                                                /* --------------- INIT HID DEV STRUCT ---------------- */
+    for (ix = 0u; ix < USBH_HID_CFG_MAX_DEV; ix++) {
+        (void)USBH_OS_MutexCreate(&USBH_HID_DevArr[ix].HMutex); /* Mutex for protection from multiple app access.       */
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+        (void)USBH_OS_SemCreate(&USBH_HID_DevArr[ix].RxQ_Sem,   /* Sem for rx Q.                                        */
+                                 0u);
+#endif
+    }
+
+    Mem_PoolCreate (       &USBH_HID_DevPool,                   /* POOL for managing HID dev struct.                    */
+                    (void *)USBH_HID_DevArr,
+                            sizeof(USBH_HID_DEV) * USBH_HID_CFG_MAX_DEV,
+                            USBH_HID_CFG_MAX_DEV,
+                            sizeof(USBH_HID_DEV),
+                            sizeof(CPU_ALIGN),
+                           &octets_reqd,
+                           &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+       *p_err = USBH_ERR_ALLOC;
+        return;
+    }
+                                                                /* ------------- INIT REPORT DESC CACHE --------------- */
+    Mem_Clr((void *)USBH_HID_RD_Tbl,
+                    sizeof(USBH_HID_RD_Tbl));
+    Mem_Clr((void *)&USBH_HID_RD_CacheStat,
+                    sizeof(USBH_HID_RD_CacheStat));
+    USBH_HID_RD_UseSeq = 0u;
+
+   *p_err = USBH_OS_MutexCreate(&USBH_HID_RD_Mutex);
+    if (*p_err != USBH_ERR_NONE) {
+        return;
+    }
+
+   *p_err = USBH_HID_ParserGlobalInit();                        /* Init HID parser struct.                              */
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HID_ProbeIF()
+*
+* Description : Determine if the interface is HID class interface.
+*
+* Argument(s) : p_dev       Pointer to USB device.
+*
+*               p_if        Pointer to interface.
+*
+*               p_err       Variable that will receive the return error code from this function.
+*                           USBH_ERR_NONE                       Interface is of HID type.
+*                           USBH_ERR_DEV_ALLOC                  Cannot allocate HID device.
+*                           USBH_ERR_CLASS_DRV_NOT_FOUND        Interface is not of HID type.
+*
+*                                                               ----- RETURNED BY USBH_IF_DescGet() : -----
+*                           USBH_ERR_INVALID_ARG,               Invalid argument passed to 'alt_ix'.
+*
+*                                                               ----- RETURNED BY USBH_IntrInOpen() : -----
+*                           USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*                           USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
+*                           USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*                           Host controller drivers error,      Otherwise.
+*
+*                                                               ----- RETURNED BY USBH_IntrOutOpen() : -----
+*                           USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*                           USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
+*                           USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*                           Host controller drivers error,      Otherwise.
+*
+* Return(s)   : p_hid_dev,      If device has a HID class interface.
+*               0,              Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  *USBH_HID_ProbeIF (USBH_DEV  *p_dev,
+                                 USBH_IF   *p_if,
+                                 USBH_ERR  *p_err)
+{
+    USBH_IF_DESC   p_if_desc;
+    USBH_HID_DEV  *p_hid_dev;
+    LIB_ERR        err_lib;
+
+
+   *p_err = USBH_IF_DescGet(p_if, 0u, &p_if_desc);              /* Get IF desc from IF.                                 */
+    if (*p_err != USBH_ERR_NONE) {
+        return ((void *)0);
+    }
+                                                                /* Check for HID class code.                            */
+    if (p_if_desc.bInterfaceClass == USBH_CLASS_CODE_HID){
+                                                                /* Alloc a dev from HID dev pool.                       */
+        p_hid_dev = (USBH_HID_DEV *)Mem_PoolBlkGet(           &USBH_HID_DevPool,
+                                                   (CPU_SIZE_T)sizeof(USBH_HID_DEV),
+                                                              &err_lib);
+        if (err_lib != LIB_MEM_ERR_NONE) {
+           *p_err = USBH_ERR_DEV_ALLOC;
+            return ((void *)0);
+        }
+
+        USBH_HID_DevClr(p_hid_dev);
+        p_hid_dev->State    = USBH_CLASS_DEV_STATE_CONN;
+        p_hid_dev->RxInProg = DEF_FALSE;
+        p_hid_dev->IsInit   = DEF_FALSE;
+        p_hid_dev->DevPtr   = p_dev;
+        p_hid_dev->IfPtr    = p_if;
+        p_hid_dev->IfNbr    = p_if_desc.bInterfaceNumber;
+        p_hid_dev->SubClass = p_if_desc.bInterfaceSubClass;
+        p_hid_dev->Protocol = p_if_desc.bInterfaceProtocol;
+
+       *p_err = USBH_IntrInOpen(p_hid_dev->DevPtr,              /* Open intr IN EP.                                     */
+                                p_hid_dev->IfPtr,
+                               &p_hid_dev->IntrInEP);
+        if (*p_err != USBH_ERR_NONE) {
+            Mem_PoolBlkFree(       &USBH_HID_DevPool,
+                            (void *)p_hid_dev,
+                                   &err_lib);
+            return ((void *)0);
+        }
+
+       *p_err = USBH_IntrOutOpen(p_hid_dev->DevPtr,             /* Try to open optional intr OUT EP.                    */
+                                 p_hid_dev->IfPtr,
+                                &p_hid_dev->IntrOutEP);
+        if (*p_err != USBH_ERR_NONE) {
+            p_hid_dev->IsOutEP_Present = DEF_FALSE;
+           *p_err                      = USBH_ERR_NONE;
+        } else {
+            p_hid_dev->IsOutEP_Present = DEF_TRUE;
+        }
+    } else {
+        p_hid_dev = (USBH_HID_DEV *)0;
+       *p_err     =  USBH_ERR_CLASS_DRV_NOT_FOUND;
+    }
+
+    return ((void *)p_hid_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HID_Disconn()
+*
+* Description : Handle disconnection of HID device.
+*
+* Argument(s) : p_class_dev     Pointer to HID device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None
+*********************************************************************************************************
+*/
+
+static  void  USBH_HID_Disconn (void  *p_class_dev)
+{
+    LIB_ERR        err_lib;
+    USBH_HID_DEV  *p_hid_dev;
+
+
+    p_hid_dev = (USBH_HID_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
+
+    p_hid_dev->State = USBH_CLASS_DEV_STATE_DISCONN;
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    (void)USBH_OS_SemWaitAbort(p_hid_dev->RxQ_Sem);             /* Wake tasks waiting on rx Q.                          */
+#endif
+
+                                                                /* -------------------- CLOSE EPS --------------------- */
     USBH_EP_Close(&p_hid_dev->IntrInEP);
 
-    if (p_hid_dev->IsOutEP_Present == DEF_TRUE) {
-        USBH_EP_Close(&p_hid_dev->IntrOutEP);
+    if (p_hid_dev->IsOutEP_Present == DEF_TRUE) {
+        USBH_EP_Close(&p_hid_dev->IntrOutEP);
+    }
+
+    p_hid_dev->IsInit = DEF_FALSE;
+    USBH_HID_RD_Release(p_hid_dev);                             /* Release parsed report desc.                          */
+
+    if (p_hid_dev->AppRefCnt == 0u) {                           /* Release HID dev if app reference count is zero.      */
+        (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+        Mem_PoolBlkFree(       &USBH_HID_DevPool,               /* App refcnt is 0 and Dev is removed, release HID dev. */
+                        (void *)p_hid_dev,
+                               &err_lib);
+    }
+
+    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HID_Suspend()
+*
+* Description : Suspend HID device, waits for completion of any pending I/O.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HID_Suspend (void  *p_class_dev)
+{
+    USBH_HID_DEV  *p_hid_dev;
+
+
+    p_hid_dev = (USBH_HID_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
+
+    p_hid_dev->State = USBH_CLASS_DEV_STATE_SUSPEND;
+
+    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_HID_Resume()
+*
+* Description : Resume HID device.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HID_Resume (void  *p_class_dev)
+{
+    USBH_HID_DEV  *p_hid_dev;
+
+
+    p_hid_dev = (USBH_HID_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
+
+    p_hid_dev->State = USBH_CLASS_DEV_STATE_CONN;
+
+    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_HID_DevClr()
+*
+* Description : Clear HID device structure.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HID_DevClr (USBH_HID_DEV  *p_hid_dev)
+{
+    USBH_HMUTEX  h_mutex;
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    USBH_HSEM    h_sem;
+#endif
+
+
+    h_mutex = p_hid_dev->HMutex;                                /* Save mutex var.                                      */
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    h_sem   = p_hid_dev->RxQ_Sem;                               /* Save rx Q sem var.                                   */
+#endif
+
+    Mem_Clr((void *)p_hid_dev, sizeof(USBH_HID_DEV));
+
+    p_hid_dev->State  = USBH_CLASS_DEV_STATE_NONE;
+    p_hid_dev->HMutex = h_mutex;                                /* Restore mutex var.                                   */
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    p_hid_dev->RxQ_Sem = h_sem;                                 /* Restore rx Q sem var.                                */
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HID_DevLock()
+*
+* Description : Lock HID device.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+* Return(s)   : USBH_ERR_NONE,              If HID device successfully locked.
+*               USBH_ERR_DEV_NOT_READY,     If HID device not ready.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_HID_DevLock (USBH_HID_DEV  *p_hid_dev)
+{
+    CPU_INT08U  state;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    state = p_hid_dev->State;
+    CPU_CRITICAL_EXIT();
+
+    if (state != USBH_CLASS_DEV_STATE_CONN) {
+        return (USBH_ERR_DEV_NOT_READY);
     }
 
-    if (p_hid_dev->AppRefCnt == 0u) {                           /* Release HID dev if app reference count is zero.      */
+    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
+    if (p_hid_dev->State != USBH_CLASS_DEV_STATE_CONN) {
         (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
-        Mem_PoolBlkFree(       &USBH_HID_DevPool,               /* App refcnt is 0 and Dev is removed, release HID dev. */
-                        (void *)p_hid_dev,
-                               &err_lib);
+        return (USBH_ERR_DEV_NOT_READY);
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_HID_DevUnlock()
+*
+* Description : Unlock HID device.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HID_DevUnlock (USBH_HID_DEV  *p_hid_dev)
+{
+    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_HID_TxData()
+*
+* Description : Send data (report) to HID device.
+*
+* Argument(s) : p_hid_dev        Pointer to HID device.
+*
+*               report_id        Report Id.
+*
+*               p_buf            Pointer to buffer that contains the report.
+*
+*               buf_len          Buffer length, in octets.
+*
+*               timeout_ms       Timeout, in milliseconds.
+*
+*               p_err       Variable that will receive the return error code from this function.
+*
+*                           USBH_ERR_NONE                           Report successfully transmitted.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'buf_len'.
+*                           USBH_ERR_NULL_PTR                       Invalid null pointer passed to 'p_buf'.
+*                           USBH_ERR_CLASS_DRV_NOT_FOUND            Interface is not of HID type.
+*
+*                                                                   ----- RETURNED BY USBH_IntrTx() : -----
+*                           USBH_ERR_NONE                           Interrupt transfer successfully transmitted.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not OUT.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
+*                           Host controller drivers error code,     Otherwise.
+*
+*                                                                   ----- RETURNED BY USBH_CtrlTx() : -----
+*                           USBH_ERR_UNKNOWN                        Unknown error occurred.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           USBH_ERR_HC_IO,                         Root hub input/output error.
+*                           USBH_ERR_EP_STALL,                      Root hub does not support request.
+*                           Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets sent.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_HID_TxData (USBH_HID_DEV  *p_hid_dev,
+                                     CPU_INT08U     report_id,
+                                     void          *p_buf,
+                                     CPU_INT32U     buf_len,
+                                     CPU_INT16U     timeout_ms,
+                                     USBH_ERR      *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+
+    if ((p_buf   == (void *)0 ) ||
+        (buf_len ==         0u)) {
+        *p_err = USBH_ERR_NULL_PTR;
+         return (0u);
+    }
+                                                                /* Use optional intr OUT EP if available.               */
+    if (p_hid_dev->IsOutEP_Present == DEF_TRUE) {
+
+        if (report_id != 0u) {                                  /* Copy report id and buf if report is non zero.        */
+
+            if (buf_len > USBH_HID_CFG_MAX_TX_BUF_SIZE) {
+               *p_err = USBH_ERR_INVALID_ARG;
+                return (0u);
+            }
+
+            p_hid_dev->TxBuf[0] = report_id;                    /* First byte should be report id.                      */
+            Mem_Copy((void *)&p_hid_dev->TxBuf[1],
+                              p_buf,
+                              buf_len);
+
+            xfer_len = USBH_IntrTx(&p_hid_dev->IntrOutEP,
+                                    p_hid_dev->TxBuf,
+                                    buf_len + 1u,
+                                    timeout_ms,
+                                    p_err);
+            if ((*p_err    == USBH_ERR_NONE) &&
+                ( xfer_len != 0u           )) {
+                xfer_len--;
+            }
+        } else {
+            xfer_len = USBH_IntrTx(&p_hid_dev->IntrOutEP,
+                                    p_buf,
+                                    buf_len,
+                                    timeout_ms,
+                                    p_err);
+        }
+    } else {
+                                                                /* Send report via ctrl EP if intr OUT not available.   */
+        xfer_len = USBH_CtrlTx(p_hid_dev->DevPtr,
+                               USBH_HID_REQ_SET_REPORT,
+                              (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
+                              (((USBH_HID_REPORT_TYPE_OUT << 8u) & 0xFF00u) | report_id),
+                               p_hid_dev->IfNbr,
+                               p_buf,
+                               buf_len,
+                               timeout_ms,
+                               p_err);
+    }
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_HID_RxData()
+*
+* Description : Receive data (report) from device.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+*               report_id       Report id.
+*
+*               p_buf           Pointer to buffer that will receive the report.
+*
+*               buf_len         Buffer length, in octets.
+*
+*               timeout_ms      Timeout, in milliseconds.
+*
+*               p_err       Variable that will receive the return error code from this function.
+*
+*                           USBH_ERR_NONE                           Report successfully received.
+*                           USBH_ERR_NULL_PTR                       Invalid null pointer passed to 'p_buf'.
+*
+*                                                                   ----- RETURNED BY USBH_IntrRx() : -----
+*                           USBH_ERR_NONE                           Interrupt transfer successfully received.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not IN.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
+*                           Host controller drivers error code,     Otherwise.
+*
+*                                                                   ----- RETURNED BY USBH_CtrlRx() : -----
+*                           USBH_ERR_UNKNOWN,                       Unknown error occurred.
+*                           USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
+*                           USBH_ERR_HC_IO,                         Root hub input/output error.
+*                           USBH_ERR_EP_STALL,                      Root hub does not support request.
+*                           Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets received.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_HID_RxData (USBH_HID_DEV  *p_hid_dev,
+                                     CPU_INT08U     report_id,
+                                     void          *p_buf,
+                                     CPU_INT32U     buf_len,
+                                     CPU_INT16U     timeout_ms,
+                                     USBH_ERR      *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+
+    if ((p_buf   == (void *)0 ) ||
+        (buf_len ==         0u)) {
+       *p_err = USBH_ERR_NULL_PTR;
+        return (0u);
+    }
+
+    if ((report_id           !=       0u) ||                    /* If report ID 0 specified or intr IN EP busy, use ... */
+        (p_hid_dev->RxInProg == DEF_TRUE)) {                    /* ... ctrl EP.                                         */
+        xfer_len = USBH_CtrlRx(p_hid_dev->DevPtr,
+                               USBH_HID_REQ_GET_REPORT,
+                              (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
+                              (((USBH_HID_REPORT_TYPE_IN << 8u) & 0xFF00u) | report_id),
+                               p_hid_dev->IfNbr,
+                               p_buf,
+                               buf_len,
+                               timeout_ms,
+                               p_err);
+    } else {                                                    /* Rcv report on intr IN EP.                            */
+        xfer_len = USBH_IntrRx(&p_hid_dev->IntrInEP,
+                                p_buf,
+                                buf_len,
+                                timeout_ms,
+                                p_err);
     }
 
-    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+    return (xfer_len);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_HID_Suspend()
+*                                        USBH_HID_RxCB_Add()
 *
-* Description : Suspend HID device, waits for completion of any pending I/O.
+* Description : Register a callback function to receive reports or usage changes from device.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : p_hid_dev        Pointer to HID device.
 *
-* Return(s)   : None.
+*               report_id        Report id.
+*
+*               async_fnct       Report callback function, if 'filter' is not USBH_HID_RX_FILTER_USAGE.
+*
+*               chng_fnct        Usage change callback function, if 'filter' is USBH_HID_RX_FILTER_USAGE.
+*
+*               p_async_arg      Pointer to context that will be passed to callback function.
+*
+*               filter           Receive filter (see 'usbh_hid.h  HID RECEIVE FILTERS').
+*
+*               dead_band        Dead band of absolute axes.
+*
+* Return(s)   : USBH_ERR_NONE,                  If callback successfully registered.
+*               USBH_ERR_DEV_NOT_READY,         If device is not ready.
+*               USBH_ERR_HID_NOT_IN_REPORT,     If incorrect report descriptor provided by device.
+*               USBH_ERR_ALLOC,                 If rx callback cannot be allocated.
+*               USBH_ERR_HID_REPORT_ID,         If callback with same report ID is already registered.
+*
+*                                               ----- RETURNED BY USBH_HID_DevLock -----
+*               USBH_ERR_NONE,                  If HID device successfully locked.
+*               USBH_ERR_DEV_NOT_READY,         If HID device not ready.
 *
 * Note(s)     : None.
 *********************************************************************************************************
 */
 
-static  void  USBH_HID_Suspend (void  *p_class_dev)
+static  USBH_ERR  USBH_HID_RxCB_Add (USBH_HID_DEV        *p_hid_dev,
+                                     CPU_INT08U           report_id,
+                                     USBH_HID_RXCB_FNCT   async_fnct,
+                                     USBH_HID_CHNG_FNCT   chng_fnct,
+                                     void                *p_async_arg,
+                                     CPU_INT08U           filter,
+                                     CPU_INT32U           dead_band)
 {
-    USBH_HID_DEV  *p_hid_dev;
+    CPU_INT08U      ix;
+    CPU_INT32U      report_len_bytes;
+    USBH_HID_RXCB  *p_rx_cb;
+    USBH_ERR        err;
 
 
-    p_hid_dev = (USBH_HID_DEV *)p_class_dev;
+    err = USBH_HID_DevLock(p_hid_dev);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
 
-    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
+    if (p_hid_dev->IsInit == DEF_FALSE) {
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_DEV_NOT_READY);
+    }
 
-    p_hid_dev->State = USBH_CLASS_DEV_STATE_SUSPEND;
+    if (p_hid_dev->MaxReportPtr == (USBH_HID_REPORT_ID *)0) {
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_HID_NOT_IN_REPORT);
+    }
+                                                                /* Check max buf size to recv data.                     */
+    report_len_bytes = (p_hid_dev->MaxReportPtr->Size / 8u);
+    if ((p_hid_dev->MaxReportPtr->Size % 8u) != 0u) {
+        report_len_bytes++;
+    }
 
-    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
-}
+    if (report_len_bytes > USBH_HID_CFG_MAX_RX_BUF_SIZE) {
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_ALLOC);
+    }
 
+    for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {       /* Check already reg callback with same report id.      */
 
-/*
-*********************************************************************************************************
-*                                          USBH_HID_Resume()
-*
-* Description : Resume HID device.
-*
-* Argument(s) : p_hid_dev       Pointer to HID device.
-*
-* Return(s)   : None.
-*
-* Note(s)     : None.
-*********************************************************************************************************
-*/
+        if ((p_hid_dev->RxCB[ix].InUse    == DEF_TRUE) &&
+            (p_hid_dev->RxCB[ix].ReportID == report_id)) {
+            USBH_HID_DevUnlock(p_hid_dev);
+            return (USBH_ERR_HID_REPORT_ID);
+        }
+    }
 
-static  void  USBH_HID_Resume (void  *p_class_dev)
-{
-    USBH_HID_DEV  *p_hid_dev;
+    p_rx_cb = (USBH_HID_RXCB *)0;                               /* Search for empty callback structure.                 */
+    for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {
 
+        if (p_hid_dev->RxCB[ix].InUse == DEF_FALSE) {
+            p_rx_cb = &p_hid_dev->RxCB[ix];
+            break;
+        }
+    }
 
-    p_hid_dev = (USBH_HID_DEV *)p_class_dev;
+    if (p_rx_cb == (USBH_HID_RXCB *)0) {
+        USBH_HID_DevUnlock(p_hid_dev);
+        return (USBH_ERR_ALLOC);
+    }
+                                                                /* Fill callback structure.                             */
+    p_rx_cb->ReportID    = report_id;
+    p_rx_cb->AsyncFnct   = async_fnct;
+    p_rx_cb->ChngFnct    = chng_fnct;
+    p_rx_cb->AsyncArgPtr = p_async_arg;
+    p_rx_cb->Filter      = filter;
+    p_rx_cb->DeadBand    = dead_band;
+    p_rx_cb->LastValid   = DEF_FALSE;
+    p_rx_cb->InUse       = DEF_TRUE;
 
-    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
+    if (p_hid_dev->RxInProg == DEF_FALSE) {                     /* Receive Async if not started                         */
+        err = USBH_HID_RxStart(p_hid_dev);
+    } else {
+        err = USBH_ERR_NONE;
+    }
 
-    p_hid_dev->State = USBH_CLASS_DEV_STATE_CONN;
+    USBH_HID_DevUnlock(p_hid_dev);
 
-    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+    return (err);
 }
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_HID_DevClr()
+*                                          USBH_HID_ChngAdd()
 *
-* Description : Clear HID device structure.
+* Description : Add usage change to the list delivered to application.
 *
 * Argument(s) : p_hid_dev       Pointer to HID device.
 *
+*               p_rx_cb         Pointer to copy of receive callback of report.
+*
+*               p_chng_cnt      Pointer to number of changes in list.
+*
+*               usage           Usage that changed.
+*
+*               val_old         Last delivered value.
+*
+*               val_new         New value.
+*
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) A full list is delivered right away (see USBH_HID_RegRxChngCB() Note #2).
 *********************************************************************************************************
 */
 
-static  void  USBH_HID_DevClr (USBH_HID_DEV  *p_hid_dev)
+static  void  USBH_HID_ChngAdd (USBH_HID_DEV   *p_hid_dev,
+                                USBH_HID_RXCB  *p_rx_cb,
+                                CPU_INT16U     *p_chng_cnt,
+                                CPU_INT32U      usage,
+                                CPU_INT32S      val_old,
+                                CPU_INT32S      val_new)
 {
-    USBH_HMUTEX  h_mutex;
-
-
-    h_mutex = p_hid_dev->HMutex;                                /* Save mutex var.                                      */
+    if (p_rx_cb->Filter != USBH_HID_RX_FILTER_USAGE) {         /* Whole report is delivered.                           */
+        return;
+    }
 
-    Mem_Clr((void *)p_hid_dev, sizeof(USBH_HID_DEV));
+    p_hid_dev->Chng[*p_chng_cnt].Usage  = usage;
+    p_hid_dev->Chng[*p_chng_cnt].ValOld = val_old;
+    p_hid_dev->Chng[*p_chng_cnt].ValNew = val_new;
+   (*p_chng_cnt)++;
 
-    p_hid_dev->State  = USBH_CLASS_DEV_STATE_NONE;
-    p_hid_dev->HMutex = h_mutex;                                /* Restore mutex var.                                   */
+    if (*p_chng_cnt == USBH_HID_CFG_MAX_NBR_FIELD) {            /* See Note #1.                                         */
+        p_rx_cb->ChngFnct(p_rx_cb->AsyncArgPtr, p_hid_dev->Chng, *p_chng_cnt, USBH_ERR_NONE);
+       *p_chng_cnt = 0u;
+    }
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_HID_DevLock()
+*                                        USBH_HID_FieldUsageGet()
 *
-* Description : Lock HID device.
+* Description : Get usage of report field, for given field value.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : p_field     Pointer to field.
 *
-* Return(s)   : USBH_ERR_NONE,              If HID device successfully locked.
-*               USBH_ERR_DEV_NOT_READY,     If HID device not ready.
+*               val         Field value.
 *
-* Note(s)     : None.
+* Return(s)   : Usage of variable field,
+*               usage selected by array field, or
+*               0, if array field selects no usage.
+*
+* Note(s)     : (1) An array index out of the logical range, or that selects usage ID 0 (no event), selects
+*                   no usage.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_HID_DevLock (USBH_HID_DEV  *p_hid_dev)
+static  CPU_INT32U  USBH_HID_FieldUsageGet (USBH_HID_FIELD  *p_field,
+                                            CPU_INT32S       val)
 {
-    CPU_INT08U  state;
-    CPU_SR_ALLOC();
+    USBH_HID_REPORT_FMT  *p_report_fmt;
+    CPU_INT32U            usage;
+    CPU_INT32U            ix;
 
 
-    CPU_CRITICAL_ENTER();
-    state = p_hid_dev->State;
-    CPU_CRITICAL_EXIT();
+    if (p_field->IsArray == DEF_FALSE) {
+        return (p_field->Usage);
+    }
 
-    if (state != USBH_CLASS_DEV_STATE_CONN) {
-        return (USBH_ERR_DEV_NOT_READY);
+    if (val < p_field->LogMin) {                                /* See Note #1.                                         */
+        return (0u);
     }
 
-    (void)USBH_OS_MutexLock(p_hid_dev->HMutex);
-    if (p_hid_dev->State != USBH_CLASS_DEV_STATE_CONN) {
-        (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
-        return (USBH_ERR_DEV_NOT_READY);
+    p_report_fmt = p_field->ReportFmtPtr;
+    ix           = (CPU_INT32U)(val - p_field->LogMin);
+
+    if (ix < p_report_fmt->NbrUsage) {
+        usage = p_report_fmt->Usage[ix];
+    } else if ((p_field->Usage != 0u) &&
+               (ix <= (p_report_fmt->UsageMax - p_report_fmt->UsageMin))) {
+        usage = p_field->Usage + ix;
+    } else {
+        return (0u);
     }
 
-    return (USBH_ERR_NONE);
+    if ((usage & DEF_INT_16_MASK) == 0u) {
+        return (0u);
+    }
+
+    return (usage);
 }
 
 
 /*
 *********************************************************************************************************
-*                                        USBH_HID_DevUnlock()
+*                                       USBH_HID_ArrUsageIsSel()
 *
-* Description : Unlock HID device.
+* Description : Check if a usage is selected by one of the array fields of a report.
 *
 * Argument(s) : p_hid_dev       Pointer to HID device.
 *
-* Return(s)   : None.
+*               p_report_id     Pointer to input report ID.
+*
+*               p_buf           Pointer to new report, or null pointer to check the last delivered values.
+*
+*               bit_len         Length of new report, in bits.
+*
+*               usage           Usage to look for.
+*
+* Return(s)   : DEF_YES, if usage is selected.
+*               DEF_NO,  otherwise.
 *
 * Note(s)     : None.
 *********************************************************************************************************
 */
 
-static  void  USBH_HID_DevUnlock (USBH_HID_DEV  *p_hid_dev)
+static  CPU_BOOLEAN  USBH_HID_ArrUsageIsSel (USBH_HID_DEV        *p_hid_dev,
+                                             USBH_HID_REPORT_ID  *p_report_id,
+                                             CPU_INT08U          *p_buf,
+                                             CPU_INT32U           bit_len,
+                                             CPU_INT32U           usage)
 {
-    (void)USBH_OS_MutexUnlock(p_hid_dev->HMutex);
+    USBH_HID_FIELD  *p_field;
+    CPU_INT16U       field_ix;
+    CPU_INT32S       val;
+
+
+    for (field_ix = p_report_id->FieldIx; field_ix < (p_report_id->FieldIx + p_report_id->NbrField); field_ix++) {
+        p_field = &p_hid_dev->RD_Ptr->Field[field_ix];
+
+        if (p_field->IsArray == DEF_FALSE) {
+            continue;
+        }
+
+        if (p_buf == (CPU_INT08U *)0) {
+            val = p_hid_dev->FieldVal[field_ix];
+        } else if (((CPU_INT32U)p_field->BitOff + p_field->BitSize) <= bit_len) {
+            val = USBH_HID_FieldRd(p_field, p_buf);
+        } else {
+            continue;
+        }
+
+        if (USBH_HID_FieldUsageGet(p_field, val) == usage) {
+            return (DEF_YES);
+        }
+    }
+
+    return (DEF_NO);
 }
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_HID_TxData()
+*                                        USBH_HID_ChngProcess()
 *
-* Description : Send data (report) to HID device.
-*
-* Argument(s) : p_hid_dev        Pointer to HID device.
-*
-*               report_id        Report Id.
-*
-*               p_buf            Pointer to buffer that contains the report.
+* Description : Compare received report with last delivered values and deliver changes to application.
 *
-*               buf_len          Buffer length, in octets.
+* Argument(s) : p_hid_dev       Pointer to HID device.
 *
-*               timeout_ms       Timeout, in milliseconds.
+*               p_rx_cb         Pointer to copy of receive callback of report.
 *
-*               p_err       Variable that will receive the return error code from this function.
+*               p_buf           Pointer to report, without report ID prefix.
 *
-*                           USBH_ERR_NONE                           Report successfully transmitted.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'buf_len'.
-*                           USBH_ERR_NULL_PTR                       Invalid null pointer passed to 'p_buf'.
-*                           USBH_ERR_CLASS_DRV_NOT_FOUND            Interface is not of HID type.
+*               buf_len         Report length, in octets.
 *
-*                                                                   ----- RETURNED BY USBH_IntrTx() : -----
-*                           USBH_ERR_NONE                           Interrupt transfer successfully transmitted.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not OUT.
-*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
-*                           Host controller drivers error code,     Otherwise.
+* Return(s)   : None.
 *
-*                                                                   ----- RETURNED BY USBH_CtrlTx() : -----
-*                           USBH_ERR_UNKNOWN                        Unknown error occurred.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           USBH_ERR_HC_IO,                         Root hub input/output error.
-*                           USBH_ERR_EP_STALL,                      Root hub does not support request.
-*                           Host controller drivers error code,     Otherwise.
+* Note(s)     : (1) See USBH_HID_RegRxChngCB() Note #1 for the change rules. Changes are computed in two
+*                   passes over the fields of the report: variable fields first, then the usages that
+*                   array fields no longer select and the ones they newly select. The values of array
+*                   fields are only updated once both are known.
 *
-* Return(s)   : Number of octets sent.
+*               (2) The receive callback of a report ID is only invoked from the dispatch of the reports
+*                   of its device, one at a time. The last delivered values are thus accessed without
+*                   locking the device.
 *
-* Note(s)     : None.
+*               (3) The values of array fields always become the last delivered ones: when no selected
+*                   usage changed, they only differ by their order. When a changed report is delivered as a
+*                   whole, all its values become the last delivered ones, including axes that moved within
+*                   the dead band.
 *********************************************************************************************************
 */
 
-static  CPU_INT32U  USBH_HID_TxData (USBH_HID_DEV  *p_hid_dev,
-                                     CPU_INT08U     report_id,
-                                     void          *p_buf,
-                                     CPU_INT32U     buf_len,
-                                     CPU_INT16U     timeout_ms,
-                                     USBH_ERR      *p_err)
+static  void  USBH_HID_ChngProcess (USBH_HID_DEV   *p_hid_dev,
+                                    USBH_HID_RXCB  *p_rx_cb,
+                                    CPU_INT08U     *p_buf,
+                                    CPU_INT08U      buf_len)
 {
-    CPU_INT32U  xfer_len;
-
+    USBH_HID_REPORT_ID  *p_report_id;
+    USBH_HID_FIELD      *p_field;
+    CPU_INT32U           bit_len;
+    CPU_INT32U           usage;
+    CPU_INT32U           diff;
+    CPU_INT32S           val;
+    CPU_INT32S           val_old;
+    CPU_INT16U           field_ix;
+    CPU_INT16U           field_ix_end;
+    CPU_INT16U           chng_cnt;
+    CPU_INT16U           chng_tot;
+    CPU_INT08U           report_id_ix;
+
+
+    p_report_id = (USBH_HID_REPORT_ID *)0;
+    for (report_id_ix = 0u; report_id_ix < p_hid_dev->RD_Ptr->NbrReportID; report_id_ix++) {
+        if ((p_hid_dev->RD_Ptr->ReportID[report_id_ix].ReportID == p_rx_cb->ReportID) &&
+            (p_hid_dev->RD_Ptr->ReportID[report_id_ix].Type     == USBH_HID_MAIN_ITEM_TAG_IN)) {
+            p_report_id = &p_hid_dev->RD_Ptr->ReportID[report_id_ix];
+            break;
+        }
+    }
 
-    if ((p_buf   == (void *)0 ) ||
-        (buf_len ==         0u)) {
-        *p_err = USBH_ERR_NULL_PTR;
-         return (0u);
+    if (p_report_id == (USBH_HID_REPORT_ID *)0) {               /* No field known, report cannot be compared.           */
+        if (p_rx_cb->Filter == USBH_HID_RX_FILTER_REPORT) {
+            p_rx_cb->AsyncFnct(p_rx_cb->AsyncArgPtr, (void *)p_buf, buf_len, USBH_ERR_NONE);
+        }
+        return;
     }
-                                                                /* Use optional intr OUT EP if available.               */
-    if (p_hid_dev->IsOutEP_Present == DEF_TRUE) {
 
-        if (report_id != 0u) {                                  /* Copy report id and buf if report is non zero.        */
+    bit_len      = (CPU_INT32U)buf_len * DEF_OCTET_NBR_BITS;
+    field_ix_end =  p_report_id->FieldIx + p_report_id->NbrField;
+    chng_cnt     =  0u;
+    chng_tot     =  0u;
+                                                                /* ------------------ VARIABLE FIELDS ----------------- */
+    for (field_ix = p_report_id->FieldIx; field_ix < field_ix_end; field_ix++) {
+        p_field = &p_hid_dev->RD_Ptr->Field[field_ix];
 
-            if (buf_len > USBH_HID_CFG_MAX_TX_BUF_SIZE) {
-               *p_err = USBH_ERR_INVALID_ARG;
-                return (0u);
+        if ((p_field->IsArray == DEF_TRUE) ||
+           (((CPU_INT32U)p_field->BitOff + p_field->BitSize) > bit_len)) {
+            continue;
+        }
+
+        val = USBH_HID_FieldRd(p_field, p_buf);
+
+        if (DEF_BIT_IS_SET(p_field->ReportFmtPtr->Flag, USBH_HID_MAIN_REL) == DEF_YES) {
+            if (val == 0) {
+                continue;
+            }
+            val_old = 0;
+        } else if (p_rx_cb->LastValid == DEF_FALSE) {
+            val_old = 0;
+        } else {
+            val_old = p_hid_dev->FieldVal[field_ix];
+            diff    = (val > val_old) ? (CPU_INT32U)val - (CPU_INT32U)val_old
+                                      : (CPU_INT32U)val_old - (CPU_INT32U)val;
+            if ((diff == 0u) ||
+               ((p_field->BitSize > 1u) && (diff <= p_rx_cb->DeadBand))) {
+                continue;
+            }
+        }
+
+        p_hid_dev->FieldVal[field_ix] = val;
+        USBH_HID_ChngAdd(p_hid_dev, p_rx_cb, &chng_cnt, p_field->Usage, val_old, val);
+        chng_tot++;
+    }
+                                                                /* ------------------- ARRAY FIELDS ------------------- */
+    if (p_rx_cb->LastValid == DEF_TRUE) {                       /* Usages no longer selected.                           */
+        for (field_ix = p_report_id->FieldIx; field_ix < field_ix_end; field_ix++) {
+            p_field = &p_hid_dev->RD_Ptr->Field[field_ix];
+            if (p_field->IsArray == DEF_FALSE) {
+                continue;
             }
 
-            p_hid_dev->TxBuf[0] = report_id;                    /* First byte should be report id.                      */
-            Mem_Copy((void *)&p_hid_dev->TxBuf[1],
-                              p_buf,
-                              buf_len);
+            usage = USBH_HID_FieldUsageGet(p_field, p_hid_dev->FieldVal[field_ix]);
+            if ((usage != 0u) &&
+                (USBH_HID_ArrUsageIsSel(p_hid_dev, p_report_id, p_buf, bit_len, usage) == DEF_NO)) {
+                USBH_HID_ChngAdd(p_hid_dev, p_rx_cb, &chng_cnt, usage, 1, 0);
+                chng_tot++;
+            }
+        }
+    }
+
+                                                                /* Usages newly selected.                               */
+    for (field_ix = p_report_id->FieldIx; field_ix < field_ix_end; field_ix++) {
+        p_field = &p_hid_dev->RD_Ptr->Field[field_ix];
+        if ((p_field->IsArray == DEF_FALSE) ||
+           (((CPU_INT32U)p_field->BitOff + p_field->BitSize) > bit_len)) {
+            continue;
+        }
+
+        usage = USBH_HID_FieldUsageGet(p_field, USBH_HID_FieldRd(p_field, p_buf));
+        if (usage == 0u) {
+            continue;
+        }
+
+        if ((p_rx_cb->LastValid == DEF_FALSE) ||
+            (USBH_HID_ArrUsageIsSel(p_hid_dev, p_report_id, (CPU_INT08U *)0, 0u, usage) == DEF_NO)) {
+            USBH_HID_ChngAdd(p_hid_dev, p_rx_cb, &chng_cnt, usage, 0, 1);
+            chng_tot++;
+        }
+    }
 
-            xfer_len = USBH_IntrTx(&p_hid_dev->IntrOutEP,
-                                    p_hid_dev->TxBuf,
-                                    buf_len + 1u,
-                                    timeout_ms,
-                                    p_err);
-            if ((*p_err    == USBH_ERR_NONE) &&
-                ( xfer_len != 0u           )) {
-                xfer_len--;
-            }
-        } else {
-            xfer_len = USBH_IntrTx(&p_hid_dev->IntrOutEP,
-                                    p_buf,
-                                    buf_len,
-                                    timeout_ms,
-                                    p_err);
+    for (field_ix = p_report_id->FieldIx; field_ix < field_ix_end; field_ix++) {
+        p_field = &p_hid_dev->RD_Ptr->Field[field_ix];
+
+        if (((CPU_INT32U)p_field->BitOff + p_field->BitSize) > bit_len) {
+            continue;
+        }
+                                                                /* See Note #3.                                         */
+        if ((p_field->IsArray == DEF_TRUE) ||
+           ((p_rx_cb->Filter  == USBH_HID_RX_FILTER_REPORT) && (chng_tot > 0u))) {
+            p_hid_dev->FieldVal[field_ix] = USBH_HID_FieldRd(p_field, p_buf);
         }
-    } else {
-                                                                /* Send report via ctrl EP if intr OUT not available.   */
-        xfer_len = USBH_CtrlTx(p_hid_dev->DevPtr,
-                               USBH_HID_REQ_SET_REPORT,
-                              (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
-                              (((USBH_HID_REPORT_TYPE_OUT << 8u) & 0xFF00u) | report_id),
-                               p_hid_dev->IfNbr,
-                               p_buf,
-                               buf_len,
-                               timeout_ms,
-                               p_err);
     }
 
-    return (xfer_len);
+    if (chng_tot == 0u) {                                       /* Nothing changed, app is not notified.                */
+        return;
+    }
+
+    if (p_rx_cb->Filter == USBH_HID_RX_FILTER_REPORT) {
+        p_rx_cb->AsyncFnct(p_rx_cb->AsyncArgPtr, (void *)p_buf, buf_len, USBH_ERR_NONE);
+    } else if (chng_cnt > 0u) {
+        p_rx_cb->ChngFnct(p_rx_cb->AsyncArgPtr, p_hid_dev->Chng, chng_cnt, USBH_ERR_NONE);
+    } else {
+        ;
+    }
 }
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_HID_RxData()
-*
-* Description : Receive data (report) from device.
-*
-* Argument(s) : p_hid_dev       Pointer to HID device.
-*
-*               report_id       Report id.
-*
-*               p_buf           Pointer to buffer that will receive the report.
-*
-*               buf_len         Buffer length, in octets.
-*
-*               timeout_ms      Timeout, in milliseconds.
-*
-*               p_err       Variable that will receive the return error code from this function.
+*                                         USBH_HID_FieldRd()
 *
-*                           USBH_ERR_NONE                           Report successfully received.
-*                           USBH_ERR_NULL_PTR                       Invalid null pointer passed to 'p_buf'.
+* Description : Read value of report field.
 *
-*                                                                   ----- RETURNED BY USBH_IntrRx() : -----
-*                           USBH_ERR_NONE                           Interrupt transfer successfully received.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not IN.
-*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
-*                           Host controller drivers error code,     Otherwise.
+* Argument(s) : p_field     Pointer to field.
 *
-*                                                                   ----- RETURNED BY USBH_CtrlRx() : -----
-*                           USBH_ERR_UNKNOWN,                       Unknown error occurred.
-*                           USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
-*                           USBH_ERR_HC_IO,                         Root hub input/output error.
-*                           USBH_ERR_EP_STALL,                      Root hub does not support request.
-*                           Host controller drivers error code,     Otherwise.
+*               p_buf       Pointer to report, without report ID prefix.
 *
-* Return(s)   : Number of octets received.
+* Return(s)   : Field value, sign extended if field is signed.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Report fields are little-endian bit strings (see 'Device Class Definition for Human
+*                   Interface Devices (HID), 6/27/01, Version 1.11', section 5.8). A field of up to 32
+*                   bits spans at most 5 octets, which are gathered in a 64-bit value.
 *********************************************************************************************************
 */
 
-static  CPU_INT32U  USBH_HID_RxData (USBH_HID_DEV  *p_hid_dev,
-                                     CPU_INT08U     report_id,
-                                     void          *p_buf,
-                                     CPU_INT32U     buf_len,
-                                     CPU_INT16U     timeout_ms,
-                                     USBH_ERR      *p_err)
+static  CPU_INT32S  USBH_HID_FieldRd (USBH_HID_FIELD  *p_field,
+                                      CPU_INT08U      *p_buf)
 {
-    CPU_INT32U  xfer_len;
+    CPU_INT08U  *p_octet;
+    CPU_INT64U   raw;
+    CPU_INT32U   mask;
+    CPU_INT32U   val;
+    CPU_INT08U   shift;
+    CPU_INT08U   nbr_octet;
+    CPU_INT08U   ix;
 
 
-    if ((p_buf   == (void *)0 ) ||
-        (buf_len ==         0u)) {
-       *p_err = USBH_ERR_NULL_PTR;
-        return (0u);
+    p_octet   = &p_buf[p_field->BitOff / DEF_OCTET_NBR_BITS];
+    shift     = (CPU_INT08U)(p_field->BitOff % DEF_OCTET_NBR_BITS);
+    nbr_octet = (CPU_INT08U)((shift + p_field->BitSize + (DEF_OCTET_NBR_BITS - 1u)) / DEF_OCTET_NBR_BITS);
+
+    raw = 0u;                                                   /* See Note #1.                                         */
+    for (ix = 0u; ix < nbr_octet; ix++) {
+        raw |= (CPU_INT64U)p_octet[ix] << (ix * DEF_OCTET_NBR_BITS);
     }
 
-    if ((report_id           !=       0u) ||                    /* If report ID 0 specified or intr IN EP busy, use ... */
-        (p_hid_dev->RxInProg == DEF_TRUE)) {                    /* ... ctrl EP.                                         */
-        xfer_len = USBH_CtrlRx(p_hid_dev->DevPtr,
-                               USBH_HID_REQ_GET_REPORT,
-                              (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
-                              (((USBH_HID_REPORT_TYPE_IN << 8u) & 0xFF00u) | report_id),
-                               p_hid_dev->IfNbr,
-                               p_buf,
-                               buf_len,
-                               timeout_ms,
-                               p_err);
-    } else {                                                    /* Rcv report on intr IN EP.                            */
-        xfer_len = USBH_IntrRx(&p_hid_dev->IntrInEP,
-                                p_buf,
-                                buf_len,
-                                timeout_ms,
-                                p_err);
+    if (p_field->BitSize < 32u) {
+        mask = DEF_BIT(p_field->BitSize) - 1u;
+    } else {
+        mask = DEF_INT_32U_MAX_VAL;
     }
+    val = (CPU_INT32U)(raw >> shift) & mask;
 
-    return (xfer_len);
+    if ((p_field->IsSigned == DEF_TRUE) &&                      /* Sign extend.                                         */
+        (DEF_BIT_IS_SET(val, DEF_BIT(p_field->BitSize - 1u)) == DEF_YES)) {
+        val |= ~mask;
+    }
+
+    return ((CPU_INT32S)val);
 }
 
 
@@ -1852,7 +2993,14 @@ static  USBH_ERR  USBH_HID_MemReadHIDDesc (USBH_HID_DEV  *p_hid_dev)
 *
 *               (2) If endpoint has no interrupt data to transmit when accessed by the host, it
 *                   responds with NAK. Next polling from the Host will take place at the next period
-*                   (i.e. bInterval of the endpoint).
+*                   (i.e. bInterval of the endpoint, or the interval set by USBH_HID_PollIntervalSet()).
+*
+*               (3) The other receive buffers are still queued on the endpoint while the report is
+*                   dispatched, so that a slow callback does not stop the polling of the device. The
+*                   completed buffer is resubmitted after dispatch, behind them.
+*
+*               (4) Resetting the endpoint aborts the other queued transfers. The first transfer
+*                   completed without error after that resubmits all idle receive buffers.
 *********************************************************************************************************
 */
 
@@ -1868,29 +3016,53 @@ static  void  USBH_HID_IntrRxCB (USBH_EP     *p_ep,
     USBH_ERR       lock_err;
     CPU_INT08U     state;
     CPU_INT08U     ix;
+    CPU_INT08U     buf_ix;
+    CPU_BOOLEAN    rx_idle;
+    CPU_BOOLEAN    rearm_all;
     CPU_SR_ALLOC();
 
 
     (void)p_ep;
 
+    temp_err  =  USBH_ERR_NONE;
+    rearm_all =  DEF_NO;
     p_hid_dev = (USBH_HID_DEV *)p_arg;                          /* Get HID dev.                                         */
 
     if (p_hid_dev == (USBH_HID_DEV *)0) {
         return;
     }
+                                                                /* Find rx buf of completed xfer.                       */
+    buf_ix = (CPU_INT08U)(((CPU_INT08U *)p_buf - &p_hid_dev->RxBuf[0][0]) / sizeof(p_hid_dev->RxBuf[0]));
+    if (buf_ix >= USBH_HID_CFG_RX_BUF_NBR) {
+        return;
+    }
 
     CPU_CRITICAL_ENTER();
     state = p_hid_dev->State;
+    DEF_BIT_CLR(p_hid_dev->RxBufArmed, DEF_BIT(buf_ix));
+    rx_idle             = (p_hid_dev->RxBufArmed == 0u) ? DEF_YES : DEF_NO;
+    p_hid_dev->RxInProg = (rx_idle == DEF_YES) ? DEF_FALSE : DEF_TRUE;
     CPU_CRITICAL_EXIT();
 
     if (state != USBH_CLASS_DEV_STATE_CONN) {
+        if (rx_idle == DEF_NO) {                                /* Notify once, when last rx buf is returned.           */
+            return;
+        }
+
         for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {   /* Notify all callback about state.                     */
 
             if (p_hid_dev->RxCB[ix].InUse == DEF_TRUE) {
-                p_hid_dev->RxCB[ix].AsyncFnct((void *)p_hid_dev->RxCB[ix].AsyncArgPtr,
-                                              (void *)0,
-                                                      0u,
-                                                      USBH_ERR_DEV_NOT_READY);
+                if (p_hid_dev->RxCB[ix].Filter == USBH_HID_RX_FILTER_USAGE) {
+                    p_hid_dev->RxCB[ix].ChngFnct((void                *)p_hid_dev->RxCB[ix].AsyncArgPtr,
+                                                 (USBH_HID_USAGE_CHNG *)0,
+                                                                        0u,
+                                                                        USBH_ERR_DEV_NOT_READY);
+                } else {
+                    p_hid_dev->RxCB[ix].AsyncFnct((void *)p_hid_dev->RxCB[ix].AsyncArgPtr,
+                                                  (void *)0,
+                                                          0u,
+                                                          USBH_ERR_DEV_NOT_READY);
+                }
             }
         }
 
@@ -1902,6 +3074,9 @@ static  void  USBH_HID_IntrRxCB (USBH_EP     *p_ep,
              err      = USBH_ERR_NONE;
              temp_err = USBH_ERR_EP_NACK;
         case USBH_ERR_NONE:
+             if (p_hid_dev->ErrCnt != 0u) {                     /* See Note #4.                                         */
+                 rearm_all = DEF_YES;
+             }
              p_hid_dev->ErrCnt = 0u;
              break;
 
@@ -1935,11 +3110,20 @@ static  void  USBH_HID_IntrRxCB (USBH_EP     *p_ep,
             (p_hid_dev->DevPtr->DevSpd == USBH_DEV_SPD_FULL))
            && (temp_err == USBH_ERR_EP_NACK)) {                 /* See Note #1.                                         */
 
-            USBH_OS_DlyMS(p_hid_dev->IntrInEP.Desc.bInterval);  /* Wait bInterval period associated to IN endpoint      */
-                                                                /* before resubmitting xfer. See Note #2.               */
+                                                                /* Wait polling interval of IN endpoint before ...      */
+                                                                /* ... resubmitting xfer. See Note #2.                  */
+            USBH_OS_DlyMS(USBH_EP_IntervalGet(&p_hid_dev->IntrInEP) / 1000u);
+        }
+                                                                /* Resubmit xfer if dev is in operational state.        */
+        if (rearm_all == DEF_YES) {
+            (void)USBH_HID_RxStart(p_hid_dev);
+        } else {
+            (void)USBH_HID_RxReportAsync(p_hid_dev, buf_ix);    /* See Note #3.                                         */
         }
 
-        USBH_HID_RxReportAsync(p_hid_dev);                      /* Resubmit xfer if dev is in operational state.        */
+        if (DEF_BIT_IS_CLR(p_hid_dev->RxBufArmed, DEF_BIT(buf_ix)) == DEF_YES) {
+            p_hid_dev->RxStat.ArmErrCnt++;
+        }
     }
 
     USBH_HID_DevUnlock(p_hid_dev);
@@ -1952,8 +3136,9 @@ static  void  USBH_HID_IntrRxCB (USBH_EP     *p_ep,
 *
 * Description : Dispatch reports received asynchronously from device:
 *               (1) Identify report ID.
-*               (2) Find callback for report ID.
-*               (3) Invoke callback.
+*               (2) Queue report in rx Q, if enabled.
+*               (3) Find callback for report ID.
+*               (4) Invoke callback.
 *
 * Argument(s) : p_hid_dev      Pointer to HID device.
 *
@@ -1969,7 +3154,10 @@ static  void  USBH_HID_IntrRxCB (USBH_EP     *p_ep,
 *
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) The reports of a callback with a receive filter are compared with the values last
+*                   delivered to it, and only delivered if they changed (see USBH_HID_ChngProcess()).
+*
+*               (2) A report that is neither queued nor passed to a callback is counted as dropped.
 *********************************************************************************************************
 */
 
@@ -1979,11 +3167,13 @@ static  void  USBH_HID_DispatchReport (USBH_HID_DEV  *p_hid_dev,
                                        CPU_INT32U     xfer_len,
                                        USBH_ERR       err)
 {
-    CPU_INT08U           report_id;
-    CPU_INT08U           ix;
-    void                *p_arg;
-    USBH_ERR             lock_err;
-    USBH_HID_RXCB_FNCT   fnct;
+    CPU_INT08U      report_id;
+    CPU_INT08U      ix;
+    CPU_INT08U     *p_report;
+    CPU_INT08U      report_len;
+    CPU_BOOLEAN     queued;
+    USBH_ERR        lock_err;
+    USBH_HID_RXCB   rx_cb;
 
 
     (void)buf_len;
@@ -1997,15 +3187,21 @@ static  void  USBH_HID_DispatchReport (USBH_HID_DEV  *p_hid_dev,
         for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {   /* Notify all reg's callback of err.                    */
 
             if (p_hid_dev->RxCB[ix].InUse == DEF_TRUE) {
-                p_arg = p_hid_dev->RxCB[ix].AsyncArgPtr;
-                fnct  = p_hid_dev->RxCB[ix].AsyncFnct;
+                rx_cb = p_hid_dev->RxCB[ix];
 
                 USBH_HID_DevUnlock(p_hid_dev);                  /* Unlock dev before invoking callback.                 */
 
-                fnct(        p_arg,
-                     (void *)0,
-                             0u,
-                             err);
+                if (rx_cb.Filter == USBH_HID_RX_FILTER_USAGE) {
+                    rx_cb.ChngFnct(                       rx_cb.AsyncArgPtr,
+                                   (USBH_HID_USAGE_CHNG *)0,
+                                                          0u,
+                                                          err);
+                } else {
+                    rx_cb.AsyncFnct(        rx_cb.AsyncArgPtr,
+                                    (void *)0,
+                                            0u,
+                                            err);
+                }
 
                 lock_err = USBH_HID_DevLock(p_hid_dev);
                 if (lock_err != USBH_ERR_NONE) {
@@ -2026,38 +3222,54 @@ static  void  USBH_HID_DispatchReport (USBH_HID_DEV  *p_hid_dev,
     if (p_hid_dev->Boot == DEF_TRUE) {                          /* If boot dev, report ID is 0.                         */
         report_id = 0u;
     } else {
-        if (p_hid_dev->ReportID[0].ReportID == 0u) {            /* If first report ID is 0, there is no report ID.      */
+        if (p_hid_dev->RD_Ptr->ReportID[0].ReportID == 0u) {    /* If first report ID is 0, there is no report ID.      */
             report_id = 0u;
         } else {                                                /* Otherwise, report ID is first byte of buf.           */
             report_id = p_buf[0];
         }
     }
+
+    if (report_id != 0u) {
+        p_report   = &p_buf[1];
+        report_len = (CPU_INT08U)(xfer_len - 1u);
+    } else {
+        p_report   = &p_buf[0];
+        report_len = (CPU_INT08U)xfer_len;
+    }
+
+    p_hid_dev->RxStat.RxCnt++;
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    queued = USBH_HID_RxQ_Put(p_hid_dev, report_id, p_report, report_len);
+#else
+    queued = DEF_NO;
+#endif
                                                                 /* Find callback with same report ID.                   */
     for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RXCB; ix++) {
         if ((p_hid_dev->RxCB[ix].InUse    == DEF_TRUE ) &&
             (p_hid_dev->RxCB[ix].ReportID == report_id)) {
 
-            p_arg = p_hid_dev->RxCB[ix].AsyncArgPtr;
-            fnct  = p_hid_dev->RxCB[ix].AsyncFnct;
+            rx_cb                          = p_hid_dev->RxCB[ix];
+            p_hid_dev->RxCB[ix].LastValid  = DEF_TRUE;          /* Values of this report become the last delivered.     */
 
             USBH_HID_DevUnlock(p_hid_dev);                      /* Unlock dev before invoking callback.                 */
 
-            if (report_id != 0u) {
-                fnct(         p_arg,
-                     (void *)&p_buf[1],
-                              xfer_len - 1u,
-                              err);
-            } else {
-                fnct(         p_arg,
-                     (void *)&p_buf[0],
-                              xfer_len,
-                              err);
+            if (rx_cb.Filter == USBH_HID_RX_FILTER_NONE) {
+                rx_cb.AsyncFnct(        rx_cb.AsyncArgPtr,
+                                (void *)p_report,
+                                        report_len,
+                                        err);
+            } else {                                            /* See Note #1.                                         */
+                USBH_HID_ChngProcess(p_hid_dev, &rx_cb, p_report, report_len);
             }
 
             return;
         }
     }
 
+    if (queued == DEF_NO) {                                     /* See Note #2.                                         */
+        p_hid_dev->RxStat.DropCnt++;
+    }
+
     USBH_HID_DevUnlock(p_hid_dev);
 }
 
@@ -2066,12 +3278,15 @@ static  void  USBH_HID_DispatchReport (USBH_HID_DEV  *p_hid_dev,
 *********************************************************************************************************
 *                                    USBH_HID_ProcessReportDesc()
 *
-* Description : Read and parse report descriptor.
+* Description : Read report descriptor and get its parsed form from the report descriptor cache, parsing it
+*               if not found.
 *
 * Argument(s) : p_hid_dev       Pointer to HID device.
 *
 * Return(s)   : USBH_ERR_NONE,                          Report descriptor successfully processed.
 *               USBH_ERR_DESC_ALLOC,                    Failed to allocate memory for descriptor.
+*               USBH_ERR_DESC_INVALID,                  Report descriptor shorter than given in HID descriptor.
+*               USBH_ERR_ALLOC,                         No report descriptor cache entry is free or unused.
 *               USBH_ERR_HID_RD_PARSER_FAIL,            Cannot parse report descriptor.
 *
 *                                                       ----- RETURNED BY USBH_CtrlRx() : -----
@@ -2086,14 +3301,34 @@ static  void  USBH_HID_DispatchReport (USBH_HID_DEV  *p_hid_dev,
 *               USBH_ERR_DESC_EXTRA_NOT_FOUND,          HID descriptor not found.
 *               USBH_ERR_DESC_INVALID,                  HID descriptor contains invalid value(s).
 *
-* Note(s)     : None.
+*                                                       ----- RETURNED BY USBH_HID_CreateReportID() : -----
+*               USBH_ERR_ALLOC,                         if report ID cannot be allocated.
+*
+*                                                       ----- RETURNED BY USBH_HID_CreateFieldTbl() : -----
+*               USBH_ERR_ALLOC,                         if report field cannot be allocated.
+*
+* Note(s)     : (1) A cache entry matches if its report descriptor has the same hash, length and content. The
+*                   content is compared so that a hash collision cannot give a wrong parsed descriptor.
+*
+*               (2) If the report descriptor is not cached, it is parsed in a free entry or, if none, in the
+*                   least recently used entry that no device uses.
+*
+*               (3) The report descriptor cache mutex also serializes the calls to the parser, whose arena
+*                   is shared by all HID devices (see 'usbh_hidparser.c  USBH_HID_ItemParser() Note #2').
 *********************************************************************************************************
 */
 
 static  USBH_ERR  USBH_HID_ProcessReportDesc (USBH_HID_DEV  *p_hid_dev)
 {
-    CPU_INT32U  len;
-    USBH_ERR    err;
+    USBH_HID_RD  *p_rd;
+    USBH_HID_RD  *p_rd_cur;
+    USBH_HID_RD  *p_rd_free;
+    USBH_HID_RD  *p_rd_lru;
+    CPU_INT32U    len;
+    CPU_INT32U    pos;
+    CPU_INT32U    hash;
+    CPU_INT08U    ix;
+    USBH_ERR      err;
 
 
     err = USBH_HID_MemReadHIDDesc(p_hid_dev);                   /* Read HID desc.                                       */
@@ -2105,28 +3340,193 @@ static  USBH_ERR  USBH_HID_ProcessReportDesc (USBH_HID_DEV  *p_hid_dev)
         return (USBH_ERR_DESC_ALLOC);
     }
 
+    err = USBH_OS_MutexLock(USBH_HID_RD_Mutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
     len = USBH_CtrlRx(         p_hid_dev->DevPtr,               /* Read report desc.                                    */
                                USBH_REQ_GET_DESC,
                               (USBH_REQ_DIR_DEV_TO_HOST | USBH_REQ_TYPE_STD | USBH_REQ_RECIPIENT_IF),
                               ((USBH_HID_DESC_TYPE_REPORT << 8u) & 0xFF00u),
                                p_hid_dev->IfNbr,
-                      (void *)&p_hid_dev->ReportDesc,
+                      (void *)&USBH_HID_RD_Buf[0u],
                                p_hid_dev->Desc.wClassDescriptorLength,
                                USBH_CFG_STD_REQ_TIMEOUT,
                               &err);
+    if (err != USBH_ERR_NONE) {
+        (void)USBH_OS_MutexUnlock(USBH_HID_RD_Mutex);
+        return (err);
+    }
+
+    if ((len == 0u                                    ) ||
+        (len != p_hid_dev->Desc.wClassDescriptorLength)) {
+        (void)USBH_OS_MutexUnlock(USBH_HID_RD_Mutex);
+        return (USBH_ERR_DESC_INVALID);
+    }
 
-    if ((err == USBH_ERR_NONE                         ) &&
-        (len == p_hid_dev->Desc.wClassDescriptorLength)) {
+    hash = USBH_HID_RD_HASH_INIT;
+    for (pos = 0u; pos < len; pos++) {
+        hash ^= USBH_HID_RD_Buf[pos];
+        hash *= USBH_HID_RD_HASH_PRIME;
+    }
+
+                                                                /* --------------- LOOK UP CACHED DESC ---------------- */
+    p_rd      = (USBH_HID_RD *)0;
+    p_rd_free = (USBH_HID_RD *)0;
+    p_rd_lru  = (USBH_HID_RD *)0;
+    for (ix = 0u; ix < USBH_HID_CFG_MAX_NBR_RD; ix++) {
+        p_rd_cur = &USBH_HID_RD_Tbl[ix];
+
+        if (p_rd_cur->DescLen == 0u) {                          /* Free entry.                                          */
+            if (p_rd_free == (USBH_HID_RD *)0) {
+                p_rd_free = p_rd_cur;
+            }
+        } else if ((p_rd_cur->Hash    == hash) &&               /* See Note #1.                                         */
+                   (p_rd_cur->DescLen == len ) &&
+                   (Mem_Cmp((void *)p_rd_cur->Desc, (void *)USBH_HID_RD_Buf, len) == DEF_YES)) {
+            p_rd = p_rd_cur;
+            break;
+        } else if (p_rd_cur->RefCnt == 0u) {                    /* Oldest unused entry.                                 */
+            if ((p_rd_lru == (USBH_HID_RD *)0) ||
+                ((USBH_HID_RD_UseSeq - p_rd_cur->UseSeq) > (USBH_HID_RD_UseSeq - p_rd_lru->UseSeq))) {
+                p_rd_lru = p_rd_cur;
+            }
+        }
+    }
 
-        err = USBH_HID_ItemParser(p_hid_dev,                    /* Parse report desc.                                   */
-                                  p_hid_dev->ReportDesc,
+    if (p_rd != (USBH_HID_RD *)0) {
+        USBH_HID_RD_CacheStat.HitCnt++;
+    } else {                                                    /* ------------- PARSE DESC (see Note #2) ------------- */
+        if (p_rd_free != (USBH_HID_RD *)0) {
+            p_rd = p_rd_free;
+        } else if (p_rd_lru != (USBH_HID_RD *)0) {
+            p_rd = p_rd_lru;
+            USBH_HID_RD_CacheStat.EvictCnt++;
+        } else {
+            (void)USBH_OS_MutexUnlock(USBH_HID_RD_Mutex);
+            return (USBH_ERR_ALLOC);
+        }
+        USBH_HID_RD_CacheStat.MissCnt++;
+
+        Mem_Clr((void *)p_rd, sizeof(USBH_HID_RD));
+        Mem_Copy((void *)p_rd->Desc,
+                 (void *)USBH_HID_RD_Buf,
+                         len);
+
+        err = USBH_HID_ItemParser(p_rd,                         /* Parse report desc (see Note #3).                     */
+                                  p_rd->Desc,
                                   len);
         if (err != USBH_ERR_NONE) {
             err = USBH_ERR_HID_RD_PARSER_FAIL;
         }
+
+        if (err == USBH_ERR_NONE) {
+            err = USBH_HID_CreateReportID(p_rd);                /* Create report ID list.                               */
+        }
+
+        if (err == USBH_ERR_NONE) {
+            err = USBH_HID_CreateFieldTbl(p_rd);                /* Create input report field tbl.                       */
+        }
+
+        if (err != USBH_ERR_NONE) {                             /* Leave entry free.                                    */
+            (void)USBH_OS_MutexUnlock(USBH_HID_RD_Mutex);
+            return (err);
+        }
+
+        p_rd->Hash    = hash;
+        p_rd->DescLen = (CPU_INT16U)len;
     }
 
-    return (err);
+    USBH_HID_RD_UseSeq++;
+    p_rd->UseSeq = USBH_HID_RD_UseSeq;
+    p_rd->RefCnt++;
+    p_hid_dev->RD_Ptr = p_rd;
+
+    (void)USBH_OS_MutexUnlock(USBH_HID_RD_Mutex);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_HID_RD_Release()
+*
+* Description : Release parsed report descriptor of HID device.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The released entry stays in the report descriptor cache, so that a device with the same
+*                   report descriptor can use it without parsing (see USBH_HID_ProcessReportDesc() Note #2).
+*********************************************************************************************************
+*/
+
+static  void  USBH_HID_RD_Release (USBH_HID_DEV  *p_hid_dev)
+{
+    if (p_hid_dev->RD_Ptr == (USBH_HID_RD *)0) {
+        return;
+    }
+
+    (void)USBH_OS_MutexLock(USBH_HID_RD_Mutex);
+
+    if (p_hid_dev->RD_Ptr->RefCnt > 0u) {
+        p_hid_dev->RD_Ptr->RefCnt--;                            /* See Note #1.                                         */
+    }
+    p_hid_dev->RD_Ptr = (USBH_HID_RD *)0;
+
+    (void)USBH_OS_MutexUnlock(USBH_HID_RD_Mutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HID_RxStart()
+*
+* Description : Start reception of reports on interrupt in endpoint, in every idle receive buffer.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+* Return(s)   : USBH_ERR_NONE,                          if at least one receive buffer is submitted.
+*
+*                                                       ----- RETURNED BY USBH_HID_RxReportAsync() : -----
+*               USBH_ERR_EP_INVALID_STATE               If endpoint is not opened.
+*               USBH_ERR_ALLOC                          If URB cannot be allocated.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) A buffer that cannot be submitted (e.g. USBH_ERR_EP_QUEUE_FULL or USBH_ERR_ALLOC) stays
+*                   idle. Reception continues with the buffers that could be submitted.
+*
+*               (2) HID device must be locked by the caller.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_HID_RxStart (USBH_HID_DEV  *p_hid_dev)
+{
+    USBH_ERR    err;
+    USBH_ERR    err_first;
+    CPU_INT08U  buf_ix;
+
+
+    err_first = USBH_ERR_NONE;
+
+    for (buf_ix = 0u; buf_ix < USBH_HID_CFG_RX_BUF_NBR; buf_ix++) {
+        if (DEF_BIT_IS_CLR(p_hid_dev->RxBufArmed, DEF_BIT(buf_ix)) == DEF_YES) {
+            err = USBH_HID_RxReportAsync(p_hid_dev, buf_ix);
+            if ((err       != USBH_ERR_NONE) &&
+                (err_first == USBH_ERR_NONE)) {
+                err_first = err;
+            }
+        }
+    }
+
+    if (p_hid_dev->RxInProg == DEF_TRUE) {                      /* See Note #1.                                         */
+        err_first = USBH_ERR_NONE;
+    }
+
+    return (err_first);
 }
 
 
@@ -2138,6 +3538,8 @@ static  USBH_ERR  USBH_HID_ProcessReportDesc (USBH_HID_DEV  *p_hid_dev)
 *
 * Argument(s) : p_hid_dev       Pointer to HID device.
 *
+*               buf_ix          Index of receive buffer.
+*
 * Return(s)   : USBH_ERR_NONE,                          if read request successfully transmitted.
 *
 *                                                       ----- RETURNED BY USBH_IntrRxAsync() : -----
@@ -2149,37 +3551,113 @@ static  USBH_ERR  USBH_HID_ProcessReportDesc (USBH_HID_DEV  *p_hid_dev)
 *               USBH_ERR_UNKNOWN                        If unknown error occured.
 *               Host controller drivers error code,     Otherwise.
 *
-* Note(s)     : None.
+* Note(s)     : (1) The buffer is marked as submitted before the request, since the request may complete
+*                   before USBH_IntrRxAsync() returns.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_HID_RxReportAsync (USBH_HID_DEV  *p_hid_dev)
+static  USBH_ERR  USBH_HID_RxReportAsync (USBH_HID_DEV  *p_hid_dev,
+                                          CPU_INT08U     buf_ix)
 {
     USBH_ERR    err;
     CPU_INT08U  len;
+    CPU_SR_ALLOC();
 
 
     len = p_hid_dev->MaxReportPtr->Size / 8u;
     if (p_hid_dev->MaxReportPtr->ReportID != 0u) {
         len++;
     }
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    DEF_BIT_SET(p_hid_dev->RxBufArmed, DEF_BIT(buf_ix));
+    p_hid_dev->RxInProg = DEF_TRUE;
+    CPU_CRITICAL_EXIT();
                                                                 /* Start receiving in data.                             */
     err = USBH_IntrRxAsync(       &p_hid_dev->IntrInEP,
-                           (void *)p_hid_dev->RxBuf,
+                           (void *)p_hid_dev->RxBuf[buf_ix],
                                    len,
                                    USBH_HID_IntrRxCB,
                            (void *)p_hid_dev);
     if (err != USBH_ERR_NONE) {
-        p_hid_dev->RxInProg = DEF_FALSE;
+        CPU_CRITICAL_ENTER();
+        DEF_BIT_CLR(p_hid_dev->RxBufArmed, DEF_BIT(buf_ix));
+        p_hid_dev->RxInProg = (p_hid_dev->RxBufArmed == 0u) ? DEF_FALSE : DEF_TRUE;
+        CPU_CRITICAL_EXIT();
         USBH_PRINT_ERR(err);
-    } else {
-        p_hid_dev->RxInProg = DEF_TRUE;
     }
 
     return (err);
 }
 
 
+/*
+*********************************************************************************************************
+*                                         USBH_HID_RxQ_Put()
+*
+* Description : Queue input report in receive queue.
+*
+* Argument(s) : p_hid_dev       Pointer to HID device.
+*
+*               report_id       Report ID.
+*
+*               p_report        Pointer to report, without report ID.
+*
+*               report_len      Report length, in octets.
+*
+* Return(s)   : DEF_YES, if report queued.
+*               DEF_NO,  if queue is full.
+*
+* Note(s)     : (1) When the queue is full, the new report is discarded and counted, so that the queued
+*                   reports keep their order.
+*
+*               (2) HID device must be locked by the caller.
+*********************************************************************************************************
+*/
+
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+static  CPU_BOOLEAN  USBH_HID_RxQ_Put (USBH_HID_DEV  *p_hid_dev,
+                                       CPU_INT08U     report_id,
+                                       CPU_INT08U    *p_report,
+                                       CPU_INT08U     report_len)
+{
+    USBH_HID_RX_REPORT  *p_entry;
+
+
+    if (p_hid_dev->RxQ_Cnt >= USBH_HID_CFG_RX_Q_LEN) {          /* See Note #1.                                         */
+        p_hid_dev->RxStat.Q_OvfCnt++;
+        return (DEF_NO);
+    }
+
+    if (report_len > USBH_HID_CFG_MAX_RX_BUF_SIZE) {
+        report_len = USBH_HID_CFG_MAX_RX_BUF_SIZE;
+    }
+
+    p_entry           = &p_hid_dev->RxQ[p_hid_dev->RxQ_InIx];
+    p_entry->TS       = (CPU_INT32U)CPU_TS_Get32();
+    p_entry->ReportID =  report_id;
+    p_entry->Len      =  report_len;
+    Mem_Copy((void *)p_entry->Buf,
+             (void *)p_report,
+                     report_len);
+
+    p_hid_dev->RxQ_InIx++;
+    if (p_hid_dev->RxQ_InIx >= USBH_HID_CFG_RX_Q_LEN) {
+        p_hid_dev->RxQ_InIx = 0u;
+    }
+
+    p_hid_dev->RxQ_Cnt++;
+    if (p_hid_dev->RxQ_Cnt > p_hid_dev->RxStat.Q_LvlMax) {
+        p_hid_dev->RxStat.Q_LvlMax = p_hid_dev->RxQ_Cnt;
+    }
+
+    (void)USBH_OS_SemPost(p_hid_dev->RxQ_Sem);
+
+    return (DEF_YES);
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                                 END
@@ -62,6 +62,73 @@
 *********************************************************************************************************
 */
 
+/*
+*********************************************************************************************************
+*                                        DEFAULT CONFIGURATION
+*
+* Note(s) : (1) The HID class may be configured from 'usbh_cfg.h':
+*
+*               (a) USBH_HID_CFG_MAX_NBR_FIELD  Nbr of input report fields whose position is precomputed
+*                                               per device (see USBH_HID_ReportDecode()). Each variable
+*                                               item element and each array item element is one field.
+*
+*               (b) USBH_HID_CFG_RX_BUF_NBR     Nbr of receive buffers per device, each with its own
+*                                               interrupt IN transfer (see Note #2). 1 to 8.
+*
+*               (c) USBH_HID_CFG_RX_Q_LEN       Nbr of input reports kept in the receive queue of each
+*                                               device (see USBH_HID_RxQ_Get()). 0 disables the queue.
+*
+*               (d) USBH_HID_CFG_MAX_NBR_RD     Nbr of parsed report descriptors kept in the report
+*                                               descriptor cache (see Note #3).
+*
+*           (2) The interrupt IN transfers of the receive buffers are queued on the endpoint, so that the
+*               endpoint is still polled while a received report is dispatched. This requires
+*               USBH_CFG_MAX_QUEUED_URB_PER_EP >= USBH_HID_CFG_RX_BUF_NBR, and one extra URB per device per
+*               buffer after the first one. With fewer URBs, fewer buffers are used.
+*
+*           (3) HID devices with identical report descriptors share one parsed report descriptor
+*               (USBH_HID_RD). An entry no longer used by any device stays cached until it is needed for
+*               another report descriptor, so that a reconnected device is not parsed again. Devices with
+*               distinct report descriptors connected at the same time need one entry each.
+*
+*               Each entry holds a copy of the report descriptor (USBH_HID_CFG_MAX_REPORT_DESC_LEN octets)
+*               and its parsed content. USBH_HID_CFG_MAX_NBR_RD defaults to USBH_HID_CFG_MAX_DEV, which
+*               takes as much memory as one entry per device: the cache only saves memory when
+*               USBH_HID_CFG_MAX_NBR_RD is lowered to the number of distinct report descriptors expected
+*               to be connected at the same time.
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_HID_CFG_MAX_NBR_FIELD
+#define  USBH_HID_CFG_MAX_NBR_FIELD                       32u
+#endif
+
+#ifndef  USBH_HID_CFG_RX_BUF_NBR
+#define  USBH_HID_CFG_RX_BUF_NBR                           2u
+#endif
+
+#ifndef  USBH_HID_CFG_RX_Q_LEN
+#define  USBH_HID_CFG_RX_Q_LEN                             0u
+#endif
+
+#ifndef  USBH_HID_CFG_MAX_NBR_RD
+#define  USBH_HID_CFG_MAX_NBR_RD                  USBH_HID_CFG_MAX_DEV
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         HID RECEIVE FILTERS
+*
+* Note(s) : (1) See 'usbh_hid.c  USBH_HID_RxFilterSet()' and 'usbh_hid.c  USBH_HID_RegRxChngCB()'.
+*********************************************************************************************************
+*/
+
+#define  USBH_HID_RX_FILTER_NONE                           0u   /* Every report is delivered.                           */
+#define  USBH_HID_RX_FILTER_REPORT                         1u   /* Only changed reports are delivered.                  */
+#define  USBH_HID_RX_FILTER_USAGE                          2u   /* Only changed usages are delivered.                   */
+
+
 /*
 *********************************************************************************************************
 *                                          HID PROTOCOL CODES
@@ -458,9 +525,43 @@ typedef  struct  usbh_hid_report_id {
     CPU_INT32U  Size;                                           /* Report size in bits.                                 */
     CPU_INT08U  ReportID;
     CPU_INT08U  Type;                                           /* Report type (INPUT / OUTPUT / FEATURE).              */
+    CPU_INT16U  FieldIx;                                        /* Ix of first field in dev field tbl (INPUT only).     */
+    CPU_INT16U  NbrField;                                       /* Nbr of fields of report (INPUT only).                */
 } USBH_HID_REPORT_ID;
 
 
+/*
+*********************************************************************************************************
+*                                           HID REPORT FIELD
+*
+* Note(s) : (1) A field is one data element of an input report, with its position precomputed from the
+*               report formats when the device is initialized (see 'usbh_hidparser.c
+*               USBH_HID_CreateFieldTbl()'). Constant (padding) elements have no field.
+*
+*           (2) The value of an array element is an index that selects a usage of 'ReportFmtPtr', either
+*               from its usage list or from its usage range, whose base is then held in 'Usage' (see
+*               USBH_HID_ReportDecode()).
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_hid_field {
+    CPU_INT32U            Usage;                                /* Usage (page << 16 | ID) of element (see Note #2).    */
+    CPU_INT32S            LogMin;                               /* Logical min, base of array element index.            */
+    USBH_HID_REPORT_FMT  *ReportFmtPtr;                         /* Report fmt element belongs to.                       */
+    CPU_INT16U            BitOff;                               /* Bit offset of element in report, after report ID.    */
+    CPU_INT08U            BitSize;                              /* Element size in bits (1..32).                        */
+    CPU_BOOLEAN           IsSigned;                             /* Sign extend value (logical min is negative).         */
+    CPU_BOOLEAN           IsArray;                              /* Element is an array item selector.                   */
+} USBH_HID_FIELD;
+
+
+                                                                /* ----------------- DECODED USAGE VALUE -------------- */
+typedef  struct  usbh_hid_usage_val {
+    CPU_INT32U  Usage;                                          /* Usage (page << 16 | ID).                             */
+    CPU_INT32S  Val;                                            /* Logical value.                                       */
+} USBH_HID_USAGE_VAL;
+
+
 /*
 *********************************************************************************************************
 *                                           HID COLLECTION
@@ -486,6 +587,46 @@ typedef  struct  usbh_hid_app_coll {
 } USBH_HID_APP_COLL;
 
 
+/*
+*********************************************************************************************************
+*                                     PARSED REPORT DESCRIPTOR
+*
+* Note(s) : (1) A parsed report descriptor is shared by all HID devices whose report descriptor has the
+*               same content (see 'usbh_hid.c  USBH_HID_ProcessReportDesc()'). It is read-only once parsed.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_hid_rd {
+    CPU_INT32U           Hash;                                  /* Hash of report desc content.                         */
+    CPU_INT16U           DescLen;                               /* Report desc len, 0 if entry is free.                 */
+    CPU_INT08U           RefCnt;                                /* Nbr of HID devs using this entry.                    */
+    CPU_INT32U           UseSeq;                                /* Seq nbr of last use, to find LRU entry.              */
+                                                                /* Report desc content.                                 */
+    CPU_INT08U           Desc[USBH_HID_CFG_MAX_REPORT_DESC_LEN];
+
+    CPU_INT32U           Usage;                                 /* HID device usage.                                    */
+    CPU_INT08U           NbrAppColl;                            /* Nbr of app coll in main item.                        */
+    USBH_HID_APP_COLL    AppColl[USBH_HID_CFG_MAX_NBR_APP_COLL];/* App coll in main item.                               */
+    CPU_INT08U           NbrReportID;                           /* Tot nbr of report ID.                                */
+    CPU_BOOLEAN          IsReportID_Present;                    /* Indicate if report ID tag is present.                */
+
+                                                                /* Report ID of all colls.                              */
+    USBH_HID_REPORT_ID   ReportID[USBH_HID_CFG_MAX_NBR_REPORT_ID];
+
+                                                                /* Input report fields of all report IDs.               */
+    USBH_HID_FIELD       Field[USBH_HID_CFG_MAX_NBR_FIELD];
+    CPU_INT16U           NbrField;                              /* Tot nbr of input report fields.                      */
+} USBH_HID_RD;
+
+
+                                                                /* ----------- REPORT DESCRIPTOR CACHE STATS ---------- */
+typedef  struct  usbh_hid_rd_cache_stat {
+    CPU_INT32U  HitCnt;                                         /* Nbr of report desc found parsed in cache.            */
+    CPU_INT32U  MissCnt;                                        /* Nbr of report desc parsed.                           */
+    CPU_INT32U  EvictCnt;                                       /* Nbr of unused entries reused for another desc.       */
+} USBH_HID_RD_CACHE_STAT;
+
+
                                                                 /* --- APPLICATION REPORT RECEIVE CALLBACK FUNCTION --- */
 typedef  void  (*USBH_HID_RXCB_FNCT)(void        *p_arg,
                                      void        *p_buf,
@@ -493,15 +634,54 @@ typedef  void  (*USBH_HID_RXCB_FNCT)(void        *p_arg,
                                      USBH_ERR     err);
 
 
+                                                                /* ----------------- HID USAGE CHANGE ----------------- */
+typedef  struct  usbh_hid_usage_chng {
+    CPU_INT32U  Usage;                                          /* Usage (page << 16 | ID).                             */
+    CPU_INT32S  ValOld;                                         /* Last delivered value.                                */
+    CPU_INT32S  ValNew;                                         /* New value.                                           */
+} USBH_HID_USAGE_CHNG;
+
+
+                                                                /* ---- APPLICATION USAGE CHANGE CALLBACK FUNCTION ---- */
+typedef  void  (*USBH_HID_CHNG_FNCT)(void                 *p_arg,
+                                     USBH_HID_USAGE_CHNG  *p_chng,
+                                     CPU_INT16U            nbr_chng,
+                                     USBH_ERR              err);
+
+
                                                                 /* ----------- HID REPORT RECEIVE CALLBACK ------------ */
 typedef  struct  usbh_hid_rxcb {
     CPU_BOOLEAN          InUse;
     CPU_INT08U           ReportID;
     void                *AsyncArgPtr;
     USBH_HID_RXCB_FNCT   AsyncFnct;
+    USBH_HID_CHNG_FNCT   ChngFnct;                              /* Usage chng callback, if USBH_HID_RX_FILTER_USAGE.    */
+    CPU_INT08U           Filter;                                /* Rx filter (USBH_HID_RX_FILTER_xxx).                  */
+    CPU_INT32U           DeadBand;                              /* Dead band of absolute axes.                          */
+    CPU_BOOLEAN          LastValid;                             /* Indicate if last delivered values are valid.         */
 } USBH_HID_RXCB;
 
 
+                                                                /* ---------------- QUEUED INPUT REPORT --------------- */
+typedef  struct  usbh_hid_rx_report {
+    CPU_INT32U  TS;                                             /* Reception timestamp, from CPU_TS_Get32().            */
+    CPU_INT08U  ReportID;
+    CPU_INT08U  Len;                                            /* Report len, without report ID prefix.                */
+    CPU_INT08U  Buf[USBH_HID_CFG_MAX_RX_BUF_SIZE];
+} USBH_HID_RX_REPORT;
+
+
+                                                                /* ------------- INPUT REPORT STATISTICS -------------- */
+typedef  struct  usbh_hid_rx_stat {
+    CPU_INT32U  RxCnt;                                          /* Nbr of input reports received.                       */
+    CPU_INT32U  DropCnt;                                        /* Nbr of reports neither dispatched nor queued.        */
+    CPU_INT32U  Q_OvfCnt;                                       /* Nbr of reports not queued, rx Q being full.          */
+    CPU_INT32U  ArmErrCnt;                                      /* Nbr of times a rx buf could not be resubmitted.      */
+    CPU_INT16U  Q_LvlMax;                                       /* Highest nbr of reports in rx Q.                      */
+    CPU_INT08U  BufArmedNbr;                                    /* Nbr of rx buf with an IN xfer in progress.           */
+} USBH_HID_RX_STAT;
+
+
                                                                 /* -------------------- HID DEVICE -------------------- */
 typedef  struct  usbh_hid_dev {
     USBH_DEV            *DevPtr;                                /* Ptr to dev struct.                                   */
@@ -519,26 +699,31 @@ typedef  struct  usbh_hid_dev {
     CPU_INT08U           Protocol;                              /* HID dev IF protocol code.                            */
     USBH_HID_DESC        Desc;                                  /* HID desc content.                                    */
 
-    CPU_INT08U           NbrAppColl;                            /* Nbr of app coll in main item.                        */
-    USBH_HID_APP_COLL    AppColl[USBH_HID_CFG_MAX_NBR_APP_COLL];/* App coll in main item.                               */
-    CPU_INT08U           NbrReportID;                           /* Tot nbr of report ID.                                */
-    CPU_BOOLEAN          IsReportID_Present;                    /* Indicate if report ID tag is present.                */
+    USBH_HID_RD         *RD_Ptr;                                /* Ptr to parsed report desc.                           */
 
-                                                                /* Report ID of all colls.                              */
-    USBH_HID_REPORT_ID   ReportID[USBH_HID_CFG_MAX_NBR_REPORT_ID];
+                                                                /* Last delivered value of each field.                  */
+    CPU_INT32S           FieldVal[USBH_HID_CFG_MAX_NBR_FIELD];
+                                                                /* Usage chngs dispatched to app.                       */
+    USBH_HID_USAGE_CHNG  Chng[USBH_HID_CFG_MAX_NBR_FIELD];
 
     USBH_HID_RXCB        RxCB[USBH_HID_CFG_MAX_NBR_RXCB];
 
                                                                 /* Rx/Tx buf, +1 for report id.                            */
-    CPU_INT08U           RxBuf[USBH_HID_CFG_MAX_RX_BUF_SIZE + 1u];
+    CPU_INT08U           RxBuf[USBH_HID_CFG_RX_BUF_NBR][USBH_HID_CFG_MAX_RX_BUF_SIZE + 1u];
     CPU_INT08U           TxBuf[USBH_HID_CFG_MAX_TX_BUF_SIZE + 1u];
+    CPU_INT08U           RxBufArmed;                            /* Bitmap of rx buf with an IN xfer in progress.        */
+    USBH_HID_RX_STAT     RxStat;                                /* Input report stats.                                  */
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+    USBH_HID_RX_REPORT   RxQ[USBH_HID_CFG_RX_Q_LEN];            /* Rx Q of input reports.                               */
+    CPU_INT16U           RxQ_InIx;
+    CPU_INT16U           RxQ_OutIx;
+    CPU_INT16U           RxQ_Cnt;
+    USBH_HSEM            RxQ_Sem;                               /* Sem posted for each queued report.                   */
+#endif
     CPU_INT08U           ErrCnt;                                /* Rx error cnt.                                        */
     CPU_INT08U           Boot;                                  /* Is it a boot HID dev?                                */
     CPU_BOOLEAN          IsInit;                                /* Indicate if HID class instance is correctly init.    */
     CPU_BOOLEAN          RxInProg;                              /* Async rx is in progress.                             */
-
-                                                                /* HID report desc content.                             */
-    CPU_INT08U           ReportDesc[USBH_HID_CFG_MAX_REPORT_DESC_LEN];
     USBH_HID_REPORT_ID  *MaxReportPtr;                          /* Ptr to largest report.                               */
 
     CPU_INT32U           Usage;                                 /* HID device usage.                                    */
@@ -608,6 +793,17 @@ USBH_ERR     USBH_HID_RegRxCB         (USBH_HID_DEV         *p_hid_dev,
 USBH_ERR     USBH_HID_UnregRxCB       (USBH_HID_DEV         *p_hid_dev,
                                        CPU_INT08U            report_id);
 
+USBH_ERR     USBH_HID_RegRxChngCB     (USBH_HID_DEV         *p_hid_dev,
+                                       CPU_INT08U            report_id,
+                                       USBH_HID_CHNG_FNCT    chng_fnct,
+                                       void                 *p_arg,
+                                       CPU_INT32U            dead_band);
+
+USBH_ERR     USBH_HID_RxFilterSet     (USBH_HID_DEV         *p_hid_dev,
+                                       CPU_INT08U            report_id,
+                                       CPU_BOOLEAN           en,
+                                       CPU_INT32U            dead_band);
+
 USBH_ERR     USBH_HID_ProtocolSet     (USBH_HID_DEV         *p_hid_dev,
                                        CPU_INT16U            protocol);
 
@@ -622,6 +818,33 @@ CPU_INT32U   USBH_HID_IdleGet         (USBH_HID_DEV         *p_hid_dev,
                                        CPU_INT08U            report_id,
                                        USBH_ERR             *p_err);
 
+USBH_ERR     USBH_HID_PollIntervalSet (USBH_HID_DEV         *p_hid_dev,
+                                       CPU_INT32U            interval_us,
+                                       CPU_INT32U           *p_interval_us);
+
+USBH_ERR     USBH_HID_RxStatGet       (USBH_HID_DEV         *p_hid_dev,
+                                       USBH_HID_RX_STAT     *p_stat);
+
+#if (USBH_HID_CFG_RX_Q_LEN > 0u)
+CPU_INT08U   USBH_HID_RxQ_Get         (USBH_HID_DEV         *p_hid_dev,
+                                       CPU_INT08U           *p_report_id,
+                                       void                 *p_buf,
+                                       CPU_INT08U            buf_len,
+                                       CPU_INT32U           *p_ts,
+                                       CPU_INT16U            timeout_ms,
+                                       USBH_ERR             *p_err);
+#endif
+
+void         USBH_HID_RD_CacheStatGet (USBH_HID_RD_CACHE_STAT  *p_stat);
+
+CPU_INT16U   USBH_HID_ReportDecode    (USBH_HID_DEV         *p_hid_dev,
+                                       CPU_INT08U            report_id,
+                                       void                 *p_buf,
+                                       CPU_INT08U            buf_len,
+                                       USBH_HID_USAGE_VAL   *p_usage_val,
+                                       CPU_INT16U            nbr_usage_val,
+                                       USBH_ERR             *p_err);
+
 
 /*
 *********************************************************************************************************
@@ -629,6 +852,18 @@ CPU_INT32U   USBH_HID_IdleGet         (USBH_HID_DEV         *p_hid_dev,
 *********************************************************************************************************
 */
 
+#if    ((USBH_HID_CFG_RX_BUF_NBR < 1u) || \
+        (USBH_HID_CFG_RX_BUF_NBR > 8u))
+#error  "USBH_HID_CFG_RX_BUF_NBR               illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1 && <= 8]             "
+#endif
+
+#if    ((USBH_HID_CFG_MAX_NBR_RD < 1u) || \
+        (USBH_HID_CFG_MAX_NBR_RD > 255u))
+#error  "USBH_HID_CFG_MAX_NBR_RD               illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1 && <= 255]           "
+#endif
+
 
 /*
 *********************************************************************************************************
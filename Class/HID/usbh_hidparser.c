@@ -71,6 +71,22 @@
 #define  USBH_HID_REPORT_SIZE_UNDEFINED                    0u
 #define  USBH_HID_REPORT_CNT_UNDEFINED                     0u
 
+                                                                /* ------------------- PARSER ARENA ------------------- */
+                                                                /* Nbr of arena units taken by a global item.           */
+#define  USBH_HID_ARENA_GLOBAL_UNITS       ((sizeof(USBH_HID_GLOBAL) + sizeof(USBH_HID_COLL) - 1u) / \
+                                            sizeof(USBH_HID_COLL))
+
+                                                                /* Nbr of arena units for cfg'd nbr of items.           */
+#define  USBH_HID_ARENA_CFG_UNITS          (USBH_HID_CFG_MAX_COLL + \
+                                          (USBH_HID_CFG_MAX_GLOBAL * USBH_HID_ARENA_GLOBAL_UNITS))
+
+                                                                /* Nbr of arena units for max report desc len.          */
+#define  USBH_HID_ARENA_DESC_UNITS         (USBH_HID_CFG_MAX_REPORT_DESC_LEN * USBH_HID_ARENA_GLOBAL_UNITS)
+
+                                                                /* Nbr of arena units (see USBH_HID_ItemParser() ...    */
+                                                                /* ... Note #3).                                        */
+#define  USBH_HID_ARENA_UNITS               DEF_MIN(USBH_HID_ARENA_CFG_UNITS, USBH_HID_ARENA_DESC_UNITS)
+
 
 /*
 *********************************************************************************************************
@@ -116,6 +132,8 @@ typedef  struct  usbh_hid_parser {
     USBH_HID_GLOBAL   Global;                                   /* Global items.                                        */
     USBH_HID_GLOBAL  *GlobalStkPtr;                             /* Global items stack for push and pop.                 */
     USBH_HID_COLL    *CollStkPtr;                               /* Collection stack.                                    */
+    CPU_INT16U        ArenaLo;                                  /* Arena units used by global stack, from bottom.       */
+    CPU_INT16U        ArenaHi;                                  /* First arena unit used by collection stack.           */
     CPU_INT08U        AppCollNbr;                               /* Present Apllication Collection number.               */
     CPU_INT08U        Type;                                     /* Item Type.                                           */
     CPU_INT08U        Tag;                                      /* Item Tag.                                            */
@@ -144,11 +162,8 @@ typedef  struct  usbh_hid_parser {
 *********************************************************************************************************
 */
 
-static  MEM_POOL         USBH_HID_CollPool;
-static  USBH_HID_COLL    USBH_HID_CollList[USBH_HID_CFG_MAX_COLL];
-
-static  MEM_POOL         USBH_HID_GlobalItemPool;
-static  USBH_HID_GLOBAL  USBH_HID_GlobalItemList[USBH_HID_CFG_MAX_GLOBAL];
+                                                                /* Parser arena (see USBH_HID_ItemParser() Note #1).    */
+static  USBH_HID_COLL    USBH_HID_ParserArena[USBH_HID_ARENA_UNITS];
 
 
 /*
@@ -165,19 +180,22 @@ static  void      USBH_HID_InitItemParser(USBH_HID_PARSER      *p_parser);
 
 static  void      USBH_HID_FreeItemParser(USBH_HID_PARSER      *p_parser);
 
-static  USBH_ERR  USBH_HID_ParseMain     (USBH_HID_DEV         *p_hid_dev,
+static  CPU_INT32U  USBH_HID_ArenaReqGet (CPU_INT08U           *p_report_desc,
+                                          CPU_INT32U            desc_len);
+
+static  USBH_ERR  USBH_HID_ParseMain     (USBH_HID_RD          *p_rd,
                                           USBH_HID_PARSER      *p_parser);
 
 static  USBH_ERR  USBH_HID_ParseGlobal   (USBH_HID_PARSER      *p_parser);
 
 static  USBH_ERR  USBH_HID_ParseLocal    (USBH_HID_PARSER      *p_parser);
 
-static  USBH_ERR  USBH_HID_OpenColl      (USBH_HID_DEV         *p_hid_dev,
+static  USBH_ERR  USBH_HID_OpenColl      (USBH_HID_RD          *p_rd,
                                           USBH_HID_PARSER      *p_parser);
 
 static  USBH_ERR  USBH_HID_CloseColl     (USBH_HID_PARSER      *p_parser);
 
-static  USBH_ERR  USBH_HID_AddReport     (USBH_HID_DEV         *p_hid_dev,
+static  USBH_ERR  USBH_HID_AddReport     (USBH_HID_RD          *p_rd,
                                           USBH_HID_PARSER      *p_parser);
 
 static  USBH_ERR  USBH_HID_ValidateReport(USBH_HID_REPORT_FMT  *p_report_fmt);
@@ -211,10 +229,9 @@ static  void      USBH_HID_SetData       (USBH_HID_PARSER      *p_parser,
 *
 * Description : Initialize global data.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : None.
 *
-* Return(s)   : USBH_ERR_NONE,      if initialization is succesful.
-*               USBH_ERR_ALLOC,     if global item or collection list allocation failed.
+* Return(s)   : USBH_ERR_NONE.
 *
 * Note(s)     : None.
 *********************************************************************************************************
@@ -222,39 +239,8 @@ static  void      USBH_HID_SetData       (USBH_HID_PARSER      *p_parser,
 
 USBH_ERR  USBH_HID_ParserGlobalInit (void)
 {
-    LIB_ERR     err_lib;
-    CPU_SIZE_T  octets_reqd;
-
-
-    Mem_PoolCreate (       &USBH_HID_CollPool,                  /* POOL for managing collection structures.             */
-                    (void *)USBH_HID_CollList,
-                           (sizeof(USBH_HID_COLL) * USBH_HID_CFG_MAX_COLL),
-                            USBH_HID_CFG_MAX_COLL,
-                            sizeof(USBH_HID_COLL),
-                            sizeof(CPU_ALIGN),
-                           &octets_reqd,
-                           &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
-#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
-        USBH_PRINT_LOG("%d octets required\r\n", octets_reqd);
-#endif
-        return (USBH_ERR_ALLOC);
-    }
-
-    Mem_PoolCreate (       &USBH_HID_GlobalItemPool,            /* POOL for managing global item structures.            */
-                    (void *)USBH_HID_GlobalItemList,
-                           (sizeof(USBH_HID_GLOBAL) * USBH_HID_CFG_MAX_GLOBAL),
-                            USBH_HID_CFG_MAX_GLOBAL,
-                            sizeof(USBH_HID_GLOBAL),
-                            sizeof(CPU_ALIGN),
-                           &octets_reqd,
-                           &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
-#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
-        USBH_PRINT_LOG("%d octets required\r\n", octets_reqd);
-#endif
-        return (USBH_ERR_ALLOC);
-    }
+    Mem_Clr((void *)USBH_HID_ParserArena,
+                    sizeof(USBH_HID_ParserArena));
 
     return (USBH_ERR_NONE);
 }
@@ -266,7 +252,7 @@ USBH_ERR  USBH_HID_ParserGlobalInit (void)
 *
 * Description : Parse report descriptor.
 *
-* Argument(s) : p_hid_dev           Pointer to HID device.
+* Argument(s) : p_rd                Pointer to parsed report descriptor.
 *
 *               p_report_desc       Pointer to report descriptor buffer.
 *
@@ -278,21 +264,42 @@ USBH_ERR  USBH_HID_ParserGlobalInit (void)
 *               USBH_ERR_HID_ITEM_UNKNOWN,          if unknown item present.
 *               USBH_ERR_HID_MISMATCH_COLL,         if there is a collection mismatch.
 *               USBH_ERR_HID_MISMATCH_PUSH_POP,     if global stack error occured.
+*               USBH_ERR_ALLOC,                     if parser arena is too small for report descriptor.
 *
-* Note(s)     : None.
+* Note(s)     : (1) The global item stack (push/pop) and the collection stack are allocated from a single
+*                   arena: global items from its bottom, collections from its top. The arena is sized for
+*                   USBH_HID_CFG_MAX_GLOBAL global items and USBH_HID_CFG_MAX_COLL collections, but either
+*                   stack may use the space left by the other. The nesting depths of the report descriptor
+*                   are checked against the arena before parsing.
+*
+*               (2) The arena is shared by all HID devices. Calls to this function must be serialized.
+*
+*               (3) The report descriptor is at most USBH_HID_CFG_MAX_REPORT_DESC_LEN octets long. Each
+*                   nesting level takes at least one Collection item (2 octets) or one Push item (1 octet),
+*                   so the arena never needs more than USBH_HID_CFG_MAX_REPORT_DESC_LEN global items. The
+*                   arena is not sized beyond this bound, whatever USBH_HID_CFG_MAX_COLL and
+*                   USBH_HID_CFG_MAX_GLOBAL are.
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_HID_ItemParser (USBH_HID_DEV  *p_hid_dev,
+USBH_ERR  USBH_HID_ItemParser (USBH_HID_RD   *p_rd,
                                CPU_INT08U    *p_report_desc,
                                CPU_INT32U     desc_len)
 {
     USBH_HID_PARSER  parser;
     CPU_INT32U       pos;
+    CPU_INT32U       arena_req;
     CPU_INT08U       item;
     USBH_ERR         err;
 
 
+    arena_req = USBH_HID_ArenaReqGet(p_report_desc, desc_len);  /* See Note #1.                                         */
+    if (arena_req > USBH_HID_ARENA_UNITS) {
+#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
+        USBH_PRINT_LOG("%d octets required\r\n", arena_req * sizeof(USBH_HID_COLL));
+#endif
+        return (USBH_ERR_ALLOC);
+    }
                                                                 /* ----------------- INITIALIZE DATA ------------------ */
     USBH_HID_InitItemParser(&parser);
     pos = 0u;
@@ -317,7 +324,7 @@ USBH_ERR  USBH_HID_ItemParser (USBH_HID_DEV  *p_hid_dev,
 
         switch (parser.Type) {
             case USBH_HID_ITEM_TYPE_MAIN:                       /* Parse main item.                                     */
-                 err = USBH_HID_ParseMain(p_hid_dev, &parser);
+                 err = USBH_HID_ParseMain(p_rd, &parser);
                  break;
 
             case USBH_HID_ITEM_TYPE_GLOBAL:                     /* Parse global item.                                   */
@@ -328,7 +335,7 @@ USBH_ERR  USBH_HID_ItemParser (USBH_HID_DEV  *p_hid_dev,
                  err = USBH_HID_ParseLocal(&parser);
 
                  if (pos <= 6u) {                               /* Store device usage.                                  */
-                     p_hid_dev->Usage = parser.Local.Usage[0u];
+                     p_rd->Usage = parser.Local.Usage[0u];
                  }
                  break;
 
@@ -375,7 +382,7 @@ USBH_ERR  USBH_HID_ItemParser (USBH_HID_DEV  *p_hid_dev,
 *
 * Description : Creates report id list from pre-parsed data.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : p_rd            Pointer to parsed report descriptor.
 *
 * Return(s)   : USBH_ERR_NONE,      if report ID list successfully created.
 *               USBH_ERR_ALLOC,     if report ID cannot be allocated.
@@ -384,7 +391,7 @@ USBH_ERR  USBH_HID_ItemParser (USBH_HID_DEV  *p_hid_dev,
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_HID_CreateReportID (USBH_HID_DEV  *p_hid_dev)
+USBH_ERR  USBH_HID_CreateReportID (USBH_HID_RD   *p_rd)
 {
     CPU_BOOLEAN           found;
     CPU_INT08U            coll_ix;
@@ -394,17 +401,17 @@ USBH_ERR  USBH_HID_CreateReportID (USBH_HID_DEV  *p_hid_dev)
     USBH_HID_REPORT_ID   *p_report_id;
 
 
-    p_hid_dev->NbrReportID = 0u;
+    p_rd->NbrReportID = 0u;
                                                                 /* For each app collection.                     */
-    for (coll_ix = 0u; coll_ix < p_hid_dev->NbrAppColl; coll_ix++) {
+    for (coll_ix = 0u; coll_ix < p_rd->NbrAppColl; coll_ix++) {
 
-        for (report_fmt_ix = 0u; report_fmt_ix < p_hid_dev->AppColl[coll_ix].NbrReportFmt; report_fmt_ix++) {
+        for (report_fmt_ix = 0u; report_fmt_ix < p_rd->AppColl[coll_ix].NbrReportFmt; report_fmt_ix++) {
 
-            p_report_fmt = &p_hid_dev->AppColl[coll_ix].ReportFmt[report_fmt_ix];
+            p_report_fmt = &p_rd->AppColl[coll_ix].ReportFmt[report_fmt_ix];
             found        =  DEF_FALSE;
 
-            for (report_id_ix = 0u; report_id_ix < p_hid_dev->NbrReportID; report_id_ix++) {
-                p_report_id = &p_hid_dev->ReportID[report_id_ix];
+            for (report_id_ix = 0u; report_id_ix < p_rd->NbrReportID; report_id_ix++) {
+                p_report_id = &p_rd->ReportID[report_id_ix];
                                                                 /* If report ID/type match, increment size.      */
                 if ((p_report_id->ReportID == p_report_fmt->ReportID  ) &&
                     (p_report_id->Type     == p_report_fmt->ReportType)) {
@@ -417,15 +424,125 @@ USBH_ERR  USBH_HID_CreateReportID (USBH_HID_DEV  *p_hid_dev)
 
             if (found == DEF_FALSE) {                           /* No match found, create new report ID.             */
 
-                if (p_hid_dev->NbrReportID >= USBH_HID_CFG_MAX_NBR_REPORT_ID) {
+                if (p_rd->NbrReportID >= USBH_HID_CFG_MAX_NBR_REPORT_ID) {
                     return (USBH_ERR_ALLOC);
                 }
 
-                p_report_id            = &p_hid_dev->ReportID[p_hid_dev->NbrReportID];
+                p_report_id            = &p_rd->ReportID[p_rd->NbrReportID];
                 p_report_id->ReportID  =  p_report_fmt->ReportID;
                 p_report_id->Type      =  p_report_fmt->ReportType;
                 p_report_id->Size      = (p_report_fmt->ReportCnt * p_report_fmt->ReportSize);
-                p_hid_dev->NbrReportID++;
+                p_rd->NbrReportID++;
+            }
+        }
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_HID_CreateFieldTbl()
+*
+* Description : Creates input report field table from pre-parsed data.
+*
+* Argument(s) : p_rd            Pointer to parsed report descriptor.
+*
+* Return(s)   : USBH_ERR_NONE,      if field table successfully created.
+*               USBH_ERR_ALLOC,     if field cannot be allocated.
+*
+* Note(s)     : (1) Report formats are stored in descriptor order, so the bit offset of an element is the
+*                   sum of the sizes of the preceding elements with the same report ID. The fields of a
+*                   report ID are contiguous in the table.
+*
+*               (2) Constant elements are padding and get no field. Elements of more than 32 bits cannot
+*                   be returned as a value and get no field either. Both still advance the bit offset.
+*
+*               (3) The usage of a variable element is the usage at the same position in the usage list;
+*                   the last usage applies to the remaining elements. Without usage list, usages are
+*                   assigned in sequence from the usage minimum. The usage of an array element is the base
+*                   of its usage range, or 0 if it only has a usage list.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_HID_CreateFieldTbl (USBH_HID_RD   *p_rd)
+{
+    CPU_INT08U            coll_ix;
+    CPU_INT08U            report_fmt_ix;
+    CPU_INT08U            report_id_ix;
+    CPU_INT32U            elem_ix;
+    CPU_INT32U            bit_off;
+    USBH_HID_REPORT_FMT  *p_report_fmt;
+    USBH_HID_REPORT_ID   *p_report_id;
+    USBH_HID_FIELD       *p_field;
+
+
+    p_rd->NbrField = 0u;
+
+    for (report_id_ix = 0u; report_id_ix < p_rd->NbrReportID; report_id_ix++) {
+        p_report_id           = &p_rd->ReportID[report_id_ix];
+        p_report_id->FieldIx  =  p_rd->NbrField;
+        p_report_id->NbrField =  0u;
+
+        if (p_report_id->Type != USBH_HID_MAIN_ITEM_TAG_IN) {
+            continue;
+        }
+
+        bit_off = 0u;                                           /* See Note #1.                                         */
+        for (coll_ix = 0u; coll_ix < p_rd->NbrAppColl; coll_ix++) {
+
+            for (report_fmt_ix = 0u; report_fmt_ix < p_rd->AppColl[coll_ix].NbrReportFmt; report_fmt_ix++) {
+
+                p_report_fmt = &p_rd->AppColl[coll_ix].ReportFmt[report_fmt_ix];
+                if ((p_report_fmt->ReportID   != p_report_id->ReportID) ||
+                    (p_report_fmt->ReportType != p_report_id->Type    )) {
+                    continue;
+                }
+                                                                /* See Note #2.                                         */
+                if (((p_report_fmt->Flag & USBH_HID_MAIN_CONST) == USBH_HID_MAIN_CONST) ||
+                     (p_report_fmt->ReportSize == 0u) ||
+                     (p_report_fmt->ReportSize >  32u)) {
+                    bit_off += p_report_fmt->ReportCnt * p_report_fmt->ReportSize;
+                    continue;
+                }
+
+                for (elem_ix = 0u; elem_ix < p_report_fmt->ReportCnt; elem_ix++) {
+
+                    if (p_rd->NbrField >= USBH_HID_CFG_MAX_NBR_FIELD) {
+                        return (USBH_ERR_ALLOC);
+                    }
+
+                    p_field               = &p_rd->Field[p_rd->NbrField];
+                    p_field->ReportFmtPtr =  p_report_fmt;
+                    p_field->BitOff       = (CPU_INT16U)bit_off;
+                    p_field->BitSize      = (CPU_INT08U)p_report_fmt->ReportSize;
+                    p_field->LogMin       =  p_report_fmt->LogMin;
+                    p_field->IsSigned     = (p_report_fmt->LogMin < 0) ? DEF_TRUE : DEF_FALSE;
+                    p_field->IsArray      = DEF_BIT_IS_CLR(p_report_fmt->Flag, USBH_HID_MAIN_VAR);
+                                                                /* See Note #3.                                         */
+                    if (p_field->IsArray == DEF_TRUE) {
+                        if (p_report_fmt->UsageMin != USBH_HID_USAGE_MIN_UNDEFINED) {
+                            p_field->Usage = ((CPU_INT32U)p_report_fmt->UsagePage << 16u) |
+                                              p_report_fmt->UsageMin;
+                        } else {
+                            p_field->Usage = 0u;                /* No usage range, index selects from usage list.       */
+                        }
+                    } else if (elem_ix < p_report_fmt->NbrUsage) {
+                        p_field->Usage = p_report_fmt->Usage[elem_ix];
+                    } else if (p_report_fmt->NbrUsage > 0u) {
+                        p_field->Usage = p_report_fmt->Usage[p_report_fmt->NbrUsage - 1u];
+                    } else if (p_report_fmt->UsageMin != USBH_HID_USAGE_MIN_UNDEFINED) {
+                        p_field->Usage = ((CPU_INT32U)p_report_fmt->UsagePage << 16u) |
+                                          (p_report_fmt->UsageMin + elem_ix);
+                    } else {
+                        p_field->Usage = (CPU_INT32U)p_report_fmt->UsagePage << 16u;
+                    }
+
+                    bit_off += p_report_fmt->ReportSize;
+                    p_rd->NbrField++;
+                    p_report_id->NbrField++;
+                }
             }
         }
     }
@@ -440,7 +557,7 @@ USBH_ERR  USBH_HID_CreateReportID (USBH_HID_DEV  *p_hid_dev)
 *
 * Description : Find report of given type that has the greater size.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : p_rd            Pointer to parsed report descriptor.
 *
 *               type            Report Type.
 *
@@ -450,7 +567,7 @@ USBH_ERR  USBH_HID_CreateReportID (USBH_HID_DEV  *p_hid_dev)
 *********************************************************************************************************
 */
 
-USBH_HID_REPORT_ID  *USBH_HID_MaxReport (USBH_HID_DEV  *p_hid_dev,
+USBH_HID_REPORT_ID  *USBH_HID_MaxReport (USBH_HID_RD   *p_rd,
                                          CPU_INT08U     type)
 {
     USBH_HID_REPORT_ID  *p_report_id;
@@ -461,13 +578,13 @@ USBH_HID_REPORT_ID  *USBH_HID_MaxReport (USBH_HID_DEV  *p_hid_dev,
     size        = 0u;
     p_report_id = (USBH_HID_REPORT_ID *)0;
 
-    for (report_id_ix = 0u; report_id_ix < p_hid_dev->NbrReportID; report_id_ix++) {
+    for (report_id_ix = 0u; report_id_ix < p_rd->NbrReportID; report_id_ix++) {
 
-        if (p_hid_dev->ReportID[report_id_ix].Type == type) {
+        if (p_rd->ReportID[report_id_ix].Type == type) {
 
-            if (p_hid_dev->ReportID[report_id_ix].Size > size) {
-                size        =  p_hid_dev->ReportID[report_id_ix].Size;
-                p_report_id = &p_hid_dev->ReportID[report_id_ix];
+            if (p_rd->ReportID[report_id_ix].Size > size) {
+                size        =  p_rd->ReportID[report_id_ix].Size;
+                p_report_id = &p_rd->ReportID[report_id_ix];
             }
         }
     }
@@ -506,6 +623,9 @@ static  void  USBH_HID_InitItemParser (USBH_HID_PARSER  *p_parser)
 
     USBH_HID_InitGlobalItem(&p_parser->Global);
     USBH_HID_InitLocalItem(&p_parser->Local);
+
+    p_parser->ArenaLo = 0u;
+    p_parser->ArenaHi = USBH_HID_ARENA_UNITS;
 }
 
 
@@ -525,32 +645,78 @@ static  void  USBH_HID_InitItemParser (USBH_HID_PARSER  *p_parser)
 
 static  void  USBH_HID_FreeItemParser (USBH_HID_PARSER  *p_parser)
 {
-    USBH_HID_GLOBAL  *p_global;
-    USBH_HID_GLOBAL  *p_global_free;
-    USBH_HID_COLL    *p_coll;
-    USBH_HID_COLL    *p_coll_free;
-    LIB_ERR           err_lib;
-
-                                                                /* --------------- FREE THE GLOBAL STACK -------------- */
-    p_global = p_parser->GlobalStkPtr;
-    while (p_global != (USBH_HID_GLOBAL *)0) {
-        p_global_free = p_global;
-        p_global      = p_global->NextPtr;
-
-        Mem_PoolBlkFree(       &USBH_HID_GlobalItemPool,
-                        (void *)p_global_free,
-                               &err_lib);
-    }
-                                                                /* ------------- FREE THE COLLECTION STACK ------------ */
-    p_coll = p_parser->CollStkPtr;
-    while (p_coll != (USBH_HID_COLL *)0) {
-        p_coll_free = p_coll;
-        p_coll      = p_coll->NextPtr;
-
-        Mem_PoolBlkFree(       &USBH_HID_CollPool,
-                        (void *)p_coll_free,
-                               &err_lib);
+    p_parser->GlobalStkPtr = (USBH_HID_GLOBAL *)0;              /* Release the whole arena.                             */
+    p_parser->CollStkPtr   = (USBH_HID_COLL   *)0;
+    p_parser->ArenaLo      =  0u;
+    p_parser->ArenaHi      =  USBH_HID_ARENA_UNITS;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_HID_ArenaReqGet()
+*
+* Description : Compute the parser arena required by a report descriptor.
+*
+* Argument(s) : p_report_desc       Pointer to report descriptor buffer.
+*
+*               desc_len            Length of report descriptor buffer in octets.
+*
+* Return(s)   : Number of arena units required.
+*
+* Note(s)     : (1) Only the nesting depths of collections and of push items are tracked. Malformed items
+*                   are left to USBH_HID_ItemParser() to report.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_HID_ArenaReqGet (CPU_INT08U  *p_report_desc,
+                                          CPU_INT32U   desc_len)
+{
+    CPU_INT32U  pos;
+    CPU_INT08U  item;
+    CPU_INT08U  type;
+    CPU_INT08U  tag;
+    CPU_INT32U  coll_depth;
+    CPU_INT32U  coll_depth_max;
+    CPU_INT32U  global_depth;
+    CPU_INT32U  global_depth_max;
+
+
+    pos              = 0u;
+    coll_depth       = 0u;
+    coll_depth_max   = 0u;
+    global_depth     = 0u;
+    global_depth_max = 0u;
+
+    while (pos < desc_len) {
+        item = p_report_desc[pos++];
+        if (item == USBH_HID_ITEM_LONG) {
+            break;
+        }
+        type = USBH_HID_ITEM_TYPE(item);
+        tag  = USBH_HID_ITEM_TAG(item);
+        pos += USBH_HID_ITEM_SIZE(item);
+
+        if (type == USBH_HID_ITEM_TYPE_MAIN) {
+            if (tag == USBH_HID_MAIN_ITEM_TAG_COLL) {
+                coll_depth++;
+                coll_depth_max = DEF_MAX(coll_depth_max, coll_depth);
+            } else if ((tag        == USBH_HID_MAIN_ITEM_TAG_ENDCOLL) &&
+                       (coll_depth >  0u)) {
+                coll_depth--;
+            }
+        } else if (type == USBH_HID_ITEM_TYPE_GLOBAL) {
+            if (tag == USBH_HID_GLOBAL_ITEM_TAG_PUSH) {
+                global_depth++;
+                global_depth_max = DEF_MAX(global_depth_max, global_depth);
+            } else if ((tag          == USBH_HID_GLOBAL_ITEM_TAG_POP) &&
+                       (global_depth >  0u)) {
+                global_depth--;
+            }
+        }
     }
+
+    return (coll_depth_max + (global_depth_max * USBH_HID_ARENA_GLOBAL_UNITS));
 }
 
 
@@ -613,7 +779,7 @@ static  void  USBH_HID_InitLocalItem (USBH_HID_LOCAL  *p_local)
 *
 * Description : Parse a main item.
 *
-* Argument(s) : p_hid_dev       Pointer to the HID device.
+* Argument(s) : p_rd            Pointer to parsed report descriptor.
 *
 *               p_parser        Pointer to the parser.
 *
@@ -624,7 +790,7 @@ static  void  USBH_HID_InitLocalItem (USBH_HID_LOCAL  *p_local)
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_HID_ParseMain (USBH_HID_DEV     *p_hid_dev,
+static  USBH_ERR  USBH_HID_ParseMain (USBH_HID_RD      *p_rd,
                                       USBH_HID_PARSER  *p_parser)
 {
     USBH_ERR  err;
@@ -635,11 +801,11 @@ static  USBH_ERR  USBH_HID_ParseMain (USBH_HID_DEV     *p_hid_dev,
         case USBH_HID_MAIN_ITEM_TAG_FEATURE:
         case USBH_HID_MAIN_ITEM_TAG_IN:
         case USBH_HID_MAIN_ITEM_TAG_OUT:
-             err = USBH_HID_AddReport(p_hid_dev, p_parser);     /* Add report to report list.                           */
+             err = USBH_HID_AddReport(p_rd, p_parser);          /* Add report to report list.                           */
              break;
 
         case USBH_HID_MAIN_ITEM_TAG_COLL:
-             err = USBH_HID_OpenColl(p_hid_dev, p_parser);      /* Open new collection.                                 */
+             err = USBH_HID_OpenColl(p_rd, p_parser);           /* Open new collection.                                 */
              break;
 
         case USBH_HID_MAIN_ITEM_TAG_ENDCOLL:
@@ -686,7 +852,6 @@ static  USBH_ERR  USBH_HID_ParseGlobal (USBH_HID_PARSER  *p_parser)
 {
     USBH_HID_GLOBAL  *p_global_new;
     USBH_HID_GLOBAL  *p_global_free;
-    LIB_ERR           err_lib;
 
 
     switch (p_parser->Tag) {
@@ -772,16 +937,15 @@ static  USBH_ERR  USBH_HID_ParseGlobal (USBH_HID_PARSER  *p_parser)
 #endif
                  return (USBH_ERR_HID_PUSH_SIZE);
              }
-                                                                /* Allocate memory for new entry.                       */
-             p_global_new = (USBH_HID_GLOBAL *)Mem_PoolBlkGet ((MEM_POOL *)&USBH_HID_GlobalItemPool,
-                                                                            sizeof(USBH_HID_GLOBAL),
-                                                                           &err_lib);
-             if (err_lib != LIB_MEM_ERR_NONE) {
+                                                                /* Allocate new entry from arena bottom.                */
+             if ((p_parser->ArenaLo + USBH_HID_ARENA_GLOBAL_UNITS) > p_parser->ArenaHi) {
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
                  USBH_PRINT_LOG("GLOBAL ITEM PUSH: OUT OF MEMORY\r\n");
 #endif
                  return (USBH_ERR_ALLOC);
              }
+             p_global_new       = (USBH_HID_GLOBAL *)&USBH_HID_ParserArena[p_parser->ArenaLo];
+             p_parser->ArenaLo +=  USBH_HID_ARENA_GLOBAL_UNITS;
 
             *p_global_new           = p_parser->Global;         /* Copy global to new entry.                            */
              p_global_new->NextPtr  = p_parser->GlobalStkPtr;
@@ -805,10 +969,8 @@ static  USBH_ERR  USBH_HID_ParseGlobal (USBH_HID_PARSER  *p_parser)
              p_parser->Global       = *(p_parser->GlobalStkPtr);/* Copy top element to global.                          */
              p_global_free          =   p_parser->GlobalStkPtr;
              p_parser->GlobalStkPtr =   p_global_free->NextPtr;
-
-             Mem_PoolBlkFree(       &USBH_HID_GlobalItemPool,   /* Free top item.                                       */
-                             (void *)p_global_free,
-                                    &err_lib);
+                                                                /* Free top item.                                       */
+             p_parser->ArenaLo     -=   USBH_HID_ARENA_GLOBAL_UNITS;
              break;
 
         default:
@@ -874,32 +1036,30 @@ static  USBH_ERR  USBH_HID_ParseLocal (USBH_HID_PARSER  *p_parser)
 *
 * Description : Add new collection item to collection stack.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : p_rd            Pointer to parsed report descriptor.
 *
 *               p_parser        Pointer to parser.
 *
 * Return(s)   : USBH_ERR_NONE,                  if collection opened successfully.
 *               USBH_ERR_HID_NOT_APP_COLL,      if top level collection not an application collection.
-*               USBH_ERR_ALLOC,                 if collection cannot be freed/allocated.
+*               USBH_ERR_ALLOC,                 if collection cannot be allocated.
 *
 * Note(s)     : None.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_HID_OpenColl (USBH_HID_DEV     *p_hid_dev,
+static  USBH_ERR  USBH_HID_OpenColl (USBH_HID_RD      *p_rd,
                                      USBH_HID_PARSER  *p_parser)
 {
     USBH_HID_COLL  *p_coll_new;
-    LIB_ERR         err_lib;
 
 
                                                                 /* --------------- INIT NEW COLLECTION ---------------- */
-    p_coll_new = (USBH_HID_COLL *)Mem_PoolBlkGet(&USBH_HID_CollPool,
-                                                  sizeof(USBH_HID_COLL),
-                                                 &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
+    if (p_parser->ArenaHi <= p_parser->ArenaLo) {               /* Allocate new entry from arena top.                   */
         return (USBH_ERR_ALLOC);
     }
+    p_parser->ArenaHi--;
+    p_coll_new = &USBH_HID_ParserArena[p_parser->ArenaHi];
                                                                 /* Initialize collection parameters.                    */
     p_coll_new->Usage = (((CPU_INT32U)p_parser->Global.UsagePage << 16u) & 0xFFFF0000u) | (CPU_INT32U)p_parser->Local.Usage[0];
     p_coll_new->Type  = USBH_HID_UNSIGNED_DATA(p_parser);
@@ -909,9 +1069,7 @@ static  USBH_ERR  USBH_HID_OpenColl (USBH_HID_DEV     *p_hid_dev,
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
         USBH_PRINT_LOG("OPEN COLLECTION: FIRST COLLECTION NOT APP COLLECTION\r\n");
 #endif
-        Mem_PoolBlkFree(       &USBH_HID_CollPool,
-                        (void *)p_coll_new,
-                               &err_lib);
+        p_parser->ArenaHi++;                                    /* Free new entry.                                      */
 
         return (USBH_ERR_HID_NOT_APP_COLL);
     }
@@ -922,26 +1080,22 @@ static  USBH_ERR  USBH_HID_OpenColl (USBH_HID_DEV     *p_hid_dev,
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
             USBH_PRINT_LOG("OPEN COLLECTION: NESTED\r\n");
 #endif
-            Mem_PoolBlkFree(       &USBH_HID_CollPool,
-                            (void *)p_coll_new,
-                                   &err_lib);
+            p_parser->ArenaHi++;
 
             return (USBH_ERR_HID_NOT_APP_COLL);
         }
                                                                 /* Max app collections exceeded.                        */
-        if (p_hid_dev->NbrAppColl == USBH_HID_CFG_MAX_NBR_APP_COLL) {
+        if (p_rd->NbrAppColl == USBH_HID_CFG_MAX_NBR_APP_COLL) {
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
             USBH_PRINT_LOG("OPEN COLLECTION: MAX APP COLLECTION EXCEEDED\r\n");
 #endif
-            Mem_PoolBlkFree(       &USBH_HID_CollPool,
-                            (void *)p_coll_new,
-                                   &err_lib);
+            p_parser->ArenaHi++;
 
             return (USBH_ERR_ALLOC);
         }
-        p_hid_dev->AppColl[p_hid_dev->NbrAppColl].Usage = p_coll_new->Usage;
-        p_hid_dev->AppColl[p_hid_dev->NbrAppColl].Type  = p_coll_new->Type;
-        p_hid_dev->NbrAppColl++;
+        p_rd->AppColl[p_rd->NbrAppColl].Usage = p_coll_new->Usage;
+        p_rd->AppColl[p_rd->NbrAppColl].Type  = p_coll_new->Type;
+        p_rd->NbrAppColl++;
     }
 
                                                                 /* ------------- PUT COLLECTION IN STACK -------------- */
@@ -970,7 +1124,6 @@ static  USBH_ERR  USBH_HID_OpenColl (USBH_HID_DEV     *p_hid_dev,
 static  USBH_ERR  USBH_HID_CloseColl (USBH_HID_PARSER  *p_parser)
 {
     USBH_HID_COLL  *p_coll_free;
-    LIB_ERR         err_lib;
 
 
     if (p_parser->CollStkPtr == (USBH_HID_COLL *)0) {           /* Collection stack should not be empty.                */
@@ -982,10 +1135,7 @@ static  USBH_ERR  USBH_HID_CloseColl (USBH_HID_PARSER  *p_parser)
 
     p_coll_free          = p_parser->CollStkPtr;                /* Remove top element from collection stack.            */
     p_parser->CollStkPtr = p_coll_free->NextPtr;
-
-    Mem_PoolBlkFree(       &USBH_HID_CollPool,
-                    (void *)p_coll_free,
-                           &err_lib);
+    p_parser->ArenaHi++;                                        /* Free top element.                                    */
 
     return (USBH_ERR_NONE);
 }
@@ -997,7 +1147,7 @@ static  USBH_ERR  USBH_HID_CloseColl (USBH_HID_PARSER  *p_parser)
 *
 * Description : Add new report to report list in application collection.
 *
-* Argument(s) : p_hid_dev       Pointer to HID device.
+* Argument(s) : p_rd            Pointer to parsed report descriptor.
 *
 *               p_parser        Pointer to parser.
 *
@@ -1012,7 +1162,7 @@ static  USBH_ERR  USBH_HID_CloseColl (USBH_HID_PARSER  *p_parser)
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_HID_AddReport (USBH_HID_DEV     *p_hid_dev,
+static  USBH_ERR  USBH_HID_AddReport (USBH_HID_RD      *p_rd,
                                       USBH_HID_PARSER  *p_parser)
 {
     USBH_HID_REPORT_FMT  *p_report_new;
@@ -1020,14 +1170,14 @@ static  USBH_ERR  USBH_HID_AddReport (USBH_HID_DEV     *p_hid_dev,
     USBH_ERR              err;
 
 
-    if (p_hid_dev->NbrAppColl == 0u) {                           /* Rtn error if no app collections exist.               */
+    if (p_rd->NbrAppColl == 0u) {                               /* Rtn error if no app collections exist.               */
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
         USBH_PRINT_LOG("ADD REPORT: NO APP COLLECTION's\r\n");
 #endif
         return (USBH_ERR_HID_REPORT_OUTSIDE_COLL);
     }
                                                                 /* Current Application Collection                       */
-    p_app_coll = &p_hid_dev->AppColl[p_hid_dev->NbrAppColl - 1u];
+    p_app_coll = &p_rd->AppColl[p_rd->NbrAppColl - 1u];
 
     if (p_app_coll->NbrReportFmt == USBH_HID_CFG_MAX_NBR_REPORT_FMT) {
         return (USBH_ERR_ALLOC);
@@ -1039,7 +1189,7 @@ static  USBH_ERR  USBH_HID_AddReport (USBH_HID_DEV     *p_hid_dev,
                                                                 /* ----------------- INITIALIZE REPORT ---------------- */
     USBH_HID_InitReport(p_parser, p_report_new);
     if (p_report_new->ReportID != 0u) {
-        p_hid_dev->IsReportID_Present = DEF_TRUE;
+        p_rd->IsReportID_Present = DEF_TRUE;
     }
 
                                                                 /* ------------------ VALIDATE REPORT ----------------- */
@@ -90,13 +90,15 @@
 
 USBH_ERR             USBH_HID_ParserGlobalInit(void);
 
-USBH_ERR             USBH_HID_ItemParser      (USBH_HID_DEV  *p_hid_dev,
+USBH_ERR             USBH_HID_ItemParser      (USBH_HID_RD   *p_rd,
                                                CPU_INT08U    *p_report_desc,
                                                CPU_INT32U     desc_len);
 
-USBH_ERR             USBH_HID_CreateReportID  (USBH_HID_DEV  *p_hid_dev);
+USBH_ERR             USBH_HID_CreateReportID  (USBH_HID_RD   *p_rd);
 
-USBH_HID_REPORT_ID  *USBH_HID_MaxReport       (USBH_HID_DEV  *p_hid_dev,
+USBH_ERR             USBH_HID_CreateFieldTbl  (USBH_HID_RD   *p_rd);
+
+USBH_HID_REPORT_ID  *USBH_HID_MaxReport       (USBH_HID_RD   *p_rd,
                                                CPU_INT08U     type);
 
 
@@ -52,11 +52,41 @@
 #define  USBH_MSC_SIG_CBW                             0x43425355u
 #define  USBH_MSC_SIG_CSW                             0x53425355u
 
-#define  USBH_MSC_LEN_CBW                                     31u
-#define  USBH_MSC_LEN_CSW                                     13u
-
 #define  USBH_MSC_MAX_TRANSFER_RETRY                        1000u
 
+                                                                /* ---------------- PIPELINED CMD FLAGS --------------- */
+#define  USBH_MSC_CMD_FLAG_CBW_SUBMIT               DEF_BIT_00  /* CBW submitted.                                       */
+#define  USBH_MSC_CMD_FLAG_CBW_DONE                 DEF_BIT_01  /* CBW xfered.                                          */
+#define  USBH_MSC_CMD_FLAG_CSW_SUBMIT               DEF_BIT_02  /* CSW submitted.                                       */
+#define  USBH_MSC_CMD_FLAG_CSW_RX                   DEF_BIT_03  /* CSW received.                                        */
+#define  USBH_MSC_CMD_FLAG_DATA_SHORT               DEF_BIT_04  /* Data stage ended by short pkt.                       */
+#define  USBH_MSC_CMD_FLAG_FILL                     DEF_BIT_05  /* Stages being submitted.                              */
+#define  USBH_MSC_CMD_FLAG_FILL_REQ                 DEF_BIT_06  /* Submission requested while submitting.               */
+#define  USBH_MSC_CMD_FLAG_SIGNALED                 DEF_BIT_07  /* Task waiting for cmd signaled.                       */
+#define  USBH_MSC_CMD_FLAG_CLEAN                    DEF_BIT_08  /* Cmd completed without err.                           */
+#define  USBH_MSC_CMD_FLAG_DRAIN                    DEF_BIT_09  /* Aborted URBs to be completed.                        */
+#define  USBH_MSC_CMD_FLAG_ABORT                    DEF_BIT_10  /* URBs being aborted.                                  */
+
+#define  USBH_MSC_CMD_STAGE_NONE                               0u
+#define  USBH_MSC_CMD_STAGE_CBW                                1u
+#define  USBH_MSC_CMD_STAGE_DATA                               2u
+#define  USBH_MSC_CMD_STAGE_CSW                                3u
+
+#define  USBH_MSC_CACHE_BLK_STATE_FREE                         0u
+#define  USBH_MSC_CACHE_BLK_STATE_CLEAN                        1u
+#define  USBH_MSC_CACHE_BLK_STATE_DIRTY                        2u
+
+#define  USBH_MSC_CACHE_ARENA_SIZE          ((USBH_MSC_CFG_CACHE_BLK_NBR + USBH_MSC_CFG_CACHE_XFER_BLK_NBR) * \
+                                              USBH_MSC_CFG_CACHE_BLK_SIZE)
+
+                                                                /* Unlock dev while rd / wr cmds are issued.            */
+#if ((USBH_MSC_CFG_PIPE_EN  == DEF_ENABLED) && \
+     (USBH_MSC_CFG_CACHE_EN != DEF_ENABLED))
+#define  USBH_MSC_XFER_UNLOCK_EN                    DEF_ENABLED
+#else
+#define  USBH_MSC_XFER_UNLOCK_EN                    DEF_DISABLED
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -512,6 +542,16 @@
 #define USBH_SCSI_PAGE_LENGTH_READ_WRITE_ERROR_RECOVERY     0x0Au
 #define USBH_SCSI_PAGE_LENGTH_FLEXIBLE_DISK                 0x1Eu
 #define USBH_SCSI_PAGE_LENGTH_FORMAT_DEVICE                 0x16u
+                                                                /* -------------------- SCSI VPD PAGES -------------------- */
+#define  USBH_SCSI_VPD_PAGE_SUPPORTED                       0x00u
+#define  USBH_SCSI_VPD_PAGE_BLK_LIMITS                      0xB0u
+#define  USBH_SCSI_VPD_LEN_MAX                                64u
+                                                                /* ----------------- SCSI SERVICE ACTIONS ----------------- */
+#define  USBH_SCSI_SA_READ_CAPACITY_16                      0x10u
+                                                                /* ------------------- SCSI CMD LIMITS -------------------- */
+#define  USBH_SCSI_BLK_NBR_MAX_10                         0xFFFFu   /* Max nbr of blks of a READ (10) / WRITE (10) cmd.    */
+#define  USBH_SCSI_LBA_MAX_10                         0xFFFFFFFFu   /* Max LBA         of a READ (10) / WRITE (10) cmd.    */
+#define  USBH_SCSI_VER_SPC_3                                0x05u   /* INQUIRY VERSION of a dev compliant with SPC-3.      */
 
 
 /*
@@ -588,6 +628,10 @@ typedef  struct  usbh_msc_csw {
 static  USBH_MSC_DEV  USBH_MSC_DevArr[USBH_MSC_CFG_MAX_DEV];
 static  MEM_POOL      USBH_MSC_DevPool;
 
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)                      /* Cache arena (see 'usbh_msc.h  Note #3').             */
+static  CPU_INT08U    USBH_MSC_CacheArena[USBH_MSC_CFG_MAX_DEV][USBH_MSC_CACHE_ARENA_SIZE];
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -622,8 +666,28 @@ static  CPU_INT32U   USBH_MSC_XferCmd            (USBH_MSC_DEV           *p_msc_
                                                   CPU_INT32U              data_len,
                                                   USBH_ERR               *p_err);
 
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR     USBH_MSC_XferCmdAsync       (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  void                   *p_cb,
+                                                  CPU_INT08U              cb_len,
+                                                  void                   *p_arg,
+                                                  CPU_INT32U              data_len,
+                                                  USBH_MSC_XFER_CMPL_FNCT fnct,
+                                                  void                   *p_fnct_arg);
+#endif
+
+static  CPU_INT32U   USBH_MSC_CSW_Chk            (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT32U              tag,
+                                                  CPU_INT32U              data_len,
+                                                  USBH_MSC_CSW           *p_msc_csw,
+                                                  USBH_ERR               *p_err);
+
+#if (USBH_MSC_CFG_PIPE_EN != DEF_ENABLED)
 static  USBH_ERR     USBH_MSC_TxCBW              (USBH_MSC_DEV           *p_msc_dev,
                                                   USBH_MSC_CBW           *p_msc_cbw);
+#endif
 
 static  USBH_ERR     USBH_MSC_RxCSW              (USBH_MSC_DEV           *p_msc_dev,
                                                   USBH_MSC_CSW           *p_msc_csw);
@@ -638,8 +702,63 @@ static  USBH_ERR     USBH_MSC_RxData             (USBH_MSC_DEV           *p_msc_
 
 static  USBH_ERR     USBH_MSC_ResetRecovery      (USBH_MSC_DEV           *p_msc_dev);
 
+static  USBH_ERR     USBH_MSC_StallClr           (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_EP                *p_ep);
+
 static  USBH_ERR     USBH_MSC_BulkOnlyReset      (USBH_MSC_DEV           *p_msc_dev);
 
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_MSC_CMD  *USBH_MSC_PipeCmdGet       (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_BOOLEAN             wait,
+                                                  USBH_ERR               *p_err);
+
+static  void         USBH_MSC_PipeCmdRel         (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_MSC_CMD           *p_cmd);
+
+static  USBH_MSC_CMD  *USBH_MSC_PipeNxt          (USBH_MSC_DEV           *p_msc_dev);
+
+static  void         USBH_MSC_PipeStart          (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_MSC_CMD           *p_cmd,
+                                                  USBH_MSC_CBW           *p_msc_cbw,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  void                   *p_arg,
+                                                  USBH_MSC_XFER_CMPL_FNCT fnct,
+                                                  void                   *p_fnct_arg);
+
+static  USBH_ERR     USBH_MSC_PipeXfer           (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_MSC_CMD           *p_cmd,
+                                                  USBH_MSC_CBW           *p_msc_cbw,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  void                   *p_arg,
+                                                  USBH_MSC_CSW           *p_msc_csw,
+                                                  USBH_ERR               *p_csw_err);
+
+static  USBH_ERR     USBH_MSC_PipeRecover        (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_MSC_CMD           *p_cmd,
+                                                  USBH_MSC_CSW           *p_msc_csw,
+                                                  USBH_ERR               *p_csw_err);
+
+static  void         USBH_MSC_PipeAsyncEnd       (USBH_MSC_CMD           *p_cmd);
+
+static  CPU_BOOLEAN  USBH_MSC_PipeAbort          (USBH_MSC_CMD           *p_cmd);
+
+static  void         USBH_MSC_PipeRun            (USBH_MSC_CMD           *p_cmd);
+
+static  void         USBH_MSC_PipeFill           (USBH_MSC_CMD           *p_cmd);
+
+static  USBH_ERR     USBH_MSC_PipeSubmit         (USBH_MSC_CMD           *p_cmd,
+                                                  USBH_EP                *p_ep,
+                                                  void                   *p_buf,
+                                                  CPU_INT32U              len);
+
+static  void         USBH_MSC_PipeCmpl           (USBH_EP                *p_ep,
+                                                  void                   *p_buf,
+                                                  CPU_INT32U              buf_len,
+                                                  CPU_INT32U              xfer_len,
+                                                  void                   *p_arg,
+                                                  USBH_ERR                err);
+#endif
+
 static  void         USBH_MSC_FmtCBW             (USBH_MSC_CBW           *p_cbw,
                                                   void                   *p_buf_dest);
 
@@ -649,6 +768,11 @@ static  void         USBH_MSC_ParseCSW           (USBH_MSC_CSW           *p_csw,
 static  USBH_ERR     USBH_SCSI_CMD_TestUnitReady (USBH_MSC_DEV           *p_msc_dev,
                                                   CPU_INT08U              lun);
 
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  USBH_ERR     USBH_SCSI_CMD_SyncCache     (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun);
+#endif
+
 static  USBH_ERR     USBH_SCSI_CMD_StdInquiry    (USBH_MSC_DEV           *p_msc_dev,
                                                   USBH_MSC_INQUIRY_INFO  *p_msc_inquiry_info,
                                                   CPU_INT08U              lun);
@@ -665,27 +789,135 @@ static  USBH_ERR     USBH_SCSI_GetSenseInfo      (USBH_MSC_DEV           *p_msc_
                                                   CPU_INT08U             *p_asc,
                                                   CPU_INT08U             *p_ascq);
 
+static  CPU_BOOLEAN  USBH_SCSI_RetryChk          (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  CPU_INT08U              retry_ix);
+
 static  USBH_ERR     USBH_SCSI_CMD_CapacityRd    (USBH_MSC_DEV           *p_msc_dev,
                                                   CPU_INT08U              lun,
-                                                  CPU_INT32U             *p_nbr_blks,
+                                                  CPU_INT64U             *p_nbr_blks,
+                                                  CPU_INT32U             *p_blk_size);
+
+static  USBH_ERR     USBH_SCSI_CMD_CapacityRd16  (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  CPU_INT64U             *p_nbr_blks,
                                                   CPU_INT32U             *p_blk_size);
 
-static  CPU_INT32U   USBH_SCSI_Rd                (USBH_MSC_DEV           *p_msc_dev,
+static  CPU_INT32U   USBH_SCSI_CMD_Inquiry       (USBH_SCSI_XFER_FNCT     xfer_fnct,
+                                                  void                   *p_dev,
+                                                  CPU_INT08U              lun,
+                                                  CPU_BOOLEAN             vpd,
+                                                  CPU_INT08U              page,
+                                                  CPU_INT08U             *p_arg,
+                                                  CPU_INT08U              data_len,
+                                                  USBH_ERR               *p_err);
+
+static  USBH_SCSI_LUN  *USBH_MSC_LUN_Get         (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun);
+
+static  CPU_INT32U   USBH_MSC_SCSI_Xfer          (void                   *p_dev,
+                                                  CPU_INT08U              lun,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  void                   *p_cb,
+                                                  CPU_INT08U              cb_len,
+                                                  void                   *p_arg,
+                                                  CPU_INT32U              data_len,
+                                                  USBH_ERR               *p_err);
+
+static  CPU_INT32U   USBH_MSC_SCSI_XferRetry     (void                   *p_dev,
+                                                  CPU_INT08U              lun,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  void                   *p_cb,
+                                                  CPU_INT08U              cb_len,
+                                                  void                   *p_arg,
+                                                  CPU_INT32U              data_len,
+                                                  USBH_ERR               *p_err);
+
+static  CPU_INT32U   USBH_MSC_SCSI_RdWr          (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  CPU_INT64U              blk_addr,
+                                                  CPU_INT32U              nbr_blks,
+                                                  CPU_INT32U              blk_size,
+                                                  void                   *p_arg,
+                                                  USBH_ERR               *p_err);
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR     USBH_MSC_SCSI_RdWrAsync     (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  CPU_INT64U              blk_addr,
+                                                  CPU_INT32U              nbr_blks,
+                                                  CPU_INT32U              blk_size,
+                                                  void                   *p_arg,
+                                                  USBH_MSC_XFER_CMPL_FNCT fnct,
+                                                  void                   *p_fnct_arg);
+#endif
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void         USBH_MSC_CacheClr           (USBH_MSC_DEV           *p_msc_dev);
+
+static  USBH_MSC_CACHE_BLK  *USBH_MSC_CacheBlkFind  (USBH_MSC_DEV           *p_msc_dev,
+                                                     CPU_INT08U              lun,
+                                                     CPU_INT64U              blk_addr);
+
+static  void         USBH_MSC_CacheBlkUse        (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_MSC_CACHE_BLK     *p_blk);
+
+static  void         USBH_MSC_CacheBlkInval      (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_MSC_CACHE_BLK     *p_blk);
+
+static  USBH_MSC_CACHE_BLK  *USBH_MSC_CacheBlkAlloc (USBH_MSC_DEV           *p_msc_dev,
+                                                     USBH_ERR               *p_err);
+
+static  void         USBH_MSC_CacheWrBack        (USBH_MSC_DEV           *p_msc_dev,
+                                                  USBH_MSC_CACHE_BLK     *p_blk,
+                                                  USBH_ERR               *p_err);
+
+static  void         USBH_MSC_CacheSync          (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  CPU_INT64U              blk_addr,
+                                                  CPU_INT64U              nbr_blks,
+                                                  CPU_BOOLEAN             inval,
+                                                  USBH_ERR               *p_err);
+
+static  void         USBH_MSC_CacheBlkSizeSet    (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT32U              blk_size,
+                                                  USBH_ERR               *p_err);
+
+static  void         USBH_MSC_CacheFill          (USBH_MSC_DEV           *p_msc_dev,
                                                   CPU_INT08U              lun,
-                                                  CPU_INT32U              blk_addr,
-                                                  CPU_INT16U              nbr_blks,
+                                                  CPU_INT64U              blk_addr,
+                                                  CPU_INT32U              nbr_blks,
+                                                  USBH_ERR               *p_err);
+
+static  CPU_INT32U   USBH_MSC_CacheRd            (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  CPU_INT64U              blk_addr,
+                                                  CPU_INT32U              nbr_blks,
                                                   CPU_INT32U              blk_size,
                                                   void                   *p_arg,
                                                   USBH_ERR               *p_err);
 
-static  CPU_INT32U   USBH_SCSI_Wr                (USBH_MSC_DEV           *p_msc_dev,
+static  CPU_INT32U   USBH_MSC_CacheWr            (USBH_MSC_DEV           *p_msc_dev,
                                                   CPU_INT08U              lun,
-                                                  CPU_INT32U              blk_addr,
-                                                  CPU_INT16U              nbr_blks,
+                                                  CPU_INT64U              blk_addr,
+                                                  CPU_INT32U              nbr_blks,
                                                   CPU_INT32U              blk_size,
                                                   const  void            *p_arg,
                                                   USBH_ERR               *p_err);
 
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void         USBH_MSC_CacheBypass        (USBH_MSC_DEV           *p_msc_dev,
+                                                  CPU_INT08U              lun,
+                                                  USBH_MSC_DATA_DIR       dir,
+                                                  CPU_INT64U              blk_addr,
+                                                  CPU_INT32U              nbr_blks,
+                                                  CPU_INT32U              blk_size,
+                                                  USBH_ERR               *p_err);
+#endif
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -1016,7 +1248,7 @@ CPU_BOOLEAN  USBH_MSC_UnitRdyTest (USBH_MSC_DEV  *p_msc_dev,
     if ((p_msc_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
         (p_msc_dev->RefCnt > 0u                       )) {
 
-       *p_err = USBH_SCSI_CMD_TestUnitReady(p_msc_dev, 0u);
+       *p_err = USBH_SCSI_CMD_TestUnitReady(p_msc_dev, lun);
         if (*p_err == USBH_ERR_NONE) {
             unit_rdy = DEF_YES;
         } else if (*p_err == USBH_ERR_MSC_CMD_FAILED) {
@@ -1052,15 +1284,15 @@ CPU_BOOLEAN  USBH_MSC_UnitRdyTest (USBH_MSC_DEV  *p_msc_dev,
 * Return(s)   : USBH_ERR_NONE,              If capacity of MSC device retrieved successfully.
 *               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'p_msc_dev' / 'p_nbr_blks' /
 *                                           'p_blk_size'.
-*               USBH_ERR_DEV_NOT_READY,     If device enumeration not completed.
+*               USBH_ERR_NOT_SUPPORTED,     If number of blocks does not fit in 32 bits (see Note #1).
 *
-*                                           ----- RETURNED BY USBH_OS_MutexLock() : -----
-*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'mutex'.
+*                                           ----- RETURNED BY USBH_MSC_CapacityRd64() : -----
+*               USBH_ERR_DEV_NOT_READY,     If device enumeration not completed.
 *               USBH_ERR_OS_ABORT,          If mutex wait aborted.
 *               USBH_ERR_OS_FAIL,           Otherwise.
 *               List error codes from USBH_SCSI_CMD_CapacityRd
 *
-* Note(s)     : None.
+* Note(s)     : (1) Devices of more than 2^32 blocks must be accessed with USBH_MSC_CapacityRd64().
 *********************************************************************************************************
 */
 
@@ -1068,12 +1300,77 @@ USBH_ERR  USBH_MSC_CapacityRd (USBH_MSC_DEV  *p_msc_dev,
                                CPU_INT08U     lun,
                                CPU_INT32U    *p_nbr_blks,
                                CPU_INT32U    *p_blk_size)
+{
+    CPU_INT64U  nbr_blks;
+    USBH_ERR    err;
+
+                                                                /* ------------------- VALIDATE PTR ------------------- */
+    if (p_nbr_blks == (CPU_INT32U *)0) {
+        err = USBH_ERR_INVALID_ARG;
+        return (err);
+    }
+
+    err = USBH_MSC_CapacityRd64( p_msc_dev,
+                                 lun,
+                                &nbr_blks,
+                                 p_blk_size);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    if (nbr_blks > DEF_INT_32U_MAX_VAL) {                       /* See Note #1.                                         */
+        err = USBH_ERR_NOT_SUPPORTED;
+    } else {
+       *p_nbr_blks = (CPU_INT32U)nbr_blks;
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_MSC_CapacityRd64()
+*
+* Description : Read mass storage device capacity (i.e number of blocks and block size) of specified LUN
+*               by sending READ_CAPACITY (10) and, for devices of more than 2^32 blocks, READ_CAPACITY
+*               (16) SCSI commands.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+*               p_nbr_blks      Pointer to variable that receives number of blocks.
+*
+*               p_blk_size      Pointer to variable that receives block size.
+*
+* Return(s)   : USBH_ERR_NONE,              If capacity of MSC device retrieved successfully.
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'p_msc_dev' / 'p_nbr_blks' /
+*                                           'p_blk_size'.
+*               USBH_ERR_DEV_NOT_READY,     If device enumeration not completed.
+*
+*                                           ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'mutex'.
+*               USBH_ERR_OS_ABORT,          If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,           Otherwise.
+*               List error codes from USBH_SCSI_CMD_CapacityRd
+*
+* Note(s)     : (1) The first successful capacity read of a LUN also requests its Block Limits VPD page,
+*                   which bounds the number of blocks of each read or write command of the LUN (see
+*                   USBH_SCSI_RdWr()). The page is not requested for LUNs beyond USBH_MSC_CFG_MAX_LUN.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_MSC_CapacityRd64 (USBH_MSC_DEV  *p_msc_dev,
+                                 CPU_INT08U     lun,
+                                 CPU_INT64U    *p_nbr_blks,
+                                 CPU_INT32U    *p_blk_size)
 {
     USBH_ERR  err;
 
                                                                 /* ------------------- VALIDATE PTR ------------------- */
     if ((p_msc_dev  == (USBH_MSC_DEV *)0) ||
-        (p_nbr_blks == (CPU_INT32U   *)0) ||
+        (p_nbr_blks == (CPU_INT64U   *)0) ||
         (p_blk_size == (CPU_INT32U   *)0)) {
         err = USBH_ERR_INVALID_ARG;
         return (err);
@@ -1092,6 +1389,14 @@ USBH_ERR  USBH_MSC_CapacityRd (USBH_MSC_DEV  *p_msc_dev,
                                        lun,
                                        p_nbr_blks,
                                        p_blk_size);
+        if ((err == USBH_ERR_NONE       ) &&
+            (lun <  USBH_MSC_CFG_MAX_LUN)) {
+                                                                /* See Note #1.                                         */
+            USBH_SCSI_BlkLimitsRd(&p_msc_dev->LUN_Tbl[lun],
+                                   USBH_MSC_SCSI_Xfer,
+                           (void *)p_msc_dev,
+                                   lun);
+        }
     } else {                                                    /* MSC dev enumeration not completed by host.           */
         err = USBH_ERR_DEV_NOT_READY;
     }
@@ -1269,7 +1574,7 @@ USBH_ERR  USBH_MSC_RefRel (USBH_MSC_DEV  *p_msc_dev)
 *********************************************************************************************************
 *                                             USBH_MSC_Rd()
 *
-* Description : Read specified number of blocks from device using READ_10 SCSI command.
+* Description : Read specified number of blocks from device using READ (10) or READ (16) SCSI commands.
 *
 * Argument(s) : p_msc_dev        Pointer to MSC device.
 *
@@ -1294,7 +1599,8 @@ USBH_ERR  USBH_MSC_RefRel (USBH_MSC_DEV  *p_msc_dev)
 *                           USBH_ERR_OS_ABORT,                      If mutex wait aborted.
 *                           USBH_ERR_OS_FAIL,                       Otherwise.
 *
-*                                                                   ----- RETURNED BY USBH_SCSI_Rd -----
+*                                                                   ----- RETURNED BY USBH_MSC_SCSI_RdWr -----
+*                           USBH_ERR_INVALID_ARG                    If transfer exceeds 2^32 - 1 octets.
 *                           USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
 *                           USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
 *                           USBH_ERR_MSC_IO                         Unable to receive CSW.
@@ -1305,14 +1611,26 @@ USBH_ERR  USBH_MSC_RefRel (USBH_MSC_DEV  *p_msc_dev)
 *
 * Return(s)   : Number of octets read.
 *
-* Note(s)     : None.
+* Note(s)     : (1) When USBH_MSC_CFG_PIPE_EN is DEF_ENABLED, the device is unlocked before the
+*                   command is issued. Commands of concurrent callers are queued on the device and
+*                   executed back to back (see USBH_MSC_XferCmd() Note #1). The caller holds a
+*                   reference on the device, so that it is not freed meanwhile.
+*
+*                   When USBH_MSC_CFG_CACHE_EN is DEF_ENABLED, the device stays locked, since the cache
+*                   is shared by all callers.
+*
+*               (2) A read larger than the device accepts in one command is split in several commands
+*                   (see USBH_MSC_SCSI_RdWr()).
+*
+*               (3) When USBH_MSC_CFG_CACHE_EN is DEF_ENABLED, the blocks are read through the cache
+*                   (see USBH_MSC_CacheRd()).
 *********************************************************************************************************
 */
 
 CPU_INT32U  USBH_MSC_Rd (USBH_MSC_DEV  *p_msc_dev,
                          CPU_INT08U     lun,
-                         CPU_INT32U     blk_addr,
-                         CPU_INT16U     nbr_blks,
+                         CPU_INT64U     blk_addr,
+                         CPU_INT32U     nbr_blks,
                          CPU_INT32U     blk_size,
                          void          *p_arg,
                          USBH_ERR      *p_err)
@@ -1333,19 +1651,38 @@ CPU_INT32U  USBH_MSC_Rd (USBH_MSC_DEV  *p_msc_dev,
 
     if ((p_msc_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
         (p_msc_dev->RefCnt > 0u                       )) {
-        xfer_len = USBH_SCSI_Rd(p_msc_dev,
-                                lun,
-                                blk_addr,
-                                nbr_blks,
-                                blk_size,
-                                p_arg,
-                                p_err);
+#if (USBH_MSC_XFER_UNLOCK_EN == DEF_ENABLED)
+        (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);           /* See Note #1.                                         */
+#endif
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+        xfer_len = USBH_MSC_CacheRd(p_msc_dev,                  /* See Note #3.                                         */
+                                    lun,
+                                    blk_addr,
+                                    nbr_blks,
+                                    blk_size,
+                                    p_arg,
+                                    p_err);
+#else
+        xfer_len = USBH_MSC_SCSI_RdWr(p_msc_dev,
+                                      lun,
+                                      USBH_MSC_DATA_DIR_IN,
+                                      blk_addr,
+                                      nbr_blks,
+                                      blk_size,
+                                      p_arg,
+                                      p_err);
+#endif
     } else {
         xfer_len = 0u;
        *p_err    = USBH_ERR_DEV_NOT_READY;
+#if (USBH_MSC_XFER_UNLOCK_EN == DEF_ENABLED)
+        (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+#endif
     }
 
+#if (USBH_MSC_XFER_UNLOCK_EN != DEF_ENABLED)
     (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+#endif
 
     return (xfer_len);
 }
@@ -1355,7 +1692,7 @@ CPU_INT32U  USBH_MSC_Rd (USBH_MSC_DEV  *p_msc_dev,
 *********************************************************************************************************
 *                                             USBH_MSC_Wr()
 *
-* Description : Write specified number of blocks to the device.
+* Description : Write specified number of blocks to device using WRITE (10) or WRITE (16) SCSI commands.
 *
 * Argument(s) : p_msc_dev        Pointer to mass storage device.
 *
@@ -1380,7 +1717,8 @@ CPU_INT32U  USBH_MSC_Rd (USBH_MSC_DEV  *p_msc_dev,
 *                       USBH_ERR_OS_ABORT,                      If mutex wait aborted.
 *                       USBH_ERR_OS_FAIL,                       Otherwise.
 *
-*                                                               ----- RETURNED BY USBH_SCSI_Rd -----
+*                                                               ----- RETURNED BY USBH_MSC_SCSI_RdWr -----
+*                       USBH_ERR_INVALID_ARG                    If transfer exceeds 2^32 - 1 octets.
 *                       USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
 *                       USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
 *                       USBH_ERR_MSC_IO                         Unable to receive CSW.
@@ -1391,14 +1729,20 @@ CPU_INT32U  USBH_MSC_Rd (USBH_MSC_DEV  *p_msc_dev,
 *
 * Return(s)   : Number of octets written.
 *
-* Note(s)     : None.
+* Note(s)     : (1) See USBH_MSC_Rd() Note #1.
+*
+*               (2) A write larger than the device accepts in one command is split in several commands
+*                   (see USBH_MSC_SCSI_RdWr()).
+*
+*               (3) When USBH_MSC_CFG_CACHE_EN is DEF_ENABLED, the blocks are written to the cache and
+*                   written back to the device later (see USBH_MSC_CacheWr()).
 *********************************************************************************************************
 */
 
 CPU_INT32U  USBH_MSC_Wr (       USBH_MSC_DEV  *p_msc_dev,
                                 CPU_INT08U     lun,
-                                CPU_INT32U     blk_addr,
-                                CPU_INT16U     nbr_blks,
+                                CPU_INT64U     blk_addr,
+                                CPU_INT32U     nbr_blks,
                                 CPU_INT32U     blk_size,
                          const  void          *p_arg,
                                 USBH_ERR      *p_err)
@@ -1419,19 +1763,38 @@ CPU_INT32U  USBH_MSC_Wr (       USBH_MSC_DEV  *p_msc_dev,
 
     if ((p_msc_dev->State == USBH_CLASS_DEV_STATE_CONN     ) &&
         (p_msc_dev->RefCnt > 0                             )) {
-        xfer_len = USBH_SCSI_Wr(p_msc_dev,
-                                lun,
-                                blk_addr,
-                                nbr_blks,
-                                blk_size,
-                                p_arg,
-                                p_err);
+#if (USBH_MSC_XFER_UNLOCK_EN == DEF_ENABLED)
+        (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);           /* See Note #1.                                         */
+#endif
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+        xfer_len = USBH_MSC_CacheWr(p_msc_dev,                  /* See Note #3.                                         */
+                                    lun,
+                                    blk_addr,
+                                    nbr_blks,
+                                    blk_size,
+                                    p_arg,
+                                    p_err);
+#else
+        xfer_len = USBH_MSC_SCSI_RdWr(        p_msc_dev,
+                                              lun,
+                                              USBH_MSC_DATA_DIR_OUT,
+                                              blk_addr,
+                                              nbr_blks,
+                                              blk_size,
+                                      (void *)p_arg,
+                                              p_err);
+#endif
     } else {
         xfer_len = 0u;
        *p_err    = USBH_ERR_DEV_NOT_READY;
+#if (USBH_MSC_XFER_UNLOCK_EN == DEF_ENABLED)
+        (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+#endif
     }
 
+#if (USBH_MSC_XFER_UNLOCK_EN != DEF_ENABLED)
     (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+#endif
 
     return (xfer_len);
 }
@@ -1439,886 +1802,4017 @@ CPU_INT32U  USBH_MSC_Wr (       USBH_MSC_DEV  *p_msc_dev,
 
 /*
 *********************************************************************************************************
-*********************************************************************************************************
-*                                           LOCAL FUNCTIONS
-*********************************************************************************************************
-*********************************************************************************************************
-*/
-
-/*
-*********************************************************************************************************
-*                                        USBH_MSC_GlobalInit()
+*                                          USBH_MSC_RdAsync()
 *
-* Description : Initialize MSC.
+* Description : Queue a read of specified number of blocks from device using a READ (10) or READ (16) SCSI
+*               command. The function returns immediately and the completion is notified to the given
+*               function.
 *
-* Argument(s) : p_err   Pointer to variable that will receive the return error code from this function :
+* Argument(s) : p_msc_dev        Pointer to MSC device.
 *
-*                           USBH_ERR_NONE       MSC successfully initalized.
-*                           USBH_ERR_ALLOC      If MSC device cannot be allocated.
+*               lun              Logical unit number.
 *
-* Return(s)   : None.
+*               blk_addr         Block address.
 *
-* Note(s)     : None.
+*               nbr_blks         Number of blocks to read.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               fnct             Function notified when the read completes (see Note #2).
+*
+*               p_fnct_arg       Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,                  if the read is successfully queued.
+*               USBH_ERR_INVALID_ARG,           if invalid argument passed to 'p_msc_dev' / 'fnct'.
+*               USBH_ERR_DEV_NOT_READY,         if device enumeration not completed.
+*
+*                                               ----- RETURNED BY USBH_MSC_SCSI_RdWrAsync() : -----
+*               USBH_ERR_INVALID_ARG,           if the read does not fit in one command (see Note #3).
+*               USBH_ERR_ALLOC,                 if USBH_MSC_CFG_CMD_Q_LEN commands are already queued.
+*
+*                                               ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_OS_ABORT,              if mutex wait aborted.
+*               USBH_ERR_OS_FAIL,               Otherwise.
+*
+*                                               ----- RETURNED BY USBH_MSC_CacheBypass() : -----
+*               USBH_ERR_MSC_IO,                if the device accepted fewer blocks than written back.
+*               Other error codes,              see USBH_MSC_SCSI_RdWr().
+*
+* Note(s)     : (1) The read is queued behind the commands already queued on the device for the same
+*                   LUN, from any task; the commands of different LUNs are interleaved (see 'usbh_msc.h
+*                   Note #4'). The device is not locked, so that this function can be called from a
+*                   completion function, unless USBH_MSC_CFG_CACHE_EN is DEF_ENABLED (see Note #4). The
+*                   caller must hold a reference on the device (see USBH_MSC_RefAdd()).
+*
+*               (2) 'fnct' is called from the asynchronous task, with the number of octets read and the
+*                   error code that USBH_MSC_Rd() would have returned. It may queue another command.
+*
+*               (3) An asynchronous read is issued as a single command; it is not split like USBH_MSC_Rd()
+*                   does (see USBH_SCSI_XferBlkMaxGet() Note #1).
+*
+*               (4) Asynchronous reads and writes bypass the cache (see 'usbh_msc.h  Note #3'). When
+*                   USBH_MSC_CFG_CACHE_EN is DEF_ENABLED, the device is locked while the dirty cached
+*                   blocks of a read are written back and all cached blocks of the range, including the
+*                   blocks read ahead, are invalidated, then the command is queued (see
+*                   USBH_MSC_CacheBypass()). A completion function may then only queue a command while no
+*                   other task reads or writes the device, and if no block of a read is dirty, since the
+*                   asynchronous task would wait for its own completions.
 *********************************************************************************************************
 */
 
-static  void  USBH_MSC_GlobalInit (USBH_ERR  *p_err)
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+USBH_ERR  USBH_MSC_RdAsync (USBH_MSC_DEV             *p_msc_dev,
+                            CPU_INT08U                lun,
+                            CPU_INT64U                blk_addr,
+                            CPU_INT32U                nbr_blks,
+                            CPU_INT32U                blk_size,
+                            void                     *p_arg,
+                            USBH_MSC_XFER_CMPL_FNCT   fnct,
+                            void                     *p_fnct_arg)
 {
+    USBH_ERR  err;
 
-    CPU_INT08U  ix;
-    CPU_SIZE_T  octets_reqd;
-    LIB_ERR     err_lib;
 
-                                                                /* --------------- INIT MSC DEV STRUCT ---------------- */
-    for (ix = 0u; ix < USBH_MSC_CFG_MAX_DEV; ix++) {
-        USBH_MSC_DevClr(&USBH_MSC_DevArr[ix]);
-        USBH_OS_MutexCreate(&USBH_MSC_DevArr[ix].HMutex);
+    if ((p_msc_dev == (USBH_MSC_DEV *)0) ||
+        (fnct      == (USBH_MSC_XFER_CMPL_FNCT)0)) {
+        return (USBH_ERR_INVALID_ARG);
     }
 
-    Mem_PoolCreate (       &USBH_MSC_DevPool,                   /* POOL for managing MSC dev struct.                    */
-                    (void *)USBH_MSC_DevArr,
-                           (sizeof(USBH_MSC_DEV) * USBH_MSC_CFG_MAX_DEV),
-                            USBH_MSC_CFG_MAX_DEV,
-                            sizeof(USBH_MSC_DEV),
-                            sizeof(CPU_ALIGN),
-                           &octets_reqd,
-                           &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
-#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
-        USBH_PRINT_LOG("%d octets required\r\n", octets_reqd);
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+    err = USBH_OS_MutexLock(p_msc_dev->HMutex);                 /* See Note #4.                                         */
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
 #endif
-       *p_err = USBH_ERR_ALLOC;
+
+    if ((p_msc_dev->State != USBH_CLASS_DEV_STATE_CONN) ||      /* See Note #1.                                         */
+        (p_msc_dev->RefCnt == 0u                       )) {
+        err = USBH_ERR_DEV_NOT_READY;
     } else {
-       *p_err = USBH_ERR_NONE;
+        err = USBH_ERR_NONE;
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+        USBH_MSC_CacheBypass( p_msc_dev,
+                              lun,
+                              USBH_MSC_DATA_DIR_IN,
+                              blk_addr,
+                              nbr_blks,
+                              blk_size,
+                             &err);
+#endif
+        if (err == USBH_ERR_NONE) {
+            err = USBH_MSC_SCSI_RdWrAsync(p_msc_dev,
+                                          lun,
+                                          USBH_MSC_DATA_DIR_IN,
+                                          blk_addr,
+                                          nbr_blks,
+                                          blk_size,
+                                          p_arg,
+                                          fnct,
+                                          p_fnct_arg);
+        }
     }
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+    (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+#endif
+
+    return (err);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_MSC_ProbeIF()
+*                                          USBH_MSC_WrAsync()
 *
-* Description : Determine if interface is mass storage class interface.
+* Description : Queue a write of specified number of blocks to device using a WRITE (10) or WRITE (16) SCSI
+*               command. The function returns immediately and the completion is notified to the given
+*               function.
 *
-* Argument(s) : p_dev      Pointer to USB device.
+* Argument(s) : p_msc_dev        Pointer to MSC device.
 *
-*               p_if       Pointer to interface.
+*               lun              Logical unit number.
 *
-*               p_err   Pointer to variable that will receive the return error code from this function :
+*               blk_addr         Block address.
 *
-*                       USBH_ERR_NONE                       MSC successfully initalized.
-*                       USBH_ERR_DEV_ALLOC                  MSC device cannot be allocated.
-*                       USBH_ERR_CLASS_DRV_NOT_FOUND        IF type is not MSC.
+*               nbr_blks         Number of blocks to write.
 *
-*                                                           ----- RETURNED BY USBH_IF_DescGet() : -----
-*                       USBH_ERR_INVALID_ARG,               Invalid argument passed to 'alt_ix'.
+*               blk_size         Block size.
 *
-*                                                           ----- RETURNED BY USBH_MSC_EP_Open -----
-*                       USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
-*                       USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
-*                       USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
-*                       Host controller drivers error,      Otherwise.
+*               p_arg            Pointer to data buffer. The buffer must remain valid until 'fnct' is called.
 *
-* Return(s)   : p_msc_dev,      if device has a mass storage class interface.
-*               0,              otherwise.
+*               fnct             Function notified when the write completes.
 *
-* Note(s)     : None.
+*               p_fnct_arg       Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,                  if the write is successfully queued.
+*               USBH_ERR_INVALID_ARG,           if invalid argument passed to 'p_msc_dev' / 'fnct'.
+*               USBH_ERR_DEV_NOT_READY,         if device enumeration not completed.
+*
+*                                               ----- RETURNED BY USBH_MSC_SCSI_RdWrAsync() : -----
+*               USBH_ERR_INVALID_ARG,           if the write does not fit in one command.
+*               USBH_ERR_ALLOC,                 if USBH_MSC_CFG_CMD_Q_LEN commands are already queued.
+*
+*                                               ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_OS_ABORT,              if mutex wait aborted.
+*               USBH_ERR_OS_FAIL,               Otherwise.
+*
+*                                               ----- RETURNED BY USBH_MSC_CacheBypass() : -----
+*               USBH_ERR_MSC_IO,                if the device accepted fewer blocks than written back.
+*               Other error codes,              see USBH_MSC_SCSI_RdWr().
+*
+* Note(s)     : (1) See USBH_MSC_RdAsync() Notes #1, #2, #3 and #4.
 *********************************************************************************************************
 */
 
-static  void  *USBH_MSC_ProbeIF (USBH_DEV  *p_dev,
-                                 USBH_IF   *p_if,
-                                 USBH_ERR  *p_err)
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+USBH_ERR  USBH_MSC_WrAsync (       USBH_MSC_DEV             *p_msc_dev,
+                                   CPU_INT08U                lun,
+                                   CPU_INT64U                blk_addr,
+                                   CPU_INT32U                nbr_blks,
+                                   CPU_INT32U                blk_size,
+                            const  void                     *p_arg,
+                                   USBH_MSC_XFER_CMPL_FNCT   fnct,
+                                   void                     *p_fnct_arg)
 {
-    USBH_IF_DESC   p_if_desc;
-    USBH_MSC_DEV  *p_msc_dev;
-    LIB_ERR        err_lib;
+    USBH_ERR  err;
 
 
-    p_msc_dev = (USBH_MSC_DEV *)0;
-   *p_err     =  USBH_IF_DescGet(p_if, 0u, &p_if_desc);
-    if (*p_err != USBH_ERR_NONE) {
-        return ((void *)0);
+    if ((p_msc_dev == (USBH_MSC_DEV *)0) ||
+        (fnct      == (USBH_MSC_XFER_CMPL_FNCT)0)) {
+        return (USBH_ERR_INVALID_ARG);
     }
-                                                                /* Chk for class, sub class and protocol.               */
-    if ((p_if_desc.bInterfaceClass     == USBH_CLASS_CODE_MASS_STORAGE)      &&
-        ((p_if_desc.bInterfaceSubClass == USBH_MSC_SUBCLASS_CODE_SCSI)       ||
-         (p_if_desc.bInterfaceSubClass == USBH_MSC_SUBCLASS_CODE_SFF_8070i)) &&
-        (p_if_desc.bInterfaceProtocol  == USBH_MSC_PROTOCOL_CODE_BULK_ONLY)) {
-
-                                                                /* Alloc dev from MSC dev pool.                         */
-        p_msc_dev = (USBH_MSC_DEV *)Mem_PoolBlkGet(&USBH_MSC_DevPool,
-                                                    sizeof(USBH_MSC_DEV),
-                                                   &err_lib);
-        if (err_lib != LIB_MEM_ERR_NONE) {
-           *p_err  = USBH_ERR_DEV_ALLOC;
-            return ((void *)0);
-        }
 
-        USBH_MSC_DevClr(p_msc_dev);
-        p_msc_dev->RefCnt = (CPU_INT08U  )0;
-        p_msc_dev->State  = USBH_CLASS_DEV_STATE_CONN;
-        p_msc_dev->DevPtr = p_dev;
-        p_msc_dev->IF_Ptr = p_if;
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+    err = USBH_OS_MutexLock(p_msc_dev->HMutex);                 /* See Note #4.                                         */
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+#endif
 
-        *p_err = USBH_MSC_EP_Open(p_msc_dev);                   /* Open Bulk in/out EPs.                                */
-        if (*p_err != USBH_ERR_NONE) {
-            Mem_PoolBlkFree(       &USBH_MSC_DevPool,
-                            (void *)p_msc_dev,
-                                   &err_lib);
-        }
+    if ((p_msc_dev->State != USBH_CLASS_DEV_STATE_CONN) ||      /* See Note #1.                                         */
+        (p_msc_dev->RefCnt == 0u                       )) {
+        err = USBH_ERR_DEV_NOT_READY;
     } else {
-       *p_err = USBH_ERR_CLASS_DRV_NOT_FOUND;
+        err = USBH_ERR_NONE;
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+        USBH_MSC_CacheBypass( p_msc_dev,
+                              lun,
+                              USBH_MSC_DATA_DIR_OUT,
+                              blk_addr,
+                              nbr_blks,
+                              blk_size,
+                             &err);
+#endif
+        if (err == USBH_ERR_NONE) {
+            err = USBH_MSC_SCSI_RdWrAsync(        p_msc_dev,
+                                                  lun,
+                                                  USBH_MSC_DATA_DIR_OUT,
+                                                  blk_addr,
+                                                  nbr_blks,
+                                                  blk_size,
+                                          (void *)p_arg,
+                                                  fnct,
+                                                  p_fnct_arg);
+        }
     }
 
-    if (*p_err != USBH_ERR_NONE) {
-        p_msc_dev = (void *)0;
-    }
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+    (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+#endif
 
-    return ((void *)p_msc_dev);
+    return (err);
 }
-
+#endif
 
 /*
 *********************************************************************************************************
-*                                         USBH_MSC_Disconn()
+*                                        USBH_MSC_CacheFlush()
 *
-* Description : Handle disconnection of mass storage device.
+* Description : Write back the dirty cached blocks of specified LUN, then request the device to write its
+*               own cache to the medium with a SYNCHRONIZE CACHE (10) SCSI command.
 *
-* Argument(s) : p_msc_dev       Pointer to MSC device.
+* Argument(s) : p_msc_dev        Pointer to MSC device.
 *
-* Return(s)   : None.
+*               lun              Logical unit number.
 *
-* Note(s)     : None.
+* Return(s)   : USBH_ERR_NONE,                  if the cache is successfully flushed.
+*               USBH_ERR_INVALID_ARG,           if invalid argument passed to 'p_msc_dev'.
+*               USBH_ERR_DEV_NOT_READY,         if device enumeration not completed.
+*
+*                                               ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_OS_ABORT,              if mutex wait aborted.
+*               USBH_ERR_OS_FAIL,               Otherwise.
+*
+*                                               ----- RETURNED BY USBH_MSC_CacheSync() : -----
+*               USBH_ERR_MSC_CMD_FAILED,        Device reports command failed.
+*               USBH_ERR_MSC_CMD_PHASE,         Device reports command phase error.
+*               USBH_ERR_MSC_IO,                Unable to write all blocks.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) A device that does not implement SYNCHRONIZE CACHE (10) is assumed to write data
+*                   through (see USBH_SCSI_CMD_SyncCache() Note #2).
+*
+*               (2) Dirty blocks are also written back when they are evicted from the cache. The
+*                   application should flush the cache before the device is removed.
 *********************************************************************************************************
 */
 
-static  void  USBH_MSC_Disconn (void  *p_class_dev)
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+USBH_ERR  USBH_MSC_CacheFlush (USBH_MSC_DEV  *p_msc_dev,
+                               CPU_INT08U     lun)
 {
-    LIB_ERR        err_lib;
-    USBH_MSC_DEV  *p_msc_dev;
-
+    USBH_ERR  err;
 
-    p_msc_dev = (USBH_MSC_DEV *)p_class_dev;
 
-    (void)USBH_OS_MutexLock(p_msc_dev->HMutex);
+    if (p_msc_dev == (USBH_MSC_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
 
-    p_msc_dev->State = USBH_CLASS_DEV_STATE_DISCONN;
-    USBH_MSC_EP_Close(p_msc_dev);                               /* Close bulk in/out EPs.                               */
+    err = USBH_OS_MutexLock(p_msc_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
 
-    if (p_msc_dev->RefCnt == 0u) {                              /* Release MSC dev.                                     */
-        (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
-        Mem_PoolBlkFree(       &USBH_MSC_DevPool,
-                        (void *)p_msc_dev,
-                               &err_lib);
+    if ((p_msc_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_msc_dev->RefCnt > 0u                       )) {
+        USBH_MSC_CacheSync( p_msc_dev,                          /* Write back all dirty blks of LUN.                    */
+                            lun,
+                            0u,
+                            DEF_INT_64U_MAX_VAL,
+                            DEF_FALSE,
+                           &err);
+        if (err == USBH_ERR_NONE) {
+            err = USBH_SCSI_CMD_SyncCache(p_msc_dev, lun);      /* See Note #1.                                         */
+        }
+    } else {
+        err = USBH_ERR_DEV_NOT_READY;
     }
 
     (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+
+    return (err);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_MSC_Suspend()
+*                                       USBH_MSC_CacheStatGet()
 *
-* Description : Suspend MSC device. Waits for completion of any pending I/O.
+* Description : Get a snapshot of the cache statistics of a device.
 *
 * Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-* Return(s)   : None.
+*               p_stat          Pointer to structure that will receive the statistics.
+*
+* Return(s)   : USBH_ERR_NONE,          If statistics were retrieved.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_msc_dev' / 'p_stat'.
+*
+*                                       ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_OS_ABORT,      If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,       Otherwise.
 *
 * Note(s)     : None.
 *********************************************************************************************************
 */
 
-static  void  USBH_MSC_Suspend (void  *p_class_dev)
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+USBH_ERR  USBH_MSC_CacheStatGet (USBH_MSC_DEV         *p_msc_dev,
+                                 USBH_MSC_CACHE_STAT  *p_stat)
 {
-    USBH_MSC_DEV  *p_msc_dev;
+    USBH_ERR  err;
 
 
-    p_msc_dev = (USBH_MSC_DEV *)p_class_dev;
+    if ((p_msc_dev == (USBH_MSC_DEV        *)0) ||
+        (p_stat    == (USBH_MSC_CACHE_STAT *)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
 
-    (void)USBH_OS_MutexLock(p_msc_dev->HMutex);
+    err = USBH_OS_MutexLock(p_msc_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
 
-    p_msc_dev->State = USBH_CLASS_DEV_STATE_SUSPEND;
+   *p_stat = p_msc_dev->CacheStat;
 
     (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+
+    return (USBH_ERR_NONE);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_MSC_Resume()
+*                                       USBH_MSC_CacheStatClr()
 *
-* Description : Resume MSC device.
+* Description : Clear the cache statistics of a device.
 *
 * Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-* Return(s)   : None.
+* Return(s)   : USBH_ERR_NONE,          If statistics were cleared.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_msc_dev'.
+*
+*                                       ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_OS_ABORT,      If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,       Otherwise.
 *
 * Note(s)     : None.
 *********************************************************************************************************
 */
 
-static  void  USBH_MSC_Resume (void  *p_class_dev)
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+USBH_ERR  USBH_MSC_CacheStatClr (USBH_MSC_DEV  *p_msc_dev)
 {
-    USBH_MSC_DEV  *p_msc_dev;
+    USBH_ERR  err;
 
 
-    p_msc_dev = (USBH_MSC_DEV *)p_class_dev;
+    if (p_msc_dev == (USBH_MSC_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
 
-    (void)USBH_OS_MutexLock(p_msc_dev->HMutex);
+    err = USBH_OS_MutexLock(p_msc_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
 
-    p_msc_dev->State = USBH_CLASS_DEV_STATE_CONN;
+    Mem_Clr((void *)&p_msc_dev->CacheStat,
+                     sizeof(USBH_MSC_CACHE_STAT));
 
     (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+
+    return (USBH_ERR_NONE);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_MSC_DevClr()
+*                                         USBH_MSC_SenseGet()
 *
-* Description : Clear USBH_MSC_DEV structure.
+* Description : Get the last sense data reported by a logical unit.
 *
 * Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-* Return(s)   : None.
+*               lun             Logical unit number.
 *
-* Note(s)     : None.
+*               p_sense         Pointer to structure that will receive the sense data.
+*
+* Return(s)   : USBH_ERR_NONE,          If sense data was retrieved.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_msc_dev' / 'lun' / 'p_sense'.
+*
+* Note(s)     : (1) The sense data is the one received by the last REQUEST SENSE command issued to the
+*                   LUN by the stack, after a command failed. No command is issued to the device. A sense
+*                   key of 0 (NO SENSE) is returned if no sense data was received since the device was
+*                   connected.
+*
+*               (2) Sense data is kept for the first USBH_MSC_CFG_MAX_LUN LUNs of each device.
 *********************************************************************************************************
 */
 
-static  void  USBH_MSC_DevClr (USBH_MSC_DEV  *p_msc_dev)
+USBH_ERR  USBH_MSC_SenseGet (USBH_MSC_DEV    *p_msc_dev,
+                             CPU_INT08U       lun,
+                             USBH_MSC_SENSE  *p_sense)
 {
-    p_msc_dev->DevPtr = (USBH_DEV *)0;
-    p_msc_dev->IF_Ptr = (USBH_IF  *)0;
-    p_msc_dev->State  =  USBH_CLASS_DEV_STATE_NONE;
-    p_msc_dev->RefCnt =  0u;
+    CPU_SR_ALLOC();
+
+
+    if ((p_msc_dev == (USBH_MSC_DEV   *)0) ||
+        (p_sense   == (USBH_MSC_SENSE *)0) ||
+        (lun       >=  USBH_MSC_CFG_MAX_LUN)) {                 /* See Note #2.                                         */
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    CPU_CRITICAL_ENTER();
+   *p_sense = p_msc_dev->SenseTbl[lun];
+    CPU_CRITICAL_EXIT();
+
+    return (USBH_ERR_NONE);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_MSC_EP_Open()
+*                                     USBH_MSC_RecoveryStatGet()
 *
-* Description : Open bulk IN & OUT endpoints.
+* Description : Get a snapshot of the error recovery statistics of a device.
 *
 * Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-* Return(s)   : USBH_ERR_NONE,                      if endpoints successfully opened.
+*               p_stat          Pointer to structure that will receive the statistics.
 *
-*                                                   ---- RETURNED BY USBH_BulkInOpen ----
-*               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
-*               USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
-*               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
-*               Host controller drivers error,      Otherwise.
+* Return(s)   : USBH_ERR_NONE,          If statistics were retrieved.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_msc_dev' / 'p_stat'.
 *
-*                                                   ---- RETURNED BY USBH_BulkOutOpen ----
-*               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
-*               USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
-*               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
-*               Host controller drivers error,      Otherwise.
+*                                       ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_OS_ABORT,      If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,       Otherwise.
 *
-* Note(s)     : None.
+* Note(s)     : (1) See 'usbh_msc.h  DEFAULT CONFIGURATION  Note #5' for the recovery levels.
+*
+*               (2) The statistics are updated within a critical section, since some of them are updated
+*                   while the device is unlocked for a transfer.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_MSC_EP_Open (USBH_MSC_DEV  *p_msc_dev)
+USBH_ERR  USBH_MSC_RecoveryStatGet (USBH_MSC_DEV            *p_msc_dev,
+                                    USBH_MSC_RECOVERY_STAT  *p_stat)
 {
     USBH_ERR  err;
+    CPU_SR_ALLOC();
 
 
-    err = USBH_BulkInOpen(p_msc_dev->DevPtr,
-                          p_msc_dev->IF_Ptr,
-                         &p_msc_dev->BulkInEP);
-    if (err != USBH_ERR_NONE) {
-        return (err);
+    if ((p_msc_dev == (USBH_MSC_DEV           *)0) ||
+        (p_stat    == (USBH_MSC_RECOVERY_STAT *)0)) {
+        return (USBH_ERR_INVALID_ARG);
     }
 
-    err = USBH_BulkOutOpen(p_msc_dev->DevPtr,
-                           p_msc_dev->IF_Ptr,
-                          &p_msc_dev->BulkOutEP);
+    err = USBH_OS_MutexLock(p_msc_dev->HMutex);
     if (err != USBH_ERR_NONE) {
-        USBH_MSC_EP_Close(p_msc_dev);
+        return (err);
     }
 
-    return (err);
+    CPU_CRITICAL_ENTER();                                       /* See Note #2.                                         */
+   *p_stat = p_msc_dev->RecoveryStat;
+    CPU_CRITICAL_EXIT();
+
+    (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+
+    return (USBH_ERR_NONE);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_MSC_EP_Close()
+*                                     USBH_MSC_RecoveryStatClr()
 *
-* Description : Close bulk IN & OUT endpoints.
+* Description : Clear the error recovery statistics of a device.
 *
 * Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-* Return(s)   : None.
+* Return(s)   : USBH_ERR_NONE,          If statistics were cleared.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_msc_dev'.
+*
+*                                       ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_OS_ABORT,      If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,       Otherwise.
 *
 * Note(s)     : None.
 *********************************************************************************************************
 */
 
-static  void  USBH_MSC_EP_Close (USBH_MSC_DEV  *p_msc_dev)
+USBH_ERR  USBH_MSC_RecoveryStatClr (USBH_MSC_DEV  *p_msc_dev)
 {
-    USBH_EP_Close(&p_msc_dev->BulkInEP);
-    USBH_EP_Close(&p_msc_dev->BulkOutEP);
+    USBH_ERR  err;
+    CPU_SR_ALLOC();
+
+
+    if (p_msc_dev == (USBH_MSC_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err = USBH_OS_MutexLock(p_msc_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    CPU_CRITICAL_ENTER();                                       /* See 'USBH_MSC_RecoveryStatGet() Note #2'.            */
+    Mem_Clr((void *)&p_msc_dev->RecoveryStat,
+                     sizeof(USBH_MSC_RECOVERY_STAT));
+    CPU_CRITICAL_EXIT();
+
+    (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+
+    return (USBH_ERR_NONE);
 }
 
 
 /*
 *********************************************************************************************************
-*                                         USBH_MSC_XferCmd()
+*                                       USBH_SCSI_BlkLimitsRd()
 *
-* Description : Executes MSC command cycle. Sends command (CBW), followed by data stage (if present),
-*               and then receive status (CSW).
+* Description : Read maximum number of blocks per read or write command from the Block Limits VPD page.
 *
-* Argument(s) : p_msc_dev       Pointer to MSC device.
+* Argument(s) : p_lun           Pointer to properties of the LUN.
 *
-*               lun             Logical Unit Number.
+*               xfer_fnct       Function that issues a command on the transport of the device.
 *
-*               dir             Direction of data transfer, if present.
+*               p_dev           Pointer to device, passed to 'xfer_fnct'.
 *
-*               p_cb            Pointer to command block.
+*               lun             Logical unit number.
 *
-*               cb_len          Command block length, in octets.
+* Return(s)   : None.
 *
-*               p_arg           Pointer to data buffer, if data stage present.
+* Note(s)     : (1) The page is requested once per LUN, on its first successful capacity read. It is
+*                   requested again only when the LUN properties are cleared with the device.
 *
-*               data_len        Length of data buffer in octets, if data stage present.
+*               (2) VPD pages are only requested from devices claiming compliance with SPC-3 or later, and
+*                   the Block Limits page only if it is listed in the Supported VPD Pages page. Some
+*                   older devices fail to recover from an INQUIRY of an unsupported page.
 *
-*               p_err   Pointer to variable that will receive the return error code from this function :
-*                           USBH_ERR_NONE                           Command successfully transmitted.
-*                           USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
-*                           USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
-*                           USBH_ERR_MSC_IO                         Unable to receive CSW.
+*               (3) The Block Limits VPD page is documented in 'SCSI Block Commands - 3 (SBC-3)', Section
+*                   6.5.3. MAXIMUM TRANSFER LENGTH is 0 if the device reports no limit.
 *
-*                                                                   ----- RETURNED BY USBH_MSC_RxCSW() : -----
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
-*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           Host controller drivers error code,     Otherwise.
+*               (4) On any failure, the number of blocks per command is only limited by the command
+*                   format (see USBH_SCSI_XferBlkMaxGet()).
 *
-*                                                                   ----- RETURNED BY USBH_MSC_RxData() : -----
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
-*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           Host controller drivers error code,     Otherwise.
+*               (5) The caller must hold the lock of the device.
+*********************************************************************************************************
+*/
+
+void  USBH_SCSI_BlkLimitsRd (USBH_SCSI_LUN        *p_lun,
+                             USBH_SCSI_XFER_FNCT   xfer_fnct,
+                             void                 *p_dev,
+                             CPU_INT08U            lun)
+{
+    CPU_INT08U   data[USBH_SCSI_VPD_LEN_MAX];
+    CPU_INT32U   xfer_len;
+    CPU_INT32U   ix;
+    CPU_BOOLEAN  found;
+    USBH_ERR     err;
+
+
+    if (p_lun->BlkLimitsRd == DEF_TRUE) {                       /* See Note #1.                                         */
+        return;
+    }
+    p_lun->BlkLimitsRd = DEF_TRUE;
+    p_lun->XferBlkMax  = 0u;                                    /* See Note #4.                                         */
+
+    xfer_len = USBH_SCSI_CMD_Inquiry(xfer_fnct,                 /* See Note #2.                                         */
+                                     p_dev,
+                                     lun,
+                                     DEF_FALSE,
+                                     0u,
+                                     data,
+                                     36u,
+                                    &err);
+    if ((err      != USBH_ERR_NONE) ||
+        (xfer_len <  3u)            ||
+        (data[2]  <  USBH_SCSI_VER_SPC_3)) {
+        return;
+    }
+
+    xfer_len = USBH_SCSI_CMD_Inquiry(xfer_fnct,                 /* ---------------- SUPPORTED VPD PAGES --------------- */
+                                     p_dev,
+                                     lun,
+                                     DEF_TRUE,
+                                     USBH_SCSI_VPD_PAGE_SUPPORTED,
+                                     data,
+                                     USBH_SCSI_VPD_LEN_MAX,
+                                    &err);
+    if ((err      != USBH_ERR_NONE) ||
+        (xfer_len <  4u)) {
+        return;
+    }
+
+    xfer_len = DEF_MIN(xfer_len, 4u + data[3]);
+    found    = DEF_FALSE;
+    for (ix = 4u; ix < xfer_len; ix++) {
+        if (data[ix] == USBH_SCSI_VPD_PAGE_BLK_LIMITS) {
+            found = DEF_TRUE;
+            break;
+        }
+    }
+    if (found == DEF_FALSE) {
+        return;
+    }
+
+    xfer_len = USBH_SCSI_CMD_Inquiry(xfer_fnct,                 /* ----------------- BLOCK LIMITS PAGE ---------------- */
+                                     p_dev,
+                                     lun,
+                                     DEF_TRUE,
+                                     USBH_SCSI_VPD_PAGE_BLK_LIMITS,
+                                     data,
+                                     USBH_SCSI_VPD_LEN_MAX,
+                                    &err);
+    if ((err      != USBH_ERR_NONE) ||
+        (xfer_len <  12u)           ||
+        (data[1]  != USBH_SCSI_VPD_PAGE_BLK_LIMITS)) {
+        return;
+    }
+                                                                /* See Note #3.                                         */
+    MEM_VAL_COPY_GET_INT32U_BIG(&p_lun->XferBlkMax, &data[8]);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SCSI_XferBlkMaxGet()
 *
-*                                                                   ----- RETURNED BY USBH_MSC_TxCBW() : -----
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
-*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           Host controller drivers error code,     Otherwise.
+* Description : Get maximum number of blocks that a single read or write command may transfer.
 *
-*                                                                   ----- RETURNED BY USBH_MSC_TxData() : -----
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
-*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           Host controller drivers error code,     Otherwise.
+* Argument(s) : p_lun           Pointer to properties of the LUN, or null pointer if the transport keeps no
+*                               properties for the LUN.
 *
-* Return(s)   : Number of octets transferred.
+*               blk_size        Block size.
 *
-* Note(s)     : None.
+* Return(s)   : Maximum number of blocks per command.
+*
+* Note(s)     : (1) The number of blocks is limited by :
+*
+*                   (a) The transfer length field of the command : 16 bits for READ (10) / WRITE (10), 32
+*                       bits for READ (16) / WRITE (16).
+*
+*                   (b) The MAXIMUM TRANSFER LENGTH of the Block Limits VPD page of the LUN, if reported.
+*
+*                   (c) The 32-bit data length of a command (see USBH_SCSI_XFER_FNCT).
+*
+*                   The host controller imposes no limit: the data of a command is split in pieces of at
+*                   most 'DataBufMaxLen' octets by the transport.
+*
+*               (2) A LUN without properties is accessed with READ (10) / WRITE (10) commands whenever
+*                   addresses fit (see 'usbh_msc.h  Note #1h').
 *********************************************************************************************************
 */
 
-static  CPU_INT32U  USBH_MSC_XferCmd (USBH_MSC_DEV       *p_msc_dev,
-                                      CPU_INT08U          lun,
+CPU_INT32U  USBH_SCSI_XferBlkMaxGet (const  USBH_SCSI_LUN  *p_lun,
+                                     CPU_INT32U             blk_size)
+{
+    CPU_INT32U  blk_max;
+
+
+    if (p_lun == (const USBH_SCSI_LUN *)0) {                    /* See Note #2.                                         */
+        blk_max = USBH_SCSI_BLK_NBR_MAX_10;
+    } else {
+                                                                /* See Note #1a.                                        */
+        blk_max = (p_lun->Cmd16En == DEF_TRUE) ? DEF_INT_32U_MAX_VAL : USBH_SCSI_BLK_NBR_MAX_10;
+
+        if ((p_lun->XferBlkMax != 0u) &&                        /* See Note #1b.                                        */
+            (p_lun->XferBlkMax <  blk_max)) {
+            blk_max = p_lun->XferBlkMax;
+        }
+    }
+
+    if (blk_size > 1u) {                                        /* See Note #1c.                                        */
+        blk_max = DEF_MIN(blk_max, DEF_INT_32U_MAX_VAL / blk_size);
+    }
+
+    return (blk_max);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SCSI_RdWrFmt()
+*
+* Description : Format the command block of a read or write command.
+*
+* Argument(s) : p_lun           Pointer to properties of the LUN, or null pointer if the transport keeps no
+*                               properties for the LUN.
+*
+*               dir             USBH_MSC_DATA_DIR_IN to read, USBH_MSC_DATA_DIR_OUT to write.
+*
+*               blk_addr        Block address.
+*
+*               nbr_blks        Number of blocks to transfer.
+*
+*               p_cmd           Pointer to buffer that receives the command block (16 octets).
+*
+* Return(s)   : Length of command block, in octets.
+*
+* Note(s)     : (1) READ (16) / WRITE (16) are used for LUNs whose capacity was read with READ CAPACITY
+*                   (16), and whenever the address or the number of blocks does not fit a READ (10) /
+*                   WRITE (10) command. Devices of 2^32 blocks or less may not support the 16-octet
+*                   commands.
+*
+*               (2) The SCSI "READ (10)", "WRITE (10)", "READ (16)" and "WRITE (16)" commands are
+*                   documented in 'SCSI Block Commands - 3 (SBC-3)', Sections 5.11, 5.33, 5.13 and 5.35.
+*********************************************************************************************************
+*/
+
+CPU_INT08U  USBH_SCSI_RdWrFmt (const  USBH_SCSI_LUN      *p_lun,
                                       USBH_MSC_DATA_DIR   dir,
-                                      void               *p_cb,
-                                      CPU_INT08U          cb_len,
-                                      void               *p_arg,
-                                      CPU_INT32U          data_len,
-                                      USBH_ERR           *p_err)
+                                      CPU_INT64U          blk_addr,
+                                      CPU_INT32U          nbr_blks,
+                                      CPU_INT08U         *p_cmd)
 {
-    CPU_INT32U     xfer_len;
-    USBH_MSC_CBW   msc_cbw;
-    USBH_MSC_CSW   msc_csw;
+    CPU_BOOLEAN  cmd_16_en;
+    CPU_INT32U   lba_msb;
+    CPU_INT32U   lba_lsb;
+    CPU_INT16U   nbr_blks_10;
+
+
+    cmd_16_en = (p_lun != (const USBH_SCSI_LUN *)0) ? p_lun->Cmd16En : DEF_FALSE;
+                                                                /* See Note #2.                                         */
+    lba_lsb   = (CPU_INT32U)blk_addr;
+    if ((cmd_16_en           == DEF_TRUE)                 ||    /* See Note #1.                                         */
+        (nbr_blks            >  USBH_SCSI_BLK_NBR_MAX_10) ||
+        ((blk_addr + nbr_blks) > ((CPU_INT64U)USBH_SCSI_LBA_MAX_10 + 1u))) {
+        lba_msb   = (CPU_INT32U)(blk_addr >> 32u);
+                                                                /* ------------ READ (16) / WRITE (16) CMD ------------ */
+        p_cmd[0]  = (dir == USBH_MSC_DATA_DIR_IN) ? USBH_SCSI_CMD_READ_16 : USBH_SCSI_CMD_WRITE_16;
+        p_cmd[1]  = 0u;                                         /* Flags.                                               */
+        MEM_VAL_COPY_SET_INT32U_BIG(&p_cmd[2],  &lba_msb);      /* Logical Block Address (LBA).                         */
+        MEM_VAL_COPY_SET_INT32U_BIG(&p_cmd[6],  &lba_lsb);
+        MEM_VAL_COPY_SET_INT32U_BIG(&p_cmd[10], &nbr_blks);     /* Transfer length (number of logical blocks).          */
+        p_cmd[14] = 0u;                                         /* Group number.                                        */
+        p_cmd[15] = 0u;                                         /* Control.                                             */
+
+        return (16u);
+    }
 
-                                                                /* Prepare CBW.                                         */
-    msc_cbw.dCBWSignature          =  USBH_MSC_SIG_CBW;
-    msc_cbw.dCBWTag                =  0u;
-    msc_cbw.dCBWDataTransferLength =  data_len;
-    msc_cbw.bmCBWFlags             = (dir == USBH_MSC_DATA_DIR_NONE) ? 0u : dir;
-    msc_cbw.bCBWLUN                =  lun;
-    msc_cbw.bCBWCBLength           =  cb_len;
+    nbr_blks_10 = (CPU_INT16U)nbr_blks;
+                                                                /* ------------ READ (10) / WRITE (10) CMD ------------ */
+    p_cmd[0] = (dir == USBH_MSC_DATA_DIR_IN) ? USBH_SCSI_CMD_READ_10 : USBH_SCSI_CMD_WRITE_10;
+    p_cmd[1] = 0u;                                              /* Reserved.                                            */
+    MEM_VAL_COPY_SET_INT32U_BIG(&p_cmd[2], &lba_lsb);           /* Logical Block Address (LBA).                         */
+    p_cmd[6] = 0u;                                              /* Reserved.                                            */
+    MEM_VAL_COPY_SET_INT16U_BIG(&p_cmd[7], &nbr_blks_10);       /* Transfer length (number of logical blocks).          */
+    p_cmd[9] = 0u;                                              /* Control.                                             */
 
-    Mem_Copy((void *)msc_cbw.CBWCB,
-                     p_cb,
-                     cb_len);
+    return (10u);
+}
 
-   *p_err = USBH_MSC_TxCBW(p_msc_dev, &msc_cbw);                /* Send CBW to dev.                                     */
-    if (*p_err != USBH_ERR_NONE) {
+
+/*
+*********************************************************************************************************
+*                                          USBH_SCSI_RdWr()
+*
+* Description : Read or write specified number of blocks, using as few commands as the device accepts.
+*
+* Argument(s) : p_lun            Pointer to properties of the LUN, or null pointer if the transport keeps no
+*                                properties for the LUN.
+*
+*               xfer_fnct        Function that issues a command on the transport of the device.
+*
+*               p_dev            Pointer to device, passed to 'xfer_fnct'.
+*
+*               lun              Logical unit number.
+*
+*               dir              USBH_MSC_DATA_DIR_IN to read, USBH_MSC_DATA_DIR_OUT to write.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to transfer.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*                       USBH_ERR_NONE                           Data successfully transferred.
+*                       USBH_ERR_INVALID_ARG                    Transfer exceeds 2^32 - 1 octets.
+*                       Other error codes,                      returned by 'xfer_fnct'.
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : (1) The transfer is split in commands of at most USBH_SCSI_XferBlkMaxGet() blocks, issued
+*                   one after the other. The transfer stops at the first failed or short command.
+*
+*               (2) As with a single command, 0 is returned if a command fails.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_SCSI_RdWr (const  USBH_SCSI_LUN        *p_lun,
+                                   USBH_SCSI_XFER_FNCT   xfer_fnct,
+                                   void                 *p_dev,
+                                   CPU_INT08U            lun,
+                                   USBH_MSC_DATA_DIR     dir,
+                                   CPU_INT64U            blk_addr,
+                                   CPU_INT32U            nbr_blks,
+                                   CPU_INT32U            blk_size,
+                                   void                 *p_arg,
+                                   USBH_ERR             *p_err)
+{
+    CPU_INT08U   cmd[16];
+    CPU_INT08U   cmd_len;
+    CPU_INT08U  *p_buf;
+    CPU_INT32U   blk_max;
+    CPU_INT32U   cmd_blks;
+    CPU_INT32U   data_len;
+    CPU_INT32U   len;
+    CPU_INT32U   xfer_len;
+
+
+    if (((CPU_INT64U)nbr_blks * blk_size) > DEF_INT_32U_MAX_VAL) {
+       *p_err = USBH_ERR_INVALID_ARG;
         return (0u);
     }
 
-    switch (dir) {
-        case USBH_MSC_DATA_DIR_OUT:
-            *p_err = USBH_MSC_TxData(p_msc_dev,
-                                     p_arg,
-                                     data_len);                 /* Send data to dev.                                    */
-             break;
+    blk_max  =  USBH_SCSI_XferBlkMaxGet(p_lun, blk_size);
+    p_buf    = (CPU_INT08U *)p_arg;
+    xfer_len =  0u;
+   *p_err    =  USBH_ERR_NONE;
+
+    while (nbr_blks > 0u) {                                     /* See Note #1.                                         */
+        cmd_blks = DEF_MIN(nbr_blks, blk_max);
+        data_len = cmd_blks * blk_size;
+        cmd_len  = USBH_SCSI_RdWrFmt(p_lun,
+                                     dir,
+                                     blk_addr,
+                                     cmd_blks,
+                                     cmd);
+
+        len = xfer_fnct(        p_dev,                          /* ------------------ SEND SCSI CMD ------------------- */
+                                lun,
+                                dir,
+                        (void *)cmd,
+                                cmd_len,
+                        (void *)p_buf,
+                                data_len,
+                                p_err);
+        if (*p_err != USBH_ERR_NONE) {                          /* See Note #2.                                         */
+            xfer_len = 0u;
+            break;
+        }
 
-        case USBH_MSC_DATA_DIR_IN:
-            *p_err = USBH_MSC_RxData(p_msc_dev,
-                                     p_arg,
-                                     data_len);                 /* Receive data from dev.                               */
-             break;
+        xfer_len += len;
+        if (len != data_len) {
+            break;
+        }
+
+        blk_addr += cmd_blks;
+        nbr_blks -= cmd_blks;
+        p_buf    += data_len;
+    }
+
+    return (xfer_len);
+}
+
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_GlobalInit()
+*
+* Description : Initialize MSC.
+*
+* Argument(s) : p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                           USBH_ERR_NONE       MSC successfully initalized.
+*                           USBH_ERR_ALLOC      If MSC device cannot be allocated.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_MSC_GlobalInit (USBH_ERR  *p_err)
+{
+
+    CPU_INT08U  ix;
+    CPU_SIZE_T  octets_reqd;
+    LIB_ERR     err_lib;
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+    CPU_INT08U  cmd_ix;
+#endif
+
+                                                                /* --------------- INIT MSC DEV STRUCT ---------------- */
+    for (ix = 0u; ix < USBH_MSC_CFG_MAX_DEV; ix++) {
+        USBH_MSC_DevClr(&USBH_MSC_DevArr[ix]);
+        USBH_OS_MutexCreate(&USBH_MSC_DevArr[ix].HMutex);
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+        (void)USBH_OS_SemCreate(&USBH_MSC_DevArr[ix].CmdFreeSem, 0u);
+        for (cmd_ix = 0u; cmd_ix < USBH_MSC_CFG_CMD_Q_LEN; cmd_ix++) {
+            (void)USBH_OS_SemCreate(&USBH_MSC_DevArr[ix].CmdTbl[cmd_ix].Sem, 0u);
+        }
+#endif
+    }
+
+    Mem_PoolCreate (       &USBH_MSC_DevPool,                   /* POOL for managing MSC dev struct.                    */
+                    (void *)USBH_MSC_DevArr,
+                           (sizeof(USBH_MSC_DEV) * USBH_MSC_CFG_MAX_DEV),
+                            USBH_MSC_CFG_MAX_DEV,
+                            sizeof(USBH_MSC_DEV),
+                            sizeof(CPU_ALIGN),
+                           &octets_reqd,
+                           &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
+        USBH_PRINT_LOG("%d octets required\r\n", octets_reqd);
+#endif
+       *p_err = USBH_ERR_ALLOC;
+    } else {
+       *p_err = USBH_ERR_NONE;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_ProbeIF()
+*
+* Description : Determine if interface is mass storage class interface.
+*
+* Argument(s) : p_dev      Pointer to USB device.
+*
+*               p_if       Pointer to interface.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                       USBH_ERR_NONE                       MSC successfully initalized.
+*                       USBH_ERR_DEV_ALLOC                  MSC device cannot be allocated.
+*                       USBH_ERR_CLASS_DRV_NOT_FOUND        IF type is not MSC.
+*
+*                                                           ----- RETURNED BY USBH_IF_DescGet() : -----
+*                       USBH_ERR_INVALID_ARG,               Invalid argument passed to 'alt_ix'.
+*
+*                                                           ----- RETURNED BY USBH_MSC_EP_Open -----
+*                       USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*                       USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
+*                       USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*                       Host controller drivers error,      Otherwise.
+*
+* Return(s)   : p_msc_dev,      if device has a mass storage class interface.
+*               0,              otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  *USBH_MSC_ProbeIF (USBH_DEV  *p_dev,
+                                 USBH_IF   *p_if,
+                                 USBH_ERR  *p_err)
+{
+    USBH_IF_DESC   p_if_desc;
+    USBH_MSC_DEV  *p_msc_dev;
+    LIB_ERR        err_lib;
+
+
+    p_msc_dev = (USBH_MSC_DEV *)0;
+   *p_err     =  USBH_IF_DescGet(p_if, 0u, &p_if_desc);
+    if (*p_err != USBH_ERR_NONE) {
+        return ((void *)0);
+    }
+                                                                /* Chk for class, sub class and protocol.               */
+    if ((p_if_desc.bInterfaceClass     == USBH_CLASS_CODE_MASS_STORAGE)      &&
+        ((p_if_desc.bInterfaceSubClass == USBH_MSC_SUBCLASS_CODE_SCSI)       ||
+         (p_if_desc.bInterfaceSubClass == USBH_MSC_SUBCLASS_CODE_SFF_8070i)) &&
+        (p_if_desc.bInterfaceProtocol  == USBH_MSC_PROTOCOL_CODE_BULK_ONLY)) {
+
+                                                                /* Alloc dev from MSC dev pool.                         */
+        p_msc_dev = (USBH_MSC_DEV *)Mem_PoolBlkGet(&USBH_MSC_DevPool,
+                                                    sizeof(USBH_MSC_DEV),
+                                                   &err_lib);
+        if (err_lib != LIB_MEM_ERR_NONE) {
+           *p_err  = USBH_ERR_DEV_ALLOC;
+            return ((void *)0);
+        }
+
+        USBH_MSC_DevClr(p_msc_dev);
+        p_msc_dev->RefCnt = (CPU_INT08U  )0;
+        p_msc_dev->State  = USBH_CLASS_DEV_STATE_CONN;
+        p_msc_dev->DevPtr = p_dev;
+        p_msc_dev->IF_Ptr = p_if;
+
+        *p_err = USBH_MSC_EP_Open(p_msc_dev);                   /* Open Bulk in/out EPs.                                */
+        if (*p_err != USBH_ERR_NONE) {
+            Mem_PoolBlkFree(       &USBH_MSC_DevPool,
+                            (void *)p_msc_dev,
+                                   &err_lib);
+        }
+    } else {
+       *p_err = USBH_ERR_CLASS_DRV_NOT_FOUND;
+    }
+
+    if (*p_err != USBH_ERR_NONE) {
+        p_msc_dev = (void *)0;
+    }
+
+    return ((void *)p_msc_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_Disconn()
+*
+* Description : Handle disconnection of mass storage device.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_MSC_Disconn (void  *p_class_dev)
+{
+    LIB_ERR        err_lib;
+    USBH_MSC_DEV  *p_msc_dev;
+
+
+    p_msc_dev = (USBH_MSC_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_msc_dev->HMutex);
+
+    p_msc_dev->State = USBH_CLASS_DEV_STATE_DISCONN;
+    USBH_MSC_EP_Close(p_msc_dev);                               /* Close bulk in/out EPs.                               */
+
+    if (p_msc_dev->RefCnt == 0u) {                              /* Release MSC dev.                                     */
+        (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+        Mem_PoolBlkFree(       &USBH_MSC_DevPool,
+                        (void *)p_msc_dev,
+                               &err_lib);
+    }
+
+    (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_Suspend()
+*
+* Description : Suspend MSC device. Waits for completion of any pending I/O.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_MSC_Suspend (void  *p_class_dev)
+{
+    USBH_MSC_DEV  *p_msc_dev;
+
+
+    p_msc_dev = (USBH_MSC_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_msc_dev->HMutex);
+
+    p_msc_dev->State = USBH_CLASS_DEV_STATE_SUSPEND;
+
+    (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_Resume()
+*
+* Description : Resume MSC device.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_MSC_Resume (void  *p_class_dev)
+{
+    USBH_MSC_DEV  *p_msc_dev;
+
+
+    p_msc_dev = (USBH_MSC_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_msc_dev->HMutex);
+
+    p_msc_dev->State = USBH_CLASS_DEV_STATE_CONN;
+
+    (void)USBH_OS_MutexUnlock(p_msc_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_DevClr()
+*
+* Description : Clear USBH_MSC_DEV structure.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_MSC_DevClr (USBH_MSC_DEV  *p_msc_dev)
+{
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+    CPU_INT08U  cmd_ix;
+
+
+#endif
+    p_msc_dev->DevPtr = (USBH_DEV *)0;
+    p_msc_dev->IF_Ptr = (USBH_IF  *)0;
+    p_msc_dev->State  =  USBH_CLASS_DEV_STATE_NONE;
+    p_msc_dev->RefCnt =  0u;
+
+    Mem_Clr((void *)p_msc_dev->LUN_Tbl,
+                    sizeof(p_msc_dev->LUN_Tbl));
+    Mem_Clr((void *)p_msc_dev->SenseTbl,
+                    sizeof(p_msc_dev->SenseTbl));
+    Mem_Clr((void *)&p_msc_dev->RecoveryStat,
+                     sizeof(USBH_MSC_RECOVERY_STAT));
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)                       /* Build free cmd list.                                 */
+    p_msc_dev->CmdFreePtr = (USBH_MSC_CMD *)0;
+    for (cmd_ix = USBH_MSC_CFG_CMD_Q_LEN; cmd_ix > 0u; cmd_ix--) {
+        p_msc_dev->CmdTbl[cmd_ix - 1u].MSC_DevPtr =  p_msc_dev;
+        p_msc_dev->CmdTbl[cmd_ix - 1u].NxtPtr     =  p_msc_dev->CmdFreePtr;
+        p_msc_dev->CmdFreePtr                     = &p_msc_dev->CmdTbl[cmd_ix - 1u];
+    }
+    p_msc_dev->CmdRsvPtr  = (USBH_MSC_CMD *)0;
+    p_msc_dev->CmdHeadPtr = (USBH_MSC_CMD *)0;
+    p_msc_dev->CmdTailPtr = (USBH_MSC_CMD *)0;
+    p_msc_dev->CmdWaitCnt =  0u;
+    p_msc_dev->CmdLUN     =  0u;
+    p_msc_dev->CmdRdCnt   =  0u;
+#endif
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+    USBH_MSC_CacheClr(p_msc_dev);
+    Mem_Clr((void *)&p_msc_dev->CacheStat,
+                     sizeof(USBH_MSC_CACHE_STAT));
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_EP_Open()
+*
+* Description : Open bulk IN & OUT endpoints.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : USBH_ERR_NONE,                      if endpoints successfully opened.
+*
+*                                                   ---- RETURNED BY USBH_BulkInOpen ----
+*               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*               USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
+*               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*               Host controller drivers error,      Otherwise.
+*
+*                                                   ---- RETURNED BY USBH_BulkOutOpen ----
+*               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*               USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
+*               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*               Host controller drivers error,      Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_MSC_EP_Open (USBH_MSC_DEV  *p_msc_dev)
+{
+    USBH_ERR  err;
+
+
+    err = USBH_BulkInOpen(p_msc_dev->DevPtr,
+                          p_msc_dev->IF_Ptr,
+                         &p_msc_dev->BulkInEP);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_BulkOutOpen(p_msc_dev->DevPtr,
+                           p_msc_dev->IF_Ptr,
+                          &p_msc_dev->BulkOutEP);
+    if (err != USBH_ERR_NONE) {
+        USBH_MSC_EP_Close(p_msc_dev);
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_EP_Close()
+*
+* Description : Close bulk IN & OUT endpoints.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_MSC_EP_Close (USBH_MSC_DEV  *p_msc_dev)
+{
+    USBH_EP_Close(&p_msc_dev->BulkInEP);
+    USBH_EP_Close(&p_msc_dev->BulkOutEP);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_XferCmd()
+*
+* Description : Executes MSC command cycle. Sends command (CBW), followed by data stage (if present),
+*               and then receive status (CSW).
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical Unit Number.
+*
+*               dir             Direction of data transfer, if present.
+*
+*               p_cb            Pointer to command block.
+*
+*               cb_len          Command block length, in octets.
+*
+*               p_arg           Pointer to data buffer, if data stage present.
+*
+*               data_len        Length of data buffer in octets, if data stage present.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*                           USBH_ERR_NONE                           Command successfully transmitted.
+*                           USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*                           USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
+*                           USBH_ERR_MSC_IO                         Unable to receive CSW.
+*
+*                                                                   ----- RETURNED BY USBH_MSC_RxCSW() : -----
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           Host controller drivers error code,     Otherwise.
+*
+*                                                                   ----- RETURNED BY USBH_MSC_RxData() : -----
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           Host controller drivers error code,     Otherwise.
+*
+*                                                                   ----- RETURNED BY USBH_MSC_TxCBW() : -----
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           Host controller drivers error code,     Otherwise.
+*
+*                                                                   ----- RETURNED BY USBH_MSC_TxData() : -----
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : (1) When USBH_MSC_CFG_PIPE_EN is DEF_ENABLED, the command is queued on the device and its
+*                   stages are executed by the pipelined engine (see USBH_MSC_PipeXfer()). If the command
+*                   did not complete cleanly, the engine stays halted until the command is released, so
+*                   that the recovery of the device is not interleaved with the next command.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_MSC_XferCmd (USBH_MSC_DEV       *p_msc_dev,
+                                      CPU_INT08U          lun,
+                                      USBH_MSC_DATA_DIR   dir,
+                                      void               *p_cb,
+                                      CPU_INT08U          cb_len,
+                                      void               *p_arg,
+                                      CPU_INT32U          data_len,
+                                      USBH_ERR           *p_err)
+{
+    CPU_INT32U     xfer_len;
+    USBH_MSC_CBW   msc_cbw;
+    USBH_MSC_CSW   msc_csw;
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+    USBH_MSC_CMD  *p_cmd;
+    USBH_ERR       err_csw;
+
+
+    p_cmd = USBH_MSC_PipeCmdGet(p_msc_dev, DEF_TRUE, p_err);    /* Get cmd from dev Q.                                  */
+    if (p_cmd == (USBH_MSC_CMD *)0) {
+        return (0u);
+    }
+#endif
+                                                                /* Prepare CBW.                                         */
+    msc_cbw.dCBWSignature          =  USBH_MSC_SIG_CBW;
+    msc_cbw.dCBWTag                =  0u;
+    msc_cbw.dCBWDataTransferLength =  data_len;
+    msc_cbw.bmCBWFlags             = (dir == USBH_MSC_DATA_DIR_NONE) ? 0u : dir;
+    msc_cbw.bCBWLUN                =  lun;
+    msc_cbw.bCBWCBLength           =  cb_len;
+
+    Mem_Copy((void *)msc_cbw.CBWCB,
+                     p_cb,
+                     cb_len);
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+   *p_err = USBH_MSC_PipeXfer(p_msc_dev,                        /* Xfer CBW, data and CSW stages.                       */
+                              p_cmd,
+                             &msc_cbw,
+                              dir,
+                              p_arg,
+                             &msc_csw,
+                             &err_csw);
+    if (*p_err != USBH_ERR_NONE) {
+        USBH_MSC_PipeCmdRel(p_msc_dev, p_cmd);
+        return (0u);
+    }
+
+   *p_err = err_csw;
+#else
+   *p_err = USBH_MSC_TxCBW(p_msc_dev, &msc_cbw);                /* Send CBW to dev.                                     */
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
+    }
+
+    switch (dir) {
+        case USBH_MSC_DATA_DIR_OUT:
+            *p_err = USBH_MSC_TxData(p_msc_dev,
+                                     p_arg,
+                                     data_len);                 /* Send data to dev.                                    */
+             break;
+
+        case USBH_MSC_DATA_DIR_IN:
+            *p_err = USBH_MSC_RxData(p_msc_dev,
+                                     p_arg,
+                                     data_len);                 /* Receive data from dev.                               */
+             break;
+
+        default:
+            *p_err = USBH_ERR_NONE;
+             break;
+    }
+
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
+    }
+
+    Mem_Set((void *)&msc_csw,
+                     0u,
+                     USBH_MSC_LEN_CSW);
+
+    *p_err = USBH_MSC_RxCSW(p_msc_dev, &msc_csw);               /* Receive CSW.                                         */
+#endif
+
+    xfer_len = USBH_MSC_CSW_Chk( p_msc_dev,                     /* Chk CSW and get actual len of data xfered.           */
+                                 msc_cbw.dCBWTag,
+                                 msc_cbw.dCBWDataTransferLength,
+                                &msc_csw,
+                                 p_err);
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+    USBH_MSC_PipeCmdRel(p_msc_dev, p_cmd);                      /* See Note #1.                                         */
+#endif
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_XferCmdAsync()
+*
+* Description : Queue a command on the pipelined engine of a device without waiting for its completion.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+*               dir             Direction of data transfer, if present.
+*
+*               p_cb            Pointer to command block.
+*
+*               cb_len          Command block length, in octets.
+*
+*               p_arg           Pointer to data buffer, if data stage present.
+*
+*               data_len        Length of data buffer in octets, if data stage present.
+*
+*               fnct            Function notified when the command completes.
+*
+*               p_fnct_arg      Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,          if command successfully queued.
+*               USBH_ERR_ALLOC,         if the command queue of the device is full.
+*
+* Note(s)     : (1) The command is completed as USBH_MSC_XferCmd() completes it (see
+*                   USBH_MSC_PipeAsyncEnd()). 'fnct' may be called before this function returns, if the
+*                   command fails before it is submitted.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  USBH_MSC_XferCmdAsync (USBH_MSC_DEV             *p_msc_dev,
+                                         CPU_INT08U                lun,
+                                         USBH_MSC_DATA_DIR         dir,
+                                         void                     *p_cb,
+                                         CPU_INT08U                cb_len,
+                                         void                     *p_arg,
+                                         CPU_INT32U                data_len,
+                                         USBH_MSC_XFER_CMPL_FNCT   fnct,
+                                         void                     *p_fnct_arg)
+{
+    USBH_MSC_CBW   msc_cbw;
+    USBH_MSC_CMD  *p_cmd;
+    USBH_ERR       err;
+
+
+    p_cmd = USBH_MSC_PipeCmdGet(p_msc_dev, DEF_FALSE, &err);    /* Get cmd from dev Q without waiting.                  */
+    if (p_cmd == (USBH_MSC_CMD *)0) {
+        return (err);
+    }
+                                                                /* Prepare CBW.                                         */
+    msc_cbw.dCBWSignature          =  USBH_MSC_SIG_CBW;
+    msc_cbw.dCBWTag                =  0u;
+    msc_cbw.dCBWDataTransferLength =  data_len;
+    msc_cbw.bmCBWFlags             = (dir == USBH_MSC_DATA_DIR_NONE) ? 0u : dir;
+    msc_cbw.bCBWLUN                =  lun;
+    msc_cbw.bCBWCBLength           =  cb_len;
+
+    Mem_Copy((void *)msc_cbw.CBWCB,
+                     p_cb,
+                     cb_len);
+
+    USBH_MSC_PipeStart( p_msc_dev,                              /* See Note #1.                                         */
+                        p_cmd,
+                       &msc_cbw,
+                        dir,
+                        p_arg,
+                        fnct,
+                        p_fnct_arg);
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_CSW_Chk()
+*
+* Description : Validate the Command Status Wrapper (CSW) of a command and get the command status.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               tag             Tag of the Command Block Wrapper (CBW).
+*
+*               data_len        Length of the data stage requested by the CBW.
+*
+*               p_msc_csw       Pointer to Command Status Wrapper (CSW).
+*
+*               p_err           Pointer to variable that holds the error code of the CSW stage and that will
+*                               receive the status of the command :
+*
+*                           USBH_ERR_NONE                           Device reports command passed.
+*                           USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*                           USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
+*                           USBH_ERR_MSC_IO                         Unable to receive CSW.
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : (1) A reset recovery is issued if the CSW is not valid or not meaningful (see 'Universal
+*                   Serial Bus Mass Storage Class Bulk-Only Transport', section 6.3).
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_MSC_CSW_Chk (USBH_MSC_DEV  *p_msc_dev,
+                                      CPU_INT32U     tag,
+                                      CPU_INT32U     data_len,
+                                      USBH_MSC_CSW  *p_msc_csw,
+                                      USBH_ERR      *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+
+    if ((p_msc_csw->dCSWSignature != USBH_MSC_SIG_CSW               ) ||
+        (p_msc_csw->bCSWStatus    == USBH_MSC_BCSWSTATUS_PHASE_ERROR) ||
+        (p_msc_csw->dCSWTag       != tag                            )) {
+        USBH_MSC_ResetRecovery(p_msc_dev);                      /* Invalid CSW, issue reset recovery (see Note #1).     */
+    }
+
+    if (*p_err == USBH_ERR_NONE) {
+        switch (p_msc_csw->bCSWStatus) {
+            case USBH_MSC_BCSWSTATUS_CMD_PASSED:
+                *p_err = USBH_ERR_NONE;
+                 break;
+
+            case USBH_MSC_BCSWSTATUS_CMD_FAILED:
+                *p_err = USBH_ERR_MSC_CMD_FAILED;
+                 break;
+
+            case USBH_MSC_BCSWSTATUS_PHASE_ERROR:
+                *p_err = USBH_ERR_MSC_CMD_PHASE;
+                 break;
+
+            default:
+                *p_err = USBH_ERR_MSC_CMD_FAILED;
+                 break;
+        }
+    } else {
+       *p_err = USBH_ERR_MSC_IO;
+    }
+
+    xfer_len = data_len - p_msc_csw->dCSWDataResidue;           /* Actual len of data xfered to dev.                    */
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_TxCBW()
+*
+* Description : Send Command Block Wrapper (CBW) to device through bulk OUT endpoint.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_msc_cbw       Pointer to Command Block Wrapper (CBW).
+*
+* Return(s)   : USBH_ERR_NONE                           If CBW successfully transmitted.
+*
+*                                                       ----- RETURNED BY USBH_BulkTx() : -----
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN != DEF_ENABLED)
+static  USBH_ERR  USBH_MSC_TxCBW (USBH_MSC_DEV  *p_msc_dev,
+                                  USBH_MSC_CBW  *p_msc_cbw)
+{
+    CPU_INT08U  cmd_buf[USBH_MSC_LEN_CBW];
+    USBH_ERR    err;
+    CPU_INT32U  len;
+
+
+    Mem_Clr((void *)cmd_buf,
+                    USBH_MSC_LEN_CBW);
+
+    USBH_MSC_FmtCBW(p_msc_cbw, cmd_buf);                        /* Format CBW.                                          */
+
+    len = USBH_BulkTx(        &p_msc_dev->BulkOutEP,            /* Send CBW through bulk OUT EP.                        */
+                      (void *)&cmd_buf[0],
+                               USBH_MSC_LEN_CBW,
+                               USBH_MSC_TIMEOUT,
+                              &err);
+    if (len != USBH_MSC_LEN_CBW) {
+        if (err != USBH_ERR_NONE) {
+            USBH_PRINT_ERR(err);
+            USBH_EP_Reset(p_msc_dev->DevPtr,
+                         &p_msc_dev->BulkOutEP);                /* Clear EP err on host side.                           */
+        }
+
+        if (err == USBH_ERR_EP_STALL) {
+            USBH_MSC_ResetRecovery(p_msc_dev);
+        }
+    } else {
+        err = USBH_ERR_NONE;
+    }
+
+    return (err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_RxCSW()
+*
+* Description : Receive Command Status Word (CSW) from device through bulk IN endpoint.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_msc_csw       Pointer to Command Status Word (CSW).
+*
+* Return(s)   : USBH_ERR_NONE,                          If CSW successfully received.
+*
+*                                                       ----- RETURNED BY USBH_BulkRx() : -----
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_MSC_RxCSW (USBH_MSC_DEV  *p_msc_dev,
+                                  USBH_MSC_CSW  *p_msc_csw)
+{
+    CPU_INT32U  retry;
+    CPU_INT08U  status_buf[USBH_MSC_LEN_CSW];
+    USBH_ERR    err;
+    CPU_INT32U  len;
+
+
+    err   = USBH_ERR_NONE;
+    retry = 2u;
+
+                                                                /* Receive CSW from dev through bulk IN EP.             */
+    while (retry > 0u) {
+        len = USBH_BulkRx(        &p_msc_dev->BulkInEP,
+                          (void *)&status_buf[0],
+                                   USBH_MSC_LEN_CSW,
+                                   USBH_MSC_TIMEOUT,
+                                  &err);
+        if (len != USBH_MSC_LEN_CSW) {
+            USBH_EP_Reset(p_msc_dev->DevPtr,
+                         &p_msc_dev->BulkInEP);                 /* Clear err on host side.                              */
+
+            if (err == USBH_ERR_EP_STALL) {
+                (void)USBH_MSC_StallClr(p_msc_dev, &p_msc_dev->BulkInEP);
+                retry--;
+            } else {
+                break;
+            }
+        } else {
+            err = USBH_ERR_NONE;
+            USBH_MSC_ParseCSW(p_msc_csw, status_buf);
+            break;
+        }
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_TxData()
+*
+* Description : Send data to device through bulk OUT endpoint.
+*
+* Argument(s) : p_msc_dev        Pointer to MSC device.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               data_len         Length of data buffer in octets.
+*
+* Return(s)   : USBH_ERR_NONE,                          if data successfully transmitted.
+*
+*                                                       ----- RETURNED BY USBH_BulkTx() : -----
+*               USBH_ERR_NONE                           Bulk transfer successfully transmitted.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               USBH_ERR_NONE,                          URB is successfully submitted to host controller.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_MSC_TxData (USBH_MSC_DEV  *p_msc_dev,
+                                   void          *p_arg,
+                                   CPU_INT32U     data_len)
+{
+    USBH_ERR      err;
+    CPU_BOOLEAN   retry;
+    CPU_INT08U   *p_data_08;
+    CPU_INT16U    retry_cnt;
+    CPU_INT32U    p_data_ix;
+    CPU_INT32U    data_len_rem;
+    CPU_INT32U    data_len_tx;
+
+
+    err          =  USBH_ERR_NONE;
+    p_data_ix    =  0u;
+    p_data_08    = (CPU_INT08U *)p_arg;
+    data_len_rem =  data_len;
+    retry_cnt    =  0u;
+    retry        =  DEF_TRUE;
+
+    while ((data_len_rem  > 0u      ) &&
+           (retry        == DEF_TRUE)) {
+
+        data_len_tx = USBH_BulkTx(        &p_msc_dev->BulkOutEP,
+                                  (void *)(p_data_08 + p_data_ix),
+                                           data_len_rem,
+                                           USBH_MSC_TIMEOUT,
+                                          &err);
+        switch (err) {
+            case USBH_ERR_DEV_NOT_RESPONDING:
+            case USBH_ERR_HC_IO:
+                 retry_cnt++;
+                 if (retry_cnt >= USBH_MSC_MAX_TRANSFER_RETRY) {
+                     retry = DEF_FALSE;
+                 }
+                 break;
+
+            case USBH_ERR_NONE:
+                 if (data_len_tx < data_len_rem) {
+                     data_len_rem -= data_len_tx;
+                     p_data_ix    += data_len_tx;
+                 } else {
+                     data_len_rem = 0u;
+                 }
+                 break;
+
+            default:
+                 retry = DEF_FALSE;
+                 break;
+        }
+    }
+
+    if (err != USBH_ERR_NONE) {
+        USBH_PRINT_ERR(err);
+
+        USBH_EP_Reset(p_msc_dev->DevPtr,
+                     &p_msc_dev->BulkOutEP);
+        if (err == USBH_ERR_EP_STALL) {
+            (void)USBH_MSC_StallClr(p_msc_dev, &p_msc_dev->BulkOutEP);
+        } else {
+            (void)USBH_MSC_ResetRecovery(p_msc_dev);
+        }
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_RxData()
+*
+* Description : Receive data from device through bulk IN endpoint.
+*
+* Argument(s) : p_msc_dev        Pointer to MSC device.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               data_len         Length of data buffer in octets.
+*
+* Return(s)   : USBH_ERR_NONE,                          if data successfully received.
+*
+*                                                       ----- RETURNED BY USBH_BulkRx() : -----
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_MSC_RxData (USBH_MSC_DEV  *p_msc_dev,
+                                   void          *p_arg,
+                                   CPU_INT32U     data_len)
+
+{
+    USBH_ERR      err;
+    CPU_BOOLEAN   retry;
+    CPU_INT08U   *p_data_08;
+    CPU_INT16U    retry_cnt;
+    CPU_INT32U    p_data_ix;
+    CPU_INT32U    data_len_rem;
+    CPU_INT32U    data_len_rx;
+
+
+    err          =  USBH_ERR_NONE;
+    p_data_ix    =  0u;
+    p_data_08    = (CPU_INT08U *)p_arg;
+    data_len_rem =  data_len;
+    retry_cnt    =  0u;
+    retry        =  DEF_TRUE;
+
+    while ((data_len_rem  > 0u      ) &&
+           (retry        == DEF_TRUE)) {
+
+        data_len_rx = USBH_BulkRx(        &p_msc_dev->BulkInEP,
+                                  (void *)(p_data_08 + p_data_ix),
+                                           data_len_rem,
+                                           USBH_MSC_TIMEOUT,
+                                          &err);
+        switch (err) {
+            case USBH_ERR_DEV_NOT_RESPONDING:
+            case USBH_ERR_HC_IO:
+                 retry_cnt++;
+                 if (retry_cnt >= USBH_MSC_MAX_TRANSFER_RETRY) {
+                     retry = DEF_FALSE;
+                 }
+                 break;
+
+            case USBH_ERR_NONE:
+                 if (data_len_rx < data_len_rem) {
+                     data_len_rem -= data_len_rx;               /* Update remaining nbr of octets to read.              */
+                     p_data_ix    += data_len_rx;               /* Update buf ix.                                       */
+                 } else {
+                     data_len_rem = 0u;
+                 }
+                 break;
+
+            default:
+                 retry = DEF_FALSE;
+                 break;
+        }
+    }
+
+    if (err != USBH_ERR_NONE) {
+        USBH_PRINT_ERR(err);
+
+        (void)USBH_EP_Reset(p_msc_dev->DevPtr,
+                           &p_msc_dev->BulkInEP);               /* Clr err on host side EP.                             */
+        if (err == USBH_ERR_EP_STALL) {
+            (void)USBH_MSC_StallClr(p_msc_dev, &p_msc_dev->BulkInEP);
+            err = USBH_ERR_NONE;
+        } else {
+            (void)USBH_MSC_ResetRecovery(p_msc_dev);
+            err = USBH_ERR_MSC_IO;
+        }
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_MSC_ResetRecovery()
+*
+* Description : Apply bulk-only reset recovery to device on phase error & clear stalled endpoints.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : USBH_ERR_NONE,                          If reset recovery procedure is successful.
+*
+*                                                       ----- RETURNED BY USBH_MSC_BulkOnlyReset -----
+*               USBH_ERR_UNKNOWN,                       Unknown error occurred.
+*               USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+*                                                       ----- RETURNED BY USBH_EP_StallClr -----
+*               USBH_ERR_UNKNOWN                        Unknown error occurred.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_MSC_ResetRecovery (USBH_MSC_DEV  *p_msc_dev)
+{
+    USBH_ERR  err;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_msc_dev->RecoveryStat.ResetCnt++;
+    CPU_CRITICAL_EXIT();
+
+    err = USBH_MSC_BulkOnlyReset(p_msc_dev);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_EP_StallClr(&p_msc_dev->BulkInEP);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_EP_StallClr(&p_msc_dev->BulkOutEP);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_StallClr()
+*
+* Description : Clear the halt of a bulk endpoint, without reset recovery.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_ep            Pointer to bulk IN or OUT endpoint of the device.
+*
+* Return(s)   : USBH_ERR_NONE,                          If the halt is cleared.
+*
+*                                                       ----- RETURNED BY USBH_EP_StallClr -----
+*               USBH_ERR_UNKNOWN                        Unknown error occurred.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The endpoints halted by a reset recovery are cleared by USBH_MSC_ResetRecovery(), and
+*                   not counted here.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_MSC_StallClr (USBH_MSC_DEV  *p_msc_dev,
+                                     USBH_EP       *p_ep)
+{
+    USBH_ERR  err;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_msc_dev->RecoveryStat.StallClrCnt++;
+    CPU_CRITICAL_EXIT();
+
+    err = USBH_EP_StallClr(p_ep);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_MSC_BulkOnlyReset()
+*
+* Description : Issue bulk-only reset.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : Specific error code.
+*
+* Note(s)     : (1)The "BULK ONLY MASS STORAGE RESET" is an MSC specific request is documented in USB
+                   MSC Bulk only transport specification, section 3.1
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_MSC_BulkOnlyReset (USBH_MSC_DEV  *p_msc_dev)
+{
+    USBH_ERR    err;
+    CPU_INT08U  if_nbr;
+
+
+    err    = USBH_ERR_NONE;
+    if_nbr = USBH_IF_NbrGet(p_msc_dev->IF_Ptr);
+
+    USBH_CtrlTx(        p_msc_dev->DevPtr,
+                        USBH_MSC_REQ_MASS_STORAGE_RESET, /*  See Note(s) #1                                      */
+                       (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
+                        0u,
+                        if_nbr,
+                (void *)0,
+                        0u,
+                        USBH_MSC_TIMEOUT,
+                       &err);
+    if (err != USBH_ERR_NONE) {
+        USBH_PRINT_ERR(err);
+        USBH_EP_Reset(           p_msc_dev->DevPtr,
+                      (USBH_EP *)0);
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_PipeCmdGet()
+*
+* Description : Get a free command from the command queue of a device and assign it a new tag.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               wait            DEF_TRUE to wait for a free command (see Note #1).
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                           USBH_ERR_NONE                   Command successfully allocated.
+*                           USBH_ERR_ALLOC                  No free command and 'wait' is DEF_FALSE.
+*
+*                                                           ----- RETURNED BY USBH_OS_SemWait() : -----
+*                           USBH_ERR_INVALID_ARG,           If invalid argument passed to 'sem'.
+*                           USBH_ERR_OS_ABORT,              If semaphore wait aborted.
+*                           USBH_ERR_OS_FAIL,               Otherwise.
+*
+* Return(s)   : Pointer to command,     if successful.
+*               Pointer to NULL,        otherwise.
+*
+* Note(s)     : (1) A task waits until one of the USBH_MSC_CFG_CMD_Q_LEN commands of the device is
+*                   released. Asynchronous requests, which may be issued from a completion callback, do
+*                   not wait.
+*
+*               (2) A command released while tasks wait is handed over to the first task woken (see
+*                   USBH_MSC_PipeCmdRel()). It cannot be taken in between by an asynchronous request
+*                   issued from a completion callback, which would starve the waiting tasks.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_MSC_CMD  *USBH_MSC_PipeCmdGet (USBH_MSC_DEV  *p_msc_dev,
+                                            CPU_BOOLEAN    wait,
+                                            USBH_ERR      *p_err)
+{
+    USBH_MSC_CMD  *p_cmd;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    if (p_msc_dev->CmdFreePtr != (USBH_MSC_CMD *)0) {
+        p_cmd                 = p_msc_dev->CmdFreePtr;
+        p_msc_dev->CmdFreePtr = p_cmd->NxtPtr;
+
+    } else {
+        if (wait == DEF_FALSE) {
+            CPU_CRITICAL_EXIT();
+           *p_err = USBH_ERR_ALLOC;
+            return ((USBH_MSC_CMD *)0);
+        }
+
+        p_msc_dev->CmdWaitCnt++;
+        CPU_CRITICAL_EXIT();
+
+       *p_err = USBH_OS_SemWait(p_msc_dev->CmdFreeSem, 0u);     /* See Note #1.                                         */
+        if (*p_err != USBH_ERR_NONE) {
+            CPU_CRITICAL_ENTER();
+            p_msc_dev->CmdWaitCnt--;
+            CPU_CRITICAL_EXIT();
+            return ((USBH_MSC_CMD *)0);
+        }
+
+        CPU_CRITICAL_ENTER();
+        p_cmd                = p_msc_dev->CmdRsvPtr;            /* Take cmd handed over (see Note #2).                  */
+        p_msc_dev->CmdRsvPtr = p_cmd->NxtPtr;
+    }
+
+    p_msc_dev->CmdTag++;
+    p_cmd->Tag            = p_msc_dev->CmdTag;
+    p_cmd->NxtPtr         = (USBH_MSC_CMD *)0;
+    CPU_CRITICAL_EXIT();
+
+    return (p_cmd);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_PipeCmdRel()
+*
+* Description : Release a command and start the next queued command, if the engine was halted on it.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_cmd           Pointer to command.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) A command that completed cleanly was removed from the queue by its CSW completion,
+*                   which also started the next command. Otherwise, the command is still at the head of
+*                   the queue and the engine is halted on it.
+*
+*               (2) See USBH_MSC_PipeCmdGet() Note #2.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  USBH_MSC_PipeCmdRel (USBH_MSC_DEV  *p_msc_dev,
+                                   USBH_MSC_CMD  *p_cmd)
+{
+    USBH_MSC_CMD  *p_cmd_nxt;
+    CPU_BOOLEAN    post;
+    CPU_SR_ALLOC();
+
+
+    p_cmd_nxt = (USBH_MSC_CMD *)0;
+
+    CPU_CRITICAL_ENTER();
+    if ((DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CLEAN) == DEF_NO) &&
+        (p_msc_dev->CmdHeadPtr == p_cmd)) {                     /* See Note #1.                                         */
+        p_cmd_nxt = USBH_MSC_PipeNxt(p_msc_dev);
+    }
+
+    if (p_msc_dev->CmdWaitCnt > 0u) {                           /* Hand cmd over to a waiting task (see Note #2).       */
+        p_msc_dev->CmdWaitCnt--;
+        p_cmd->NxtPtr         = p_msc_dev->CmdRsvPtr;
+        p_msc_dev->CmdRsvPtr  = p_cmd;
+        post                  = DEF_TRUE;
+    } else {
+        p_cmd->NxtPtr         = p_msc_dev->CmdFreePtr;          /* Return cmd to free list.                             */
+        p_msc_dev->CmdFreePtr = p_cmd;
+        post                  = DEF_FALSE;
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (post == DEF_TRUE) {
+        (void)USBH_OS_SemPost(p_msc_dev->CmdFreeSem);
+    }
+
+    if (p_cmd_nxt != (USBH_MSC_CMD *)0) {
+        USBH_MSC_PipeRun(p_cmd_nxt);
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_MSC_PipeNxt()
+*
+* Description : Remove the command at the head of the queue and select the next command to start.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : Pointer to next command, moved to the head of the queue, if any.
+*
+*               Pointer to NULL, if queue is empty.
+*
+* Note(s)     : (1) This function MUST be called from a critical section.
+*
+*               (2) Only the oldest command of each LUN is a candidate, so that the commands of a LUN are
+*                   executed in the order they were queued. The candidates are ranked round-robin by
+*                   LUN, starting with the LUN following the one of the last command started.
+*
+*               (3) While fewer than USBH_MSC_CFG_RD_PRIO_MAX commands were started in a row ahead of a
+*                   write, the writes are ranked after all other commands. A read of a LUN is hence not
+*                   delayed by a long sequence of writes to another LUN, and the writes are started
+*                   at least once every USBH_MSC_CFG_RD_PRIO_MAX + 1 commands.
+*
+*               (4) The commands of a device with a single LUN are executed in the order they were
+*                   queued.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_MSC_CMD  *USBH_MSC_PipeNxt (USBH_MSC_DEV  *p_msc_dev)
+{
+    USBH_MSC_CMD  *p_cmd;
+    USBH_MSC_CMD  *p_cmd_prev;
+    USBH_MSC_CMD  *p_cmd_sel;
+    USBH_MSC_CMD  *p_cmd_sel_prev;
+    CPU_INT16U     lun_bit;
+    CPU_INT16U     lun_seen;
+    CPU_INT08U     rank;
+    CPU_INT08U     rank_sel;
+    CPU_BOOLEAN    rd_prio;
+    CPU_BOOLEAN    wr_pend;
+
+
+    p_cmd                 = p_msc_dev->CmdHeadPtr->NxtPtr;      /* Remove cmd at head of queue.                         */
+    p_msc_dev->CmdHeadPtr = p_cmd;
+    if (p_cmd == (USBH_MSC_CMD *)0) {
+        p_msc_dev->CmdTailPtr = (USBH_MSC_CMD *)0;
+        return ((USBH_MSC_CMD *)0);
+    }
+                                                                /* ---------------- RANK CANDIDATES ------------------- */
+#if (USBH_MSC_CFG_RD_PRIO_MAX > 0u)
+    rd_prio        = (p_msc_dev->CmdRdCnt < USBH_MSC_CFG_RD_PRIO_MAX) ? DEF_TRUE : DEF_FALSE;
+#else
+    rd_prio        =  DEF_FALSE;                                /* Rd priority disabled.                                */
+#endif
+    wr_pend        =  DEF_FALSE;
+    lun_seen       =  0u;
+    rank_sel       =  DEF_INT_08U_MAX_VAL;
+    p_cmd_prev     = (USBH_MSC_CMD *)0;
+    p_cmd_sel      = (USBH_MSC_CMD *)0;
+    p_cmd_sel_prev = (USBH_MSC_CMD *)0;
+
+    while (p_cmd != (USBH_MSC_CMD *)0) {
+        lun_bit = (CPU_INT16U)DEF_BIT(p_cmd->LUN & 0x0Fu);
+        if (DEF_BIT_IS_CLR(lun_seen, lun_bit) == DEF_YES) {     /* Oldest cmd of LUN (see Note #2).                     */
+            DEF_BIT_SET(lun_seen, lun_bit);
+
+            rank = (CPU_INT08U)((p_cmd->LUN - p_msc_dev->CmdLUN - 1u) & 0x0Fu);
+            if (p_cmd->Dir == USBH_MSC_DATA_DIR_OUT) {
+                wr_pend = DEF_TRUE;
+                if (rd_prio == DEF_TRUE) {                      /* Rank writes last (see Note #3).                      */
+                    rank += 16u;
+                }
+            }
+
+            if (rank < rank_sel) {
+                rank_sel       = rank;
+                p_cmd_sel      = p_cmd;
+                p_cmd_sel_prev = p_cmd_prev;
+            }
+        }
+
+        p_cmd_prev = p_cmd;
+        p_cmd      = p_cmd->NxtPtr;
+    }
+                                                                /* ------------- MOVE SEL CMD TO HEAD ----------------- */
+    if (p_cmd_sel_prev != (USBH_MSC_CMD *)0) {
+        p_cmd_sel_prev->NxtPtr = p_cmd_sel->NxtPtr;
+        if (p_msc_dev->CmdTailPtr == p_cmd_sel) {
+            p_msc_dev->CmdTailPtr = p_cmd_sel_prev;
+        }
+        p_cmd_sel->NxtPtr     = p_msc_dev->CmdHeadPtr;
+        p_msc_dev->CmdHeadPtr = p_cmd_sel;
+    }
+
+    p_msc_dev->CmdLUN = p_cmd_sel->LUN;
+    if ((p_cmd_sel->Dir == USBH_MSC_DATA_DIR_OUT) ||
+        (wr_pend        == DEF_FALSE)) {
+        p_msc_dev->CmdRdCnt = 0u;
+    } else {
+        p_msc_dev->CmdRdCnt++;
+    }
+
+    return (p_cmd_sel);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_PipeStart()
+*
+* Description : Queue a command on the pipelined engine of a device.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_cmd           Pointer to command.
+*
+*               p_msc_cbw       Pointer to Command Block Wrapper (CBW).
+*
+*               dir             Direction of data transfer, if present.
+*
+*               p_arg           Pointer to data buffer, if data stage present.
+*
+*               fnct            Function notified when the command completes, for an asynchronous command.
+*                               Pointer to NULL for a command waited by the caller.
+*
+*               p_fnct_arg      Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The CBW is formatted before the command is queued, so that it can be submitted as soon
+*                   as the CSW of the previous command is received, from the asynchronous task.
+*
+*               (2) The stages are submitted as asynchronous transfers: the CBW and the data OUT stage on
+*                   the bulk OUT endpoint, the data IN stage followed by the CSW on the bulk IN endpoint.
+*                   The host controller executes them back to back, without a round trip to a task.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  USBH_MSC_PipeStart (USBH_MSC_DEV             *p_msc_dev,
+                                  USBH_MSC_CMD             *p_cmd,
+                                  USBH_MSC_CBW             *p_msc_cbw,
+                                  USBH_MSC_DATA_DIR         dir,
+                                  void                     *p_arg,
+                                  USBH_MSC_XFER_CMPL_FNCT   fnct,
+                                  void                     *p_fnct_arg)
+{
+    CPU_BOOLEAN  start;
+    CPU_SR_ALLOC();
+
+                                                                /* ------------------ PREPARE CMD --------------------- */
+    p_msc_cbw->dCBWTag = p_cmd->Tag;
+    Mem_Clr((void *)p_cmd->CBW_Buf,
+                    USBH_MSC_LEN_CBW);
+    USBH_MSC_FmtCBW(p_msc_cbw, p_cmd->CBW_Buf);                 /* See Note #1.                                         */
+
+    p_cmd->Dir           = (p_msc_cbw->dCBWDataTransferLength == 0u) ? USBH_MSC_DATA_DIR_NONE : dir;
+    p_cmd->DataPtr       = (CPU_INT08U *)p_arg;
+    p_cmd->DataLen       =  p_msc_cbw->dCBWDataTransferLength;
+    p_cmd->DataSubmitLen =  0u;
+    p_cmd->DataCmplLen   =  0u;
+    p_cmd->DataXferLen   =  0u;
+    p_cmd->URB_Cnt       =  0u;
+    p_cmd->Flags         =  0u;
+    p_cmd->Err           =  USBH_ERR_NONE;
+    p_cmd->ErrStage      =  USBH_MSC_CMD_STAGE_NONE;
+    p_cmd->CmplFnctPtr   =  fnct;
+    p_cmd->CmplArgPtr    =  p_fnct_arg;
+    p_cmd->LUN           =  p_msc_cbw->bCBWLUN;
+
+                                                                /* -------------------- QUEUE CMD --------------------- */
+    CPU_CRITICAL_ENTER();
+    if (p_msc_dev->CmdTailPtr != (USBH_MSC_CMD *)0) {
+        p_msc_dev->CmdTailPtr->NxtPtr = p_cmd;
+    } else {
+        p_msc_dev->CmdHeadPtr = p_cmd;
+    }
+    p_msc_dev->CmdTailPtr = p_cmd;
+    start                 = (p_msc_dev->CmdHeadPtr == p_cmd) ? DEF_TRUE : DEF_FALSE;
+    if (start == DEF_TRUE) {
+        p_msc_dev->CmdLUN   = p_cmd->LUN;
+        p_msc_dev->CmdRdCnt = 0u;
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (start == DEF_TRUE) {                                    /* Start cmd if engine is idle (see Note #2).           */
+        USBH_MSC_PipeRun(p_cmd);
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_PipeXfer()
+*
+* Description : Execute the CBW, data and CSW stages of a command with the pipelined engine and wait for
+*               its completion.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_cmd           Pointer to command.
+*
+*               p_msc_cbw       Pointer to Command Block Wrapper (CBW).
+*
+*               dir             Direction of data transfer, if present.
+*
+*               p_arg           Pointer to data buffer, if data stage present.
+*
+*               p_msc_csw       Pointer to variable that will receive the Command Status Wrapper (CSW).
+*
+*               p_csw_err       Pointer to variable that will receive the error code of the CSW stage.
+*
+* Return(s)   : USBH_ERR_NONE,                          if CBW and data stages successful.
+*
+*                                                       ----- RETURNED BY USBH_MSC_PipeRecover() : -----
+*               USBH_ERR_EP_STALL,                      if device stalled the CBW or the data OUT stage.
+*               USBH_ERR_MSC_IO,                        if data IN stage failed.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The wait is restarted while the command is queued behind another command. That
+*                   command's task recovers the device if it times out.
+*
+*               (2) The URBs still queued on the bulk endpoints are aborted and this function waits until
+*                   their completion has been handled, so that the command can be reused.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  USBH_MSC_PipeXfer (USBH_MSC_DEV       *p_msc_dev,
+                                     USBH_MSC_CMD       *p_cmd,
+                                     USBH_MSC_CBW       *p_msc_cbw,
+                                     USBH_MSC_DATA_DIR   dir,
+                                     void               *p_arg,
+                                     USBH_MSC_CSW       *p_msc_csw,
+                                     USBH_ERR           *p_csw_err)
+{
+    CPU_BOOLEAN  timeout;
+    USBH_ERR     err;
+    CPU_SR_ALLOC();
+
+
+    USBH_MSC_PipeStart(p_msc_dev,
+                       p_cmd,
+                       p_msc_cbw,
+                       dir,
+                       p_arg,
+                       (USBH_MSC_XFER_CMPL_FNCT)0,
+                       (void *)0);
+                                                                /* ------------------ WAIT FOR CMD -------------------- */
+    timeout = DEF_FALSE;
+    while (timeout == DEF_FALSE) {
+        err = USBH_OS_SemWait(p_cmd->Sem, USBH_MSC_TIMEOUT);
+        if (err == USBH_ERR_NONE) {
+            break;
+        }
+
+        CPU_CRITICAL_ENTER();                                   /* See Note #1.                                         */
+        if ((p_msc_dev->CmdHeadPtr                                     == p_cmd) &&
+            (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_SIGNALED) == DEF_NO)) {
+            DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_SIGNALED);
+            p_cmd->Err = err;
+            timeout    = DEF_TRUE;
+        }
+        CPU_CRITICAL_EXIT();
+    }
+
+    if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CLEAN) == DEF_YES) {
+        USBH_MSC_ParseCSW(p_msc_csw, p_cmd->CSW_Buf);
+       *p_csw_err = USBH_ERR_NONE;
+        return (USBH_ERR_NONE);
+    }
+
+    if (USBH_MSC_PipeAbort(p_cmd) == DEF_TRUE) {                /* See Note #2.                                         */
+        (void)USBH_OS_SemWait(p_cmd->Sem, USBH_MSC_TIMEOUT);
+    }
+
+    err = USBH_MSC_PipeRecover(p_msc_dev,                       /* Finish cmd synchronously.                            */
+                               p_cmd,
+                               p_msc_csw,
+                               p_csw_err);
+
+    return (err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_PipeAsyncEnd()
+*
+* Description : Complete an asynchronous command and notify the application.
+*
+* Argument(s) : p_cmd           Pointer to command.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The URBs still queued on the bulk endpoints are aborted. If some are not completed
+*                   when USBH_EP_Abort() returns, the completion of the last one ends the command.
+*
+*               (2) A command that did not complete cleanly is recovered from this context, which is
+*                   the asynchronous task in most cases. The recovery blocks the notification of other
+*                   transfers handled by this task until it ends.
+*
+*               (3) The command is released before the application is notified, so that the completion
+*                   function can queue another command. The command is handed over to a task waiting for
+*                   one, if any (see USBH_MSC_PipeCmdGet() Note #2); the completion function then gets
+*                   USBH_ERR_ALLOC if the queue is still full.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  USBH_MSC_PipeAsyncEnd (USBH_MSC_CMD  *p_cmd)
+{
+    USBH_MSC_DEV             *p_msc_dev;
+    USBH_MSC_CSW              msc_csw;
+    USBH_MSC_XFER_CMPL_FNCT   p_fnct;
+    void                     *p_fnct_arg;
+    void                     *p_buf;
+    CPU_INT32U                buf_len;
+    CPU_INT32U                xfer_len;
+    USBH_ERR                  err;
+    USBH_ERR                  err_csw;
+
+
+    if (USBH_MSC_PipeAbort(p_cmd) == DEF_TRUE) {                /* See Note #1.                                         */
+        return;
+    }
+
+    p_msc_dev = p_cmd->MSC_DevPtr;
+
+    if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CLEAN) == DEF_YES) {
+        USBH_MSC_ParseCSW(&msc_csw, p_cmd->CSW_Buf);
+        err     = USBH_ERR_NONE;
+        err_csw = USBH_ERR_NONE;
+    } else {
+        err = USBH_MSC_PipeRecover( p_msc_dev,                  /* See Note #2.                                         */
+                                    p_cmd,
+                                   &msc_csw,
+                                   &err_csw);
+    }
+
+    if (err == USBH_ERR_NONE) {
+        xfer_len = USBH_MSC_CSW_Chk( p_msc_dev,
+                                     p_cmd->Tag,
+                                     p_cmd->DataLen,
+                                    &msc_csw,
+                                    &err_csw);
+        err      = err_csw;
+    }
+    if (err != USBH_ERR_NONE) {
+        xfer_len = 0u;
+    }
+
+    p_fnct     = p_cmd->CmplFnctPtr;
+    p_fnct_arg = p_cmd->CmplArgPtr;
+    p_buf      = (void *)p_cmd->DataPtr;
+    buf_len    = p_cmd->DataLen;
+
+    USBH_MSC_PipeCmdRel(p_msc_dev, p_cmd);                      /* See Note #3.                                         */
+
+    p_fnct(p_msc_dev,
+           p_buf,
+           buf_len,
+           xfer_len,
+           p_fnct_arg,
+           err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_PipeAbort()
+*
+* Description : Abort the URBs of a command still queued on the bulk endpoints.
+*
+* Argument(s) : p_cmd           Pointer to command.
+*
+* Return(s)   : DEF_TRUE,       if aborted URBs are still to be completed.
+*               DEF_FALSE,      otherwise.
+*
+* Note(s)     : (1) USBH_EP_Abort() completes the scheduled URBs from this context. The last of these
+*                   completions does not signal the command (see USBH_MSC_PipeRun() Note #1d), since
+*                   the caller is informed by the return value.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  CPU_BOOLEAN  USBH_MSC_PipeAbort (USBH_MSC_CMD  *p_cmd)
+{
+    USBH_MSC_DEV  *p_msc_dev;
+    CPU_BOOLEAN    drain;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    drain = (p_cmd->URB_Cnt != 0u) ? DEF_TRUE : DEF_FALSE;
+    if (drain == DEF_TRUE) {
+        DEF_BIT_SET(p_cmd->Flags, (USBH_MSC_CMD_FLAG_DRAIN | USBH_MSC_CMD_FLAG_ABORT));
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (drain == DEF_FALSE) {
+        return (DEF_FALSE);
+    }
+
+    p_msc_dev = p_cmd->MSC_DevPtr;
+    (void)USBH_EP_Abort(&p_msc_dev->BulkInEP);
+    (void)USBH_EP_Abort(&p_msc_dev->BulkOutEP);
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    DEF_BIT_CLR(p_cmd->Flags, USBH_MSC_CMD_FLAG_ABORT);
+    drain = DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_DRAIN);
+    CPU_CRITICAL_EXIT();
+
+    return (drain);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_MSC_PipeRecover()
+*
+* Description : Finish a command that did not complete cleanly in the pipelined engine.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_cmd           Pointer to command.
+*
+*               p_msc_csw       Pointer to variable that will receive the Command Status Wrapper (CSW).
+*
+*               p_csw_err       Pointer to variable that will receive the error code of the CSW stage.
+*
+* Return(s)   : USBH_ERR_NONE,                          if CBW and data stages successful.
+*
+*                                                       ----- RETURNED BY USBH_MSC_TxData() : -----
+*               USBH_ERR_EP_STALL,                      if device stalled the data OUT stage.
+*               Host controller drivers error code,     Otherwise.
+*
+*                                                       ----- RETURNED BY USBH_MSC_RxData() : -----
+*               USBH_ERR_MSC_IO,                        if data IN stage failed.
+*
+* Note(s)     : (1) No URB of the command may be in progress.
+*
+*               (2) Each stage is handled as USBH_MSC_TxCBW(), USBH_MSC_TxData(), USBH_MSC_RxData() and
+*                   USBH_MSC_RxCSW() would have handled the same error. The stages that did not complete
+*                   are finished with these functions.
+*
+*               (3) The CSW is received in place of data when the data IN stage ends with a short packet
+*                   while more data was requested (see USBH_MSC_PipeCmpl()).
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  USBH_MSC_PipeRecover (USBH_MSC_DEV  *p_msc_dev,
+                                        USBH_MSC_CMD  *p_cmd,
+                                        USBH_MSC_CSW  *p_msc_csw,
+                                        USBH_ERR      *p_csw_err)
+{
+    USBH_EP      *p_ep_data;
+    CPU_BOOLEAN   data_done;
+    USBH_ERR      err;
+
+
+    err = p_cmd->Err;
+    if (err != USBH_ERR_NONE) {
+        USBH_PRINT_ERR(err);
+    }
+                                                                /* -------------------- CBW STAGE --------------------- */
+    if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CBW_DONE) == DEF_NO) {
+        USBH_EP_Reset(p_msc_dev->DevPtr,
+                     &p_msc_dev->BulkOutEP);                    /* Clear EP err on host side.                           */
+        if (err == USBH_ERR_EP_STALL) {
+            USBH_MSC_ResetRecovery(p_msc_dev);
+        }
+        return (err);
+    }
+                                                                /* -------------------- DATA STAGE -------------------- */
+    data_done = ((DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_DATA_SHORT) == DEF_YES) ||
+                 (p_cmd->DataXferLen                                         >= p_cmd->DataLen)) ? DEF_TRUE : DEF_FALSE;
+
+    if (p_cmd->ErrStage == USBH_MSC_CMD_STAGE_DATA) {
+        p_ep_data = (p_cmd->Dir == USBH_MSC_DATA_DIR_IN) ? &p_msc_dev->BulkInEP : &p_msc_dev->BulkOutEP;
+        (void)USBH_EP_Reset(p_msc_dev->DevPtr,                  /* Clr err on host side EP.                             */
+                            p_ep_data);
+        switch (err) {
+            case USBH_ERR_EP_STALL:                             /* Data IN stall ends data stage.                       */
+                 (void)USBH_MSC_StallClr(p_msc_dev, p_ep_data);
+                 if (p_cmd->Dir != USBH_MSC_DATA_DIR_IN) {
+                     return (err);
+                 }
+                 data_done = DEF_TRUE;
+                 break;
+
+            case USBH_ERR_DEV_NOT_RESPONDING:                   /* Retry remaining data (see Note #2).                  */
+            case USBH_ERR_HC_IO:
+                 break;
+
+            default:
+                 (void)USBH_MSC_ResetRecovery(p_msc_dev);
+                 return ((p_cmd->Dir == USBH_MSC_DATA_DIR_IN) ? USBH_ERR_MSC_IO : err);
+        }
+    }
+
+    if (data_done == DEF_FALSE) {                               /* See Note #2.                                         */
+        switch (p_cmd->Dir) {
+            case USBH_MSC_DATA_DIR_OUT:
+                 err = USBH_MSC_TxData(        p_msc_dev,
+                                       (void *)(p_cmd->DataPtr + p_cmd->DataXferLen),
+                                               p_cmd->DataLen - p_cmd->DataXferLen);
+                 break;
+
+            case USBH_MSC_DATA_DIR_IN:
+                 err = USBH_MSC_RxData(        p_msc_dev,
+                                       (void *)(p_cmd->DataPtr + p_cmd->DataXferLen),
+                                               p_cmd->DataLen - p_cmd->DataXferLen);
+                 break;
+
+            default:
+                 err = USBH_ERR_NONE;
+                 break;
+        }
+
+        if (err != USBH_ERR_NONE) {
+            return (err);
+        }
+    }
+                                                                /* -------------------- CSW STAGE --------------------- */
+    if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CSW_RX) == DEF_YES) {
+        USBH_MSC_ParseCSW(p_msc_csw, p_cmd->CSW_Buf);           /* See Note #3.                                         */
+       *p_csw_err = USBH_ERR_NONE;
+        return (USBH_ERR_NONE);
+    }
+
+    Mem_Set((void *)p_msc_csw,
+                    0u,
+                    sizeof(USBH_MSC_CSW));
+
+    if (p_cmd->ErrStage == USBH_MSC_CMD_STAGE_CSW) {
+        USBH_EP_Reset(p_msc_dev->DevPtr,
+                     &p_msc_dev->BulkInEP);                     /* Clear err on host side.                              */
+        if (err != USBH_ERR_EP_STALL) {
+           *p_csw_err = err;
+            return (USBH_ERR_NONE);
+        }
+        (void)USBH_MSC_StallClr(p_msc_dev, &p_msc_dev->BulkInEP);
+    }
+
+   *p_csw_err = USBH_MSC_RxCSW(p_msc_dev, p_msc_csw);
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_PipeRun()
+*
+* Description : Submit the pending stages of a command and check whether the command is complete.
+*
+* Argument(s) : p_cmd           Pointer to command at the head of the device queue.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The task waiting for the command is signaled, or an asynchronous command is ended
+*                   (see USBH_MSC_PipeAsyncEnd()) :
+*
+*                   (a) When the first error is reported. The engine is halted on the command until it is
+*                       released, after the device is recovered.
+*
+*                   (b) When the CSW is received and no URB of the command is in progress. If the CSW is
+*                       valid, the command is removed from the queue and the next command is started
+*                       immediately, from this context.
+*
+*                   (c) When the CSW was received in place of data while URBs are still queued behind it.
+*                       These URBs are aborted (see USBH_MSC_PipeAbort()).
+*
+*                   (d) When the last aborted URB is completed, unless USBH_MSC_PipeAbort() is still
+*                       aborting URBs.
+*
+*               (2) The validation of the CSW matches USBH_MSC_XferCmd(), which issues a reset recovery
+*                   for the CSWs rejected here.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  USBH_MSC_PipeRun (USBH_MSC_CMD  *p_cmd)
+{
+    USBH_MSC_DEV  *p_msc_dev;
+    USBH_MSC_CMD  *p_cmd_nxt;
+    CPU_BOOLEAN    post;
+    CPU_BOOLEAN    valid;
+    CPU_SR_ALLOC();
+
+
+    USBH_MSC_PipeFill(p_cmd);
+
+    p_msc_dev = p_cmd->MSC_DevPtr;
+    p_cmd_nxt = (USBH_MSC_CMD *)0;
+    post      =  DEF_FALSE;
+
+    CPU_CRITICAL_ENTER();
+    if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_SIGNALED) == DEF_YES) {
+        if ((DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_DRAIN) == DEF_YES) &&
+            (p_cmd->URB_Cnt                                        == 0u)) {
+            DEF_BIT_CLR(p_cmd->Flags, USBH_MSC_CMD_FLAG_DRAIN); /* See Note #1d.                                        */
+            if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_ABORT) == DEF_NO) {
+                post = DEF_TRUE;
+            }
+        }
+
+    } else if (p_cmd->Err != USBH_ERR_NONE) {                   /* See Note #1a.                                        */
+        DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_SIGNALED);
+        post = DEF_TRUE;
+
+    } else if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CSW_RX) == DEF_YES) {
+        if (p_cmd->URB_Cnt == 0u) {                             /* See Note #1b.                                        */
+            DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_SIGNALED);
+            post  = DEF_TRUE;
+                                                                /* See Note #2.                                         */
+            valid = ((MEM_VAL_GET_INT32U_LITTLE(&p_cmd->CSW_Buf[0]) == USBH_MSC_SIG_CSW) &&
+                     (MEM_VAL_GET_INT32U_LITTLE(&p_cmd->CSW_Buf[4]) == p_cmd->Tag)       &&
+                     (p_cmd->CSW_Buf[12] != USBH_MSC_BCSWSTATUS_PHASE_ERROR)) ? DEF_TRUE : DEF_FALSE;
+            if (valid == DEF_TRUE) {
+                DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CLEAN);
+                p_cmd_nxt = USBH_MSC_PipeNxt(p_msc_dev);
+            }
+
+        } else if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_DATA_SHORT) == DEF_YES) {
+            DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_SIGNALED);
+            post = DEF_TRUE;                                    /* See Note #1c.                                        */
+        } else {
+                                                                /* Empty Else Statement                                 */
+        }
+    } else {
+                                                                /* Empty Else Statement                                 */
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (p_cmd_nxt != (USBH_MSC_CMD *)0) {                       /* Start next cmd before waking task.                   */
+        USBH_MSC_PipeRun(p_cmd_nxt);
+    }
+
+    if (post == DEF_TRUE) {
+        if (p_cmd->CmplFnctPtr == (USBH_MSC_XFER_CMPL_FNCT)0) {
+            (void)USBH_OS_SemPost(p_cmd->Sem);
+        } else {
+            USBH_MSC_PipeAsyncEnd(p_cmd);
+        }
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_PipeFill()
+*
+* Description : Submit the stages of a command that can be queued on the bulk endpoints.
+*
+* Argument(s) : p_cmd           Pointer to command.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function is called from the task that starts the command and from the completion
+*                   of its URBs. Only one context submits at a time; a call made meanwhile is executed
+*                   by that context before it returns.
+*
+*               (2) The data stage is split in pieces of at most 'DataBufMaxLen' octets, rounded down to a
+*                   multiple of the maximum packet size, so that the host controller does not truncate a
+*                   transfer and a short packet always ends the data stage.
+*
+*               (3) When the endpoint queue or the extra URBs are exhausted, the remaining stages are
+*                   submitted from the completion of a URB in progress.
+*
+*               (4) The CSW is queued behind the last data IN piece. If the data IN stage ended with a
+*                   short packet, the CSW is submitted only if no data piece is queued, since the next
+*                   piece would receive it.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  USBH_MSC_PipeFill (USBH_MSC_CMD  *p_cmd)
+{
+    USBH_MSC_DEV  *p_msc_dev;
+    USBH_EP       *p_ep_data;
+    CPU_INT32U     piece_len;
+    CPU_INT32U     len;
+    CPU_INT16U     max_pkt_size;
+    CPU_INT16U     flags;
+    CPU_BOOLEAN    csw_rdy;
+    CPU_BOOLEAN    done;
+    USBH_ERR       err;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_FILL) == DEF_YES) {
+        DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_FILL_REQ);
+        CPU_CRITICAL_EXIT();
+        return;
+    }
+    DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_FILL);
+    CPU_CRITICAL_EXIT();
+
+    p_msc_dev = p_cmd->MSC_DevPtr;
+    p_ep_data = (p_cmd->Dir == USBH_MSC_DATA_DIR_IN) ? &p_msc_dev->BulkInEP : &p_msc_dev->BulkOutEP;
+
+    piece_len    = p_msc_dev->DevPtr->HC_Ptr->HC_Drv.HC_CfgPtr->DataBufMaxLen;
+    max_pkt_size = USBH_EP_MaxPktSizeGet(p_ep_data);
+    if (piece_len == 0u) {                                      /* See Note #2.                                         */
+        piece_len = DEF_INT_32U_MAX_VAL;
+    } else if ((max_pkt_size != 0u          ) &&
+               (piece_len    >= max_pkt_size)) {
+        piece_len -= piece_len % max_pkt_size;
+    } else {
+                                                                /* Empty Else Statement                                 */
+    }
+
+    done = DEF_FALSE;
+    while (done == DEF_FALSE) {
+        CPU_CRITICAL_ENTER();
+        DEF_BIT_CLR(p_cmd->Flags, USBH_MSC_CMD_FLAG_FILL_REQ);
+        flags = p_cmd->Flags;
+        err   = p_cmd->Err;
+        CPU_CRITICAL_EXIT();
+
+        if ((err == USBH_ERR_NONE) &&                           /* --------------------- CBW ------------------------- */
+            (DEF_BIT_IS_SET(flags, USBH_MSC_CMD_FLAG_CBW_SUBMIT) == DEF_NO)) {
+            err = USBH_MSC_PipeSubmit(        p_cmd,
+                                             &p_msc_dev->BulkOutEP,
+                                      (void *)p_cmd->CBW_Buf,
+                                              USBH_MSC_LEN_CBW);
+            if (err == USBH_ERR_NONE) {
+                CPU_CRITICAL_ENTER();
+                DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CBW_SUBMIT);
+                CPU_CRITICAL_EXIT();
+            }
+        }
+                                                                /* -------------------- DATA -------------------------- */
+        while ((err                                                == USBH_ERR_NONE) &&
+               (DEF_BIT_IS_SET(flags, USBH_MSC_CMD_FLAG_DATA_SHORT) == DEF_NO)        &&
+               (p_cmd->DataSubmitLen                                <  p_cmd->DataLen)) {
+            len = DEF_MIN(p_cmd->DataLen - p_cmd->DataSubmitLen, piece_len);
+            err = USBH_MSC_PipeSubmit(        p_cmd,
+                                              p_ep_data,
+                                      (void *)(p_cmd->DataPtr + p_cmd->DataSubmitLen),
+                                              len);
+            if (err == USBH_ERR_NONE) {
+                p_cmd->DataSubmitLen += len;
+            }
+        }
+                                                                /* --------------------- CSW -------------------------- */
+        if (p_cmd->Dir == USBH_MSC_DATA_DIR_IN) {               /* See Note #4.                                         */
+            CPU_CRITICAL_ENTER();
+            flags   = p_cmd->Flags;
+            if (DEF_BIT_IS_SET(flags, USBH_MSC_CMD_FLAG_DATA_SHORT) == DEF_YES) {
+                csw_rdy = (p_cmd->DataCmplLen   >= p_cmd->DataSubmitLen) ? DEF_TRUE : DEF_FALSE;
+            } else {
+                csw_rdy = (p_cmd->DataSubmitLen >= p_cmd->DataLen)       ? DEF_TRUE : DEF_FALSE;
+            }
+            CPU_CRITICAL_EXIT();
+        } else {
+            csw_rdy = DEF_TRUE;
+        }
+
+        if ((err                                                == USBH_ERR_NONE) &&
+            (csw_rdy                                            == DEF_TRUE)      &&
+            (DEF_BIT_IS_SET(flags, USBH_MSC_CMD_FLAG_CSW_SUBMIT) == DEF_NO)        &&
+            (DEF_BIT_IS_SET(flags, USBH_MSC_CMD_FLAG_CSW_RX)     == DEF_NO)) {
+            err = USBH_MSC_PipeSubmit(        p_cmd,
+                                             &p_msc_dev->BulkInEP,
+                                      (void *)p_cmd->CSW_Buf,
+                                              USBH_MSC_LEN_CSW);
+            if (err == USBH_ERR_NONE) {
+                CPU_CRITICAL_ENTER();
+                DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CSW_SUBMIT);
+                CPU_CRITICAL_EXIT();
+            }
+        }
+
+        CPU_CRITICAL_ENTER();
+        if ((err == USBH_ERR_EP_QUEUE_FULL) ||                  /* See Note #3.                                         */
+            (err == USBH_ERR_ALLOC)) {
+            if (p_cmd->URB_Cnt > 0u) {
+                err = USBH_ERR_NONE;
+            }
+        }
+        if ((err        != USBH_ERR_NONE) &&
+            (p_cmd->Err == USBH_ERR_NONE)) {
+            p_cmd->Err = err;
+        }
+        if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_FILL_REQ) == DEF_NO) {
+            DEF_BIT_CLR(p_cmd->Flags, USBH_MSC_CMD_FLAG_FILL);
+            done = DEF_TRUE;
+        }
+        CPU_CRITICAL_EXIT();
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_PipeSubmit()
+*
+* Description : Submit one stage, or one piece of the data stage, of a command.
+*
+* Argument(s) : p_cmd           Pointer to command.
+*
+*               p_ep            Pointer to bulk endpoint.
+*
+*               p_buf           Pointer to buffer.
+*
+*               len             Buffer length in octets.
+*
+* Return(s)   : USBH_ERR_NONE,                          if transfer successfully submitted.
+*
+*                                                       ----- RETURNED BY USBH_BulkTxAsync() : -----
+*                                                       ----- RETURNED BY USBH_BulkRxAsync() : -----
+*               USBH_ERR_EP_QUEUE_FULL,                 if endpoint submission queue is full.
+*               USBH_ERR_ALLOC,                         if URB cannot be allocated.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The URB is accounted before it is submitted, since it may complete before the
+*                   submission returns.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  USBH_MSC_PipeSubmit (USBH_MSC_CMD  *p_cmd,
+                                       USBH_EP       *p_ep,
+                                       void          *p_buf,
+                                       CPU_INT32U     len)
+{
+    USBH_ERR  err;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_cmd->URB_Cnt++;                                           /* See Note #1.                                         */
+    CPU_CRITICAL_EXIT();
+
+    if (p_ep == &p_cmd->MSC_DevPtr->BulkInEP) {
+        err = USBH_BulkRxAsync(p_ep,
+                               p_buf,
+                               len,
+                               USBH_MSC_PipeCmpl,
+                       (void *)p_cmd);
+    } else {
+        err = USBH_BulkTxAsync(p_ep,
+                               p_buf,
+                               len,
+                               USBH_MSC_PipeCmpl,
+                       (void *)p_cmd);
+    }
+
+    if (err != USBH_ERR_NONE) {
+        CPU_CRITICAL_ENTER();
+        p_cmd->URB_Cnt--;
+        CPU_CRITICAL_EXIT();
+    }
+
+    return (err);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_PipeCmpl()
+*
+* Description : Handle the completion of a URB submitted by the pipelined engine.
+*
+* Argument(s) : p_ep            Pointer to endpoint.
+*
+*               p_buf           Pointer to buffer.
+*
+*               buf_len         Buffer length in octets.
+*
+*               xfer_len        Number of octets transferred.
+*
+*               p_arg           Pointer to command.
+*
+*               err             Status of transfer.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The stage is identified by its buffer: the CBW and CSW buffers belong to the command.
+*
+*               (2) A CSW of invalid length is cleared, so that USBH_MSC_XferCmd() rejects it and issues a
+*                   reset recovery, as with USBH_MSC_RxCSW().
+*
+*               (3) After a short packet, the device sends the CSW. A data IN piece queued behind the short
+*                   one receives it.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  void  USBH_MSC_PipeCmpl (USBH_EP     *p_ep,
+                                 void        *p_buf,
+                                 CPU_INT32U   buf_len,
+                                 CPU_INT32U   xfer_len,
+                                 void        *p_arg,
+                                 USBH_ERR     err)
+{
+    USBH_MSC_CMD  *p_cmd;
+    CPU_INT08U     stage;
+    CPU_SR_ALLOC();
+
+
+    (void)p_ep;
+
+    p_cmd = (USBH_MSC_CMD *)p_arg;
+
+    CPU_CRITICAL_ENTER();
+    p_cmd->URB_Cnt--;
+
+    if (p_buf == (void *)p_cmd->CBW_Buf) {                      /* See Note #1.                                         */
+        stage = USBH_MSC_CMD_STAGE_CBW;
+        if ((err == USBH_ERR_NONE) && (xfer_len != USBH_MSC_LEN_CBW)) {
+            err = USBH_ERR_MSC_IO;
+        }
+        if (err == USBH_ERR_NONE) {
+            DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CBW_DONE);
+        }
+
+    } else if (p_buf == (void *)p_cmd->CSW_Buf) {
+        stage = USBH_MSC_CMD_STAGE_CSW;
+        if (err == USBH_ERR_NONE) {
+            if (xfer_len != USBH_MSC_LEN_CSW) {                 /* See Note #2.                                         */
+                Mem_Clr((void *)p_cmd->CSW_Buf,
+                                USBH_MSC_LEN_CSW);
+            }
+            DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CSW_RX);
+        }
+
+    } else {
+        stage               = USBH_MSC_CMD_STAGE_DATA;
+        p_cmd->DataCmplLen += buf_len;
+        if (err == USBH_ERR_NONE) {
+            if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_DATA_SHORT) == DEF_YES) {
+                if (xfer_len == USBH_MSC_LEN_CSW) {             /* See Note #3.                                         */
+                    Mem_Copy((void *)p_cmd->CSW_Buf,
+                                     p_buf,
+                                     USBH_MSC_LEN_CSW);
+                    DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_CSW_RX);
+                } else {
+                    err = USBH_ERR_MSC_IO;
+                }
+            } else {
+                p_cmd->DataXferLen += xfer_len;
+                if (xfer_len < buf_len) {
+                    DEF_BIT_SET(p_cmd->Flags, USBH_MSC_CMD_FLAG_DATA_SHORT);
+                }
+            }
+        }
+    }
+
+    if ((err        != USBH_ERR_NONE) &&                        /* Keep first err.                                      */
+        (p_cmd->Err == USBH_ERR_NONE)) {
+        p_cmd->Err      = err;
+        p_cmd->ErrStage = stage;
+    }
+    CPU_CRITICAL_EXIT();
+
+    USBH_MSC_PipeRun(p_cmd);
+}
+#endif
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_CacheClr()
+*
+* Description : Empty the cache of a device and assign its blocks in the cache arena.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) All blocks are free and linked in the LRU list, the head being the most recently used
+*                   block and the tail the next block to be allocated.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void  USBH_MSC_CacheClr (USBH_MSC_DEV  *p_msc_dev)
+{
+    CPU_INT08U          *p_arena;
+    USBH_MSC_CACHE_BLK  *p_blk;
+    CPU_INT32U           blk_ix;
+
+
+    p_arena = &USBH_MSC_CacheArena[p_msc_dev - &USBH_MSC_DevArr[0]][0];
+
+    p_msc_dev->CacheHeadPtr = (USBH_MSC_CACHE_BLK *)0;
+    p_msc_dev->CacheTailPtr = (USBH_MSC_CACHE_BLK *)0;
+    for (blk_ix = 0u; blk_ix < USBH_MSC_CFG_CACHE_BLK_NBR; blk_ix++) {
+        p_blk          = &p_msc_dev->CacheBlkTbl[blk_ix];
+        p_blk->BlkAddr =  0u;
+        p_blk->DataPtr = &p_arena[blk_ix * USBH_MSC_CFG_CACHE_BLK_SIZE];
+        p_blk->LUN     =  0u;
+        p_blk->State   =  USBH_MSC_CACHE_BLK_STATE_FREE;
+        p_blk->PrevPtr =  p_msc_dev->CacheTailPtr;              /* Append blk to LRU list (see Note #1).                */
+        p_blk->NxtPtr  = (USBH_MSC_CACHE_BLK *)0;
+        if (p_msc_dev->CacheTailPtr != (USBH_MSC_CACHE_BLK *)0) {
+            p_msc_dev->CacheTailPtr->NxtPtr = p_blk;
+        } else {
+            p_msc_dev->CacheHeadPtr = p_blk;
+        }
+        p_msc_dev->CacheTailPtr = p_blk;
+    }
+                                                                /* Xfer buf follows cached blks.                        */
+    p_msc_dev->CacheXferBufPtr = &p_arena[USBH_MSC_CFG_CACHE_BLK_NBR * USBH_MSC_CFG_CACHE_BLK_SIZE];
+    p_msc_dev->CacheBlkSize    =  0u;
+    p_msc_dev->CacheSeqLUN     =  0u;
+    p_msc_dev->CacheSeqBlkAddr =  0u;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_MSC_CacheBlkFind()
+*
+* Description : Find a block in the cache.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+*               blk_addr        Block address.
+*
+* Return(s)   : Pointer to cached block, if found.
+*
+*               0,                       otherwise.
+*
+* Note(s)     : (1) The cache is searched linearly. It is meant to hold a few tens of blocks.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  USBH_MSC_CACHE_BLK  *USBH_MSC_CacheBlkFind (USBH_MSC_DEV  *p_msc_dev,
+                                                    CPU_INT08U     lun,
+                                                    CPU_INT64U     blk_addr)
+{
+    USBH_MSC_CACHE_BLK  *p_blk;
+    CPU_INT32U           blk_ix;
+
+
+    for (blk_ix = 0u; blk_ix < USBH_MSC_CFG_CACHE_BLK_NBR; blk_ix++) {
+        p_blk = &p_msc_dev->CacheBlkTbl[blk_ix];
+        if ((p_blk->State   != USBH_MSC_CACHE_BLK_STATE_FREE) &&
+            (p_blk->BlkAddr == blk_addr                     ) &&
+            (p_blk->LUN     == lun                          )) {
+            return (p_blk);
+        }
+    }
+
+    return ((USBH_MSC_CACHE_BLK *)0);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_MSC_CacheBlkUse()
+*
+* Description : Move a block to the head of the LRU list.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_blk           Pointer to cached block.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
 
-        default:
-            *p_err = USBH_ERR_NONE;
-             break;
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void  USBH_MSC_CacheBlkUse (USBH_MSC_DEV        *p_msc_dev,
+                                    USBH_MSC_CACHE_BLK  *p_blk)
+{
+    if (p_blk == p_msc_dev->CacheHeadPtr) {
+        return;
     }
-
-    if (*p_err != USBH_ERR_NONE) {
-        return (0u);
+                                                                /* Unlink blk.                                          */
+    p_blk->PrevPtr->NxtPtr = p_blk->NxtPtr;
+    if (p_blk->NxtPtr != (USBH_MSC_CACHE_BLK *)0) {
+        p_blk->NxtPtr->PrevPtr = p_blk->PrevPtr;
+    } else {
+        p_msc_dev->CacheTailPtr = p_blk->PrevPtr;
     }
+                                                                /* Insert blk at head.                                  */
+    p_blk->PrevPtr                  = (USBH_MSC_CACHE_BLK *)0;
+    p_blk->NxtPtr                   =  p_msc_dev->CacheHeadPtr;
+    p_msc_dev->CacheHeadPtr->PrevPtr =  p_blk;
+    p_msc_dev->CacheHeadPtr          =  p_blk;
+}
+#endif
 
-    Mem_Set((void *)&msc_csw,
-                     0u,
-                     USBH_MSC_LEN_CSW);
 
-    *p_err = USBH_MSC_RxCSW(p_msc_dev, &msc_csw);               /* Receive CSW.                                         */
+/*
+*********************************************************************************************************
+*                                      USBH_MSC_CacheBlkInval()
+*
+* Description : Free a cached block and move it to the tail of the LRU list, so that it is allocated next.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_blk           Pointer to cached block.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The content of a dirty block is lost.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void  USBH_MSC_CacheBlkInval (USBH_MSC_DEV        *p_msc_dev,
+                                      USBH_MSC_CACHE_BLK  *p_blk)
+{
+    p_blk->State = USBH_MSC_CACHE_BLK_STATE_FREE;
 
-    if ((msc_csw.dCSWSignature != USBH_MSC_SIG_CSW               ) ||
-        (msc_csw.bCSWStatus    == USBH_MSC_BCSWSTATUS_PHASE_ERROR) ||
-        (msc_csw.dCSWTag       != msc_cbw.dCBWTag                )) {
-        USBH_MSC_ResetRecovery(p_msc_dev);                      /* Invalid CSW, issue reset recovery.                   */
+    if (p_blk == p_msc_dev->CacheTailPtr) {
+        return;
     }
+                                                                /* Unlink blk.                                          */
+    p_blk->NxtPtr->PrevPtr = p_blk->PrevPtr;
+    if (p_blk->PrevPtr != (USBH_MSC_CACHE_BLK *)0) {
+        p_blk->PrevPtr->NxtPtr = p_blk->NxtPtr;
+    } else {
+        p_msc_dev->CacheHeadPtr = p_blk->NxtPtr;
+    }
+                                                                /* Insert blk at tail.                                  */
+    p_blk->NxtPtr                   = (USBH_MSC_CACHE_BLK *)0;
+    p_blk->PrevPtr                  =  p_msc_dev->CacheTailPtr;
+    p_msc_dev->CacheTailPtr->NxtPtr  =  p_blk;
+    p_msc_dev->CacheTailPtr          =  p_blk;
+}
+#endif
 
-    if (*p_err == USBH_ERR_NONE) {
-        switch (msc_csw.bCSWStatus) {
-            case USBH_MSC_BCSWSTATUS_CMD_PASSED:
-                *p_err = USBH_ERR_NONE;
-                 break;
 
-            case USBH_MSC_BCSWSTATUS_CMD_FAILED:
-                *p_err = USBH_ERR_MSC_CMD_FAILED;
-                 break;
+/*
+*********************************************************************************************************
+*                                      USBH_MSC_CacheBlkAlloc()
+*
+* Description : Allocate the least recently used block of the cache.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               p_err           Pointer to variable that will receive the return error code from this function :
+*
+*                                   USBH_ERR_NONE,          Block allocated.
+*
+*                                                           ----- RETURNED BY USBH_MSC_CacheWrBack() : -----
+*                                   USBH_ERR_MSC_IO,        Unable to write back the evicted block.
+*                                   Other error codes,      See USBH_MSC_SCSI_RdWr().
+*
+* Return(s)   : Pointer to allocated block, if no error.
+*
+*               0,                            otherwise.
+*
+* Note(s)     : (1) The allocated block is free and becomes the head of the LRU list. Consecutive calls
+*                   therefore allocate different blocks, and the blocks allocated last are found from the
+*                   head of the list, the most recent first.
+*********************************************************************************************************
+*/
 
-            case USBH_MSC_BCSWSTATUS_PHASE_ERROR:
-                *p_err = USBH_ERR_MSC_CMD_PHASE;
-                 break;
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  USBH_MSC_CACHE_BLK  *USBH_MSC_CacheBlkAlloc (USBH_MSC_DEV  *p_msc_dev,
+                                                     USBH_ERR      *p_err)
+{
+    USBH_MSC_CACHE_BLK  *p_blk;
 
-            default:
-                *p_err = USBH_ERR_MSC_CMD_FAILED;
-                 break;
+
+    p_blk = p_msc_dev->CacheTailPtr;
+    if (p_blk->State == USBH_MSC_CACHE_BLK_STATE_DIRTY) {       /* Write back evicted blk.                              */
+        USBH_MSC_CacheWrBack(p_msc_dev, p_blk, p_err);
+        if (*p_err != USBH_ERR_NONE) {
+            return ((USBH_MSC_CACHE_BLK *)0);
         }
     } else {
-       *p_err = USBH_ERR_MSC_IO;
+       *p_err = USBH_ERR_NONE;
     }
 
-                                                                /* Actual len of data xfered to dev.                    */
-    xfer_len = msc_cbw.dCBWDataTransferLength - msc_csw.dCSWDataResidue;
+    p_blk->State = USBH_MSC_CACHE_BLK_STATE_FREE;
+    USBH_MSC_CacheBlkUse(p_msc_dev, p_blk);                     /* See Note #1.                                         */
 
-    return (xfer_len);
+    return (p_blk);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_MSC_TxCBW()
+*                                       USBH_MSC_CacheWrBack()
 *
-* Description : Send Command Block Wrapper (CBW) to device through bulk OUT endpoint.
+* Description : Write a dirty block back to the device, along with the adjacent dirty blocks.
 *
 * Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-*               p_msc_cbw       Pointer to Command Block Wrapper (CBW).
+*               p_blk           Pointer to dirty block.
 *
-* Return(s)   : USBH_ERR_NONE                           If CBW successfully transmitted.
+*               p_err           Pointer to variable that will receive the return error code from this function :
 *
-*                                                       ----- RETURNED BY USBH_BulkTx() : -----
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               Host controller drivers error code,     Otherwise.
+*                                   USBH_ERR_NONE,          Blocks written back.
+*                                   USBH_ERR_MSC_IO,        Device accepted fewer blocks than written.
 *
-* Note(s)     : None.
+*                                                           ----- RETURNED BY USBH_MSC_SCSI_RdWr() : -----
+*                                   USBH_ERR_MSC_CMD_FAILED,    Device reports command failed (see Note #2).
+*                                   Other error codes,      See USBH_MSC_SCSI_RdWr().
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The dirty blocks of the same LUN that precede and follow the block are written by the
+*                   same command, up to USBH_MSC_CFG_CACHE_XFER_BLK_NBR blocks. They are gathered in the
+*                   transfer buffer of the cache.
+*
+*               (2) Blocks rejected by the device are dropped, since writing them again would fail again;
+*                   the error is returned to the caller. After any other error, the blocks stay dirty.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_MSC_TxCBW (USBH_MSC_DEV  *p_msc_dev,
-                                  USBH_MSC_CBW  *p_msc_cbw)
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void  USBH_MSC_CacheWrBack (USBH_MSC_DEV        *p_msc_dev,
+                                    USBH_MSC_CACHE_BLK  *p_blk,
+                                    USBH_ERR            *p_err)
 {
-    CPU_INT08U  cmd_buf[USBH_MSC_LEN_CBW];
-    USBH_ERR    err;
-    CPU_INT32U  len;
-
+    USBH_MSC_CACHE_BLK  *p_blk_adj;
+    CPU_INT64U           blk_addr;
+    CPU_INT32U           nbr_blks;
+    CPU_INT32U           blk_size;
+    CPU_INT32U           blk_ix;
+    CPU_INT32U           xfer_len;
+    CPU_INT08U           lun;
+
+
+    lun      = p_blk->LUN;
+    blk_addr = p_blk->BlkAddr;
+    nbr_blks = 1u;
+    blk_size = p_msc_dev->CacheBlkSize;
+                                                                /* Coalesce preceding dirty blks (see Note #1).         */
+    while ((nbr_blks < USBH_MSC_CFG_CACHE_XFER_BLK_NBR) &&
+           (blk_addr > 0u                             )) {
+        p_blk_adj = USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr - 1u);
+        if ((p_blk_adj        == (USBH_MSC_CACHE_BLK *)0) ||
+            (p_blk_adj->State != USBH_MSC_CACHE_BLK_STATE_DIRTY)) {
+            break;
+        }
+        blk_addr--;
+        nbr_blks++;
+    }
+                                                                /* Coalesce following dirty blks.                       */
+    while (nbr_blks < USBH_MSC_CFG_CACHE_XFER_BLK_NBR) {
+        p_blk_adj = USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr + nbr_blks);
+        if ((p_blk_adj        == (USBH_MSC_CACHE_BLK *)0) ||
+            (p_blk_adj->State != USBH_MSC_CACHE_BLK_STATE_DIRTY)) {
+            break;
+        }
+        nbr_blks++;
+    }
 
-    Mem_Clr((void *)cmd_buf,
-                    USBH_MSC_LEN_CBW);
+    for (blk_ix = 0u; blk_ix < nbr_blks; blk_ix++) {            /* Gather blks in xfer buf.                             */
+        p_blk_adj = USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr + blk_ix);
+        Mem_Copy((void *)&p_msc_dev->CacheXferBufPtr[blk_ix * blk_size],
+                 (void *) p_blk_adj->DataPtr,
+                          blk_size);
+    }
 
-    USBH_MSC_FmtCBW(p_msc_cbw, cmd_buf);                        /* Format CBW.                                          */
+    xfer_len = USBH_MSC_SCSI_RdWr(        p_msc_dev,
+                                          lun,
+                                          USBH_MSC_DATA_DIR_OUT,
+                                          blk_addr,
+                                          nbr_blks,
+                                          blk_size,
+                                  (void *)p_msc_dev->CacheXferBufPtr,
+                                          p_err);
+    if ((*p_err   == USBH_ERR_NONE          ) &&
+        ( xfer_len != (nbr_blks * blk_size))) {
+       *p_err = USBH_ERR_MSC_IO;
+    }
 
-    len = USBH_BulkTx(        &p_msc_dev->BulkOutEP,            /* Send CBW through bulk OUT EP.                        */
-                      (void *)&cmd_buf[0],
-                               USBH_MSC_LEN_CBW,
-                               USBH_MSC_TIMEOUT,
-                              &err);
-    if (len != USBH_MSC_LEN_CBW) {
-        if (err != USBH_ERR_NONE) {
-            USBH_PRINT_ERR(err);
-            USBH_EP_Reset(p_msc_dev->DevPtr,
-                         &p_msc_dev->BulkOutEP);                /* Clear EP err on host side.                           */
-        }
+    if (*p_err == USBH_ERR_NONE) {
+        p_msc_dev->CacheStat.WrBackCnt += nbr_blks;
+        p_msc_dev->CacheStat.WrBackCmdCnt++;
+    } else if (*p_err != USBH_ERR_MSC_CMD_FAILED) {             /* See Note #2.                                         */
+        return;
+    }
 
-        if (err == USBH_ERR_EP_STALL) {
-            USBH_MSC_ResetRecovery(p_msc_dev);
+    for (blk_ix = 0u; blk_ix < nbr_blks; blk_ix++) {
+        p_blk_adj = USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr + blk_ix);
+        if (*p_err == USBH_ERR_NONE) {
+            p_blk_adj->State = USBH_MSC_CACHE_BLK_STATE_CLEAN;
+        } else {
+            USBH_MSC_CacheBlkInval(p_msc_dev, p_blk_adj);
         }
-    } else {
-        err = USBH_ERR_NONE;
     }
-
-    return (err);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_MSC_RxCSW()
+*                                        USBH_MSC_CacheSync()
 *
-* Description : Receive Command Status Word (CSW) from device through bulk IN endpoint.
+* Description : Write back or invalidate the cached blocks of a range.
 *
 * Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-*               p_msc_csw       Pointer to Command Status Word (CSW).
+*               lun             Logical unit number.
 *
-* Return(s)   : USBH_ERR_NONE,                          If CSW successfully received.
+*               blk_addr        Address of first block of the range.
 *
-*                                                       ----- RETURNED BY USBH_BulkRx() : -----
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               Host controller drivers error code,     Otherwise.
+*               nbr_blks        Number of blocks of the range.
 *
-* Note(s)     : None.
+*               inval           DEF_FALSE, to write back the dirty blocks of the range.
+*                               DEF_TRUE,  to invalidate all blocks of the range (see Note #1).
+*
+*               p_err           Pointer to variable that will receive the return error code from this function :
+*
+*                                   USBH_ERR_NONE,          Range synchronized.
+*
+*                                                           ----- RETURNED BY USBH_MSC_CacheWrBack() : -----
+*                                   USBH_ERR_MSC_IO,        Device accepted fewer blocks than written.
+*                                   Other error codes,      See USBH_MSC_SCSI_RdWr().
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Blocks are invalidated before the range is written directly to the device, so dirty
+*                   blocks are not written back.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_MSC_RxCSW (USBH_MSC_DEV  *p_msc_dev,
-                                  USBH_MSC_CSW  *p_msc_csw)
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void  USBH_MSC_CacheSync (USBH_MSC_DEV  *p_msc_dev,
+                                  CPU_INT08U     lun,
+                                  CPU_INT64U     blk_addr,
+                                  CPU_INT64U     nbr_blks,
+                                  CPU_BOOLEAN    inval,
+                                  USBH_ERR      *p_err)
 {
-    CPU_INT32U  retry;
-    CPU_INT08U  status_buf[USBH_MSC_LEN_CSW];
-    USBH_ERR    err;
-    CPU_INT32U  len;
+    USBH_MSC_CACHE_BLK  *p_blk;
+    CPU_INT32U           blk_ix;
 
 
-    err   = USBH_ERR_NONE;
-    retry = 2u;
+   *p_err = USBH_ERR_NONE;
 
-                                                                /* Receive CSW from dev through bulk IN EP.             */
-    while (retry > 0u) {
-        len = USBH_BulkRx(        &p_msc_dev->BulkInEP,
-                          (void *)&status_buf[0],
-                                   USBH_MSC_LEN_CSW,
-                                   USBH_MSC_TIMEOUT,
-                                  &err);
-        if (len != USBH_MSC_LEN_CSW) {
-            USBH_EP_Reset(p_msc_dev->DevPtr,
-                         &p_msc_dev->BulkInEP);                 /* Clear err on host side.                              */
+    for (blk_ix = 0u; blk_ix < USBH_MSC_CFG_CACHE_BLK_NBR; blk_ix++) {
+        p_blk = &p_msc_dev->CacheBlkTbl[blk_ix];
+        if ((p_blk->State               == USBH_MSC_CACHE_BLK_STATE_FREE) ||
+            (p_blk->LUN                 != lun                          ) ||
+            ((p_blk->BlkAddr - blk_addr) >= nbr_blks                    )) {
+            continue;
+        }
 
-            if (err == USBH_ERR_EP_STALL) {
-                (void)USBH_EP_StallClr(&p_msc_dev->BulkInEP);
-                retry--;
-            } else {
-                break;
+        if (inval == DEF_TRUE) {
+            USBH_MSC_CacheBlkInval(p_msc_dev, p_blk);
+        } else if (p_blk->State == USBH_MSC_CACHE_BLK_STATE_DIRTY) {
+            USBH_MSC_CacheWrBack(p_msc_dev, p_blk, p_err);
+            if (*p_err != USBH_ERR_NONE) {
+                return;
             }
         } else {
-            err = USBH_ERR_NONE;
-            USBH_MSC_ParseCSW(p_msc_csw, status_buf);
-            break;
+                                                                /* Empty Else Statement                                 */
         }
     }
-
-    return (err);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_MSC_TxData()
+*                                     USBH_MSC_CacheBlkSizeSet()
 *
-* Description : Send data to device through bulk OUT endpoint.
+* Description : Set the size of the cached blocks. If it changes, the cache is written back and emptied.
 *
-* Argument(s) : p_msc_dev        Pointer to MSC device.
+* Argument(s) : p_msc_dev       Pointer to MSC device.
 *
-*               p_arg            Pointer to data buffer.
+*               blk_size        Block size of the request.
 *
-*               data_len         Length of data buffer in octets.
+*               p_err           Pointer to variable that will receive the return error code from this function :
 *
-* Return(s)   : USBH_ERR_NONE,                          if data successfully transmitted.
+*                                   USBH_ERR_NONE,          Block size set.
 *
-*                                                       ----- RETURNED BY USBH_BulkTx() : -----
-*               USBH_ERR_NONE                           Bulk transfer successfully transmitted.
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               USBH_ERR_NONE,                          URB is successfully submitted to host controller.
-*               Host controller drivers error code,     Otherwise.
+*                                                           ----- RETURNED BY USBH_MSC_CacheWrBack() : -----
+*                                   USBH_ERR_MSC_IO,        Device accepted fewer blocks than written.
+*                                   Other error codes,      See USBH_MSC_SCSI_RdWr().
 *
-* Note(s)     : None.
+* Return(s)   : None.
+*
+* Note(s)     : (1) The block size only changes if the medium changes. Blocks larger than
+*                   USBH_MSC_CFG_CACHE_BLK_SIZE are not cached, and the cache is left empty.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_MSC_TxData (USBH_MSC_DEV  *p_msc_dev,
-                                   void          *p_arg,
-                                   CPU_INT32U     data_len)
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void  USBH_MSC_CacheBlkSizeSet (USBH_MSC_DEV  *p_msc_dev,
+                                        CPU_INT32U     blk_size,
+                                        USBH_ERR      *p_err)
 {
-    USBH_ERR      err;
-    CPU_BOOLEAN   retry;
-    CPU_INT08U   *p_data_08;
-    CPU_INT16U    retry_cnt;
-    CPU_INT32U    p_data_ix;
-    CPU_INT32U    data_len_rem;
-    CPU_INT32U    data_len_tx;
+    USBH_MSC_CACHE_BLK  *p_blk;
+    CPU_INT32U           blk_ix;
 
 
-    err          =  USBH_ERR_NONE;
-    p_data_ix    =  0u;
-    p_data_08    = (CPU_INT08U *)p_arg;
-    data_len_rem =  data_len;
-    retry_cnt    =  0u;
-    retry        =  DEF_TRUE;
+   *p_err = USBH_ERR_NONE;
 
-    while ((data_len_rem  > 0u      ) &&
-           (retry        == DEF_TRUE)) {
+    if (blk_size == p_msc_dev->CacheBlkSize) {
+        return;
+    }
 
-        data_len_tx = USBH_BulkTx(        &p_msc_dev->BulkOutEP,
-                                  (void *)(p_data_08 + p_data_ix),
-                                           data_len_rem,
-                                           USBH_MSC_TIMEOUT,
-                                          &err);
-        switch (err) {
-            case USBH_ERR_DEV_NOT_RESPONDING:
-            case USBH_ERR_HC_IO:
-                 retry_cnt++;
-                 if (retry_cnt >= USBH_MSC_MAX_TRANSFER_RETRY) {
-                     retry = DEF_FALSE;
-                 }
-                 break;
+    for (blk_ix = 0u; blk_ix < USBH_MSC_CFG_CACHE_BLK_NBR; blk_ix++) {
+        p_blk = &p_msc_dev->CacheBlkTbl[blk_ix];
+        if (p_blk->State == USBH_MSC_CACHE_BLK_STATE_DIRTY) {   /* Write back blks of previous size.                    */
+            USBH_MSC_CacheWrBack(p_msc_dev, p_blk, p_err);
+            if (*p_err != USBH_ERR_NONE) {
+                return;
+            }
+        }
+    }
 
-            case USBH_ERR_NONE:
-                 if (data_len_tx < data_len_rem) {
-                     data_len_rem -= data_len_tx;
-                     p_data_ix    += data_len_tx;
-                 } else {
-                     data_len_rem = 0u;
-                 }
-                 break;
+    USBH_MSC_CacheClr(p_msc_dev);
+    if (blk_size <= USBH_MSC_CFG_CACHE_BLK_SIZE) {              /* See Note #1.                                         */
+        p_msc_dev->CacheBlkSize = blk_size;
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_CacheFill()
+*
+* Description : Read blocks from the device into the cache.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+*               blk_addr        Address of first block.
+*
+*               nbr_blks        Number of blocks, at most USBH_MSC_CFG_CACHE_XFER_BLK_NBR (see Note #1).
+*
+*               p_err           Pointer to variable that will receive the return error code from this function :
+*
+*                                   USBH_ERR_NONE,          Blocks read.
+*                                   USBH_ERR_MSC_IO,        Device returned fewer blocks than requested.
+*
+*                                                           ----- RETURNED BY USBH_MSC_SCSI_RdWr() : -----
+*                                   Other error codes,      See USBH_MSC_SCSI_RdWr().
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The blocks must not be cached already. They are read by a single request into the
+*                   transfer buffer of the cache, then copied to the allocated blocks. The transfer buffer
+*                   is left holding the blocks read.
+*
+*               (2) Blocks are allocated before the read, since evicting a dirty block uses the transfer
+*                   buffer (see USBH_MSC_CacheBlkAlloc() Note #1).
+*********************************************************************************************************
+*/
 
-            default:
-                 retry = DEF_FALSE;
-                 break;
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  void  USBH_MSC_CacheFill (USBH_MSC_DEV  *p_msc_dev,
+                                  CPU_INT08U     lun,
+                                  CPU_INT64U     blk_addr,
+                                  CPU_INT32U     nbr_blks,
+                                  USBH_ERR      *p_err)
+{
+    USBH_MSC_CACHE_BLK  *p_blk;
+    USBH_MSC_CACHE_BLK  *p_blk_nxt;
+    CPU_INT32U           alloc_nbr;
+    CPU_INT32U           blk_size;
+    CPU_INT32U           xfer_len;
+
+
+    blk_size = p_msc_dev->CacheBlkSize;
+   *p_err    = USBH_ERR_NONE;
+                                                                /* Alloc blks (see Note #2).                            */
+    for (alloc_nbr = 0u; alloc_nbr < nbr_blks; alloc_nbr++) {
+        (void)USBH_MSC_CacheBlkAlloc(p_msc_dev, p_err);
+        if (*p_err != USBH_ERR_NONE) {
+            break;
         }
     }
 
-    if (err != USBH_ERR_NONE) {
-        USBH_PRINT_ERR(err);
+    if (*p_err == USBH_ERR_NONE) {
+        xfer_len = USBH_MSC_SCSI_RdWr(        p_msc_dev,
+                                              lun,
+                                              USBH_MSC_DATA_DIR_IN,
+                                              blk_addr,
+                                              nbr_blks,
+                                              blk_size,
+                                      (void *)p_msc_dev->CacheXferBufPtr,
+                                              p_err);
+        if ((*p_err   == USBH_ERR_NONE          ) &&
+            ( xfer_len != (nbr_blks * blk_size))) {
+           *p_err = USBH_ERR_MSC_IO;
+        }
+    }
 
-        USBH_EP_Reset(p_msc_dev->DevPtr,
-                     &p_msc_dev->BulkOutEP);
-        if (err == USBH_ERR_EP_STALL) {
-            (void)USBH_EP_StallClr(&p_msc_dev->BulkOutEP);
+    p_blk = p_msc_dev->CacheHeadPtr;                            /* Alloc'd blks are at head of LRU list, last first.    */
+    while (alloc_nbr > 0u) {
+        alloc_nbr--;
+        p_blk_nxt = p_blk->NxtPtr;
+        if (*p_err == USBH_ERR_NONE) {
+            p_blk->BlkAddr = blk_addr + alloc_nbr;
+            p_blk->LUN     = lun;
+            p_blk->State   = USBH_MSC_CACHE_BLK_STATE_CLEAN;
+            Mem_Copy((void *) p_blk->DataPtr,
+                     (void *)&p_msc_dev->CacheXferBufPtr[alloc_nbr * blk_size],
+                              blk_size);
         } else {
-            (void)USBH_MSC_ResetRecovery(p_msc_dev);
+            USBH_MSC_CacheBlkInval(p_msc_dev, p_blk);
         }
+        p_blk = p_blk_nxt;
     }
-
-    return (err);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                          USBH_MSC_RxData()
+*                                         USBH_MSC_CacheRd()
 *
-* Description : Receive data from device through bulk IN endpoint.
+* Description : Read specified number of blocks through the cache.
 *
 * Argument(s) : p_msc_dev        Pointer to MSC device.
 *
+*               lun              Logical unit number.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to read.
+*
+*               blk_size         Block size.
+*
 *               p_arg            Pointer to data buffer.
 *
-*               data_len         Length of data buffer in octets.
+*               p_err   Pointer to variable that will receive the return error code from this function :
 *
-* Return(s)   : USBH_ERR_NONE,                          if data successfully received.
+*                       USBH_ERR_NONE                           Block(s) read successfully.
+*                       USBH_ERR_MSC_IO                         Device returned fewer blocks than requested.
 *
-*                                                       ----- RETURNED BY USBH_BulkRx() : -----
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               Host controller drivers error code,     Otherwise.
+*                                                               ---- RETURNED BY USBH_MSC_SCSI_RdWr ----
+*                       Other error codes,                      See USBH_MSC_SCSI_RdWr().
 *
-* Note(s)     : None.
+* Return(s)   : Number of octets read.
+*
+* Note(s)     : (1) Reads of more than USBH_MSC_CFG_CACHE_XFER_BLK_NBR blocks, or of blocks larger than
+*                   USBH_MSC_CFG_CACHE_BLK_SIZE, are issued directly to the device, after the dirty blocks
+*                   of the range are written back.
+*
+*               (2) Each run of blocks missing from the cache is read by a single request. A read that
+*                   starts at the block following the previous read of the same LUN is sequential: when
+*                   its last blocks are missing, the following blocks are read ahead by the same request,
+*                   up to USBH_MSC_CFG_CACHE_XFER_BLK_NBR blocks or the first cached block.
+*
+*               (3) Read-ahead past the end of the medium fails. The request is then issued again,
+*                   without read-ahead.
+*
+*               (4) As with USBH_MSC_SCSI_RdWr(), 0 is returned if a command fails.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_MSC_RxData (USBH_MSC_DEV  *p_msc_dev,
-                                   void          *p_arg,
-                                   CPU_INT32U     data_len)
-
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  CPU_INT32U  USBH_MSC_CacheRd (USBH_MSC_DEV  *p_msc_dev,
+                                      CPU_INT08U     lun,
+                                      CPU_INT64U     blk_addr,
+                                      CPU_INT32U     nbr_blks,
+                                      CPU_INT32U     blk_size,
+                                      void          *p_arg,
+                                      USBH_ERR      *p_err)
 {
-    USBH_ERR      err;
-    CPU_BOOLEAN   retry;
-    CPU_INT08U   *p_data_08;
-    CPU_INT16U    retry_cnt;
-    CPU_INT32U    p_data_ix;
-    CPU_INT32U    data_len_rem;
-    CPU_INT32U    data_len_rx;
-
+    USBH_MSC_CACHE_BLK  *p_blk;
+    CPU_INT08U          *p_buf;
+    CPU_BOOLEAN          seq;
+    CPU_INT32U           blk_ix;
+    CPU_INT32U           miss_nbr;
+    CPU_INT32U           fetch_nbr;
+    CPU_INT32U           xfer_len;
 
-    err          =  USBH_ERR_NONE;
-    p_data_ix    =  0u;
-    p_data_08    = (CPU_INT08U *)p_arg;
-    data_len_rem =  data_len;
-    retry_cnt    =  0u;
-    retry        =  DEF_TRUE;
 
-    while ((data_len_rem  > 0u      ) &&
-           (retry        == DEF_TRUE)) {
+    USBH_MSC_CacheBlkSizeSet(p_msc_dev, blk_size, p_err);
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
+    }
 
-        data_len_rx = USBH_BulkRx(        &p_msc_dev->BulkInEP,
-                                  (void *)(p_data_08 + p_data_ix),
-                                           data_len_rem,
-                                           USBH_MSC_TIMEOUT,
-                                          &err);
-        switch (err) {
-            case USBH_ERR_DEV_NOT_RESPONDING:
-            case USBH_ERR_HC_IO:
-                 retry_cnt++;
-                 if (retry_cnt >= USBH_MSC_MAX_TRANSFER_RETRY) {
-                     retry = DEF_FALSE;
-                 }
-                 break;
+    if ((blk_size == 0u                             ) ||        /* See Note #1.                                         */
+        (blk_size >  USBH_MSC_CFG_CACHE_BLK_SIZE    ) ||
+        (nbr_blks >  USBH_MSC_CFG_CACHE_XFER_BLK_NBR)) {
+        p_msc_dev->CacheStat.BypassCnt++;
+        USBH_MSC_CacheSync(p_msc_dev,
+                           lun,
+                           blk_addr,
+                           nbr_blks,
+                           DEF_FALSE,
+                           p_err);
+        if (*p_err != USBH_ERR_NONE) {
+            return (0u);
+        }
 
-            case USBH_ERR_NONE:
-                 if (data_len_rx < data_len_rem) {
-                     data_len_rem -= data_len_rx;               /* Update remaining nbr of octets to read.              */
-                     p_data_ix    += data_len_rx;               /* Update buf ix.                                       */
-                 } else {
-                     data_len_rem = 0u;
-                 }
-                 break;
+        xfer_len = USBH_MSC_SCSI_RdWr(p_msc_dev,
+                                      lun,
+                                      USBH_MSC_DATA_DIR_IN,
+                                      blk_addr,
+                                      nbr_blks,
+                                      blk_size,
+                                      p_arg,
+                                      p_err);
+        return (xfer_len);
+    }
 
-            default:
-                 retry = DEF_FALSE;
-                 break;
+    seq    = ((lun      == p_msc_dev->CacheSeqLUN    ) &&
+              (blk_addr == p_msc_dev->CacheSeqBlkAddr)) ? DEF_TRUE : DEF_FALSE;
+    p_buf  = (CPU_INT08U *)p_arg;
+    blk_ix =  0u;
+
+    while (blk_ix < nbr_blks) {
+        p_blk = USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr + blk_ix);
+        if (p_blk != (USBH_MSC_CACHE_BLK *)0) {                 /* ----------------------- HIT ------------------------ */
+            Mem_Copy((void *)&p_buf[blk_ix * blk_size],
+                     (void *) p_blk->DataPtr,
+                              blk_size);
+            USBH_MSC_CacheBlkUse(p_msc_dev, p_blk);
+            p_msc_dev->CacheStat.RdHitCnt++;
+            blk_ix++;
+            continue;
+        }
+                                                                /* ----------------------- MISS ----------------------- */
+        miss_nbr = 1u;                                          /* See Note #2.                                         */
+        while (((blk_ix + miss_nbr) < nbr_blks) &&
+               (USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr + blk_ix + miss_nbr) == (USBH_MSC_CACHE_BLK *)0)) {
+            miss_nbr++;
         }
-    }
 
-    if (err != USBH_ERR_NONE) {
-        USBH_PRINT_ERR(err);
+        fetch_nbr = miss_nbr;
+        if ((seq                   == DEF_TRUE) &&
+            ((blk_ix + miss_nbr)   == nbr_blks)) {
+            while ((fetch_nbr < USBH_MSC_CFG_CACHE_XFER_BLK_NBR) &&
+                   (USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr + blk_ix + fetch_nbr) == (USBH_MSC_CACHE_BLK *)0)) {
+                fetch_nbr++;
+            }
+        }
 
-        (void)USBH_EP_Reset(p_msc_dev->DevPtr,
-                           &p_msc_dev->BulkInEP);               /* Clr err on host side EP.                             */
-        if (err == USBH_ERR_EP_STALL) {
-            (void)USBH_EP_StallClr(&p_msc_dev->BulkInEP);
-            err = USBH_ERR_NONE;
-        } else {
-            (void)USBH_MSC_ResetRecovery(p_msc_dev);
-            err = USBH_ERR_MSC_IO;
+        USBH_MSC_CacheFill(p_msc_dev,
+                           lun,
+                           blk_addr + blk_ix,
+                           fetch_nbr,
+                           p_err);
+        if ((*p_err    != USBH_ERR_NONE) &&                     /* See Note #3.                                         */
+            (fetch_nbr >  miss_nbr     )) {
+            fetch_nbr = miss_nbr;
+            USBH_MSC_CacheFill(p_msc_dev,
+                               lun,
+                               blk_addr + blk_ix,
+                               fetch_nbr,
+                               p_err);
         }
+        if (*p_err != USBH_ERR_NONE) {                          /* See Note #4.                                         */
+            return (0u);
+        }
+
+        Mem_Copy((void *)&p_buf[blk_ix * blk_size],             /* Xfer buf holds blks read (see USBH_MSC_CacheFill()). */
+                 (void *) p_msc_dev->CacheXferBufPtr,
+                          miss_nbr * blk_size);
+        p_msc_dev->CacheStat.RdMissCnt  += miss_nbr;
+        p_msc_dev->CacheStat.RdAheadCnt += fetch_nbr - miss_nbr;
+        blk_ix                          += miss_nbr;
     }
 
-    return (err);
+    p_msc_dev->CacheSeqLUN     = lun;
+    p_msc_dev->CacheSeqBlkAddr = blk_addr + nbr_blks;
+
+    return (nbr_blks * blk_size);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                      USBH_MSC_ResetRecovery()
+*                                         USBH_MSC_CacheWr()
 *
-* Description : Apply bulk-only reset recovery to device on phase error & clear stalled endpoints.
+* Description : Write specified number of blocks to the cache.
 *
-* Argument(s) : p_msc_dev       Pointer to MSC device.
+* Argument(s) : p_msc_dev        Pointer to MSC device.
 *
-* Return(s)   : USBH_ERR_NONE,                          If reset recovery procedure is successful.
+*               lun              Logical unit number.
 *
-*                                                       ----- RETURNED BY USBH_MSC_BulkOnlyReset -----
-*               USBH_ERR_UNKNOWN,                       Unknown error occurred.
-*               USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
-*               USBH_ERR_HC_IO,                         Root hub input/output error.
-*               USBH_ERR_EP_STALL,                      Root hub does not support request.
-*               Host controller drivers error code,     Otherwise.
+*               blk_addr         Block address.
 *
-*                                                       ----- RETURNED BY USBH_EP_StallClr -----
-*               USBH_ERR_UNKNOWN                        Unknown error occurred.
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               USBH_ERR_HC_IO,                         Root hub input/output error.
-*               USBH_ERR_EP_STALL,                      Root hub does not support request.
-*               Host controller drivers error code,     Otherwise.
+*               nbr_blks         Number of blocks to write.
 *
-* Note(s)     : None.
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                       USBH_ERR_NONE                           Block(s) written successfully.
+*                       USBH_ERR_MSC_IO                         Device accepted fewer blocks than written back.
+*
+*                                                               ---- RETURNED BY USBH_MSC_SCSI_RdWr ----
+*                       Other error codes,                      See USBH_MSC_SCSI_RdWr().
+*
+* Return(s)   : Number of octets written.
+*
+* Note(s)     : (1) Writes of more than USBH_MSC_CFG_CACHE_XFER_BLK_NBR blocks, or of blocks larger than
+*                   USBH_MSC_CFG_CACHE_BLK_SIZE, are issued directly to the device. The cached blocks of
+*                   the range are invalidated.
+*
+*               (2) The blocks are marked dirty. They are written back to the device when they are
+*                   evicted, or by USBH_MSC_CacheFlush(). An error returned by this function may then come
+*                   from the write back of other blocks.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_MSC_ResetRecovery (USBH_MSC_DEV  *p_msc_dev)
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  CPU_INT32U  USBH_MSC_CacheWr (       USBH_MSC_DEV  *p_msc_dev,
+                                             CPU_INT08U     lun,
+                                             CPU_INT64U     blk_addr,
+                                             CPU_INT32U     nbr_blks,
+                                             CPU_INT32U     blk_size,
+                                      const  void          *p_arg,
+                                             USBH_ERR      *p_err)
 {
-    USBH_ERR  err;
+    USBH_MSC_CACHE_BLK  *p_blk;
+    CPU_INT08U          *p_buf;
+    CPU_INT32U           blk_ix;
+    CPU_INT32U           xfer_len;
 
 
-    err = USBH_MSC_BulkOnlyReset(p_msc_dev);
-    if (err != USBH_ERR_NONE) {
-        return (err);
+    USBH_MSC_CacheBlkSizeSet(p_msc_dev, blk_size, p_err);
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
     }
 
-    err = USBH_EP_StallClr(&p_msc_dev->BulkInEP);
-    if (err != USBH_ERR_NONE) {
-        return (err);
+    if ((blk_size == 0u                             ) ||        /* See Note #1.                                         */
+        (blk_size >  USBH_MSC_CFG_CACHE_BLK_SIZE    ) ||
+        (nbr_blks >  USBH_MSC_CFG_CACHE_XFER_BLK_NBR)) {
+        p_msc_dev->CacheStat.BypassCnt++;
+        USBH_MSC_CacheSync(p_msc_dev,
+                           lun,
+                           blk_addr,
+                           nbr_blks,
+                           DEF_TRUE,
+                           p_err);
+
+        xfer_len = USBH_MSC_SCSI_RdWr(        p_msc_dev,
+                                              lun,
+                                              USBH_MSC_DATA_DIR_OUT,
+                                              blk_addr,
+                                              nbr_blks,
+                                              blk_size,
+                                      (void *)p_arg,
+                                              p_err);
+        return (xfer_len);
     }
 
-    err = USBH_EP_StallClr(&p_msc_dev->BulkOutEP);
+    p_buf = (CPU_INT08U *)p_arg;
 
-    return (err);
+    for (blk_ix = 0u; blk_ix < nbr_blks; blk_ix++) {
+        p_blk = USBH_MSC_CacheBlkFind(p_msc_dev, lun, blk_addr + blk_ix);
+        if (p_blk == (USBH_MSC_CACHE_BLK *)0) {
+            p_blk = USBH_MSC_CacheBlkAlloc(p_msc_dev, p_err);
+            if (*p_err != USBH_ERR_NONE) {
+                return (0u);
+            }
+            p_blk->BlkAddr = blk_addr + blk_ix;
+            p_blk->LUN     = lun;
+        }
+
+        Mem_Copy((void *) p_blk->DataPtr,
+                 (void *)&p_buf[blk_ix * blk_size],
+                          blk_size);
+        p_blk->State = USBH_MSC_CACHE_BLK_STATE_DIRTY;          /* See Note #2.                                         */
+        USBH_MSC_CacheBlkUse(p_msc_dev, p_blk);
+    }
+
+    p_msc_dev->CacheStat.WrCnt += nbr_blks;
+   *p_err                       = USBH_ERR_NONE;
+
+    return (nbr_blks * blk_size);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                      USBH_MSC_BulkOnlyReset()
+*                                       USBH_MSC_CacheBypass()
 *
-* Description : Issue bulk-only reset.
+* Description : Prepare the cache for a read or a write issued directly to the device.
 *
-* Argument(s) : p_msc_dev       Pointer to MSC device.
+* Argument(s) : p_msc_dev        Pointer to MSC device.
 *
-* Return(s)   : Specific error code.
+*               lun              Logical unit number.
 *
-* Note(s)     : (1)The "BULK ONLY MASS STORAGE RESET" is an MSC specific request is documented in USB
-                   MSC Bulk only transport specification, section 3.1
+*               dir              USBH_MSC_DATA_DIR_IN for a read, USBH_MSC_DATA_DIR_OUT for a write.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to transfer.
+*
+*               blk_size         Block size.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                       USBH_ERR_NONE                           Cache ready for the transfer.
+*                       USBH_ERR_MSC_IO                         Device accepted fewer blocks than written back.
+*
+*                                                               ---- RETURNED BY USBH_MSC_SCSI_RdWr ----
+*                       Other error codes,                      See USBH_MSC_SCSI_RdWr().
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The device must be locked.
+*
+*               (2) Before a read, the dirty blocks of the range are written back, so that the device
+*                   returns the data last written. Then all cached blocks of the range are invalidated,
+*                   including the blocks read ahead, so that later reads are not served stale data. Dirty
+*                   blocks of a write are discarded, since the write replaces them (see
+*                   USBH_MSC_CacheSync() Note #1).
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_MSC_BulkOnlyReset (USBH_MSC_DEV  *p_msc_dev)
+#if ((USBH_MSC_CFG_CACHE_EN == DEF_ENABLED) && \
+     (USBH_MSC_CFG_PIPE_EN  == DEF_ENABLED))
+static  void  USBH_MSC_CacheBypass (USBH_MSC_DEV       *p_msc_dev,
+                                    CPU_INT08U          lun,
+                                    USBH_MSC_DATA_DIR   dir,
+                                    CPU_INT64U          blk_addr,
+                                    CPU_INT32U          nbr_blks,
+                                    CPU_INT32U          blk_size,
+                                    USBH_ERR           *p_err)
 {
-    USBH_ERR    err;
-    CPU_INT08U  if_nbr;
-
-
-    err    = USBH_ERR_NONE;
-    if_nbr = USBH_IF_NbrGet(p_msc_dev->IF_Ptr);
+    USBH_MSC_CacheBlkSizeSet(p_msc_dev, blk_size, p_err);
+    if (*p_err != USBH_ERR_NONE) {
+        return;
+    }
 
-    USBH_CtrlTx(        p_msc_dev->DevPtr,
-                        USBH_MSC_REQ_MASS_STORAGE_RESET, /*  See Note(s) #1                                      */
-                       (USBH_REQ_DIR_HOST_TO_DEV | USBH_REQ_TYPE_CLASS | USBH_REQ_RECIPIENT_IF),
-                        0u,
-                        if_nbr,
-                (void *)0,
-                        0u,
-                        USBH_MSC_TIMEOUT,
-                       &err);
-    if (err != USBH_ERR_NONE) {
-        USBH_PRINT_ERR(err);
-        USBH_EP_Reset(           p_msc_dev->DevPtr,
-                      (USBH_EP *)0);
+    if (dir == USBH_MSC_DATA_DIR_IN) {                          /* See Note #2.                                         */
+        USBH_MSC_CacheSync(p_msc_dev,
+                           lun,
+                           blk_addr,
+                           nbr_blks,
+                           DEF_FALSE,
+                           p_err);
+        if (*p_err != USBH_ERR_NONE) {
+            return;
+        }
     }
 
-    return (err);
+    USBH_MSC_CacheSync(p_msc_dev,
+                       lun,
+                       blk_addr,
+                       nbr_blks,
+                       DEF_TRUE,
+                       p_err);
 }
+#endif
+
 
 
 /*
@@ -2437,13 +5931,92 @@ static  USBH_ERR  USBH_SCSI_CMD_TestUnitReady (USBH_MSC_DEV  *p_msc_dev,
                               lun,
                               USBH_MSC_DATA_DIR_NONE,
                      (void *)&cmd[0],
-                              6u,
+                              6u,
+                     (void *) 0,
+                              0u,
+                             &err);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SCSI_CMD_SyncCache()
+*
+* Description : Request the device to write its cache to the medium.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+* Return(s)   : USBH_ERR_NONE,                          if the command is successful or not supported.
+*
+*                                                       ---- RETURNED BY USBH_MSC_XferCmd ----
+*               USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*               USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
+*               USBH_ERR_MSC_IO                         Unable to receive CSW.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_TYPE                Endpoint type or direction is incorrect.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The SCSI "SYNCHRONIZE CACHE (10)" command is documented in 'SCSI Block Commands - 3
+*                   (SBC-3)', Section 5.18. A number of blocks of 0 synchronizes the whole medium.
+*
+*               (2) Many flash devices have no write cache and reject the command with an ILLEGAL
+*                   REQUEST sense key. Their data is already on the medium.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+static  USBH_ERR  USBH_SCSI_CMD_SyncCache (USBH_MSC_DEV  *p_msc_dev,
+                                           CPU_INT08U     lun)
+{
+    USBH_ERR    err;
+    USBH_ERR    err_sense;
+    CPU_INT08U  cmd[10];
+    CPU_INT08U  sense_key;
+    CPU_INT08U  asc;
+    CPU_INT08U  ascq;
+
+                                                                /* See Note #1.                                         */
+                                                                /* ------------ PREPARE SCSI COMMAND BLOCK ------------ */
+    cmd[0] = USBH_SCSI_CMD_SYNCHRONIZE_CACHE_10;                /* Operation code (0x35).                               */
+    cmd[1] = 0u;                                                /* Flags (IMMED = 0).                                   */
+    cmd[2] = 0u;                                                /* Logical Block Address (LBA).                         */
+    cmd[3] = 0u;
+    cmd[4] = 0u;
+    cmd[5] = 0u;
+    cmd[6] = 0u;                                                /* Group number.                                        */
+    cmd[7] = 0u;                                                /* Number of blocks.                                    */
+    cmd[8] = 0u;
+    cmd[9] = 0u;                                                /* Control.                                             */
+
+    USBH_MSC_XferCmd(         p_msc_dev,                        /* ---------------- SEND SCSI COMMAND ----------------- */
+                              lun,
+                              USBH_MSC_DATA_DIR_NONE,
+                     (void *)&cmd[0],
+                              10u,
                      (void *) 0,
                               0u,
                              &err);
 
+    if (err == USBH_ERR_MSC_CMD_FAILED) {                       /* See Note #2.                                         */
+        err_sense = USBH_SCSI_GetSenseInfo( p_msc_dev,
+                                            lun,
+                                           &sense_key,
+                                           &asc,
+                                           &ascq);
+        if ((err_sense == USBH_ERR_NONE                      ) &&
+            (sense_key == USBH_SCSI_SENSE_KEY_ILLEGAL_REQUEST)) {
+            err = USBH_ERR_NONE;
+        }
+    }
+
     return (err);
 }
+#endif
 
 
 /*
@@ -2548,6 +6121,9 @@ static  CPU_INT32U  USBH_SCSI_CMD_ReqSense (USBH_MSC_DEV  *p_msc_dev,
 *                   (b) The lower nibble of the  2nd byte of the sense data is the sense key.
 *                   (c) The 12th byte of the sense data is the additional sense code (ASC).
 *                   (d) The 13th byte of the sense data is the additional sense code (ASC) qualifier.
+*
+*               (3) The sense data of the LUN is kept, so that it may be retrieved by the application
+*                   without another REQUEST SENSE command (see USBH_MSC_SenseGet()).
 *********************************************************************************************************
 */
 
@@ -2557,10 +6133,12 @@ static  USBH_ERR  USBH_SCSI_GetSenseInfo (USBH_MSC_DEV  *p_msc_dev,
                                           CPU_INT08U    *p_asc,
                                           CPU_INT08U    *p_ascq)
 {
-    USBH_ERR    err;
-    CPU_INT32U  xfer_len;
-    CPU_INT08U  sense_data[18];
-    CPU_INT08U  resp_code;
+    USBH_ERR         err;
+    CPU_INT32U       xfer_len;
+    CPU_INT08U       sense_data[18];
+    CPU_INT08U       resp_code;
+    USBH_MSC_SENSE  *p_sense;
+    CPU_SR_ALLOC();
 
 
     xfer_len = USBH_SCSI_CMD_ReqSense(p_msc_dev,                     /* Issue SCSI request sense cmd.                        */
@@ -2578,6 +6156,18 @@ static  USBH_ERR  USBH_SCSI_GetSenseInfo (USBH_MSC_DEV  *p_msc_dev,
             *p_ascq      = sense_data[13];
              err         = USBH_ERR_NONE;
 
+             CPU_CRITICAL_ENTER();
+             p_msc_dev->RecoveryStat.SenseCnt++;
+             CPU_CRITICAL_EXIT();
+             if (lun < USBH_MSC_CFG_MAX_LUN) {                  /* Keep sense data of LUN (see Note #3).                */
+                 p_sense = &p_msc_dev->SenseTbl[lun];
+                 CPU_CRITICAL_ENTER();
+                 p_sense->SenseKey = *p_sense_key;
+                 p_sense->ASC      = *p_asc;
+                 p_sense->ASCQ     = *p_ascq;
+                 CPU_CRITICAL_EXIT();
+             }
+
         } else {
             *p_sense_key = 0u;
             *p_asc       = 0u;
@@ -2600,6 +6190,90 @@ static  USBH_ERR  USBH_SCSI_GetSenseInfo (USBH_MSC_DEV  *p_msc_dev,
 }
 
 
+/*
+*********************************************************************************************************
+*                                        USBH_SCSI_RetryChk()
+*
+* Description : Request the sense data of a failed command and determine whether the command is retried.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+*               retry_ix        Number of times the command was already retried.
+*
+* Return(s)   : DEF_YES, if the condition is transient and the command must be retried.
+*
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : (1) A command that failed with a CSW status of "Command Failed" leaves the transport in
+*                   sync; no reset recovery is needed (see 'usbh_msc.h  DEFAULT CONFIGURATION  Note #5').
+*
+*               (2) A UNIT ATTENTION condition is cleared when it is reported by REQUEST SENSE. The first
+*                   retry is issued at once; the following ones wait as a NOT READY condition does.
+*
+*               (3) A NOT READY unit is given USBH_MSC_CFG_RETRY_DLY_MS ms to become ready before the
+*                   first retry, and twice as long before each following one.
+*
+*               (4) A medium that is not present will not appear within the retry delays.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SCSI_RetryChk (USBH_MSC_DEV  *p_msc_dev,
+                                         CPU_INT08U     lun,
+                                         CPU_INT08U     retry_ix)
+{
+    CPU_INT08U  sense_key;
+    CPU_INT08U  asc;
+    CPU_INT08U  ascq;
+    CPU_INT32U  dly;
+    USBH_ERR    err;
+    CPU_SR_ALLOC();
+
+
+#if (USBH_MSC_CFG_RETRY_NBR > 0u)
+    if (retry_ix >= USBH_MSC_CFG_RETRY_NBR) {
+        return (DEF_NO);
+    }
+#else
+    return (DEF_NO);                                            /* Retries disabled.                                    */
+#endif
+
+    err = USBH_SCSI_GetSenseInfo( p_msc_dev,                    /* See Note #1.                                         */
+                                  lun,
+                                 &sense_key,
+                                 &asc,
+                                 &ascq);
+    if ((err != USBH_ERR_NONE                   ) ||
+        (asc == USBH_SCSI_ASC_MEDIUM_NOT_PRESENT)) {            /* See Note #4.                                         */
+        return (DEF_NO);
+    }
+
+    switch (sense_key) {
+        case USBH_SCSI_SENSE_KEY_UNIT_ATTENTION:                /* See Note #2.                                         */
+             dly = (retry_ix == 0u) ? 0u : (USBH_MSC_CFG_RETRY_DLY_MS << (retry_ix - 1u));
+             break;
+
+        case USBH_SCSI_SENSE_KEY_NOT_RDY:                       /* See Note #3.                                         */
+             dly = USBH_MSC_CFG_RETRY_DLY_MS << retry_ix;
+             break;
+
+        default:
+             return (DEF_NO);
+    }
+
+    CPU_CRITICAL_ENTER();
+    p_msc_dev->RecoveryStat.RetryCnt++;
+    CPU_CRITICAL_EXIT();
+
+    if (dly > 0u) {
+        USBH_OS_DlyMS(dly);
+    }
+
+    return (DEF_YES);
+}
+
+
 /*
 *********************************************************************************************************
 *                                     USBH_SCSI_CMD_CapacityRd()
@@ -2627,16 +6301,21 @@ static  USBH_ERR  USBH_SCSI_GetSenseInfo (USBH_MSC_DEV  *p_msc_dev,
 *
 * Note(s)     : (1) The SCSI "READ CAPAPITY (10)" command is documented in 'SCSI Block Commands - 2
 *                   (SBC-2)', Section 5.10.
+*
+*               (2) A device of more than 2^32 blocks returns 0xFFFFFFFF as last logical block address.
+*                   The capacity is then read with READ CAPACITY (16), and the LUN is accessed with
+*                   READ (16) / WRITE (16) commands (see USBH_SCSI_RdWrFmt()).
 *********************************************************************************************************
 */
 
 static  USBH_ERR  USBH_SCSI_CMD_CapacityRd (USBH_MSC_DEV  *p_msc_dev,
                                             CPU_INT08U     lun,
-                                            CPU_INT32U    *p_nbr_blks,
+                                            CPU_INT64U    *p_nbr_blks,
                                             CPU_INT32U    *p_blk_size)
 {
     CPU_INT08U  cmd[10];
     CPU_INT08U  data[8];
+    CPU_INT32U  lba_last;
     USBH_ERR    err;
                                                                 /* See Note #1.                                         */
                                                                 /* -------------- PREPARE SCSI CMD BLOCK -------------- */
@@ -2659,11 +6338,96 @@ static  USBH_ERR  USBH_SCSI_CMD_CapacityRd (USBH_MSC_DEV  *p_msc_dev,
                       (void *)data,
                               8u,
                              &err);
-    if (err == USBH_ERR_NONE) {                                 /* -------------- HANDLE DEVICE RESPONSE -------------- */
-        MEM_VAL_COPY_GET_INT32U_BIG(p_nbr_blks, &data[0]);
-       *p_nbr_blks += 1u;
-        MEM_VAL_COPY_GET_INT32U_BIG(p_blk_size, &data[4]);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* -------------- HANDLE DEVICE RESPONSE -------------- */
+    MEM_VAL_COPY_GET_INT32U_BIG(&lba_last, &data[0]);
+    if (lba_last == USBH_SCSI_LBA_MAX_10) {                     /* See Note #2.                                         */
+        err = USBH_SCSI_CMD_CapacityRd16(p_msc_dev,
+                                         lun,
+                                         p_nbr_blks,
+                                         p_blk_size);
+        if ((err == USBH_ERR_NONE       ) &&
+            (lun <  USBH_MSC_CFG_MAX_LUN)) {
+            p_msc_dev->LUN_Tbl[lun].Cmd16En = DEF_TRUE;
+        }
+        return (err);
+    }
+
+   *p_nbr_blks = (CPU_INT64U)lba_last + 1u;
+    MEM_VAL_COPY_GET_INT32U_BIG(p_blk_size, &data[4]);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    USBH_SCSI_CMD_CapacityRd16()
+*
+* Description : Read number of sectors & sector size of a device of more than 2^32 blocks.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+*               p_nbr_blks      Pointer to variable that will receive number of blocks.
+*
+*               p_blk_size      Pointer to variable that will receive block size.
+*
+* Return(s)   : USBH_ERR_NONE,                          if command is successful.
+*
+*                                                       ---- RETURNED BY USBH_MSC_XferCmd ----
+*               USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*               USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
+*               USBH_ERR_MSC_IO                         Unable to receive CSW.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The SCSI "READ CAPACITY (16)" command is a SERVICE ACTION IN (16) command documented
+*                   in 'SCSI Block Commands - 3 (SBC-3)', Section 5.16.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_SCSI_CMD_CapacityRd16 (USBH_MSC_DEV  *p_msc_dev,
+                                              CPU_INT08U     lun,
+                                              CPU_INT64U    *p_nbr_blks,
+                                              CPU_INT32U    *p_blk_size)
+{
+    CPU_INT08U  cmd[16];
+    CPU_INT08U  data[32];
+    CPU_INT32U  lba_msb;
+    CPU_INT32U  lba_lsb;
+    CPU_INT32U  xfer_len;
+    USBH_ERR    err;
+
+                                                                /* See Note #1.                                         */
+                                                                /* -------------- PREPARE SCSI CMD BLOCK -------------- */
+    Mem_Clr((void *)cmd, sizeof(cmd));
+    cmd[0]  = USBH_SCSI_CMD_SERVICE_ACTION_IN_16;               /* Operation code (0x9E).                               */
+    cmd[1]  = USBH_SCSI_SA_READ_CAPACITY_16;                    /* Service action (0x10).                               */
+    cmd[13] = (CPU_INT08U)sizeof(data);                         /* Allocation length (LSB).                             */
+
+    xfer_len = USBH_MSC_XferCmd (        p_msc_dev,             /* ------------------ SEND SCSI CMD ------------------- */
+                                         lun,
+                                         USBH_MSC_DATA_DIR_IN,
+                                 (void *)cmd,
+                                         16u,
+                                 (void *)data,
+                                         sizeof(data),
+                                        &err);
+    if ((err      == USBH_ERR_NONE) &&
+        (xfer_len <  12u)) {
+        err = USBH_ERR_MSC_CMD_FAILED;
+    }
+    if (err != USBH_ERR_NONE) {
+        return (err);
     }
+                                                                /* -------------- HANDLE DEVICE RESPONSE -------------- */
+    MEM_VAL_COPY_GET_INT32U_BIG(&lba_msb, &data[0]);
+    MEM_VAL_COPY_GET_INT32U_BIG(&lba_lsb, &data[4]);
+   *p_nbr_blks = (((CPU_INT64U)lba_msb << 32u) | lba_lsb) + 1u;
+    MEM_VAL_COPY_GET_INT32U_BIG(p_blk_size, &data[8]);
 
     return (err);
 }
@@ -2671,74 +6435,205 @@ static  USBH_ERR  USBH_SCSI_CMD_CapacityRd (USBH_MSC_DEV  *p_msc_dev,
 
 /*
 *********************************************************************************************************
-*                                           USBH_SCSI_Rd()
+*                                       USBH_SCSI_CMD_Inquiry()
 *
-* Description : Read specified number of blocks from device.
+* Description : Read standard INQUIRY data or a Vital Product Data (VPD) page.
 *
-* Argument(s) : p_msc_dev        Pointer to MSC device.
+* Argument(s) : xfer_fnct       Function that issues a command on the transport of the device.
 *
-*               lun              Logical unit number.
+*               p_dev           Pointer to device, passed to 'xfer_fnct'.
 *
-*               blk_addr         Block address.
+*               lun             Logical unit number.
 *
-*               nbr_blks         Number of blocks to read.
+*               vpd             DEF_TRUE to read VPD page 'page', DEF_FALSE to read standard INQUIRY data.
 *
-*               blk_size         Block size.
+*               page            VPD page code.
 *
-*               p_arg            Pointer to data buffer.
+*               p_arg           Pointer to data buffer.
+*
+*               data_len        Length of data buffer, in octets.
 *
 *               p_err   Pointer to variable that will receive the return error code from this function :
 *                       USBH_ERR_NONE                           Data successfully received.
+*                       Other error codes,                      returned by 'xfer_fnct'.
 *
-*                                                               ---- RETURNED BY USBH_MSC_XferCmd ----
-*                       USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
-*                       USBH_ERR_MSC_CMD_PHASE                  Device reports command phase error.
-*                       USBH_ERR_MSC_IO                         Unable to receive CSW.
-*                       USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                       USBH_ERR_EP_INVALID_TYPE                Endpoint type or direction is incorrect.
-*                       USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                       Host controller drivers error code,     Otherwise.
-*
-* Return(s)   : Number of bytes read.
+* Return(s)   : Number of octets received.
 *
-* Note(s)     : (1) The SCSI "READ (10): command is documented in 'SCSI Block Commands - 2 (SBC-2)',
-*                   Section 5.6.
+* Note(s)     : (1) The SCSI "INQUIRY" command is documented in 'SCSI Primary Commands - 3 (SPC-3)',
+*                   Section 6.4.
 *********************************************************************************************************
 */
 
-static  CPU_INT32U  USBH_SCSI_Rd (USBH_MSC_DEV  *p_msc_dev,
-                                  CPU_INT08U     lun,
-                                  CPU_INT32U     blk_addr,
-                                  CPU_INT16U     nbr_blks,
-                                  CPU_INT32U     blk_size,
-                                  void          *p_arg,
-                                  USBH_ERR      *p_err)
+static  CPU_INT32U  USBH_SCSI_CMD_Inquiry (USBH_SCSI_XFER_FNCT   xfer_fnct,
+                                           void                 *p_dev,
+                                           CPU_INT08U            lun,
+                                           CPU_BOOLEAN           vpd,
+                                           CPU_INT08U            page,
+                                           CPU_INT08U           *p_arg,
+                                           CPU_INT08U            data_len,
+                                           USBH_ERR             *p_err)
 {
-    CPU_INT08U  cmd[10];
-    CPU_INT32U  data_len;
+    CPU_INT08U  cmd[6];
     CPU_INT32U  xfer_len;
 
-
-    data_len = nbr_blks * blk_size;
                                                                 /* See Note #1.                                         */
                                                                 /* -------------- PREPARE SCSI CMD BLOCK -------------- */
-    cmd[0] = USBH_SCSI_CMD_READ_10;                             /* Operation code (0x28).                               */
-    cmd[1] = 0u;                                                /* Reserved.                                            */
-    MEM_VAL_COPY_SET_INT32U_BIG(&cmd[2], &blk_addr);            /* Logcal Block Address (LBA).                          */
-    cmd[6] = 0u;                                                /* Reserved.                                            */
-    MEM_VAL_COPY_SET_INT16U_BIG(&cmd[7], &nbr_blks);            /* Transfer length (number of logical blocks).          */
-    cmd[9] = 0u;                                                /* Control.                                             */
+    cmd[0] = USBH_SCSI_CMD_INQUIRY;                             /* Operation code (0x12).                               */
+    cmd[1] = (vpd == DEF_TRUE) ? DEF_BIT_00 : 0u;               /* EVPD.                                                */
+    cmd[2] = (vpd == DEF_TRUE) ? page       : 0u;               /* Page code.                                           */
+    cmd[3] = 0u;                                                /* Allocation length (MSB).                             */
+    cmd[4] = data_len;                                          /* Allocation length (LSB).                             */
+    cmd[5] = 0u;                                                /* Control.                                             */
 
-    xfer_len = USBH_MSC_XferCmd(         p_msc_dev,             /* ---------------- SEND SCSI COMMAND ----------------- */
-                                         lun,
-                                         USBH_MSC_DATA_DIR_IN,
-                                (void *)&cmd[0],
-                                         10u,
-                                         p_arg,
-                                         data_len,
-                                         p_err);
+    xfer_len = xfer_fnct(        p_dev,                         /* ------------------ SEND SCSI CMD ------------------- */
+                                 lun,
+                                 USBH_MSC_DATA_DIR_IN,
+                         (void *)cmd,
+                                 6u,
+                         (void *)p_arg,
+                                 data_len,
+                                 p_err);
     if (*p_err != USBH_ERR_NONE) {
-        xfer_len = (CPU_INT32U)0;
+        xfer_len = 0u;
+    }
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_MSC_LUN_Get()
+*
+* Description : Get the SCSI properties of a LUN.
+*
+* Argument(s) : p_msc_dev       Pointer to MSC device.
+*
+*               lun             Logical unit number.
+*
+* Return(s)   : Pointer to properties of the LUN, or null pointer if the LUN is beyond USBH_MSC_CFG_MAX_LUN
+*               (see 'usbh_msc.h  Note #1h').
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_SCSI_LUN  *USBH_MSC_LUN_Get (USBH_MSC_DEV  *p_msc_dev,
+                                          CPU_INT08U     lun)
+{
+    if (lun >= USBH_MSC_CFG_MAX_LUN) {
+        return ((USBH_SCSI_LUN *)0);
+    }
+
+    return (&p_msc_dev->LUN_Tbl[lun]);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_MSC_SCSI_Xfer()
+*
+* Description : Issue a SCSI command over Bulk-Only Transport on behalf of the shared SCSI functions.
+*
+* Argument(s) : p_dev           Pointer to MSC device.
+*
+*               Other arguments, see USBH_MSC_XferCmd().
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_MSC_SCSI_Xfer (void               *p_dev,
+                                        CPU_INT08U          lun,
+                                        USBH_MSC_DATA_DIR   dir,
+                                        void               *p_cb,
+                                        CPU_INT08U          cb_len,
+                                        void               *p_arg,
+                                        CPU_INT32U          data_len,
+                                        USBH_ERR           *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+
+    xfer_len = USBH_MSC_XferCmd((USBH_MSC_DEV *)p_dev,
+                                                lun,
+                                                dir,
+                                                p_cb,
+                                                cb_len,
+                                                p_arg,
+                                                data_len,
+                                                p_err);
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_MSC_SCSI_XferRetry()
+*
+* Description : Issue a SCSI read or write command over Bulk-Only Transport, and issue it again while it
+*               fails with a transient condition.
+*
+* Argument(s) : p_dev           Pointer to MSC device.
+*
+*               Other arguments, see USBH_MSC_XferCmd().
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : (1) A command failed with a transient UNIT ATTENTION or NOT READY condition is issued
+*                   again, up to USBH_MSC_CFG_RETRY_NBR times (see USBH_SCSI_RetryChk()).
+*
+*               (2) The device may be unlocked while the command is in progress (see USBH_MSC_XferCmd()),
+*                   so the recovery statistics are updated within a critical section.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_MSC_SCSI_XferRetry (void               *p_dev,
+                                             CPU_INT08U          lun,
+                                             USBH_MSC_DATA_DIR   dir,
+                                             void               *p_cb,
+                                             CPU_INT08U          cb_len,
+                                             void               *p_arg,
+                                             CPU_INT32U          data_len,
+                                             USBH_ERR           *p_err)
+{
+    USBH_MSC_DEV  *p_msc_dev;
+    CPU_INT32U     xfer_len;
+    CPU_INT08U     retry_ix;
+    CPU_SR_ALLOC();
+
+
+    p_msc_dev = (USBH_MSC_DEV *)p_dev;
+    retry_ix  =  0u;
+    xfer_len  =  USBH_MSC_XferCmd(p_msc_dev,
+                                  lun,
+                                  dir,
+                                  p_cb,
+                                  cb_len,
+                                  p_arg,
+                                  data_len,
+                                  p_err);
+    while ((*p_err == USBH_ERR_MSC_CMD_FAILED) &&               /* See Note #1.                                         */
+           (USBH_SCSI_RetryChk(p_msc_dev, lun, retry_ix) == DEF_YES)) {
+        retry_ix++;
+        xfer_len = USBH_MSC_XferCmd(p_msc_dev,
+                                    lun,
+                                    dir,
+                                    p_cb,
+                                    cb_len,
+                                    p_arg,
+                                    data_len,
+                                    p_err);
+    }
+
+    if ((*p_err   == USBH_ERR_NONE) &&                          /* See Note #2.                                         */
+        (retry_ix >  0u)) {
+        CPU_CRITICAL_ENTER();
+        p_msc_dev->RecoveryStat.RetryOkCnt++;
+        CPU_CRITICAL_EXIT();
     }
 
     return (xfer_len);
@@ -2747,24 +6642,27 @@ static  CPU_INT32U  USBH_SCSI_Rd (USBH_MSC_DEV  *p_msc_dev,
 
 /*
 *********************************************************************************************************
-*                                           USBH_SCSI_Wr()
+*                                        USBH_MSC_SCSI_RdWr()
 *
-* Description : Write specified number of blocks to device.
+* Description : Read or write specified number of blocks, using as few commands as the device accepts.
 *
 * Argument(s) : p_msc_dev        Pointer to MSC device.
 *
 *               lun              Logical unit number.
 *
+*               dir              USBH_MSC_DATA_DIR_IN to read, USBH_MSC_DATA_DIR_OUT to write.
+*
 *               blk_addr         Block address.
 *
-*               nbr_blks         Number of blocks to write.
+*               nbr_blks         Number of blocks to transfer.
 *
 *               blk_size         Block size.
 *
 *               p_arg            Pointer to data buffer.
 *
 *               p_err   Pointer to variable that will receive the return error code from this function :
-*                       USBH_ERR_NONE                           Data successfully transmitted.
+*                       USBH_ERR_NONE                           Data successfully transferred.
+*                       USBH_ERR_INVALID_ARG                    Transfer exceeds 2^32 - 1 octets.
 *
 *                                                               ---- RETURNED BY USBH_MSC_XferCmd ----
 *                       USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
@@ -2775,51 +6673,116 @@ static  CPU_INT32U  USBH_SCSI_Rd (USBH_MSC_DEV  *p_msc_dev,
 *                       USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
 *                       Host controller drivers error code,     Otherwise.
 *
-* Return(s)   : Number of octets written.
+* Return(s)   : Number of octets transferred.
 *
-* Note(s)     : (1) The SCSI "WRITE (10)" command is documented in 'SCSI Block Commands - 2 (SBC-2)',
-*                   Section 5.25.
+* Note(s)     : (1) The transfer is split as the LUN requires (see USBH_SCSI_RdWr()). Each command is
+*                   retried on its own (see USBH_MSC_SCSI_XferRetry()).
 *********************************************************************************************************
 */
 
-static  CPU_INT32U  USBH_SCSI_Wr (USBH_MSC_DEV  *p_msc_dev,
-                                  CPU_INT08U     lun,
-                                  CPU_INT32U     blk_addr,
-                                  CPU_INT16U     nbr_blks,
-                                  CPU_INT32U     blk_size,
-                                  const  void   *p_arg,
-                                  USBH_ERR      *p_err)
-
+static  CPU_INT32U  USBH_MSC_SCSI_RdWr (USBH_MSC_DEV       *p_msc_dev,
+                                        CPU_INT08U          lun,
+                                        USBH_MSC_DATA_DIR   dir,
+                                        CPU_INT64U          blk_addr,
+                                        CPU_INT32U          nbr_blks,
+                                        CPU_INT32U          blk_size,
+                                        void               *p_arg,
+                                        USBH_ERR           *p_err)
 {
-    CPU_INT08U  cmd[10];
-    CPU_INT32U  data_len;
     CPU_INT32U  xfer_len;
 
-
-    data_len = nbr_blks * blk_size;
                                                                 /* See Note #1.                                         */
-                                                                /* -------------- PREPARE SCSI CMD BLOCK -------------- */
-    cmd[0] = USBH_SCSI_CMD_WRITE_10;                            /* Operation code (0x2A).                               */
-    cmd[1] = 0u;                                                /* Reserved.                                            */
-    MEM_VAL_COPY_SET_INT32U_BIG(&cmd[2], &blk_addr);            /* Logical Block Address (LBA).                         */
-    cmd[6] = 0u;                                                /* Reserved.                                            */
-    MEM_VAL_COPY_SET_INT16U_BIG(&cmd[7], &nbr_blks);            /* Transfer length (number of logical blocks).          */
-    cmd[9] = 0u;                                                /* Control.                                             */
+    xfer_len = USBH_SCSI_RdWr(USBH_MSC_LUN_Get(p_msc_dev, lun),
+                              USBH_MSC_SCSI_XferRetry,
+                      (void *)p_msc_dev,
+                              lun,
+                              dir,
+                              blk_addr,
+                              nbr_blks,
+                              blk_size,
+                              p_arg,
+                              p_err);
 
-    xfer_len = USBH_MSC_XferCmd(         p_msc_dev,             /* ------------------ SEND SCSI CMD ------------------- */
-                                         lun,
-                                         USBH_MSC_DATA_DIR_OUT,
-                                (void *)&cmd[0],
-                                         10u,
-                                (void *) p_arg,
-                                         data_len,
-                                         p_err);
-    if (*p_err != USBH_ERR_NONE) {
-        xfer_len = 0u;
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_MSC_SCSI_RdWrAsync()
+*
+* Description : Queue a read or a write of specified number of blocks without waiting for its completion.
+*
+* Argument(s) : p_msc_dev        Pointer to MSC device.
+*
+*               lun              Logical unit number.
+*
+*               dir              USBH_MSC_DATA_DIR_IN to read, USBH_MSC_DATA_DIR_OUT to write.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to transfer.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               fnct             Function notified when the transfer completes.
+*
+*               p_fnct_arg       Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,              if the command is successfully queued.
+*               USBH_ERR_INVALID_ARG,       if the transfer does not fit in one command (see Note #1).
+*
+*                                           ---- RETURNED BY USBH_MSC_XferCmdAsync ----
+*               USBH_ERR_ALLOC,             if the command queue of the device is full.
+*
+* Note(s)     : (1) The transfer is not split: it is issued as a single command of at most
+*                   USBH_SCSI_XferBlkMaxGet() blocks.
+*********************************************************************************************************
+*/
+
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+static  USBH_ERR  USBH_MSC_SCSI_RdWrAsync (USBH_MSC_DEV             *p_msc_dev,
+                                           CPU_INT08U                lun,
+                                           USBH_MSC_DATA_DIR         dir,
+                                           CPU_INT64U                blk_addr,
+                                           CPU_INT32U                nbr_blks,
+                                           CPU_INT32U                blk_size,
+                                           void                     *p_arg,
+                                           USBH_MSC_XFER_CMPL_FNCT   fnct,
+                                           void                     *p_fnct_arg)
+{
+    USBH_SCSI_LUN  *p_lun;
+    CPU_INT08U      cmd[16];
+    CPU_INT08U      cmd_len;
+    USBH_ERR        err;
+
+
+    p_lun = USBH_MSC_LUN_Get(p_msc_dev, lun);
+    if (nbr_blks > USBH_SCSI_XferBlkMaxGet(p_lun, blk_size)) {  /* See Note #1.                                         */
+        return (USBH_ERR_INVALID_ARG);
     }
 
-    return (xfer_len);
+    cmd_len = USBH_SCSI_RdWrFmt(p_lun,
+                                dir,
+                                blk_addr,
+                                nbr_blks,
+                                cmd);
+
+    err = USBH_MSC_XferCmdAsync(        p_msc_dev,              /* ------------------ QUEUE SCSI CMD ------------------ */
+                                        lun,
+                                        dir,
+                                (void *)cmd,
+                                        cmd_len,
+                                        p_arg,
+                                        nbr_blks * blk_size,
+                                        fnct,
+                                        p_fnct_arg);
+
+    return (err);
 }
+#endif
 
 
 /*
@@ -72,6 +72,139 @@
 #define  USBH_MSC_DATA_DIR_OUT                          0x00u
 #define  USBH_MSC_DATA_DIR_NONE                         0x01u
 
+#define  USBH_MSC_LEN_CBW                                 31u
+#define  USBH_MSC_LEN_CSW                                 13u
+
+
+/*
+*********************************************************************************************************
+*                                        DEFAULT CONFIGURATION
+*
+* Note(s) : (1) The mass storage class may be configured from 'usbh_cfg.h':
+*
+*               (a) USBH_MSC_CFG_PIPE_EN        DEF_ENABLED to pipeline the Bulk-Only Transport stages. The
+*                                               CBW, data and CSW stages of a command are submitted as
+*                                               asynchronous transfers, so that the bus does not idle
+*                                               between stages, and the next queued command is started
+*                                               from the completion of the current CSW.
+*
+*               (b) USBH_MSC_CFG_CMD_Q_LEN      Nbr of commands that can be queued on a device when
+*                                               USBH_MSC_CFG_PIPE_EN is DEF_ENABLED.
+*
+*               (c) USBH_MSC_CFG_RD_PRIO_MAX    Max nbr of reads started in a row ahead of a queued write
+*                                               of another LUN when USBH_MSC_CFG_PIPE_EN is DEF_ENABLED.
+*                                               0 disables read priority (see Note #4). 0 to 254.
+*
+*               (d) USBH_MSC_CFG_CACHE_EN       DEF_ENABLED to cache blocks read and written with
+*                                               USBH_MSC_Rd() / USBH_MSC_Wr() (see Note #3).
+*
+*               (e) USBH_MSC_CFG_CACHE_BLK_NBR  Nbr of blocks cached per device.
+*
+*               (f) USBH_MSC_CFG_CACHE_BLK_SIZE Largest block size that is cached, in octets.
+*
+*               (g) USBH_MSC_CFG_CACHE_XFER_BLK_NBR
+*                                               Nbr of blocks read ahead on sequential access, and max
+*                                               nbr of dirty blocks written back by a single command.
+*                                               Larger requests bypass the cache.
+*
+*               (h) USBH_MSC_CFG_MAX_LUN        Nbr of LUNs per device whose last sense data (see
+*                                               USBH_MSC_SenseGet()) and command format are kept. Other
+*                                               LUNs are accessed with READ (10) / WRITE (10) commands
+*                                               when addresses fit, without Block Limits VPD bound.
+*
+*               (i) USBH_MSC_CFG_RETRY_NBR      Max nbr of times a read or write that failed with a
+*                                               transient UNIT ATTENTION or NOT READY condition is
+*                                               retried, without reset (see Note #5). 0 disables retries.
+*
+*               (j) USBH_MSC_CFG_RETRY_DLY_MS   Delay before the first retry of a NOT READY condition, in
+*                                               ms. The delay is doubled on each following retry.
+*
+*           (2) The pipelined engine queues the CSW behind the data stage on the bulk IN endpoint. This
+*               requires USBH_CFG_MAX_QUEUED_URB_PER_EP >= 2 and one extra URB per device. The data stage
+*               is split in pieces of at most 'DataBufMaxLen' octets (see 'usbh_core.h  HOST CONTROLLER
+*               CONFIGURATION'); each piece queued behind the first one takes another extra URB. With
+*               fewer URBs, the remaining stages are submitted as the queued ones complete.
+*
+*           (3) The cache of each device is taken from a static arena of
+*
+*                   USBH_MSC_CFG_MAX_DEV * (USBH_MSC_CFG_CACHE_BLK_NBR + USBH_MSC_CFG_CACHE_XFER_BLK_NBR) *
+*                   USBH_MSC_CFG_CACHE_BLK_SIZE
+*
+*               octets. Writes are cached (write-back) until the block is evicted or USBH_MSC_CacheFlush()
+*               is called; data not flushed is lost if the device is disconnected. Asynchronous reads
+*               and writes are not cached: the cached blocks of their range are invalidated before
+*               they are queued, after the dirty ones of a read are written back (see USBH_MSC_RdAsync()
+*               Note #4).
+*
+*           (4) The commands queued on a device by the pipelined engine are scheduled by LUN. Each LUN
+*               is served in turn (round-robin), its commands in the order they were queued, so that a
+*               LUN written by one task does not starve a LUN read by another. Reads, including commands
+*               without data, are started ahead of writes of other LUNs, up to USBH_MSC_CFG_RD_PRIO_MAX
+*               in a row. A command freed while tasks wait for one is handed to a waiting task. When the
+*               cache is enabled, the reads and writes of a device are serialized, except the asynchronous
+*               ones.
+*
+*           (5) Errors are recovered at the lowest level that clears them :
+*
+*               (a) A command failed by the device leaves the transport in sync. Its sense data is
+*                   requested; reads and writes failed with UNIT ATTENTION, or with NOT READY while the
+*                   unit becomes ready, are retried with an increasing delay. Other sense keys, and a
+*                   medium that is not present, are reported to the caller.
+*
+*               (b) A stalled data or CSW stage is recovered by clearing the halt of the endpoint.
+*
+*               (c) A phase error, an invalid CSW, a stalled CBW or a failed transfer leave the device in
+*                   an unknown state and are recovered by a reset recovery.
+*
+*               The counts are kept per device (see USBH_MSC_RecoveryStatGet()).
+*
+*           (6) The formatting, splitting and limits of SCSI read and write commands are shared with the
+*               USB Attached SCSI class driver (see USBH_SCSI_RdWr()). Each transport keeps the properties
+*               of its LUNs in a USBH_SCSI_LUN table and issues the commands with its own
+*               USBH_SCSI_XFER_FNCT function.
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_MSC_CFG_PIPE_EN
+#define  USBH_MSC_CFG_PIPE_EN                    DEF_ENABLED
+#endif
+
+#ifndef  USBH_MSC_CFG_CMD_Q_LEN
+#define  USBH_MSC_CFG_CMD_Q_LEN                            2u
+#endif
+
+#ifndef  USBH_MSC_CFG_RD_PRIO_MAX
+#define  USBH_MSC_CFG_RD_PRIO_MAX                          4u
+#endif
+
+#ifndef  USBH_MSC_CFG_CACHE_EN
+#define  USBH_MSC_CFG_CACHE_EN                  DEF_DISABLED
+#endif
+
+#ifndef  USBH_MSC_CFG_CACHE_BLK_NBR
+#define  USBH_MSC_CFG_CACHE_BLK_NBR                       32u
+#endif
+
+#ifndef  USBH_MSC_CFG_CACHE_BLK_SIZE
+#define  USBH_MSC_CFG_CACHE_BLK_SIZE                     512u
+#endif
+
+#ifndef  USBH_MSC_CFG_CACHE_XFER_BLK_NBR
+#define  USBH_MSC_CFG_CACHE_XFER_BLK_NBR                   8u
+#endif
+
+#ifndef  USBH_MSC_CFG_MAX_LUN
+#define  USBH_MSC_CFG_MAX_LUN                              1u
+#endif
+
+#ifndef  USBH_MSC_CFG_RETRY_NBR
+#define  USBH_MSC_CFG_RETRY_NBR                            3u
+#endif
+
+#ifndef  USBH_MSC_CFG_RETRY_DLY_MS
+#define  USBH_MSC_CFG_RETRY_DLY_MS                        10u
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -81,16 +214,135 @@
 
 typedef  CPU_INT08U  USBH_MSC_DATA_DIR;
 
+                                                                /* --------- SCSI LUN PROPERTIES (see Note #6) -------- */
+typedef  struct  usbh_scsi_lun {
+    CPU_BOOLEAN  Cmd16En;                                       /* Use READ (16) / WRITE (16) cmds.                     */
+    CPU_BOOLEAN  BlkLimitsRd;                                   /* Block Limits VPD page requested.                     */
+    CPU_INT32U   XferBlkMax;                                    /* Max nbr of blks per cmd reported by LUN, 0 if none.  */
+} USBH_SCSI_LUN;
+
+                                                                /* --------- SCSI CMD TRANSPORT (see Note #6) --------- */
+typedef  CPU_INT32U  (*USBH_SCSI_XFER_FNCT)(void               *p_dev,
+                                            CPU_INT08U          lun,
+                                            USBH_MSC_DATA_DIR   dir,
+                                            void               *p_cb,
+                                            CPU_INT08U          cb_len,
+                                            void               *p_arg,
+                                            CPU_INT32U          data_len,
+                                            USBH_ERR           *p_err);
+
+typedef  struct  usbh_msc_dev  USBH_MSC_DEV;
+
+                                                                /* ------------- ASYNC XFER NOTIFICATION -------------- */
+typedef  void  (*USBH_MSC_XFER_CMPL_FNCT)(USBH_MSC_DEV  *p_msc_dev,
+                                          void          *p_buf,
+                                          CPU_INT32U     buf_len,
+                                          CPU_INT32U     xfer_len,
+                                          void          *p_arg,
+                                          USBH_ERR       err);
+
+                                                                /* ------------------ PIPELINED CMD ------------------- */
+typedef  struct  usbh_msc_cmd  USBH_MSC_CMD;
+
+struct  usbh_msc_cmd {
+    CPU_INT08U               CBW_Buf[USBH_MSC_LEN_CBW];         /* CBW, formatted when cmd is queued.                   */
+    CPU_INT08U               CSW_Buf[USBH_MSC_LEN_CSW];         /* CSW received from dev.                               */
+    CPU_INT32U               Tag;                               /* Tag of CBW.                                          */
+    CPU_INT08U               LUN;                               /* LUN of CBW.                                          */
+    USBH_MSC_DATA_DIR        Dir;                               /* Dir of data stage.                                   */
+    CPU_INT08U              *DataPtr;                           /* Ptr to data buf.                                     */
+    CPU_INT32U               DataLen;                           /* Len of data stage.                                   */
+    CPU_INT32U               DataSubmitLen;                     /* Len of data stage submitted to HC.                   */
+    CPU_INT32U               DataCmplLen;                       /* Len of data stage completed by HC.                   */
+    CPU_INT32U               DataXferLen;                       /* Len of data stage xfered.                            */
+    CPU_INT08U               URB_Cnt;                           /* Nbr of URBs in progress.                             */
+    CPU_INT16U               Flags;                             /* Progress of cmd stages.                              */
+    USBH_ERR                 Err;                               /* First err reported by a stage.                       */
+    CPU_INT08U               ErrStage;                          /* Stage that reported 'Err'.                           */
+    USBH_HSEM                Sem;                               /* Sem signaled to task waiting for cmd.                */
+    USBH_MSC_XFER_CMPL_FNCT  CmplFnctPtr;                       /* Fnct notified of async cmd cmpl.                     */
+    void                    *CmplArgPtr;                        /* Arg passed to 'CmplFnctPtr'.                         */
+    USBH_MSC_DEV            *MSC_DevPtr;                        /* Ptr to MSC dev.                                      */
+    USBH_MSC_CMD            *NxtPtr;                            /* Ptr to next cmd in Q.                                */
+};
+
+                                                                /* -------------------- CACHED BLK -------------------- */
+typedef  struct  usbh_msc_cache_blk  USBH_MSC_CACHE_BLK;
+
+struct  usbh_msc_cache_blk {
+    CPU_INT64U           BlkAddr;                               /* Addr of cached blk.                                  */
+    CPU_INT08U          *DataPtr;                               /* Ptr to blk data in cache arena.                      */
+    CPU_INT08U           LUN;                                   /* LUN of cached blk.                                   */
+    CPU_INT08U           State;                                 /* Free, clean or dirty.                                */
+    USBH_MSC_CACHE_BLK  *PrevPtr;                               /* Ptr to more recently used blk.                       */
+    USBH_MSC_CACHE_BLK  *NxtPtr;                                /* Ptr to less recently used blk.                       */
+};
+
+                                                                /* ----------------- CACHE STATISTICS ----------------- */
+typedef  struct  usbh_msc_cache_stat {
+    CPU_INT32U  RdHitCnt;                                       /* Nbr of blks read from cache.                         */
+    CPU_INT32U  RdMissCnt;                                      /* Nbr of blks read from dev.                           */
+    CPU_INT32U  RdAheadCnt;                                     /* Nbr of blks read ahead.                              */
+    CPU_INT32U  WrCnt;                                          /* Nbr of blks written to cache.                        */
+    CPU_INT32U  WrBackCnt;                                      /* Nbr of dirty blks written back to dev.               */
+    CPU_INT32U  WrBackCmdCnt;                                   /* Nbr of write backs, each of adjacent dirty blks.     */
+    CPU_INT32U  BypassCnt;                                      /* Nbr of rd/wr requests too large to be cached.        */
+} USBH_MSC_CACHE_STAT;
+
+
+                                                                /* -------------------- SENSE DATA -------------------- */
+typedef  struct  usbh_msc_sense {
+    CPU_INT08U  SenseKey;                                       /* Sense key.                                           */
+    CPU_INT08U  ASC;                                            /* Additional sense code.                               */
+    CPU_INT08U  ASCQ;                                           /* Additional sense code qualifier.                     */
+} USBH_MSC_SENSE;
+
+                                                                /* --------------- RECOVERY STATISTICS ---------------- */
+typedef  struct  usbh_msc_recovery_stat {
+    CPU_INT32U  SenseCnt;                                       /* Nbr of sense data received.                          */
+    CPU_INT32U  RetryCnt;                                       /* Nbr of cmds retried after a transient condition.     */
+    CPU_INT32U  RetryOkCnt;                                     /* Nbr of retried rd/wr that completed.                 */
+    CPU_INT32U  StallClrCnt;                                    /* Nbr of halted EPs cleared without reset.             */
+    CPU_INT32U  ResetCnt;                                       /* Nbr of reset recoveries.                             */
+} USBH_MSC_RECOVERY_STAT;
+
                                                                 /* -------------------- MSC DEVICE -------------------- */
-typedef  struct  usbh_msc_dev {
-    USBH_EP       BulkInEP;                                     /* Bulk IN  endpoint.                                   */
-    USBH_EP       BulkOutEP;                                    /* Bulk OUT endpoint.                                   */
-    USBH_DEV     *DevPtr;                                       /* Pointer to USB device.                               */
-    USBH_IF      *IF_Ptr;                                       /* Pointer to interface.                                */
-    CPU_INT08U    State;                                        /* State of MSC device.                                 */
-    CPU_INT08U    RefCnt;                                       /* Cnt of app ref on this dev.                          */
-    USBH_HMUTEX   HMutex;
-} USBH_MSC_DEV;
+struct  usbh_msc_dev {
+    USBH_EP        BulkInEP;                                    /* Bulk IN  endpoint.                                   */
+    USBH_EP        BulkOutEP;                                   /* Bulk OUT endpoint.                                   */
+    USBH_DEV      *DevPtr;                                      /* Pointer to USB device.                               */
+    USBH_IF       *IF_Ptr;                                      /* Pointer to interface.                                */
+    CPU_INT08U     State;                                       /* State of MSC device.                                 */
+    CPU_INT08U     RefCnt;                                      /* Cnt of app ref on this dev.                          */
+    USBH_HMUTEX    HMutex;
+    USBH_SCSI_LUN  LUN_Tbl[USBH_MSC_CFG_MAX_LUN];               /* Cmd format of each LUN.                              */
+                                                                /* Last sense data of each LUN.                         */
+    USBH_MSC_SENSE          SenseTbl[USBH_MSC_CFG_MAX_LUN];
+    USBH_MSC_RECOVERY_STAT  RecoveryStat;                       /* Recovery statistics.                                 */
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+    USBH_MSC_CMD   CmdTbl[USBH_MSC_CFG_CMD_Q_LEN];              /* Pipelined cmds.                                      */
+    USBH_MSC_CMD  *CmdFreePtr;                                  /* Ptr to first free cmd.                               */
+    USBH_MSC_CMD  *CmdRsvPtr;                                   /* Ptr to first cmd handed over to a waiting task.      */
+    USBH_MSC_CMD  *CmdHeadPtr;                                  /* Ptr to cmd being executed.                           */
+    USBH_MSC_CMD  *CmdTailPtr;                                  /* Ptr to last queued cmd.                              */
+    USBH_HSEM      CmdFreeSem;                                  /* Sem signaled when a cmd is freed.                    */
+    CPU_INT08U     CmdWaitCnt;                                  /* Nbr of tasks waiting for a free cmd.                 */
+    CPU_INT32U     CmdTag;                                      /* Tag of last queued CBW.                              */
+    CPU_INT08U     CmdLUN;                                      /* LUN of last started cmd.                             */
+    CPU_INT08U     CmdRdCnt;                                    /* Nbr of rds started in a row ahead of a wr.           */
+#endif
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+                                                                /* Cached blks.                                         */
+    USBH_MSC_CACHE_BLK   CacheBlkTbl[USBH_MSC_CFG_CACHE_BLK_NBR];
+    USBH_MSC_CACHE_BLK  *CacheHeadPtr;                          /* Ptr to most  recently used blk.                      */
+    USBH_MSC_CACHE_BLK  *CacheTailPtr;                          /* Ptr to least recently used blk.                      */
+    CPU_INT08U          *CacheXferBufPtr;                       /* Ptr to buf of read-ahead and write-back cmds.        */
+    CPU_INT32U           CacheBlkSize;                          /* Size of cached blks, 0 if cache empty.               */
+    CPU_INT08U           CacheSeqLUN;                           /* LUN        of last cached rd.                        */
+    CPU_INT64U           CacheSeqBlkAddr;                       /* Blk addr following last cached rd.                   */
+    USBH_MSC_CACHE_STAT  CacheStat;                             /* Cache statistics.                                    */
+#endif
+};
 
 typedef  struct  msc_inquiry_info {
     CPU_INT08U  DevType;
@@ -138,6 +390,11 @@ USBH_ERR    USBH_MSC_CapacityRd  (USBH_MSC_DEV           *p_msc_dev,
                                   CPU_INT32U             *p_nbr_blks,
                                   CPU_INT32U             *p_blk_size);
 
+USBH_ERR    USBH_MSC_CapacityRd64(USBH_MSC_DEV           *p_msc_dev,
+                                  CPU_INT08U              lun,
+                                  CPU_INT64U             *p_nbr_blks,
+                                  CPU_INT32U             *p_blk_size);
+
 USBH_ERR    USBH_MSC_StdInquiry  (USBH_MSC_DEV           *p_msc_dev,
                                   USBH_MSC_INQUIRY_INFO  *p_msc_inquiry_info,
                                   CPU_INT08U              lun);
@@ -148,20 +405,85 @@ USBH_ERR    USBH_MSC_RefRel      (USBH_MSC_DEV           *p_msc_dev);
 
 CPU_INT32U  USBH_MSC_Rd          (USBH_MSC_DEV           *p_msc_dev,
                                   CPU_INT08U              lun,
-                                  CPU_INT32U              blk_addr,
-                                  CPU_INT16U              nbr_blks,
+                                  CPU_INT64U              blk_addr,
+                                  CPU_INT32U              nbr_blks,
                                   CPU_INT32U              blk_size,
                                   void                   *p_arg,
                                   USBH_ERR               *p_err);
 
 CPU_INT32U  USBH_MSC_Wr          (USBH_MSC_DEV           *p_msc_dev,
                                   CPU_INT08U              lun,
-                                  CPU_INT32U              blk_addr,
-                                  CPU_INT16U              nbr_blks,
+                                  CPU_INT64U              blk_addr,
+                                  CPU_INT32U              nbr_blks,
                                   CPU_INT32U              blk_size,
                                   const  void            *p_arg,
                                   USBH_ERR               *p_err);
 
+#if (USBH_MSC_CFG_PIPE_EN == DEF_ENABLED)
+USBH_ERR    USBH_MSC_RdAsync     (USBH_MSC_DEV           *p_msc_dev,
+                                  CPU_INT08U              lun,
+                                  CPU_INT64U              blk_addr,
+                                  CPU_INT32U              nbr_blks,
+                                  CPU_INT32U              blk_size,
+                                  void                   *p_arg,
+                                  USBH_MSC_XFER_CMPL_FNCT fnct,
+                                  void                   *p_fnct_arg);
+
+USBH_ERR    USBH_MSC_WrAsync     (USBH_MSC_DEV           *p_msc_dev,
+                                  CPU_INT08U              lun,
+                                  CPU_INT64U              blk_addr,
+                                  CPU_INT32U              nbr_blks,
+                                  CPU_INT32U              blk_size,
+                                  const  void            *p_arg,
+                                  USBH_MSC_XFER_CMPL_FNCT fnct,
+                                  void                   *p_fnct_arg);
+#endif
+
+#if (USBH_MSC_CFG_CACHE_EN == DEF_ENABLED)
+USBH_ERR    USBH_MSC_CacheFlush  (USBH_MSC_DEV           *p_msc_dev,
+                                  CPU_INT08U              lun);
+
+USBH_ERR    USBH_MSC_CacheStatGet(USBH_MSC_DEV           *p_msc_dev,
+                                  USBH_MSC_CACHE_STAT    *p_stat);
+
+USBH_ERR    USBH_MSC_CacheStatClr(USBH_MSC_DEV           *p_msc_dev);
+#endif
+
+USBH_ERR    USBH_MSC_SenseGet    (USBH_MSC_DEV           *p_msc_dev,
+                                  CPU_INT08U              lun,
+                                  USBH_MSC_SENSE         *p_sense);
+
+USBH_ERR    USBH_MSC_RecoveryStatGet(USBH_MSC_DEV            *p_msc_dev,
+                                     USBH_MSC_RECOVERY_STAT  *p_stat);
+
+USBH_ERR    USBH_MSC_RecoveryStatClr(USBH_MSC_DEV            *p_msc_dev);
+
+                                                                /* ------------ SCSI BLK CMDS (see Note #6) ----------- */
+void        USBH_SCSI_BlkLimitsRd  (USBH_SCSI_LUN          *p_lun,
+                                    USBH_SCSI_XFER_FNCT     xfer_fnct,
+                                    void                   *p_dev,
+                                    CPU_INT08U              lun);
+
+CPU_INT32U  USBH_SCSI_XferBlkMaxGet(const  USBH_SCSI_LUN   *p_lun,
+                                    CPU_INT32U              blk_size);
+
+CPU_INT08U  USBH_SCSI_RdWrFmt      (const  USBH_SCSI_LUN   *p_lun,
+                                    USBH_MSC_DATA_DIR       dir,
+                                    CPU_INT64U              blk_addr,
+                                    CPU_INT32U              nbr_blks,
+                                    CPU_INT08U             *p_cmd);
+
+CPU_INT32U  USBH_SCSI_RdWr         (const  USBH_SCSI_LUN   *p_lun,
+                                    USBH_SCSI_XFER_FNCT     xfer_fnct,
+                                    void                   *p_dev,
+                                    CPU_INT08U              lun,
+                                    USBH_MSC_DATA_DIR       dir,
+                                    CPU_INT64U              blk_addr,
+                                    CPU_INT32U              nbr_blks,
+                                    CPU_INT32U              blk_size,
+                                    void                   *p_arg,
+                                    USBH_ERR               *p_err);
+
 
 /*
 *********************************************************************************************************
@@ -169,6 +491,54 @@ CPU_INT32U  USBH_MSC_Wr          (USBH_MSC_DEV           *p_msc_dev,
 *********************************************************************************************************
 */
 
+#if    ((USBH_MSC_CFG_PIPE_EN != DEF_DISABLED) && \
+        (USBH_MSC_CFG_PIPE_EN != DEF_ENABLED ))
+#error  "USBH_MSC_CFG_PIPE_EN                  illegally #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#endif
+
+#if    ((USBH_MSC_CFG_PIPE_EN   == DEF_ENABLED) && \
+        (USBH_MSC_CFG_CMD_Q_LEN <  1u))
+#error  "USBH_MSC_CFG_CMD_Q_LEN                illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1]                     "
+#endif
+
+#if    ((USBH_MSC_CFG_PIPE_EN     == DEF_ENABLED) && \
+        (USBH_MSC_CFG_RD_PRIO_MAX >  254u))
+#error  "USBH_MSC_CFG_RD_PRIO_MAX              illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be <= 254]                   "
+#endif
+
+#if    ((USBH_MSC_CFG_CACHE_EN != DEF_DISABLED) && \
+        (USBH_MSC_CFG_CACHE_EN != DEF_ENABLED ))
+#error  "USBH_MSC_CFG_CACHE_EN                 illegally #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#endif
+
+#if    ((USBH_MSC_CFG_CACHE_EN       == DEF_ENABLED) && \
+        (USBH_MSC_CFG_CACHE_BLK_SIZE <  1u))
+#error  "USBH_MSC_CFG_CACHE_BLK_SIZE           illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1]                     "
+#endif
+
+#if    ((USBH_MSC_CFG_CACHE_EN           == DEF_ENABLED) && \
+       ((USBH_MSC_CFG_CACHE_XFER_BLK_NBR <  1u) || \
+        (USBH_MSC_CFG_CACHE_XFER_BLK_NBR >  USBH_MSC_CFG_CACHE_BLK_NBR)))
+#error  "USBH_MSC_CFG_CACHE_XFER_BLK_NBR       illegally #define'd in 'usbh_cfg.h'"
+#error  "                         [MUST be >= 1 && <= USBH_MSC_CFG_CACHE_BLK_NBR]  "
+#endif
+
+#if    ((USBH_MSC_CFG_MAX_LUN <  1u) || \
+        (USBH_MSC_CFG_MAX_LUN > 16u))
+#error  "USBH_MSC_CFG_MAX_LUN                  illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1 && <= 16]            "
+#endif
+
+#if     (USBH_MSC_CFG_RETRY_NBR > 8u)
+#error  "USBH_MSC_CFG_RETRY_NBR                illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be <= 8]                     "
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -0,0 +1,3395 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                      USB ATTACHED SCSI (UAS)
+*
+* Filename : usbh_uas.c
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) The transport is documented in 'Universal Serial Bus Attached SCSI (UAS)', Revision 1.0,
+*                and in 'USB Attached SCSI (UAS) - T10/2095-D', Revision 4.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define   USBH_UAS_MODULE
+#define   MICRIUM_SOURCE
+#include  "usbh_uas.h"
+#include  "../../Source/usbh_core.h"
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  USBH_UAS_SUBCLASS_CODE_SCSI                        0x06u
+#define  USBH_UAS_PROTOCOL_CODE_UAS                         0x62u
+
+                                                                /* ------------- PIPE USAGE DESCRIPTOR ---------------- */
+#define  USBH_UAS_DESC_TYPE_PIPE_USAGE                      0x24u
+#define  USBH_UAS_LEN_DESC_PIPE_USAGE                          4u
+
+#define  USBH_UAS_PIPE_ID_CMD                               0x01u
+#define  USBH_UAS_PIPE_ID_STATUS                            0x02u
+#define  USBH_UAS_PIPE_ID_DATA_IN                           0x03u
+#define  USBH_UAS_PIPE_ID_DATA_OUT                          0x04u
+                                                                /* ----------------- INFORMATION UNITS ---------------- */
+#define  USBH_UAS_IU_ID_CMD                                 0x01u
+#define  USBH_UAS_IU_ID_SENSE                               0x03u
+#define  USBH_UAS_IU_ID_RESPONSE                            0x04u
+#define  USBH_UAS_IU_ID_TASK_MGMT                           0x05u
+#define  USBH_UAS_IU_ID_READ_READY                          0x06u
+#define  USBH_UAS_IU_ID_WRITE_READY                         0x07u
+
+#define  USBH_UAS_LEN_READY_IU                                 4u
+#define  USBH_UAS_LEN_SENSE_IU                                16u   /* SENSE IU without sense data.                     */
+#define  USBH_UAS_LEN_SENSE_MIN                               14u   /* Fixed sense data up to ASCQ.                     */
+
+                                                                /* ------------------- CMD FLAGS ---------------------- */
+#define  USBH_UAS_CMD_FLAG_ACTIVE                   DEF_BIT_00  /* COMMAND IU submitted.                                */
+#define  USBH_UAS_CMD_FLAG_STATUS_RX                DEF_BIT_01  /* SENSE IU received.                                   */
+#define  USBH_UAS_CMD_FLAG_DATA_SHORT               DEF_BIT_02  /* Data xfer ended by short pkt.                        */
+#define  USBH_UAS_CMD_FLAG_FAILED                   DEF_BIT_03  /* Cmd failed by dev recovery.                          */
+#define  USBH_UAS_CMD_FLAG_DONE                     DEF_BIT_04  /* Cmd completed.                                       */
+
+                                                                /* ------------------ ENGINE FLAGS -------------------- */
+#define  USBH_UAS_DEV_FLAG_RUN                      DEF_BIT_00  /* Engine being run.                                    */
+#define  USBH_UAS_DEV_FLAG_RUN_REQ                  DEF_BIT_01  /* Run requested while running.                         */
+#define  USBH_UAS_DEV_FLAG_STATUS_SUBMIT            DEF_BIT_02  /* Status IU submitted.                                 */
+#define  USBH_UAS_DEV_FLAG_STATUS_DISCARD           DEF_BIT_03  /* Status IU submitted before recovery.                 */
+#define  USBH_UAS_DEV_FLAG_DATA_IN_ABORT            DEF_BIT_04  /* Stale data-in  pieces to abort.                      */
+#define  USBH_UAS_DEV_FLAG_DATA_OUT_ABORT           DEF_BIT_05  /* Stale data-out pieces to abort.                      */
+
+
+/*
+*********************************************************************************************************
+*                                            SCSI DEFINES
+*********************************************************************************************************
+*/
+
+                                                                /* ------------------- SCSI OPCODES ------------------- */
+#define  USBH_SCSI_CMD_TEST_UNIT_READY                      0x00u
+#define  USBH_SCSI_CMD_INQUIRY                              0x12u
+#define  USBH_SCSI_CMD_READ_CAPACITY                        0x25u
+#define  USBH_SCSI_CMD_SERVICE_ACTION_IN_16                 0x9Eu
+#define  USBH_SCSI_CMD_REPORT_LUNS                          0xA0u
+                                                                /* ---------------- SCSI STATUS CODES ----------------- */
+#define  USBH_SCSI_STATUS_GOOD                              0x00u
+                                                                /* ----------------- SCSI SENSE KEYS ------------------ */
+#define  USBH_SCSI_SENSE_KEY_NOT_RDY                        0x02u
+#define  USBH_SCSI_SENSE_KEY_UNIT_ATTENTION                 0x06u
+                                                                /* ----------- SCSI ADDITIONAL SENSE CODES ------------ */
+#define  USBH_SCSI_ASC_NOT_RDY_TO_RDY_CHANGE                0x28u
+#define  USBH_SCSI_ASC_MEDIUM_NOT_PRESENT                   0x3Au
+                                                                /* --------------- SCSI SERVICE ACTIONS --------------- */
+#define  USBH_SCSI_SA_READ_CAPACITY_16                      0x10u
+                                                                /* ----------------- SCSI CMD LIMITS ------------------ */
+#define  USBH_SCSI_LBA_MAX_10                         0xFFFFFFFFu   /* Max LBA of a READ (10) / WRITE (10) cmd.         */
+#define  USBH_SCSI_REPORT_LUNS_MAX                             8u   /* Max nbr of LUNs read by REPORT LUNS.             */
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL CONSTANTS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                          LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_uas_sense {
+    CPU_INT08U  Key;                                            /* Sense key.                                           */
+    CPU_INT08U  ASC;                                            /* Additional sense code.                               */
+    CPU_INT08U  ASCQ;                                           /* Additional sense code qualifier.                     */
+} USBH_UAS_SENSE;
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  USBH_UAS_DEV  USBH_UAS_DevArr[USBH_UAS_CFG_MAX_DEV];
+static  MEM_POOL      USBH_UAS_DevPool;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void          USBH_UAS_GlobalInit        (USBH_ERR                 *p_err);
+
+static  void         *USBH_UAS_ProbeIF           (USBH_DEV                 *p_dev,
+                                                  USBH_IF                  *p_if,
+                                                  USBH_ERR                 *p_err);
+
+static  void          USBH_UAS_Disconn           (void                     *p_class_dev);
+
+static  void          USBH_UAS_Suspend           (void                     *p_class_dev);
+
+static  void          USBH_UAS_Resume            (void                     *p_class_dev);
+
+static  void          USBH_UAS_DevClr            (USBH_UAS_DEV             *p_uas_dev);
+
+static  CPU_INT08U    USBH_UAS_PipeAddrGet       (USBH_IF                  *p_if,
+                                                  CPU_INT08U                alt_ix,
+                                                  CPU_INT08U                pipe_id);
+
+static  USBH_ERR      USBH_UAS_EP_Open           (USBH_UAS_DEV             *p_uas_dev);
+
+static  void          USBH_UAS_EP_Close          (USBH_UAS_DEV             *p_uas_dev);
+
+static  CPU_INT32U    USBH_UAS_XferCmd           (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun,
+                                                  USBH_MSC_DATA_DIR         dir,
+                                                  void                     *p_cb,
+                                                  CPU_INT08U                cb_len,
+                                                  void                     *p_arg,
+                                                  CPU_INT32U                data_len,
+                                                  USBH_UAS_SENSE           *p_sense,
+                                                  USBH_ERR                 *p_err);
+
+static  USBH_ERR      USBH_UAS_XferCmdAsync      (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun,
+                                                  USBH_MSC_DATA_DIR         dir,
+                                                  void                     *p_cb,
+                                                  CPU_INT08U                cb_len,
+                                                  void                     *p_arg,
+                                                  CPU_INT32U                data_len,
+                                                  USBH_UAS_XFER_CMPL_FNCT   fnct,
+                                                  void                     *p_fnct_arg);
+
+static  USBH_UAS_CMD *USBH_UAS_CmdGet            (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_BOOLEAN               wait,
+                                                  USBH_ERR                 *p_err);
+
+static  void          USBH_UAS_CmdRel            (USBH_UAS_DEV             *p_uas_dev,
+                                                  USBH_UAS_CMD             *p_cmd);
+
+static  void          USBH_UAS_CmdStart          (USBH_UAS_DEV             *p_uas_dev,
+                                                  USBH_UAS_CMD             *p_cmd,
+                                                  CPU_INT08U                lun,
+                                                  USBH_MSC_DATA_DIR         dir,
+                                                  void                     *p_cb,
+                                                  CPU_INT08U                cb_len,
+                                                  void                     *p_arg,
+                                                  CPU_INT32U                data_len,
+                                                  USBH_UAS_XFER_CMPL_FNCT   fnct,
+                                                  void                     *p_fnct_arg);
+
+static  void          USBH_UAS_CmdAsyncEnd       (USBH_UAS_CMD             *p_cmd);
+
+static  void          USBH_UAS_CmdDoneChk        (USBH_UAS_DEV             *p_uas_dev,
+                                                  USBH_UAS_CMD             *p_cmd);
+
+static  void          USBH_UAS_ErrSet            (USBH_UAS_DEV             *p_uas_dev,
+                                                  USBH_ERR                  err);
+
+static  void          USBH_UAS_Run               (USBH_UAS_DEV             *p_uas_dev);
+
+static  void          USBH_UAS_Submit            (USBH_UAS_DEV             *p_uas_dev);
+
+static  void          USBH_UAS_DataFill          (USBH_UAS_DEV             *p_uas_dev,
+                                                  USBH_EP                  *p_ep,
+                                                  USBH_UAS_CMD            **pp_cmd);
+
+static  void          USBH_UAS_Recover           (USBH_UAS_DEV             *p_uas_dev,
+                                                  USBH_ERR                  err);
+
+static  void          USBH_UAS_CmdCmpl           (USBH_EP                  *p_ep,
+                                                  void                     *p_buf,
+                                                  CPU_INT32U                buf_len,
+                                                  CPU_INT32U                xfer_len,
+                                                  void                     *p_arg,
+                                                  USBH_ERR                  err);
+
+static  void          USBH_UAS_StatusCmpl        (USBH_EP                  *p_ep,
+                                                  void                     *p_buf,
+                                                  CPU_INT32U                buf_len,
+                                                  CPU_INT32U                xfer_len,
+                                                  void                     *p_arg,
+                                                  USBH_ERR                  err);
+
+static  void          USBH_UAS_StatusParse       (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT32U                xfer_len);
+
+static  void          USBH_UAS_DataCmpl          (USBH_EP                  *p_ep,
+                                                  void                     *p_buf,
+                                                  CPU_INT32U                buf_len,
+                                                  CPU_INT32U                xfer_len,
+                                                  void                     *p_arg,
+                                                  USBH_ERR                  err);
+
+static  USBH_ERR      USBH_UAS_SCSI_TestUnitReady(USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun,
+                                                  USBH_UAS_SENSE           *p_sense);
+
+static  USBH_ERR      USBH_UAS_SCSI_StdInquiry   (USBH_UAS_DEV             *p_uas_dev,
+                                                  USBH_MSC_INQUIRY_INFO    *p_inquiry_info,
+                                                  CPU_INT08U                lun);
+
+static  USBH_ERR      USBH_UAS_SCSI_CapacityRd   (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun,
+                                                  CPU_INT64U               *p_nbr_blks,
+                                                  CPU_INT32U               *p_blk_size);
+
+static  USBH_ERR      USBH_UAS_SCSI_CapacityRd16 (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun,
+                                                  CPU_INT64U               *p_nbr_blks,
+                                                  CPU_INT32U               *p_blk_size);
+
+static  USBH_SCSI_LUN  *USBH_UAS_LUN_Get        (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun);
+
+static  CPU_INT32U    USBH_UAS_SCSI_Xfer         (void                     *p_dev,
+                                                  CPU_INT08U                lun,
+                                                  USBH_MSC_DATA_DIR         dir,
+                                                  void                     *p_cb,
+                                                  CPU_INT08U                cb_len,
+                                                  void                     *p_arg,
+                                                  CPU_INT32U                data_len,
+                                                  USBH_ERR                 *p_err);
+
+static  CPU_INT32U    USBH_UAS_SCSI_RdWr         (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun,
+                                                  USBH_MSC_DATA_DIR         dir,
+                                                  CPU_INT64U                blk_addr,
+                                                  CPU_INT32U                nbr_blks,
+                                                  CPU_INT32U                blk_size,
+                                                  void                     *p_arg,
+                                                  USBH_ERR                 *p_err);
+
+static  USBH_ERR      USBH_UAS_SCSI_RdWrAsync    (USBH_UAS_DEV             *p_uas_dev,
+                                                  CPU_INT08U                lun,
+                                                  USBH_MSC_DATA_DIR         dir,
+                                                  CPU_INT64U                blk_addr,
+                                                  CPU_INT32U                nbr_blks,
+                                                  CPU_INT32U                blk_size,
+                                                  void                     *p_arg,
+                                                  USBH_UAS_XFER_CMPL_FNCT   fnct,
+                                                  void                     *p_fnct_arg);
+
+
+/*
+*********************************************************************************************************
+*                                     LOCAL CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                   INITIALIZED GLOBAL VARIABLES ACCESSES BY OTHER MODULES/OBJECTS
+*********************************************************************************************************
+*/
+
+USBH_CLASS_DRV  USBH_UAS_ClassDrv =  {
+    (CPU_INT08U *)"USB ATTACHED SCSI",
+                  USBH_UAS_GlobalInit,
+                  0,
+                  USBH_UAS_ProbeIF,
+                  USBH_UAS_Suspend,
+                  USBH_UAS_Resume,
+                  USBH_UAS_Disconn
+};
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           GLOBAL FUNCTION
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_UAS_Init()
+*
+* Description : Initialize a UAS device instance.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Device logical unit number to initialize.
+*
+* Return(s)   : USBH_ERR_NONE,                          if UAS device initialization is successful.
+*               USBH_ERR_INVALID_ARG,                   if invalid argument passed to 'p_uas_dev'.
+*               USBH_ERR_DEV_NOT_READY,                 if UAS device not ready for communication.
+*
+*                                                       ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'mutex'.
+*               USBH_ERR_OS_ABORT,                      If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,                       Otherwise.
+*
+* Note(s)     : (1) As with USBH_MSC_Init(), TEST UNIT READY is sent up to 40 times while the device
+*                   reports it is not ready. The sense data is returned by the SENSE IU of the failed
+*                   command, so that no REQUEST SENSE command is needed.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_Init (USBH_UAS_DEV  *p_uas_dev,
+                         CPU_INT08U     lun)
+{
+    CPU_INT08U      retry;
+    CPU_BOOLEAN     unit_ready;
+    USBH_UAS_SENSE  sense;
+    USBH_ERR        err;
+
+                                                                /* ------------------- VALIDATE ARG ------------------- */
+    if (p_uas_dev == (USBH_UAS_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err = USBH_OS_MutexLock(p_uas_dev->HMutex);                 /* Acquire UAS dev lock to avoid multiple access.       */
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* See Note #1.                                         */
+    if ((p_uas_dev->State  == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_uas_dev->RefCnt  > 0u                       )) {
+
+#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
+        USBH_PRINT_LOG("UAS device (LUN %d) is initializing ...\r\n", lun);
+#endif
+        retry      = 40u;
+        unit_ready = DEF_FALSE;
+
+        while (retry > 0u) {
+                                                                /* --------------- TEST_UNIT_READY CMD ---------------- */
+            err = USBH_UAS_SCSI_TestUnitReady(p_uas_dev, lun, &sense);
+            if (err == USBH_ERR_NONE) {                         /* UAS dev ready for comm.                              */
+                unit_ready = DEF_TRUE;
+                break;
+            } else if (err != USBH_ERR_MSC_CMD_FAILED) {        /* UAS xfers failed.                                    */
+                USBH_PRINT_ERR(err);
+                break;
+            } else {
+                switch (sense.Key) {
+                    case USBH_SCSI_SENSE_KEY_UNIT_ATTENTION:    /* UAS dev is initializing internally but not rdy.      */
+                         switch (sense.ASC) {
+                             case USBH_SCSI_ASC_MEDIUM_NOT_PRESENT:
+                             case USBH_SCSI_ASC_NOT_RDY_TO_RDY_CHANGE:
+                                  USBH_OS_DlyMS(500u);
+                                  break;
+
+                             default:                           /* Other Additional Sense Code values not supported.    */
+#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
+                                  USBH_PRINT_LOG("SENSE KEY : %02X, ASC : %02X, ASCQ : %02X\r\n", sense.Key, sense.ASC, sense.ASCQ);
+#endif
+                                  break;
+                         }
+                         break;
+
+                    case USBH_SCSI_SENSE_KEY_NOT_RDY:           /* UAS dev not ready.                                   */
+                         USBH_OS_DlyMS(500u);
+                         break;
+
+                    default:                                    /* Other Sense Key values not supported.                */
+#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
+                         USBH_PRINT_LOG("SENSE KEY : %02X, ASC : %02X, ASCQ : %02X\r\n", sense.Key, sense.ASC, sense.ASCQ);
+#endif
+                         break;
+                }
+
+                retry--;
+            }
+        }
+
+        if (unit_ready == DEF_FALSE) {
+#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
+            USBH_PRINT_LOG("Device is not ready\r\n");
+#endif
+            err = USBH_ERR_DEV_NOT_READY;
+        }
+
+    } else {
+        err = USBH_ERR_DEV_NOT_READY;                           /* UAS dev enum not completed by host.                  */
+    }
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);               /* Unlock access to UAS dev.                            */
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_MaxLUN_Get()
+*
+* Description : Get maximum logical unit number (LUN) supported by UAS device.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                       USBH_ERR_NONE                           Maximum LUN successfully retrieved.
+*                       USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_uas_dev'.
+*                       USBH_ERR_DEV_NOT_READY                  If device enumeration not completed.
+*
+*                                                               ----- RETURNED BY USBH_OS_MutexLock() : -----
+*                       USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'mutex'.
+*                       USBH_ERR_OS_ABORT,                      If mutex wait aborted.
+*                       USBH_ERR_OS_FAIL,                       Otherwise.
+*
+* Return(s)   : Maximum logical unit number.
+*
+* Note(s)     : (1) UAS has no GET MAX LUN request. The LUNs are read with the SCSI "REPORT LUNS" command,
+*                   documented in 'SCSI Primary Commands - 3 (SPC-3)', Section 6.21. Only the first
+*                   USBH_SCSI_REPORT_LUNS_MAX LUNs are accounted for.
+*
+*               (2) A device that rejects the command is assumed to have a single LUN, as a BOT device that
+*                   stalls GET MAX LUN.
+*********************************************************************************************************
+*/
+
+CPU_INT08U  USBH_UAS_MaxLUN_Get (USBH_UAS_DEV  *p_uas_dev,
+                                 USBH_ERR      *p_err)
+{
+    CPU_INT08U  cmd[12];
+    CPU_INT08U  data[8u + (8u * USBH_SCSI_REPORT_LUNS_MAX)];
+    CPU_INT32U  list_len;
+    CPU_INT32U  xfer_len;
+    CPU_INT32U  alloc_len;
+    CPU_INT08U  lun_nbr = 0u;
+
+                                                                /* ------------------ VALIDATE ARG -------------------- */
+    if (p_uas_dev == (USBH_UAS_DEV *)0) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (0u);
+    }
+
+   *p_err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
+    }
+                                                                /* ---------------- REPORT LUNS CMD ------------------- */
+    if ((p_uas_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_uas_dev->RefCnt > 0u                       )) {
+
+        alloc_len = sizeof(data);
+        Mem_Clr((void *)cmd, sizeof(cmd));
+        cmd[0] = USBH_SCSI_CMD_REPORT_LUNS;                     /* Operation code (0xA0).                               */
+        MEM_VAL_COPY_SET_INT32U_BIG(&cmd[6], &alloc_len);       /* Allocation length.                                   */
+
+        xfer_len = USBH_UAS_XferCmd(        p_uas_dev,          /* See Note #1.                                         */
+                                            0u,
+                                            USBH_MSC_DATA_DIR_IN,
+                                    (void *)cmd,
+                                            12u,
+                                    (void *)data,
+                                            alloc_len,
+                                            (USBH_UAS_SENSE *)0,
+                                            p_err);
+        if ((*p_err   == USBH_ERR_NONE) &&
+            (xfer_len >= 8u)) {
+            MEM_VAL_COPY_GET_INT32U_BIG(&list_len, &data[0]);
+            list_len = DEF_MIN(list_len / 8u, (xfer_len - 8u) / 8u);
+            if (list_len > 0u) {
+                lun_nbr = (CPU_INT08U)(list_len - 1u);
+            }
+        }
+       *p_err = USBH_ERR_NONE;                                  /* See Note #2.                                         */
+    } else {                                                    /* UAS dev enumeration not completed by host.           */
+       *p_err = USBH_ERR_DEV_NOT_READY;
+    }
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+
+    return (lun_nbr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_UnitRdyTest()
+*
+* Description : Test if a certain logical unit within the UAS device is ready for communication.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical unit number.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                       USBH_ERR_NONE                           Unit state successfully retrieved.
+*                       USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_uas_dev'.
+*                       USBH_ERR_DEV_NOT_READY                  If device enumeration not completed.
+*
+*                                                               ----- RETURNED BY USBH_OS_MutexLock() : -----
+*                       USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'mutex'.
+*                       USBH_ERR_OS_ABORT,                      If mutex wait aborted.
+*                       USBH_ERR_OS_FAIL,                       Otherwise.
+*
+*                                                               ---- RETURNED BY USBH_UAS_XferCmd() ----
+*                       USBH_ERR_MSC_IO                         Device reported a protocol error.
+*                       USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*                       Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : DEF_YES, if logical unit ready.
+*
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  USBH_UAS_UnitRdyTest (USBH_UAS_DEV  *p_uas_dev,
+                                   CPU_INT08U     lun,
+                                   USBH_ERR      *p_err)
+{
+    CPU_BOOLEAN  unit_rdy = DEF_NO;
+
+                                                                /* ------------------- VALIDATE PTR ------------------- */
+    if (p_uas_dev == (USBH_UAS_DEV *)0) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (unit_rdy);
+    }
+
+   *p_err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (*p_err != USBH_ERR_NONE) {
+        return (unit_rdy);
+    }
+                                                                /* --------------- TEST_UNIT_READY REQ ---------------- */
+    if ((p_uas_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_uas_dev->RefCnt > 0u                       )) {
+
+       *p_err = USBH_UAS_SCSI_TestUnitReady(p_uas_dev, lun, (USBH_UAS_SENSE *)0);
+        if (*p_err == USBH_ERR_NONE) {
+            unit_rdy = DEF_YES;
+        } else if (*p_err == USBH_ERR_MSC_CMD_FAILED) {
+           *p_err    = USBH_ERR_NONE;                           /* Cmd failed for this req NOT an err.                  */
+            unit_rdy = DEF_NO;
+        } else {
+                                                                /* Empty Else Statement                                 */
+        }
+    } else {                                                    /* UAS dev enumeration not completed by host.           */
+       *p_err = USBH_ERR_DEV_NOT_READY;
+    }
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+
+    return (unit_rdy);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_CapacityRd()
+*
+* Description : Read UAS device capacity (i.e number of blocks and block size) of specified LUN by sending
+*               READ_CAPACITY SCSI command.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical unit number.
+*
+*               p_nbr_blks      Pointer to variable that receives number of blocks.
+*
+*               p_blk_size      Pointer to variable that receives block size.
+*
+* Return(s)   : USBH_ERR_NONE,              If capacity of UAS device retrieved successfully.
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'p_uas_dev' / 'p_nbr_blks' /
+*                                           'p_blk_size'.
+*               USBH_ERR_NOT_SUPPORTED,     If number of blocks does not fit in 32 bits (see Note #1).
+*
+*                                           ----- RETURNED BY USBH_UAS_CapacityRd64() : -----
+*               USBH_ERR_DEV_NOT_READY,     If device enumeration not completed.
+*               USBH_ERR_OS_ABORT,          If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,           Otherwise.
+*               List error codes from USBH_UAS_SCSI_CapacityRd
+*
+* Note(s)     : (1) Devices of more than 2^32 blocks must be accessed with USBH_UAS_CapacityRd64().
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_CapacityRd (USBH_UAS_DEV  *p_uas_dev,
+                               CPU_INT08U     lun,
+                               CPU_INT32U    *p_nbr_blks,
+                               CPU_INT32U    *p_blk_size)
+{
+    CPU_INT64U  nbr_blks;
+    USBH_ERR    err;
+
+                                                                /* ------------------- VALIDATE PTR ------------------- */
+    if (p_nbr_blks == (CPU_INT32U *)0) {
+        err = USBH_ERR_INVALID_ARG;
+        return (err);
+    }
+
+    err = USBH_UAS_CapacityRd64( p_uas_dev,
+                                 lun,
+                                &nbr_blks,
+                                 p_blk_size);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    if (nbr_blks > DEF_INT_32U_MAX_VAL) {                       /* See Note #1.                                         */
+        err = USBH_ERR_NOT_SUPPORTED;
+    } else {
+       *p_nbr_blks = (CPU_INT32U)nbr_blks;
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_UAS_CapacityRd64()
+*
+* Description : Read UAS device capacity (i.e number of blocks and block size) of specified LUN by sending
+*               READ_CAPACITY (10) and, for devices of more than 2^32 blocks, READ_CAPACITY (16) SCSI
+*               commands.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical unit number.
+*
+*               p_nbr_blks      Pointer to variable that receives number of blocks.
+*
+*               p_blk_size      Pointer to variable that receives block size.
+*
+* Return(s)   : USBH_ERR_NONE,              If capacity of UAS device retrieved successfully.
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'p_uas_dev' / 'p_nbr_blks' /
+*                                           'p_blk_size'.
+*               USBH_ERR_DEV_NOT_READY,     If device enumeration not completed.
+*
+*                                           ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'mutex'.
+*               USBH_ERR_OS_ABORT,          If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,           Otherwise.
+*               List error codes from USBH_UAS_SCSI_CapacityRd
+*
+* Note(s)     : (1) The first successful capacity read of a LUN also requests its Block Limits VPD page,
+*                   which bounds the number of blocks of each read or write command of the LUN (see
+*                   USBH_SCSI_RdWr()). The page is not requested for LUNs beyond USBH_UAS_CFG_MAX_LUN.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_CapacityRd64 (USBH_UAS_DEV  *p_uas_dev,
+                                 CPU_INT08U     lun,
+                                 CPU_INT64U    *p_nbr_blks,
+                                 CPU_INT32U    *p_blk_size)
+{
+    USBH_ERR  err;
+
+                                                                /* ------------------- VALIDATE PTR ------------------- */
+    if ((p_uas_dev  == (USBH_UAS_DEV *)0) ||
+        (p_nbr_blks == (CPU_INT64U   *)0) ||
+        (p_blk_size == (CPU_INT32U   *)0)) {
+        err = USBH_ERR_INVALID_ARG;
+        return (err);
+    }
+
+    err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* -------------- READ_CAPACITY REQUEST --------------- */
+    if ((p_uas_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_uas_dev->RefCnt > 0u                       )) {
+
+        err = USBH_UAS_SCSI_CapacityRd(p_uas_dev,
+                                       lun,
+                                       p_nbr_blks,
+                                       p_blk_size);
+        if ((err == USBH_ERR_NONE       ) &&
+            (lun <  USBH_UAS_CFG_MAX_LUN)) {
+                                                                /* See Note #1.                                         */
+            USBH_SCSI_BlkLimitsRd(&p_uas_dev->LUN_Tbl[lun],
+                                   USBH_UAS_SCSI_Xfer,
+                           (void *)p_uas_dev,
+                                   lun);
+        }
+    } else {                                                    /* UAS dev enumeration not completed by host.           */
+        err = USBH_ERR_DEV_NOT_READY;
+    }
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);               /* Unlock access to UAS dev.                            */
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_StdInquiry()
+*
+* Description : Retrieve various information about a specific logical unit inside UAS device such as
+*               device type, if device is removable, vendor/product identification, etc. INQUIRY SCSI
+*               command is used.
+*
+* Argument(s) : p_uas_dev               Pointer to UAS device.
+*
+*               p_inquiry_info          Pointer to structure that will receive the informations.
+*
+*               lun                     Logical unit number.
+*
+* Return(s)   : USBH_ERR_NONE,              If information about logical unit retrieved successfully.
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'p_uas_dev' / 'p_inquiry_info'.
+*               USBH_ERR_NOT_SUPPORTED,     If INQUIRY command has failed.
+*               USBH_ERR_DEV_NOT_READY,     If device enumeration not completed.
+*
+*                                           ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'mutex'.
+*               USBH_ERR_OS_ABORT,          If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,           Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_StdInquiry (USBH_UAS_DEV           *p_uas_dev,
+                               USBH_MSC_INQUIRY_INFO  *p_inquiry_info,
+                               CPU_INT08U              lun)
+{
+    USBH_ERR  err;
+
+                                                                /* ------------------- VALIDATE PTR ------------------- */
+    if ((p_uas_dev      == (USBH_UAS_DEV          *)0) ||
+        (p_inquiry_info == (USBH_MSC_INQUIRY_INFO *)0)) {
+        err = USBH_ERR_INVALID_ARG;
+        return (err);
+    }
+
+    err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* ----------------- INQUIRY REQUEST ------------------ */
+    if ((p_uas_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_uas_dev->RefCnt > 0u                       )) {
+
+        err = USBH_UAS_SCSI_StdInquiry(p_uas_dev,
+                                       p_inquiry_info,
+                                       lun);
+        if (err != USBH_ERR_NONE) {
+            err = USBH_ERR_NOT_SUPPORTED;
+        }
+    } else {
+        err = USBH_ERR_DEV_NOT_READY;
+    }
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_RefAdd()
+*
+* Description : Increment counter of references on UAS device.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+* Return(s)   : USBH_ERR_NONE,              If counter successfully incremented.
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'p_uas_dev'.
+*
+*                                           ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'mutex'.
+*               USBH_ERR_OS_ABORT,          If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,           Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_RefAdd (USBH_UAS_DEV  *p_uas_dev)
+{
+    USBH_ERR  err;
+
+                                                                /* ------------------- VALIDATE ARG ------------------- */
+    if (p_uas_dev == (USBH_UAS_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    p_uas_dev->RefCnt++;
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_RefRel()
+*
+* Description : Decrement counter of references on UAS device and free device if counter = 0.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+* Return(s)   : USBH_ERR_NONE,              If counter successfully decremented.
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'p_uas_dev'.
+*
+*                                           ----- RETURNED BY USBH_OS_MutexLock() : -----
+*               USBH_ERR_INVALID_ARG,       If invalid argument passed to 'mutex'.
+*               USBH_ERR_OS_ABORT,          If mutex wait aborted.
+*               USBH_ERR_OS_FAIL,           Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_RefRel (USBH_UAS_DEV  *p_uas_dev)
+{
+    USBH_ERR  err;
+    LIB_ERR   err_lib;
+
+                                                                /* ------------------- VALIDATE PTR ------------------- */
+    if (p_uas_dev == (USBH_UAS_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    if (p_uas_dev->RefCnt > 0u) {
+        p_uas_dev->RefCnt--;
+
+        if ((p_uas_dev->RefCnt ==                           0u) &&
+            (p_uas_dev->State  == USBH_CLASS_DEV_STATE_DISCONN)) {
+                                                                /* Release UAS dev if no more ref on it.                */
+            Mem_PoolBlkFree(       &USBH_UAS_DevPool,
+                            (void *)p_uas_dev,
+                                   &err_lib);
+        }
+    }
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             USBH_UAS_Rd()
+*
+* Description : Read specified number of blocks from device using READ (10) or READ (16) SCSI commands.
+*
+* Argument(s) : p_uas_dev        Pointer to UAS device.
+*
+*               lun              Logical unit number.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to read.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                           USBH_ERR_NONE                           Block(s) read successfully.
+*                           USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_uas_dev'.
+*                           USBH_ERR_DEV_NOT_READY                  If device enumeration not completed.
+*
+*                                                                   ----- RETURNED BY USBH_OS_MutexLock() : -----
+*                           USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'mutex'.
+*                           USBH_ERR_OS_ABORT,                      If mutex wait aborted.
+*                           USBH_ERR_OS_FAIL,                       Otherwise.
+*
+*                                                                   ----- RETURNED BY USBH_UAS_SCSI_RdWr -----
+*                           USBH_ERR_INVALID_ARG                    If transfer exceeds 2^32 - 1 octets.
+*                           USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*                           USBH_ERR_MSC_IO                         Device reported a protocol error.
+*                           USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*                           Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets read.
+*
+* Note(s)     : (1) The device is unlocked before the commands are issued, so that the commands of
+*                   concurrent callers are outstanding on the device at the same time. The caller holds a
+*                   reference on the device, so that it is not freed meanwhile.
+*
+*               (2) A read larger than a single command accepts is split in several commands (see
+*                   USBH_UAS_SCSI_RdWr()).
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_UAS_Rd (USBH_UAS_DEV  *p_uas_dev,
+                         CPU_INT08U     lun,
+                         CPU_INT64U     blk_addr,
+                         CPU_INT32U     nbr_blks,
+                         CPU_INT32U     blk_size,
+                         void          *p_arg,
+                         USBH_ERR      *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+
+    if (p_uas_dev == (USBH_UAS_DEV *)0) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (0u);
+    }
+
+   *p_err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
+    }
+
+    if ((p_uas_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_uas_dev->RefCnt > 0u                       )) {
+        (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);           /* See Note #1.                                         */
+
+        xfer_len = USBH_UAS_SCSI_RdWr(p_uas_dev,                /* See Note #2.                                         */
+                                      lun,
+                                      USBH_MSC_DATA_DIR_IN,
+                                      blk_addr,
+                                      nbr_blks,
+                                      blk_size,
+                                      p_arg,
+                                      p_err);
+    } else {
+        (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+        xfer_len = 0u;
+       *p_err    = USBH_ERR_DEV_NOT_READY;
+    }
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             USBH_UAS_Wr()
+*
+* Description : Write specified number of blocks to device using WRITE (10) or WRITE (16) SCSI commands.
+*
+* Argument(s) : p_uas_dev        Pointer to UAS device.
+*
+*               lun              Logical unit number.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to write.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                       USBH_ERR_NONE                           Block(s) written successfully.
+*                       USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_uas_dev'.
+*                       USBH_ERR_DEV_NOT_READY                  If device enumeration not completed.
+*
+*                                                               ----- RETURNED BY USBH_OS_MutexLock() : -----
+*                       USBH_ERR_INVALID_ARG,                   If invalid argument passed to 'mutex'.
+*                       USBH_ERR_OS_ABORT,                      If mutex wait aborted.
+*                       USBH_ERR_OS_FAIL,                       Otherwise.
+*
+*                                                               ----- RETURNED BY USBH_UAS_SCSI_RdWr -----
+*                       USBH_ERR_INVALID_ARG                    If transfer exceeds 2^32 - 1 octets.
+*                       USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*                       USBH_ERR_MSC_IO                         Device reported a protocol error.
+*                       USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*                       Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets written.
+*
+* Note(s)     : (1) See USBH_UAS_Rd() Notes #1 and #2.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_UAS_Wr (       USBH_UAS_DEV  *p_uas_dev,
+                                CPU_INT08U     lun,
+                                CPU_INT64U     blk_addr,
+                                CPU_INT32U     nbr_blks,
+                                CPU_INT32U     blk_size,
+                         const  void          *p_arg,
+                                USBH_ERR      *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+
+    if (p_uas_dev == (USBH_UAS_DEV *)0) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (0u);
+    }
+
+   *p_err = USBH_OS_MutexLock(p_uas_dev->HMutex);
+    if (*p_err != USBH_ERR_NONE) {
+        return (0u);
+    }
+
+    if ((p_uas_dev->State == USBH_CLASS_DEV_STATE_CONN) &&
+        (p_uas_dev->RefCnt > 0u                       )) {
+        (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);           /* See Note #1.                                         */
+
+        xfer_len = USBH_UAS_SCSI_RdWr(        p_uas_dev,
+                                              lun,
+                                              USBH_MSC_DATA_DIR_OUT,
+                                              blk_addr,
+                                              nbr_blks,
+                                              blk_size,
+                                      (void *)p_arg,
+                                              p_err);
+    } else {
+        (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+        xfer_len = 0u;
+       *p_err    = USBH_ERR_DEV_NOT_READY;
+    }
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_RdAsync()
+*
+* Description : Issue a read of specified number of blocks from device using a READ (10) or READ (16) SCSI
+*               command. The function returns immediately and the completion is notified to the given
+*               function.
+*
+* Argument(s) : p_uas_dev        Pointer to UAS device.
+*
+*               lun              Logical unit number.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to read.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer. The buffer must remain valid until 'fnct' is called.
+*
+*               fnct             Function notified when the read completes (see Note #2).
+*
+*               p_fnct_arg       Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,                  if the read is successfully issued.
+*               USBH_ERR_INVALID_ARG,           if invalid argument passed to 'p_uas_dev' / 'fnct'.
+*               USBH_ERR_DEV_NOT_READY,         if device enumeration not completed.
+*
+*                                               ----- RETURNED BY USBH_UAS_SCSI_RdWrAsync() : -----
+*               USBH_ERR_INVALID_ARG,           if the read does not fit in one command (see Note #3).
+*               USBH_ERR_ALLOC,                 if USBH_UAS_CFG_CMD_Q_LEN commands are already outstanding.
+*
+* Note(s)     : (1) The read is sent to the device at once, with the commands already outstanding. The
+*                   device may complete them in any order. The device is not locked, so that this function
+*                   can be called from a completion function. The caller must hold a reference on the
+*                   device (see USBH_UAS_RefAdd()).
+*
+*               (2) 'fnct' is called with the number of octets read and the error code that USBH_UAS_Rd()
+*                   would have returned, from the asynchronous task or, if the device completes a command
+*                   while another command is issued, from the task issuing it. It may issue another
+*                   command.
+*
+*               (3) An asynchronous read is issued as a single command; it is not split like USBH_UAS_Rd()
+*                   does (see USBH_SCSI_XferBlkMaxGet()).
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_RdAsync (USBH_UAS_DEV             *p_uas_dev,
+                            CPU_INT08U                lun,
+                            CPU_INT64U                blk_addr,
+                            CPU_INT32U                nbr_blks,
+                            CPU_INT32U                blk_size,
+                            void                     *p_arg,
+                            USBH_UAS_XFER_CMPL_FNCT   fnct,
+                            void                     *p_fnct_arg)
+{
+    USBH_ERR  err;
+
+
+    if ((p_uas_dev == (USBH_UAS_DEV *)0) ||
+        (fnct      == (USBH_UAS_XFER_CMPL_FNCT)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    if ((p_uas_dev->State != USBH_CLASS_DEV_STATE_CONN) ||      /* See Note #1.                                         */
+        (p_uas_dev->RefCnt == 0u                       )) {
+        return (USBH_ERR_DEV_NOT_READY);
+    }
+
+    err = USBH_UAS_SCSI_RdWrAsync(p_uas_dev,
+                                  lun,
+                                  USBH_MSC_DATA_DIR_IN,
+                                  blk_addr,
+                                  nbr_blks,
+                                  blk_size,
+                                  p_arg,
+                                  fnct,
+                                  p_fnct_arg);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_WrAsync()
+*
+* Description : Issue a write of specified number of blocks to device using a WRITE (10) or WRITE (16) SCSI
+*               command. The function returns immediately and the completion is notified to the given
+*               function.
+*
+* Argument(s) : p_uas_dev        Pointer to UAS device.
+*
+*               lun              Logical unit number.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to write.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer. The buffer must remain valid until 'fnct' is called.
+*
+*               fnct             Function notified when the write completes.
+*
+*               p_fnct_arg       Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,                  if the write is successfully issued.
+*               USBH_ERR_INVALID_ARG,           if invalid argument passed to 'p_uas_dev' / 'fnct'.
+*               USBH_ERR_DEV_NOT_READY,         if device enumeration not completed.
+*
+*                                               ----- RETURNED BY USBH_UAS_SCSI_RdWrAsync() : -----
+*               USBH_ERR_INVALID_ARG,           if the write does not fit in one command.
+*               USBH_ERR_ALLOC,                 if USBH_UAS_CFG_CMD_Q_LEN commands are already outstanding.
+*
+* Note(s)     : (1) See USBH_UAS_RdAsync() Notes #1, #2 and #3. Writes issued asynchronously may be
+*                   executed by the device in any order.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_UAS_WrAsync (       USBH_UAS_DEV             *p_uas_dev,
+                                   CPU_INT08U                lun,
+                                   CPU_INT64U                blk_addr,
+                                   CPU_INT32U                nbr_blks,
+                                   CPU_INT32U                blk_size,
+                            const  void                     *p_arg,
+                                   USBH_UAS_XFER_CMPL_FNCT   fnct,
+                                   void                     *p_fnct_arg)
+{
+    USBH_ERR  err;
+
+
+    if ((p_uas_dev == (USBH_UAS_DEV *)0) ||
+        (fnct      == (USBH_UAS_XFER_CMPL_FNCT)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    if ((p_uas_dev->State != USBH_CLASS_DEV_STATE_CONN) ||      /* See Note #1.                                         */
+        (p_uas_dev->RefCnt == 0u                       )) {
+        return (USBH_ERR_DEV_NOT_READY);
+    }
+
+    err = USBH_UAS_SCSI_RdWrAsync(        p_uas_dev,
+                                          lun,
+                                          USBH_MSC_DATA_DIR_OUT,
+                                          blk_addr,
+                                          nbr_blks,
+                                          blk_size,
+                                  (void *)p_arg,
+                                          fnct,
+                                          p_fnct_arg);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_GlobalInit()
+*
+* Description : Initialize UAS.
+*
+* Argument(s) : p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                           USBH_ERR_NONE       UAS successfully initalized.
+*                           USBH_ERR_ALLOC      If UAS device cannot be allocated.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_GlobalInit (USBH_ERR  *p_err)
+{
+    CPU_INT08U  ix;
+    CPU_INT08U  cmd_ix;
+    CPU_SIZE_T  octets_reqd;
+    LIB_ERR     err_lib;
+
+                                                                /* --------------- INIT UAS DEV STRUCT ---------------- */
+    for (ix = 0u; ix < USBH_UAS_CFG_MAX_DEV; ix++) {
+        USBH_UAS_DevClr(&USBH_UAS_DevArr[ix]);
+        USBH_OS_MutexCreate(&USBH_UAS_DevArr[ix].HMutex);
+        (void)USBH_OS_SemCreate(&USBH_UAS_DevArr[ix].CmdFreeSem, 0u);
+        for (cmd_ix = 0u; cmd_ix < USBH_UAS_CFG_CMD_Q_LEN; cmd_ix++) {
+            (void)USBH_OS_SemCreate(&USBH_UAS_DevArr[ix].CmdTbl[cmd_ix].Sem, 0u);
+        }
+    }
+
+    Mem_PoolCreate (       &USBH_UAS_DevPool,                   /* POOL for managing UAS dev struct.                    */
+                    (void *)USBH_UAS_DevArr,
+                           (sizeof(USBH_UAS_DEV) * USBH_UAS_CFG_MAX_DEV),
+                            USBH_UAS_CFG_MAX_DEV,
+                            sizeof(USBH_UAS_DEV),
+                            sizeof(CPU_ALIGN),
+                           &octets_reqd,
+                           &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+#if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
+        USBH_PRINT_LOG("%d octets required\r\n", octets_reqd);
+#endif
+       *p_err = USBH_ERR_ALLOC;
+    } else {
+       *p_err = USBH_ERR_NONE;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_ProbeIF()
+*
+* Description : Determine if interface has a USB Attached SCSI alternate setting.
+*
+* Argument(s) : p_dev      Pointer to USB device.
+*
+*               p_if       Pointer to interface.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                       USBH_ERR_NONE                       UAS device successfully initalized.
+*                       USBH_ERR_DEV_ALLOC                  UAS device cannot be allocated.
+*                       USBH_ERR_CLASS_DRV_NOT_FOUND        IF has no UAS alternate setting.
+*
+*                                                           ----- RETURNED BY USBH_IF_DescGet() : -----
+*                       USBH_ERR_INVALID_ARG,               Invalid argument passed to 'alt_ix'.
+*
+*                                                           ----- RETURNED BY USBH_IF_Set() : -----
+*                       USBH_ERR_EP_STALL,                  Device rejected the alternate setting.
+*                       Host controller drivers error,      Otherwise.
+*
+*                                                           ----- RETURNED BY USBH_UAS_EP_Open -----
+*                       USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*                       USBH_ERR_EP_NOT_FOUND,              If a pipe is not described by the interface.
+*                       USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*                       Host controller drivers error,      Otherwise.
+*
+* Return(s)   : p_uas_dev,      if interface has a UAS alternate setting.
+*               0,              otherwise.
+*
+* Note(s)     : (1) A mass storage interface that implements UAS has a Bulk-Only Transport alternate
+*                   setting 0 and a UAS alternate setting (see 'Universal Serial Bus Attached SCSI (UAS)',
+*                   Section 4.1). An interface without UAS alternate setting is left to the mass storage
+*                   class driver (see 'usbh_uas.h  Note #4').
+*********************************************************************************************************
+*/
+
+static  void  *USBH_UAS_ProbeIF (USBH_DEV  *p_dev,
+                                 USBH_IF   *p_if,
+                                 USBH_ERR  *p_err)
+{
+    USBH_IF_DESC   if_desc;
+    USBH_UAS_DEV  *p_uas_dev;
+    CPU_INT08U     alt_nbr;
+    CPU_INT08U     alt_ix;
+    LIB_ERR        err_lib;
+
+
+    alt_nbr = USBH_IF_AltNbrGet(p_if);
+    for (alt_ix = 0u; alt_ix < alt_nbr; alt_ix++) {             /* See Note #1.                                         */
+       *p_err = USBH_IF_DescGet(p_if, alt_ix, &if_desc);
+        if (*p_err != USBH_ERR_NONE) {
+            return ((void *)0);
+        }
+                                                                /* Chk for class, sub class and protocol.               */
+        if ((if_desc.bInterfaceClass    == USBH_CLASS_CODE_MASS_STORAGE) &&
+            (if_desc.bInterfaceSubClass == USBH_UAS_SUBCLASS_CODE_SCSI)  &&
+            (if_desc.bInterfaceProtocol == USBH_UAS_PROTOCOL_CODE_UAS)) {
+            break;
+        }
+    }
+
+    if (alt_ix >= alt_nbr) {
+       *p_err = USBH_ERR_CLASS_DRV_NOT_FOUND;
+        return ((void *)0);
+    }
+                                                                /* Alloc dev from UAS dev pool.                         */
+    p_uas_dev = (USBH_UAS_DEV *)Mem_PoolBlkGet(&USBH_UAS_DevPool,
+                                                sizeof(USBH_UAS_DEV),
+                                               &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+       *p_err = USBH_ERR_DEV_ALLOC;
+        return ((void *)0);
+    }
+
+    USBH_UAS_DevClr(p_uas_dev);
+    p_uas_dev->State  = USBH_CLASS_DEV_STATE_CONN;
+    p_uas_dev->DevPtr = p_dev;
+    p_uas_dev->IF_Ptr = p_if;
+    p_uas_dev->AltIx  = alt_ix;
+
+   *p_err = USBH_IF_Set(p_if, alt_ix);                          /* Select UAS alternate setting before opening EPs.     */
+    if (*p_err == USBH_ERR_NONE) {
+       *p_err = USBH_UAS_EP_Open(p_uas_dev);                    /* Open cmd, status and data EPs.                       */
+    }
+
+    if (*p_err != USBH_ERR_NONE) {
+        Mem_PoolBlkFree(       &USBH_UAS_DevPool,
+                        (void *)p_uas_dev,
+                               &err_lib);
+        p_uas_dev = (USBH_UAS_DEV *)0;
+    }
+
+    return ((void *)p_uas_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_Disconn()
+*
+* Description : Handle disconnection of UAS device.
+*
+* Argument(s) : p_class_dev     Pointer to UAS device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Closing the endpoints aborts the URBs in progress. The outstanding commands are then
+*                   failed by the recovery of the device, which is not attempted once disconnected.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_Disconn (void  *p_class_dev)
+{
+    LIB_ERR        err_lib;
+    USBH_UAS_DEV  *p_uas_dev;
+
+
+    p_uas_dev = (USBH_UAS_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_uas_dev->HMutex);
+
+    p_uas_dev->State = USBH_CLASS_DEV_STATE_DISCONN;
+    USBH_UAS_EP_Close(p_uas_dev);                               /* See Note #1.                                         */
+
+    if (p_uas_dev->RefCnt == 0u) {                              /* Release UAS dev.                                     */
+        (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+        Mem_PoolBlkFree(       &USBH_UAS_DevPool,
+                        (void *)p_uas_dev,
+                               &err_lib);
+        return;
+    }
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_Suspend()
+*
+* Description : Suspend UAS device.
+*
+* Argument(s) : p_class_dev     Pointer to UAS device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_Suspend (void  *p_class_dev)
+{
+    USBH_UAS_DEV  *p_uas_dev;
+
+
+    p_uas_dev = (USBH_UAS_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_uas_dev->HMutex);
+
+    p_uas_dev->State = USBH_CLASS_DEV_STATE_SUSPEND;
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_Resume()
+*
+* Description : Resume UAS device.
+*
+* Argument(s) : p_class_dev     Pointer to UAS device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_Resume (void  *p_class_dev)
+{
+    USBH_UAS_DEV  *p_uas_dev;
+
+
+    p_uas_dev = (USBH_UAS_DEV *)p_class_dev;
+
+    (void)USBH_OS_MutexLock(p_uas_dev->HMutex);
+
+    p_uas_dev->State = USBH_CLASS_DEV_STATE_CONN;
+
+    (void)USBH_OS_MutexUnlock(p_uas_dev->HMutex);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_DevClr()
+*
+* Description : Clear USBH_UAS_DEV structure.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The tag of each command is its index in the command table plus one, so that tags are
+*                   unique among the outstanding commands of the device and never 0.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_DevClr (USBH_UAS_DEV  *p_uas_dev)
+{
+    CPU_INT08U  cmd_ix;
+
+
+    p_uas_dev->DevPtr  = (USBH_DEV *)0;
+    p_uas_dev->IF_Ptr  = (USBH_IF  *)0;
+    p_uas_dev->AltIx   =  0u;
+    p_uas_dev->State   =  USBH_CLASS_DEV_STATE_NONE;
+    p_uas_dev->RefCnt  =  0u;
+    Mem_Clr((void *)p_uas_dev->LUN_Tbl,
+                    sizeof(p_uas_dev->LUN_Tbl));
+                                                                /* Build free cmd list.                                 */
+    p_uas_dev->CmdFreePtr = (USBH_UAS_CMD *)0;
+    for (cmd_ix = USBH_UAS_CFG_CMD_Q_LEN; cmd_ix > 0u; cmd_ix--) {
+        p_uas_dev->CmdTbl[cmd_ix - 1u].Tag        =  cmd_ix;    /* See Note #1.                                         */
+        p_uas_dev->CmdTbl[cmd_ix - 1u].Flags      =  0u;
+        p_uas_dev->CmdTbl[cmd_ix - 1u].UAS_DevPtr =  p_uas_dev;
+        p_uas_dev->CmdTbl[cmd_ix - 1u].NxtPtr     =  p_uas_dev->CmdFreePtr;
+        p_uas_dev->CmdFreePtr                     = &p_uas_dev->CmdTbl[cmd_ix - 1u];
+    }
+    p_uas_dev->CmdRsvPtr     = (USBH_UAS_CMD *)0;
+    p_uas_dev->CmdWaitCnt    =  0u;
+    p_uas_dev->TxHeadPtr     = (USBH_UAS_CMD *)0;
+    p_uas_dev->TxTailPtr     = (USBH_UAS_CMD *)0;
+    p_uas_dev->DoneHeadPtr   = (USBH_UAS_CMD *)0;
+    p_uas_dev->DoneTailPtr   = (USBH_UAS_CMD *)0;
+    p_uas_dev->DataInCmdPtr  = (USBH_UAS_CMD *)0;
+    p_uas_dev->DataOutCmdPtr = (USBH_UAS_CMD *)0;
+    p_uas_dev->ActiveCnt     =  0u;
+    p_uas_dev->Flags         =  0u;
+    p_uas_dev->RecoverErr    =  USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_UAS_PipeAddrGet()
+*
+* Description : Get the address of the endpoint of a UAS pipe.
+*
+* Argument(s) : p_if            Pointer to interface.
+*
+*               alt_ix          UAS alternate setting.
+*
+*               pipe_id         Pipe ID (see Note #1).
+*
+* Return(s)   : Endpoint address,       if the pipe is found.
+*               0,                      otherwise.
+*
+* Note(s)     : (1) Each endpoint descriptor of the UAS alternate setting is followed by a Pipe Usage
+*                   descriptor that identifies the pipe : command (1), status (2), data-in (3) or data-out
+*                   (4). See 'Universal Serial Bus Attached SCSI (UAS)', Section 5.3.3.
+*********************************************************************************************************
+*/
+
+static  CPU_INT08U  USBH_UAS_PipeAddrGet (USBH_IF     *p_if,
+                                          CPU_INT08U   alt_ix,
+                                          CPU_INT08U   pipe_id)
+{
+    CPU_INT08U   *p_desc;
+    CPU_INT32U    off;
+    CPU_INT08U    ep_addr;
+    CPU_BOOLEAN   alt_found;
+
+
+    p_desc    = (CPU_INT08U *)p_if->IF_DataPtr;
+    off       =  0u;
+    ep_addr   =  0u;
+    alt_found =  DEF_FALSE;
+
+    while ((off + 2u) <= p_if->IF_DataLen) {
+        if (p_desc[off] < 2u) {                                 /* Malformed desc.                                      */
+            break;
+        }
+
+        switch (p_desc[off + 1u]) {
+            case USBH_DESC_TYPE_IF:
+                 if (p_desc[off] >= USBH_LEN_DESC_IF) {
+                     alt_found = (p_desc[off + 3u] == alt_ix) ? DEF_TRUE : DEF_FALSE;
+                 }
+                 ep_addr = 0u;
+                 break;
+
+            case USBH_DESC_TYPE_EP:
+                 ep_addr = p_desc[off + 2u];
+                 break;
+
+            case USBH_UAS_DESC_TYPE_PIPE_USAGE:                 /* See Note #1.                                         */
+                 if ((alt_found        == DEF_TRUE)                      &&
+                     (ep_addr          != 0u)                            &&
+                     (p_desc[off]      >= USBH_UAS_LEN_DESC_PIPE_USAGE) &&
+                     (p_desc[off + 2u] == pipe_id)) {
+                     return (ep_addr);
+                 }
+                 break;
+
+            default:
+                 break;
+        }
+
+        off += p_desc[off];
+    }
+
+    return (0u);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_EP_Open()
+*
+* Description : Open command, status, data-in and data-out endpoints.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+* Return(s)   : USBH_ERR_NONE,                      if endpoints successfully opened.
+*               USBH_ERR_EP_NOT_FOUND,              If a pipe is not described by the interface.
+*
+*                                                   ---- RETURNED BY USBH_BulkAddrOpen ----
+*               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*               USBH_ERR_EP_NOT_FOUND,              If endpoint with given address not found.
+*               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*               Host controller drivers error,      Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_UAS_EP_Open (USBH_UAS_DEV  *p_uas_dev)
+{
+    USBH_EP     *ep_tbl[4];
+    CPU_INT08U   ep_addr;
+    CPU_INT08U   ix;
+    USBH_ERR     err;
+
+
+    ep_tbl[0] = &p_uas_dev->CmdEP;                              /* EPs in pipe ID order.                                */
+    ep_tbl[1] = &p_uas_dev->StatusEP;
+    ep_tbl[2] = &p_uas_dev->DataInEP;
+    ep_tbl[3] = &p_uas_dev->DataOutEP;
+
+    err = USBH_ERR_NONE;
+    for (ix = 0u; ix < 4u; ix++) {
+        ep_addr = USBH_UAS_PipeAddrGet(p_uas_dev->IF_Ptr,
+                                       p_uas_dev->AltIx,
+                                       USBH_UAS_PIPE_ID_CMD + ix);
+        if (ep_addr == 0u) {
+            err = USBH_ERR_EP_NOT_FOUND;
+            break;
+        }
+
+        err = USBH_BulkAddrOpen(p_uas_dev->DevPtr,
+                                p_uas_dev->IF_Ptr,
+                                ep_addr,
+                                ep_tbl[ix]);
+        if (err != USBH_ERR_NONE) {
+            break;
+        }
+    }
+
+    if (err != USBH_ERR_NONE) {                                 /* Close EPs already opened.                            */
+        while (ix > 0u) {
+            ix--;
+            (void)USBH_EP_Close(ep_tbl[ix]);
+        }
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_EP_Close()
+*
+* Description : Close command, status, data-in and data-out endpoints.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_EP_Close (USBH_UAS_DEV  *p_uas_dev)
+{
+    (void)USBH_EP_Close(&p_uas_dev->CmdEP);
+    (void)USBH_EP_Close(&p_uas_dev->StatusEP);
+    (void)USBH_EP_Close(&p_uas_dev->DataInEP);
+    (void)USBH_EP_Close(&p_uas_dev->DataOutEP);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_XferCmd()
+*
+* Description : Issue a command and wait for its completion.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical Unit Number.
+*
+*               dir             Direction of data transfer, if present.
+*
+*               p_cb            Pointer to command block.
+*
+*               cb_len          Command block length, in octets.
+*
+*               p_arg           Pointer to data buffer, if data transfer present.
+*
+*               data_len        Length of data buffer in octets, if data transfer present.
+*
+*               p_sense         Pointer to variable that will receive the sense data of a failed command,
+*                               if not null.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*                           USBH_ERR_NONE                           Command successfully executed.
+*                           USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*                           USBH_ERR_MSC_IO                         Device reported a protocol error.
+*                           USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*                           Host controller drivers error code,     Otherwise.
+*
+*                                                                   ----- RETURNED BY USBH_UAS_CmdGet() : -----
+*                           USBH_ERR_OS_ABORT,                      If semaphore wait aborted.
+*                           USBH_ERR_OS_FAIL,                       Otherwise.
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : (1) A command that does not complete within USBH_UAS_TIMEOUT milliseconds triggers the
+*                   recovery of the device (see USBH_UAS_Recover()), which completes all outstanding
+*                   commands.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_UAS_XferCmd (USBH_UAS_DEV       *p_uas_dev,
+                                      CPU_INT08U          lun,
+                                      USBH_MSC_DATA_DIR   dir,
+                                      void               *p_cb,
+                                      CPU_INT08U          cb_len,
+                                      void               *p_arg,
+                                      CPU_INT32U          data_len,
+                                      USBH_UAS_SENSE     *p_sense,
+                                      USBH_ERR           *p_err)
+{
+    USBH_UAS_CMD  *p_cmd;
+    CPU_INT32U     xfer_len;
+    CPU_BOOLEAN    done;
+    USBH_ERR       err;
+    CPU_SR_ALLOC();
+
+
+    p_cmd = USBH_UAS_CmdGet(p_uas_dev, DEF_TRUE, p_err);
+    if (p_cmd == (USBH_UAS_CMD *)0) {
+        return (0u);
+    }
+
+    USBH_UAS_CmdStart(p_uas_dev,
+                      p_cmd,
+                      lun,
+                      dir,
+                      p_cb,
+                      cb_len,
+                      p_arg,
+                      data_len,
+                      (USBH_UAS_XFER_CMPL_FNCT)0,
+                      (void *)0);
+                                                                /* ------------------ WAIT FOR CMD -------------------- */
+    done = DEF_FALSE;
+    while (done == DEF_FALSE) {
+        err = USBH_OS_SemWait(p_cmd->Sem, USBH_UAS_TIMEOUT);
+        if (err == USBH_ERR_NONE) {
+            done = DEF_TRUE;
+        } else {
+            CPU_CRITICAL_ENTER();                               /* See Note #1.                                         */
+            if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_DONE) == DEF_NO) {
+                USBH_UAS_ErrSet(p_uas_dev, USBH_ERR_OS_TIMEOUT);
+            }
+            CPU_CRITICAL_EXIT();
+
+            USBH_UAS_Run(p_uas_dev);
+        }
+    }
+
+   *p_err    = p_cmd->Err;
+    xfer_len = p_cmd->DataXferLen;
+    if (p_sense != (USBH_UAS_SENSE *)0) {
+        p_sense->Key  = p_cmd->SenseKey;
+        p_sense->ASC  = p_cmd->ASC;
+        p_sense->ASCQ = p_cmd->ASCQ;
+    }
+
+    USBH_UAS_CmdRel(p_uas_dev, p_cmd);
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_UAS_XferCmdAsync()
+*
+* Description : Issue a command without waiting for its completion.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical Unit Number.
+*
+*               dir             Direction of data transfer, if present.
+*
+*               p_cb            Pointer to command block.
+*
+*               cb_len          Command block length, in octets.
+*
+*               p_arg           Pointer to data buffer, if data transfer present.
+*
+*               data_len        Length of data buffer in octets, if data transfer present.
+*
+*               fnct            Function notified when the command completes.
+*
+*               p_fnct_arg      Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,              if the command is successfully issued.
+*               USBH_ERR_ALLOC,             if USBH_UAS_CFG_CMD_Q_LEN commands are already outstanding.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_UAS_XferCmdAsync (USBH_UAS_DEV             *p_uas_dev,
+                                         CPU_INT08U                lun,
+                                         USBH_MSC_DATA_DIR         dir,
+                                         void                     *p_cb,
+                                         CPU_INT08U                cb_len,
+                                         void                     *p_arg,
+                                         CPU_INT32U                data_len,
+                                         USBH_UAS_XFER_CMPL_FNCT   fnct,
+                                         void                     *p_fnct_arg)
+{
+    USBH_UAS_CMD  *p_cmd;
+    USBH_ERR       err;
+
+
+    p_cmd = USBH_UAS_CmdGet(p_uas_dev, DEF_FALSE, &err);
+    if (p_cmd == (USBH_UAS_CMD *)0) {
+        return (err);
+    }
+
+    USBH_UAS_CmdStart(p_uas_dev,
+                      p_cmd,
+                      lun,
+                      dir,
+                      p_cb,
+                      cb_len,
+                      p_arg,
+                      data_len,
+                      fnct,
+                      p_fnct_arg);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_CmdGet()
+*
+* Description : Allocate a command.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               wait            DEF_TRUE to wait for a free command (see Note #1).
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                           USBH_ERR_NONE                   Command successfully allocated.
+*                           USBH_ERR_ALLOC                  No free command and 'wait' is DEF_FALSE.
+*
+*                                                           ----- RETURNED BY USBH_OS_SemWait() : -----
+*                           USBH_ERR_INVALID_ARG,           If invalid argument passed to 'sem'.
+*                           USBH_ERR_OS_ABORT,              If semaphore wait aborted.
+*                           USBH_ERR_OS_FAIL,               Otherwise.
+*
+* Return(s)   : Pointer to command,     if successful.
+*               Pointer to NULL,        otherwise.
+*
+* Note(s)     : (1) A task waits until one of the USBH_UAS_CFG_CMD_Q_LEN commands of the device is
+*                   released. Asynchronous requests, which may be issued from a completion callback, do
+*                   not wait.
+*
+*               (2) A command released while tasks wait is handed over to the first task woken (see
+*                   USBH_UAS_CmdRel()), so that asynchronous requests do not starve the waiting tasks.
+*********************************************************************************************************
+*/
+
+static  USBH_UAS_CMD  *USBH_UAS_CmdGet (USBH_UAS_DEV  *p_uas_dev,
+                                        CPU_BOOLEAN    wait,
+                                        USBH_ERR      *p_err)
+{
+    USBH_UAS_CMD  *p_cmd;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    if (p_uas_dev->CmdFreePtr != (USBH_UAS_CMD *)0) {
+        p_cmd                 = p_uas_dev->CmdFreePtr;
+        p_uas_dev->CmdFreePtr = p_cmd->NxtPtr;
+
+    } else {
+        if (wait == DEF_FALSE) {
+            CPU_CRITICAL_EXIT();
+           *p_err = USBH_ERR_ALLOC;
+            return ((USBH_UAS_CMD *)0);
+        }
+
+        p_uas_dev->CmdWaitCnt++;
+        CPU_CRITICAL_EXIT();
+
+       *p_err = USBH_OS_SemWait(p_uas_dev->CmdFreeSem, 0u);     /* See Note #1.                                         */
+        if (*p_err != USBH_ERR_NONE) {
+            CPU_CRITICAL_ENTER();
+            p_uas_dev->CmdWaitCnt--;
+            CPU_CRITICAL_EXIT();
+            return ((USBH_UAS_CMD *)0);
+        }
+
+        CPU_CRITICAL_ENTER();
+        p_cmd                = p_uas_dev->CmdRsvPtr;            /* Take cmd handed over (see Note #2).                  */
+        p_uas_dev->CmdRsvPtr = p_cmd->NxtPtr;
+    }
+
+    p_cmd->NxtPtr = (USBH_UAS_CMD *)0;
+    CPU_CRITICAL_EXIT();
+
+   *p_err = USBH_ERR_NONE;
+
+    return (p_cmd);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_CmdRel()
+*
+* Description : Release a completed command.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               p_cmd           Pointer to command.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) See USBH_UAS_CmdGet() Note #2.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_CmdRel (USBH_UAS_DEV  *p_uas_dev,
+                               USBH_UAS_CMD  *p_cmd)
+{
+    CPU_BOOLEAN  post;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_cmd->Flags = 0u;
+    if (p_uas_dev->CmdWaitCnt > 0u) {                           /* Hand cmd over to a waiting task (see Note #1).       */
+        p_uas_dev->CmdWaitCnt--;
+        p_cmd->NxtPtr         = p_uas_dev->CmdRsvPtr;
+        p_uas_dev->CmdRsvPtr  = p_cmd;
+        post                  = DEF_TRUE;
+    } else {
+        p_cmd->NxtPtr         = p_uas_dev->CmdFreePtr;          /* Return cmd to free list.                             */
+        p_uas_dev->CmdFreePtr = p_cmd;
+        post                  = DEF_FALSE;
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (post == DEF_TRUE) {
+        (void)USBH_OS_SemPost(p_uas_dev->CmdFreeSem);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_CmdStart()
+*
+* Description : Format the COMMAND IU of a command and queue it for submission.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               p_cmd           Pointer to command.
+*
+*               lun             Logical Unit Number.
+*
+*               dir             Direction of data transfer, if present.
+*
+*               p_cb            Pointer to command block.
+*
+*               cb_len          Command block length, in octets (16 at most).
+*
+*               p_arg           Pointer to data buffer, if data transfer present.
+*
+*               data_len        Length of data buffer in octets, if data transfer present.
+*
+*               fnct            Function notified when the command completes, null for a task waiting.
+*
+*               p_fnct_arg      Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The COMMAND IU is documented in 'USB Attached SCSI (UAS) - T10/2095-D', Section 6.2.2.
+*                   The task attribute is SIMPLE. The LUN is formatted with the peripheral device
+*                   addressing method of 'SCSI Architecture Model - 4 (SAM-4)', Section 4.6.6.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_CmdStart (USBH_UAS_DEV             *p_uas_dev,
+                                 USBH_UAS_CMD             *p_cmd,
+                                 CPU_INT08U                lun,
+                                 USBH_MSC_DATA_DIR         dir,
+                                 void                     *p_cb,
+                                 CPU_INT08U                cb_len,
+                                 void                     *p_arg,
+                                 CPU_INT32U                data_len,
+                                 USBH_UAS_XFER_CMPL_FNCT   fnct,
+                                 void                     *p_fnct_arg)
+{
+    CPU_SR_ALLOC();
+
+                                                                /* ------------ FORMAT COMMAND IU (NOTE #1) ----------- */
+    Mem_Clr((void *)p_cmd->IU_Buf,
+                    USBH_UAS_LEN_CMD_IU);
+    p_cmd->IU_Buf[0] = USBH_UAS_IU_ID_CMD;                      /* IU ID.                                               */
+    MEM_VAL_COPY_SET_INT16U_BIG(&p_cmd->IU_Buf[2], &p_cmd->Tag);/* Tag.                                                 */
+    p_cmd->IU_Buf[4] = 0u;                                      /* Task attribute (SIMPLE), priority 0.                 */
+    p_cmd->IU_Buf[6] = 0u;                                      /* Additional CDB len.                                  */
+    p_cmd->IU_Buf[9] = lun;                                     /* LUN.                                                 */
+    Mem_Copy((void *)&p_cmd->IU_Buf[16],
+                      p_cb,
+                      DEF_MIN(cb_len, 16u));                    /* CDB.                                                 */
+
+    p_cmd->Dir           =  dir;
+    p_cmd->DataPtr       = (CPU_INT08U *)p_arg;
+    p_cmd->DataLen       = (dir == USBH_MSC_DATA_DIR_NONE) ? 0u : data_len;
+    p_cmd->DataSubmitLen =  0u;
+    p_cmd->DataCmplLen   =  0u;
+    p_cmd->DataXferLen   =  0u;
+    p_cmd->URB_Cnt       =  0u;
+    p_cmd->Flags         =  0u;
+    p_cmd->Err           =  USBH_ERR_NONE;
+    p_cmd->Status        =  USBH_SCSI_STATUS_GOOD;
+    p_cmd->SenseKey      =  0u;
+    p_cmd->ASC           =  0u;
+    p_cmd->ASCQ          =  0u;
+    p_cmd->CmplFnctPtr   =  fnct;
+    p_cmd->CmplArgPtr    =  p_fnct_arg;
+    p_cmd->NxtPtr        = (USBH_UAS_CMD *)0;
+
+    CPU_CRITICAL_ENTER();                                       /* Queue cmd for submission.                            */
+    if (p_uas_dev->TxTailPtr == (USBH_UAS_CMD *)0) {
+        p_uas_dev->TxHeadPtr         = p_cmd;
+    } else {
+        p_uas_dev->TxTailPtr->NxtPtr = p_cmd;
+    }
+    p_uas_dev->TxTailPtr = p_cmd;
+    CPU_CRITICAL_EXIT();
+
+    USBH_UAS_Run(p_uas_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_CmdAsyncEnd()
+*
+* Description : Release an asynchronous command and notify the application.
+*
+* Argument(s) : p_cmd           Pointer to command.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The command is released before the application is notified, so that the completion
+*                   function can issue another command.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_CmdAsyncEnd (USBH_UAS_CMD  *p_cmd)
+{
+    USBH_UAS_DEV             *p_uas_dev;
+    USBH_UAS_XFER_CMPL_FNCT   p_fnct;
+    void                     *p_fnct_arg;
+    void                     *p_buf;
+    CPU_INT32U                buf_len;
+    CPU_INT32U                xfer_len;
+    USBH_ERR                  err;
+
+
+    p_uas_dev  = p_cmd->UAS_DevPtr;
+    p_fnct     = p_cmd->CmplFnctPtr;
+    p_fnct_arg = p_cmd->CmplArgPtr;
+    p_buf      = (void *)p_cmd->DataPtr;
+    buf_len    = p_cmd->DataLen;
+    err        = p_cmd->Err;
+    xfer_len   = (err == USBH_ERR_NONE) ? p_cmd->DataXferLen : 0u;
+
+    USBH_UAS_CmdRel(p_uas_dev, p_cmd);                          /* See Note #1.                                         */
+
+    p_fnct(p_uas_dev,
+           p_buf,
+           buf_len,
+           xfer_len,
+           p_fnct_arg,
+           err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_CmdDoneChk()
+*
+* Description : Move a command to the completed list once it is complete.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               p_cmd           Pointer to command.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function MUST be called from a critical section.
+*
+*               (2) A command is complete when its SENSE IU was received, or it was failed, and none of
+*                   its URBs is in progress.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_CmdDoneChk (USBH_UAS_DEV  *p_uas_dev,
+                                   USBH_UAS_CMD  *p_cmd)
+{
+    if ((DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_DONE)                                  == DEF_YES) ||
+        (DEF_BIT_IS_SET_ANY(p_cmd->Flags, USBH_UAS_CMD_FLAG_STATUS_RX | USBH_UAS_CMD_FLAG_FAILED) == DEF_NO) ||
+        (p_cmd->URB_Cnt                                                                         != 0u)) {
+        return;                                                 /* See Note #2.                                         */
+    }
+
+    DEF_BIT_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_DONE);
+    if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_ACTIVE) == DEF_YES) {
+        p_uas_dev->ActiveCnt--;
+    }
+    if (p_uas_dev->DataInCmdPtr == p_cmd) {
+        p_uas_dev->DataInCmdPtr = (USBH_UAS_CMD *)0;
+    }
+    if (p_uas_dev->DataOutCmdPtr == p_cmd) {
+        p_uas_dev->DataOutCmdPtr = (USBH_UAS_CMD *)0;
+    }
+
+    p_cmd->NxtPtr = (USBH_UAS_CMD *)0;                          /* Append cmd to completed list.                        */
+    if (p_uas_dev->DoneTailPtr == (USBH_UAS_CMD *)0) {
+        p_uas_dev->DoneHeadPtr         = p_cmd;
+    } else {
+        p_uas_dev->DoneTailPtr->NxtPtr = p_cmd;
+    }
+    p_uas_dev->DoneTailPtr = p_cmd;
+
+    DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_ErrSet()
+*
+* Description : Request the recovery of the device.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               err             Error that requires the recovery.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function MUST be called from a critical section.
+*
+*               (2) The first error is kept. The outstanding commands are failed with it (see
+*                   USBH_UAS_Recover()).
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_ErrSet (USBH_UAS_DEV  *p_uas_dev,
+                               USBH_ERR       err)
+{
+    if (p_uas_dev->RecoverErr == USBH_ERR_NONE) {               /* See Note #2.                                         */
+        p_uas_dev->RecoverErr =  err;
+    }
+    DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_UAS_Run()
+*
+* Description : Run the engine of a device: recover the device if requested, submit the pending IUs and
+*               data pieces, then notify the completed commands.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function is called from the tasks that issue commands and from the completion of
+*                   the URBs of the device. Only one context runs the engine at a time; a call made
+*                   meanwhile is executed by that context before it returns.
+*
+*               (2) A task waiting for a command is signaled. An asynchronous command is released and its
+*                   completion function called (see USBH_UAS_CmdAsyncEnd()).
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_Run (USBH_UAS_DEV  *p_uas_dev)
+{
+    USBH_UAS_CMD  *p_cmd;
+    CPU_BOOLEAN    done;
+    USBH_ERR       err;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    if (DEF_BIT_IS_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN) == DEF_YES) {
+        DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ);
+        CPU_CRITICAL_EXIT();
+        return;
+    }
+    DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN);
+    CPU_CRITICAL_EXIT();
+
+    done = DEF_FALSE;
+    while (done == DEF_FALSE) {
+        CPU_CRITICAL_ENTER();
+        DEF_BIT_CLR(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ);
+        err = p_uas_dev->RecoverErr;
+        CPU_CRITICAL_EXIT();
+
+        if (err != USBH_ERR_NONE) {
+            USBH_UAS_Recover(p_uas_dev, err);
+        }
+
+        USBH_UAS_Submit(p_uas_dev);
+                                                                /* ------------- NOTIFY COMPLETED CMDS ---------------- */
+        do {
+            CPU_CRITICAL_ENTER();
+            p_cmd = p_uas_dev->DoneHeadPtr;
+            if (p_cmd != (USBH_UAS_CMD *)0) {
+                p_uas_dev->DoneHeadPtr = p_cmd->NxtPtr;
+                if (p_uas_dev->DoneHeadPtr == (USBH_UAS_CMD *)0) {
+                    p_uas_dev->DoneTailPtr = (USBH_UAS_CMD *)0;
+                }
+            }
+            CPU_CRITICAL_EXIT();
+
+            if (p_cmd != (USBH_UAS_CMD *)0) {                   /* See Note #2.                                         */
+                if (p_cmd->CmplFnctPtr == (USBH_UAS_XFER_CMPL_FNCT)0) {
+                    (void)USBH_OS_SemPost(p_cmd->Sem);
+                } else {
+                    USBH_UAS_CmdAsyncEnd(p_cmd);
+                }
+            }
+        } while (p_cmd != (USBH_UAS_CMD *)0);
+
+        CPU_CRITICAL_ENTER();
+        if (DEF_BIT_IS_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ) == DEF_NO) {
+            DEF_BIT_CLR(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN);
+            done = DEF_TRUE;
+        }
+        CPU_CRITICAL_EXIT();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_UAS_Submit()
+*
+* Description : Submit the pending COMMAND IUs, the status IU and the data pieces of the commands the
+*               device is ready for.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The data pieces still queued for a command that completed early are aborted before the
+*                   status pipe is read again, so that they do not receive the data of the next command.
+*
+*               (2) COMMAND IUs are sent as soon as commands are issued, so that the device can queue them.
+*                   When the endpoint queue or the extra URBs are exhausted, the remaining IUs are sent
+*                   from the completion of an IU in progress.
+*
+*               (3) A single status IU is queued at a time, while commands are outstanding. READ READY,
+*                   WRITE READY and SENSE IUs of all commands are received through it.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_Submit (USBH_UAS_DEV  *p_uas_dev)
+{
+    USBH_UAS_CMD  *p_cmd;
+    CPU_INT08U     flags;
+    CPU_BOOLEAN    status_submit;
+    USBH_ERR       err;
+    CPU_SR_ALLOC();
+
+                                                                /* ---------------- STALE DATA PIECES ----------------- */
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    flags = p_uas_dev->Flags & (USBH_UAS_DEV_FLAG_DATA_IN_ABORT | USBH_UAS_DEV_FLAG_DATA_OUT_ABORT);
+    DEF_BIT_CLR(p_uas_dev->Flags, (USBH_UAS_DEV_FLAG_DATA_IN_ABORT | USBH_UAS_DEV_FLAG_DATA_OUT_ABORT));
+    CPU_CRITICAL_EXIT();
+
+    if (DEF_BIT_IS_SET(flags, USBH_UAS_DEV_FLAG_DATA_IN_ABORT) == DEF_YES) {
+        (void)USBH_EP_Abort(&p_uas_dev->DataInEP);
+    }
+    if (DEF_BIT_IS_SET(flags, USBH_UAS_DEV_FLAG_DATA_OUT_ABORT) == DEF_YES) {
+        (void)USBH_EP_Abort(&p_uas_dev->DataOutEP);
+    }
+                                                                /* ------------------- COMMAND IUs -------------------- */
+    do {                                                        /* See Note #2.                                         */
+        CPU_CRITICAL_ENTER();
+        p_cmd = p_uas_dev->TxHeadPtr;
+        if (p_cmd != (USBH_UAS_CMD *)0) {
+            p_uas_dev->TxHeadPtr = p_cmd->NxtPtr;
+            if (p_uas_dev->TxHeadPtr == (USBH_UAS_CMD *)0) {
+                p_uas_dev->TxTailPtr = (USBH_UAS_CMD *)0;
+            }
+            DEF_BIT_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_ACTIVE);
+            p_uas_dev->ActiveCnt++;
+            p_cmd->URB_Cnt++;                                   /* URB accounted before it may complete.                */
+        }
+        CPU_CRITICAL_EXIT();
+
+        if (p_cmd == (USBH_UAS_CMD *)0) {
+            break;
+        }
+
+        err = USBH_BulkTxAsync(        &p_uas_dev->CmdEP,
+                               (void *) p_cmd->IU_Buf,
+                                        USBH_UAS_LEN_CMD_IU,
+                                        USBH_UAS_CmdCmpl,
+                               (void *) p_cmd);
+        if (err != USBH_ERR_NONE) {
+            CPU_CRITICAL_ENTER();
+            p_cmd->URB_Cnt--;
+            p_uas_dev->ActiveCnt--;
+            DEF_BIT_CLR(p_cmd->Flags, USBH_UAS_CMD_FLAG_ACTIVE);
+            if (((err == USBH_ERR_EP_QUEUE_FULL) ||
+                 (err == USBH_ERR_ALLOC))        &&
+                (p_uas_dev->ActiveCnt > 0u)) {                  /* Send IU later.                                       */
+                p_cmd->NxtPtr        = p_uas_dev->TxHeadPtr;
+                p_uas_dev->TxHeadPtr = p_cmd;
+                if (p_uas_dev->TxTailPtr == (USBH_UAS_CMD *)0) {
+                    p_uas_dev->TxTailPtr = p_cmd;
+                }
+                p_cmd = (USBH_UAS_CMD *)0;
+            } else {                                            /* Fail cmd.                                            */
+                p_cmd->Err = err;
+                DEF_BIT_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_FAILED);
+                USBH_UAS_CmdDoneChk(p_uas_dev, p_cmd);
+            }
+            CPU_CRITICAL_EXIT();
+        }
+    } while (p_cmd != (USBH_UAS_CMD *)0);
+                                                                /* -------------------- STATUS IU --------------------- */
+    CPU_CRITICAL_ENTER();                                       /* See Note #3.                                         */
+    status_submit = DEF_FALSE;
+    if ((p_uas_dev->ActiveCnt                                                     > 0u) &&
+        (DEF_BIT_IS_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_SUBMIT) == DEF_NO)) {
+        status_submit = DEF_TRUE;
+        DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_SUBMIT);
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (status_submit == DEF_TRUE) {
+        err = USBH_BulkRxAsync(        &p_uas_dev->StatusEP,
+                               (void *) p_uas_dev->StatusBuf,
+                                        USBH_UAS_LEN_STATUS_IU,
+                                        USBH_UAS_StatusCmpl,
+                               (void *) p_uas_dev);
+        if (err != USBH_ERR_NONE) {
+            CPU_CRITICAL_ENTER();
+            DEF_BIT_CLR(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_SUBMIT);
+            USBH_UAS_ErrSet(p_uas_dev, err);
+            CPU_CRITICAL_EXIT();
+        }
+    }
+                                                                /* ------------------- DATA PIECES -------------------- */
+    USBH_UAS_DataFill(p_uas_dev, &p_uas_dev->DataInEP,  &p_uas_dev->DataInCmdPtr);
+    USBH_UAS_DataFill(p_uas_dev, &p_uas_dev->DataOutEP, &p_uas_dev->DataOutCmdPtr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_DataFill()
+*
+* Description : Submit the data pieces of the command the device is ready to transfer data for.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               p_ep            Pointer to data-in or data-out endpoint.
+*
+*               pp_cmd          Pointer to the variable that points to the command transferring on 'p_ep'.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The data is split in pieces of at most 'DataBufMaxLen' octets, rounded down to a
+*                   multiple of the maximum packet size, so that the host controller does not truncate a
+*                   transfer and a short packet always ends the data transfer.
+*
+*               (2) When the endpoint queue or the extra URBs are exhausted, the remaining pieces are
+*                   submitted from the completion of a piece in progress.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_DataFill (USBH_UAS_DEV   *p_uas_dev,
+                                 USBH_EP        *p_ep,
+                                 USBH_UAS_CMD  **pp_cmd)
+{
+    USBH_UAS_CMD  *p_cmd;
+    CPU_INT32U     piece_len;
+    CPU_INT32U     off;
+    CPU_INT32U     len;
+    CPU_INT16U     max_pkt_size;
+    USBH_ERR       err;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_cmd = *pp_cmd;
+    CPU_CRITICAL_EXIT();
+
+    if (p_cmd == (USBH_UAS_CMD *)0) {
+        return;
+    }
+
+    piece_len    = p_uas_dev->DevPtr->HC_Ptr->HC_Drv.HC_CfgPtr->DataBufMaxLen;
+    max_pkt_size = USBH_EP_MaxPktSizeGet(p_ep);
+    if (piece_len == 0u) {                                      /* See Note #1.                                         */
+        piece_len = DEF_INT_32U_MAX_VAL;
+    } else if ((max_pkt_size != 0u          ) &&
+               (piece_len    >= max_pkt_size)) {
+        piece_len -= piece_len % max_pkt_size;
+    } else {
+                                                                /* Empty Else Statement                                 */
+    }
+
+    while (DEF_TRUE) {
+        CPU_CRITICAL_ENTER();
+        if ((*pp_cmd                                                     != p_cmd) ||
+            (DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_DATA_SHORT) == DEF_YES) ||
+            (p_cmd->DataSubmitLen                                       >= p_cmd->DataLen)) {
+            CPU_CRITICAL_EXIT();
+            break;
+        }
+        off = p_cmd->DataSubmitLen;
+        len = DEF_MIN(p_cmd->DataLen - off, piece_len);
+        p_cmd->URB_Cnt++;                                       /* URB accounted before it may complete.                */
+        CPU_CRITICAL_EXIT();
+
+        if (p_ep == &p_uas_dev->DataInEP) {
+            err = USBH_BulkRxAsync(        p_ep,
+                                   (void *)(p_cmd->DataPtr + off),
+                                           len,
+                                           USBH_UAS_DataCmpl,
+                                   (void *)p_cmd);
+        } else {
+            err = USBH_BulkTxAsync(        p_ep,
+                                   (void *)(p_cmd->DataPtr + off),
+                                           len,
+                                           USBH_UAS_DataCmpl,
+                                   (void *)p_cmd);
+        }
+
+        CPU_CRITICAL_ENTER();
+        if (err == USBH_ERR_NONE) {
+            p_cmd->DataSubmitLen += len;
+            CPU_CRITICAL_EXIT();
+        } else {
+            p_cmd->URB_Cnt--;
+            if (((err != USBH_ERR_EP_QUEUE_FULL) &&             /* See Note #2.                                         */
+                 (err != USBH_ERR_ALLOC))        ||
+                (p_cmd->DataCmplLen >= p_cmd->DataSubmitLen)) {
+                USBH_UAS_ErrSet(p_uas_dev, err);
+            }
+            CPU_CRITICAL_EXIT();
+            break;
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_Recover()
+*
+* Description : Fail the outstanding commands and reset the UAS interface of the device.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               err             Error that required the recovery.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The outstanding commands are failed before the URBs are aborted, so that the aborted
+*                   URBs are not reported as errors. A status IU received before the recovery is
+*                   discarded.
+*
+*               (2) The UAS alternate setting is selected again, which resets the pipes of the interface on
+*                   the device side, and the endpoints are reset on the host side. Task management IUs
+*                   (ABORT TASK, LOGICAL UNIT RESET) are not used.
+*
+*               (3) Commands not sent yet are sent once the interface is reset. If the device is
+*                   disconnected or cannot be reset, they are failed as well.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_Recover (USBH_UAS_DEV  *p_uas_dev,
+                                USBH_ERR       err)
+{
+    USBH_UAS_CMD  *p_cmd;
+    USBH_UAS_CMD  *p_cmd_nxt;
+    CPU_INT08U     ix;
+    USBH_ERR       err_reset;
+    CPU_SR_ALLOC();
+
+
+    USBH_PRINT_ERR(err);
+                                                                /* -------------- FAIL OUTSTANDING CMDS --------------- */
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    for (ix = 0u; ix < USBH_UAS_CFG_CMD_Q_LEN; ix++) {
+        p_cmd = &p_uas_dev->CmdTbl[ix];
+        if ((DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_ACTIVE) == DEF_YES) &&
+            (DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_DONE)   == DEF_NO)) {
+            if (DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_STATUS_RX) == DEF_NO) {
+                p_cmd->Err = err;
+            }
+            DEF_BIT_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_FAILED);
+            USBH_UAS_CmdDoneChk(p_uas_dev, p_cmd);
+        }
+    }
+    p_uas_dev->DataInCmdPtr  = (USBH_UAS_CMD *)0;
+    p_uas_dev->DataOutCmdPtr = (USBH_UAS_CMD *)0;
+    DEF_BIT_CLR(p_uas_dev->Flags, (USBH_UAS_DEV_FLAG_DATA_IN_ABORT | USBH_UAS_DEV_FLAG_DATA_OUT_ABORT));
+    if (DEF_BIT_IS_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_SUBMIT) == DEF_YES) {
+        DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_DISCARD);
+    }
+    CPU_CRITICAL_EXIT();
+
+    (void)USBH_EP_Abort(&p_uas_dev->CmdEP);
+    (void)USBH_EP_Abort(&p_uas_dev->StatusEP);
+    (void)USBH_EP_Abort(&p_uas_dev->DataInEP);
+    (void)USBH_EP_Abort(&p_uas_dev->DataOutEP);
+                                                                /* ---------------- RESET UAS INTERFACE --------------- */
+    err_reset = USBH_ERR_DEV_NOT_READY;
+    if (p_uas_dev->State != USBH_CLASS_DEV_STATE_DISCONN) {     /* See Note #2.                                         */
+        err_reset = USBH_IF_Set(p_uas_dev->IF_Ptr, p_uas_dev->AltIx);
+        if (err_reset == USBH_ERR_NONE) {
+            (void)USBH_EP_Reset(p_uas_dev->DevPtr, &p_uas_dev->CmdEP);
+            (void)USBH_EP_Reset(p_uas_dev->DevPtr, &p_uas_dev->StatusEP);
+            (void)USBH_EP_Reset(p_uas_dev->DevPtr, &p_uas_dev->DataInEP);
+            (void)USBH_EP_Reset(p_uas_dev->DevPtr, &p_uas_dev->DataOutEP);
+        }
+    }
+
+    CPU_CRITICAL_ENTER();
+    if (err_reset != USBH_ERR_NONE) {                           /* See Note #3.                                         */
+        p_cmd = p_uas_dev->TxHeadPtr;
+        p_uas_dev->TxHeadPtr = (USBH_UAS_CMD *)0;
+        p_uas_dev->TxTailPtr = (USBH_UAS_CMD *)0;
+        while (p_cmd != (USBH_UAS_CMD *)0) {
+            p_cmd_nxt  = p_cmd->NxtPtr;
+            p_cmd->Err = err;
+            DEF_BIT_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_FAILED);
+            USBH_UAS_CmdDoneChk(p_uas_dev, p_cmd);
+            p_cmd      = p_cmd_nxt;
+        }
+    }
+    p_uas_dev->RecoverErr = USBH_ERR_NONE;
+    CPU_CRITICAL_EXIT();
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_CmdCmpl()
+*
+* Description : Handle the completion of a COMMAND IU.
+*
+* Argument(s) : p_ep            Pointer to endpoint.
+*
+*               p_buf           Pointer to buffer.
+*
+*               buf_len         Buffer length in octets.
+*
+*               xfer_len        Number of octets transferred.
+*
+*               p_arg           Pointer to command.
+*
+*               err             Status of transfer.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The errors of a command that completed or was failed by the recovery are ignored.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_CmdCmpl (USBH_EP     *p_ep,
+                                void        *p_buf,
+                                CPU_INT32U   buf_len,
+                                CPU_INT32U   xfer_len,
+                                void        *p_arg,
+                                USBH_ERR     err)
+{
+    USBH_UAS_CMD  *p_cmd;
+    USBH_UAS_DEV  *p_uas_dev;
+    CPU_SR_ALLOC();
+
+
+    (void)p_ep;
+    (void)p_buf;
+    (void)buf_len;
+
+    p_cmd     = (USBH_UAS_CMD *)p_arg;
+    p_uas_dev =  p_cmd->UAS_DevPtr;
+
+    CPU_CRITICAL_ENTER();
+    p_cmd->URB_Cnt--;
+    if ((err == USBH_ERR_NONE) && (xfer_len != USBH_UAS_LEN_CMD_IU)) {
+        err = USBH_ERR_MSC_IO;
+    }
+    if ((err                                                                                    != USBH_ERR_NONE) &&
+        (DEF_BIT_IS_SET_ANY(p_cmd->Flags, USBH_UAS_CMD_FLAG_STATUS_RX | USBH_UAS_CMD_FLAG_FAILED) == DEF_NO)) {
+        USBH_UAS_ErrSet(p_uas_dev, err);                        /* See Note #1.                                         */
+    }
+    USBH_UAS_CmdDoneChk(p_uas_dev, p_cmd);
+    CPU_CRITICAL_EXIT();
+
+    USBH_UAS_Run(p_uas_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_StatusCmpl()
+*
+* Description : Handle the completion of the status IU.
+*
+* Argument(s) : p_ep            Pointer to endpoint.
+*
+*               p_buf           Pointer to buffer.
+*
+*               buf_len         Buffer length in octets.
+*
+*               xfer_len        Number of octets transferred.
+*
+*               p_arg           Pointer to UAS device.
+*
+*               err             Status of transfer.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) A status IU submitted before the recovery of the device is discarded (see
+*                   USBH_UAS_Recover() Note #1).
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_StatusCmpl (USBH_EP     *p_ep,
+                                   void        *p_buf,
+                                   CPU_INT32U   buf_len,
+                                   CPU_INT32U   xfer_len,
+                                   void        *p_arg,
+                                   USBH_ERR     err)
+{
+    USBH_UAS_DEV  *p_uas_dev;
+    CPU_SR_ALLOC();
+
+
+    (void)p_ep;
+    (void)p_buf;
+    (void)buf_len;
+
+    p_uas_dev = (USBH_UAS_DEV *)p_arg;
+
+    CPU_CRITICAL_ENTER();
+    DEF_BIT_CLR(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_SUBMIT);
+    if (DEF_BIT_IS_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_DISCARD) == DEF_YES) {
+        DEF_BIT_CLR(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_STATUS_DISCARD);
+        DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ);
+                                                                /* See Note #1.                                         */
+    } else if (err != USBH_ERR_NONE) {
+        USBH_UAS_ErrSet(p_uas_dev, err);
+    } else {
+        USBH_UAS_StatusParse(p_uas_dev, xfer_len);
+    }
+    CPU_CRITICAL_EXIT();
+
+    USBH_UAS_Run(p_uas_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_UAS_StatusParse()
+*
+* Description : Parse the IU received on the status pipe.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               xfer_len        Length of IU, in octets.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function MUST be called from a critical section.
+*
+*               (2) The READ READY, WRITE READY and SENSE IUs are documented in 'USB Attached SCSI (UAS) -
+*                   T10/2095-D', Sections 6.2.5, 6.2.6 and 6.2.3. A RESPONSE IU is only sent in reply to a
+*                   task management IU, which is never sent. An IU that is unknown, or whose tag is not
+*                   the tag of an outstanding command, is a protocol error.
+*
+*               (3) Only one command transfers data in each direction at a time.
+*
+*               (4) A command may complete before all its data was transferred. The data pieces queued
+*                   behind the short one are aborted (see USBH_UAS_Submit() Note #1).
+*
+*               (5) The sense data is in fixed format (see 'SCSI Primary Commands - 3 (SPC-3)', Section
+*                   4.5.3).
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_StatusParse (USBH_UAS_DEV  *p_uas_dev,
+                                    CPU_INT32U     xfer_len)
+{
+    USBH_UAS_CMD  *p_cmd;
+    CPU_INT08U    *p_iu;
+    CPU_INT16U     tag;
+    CPU_INT16U     sense_len;
+
+
+    p_iu = p_uas_dev->StatusBuf;
+    if (xfer_len < USBH_UAS_LEN_READY_IU) {
+        USBH_UAS_ErrSet(p_uas_dev, USBH_ERR_MSC_IO);
+        return;
+    }
+                                                                /* ------------------ FIND TAGGED CMD ----------------- */
+    MEM_VAL_COPY_GET_INT16U_BIG(&tag, &p_iu[2]);
+    p_cmd = (USBH_UAS_CMD *)0;
+    if ((tag >= 1u) &&
+        (tag <= USBH_UAS_CFG_CMD_Q_LEN)) {
+        p_cmd = &p_uas_dev->CmdTbl[tag - 1u];
+        if ((DEF_BIT_IS_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_ACTIVE) == DEF_NO) ||
+            (DEF_BIT_IS_SET_ANY(p_cmd->Flags, (USBH_UAS_CMD_FLAG_STATUS_RX | USBH_UAS_CMD_FLAG_FAILED)) == DEF_YES)) {
+            p_cmd = (USBH_UAS_CMD *)0;
+        }
+    }
+    if (p_cmd == (USBH_UAS_CMD *)0) {                           /* See Note #2.                                         */
+        USBH_UAS_ErrSet(p_uas_dev, USBH_ERR_MSC_IO);
+        return;
+    }
+
+    switch (p_iu[0]) {
+        case USBH_UAS_IU_ID_READ_READY:                         /* See Note #3.                                         */
+             if ((p_uas_dev->DataInCmdPtr != (USBH_UAS_CMD *)0) ||
+                 (p_cmd->Dir              != USBH_MSC_DATA_DIR_IN)) {
+                 USBH_UAS_ErrSet(p_uas_dev, USBH_ERR_MSC_IO);
+             } else {
+                 p_uas_dev->DataInCmdPtr = p_cmd;
+             }
+             break;
+
+        case USBH_UAS_IU_ID_WRITE_READY:
+             if ((p_uas_dev->DataOutCmdPtr != (USBH_UAS_CMD *)0) ||
+                 (p_cmd->Dir               != USBH_MSC_DATA_DIR_OUT)) {
+                 USBH_UAS_ErrSet(p_uas_dev, USBH_ERR_MSC_IO);
+             } else {
+                 p_uas_dev->DataOutCmdPtr = p_cmd;
+             }
+             break;
+
+        case USBH_UAS_IU_ID_SENSE:
+             if (xfer_len < USBH_UAS_LEN_SENSE_IU) {
+                 USBH_UAS_ErrSet(p_uas_dev, USBH_ERR_MSC_IO);
+                 break;
+             }
+             p_cmd->Status = p_iu[6];
+             if (p_cmd->Status != USBH_SCSI_STATUS_GOOD) {
+                 p_cmd->Err = USBH_ERR_MSC_CMD_FAILED;
+                 MEM_VAL_COPY_GET_INT16U_BIG(&sense_len, &p_iu[14]);
+                 if ((sense_len >= USBH_UAS_LEN_SENSE_MIN) &&   /* See Note #5.                                         */
+                     (xfer_len  >= USBH_UAS_LEN_SENSE_IU + USBH_UAS_LEN_SENSE_MIN)) {
+                     p_cmd->SenseKey = p_iu[USBH_UAS_LEN_SENSE_IU +  2u] & 0x0Fu;
+                     p_cmd->ASC      = p_iu[USBH_UAS_LEN_SENSE_IU + 12u];
+                     p_cmd->ASCQ     = p_iu[USBH_UAS_LEN_SENSE_IU + 13u];
+                 }
+             }
+             DEF_BIT_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_STATUS_RX);
+
+             if (p_cmd->DataCmplLen < p_cmd->DataSubmitLen) {   /* See Note #4.                                         */
+                 if (p_cmd->Dir == USBH_MSC_DATA_DIR_IN) {
+                     DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_DATA_IN_ABORT);
+                 } else {
+                     DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_DATA_OUT_ABORT);
+                 }
+             }
+             if (p_uas_dev->DataInCmdPtr == p_cmd) {
+                 p_uas_dev->DataInCmdPtr = (USBH_UAS_CMD *)0;
+             }
+             if (p_uas_dev->DataOutCmdPtr == p_cmd) {
+                 p_uas_dev->DataOutCmdPtr = (USBH_UAS_CMD *)0;
+             }
+             USBH_UAS_CmdDoneChk(p_uas_dev, p_cmd);
+             break;
+
+        case USBH_UAS_IU_ID_RESPONSE:
+        default:
+             USBH_UAS_ErrSet(p_uas_dev, USBH_ERR_MSC_IO);
+             break;
+    }
+
+    DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_DataCmpl()
+*
+* Description : Handle the completion of a data piece.
+*
+* Argument(s) : p_ep            Pointer to endpoint.
+*
+*               p_buf           Pointer to buffer.
+*
+*               buf_len         Buffer length in octets.
+*
+*               xfer_len        Number of octets transferred.
+*
+*               p_arg           Pointer to command.
+*
+*               err             Status of transfer.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The pieces aborted after the command completed, or failed by the recovery, are ignored.
+*********************************************************************************************************
+*/
+
+static  void  USBH_UAS_DataCmpl (USBH_EP     *p_ep,
+                                 void        *p_buf,
+                                 CPU_INT32U   buf_len,
+                                 CPU_INT32U   xfer_len,
+                                 void        *p_arg,
+                                 USBH_ERR     err)
+{
+    USBH_UAS_CMD  *p_cmd;
+    USBH_UAS_DEV  *p_uas_dev;
+    CPU_SR_ALLOC();
+
+
+    (void)p_ep;
+    (void)p_buf;
+
+    p_cmd     = (USBH_UAS_CMD *)p_arg;
+    p_uas_dev =  p_cmd->UAS_DevPtr;
+
+    CPU_CRITICAL_ENTER();
+    p_cmd->URB_Cnt--;
+    p_cmd->DataCmplLen += buf_len;
+    if (err == USBH_ERR_NONE) {
+        p_cmd->DataXferLen += xfer_len;
+        if (xfer_len < buf_len) {
+            DEF_BIT_SET(p_cmd->Flags, USBH_UAS_CMD_FLAG_DATA_SHORT);
+        }
+    } else if (DEF_BIT_IS_SET_ANY(p_cmd->Flags, USBH_UAS_CMD_FLAG_STATUS_RX | USBH_UAS_CMD_FLAG_FAILED) == DEF_NO) {
+        USBH_UAS_ErrSet(p_uas_dev, err);                        /* See Note #1.                                         */
+    } else {
+                                                                /* Empty Else Statement                                 */
+    }
+    USBH_UAS_CmdDoneChk(p_uas_dev, p_cmd);
+    DEF_BIT_SET(p_uas_dev->Flags, USBH_UAS_DEV_FLAG_RUN_REQ);
+    CPU_CRITICAL_EXIT();
+
+    USBH_UAS_Run(p_uas_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    USBH_UAS_SCSI_TestUnitReady()
+*
+* Description : Test whether a logical unit is ready.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical unit number.
+*
+*               p_sense         Pointer to variable that will receive the sense data, if not null.
+*
+* Return(s)   : USBH_ERR_NONE,                          if the unit is ready.
+*
+*                                                       ---- RETURNED BY USBH_UAS_XferCmd ----
+*               USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*               USBH_ERR_MSC_IO                         Device reported a protocol error.
+*               USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The SCSI "TEST UNIT READY" command is documented in 'SCSI Primary Commands - 3
+*                   (SPC-3)', Section 6.33.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_UAS_SCSI_TestUnitReady (USBH_UAS_DEV    *p_uas_dev,
+                                               CPU_INT08U       lun,
+                                               USBH_UAS_SENSE  *p_sense)
+{
+    CPU_INT08U  cmd[6];
+    USBH_ERR    err;
+
+                                                                /* See Note #1.                                         */
+    Mem_Clr((void *)cmd, sizeof(cmd));
+    cmd[0] = USBH_SCSI_CMD_TEST_UNIT_READY;                     /* Operation code (0x00).                               */
+
+    (void)USBH_UAS_XferCmd(        p_uas_dev,
+                                   lun,
+                                   USBH_MSC_DATA_DIR_NONE,
+                           (void *)cmd,
+                                   6u,
+                           (void *)0,
+                                   0u,
+                                   p_sense,
+                                  &err);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_UAS_SCSI_StdInquiry()
+*
+* Description : Read standard INQUIRY data.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               p_inquiry_info  Pointer to structure that will receive the informations.
+*
+*               lun             Logical unit number.
+*
+* Return(s)   : USBH_ERR_NONE,                          if the command is successful.
+*
+*                                                       ---- RETURNED BY USBH_UAS_XferCmd ----
+*               USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*               USBH_ERR_MSC_IO                         Device reported a protocol error.
+*               USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The SCSI "INQUIRY" command is documented in 'SCSI Primary Commands - 3 (SPC-3)',
+*                   Section 6.4.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_UAS_SCSI_StdInquiry (USBH_UAS_DEV           *p_uas_dev,
+                                            USBH_MSC_INQUIRY_INFO  *p_inquiry_info,
+                                            CPU_INT08U              lun)
+{
+    CPU_INT08U  cmd[6];
+    CPU_INT08U  data[0x24];
+    USBH_ERR    err;
+
+                                                                /* See Note #1.                                         */
+    cmd[0] = USBH_SCSI_CMD_INQUIRY;                             /* Operation code (0x12).                               */
+    cmd[1] = 0u;                                                /* Std inquiry data.                                    */
+    cmd[2] = 0u;                                                /* Page code.                                           */
+    cmd[3] = 0u;                                                /* Alloc len.                                           */
+    cmd[4] = 0x24u;                                             /* Alloc len.                                           */
+    cmd[5] = 0u;                                                /* Ctrl.                                                */
+
+    (void)USBH_UAS_XferCmd(        p_uas_dev,
+                                   lun,
+                                   USBH_MSC_DATA_DIR_IN,
+                           (void *)cmd,
+                                   6u,
+                           (void *)data,
+                                   0x24u,
+                                   (USBH_UAS_SENSE *)0,
+                                  &err);
+    if (err == USBH_ERR_NONE) {
+        p_inquiry_info->DevType      = data[0] &  0x1Fu;
+        p_inquiry_info->IsRemovable  = data[1] >> 7u;
+
+        Mem_Copy((void *) p_inquiry_info->Vendor_ID,
+                 (void *)&data[8],
+                          8u);
+
+        Mem_Copy((void *) p_inquiry_info->Product_ID,
+                 (void *)&data[16],
+                          16u);
+
+        p_inquiry_info->ProductRevisionLevel = MEM_VAL_GET_INT32U(&data[32]);
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_UAS_SCSI_CapacityRd()
+*
+* Description : Read number of blocks & block size.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical unit number.
+*
+*               p_nbr_blks      Pointer to variable that will receive number of blocks.
+*
+*               p_blk_size      Pointer to variable that will receive block size.
+*
+* Return(s)   : USBH_ERR_NONE,                          if command is successful.
+*
+*                                                       ---- RETURNED BY USBH_UAS_XferCmd ----
+*               USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*               USBH_ERR_MSC_IO                         Device reported a protocol error.
+*               USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The SCSI "READ CAPACITY (10)" command is documented in 'SCSI Block Commands - 2
+*                   (SBC-2)', Section 5.10.
+*
+*               (2) A device of more than 2^32 blocks returns 0xFFFFFFFF as last logical block address.
+*                   The capacity is then read with READ CAPACITY (16), and the device is accessed with
+*                   READ (16) / WRITE (16) commands (see USBH_SCSI_RdWrFmt()).
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_UAS_SCSI_CapacityRd (USBH_UAS_DEV  *p_uas_dev,
+                                            CPU_INT08U     lun,
+                                            CPU_INT64U    *p_nbr_blks,
+                                            CPU_INT32U    *p_blk_size)
+{
+    CPU_INT08U  cmd[10];
+    CPU_INT08U  data[8];
+    CPU_INT32U  lba_last;
+    CPU_INT32U  xfer_len;
+    USBH_ERR    err;
+
+                                                                /* See Note #1.                                         */
+    Mem_Clr((void *)cmd, sizeof(cmd));
+    cmd[0] = USBH_SCSI_CMD_READ_CAPACITY;                       /* Operation code (0x25).                               */
+
+    xfer_len = USBH_UAS_XferCmd(        p_uas_dev,
+                                        lun,
+                                        USBH_MSC_DATA_DIR_IN,
+                                (void *)cmd,
+                                        10u,
+                                (void *)data,
+                                        8u,
+                                        (USBH_UAS_SENSE *)0,
+                                       &err);
+    if ((err      == USBH_ERR_NONE) &&
+        (xfer_len <  8u)) {
+        err = USBH_ERR_MSC_CMD_FAILED;
+    }
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* -------------- HANDLE DEVICE RESPONSE -------------- */
+    MEM_VAL_COPY_GET_INT32U_BIG(&lba_last, &data[0]);
+    if (lba_last == USBH_SCSI_LBA_MAX_10) {                     /* See Note #2.                                         */
+        err = USBH_UAS_SCSI_CapacityRd16(p_uas_dev,
+                                         lun,
+                                         p_nbr_blks,
+                                         p_blk_size);
+        if ((err == USBH_ERR_NONE       ) &&
+            (lun <  USBH_UAS_CFG_MAX_LUN)) {
+            p_uas_dev->LUN_Tbl[lun].Cmd16En = DEF_TRUE;
+        }
+        return (err);
+    }
+
+   *p_nbr_blks = (CPU_INT64U)lba_last + 1u;
+    MEM_VAL_COPY_GET_INT32U_BIG(p_blk_size, &data[4]);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    USBH_UAS_SCSI_CapacityRd16()
+*
+* Description : Read number of blocks & block size of a device of more than 2^32 blocks.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical unit number.
+*
+*               p_nbr_blks      Pointer to variable that will receive number of blocks.
+*
+*               p_blk_size      Pointer to variable that will receive block size.
+*
+* Return(s)   : USBH_ERR_NONE,                          if command is successful.
+*
+*                                                       ---- RETURNED BY USBH_UAS_XferCmd ----
+*               USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*               USBH_ERR_MSC_IO                         Device reported a protocol error.
+*               USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The SCSI "READ CAPACITY (16)" command is a SERVICE ACTION IN (16) command documented
+*                   in 'SCSI Block Commands - 3 (SBC-3)', Section 5.16.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_UAS_SCSI_CapacityRd16 (USBH_UAS_DEV  *p_uas_dev,
+                                              CPU_INT08U     lun,
+                                              CPU_INT64U    *p_nbr_blks,
+                                              CPU_INT32U    *p_blk_size)
+{
+    CPU_INT08U  cmd[16];
+    CPU_INT08U  data[32];
+    CPU_INT32U  lba_msb;
+    CPU_INT32U  lba_lsb;
+    CPU_INT32U  xfer_len;
+    USBH_ERR    err;
+
+                                                                /* See Note #1.                                         */
+    Mem_Clr((void *)cmd, sizeof(cmd));
+    cmd[0]  = USBH_SCSI_CMD_SERVICE_ACTION_IN_16;               /* Operation code (0x9E).                               */
+    cmd[1]  = USBH_SCSI_SA_READ_CAPACITY_16;                    /* Service action (0x10).                               */
+    cmd[13] = (CPU_INT08U)sizeof(data);                         /* Allocation length (LSB).                             */
+
+    xfer_len = USBH_UAS_XferCmd(        p_uas_dev,
+                                        lun,
+                                        USBH_MSC_DATA_DIR_IN,
+                                (void *)cmd,
+                                        16u,
+                                (void *)data,
+                                        sizeof(data),
+                                        (USBH_UAS_SENSE *)0,
+                                       &err);
+    if ((err      == USBH_ERR_NONE) &&
+        (xfer_len <  12u)) {
+        err = USBH_ERR_MSC_CMD_FAILED;
+    }
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* -------------- HANDLE DEVICE RESPONSE -------------- */
+    MEM_VAL_COPY_GET_INT32U_BIG(&lba_msb, &data[0]);
+    MEM_VAL_COPY_GET_INT32U_BIG(&lba_lsb, &data[4]);
+   *p_nbr_blks = (((CPU_INT64U)lba_msb << 32u) | lba_lsb) + 1u;
+    MEM_VAL_COPY_GET_INT32U_BIG(p_blk_size, &data[8]);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_UAS_LUN_Get()
+*
+* Description : Get the SCSI properties of a LUN.
+*
+* Argument(s) : p_uas_dev       Pointer to UAS device.
+*
+*               lun             Logical unit number.
+*
+* Return(s)   : Pointer to properties of the LUN, or null pointer if the LUN is beyond USBH_UAS_CFG_MAX_LUN
+*               (see 'usbh_uas.h  Note #1c').
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_SCSI_LUN  *USBH_UAS_LUN_Get (USBH_UAS_DEV  *p_uas_dev,
+                                          CPU_INT08U     lun)
+{
+    if (lun >= USBH_UAS_CFG_MAX_LUN) {
+        return ((USBH_SCSI_LUN *)0);
+    }
+
+    return (&p_uas_dev->LUN_Tbl[lun]);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_SCSI_Xfer()
+*
+* Description : Issue a SCSI command over UAS on behalf of the shared SCSI functions (see 'usbh_msc.h
+*               Note #6').
+*
+* Argument(s) : p_dev           Pointer to UAS device.
+*
+*               Other arguments, see USBH_UAS_XferCmd().
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_UAS_SCSI_Xfer (void               *p_dev,
+                                        CPU_INT08U          lun,
+                                        USBH_MSC_DATA_DIR   dir,
+                                        void               *p_cb,
+                                        CPU_INT08U          cb_len,
+                                        void               *p_arg,
+                                        CPU_INT32U          data_len,
+                                        USBH_ERR           *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+
+    xfer_len = USBH_UAS_XferCmd((USBH_UAS_DEV *)p_dev,
+                                                lun,
+                                                dir,
+                                                p_cb,
+                                                cb_len,
+                                                p_arg,
+                                                data_len,
+                                                (USBH_UAS_SENSE *)0,
+                                                p_err);
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_UAS_SCSI_RdWr()
+*
+* Description : Read or write specified number of blocks, using as few commands as the device accepts.
+*
+* Argument(s) : p_uas_dev        Pointer to UAS device.
+*
+*               lun              Logical unit number.
+*
+*               dir              USBH_MSC_DATA_DIR_IN to read, USBH_MSC_DATA_DIR_OUT to write.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to transfer.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*                       USBH_ERR_NONE                           Data successfully transferred.
+*                       USBH_ERR_INVALID_ARG                    Transfer exceeds 2^32 - 1 octets.
+*
+*                                                               ---- RETURNED BY USBH_UAS_XferCmd ----
+*                       USBH_ERR_MSC_CMD_FAILED                 Device reports command failed.
+*                       USBH_ERR_MSC_IO                         Device reported a protocol error.
+*                       USBH_ERR_OS_TIMEOUT                     Command did not complete in time.
+*                       Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets transferred.
+*
+* Note(s)     : (1) The transfer is split as the LUN requires (see USBH_SCSI_RdWr()).
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_UAS_SCSI_RdWr (USBH_UAS_DEV       *p_uas_dev,
+                                        CPU_INT08U          lun,
+                                        USBH_MSC_DATA_DIR   dir,
+                                        CPU_INT64U          blk_addr,
+                                        CPU_INT32U          nbr_blks,
+                                        CPU_INT32U          blk_size,
+                                        void               *p_arg,
+                                        USBH_ERR           *p_err)
+{
+    CPU_INT32U  xfer_len;
+
+                                                                /* See Note #1.                                         */
+    xfer_len = USBH_SCSI_RdWr(USBH_UAS_LUN_Get(p_uas_dev, lun),
+                              USBH_UAS_SCSI_Xfer,
+                      (void *)p_uas_dev,
+                              lun,
+                              dir,
+                              blk_addr,
+                              nbr_blks,
+                              blk_size,
+                              p_arg,
+                              p_err);
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_UAS_SCSI_RdWrAsync()
+*
+* Description : Issue a read or a write of specified number of blocks without waiting for its completion.
+*
+* Argument(s) : p_uas_dev        Pointer to UAS device.
+*
+*               lun              Logical unit number.
+*
+*               dir              USBH_MSC_DATA_DIR_IN to read, USBH_MSC_DATA_DIR_OUT to write.
+*
+*               blk_addr         Block address.
+*
+*               nbr_blks         Number of blocks to transfer.
+*
+*               blk_size         Block size.
+*
+*               p_arg            Pointer to data buffer.
+*
+*               fnct             Function notified when the transfer completes.
+*
+*               p_fnct_arg       Pointer to argument passed to 'fnct'.
+*
+* Return(s)   : USBH_ERR_NONE,              if the command is successfully issued.
+*               USBH_ERR_INVALID_ARG,       if the transfer does not fit in one command (see Note #1).
+*
+*                                           ---- RETURNED BY USBH_UAS_XferCmdAsync ----
+*               USBH_ERR_ALLOC,             if USBH_UAS_CFG_CMD_Q_LEN commands are already outstanding.
+*
+* Note(s)     : (1) The transfer is not split: it is issued as a single command of at most
+*                   USBH_SCSI_XferBlkMaxGet() blocks.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_UAS_SCSI_RdWrAsync (USBH_UAS_DEV             *p_uas_dev,
+                                           CPU_INT08U                lun,
+                                           USBH_MSC_DATA_DIR         dir,
+                                           CPU_INT64U                blk_addr,
+                                           CPU_INT32U                nbr_blks,
+                                           CPU_INT32U                blk_size,
+                                           void                     *p_arg,
+                                           USBH_UAS_XFER_CMPL_FNCT   fnct,
+                                           void                     *p_fnct_arg)
+{
+    USBH_SCSI_LUN  *p_lun;
+    CPU_INT08U      cmd[16];
+    CPU_INT08U      cmd_len;
+    USBH_ERR        err;
+
+
+    p_lun = USBH_UAS_LUN_Get(p_uas_dev, lun);
+    if (nbr_blks > USBH_SCSI_XferBlkMaxGet(p_lun, blk_size)) {  /* See Note #1.                                         */
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    cmd_len = USBH_SCSI_RdWrFmt(p_lun,
+                                dir,
+                                blk_addr,
+                                nbr_blks,
+                                cmd);
+
+    err = USBH_UAS_XferCmdAsync(        p_uas_dev,
+                                        lun,
+                                        dir,
+                                (void *)cmd,
+                                        cmd_len,
+                                        p_arg,
+                                        nbr_blks * blk_size,
+                                        fnct,
+                                        p_fnct_arg);
+
+    return (err);
+}
@@ -0,0 +1,314 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                      USB ATTACHED SCSI (UAS)
+*
+* Filename : usbh_uas.h
+* Version  : V3.42.01
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_UAS_MODULE_PRESENT
+#define  USBH_UAS_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "../../Source/usbh_os.h"
+#include  "../../Source/usbh_class.h"
+#include  "../MSC/usbh_msc.h"
+
+
+/*
+*********************************************************************************************************
+*                                               EXTERNS
+*********************************************************************************************************
+*/
+
+#ifdef   USBH_UAS_MODULE
+#define  USBH_UAS_EXT
+#else
+#define  USBH_UAS_EXT  extern
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*********************************************************************************************************
+*/
+
+#define  USBH_UAS_TIMEOUT                              10000u
+
+#define  USBH_UAS_LEN_CMD_IU                              32u   /* COMMAND IU with a CDB of up to 16 octets.            */
+#define  USBH_UAS_LEN_STATUS_IU                          112u   /* Largest SENSE IU received (96 octets of sense data). */
+
+
+/*
+*********************************************************************************************************
+*                                        DEFAULT CONFIGURATION
+*
+* Note(s) : (1) The USB Attached SCSI class may be configured from 'usbh_cfg.h':
+*
+*               (a) USBH_UAS_CFG_MAX_DEV        Nbr of UAS devices that can be connected at the same time.
+*
+*               (b) USBH_UAS_CFG_CMD_Q_LEN      Nbr of commands that can be outstanding on a device. Each
+*                                               command is tagged and several commands are queued on the
+*                                               device at the same time.
+*
+*               (c) USBH_UAS_CFG_MAX_LUN        Nbr of LUNs per device whose command format and Block
+*                                               Limits VPD bound are kept (see 'usbh_msc.h  Note #6').
+*                                               Other LUNs are accessed with READ (10) / WRITE (10)
+*                                               commands when addresses fit, without Block Limits bound.
+*
+*           (2) A UAS interface has four bulk pipes: command, status, data-in and data-out. This requires
+*               USBH_CFG_MAX_NBR_EPS >= 4. One command IU, one status IU and one data piece per direction
+*               are submitted with the URB of each endpoint; each further command IU or data piece in
+*               progress takes an extra URB (see USBH_CFG_MAX_EXTRA_URB_PER_DEV) and is limited by
+*               USBH_CFG_MAX_QUEUED_URB_PER_EP. The data of a command is split in pieces of at most
+*               'DataBufMaxLen' octets (see 'usbh_core.h  HOST CONTROLLER CONFIGURATION').
+*
+*           (3) The driver implements the USB 2.0 mode of UAS, without streams. Commands are sent on the
+*               command pipe as soon as they are issued. The device then sends, on the status pipe, a
+*               READ READY or WRITE READY IU for the command it is ready to transfer data for, and a
+*               SENSE IU when the command completes, in any order between commands.
+*
+*           (4) A device that does not implement UAS is handled by the mass storage class driver over
+*               Bulk-Only Transport. The UAS class driver must be registered before the mass storage
+*               class driver (see USBH_ClassDrvReg()), so that it selects the UAS alternate setting of
+*               the interfaces that have one.
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_UAS_CFG_CMD_Q_LEN
+#define  USBH_UAS_CFG_CMD_Q_LEN                            4u
+#endif
+
+#ifndef  USBH_UAS_CFG_MAX_LUN
+#define  USBH_UAS_CFG_MAX_LUN                              1u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                             DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_uas_dev  USBH_UAS_DEV;
+
+                                                                /* ------------- ASYNC XFER NOTIFICATION -------------- */
+typedef  void  (*USBH_UAS_XFER_CMPL_FNCT)(USBH_UAS_DEV  *p_uas_dev,
+                                          void          *p_buf,
+                                          CPU_INT32U     buf_len,
+                                          CPU_INT32U     xfer_len,
+                                          void          *p_arg,
+                                          USBH_ERR       err);
+
+                                                                /* -------------------- TAGGED CMD -------------------- */
+typedef  struct  usbh_uas_cmd  USBH_UAS_CMD;
+
+struct  usbh_uas_cmd {
+    CPU_INT08U               IU_Buf[USBH_UAS_LEN_CMD_IU];       /* COMMAND IU, formatted when cmd is issued.            */
+    CPU_INT16U               Tag;                               /* Tag of cmd, unique on the dev.                       */
+    USBH_MSC_DATA_DIR        Dir;                               /* Dir of data xfer.                                    */
+    CPU_INT08U              *DataPtr;                           /* Ptr to data buf.                                     */
+    CPU_INT32U               DataLen;                           /* Len of data xfer.                                    */
+    CPU_INT32U               DataSubmitLen;                     /* Len of data xfer submitted to HC.                    */
+    CPU_INT32U               DataCmplLen;                       /* Len of data xfer completed by HC.                    */
+    CPU_INT32U               DataXferLen;                       /* Len of data xfered.                                  */
+    CPU_INT08U               URB_Cnt;                           /* Nbr of URBs in progress.                             */
+    CPU_INT08U               Flags;                             /* Progress of cmd.                                     */
+    USBH_ERR                 Err;                               /* Err of cmd.                                          */
+    CPU_INT08U               Status;                            /* SCSI status reported by SENSE IU.                    */
+    CPU_INT08U               SenseKey;                          /* Sense key         reported by SENSE IU.              */
+    CPU_INT08U               ASC;                               /* Additional sense  reported by SENSE IU.              */
+    CPU_INT08U               ASCQ;                              /* Sense qualifier   reported by SENSE IU.              */
+    USBH_HSEM                Sem;                               /* Sem signaled to task waiting for cmd.                */
+    USBH_UAS_XFER_CMPL_FNCT  CmplFnctPtr;                       /* Fnct notified of async cmd cmpl.                     */
+    void                    *CmplArgPtr;                        /* Arg passed to 'CmplFnctPtr'.                         */
+    USBH_UAS_DEV            *UAS_DevPtr;                        /* Ptr to UAS dev.                                      */
+    USBH_UAS_CMD            *NxtPtr;                            /* Ptr to next cmd in list.                             */
+};
+
+                                                                /* -------------------- UAS DEVICE -------------------- */
+struct  usbh_uas_dev {
+    USBH_EP        CmdEP;                                       /* Command  pipe (bulk OUT).                            */
+    USBH_EP        StatusEP;                                    /* Status   pipe (bulk IN).                             */
+    USBH_EP        DataInEP;                                    /* Data-in  pipe (bulk IN).                             */
+    USBH_EP        DataOutEP;                                   /* Data-out pipe (bulk OUT).                            */
+    USBH_DEV      *DevPtr;                                      /* Pointer to USB device.                               */
+    USBH_IF       *IF_Ptr;                                      /* Pointer to interface.                                */
+    CPU_INT08U     AltIx;                                       /* UAS alternate setting of interface.                  */
+    CPU_INT08U     State;                                       /* State of UAS device.                                 */
+    CPU_INT08U     RefCnt;                                      /* Cnt of app ref on this dev.                          */
+    USBH_HMUTEX    HMutex;
+    USBH_SCSI_LUN  LUN_Tbl[USBH_UAS_CFG_MAX_LUN];               /* Cmd format of each LUN.                              */
+    USBH_UAS_CMD   CmdTbl[USBH_UAS_CFG_CMD_Q_LEN];              /* Tagged cmds.                                         */
+    USBH_UAS_CMD  *CmdFreePtr;                                  /* Ptr to first free cmd.                               */
+    USBH_UAS_CMD  *CmdRsvPtr;                                   /* Ptr to first cmd handed over to a waiting task.      */
+    USBH_HSEM      CmdFreeSem;                                  /* Sem signaled when a cmd is freed.                    */
+    CPU_INT08U     CmdWaitCnt;                                  /* Nbr of tasks waiting for a free cmd.                 */
+    USBH_UAS_CMD  *TxHeadPtr;                                   /* Ptr to first cmd whose COMMAND IU is to be sent.     */
+    USBH_UAS_CMD  *TxTailPtr;                                   /* Ptr to last  cmd whose COMMAND IU is to be sent.     */
+    USBH_UAS_CMD  *DoneHeadPtr;                                 /* Ptr to first completed cmd to notify.                */
+    USBH_UAS_CMD  *DoneTailPtr;                                 /* Ptr to last  completed cmd to notify.                */
+    USBH_UAS_CMD  *DataInCmdPtr;                                /* Ptr to cmd transferring on data-in  pipe.            */
+    USBH_UAS_CMD  *DataOutCmdPtr;                               /* Ptr to cmd transferring on data-out pipe.            */
+    CPU_INT08U     ActiveCnt;                                   /* Nbr of cmds sent to dev and not completed.           */
+    CPU_INT08U     Flags;                                       /* State of engine.                                     */
+    USBH_ERR       RecoverErr;                                  /* Err that requires the recovery of the dev.           */
+    CPU_INT08U     StatusBuf[USBH_UAS_LEN_STATUS_IU];           /* IU received on status pipe.                          */
+};
+
+
+/*
+*********************************************************************************************************
+*                                            GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+USBH_UAS_EXT  USBH_CLASS_DRV  USBH_UAS_ClassDrv;
+
+
+/*
+*********************************************************************************************************
+*                                                 MACROS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                           FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+USBH_ERR     USBH_UAS_Init        (USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun);
+
+CPU_INT08U   USBH_UAS_MaxLUN_Get  (USBH_UAS_DEV           *p_uas_dev,
+                                   USBH_ERR               *p_err);
+
+CPU_BOOLEAN  USBH_UAS_UnitRdyTest (USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun,
+                                   USBH_ERR               *p_err);
+
+USBH_ERR     USBH_UAS_CapacityRd  (USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun,
+                                   CPU_INT32U             *p_nbr_blks,
+                                   CPU_INT32U             *p_blk_size);
+
+USBH_ERR     USBH_UAS_CapacityRd64(USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun,
+                                   CPU_INT64U             *p_nbr_blks,
+                                   CPU_INT32U             *p_blk_size);
+
+USBH_ERR     USBH_UAS_StdInquiry  (USBH_UAS_DEV           *p_uas_dev,
+                                   USBH_MSC_INQUIRY_INFO  *p_inquiry_info,
+                                   CPU_INT08U              lun);
+
+USBH_ERR     USBH_UAS_RefAdd      (USBH_UAS_DEV           *p_uas_dev);
+
+USBH_ERR     USBH_UAS_RefRel      (USBH_UAS_DEV           *p_uas_dev);
+
+CPU_INT32U   USBH_UAS_Rd          (USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun,
+                                   CPU_INT64U              blk_addr,
+                                   CPU_INT32U              nbr_blks,
+                                   CPU_INT32U              blk_size,
+                                   void                   *p_arg,
+                                   USBH_ERR               *p_err);
+
+CPU_INT32U   USBH_UAS_Wr          (USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun,
+                                   CPU_INT64U              blk_addr,
+                                   CPU_INT32U              nbr_blks,
+                                   CPU_INT32U              blk_size,
+                                   const  void            *p_arg,
+                                   USBH_ERR               *p_err);
+
+USBH_ERR     USBH_UAS_RdAsync     (USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun,
+                                   CPU_INT64U              blk_addr,
+                                   CPU_INT32U              nbr_blks,
+                                   CPU_INT32U              blk_size,
+                                   void                   *p_arg,
+                                   USBH_UAS_XFER_CMPL_FNCT fnct,
+                                   void                   *p_fnct_arg);
+
+USBH_ERR     USBH_UAS_WrAsync     (USBH_UAS_DEV           *p_uas_dev,
+                                   CPU_INT08U              lun,
+                                   CPU_INT64U              blk_addr,
+                                   CPU_INT32U              nbr_blks,
+                                   CPU_INT32U              blk_size,
+                                   const  void            *p_arg,
+                                   USBH_UAS_XFER_CMPL_FNCT fnct,
+                                   void                   *p_fnct_arg);
+
+
+/*
+*********************************************************************************************************
+*                                          CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_UAS_CFG_MAX_DEV
+#error  "USBH_UAS_CFG_MAX_DEV                  not #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1]                     "
+#elif   (USBH_UAS_CFG_MAX_DEV < 1u)
+#error  "USBH_UAS_CFG_MAX_DEV                  illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1]                     "
+#endif
+
+#if    ((USBH_UAS_CFG_CMD_Q_LEN <   1u) || \
+        (USBH_UAS_CFG_CMD_Q_LEN > 255u))
+#error  "USBH_UAS_CFG_CMD_Q_LEN                illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1 && <= 255]           "
+#endif
+
+#if    ((USBH_UAS_CFG_MAX_LUN <  1u) || \
+        (USBH_UAS_CFG_MAX_LUN > 16u))
+#error  "USBH_UAS_CFG_MAX_LUN                  illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1 && <= 16]            "
+#endif
+
+#if     (USBH_CFG_MAX_NBR_EPS < 4u)
+#error  "USBH_CFG_MAX_NBR_EPS                  illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 4 for UAS]             "
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE END
+*********************************************************************************************************
+*/
+
+#endif
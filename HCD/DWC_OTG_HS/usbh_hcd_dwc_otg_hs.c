@@ -450,6 +450,7 @@ struct  usbh_dwcotghs_ch_info {
     CPU_INT32U              CSPLITCnt;                          /* Used for keeping track of when CSPLIT will be sent   */  
     CPU_INT32U              SSPLITCnt;                          /* Used for keeping track of when SSPLIT has been sent  */
     USBH_DWCOTGHS_CH_INFO  *NextPtr;                            /* Used for Periodic EP linked list to service CSPLITs  */
+    CPU_BOOLEAN             DMA_Direct;                         /* DMA from/to user buf, drv mem pool not used.         */
 };
 
 
@@ -462,7 +463,9 @@ typedef  struct  usbh_drv_data {
     CPU_INT16U             RH_PortChng;                         /* Root Hub Port status change.                         */
     CPU_INT32U             SavedGINTMSK;                        /* Saved masked/unmasked int state in case of...        */
     CPU_INT32U             CSPLITChBmp;                         /* Used for CSPLITs of bulk/setup EP that need handling */    
-    CPU_INT32U             SOFCtr;                              /* Start of frame counter.                              */                     
+    CPU_INT32U             SOFCtr;                              /* Start of frame counter.                              */
+    USBH_URB              *PendURB_HeadPtr;                     /* URBs waiting for their EP channel to be free.        */
+    USBH_URB              *PendURB_TailPtr;                     
     MEM_POOL               DrvMemPool;                          /* Pool for mem mgmt to keep alignment at the drv level.*/
 } USBH_DRV_DATA;
 
@@ -632,6 +635,13 @@ static  CPU_INT08U  DWCOTGHS_GetChNbr       (USBH_DRV_DATA              *p_drv_d
 static  CPU_INT08U  DWCOTGHS_GetFreeChNbr   (USBH_DRV_DATA              *p_drv_data,
                                              USBH_ERR                   *p_err);
 
+static  CPU_BOOLEAN DWCOTGHS_PendURB_Remove (USBH_DRV_DATA              *p_drv_data,
+                                             USBH_EP                    *p_ep,
+                                             USBH_URB                   *p_urb);
+
+static  void        DWCOTGHS_PendURB_Start  (USBH_HC_DRV                *p_hc_drv,
+                                             USBH_EP                    *p_ep);
+
 static  void        DWCOTGHS_URB_ProcTask   (void                       *p_arg);
 
 static  void        DWCOTGHS_TmrCallback    (void                       *p_tmr,
@@ -965,6 +975,7 @@ static  void  USBH_DWCOTGHS_HCD_StartHandler (USBH_HC_DRV  *p_hc_drv,
         p_drv_data->ChInfoTbl[i].DoSplit     = DEF_NO;
         p_drv_data->ChInfoTbl[i].CSPLITCnt   = 0u;
         p_drv_data->ChInfoTbl[i].SSPLITCnt   = 0u;
+        p_drv_data->ChInfoTbl[i].DMA_Direct  = DEF_NO;
     }
 
                                                                 /* --------------- ENABLE VBUS DRIVING ---------------- */
@@ -1277,6 +1288,8 @@ static  void  USBH_DWCOTGHS_HCD_EP_Close (USBH_HC_DRV  *p_hc_drv,
     ch_nbr        =  DWCOTGHS_GetChNbr(p_drv_data, p_ep);
     p_ep->DataPID =  DWCOTGHS_GRXSTS_DPID_DATA0;
 
+    USBH_DWCOTGHS_HCD_EP_Abort(p_hc_drv, p_ep, p_err);          /* Drop URBs of this EP waiting for the channel.        */
+
     if (ch_nbr != DWCOTGHS_INVALID_CH) {
                                                                 /* ----------------- FREE CHANNEL #N ------------------ */
         p_reg->HCH[ch_nbr].HCINTMSKx = 0u;
@@ -1292,6 +1305,7 @@ static  void  USBH_DWCOTGHS_HCD_EP_Close (USBH_HC_DRV  *p_hc_drv,
         p_drv_data->ChInfoTbl[ch_nbr].CSPLITCnt = 0u;
         p_drv_data->ChInfoTbl[ch_nbr].SSPLITCnt = 0u;
         p_drv_data->ChInfoTbl[ch_nbr].EP_Addr   = DWCOTGHS_DFLT_EP_ADDR;
+        p_drv_data->ChInfoTbl[ch_nbr].URB_Ptr   = (USBH_URB *)0;
         DEF_BIT_CLR(p_drv_data->ChUsed, DEF_BIT(ch_nbr));
     }
 
@@ -1323,8 +1337,15 @@ static  void  USBH_DWCOTGHS_HCD_EP_Abort (USBH_HC_DRV  *p_hc_drv,
                                           USBH_EP      *p_ep,
                                           USBH_ERR     *p_err)
 {
-    (void)p_hc_drv;
-    (void)p_ep;
+    USBH_DRV_DATA  *p_drv_data;
+    CPU_SR_ALLOC();
+
+
+    p_drv_data = (USBH_DRV_DATA *)p_hc_drv->DataPtr;
+
+    CPU_CRITICAL_ENTER();                                       /* Drop URBs of this EP waiting for the channel.        */
+    (void)DWCOTGHS_PendURB_Remove(p_drv_data, p_ep, (USBH_URB *)0);
+    CPU_CRITICAL_EXIT();
 
    *p_err = USBH_ERR_NONE;
 }
@@ -1406,6 +1427,11 @@ static  CPU_BOOLEAN  USBH_DWCOTGHS_HCD_IsHalt_EP (USBH_HC_DRV  *p_hc_drv,
 *
 *               (3) For High-speed devices a binterval value of less than 4 is not supported with the
 *                   driver due to the granularity of using the OS software timers.
+*
+*               (4) A host channel is bound to an endpoint from the URB submission until the URB is completed
+*                   or aborted. URBs submitted while the endpoint's channel is busy are queued, and started
+*                   from 'USBH_DWCOTGHS_HCD_URB_Complete()' / 'USBH_DWCOTGHS_HCD_URB_Abort()' once the
+*                   channel is released.
 *********************************************************************************************************
 */
 
@@ -1419,6 +1445,7 @@ static  void  USBH_DWCOTGHS_HCD_URB_Submit (USBH_HC_DRV  *p_hc_drv,
     CPU_INT08U          ep_type;
     CPU_INT16U          poll_per;
     CPU_INT32U          reg_val;
+    CPU_SR_ALLOC();
 
 
     p_reg      = (USBH_DWCOTGHS_REG *)p_hc_drv->HC_CfgPtr->BaseAddr;
@@ -1426,6 +1453,23 @@ static  void  USBH_DWCOTGHS_HCD_URB_Submit (USBH_HC_DRV  *p_hc_drv,
     ep_type    =  USBH_EP_TypeGet(p_urb->EP_Ptr);
     ch_nbr     =  DWCOTGHS_GetChNbr(p_drv_data, p_urb->EP_Ptr);
 
+    if ((ch_nbr                                != DWCOTGHS_INVALID_CH) &&
+        (p_drv_data->ChInfoTbl[ch_nbr].URB_Ptr != (USBH_URB *)0     ) &&
+        (p_drv_data->ChInfoTbl[ch_nbr].URB_Ptr != p_urb             )) {
+        CPU_CRITICAL_ENTER();                                   /* EP channel busy, queue URB (see Note #4).            */
+        p_urb->NxtPtr = (USBH_URB *)0;
+        if (p_drv_data->PendURB_TailPtr == (USBH_URB *)0) {
+            p_drv_data->PendURB_HeadPtr = p_urb;
+        } else {
+            p_drv_data->PendURB_TailPtr->NxtPtr = p_urb;
+        }
+        p_drv_data->PendURB_TailPtr = p_urb;
+        CPU_CRITICAL_EXIT();
+
+       *p_err = USBH_ERR_NONE;
+        return;
+    }
+
     if (ch_nbr == DWCOTGHS_INVALID_CH) {                        /* Get a new ch if there is no EP associated with it    */
         ch_nbr = DWCOTGHS_GetFreeChNbr(p_drv_data, p_err);
         if (*p_err != USBH_ERR_NONE){
@@ -1589,9 +1633,11 @@ static  void  USBH_DWCOTGHS_HCD_URB_Complete (USBH_HC_DRV  *p_hc_drv,
     xfer_len = (p_drv_data->ChInfoTbl[ch_nbr].AppBufLen - xfer_len);
 
     if (p_urb->Token   == USBH_TOKEN_IN) {
-        Mem_Copy((void *)((CPU_INT32U)p_urb->UserBufPtr + p_urb->XferLen),
-                                      p_urb->DMA_BufPtr,
-                                      xfer_len);
+        if (p_drv_data->ChInfoTbl[ch_nbr].DMA_Direct == DEF_NO) {
+            Mem_Copy((void *)((CPU_INT32U)p_urb->UserBufPtr + p_urb->XferLen),
+                                          p_urb->DMA_BufPtr,
+                                          xfer_len);
+        }
 
         if (xfer_len > p_drv_data->ChInfoTbl[ch_nbr].NextXferLen) {  /* Received more data than what was expected       */
             p_urb->XferLen += p_drv_data->ChInfoTbl[ch_nbr].NextXferLen;
@@ -1620,19 +1666,25 @@ static  void  USBH_DWCOTGHS_HCD_URB_Complete (USBH_HC_DRV  *p_hc_drv,
         p_drv_data->ChInfoTbl[ch_nbr].Tmr = (USBH_HTMR)0u;
     }
 
-    Mem_PoolBlkFree(&p_drv_data->DrvMemPool,
-                     p_urb->DMA_BufPtr,
-                    &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
-       *p_err = USBH_ERR_HC_ALLOC;
+    if (p_drv_data->ChInfoTbl[ch_nbr].DMA_Direct == DEF_NO) {
+        Mem_PoolBlkFree(&p_drv_data->DrvMemPool,
+                         p_urb->DMA_BufPtr,
+                        &err_lib);
+        if (err_lib != LIB_MEM_ERR_NONE) {
+           *p_err = USBH_ERR_HC_ALLOC;
+        }
     }
     p_urb->DMA_BufPtr = (void *)0u;
 
-    p_drv_data->ChInfoTbl[ch_nbr].DoSplit   = DEF_NO;
+    p_drv_data->ChInfoTbl[ch_nbr].DoSplit    = DEF_NO;
+    p_drv_data->ChInfoTbl[ch_nbr].DMA_Direct = DEF_NO;
     p_drv_data->ChInfoTbl[ch_nbr].CSPLITCnt = 0u;
     p_drv_data->ChInfoTbl[ch_nbr].SSPLITCnt = 0u;
     p_drv_data->ChInfoTbl[ch_nbr].EP_Addr   = DWCOTGHS_DFLT_EP_ADDR;
+    p_drv_data->ChInfoTbl[ch_nbr].URB_Ptr   = (USBH_URB *)0;
     DEF_BIT_CLR(p_drv_data->ChUsed, DEF_BIT(ch_nbr));
+
+    DWCOTGHS_PendURB_Start(p_hc_drv, p_urb->EP_Ptr);            /* Start next URB queued on this EP.                    */
 }
 
 
@@ -1663,7 +1715,9 @@ static  void  USBH_DWCOTGHS_HCD_URB_Abort (USBH_HC_DRV  *p_hc_drv,
     USBH_DWCOTGHS_REG  *p_reg;
     USBH_DRV_DATA      *p_drv_data;
     CPU_INT08U          ch_nbr;
+    CPU_BOOLEAN         removed;
     LIB_ERR             err_lib;
+    CPU_SR_ALLOC();
 
 
     p_reg      = (USBH_DWCOTGHS_REG *)p_hc_drv->HC_CfgPtr->BaseAddr;
@@ -1672,11 +1726,20 @@ static  void  USBH_DWCOTGHS_HCD_URB_Abort (USBH_HC_DRV  *p_hc_drv,
     p_urb->Err =  USBH_ERR_URB_ABORT;
    *p_err      =  USBH_ERR_NONE;
 
-    Mem_PoolBlkFree(&p_drv_data->DrvMemPool,
-                     p_urb->DMA_BufPtr,
-                    &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
-       *p_err = USBH_ERR_HC_ALLOC;
+    CPU_CRITICAL_ENTER();
+    removed = DWCOTGHS_PendURB_Remove(p_drv_data, p_urb->EP_Ptr, p_urb);
+    CPU_CRITICAL_EXIT();
+    if (removed == DEF_YES) {                                   /* URB was not started on the channel.                  */
+        return;
+    }
+
+    if (p_drv_data->ChInfoTbl[ch_nbr].DMA_Direct == DEF_NO) {
+        Mem_PoolBlkFree(&p_drv_data->DrvMemPool,
+                         p_urb->DMA_BufPtr,
+                        &err_lib);
+        if (err_lib != LIB_MEM_ERR_NONE) {
+           *p_err = USBH_ERR_HC_ALLOC;
+        }
     }
     p_urb->DMA_BufPtr = (void *)0u;
 
@@ -1684,6 +1747,12 @@ static  void  USBH_DWCOTGHS_HCD_URB_Abort (USBH_HC_DRV  *p_hc_drv,
     p_reg->HCH[ch_nbr].HCINTMSKx = 0u;
     p_reg->HCH[ch_nbr].HCINTx    = 0xFFFFFFFFu;
     p_reg->HCH[ch_nbr].HCTSIZx   = 0u;
+
+    if (ch_nbr != DWCOTGHS_INVALID_CH) {
+        p_drv_data->ChInfoTbl[ch_nbr].URB_Ptr = (USBH_URB *)0;
+    }
+
+    DWCOTGHS_PendURB_Start(p_hc_drv, p_urb->EP_Ptr);            /* Start next URB queued on this EP.                    */
 }
 
 
@@ -2604,6 +2673,7 @@ static  void  DWCOTGHS_ISR_HostChOUT (USBH_DWCOTGHS_REG  *p_reg,
         }
 
         p_ch_info->EP_TxErrCnt++;
+        USBH_EP_STAT_RETRY_INC(p_urb->EP_Ptr);
 
         DEF_BIT_SET(p_reg->HCH[ch_nbr].HCINTMSKx, DWCOTGHS_HCINTx_CHH);
         p_reg->HCH[ch_nbr].HCCHARx |= DWCOTGHS_HCCHARx_CHDIS;
@@ -2614,6 +2684,7 @@ static  void  DWCOTGHS_ISR_HostChOUT (USBH_DWCOTGHS_REG  *p_reg,
 
     } else if (hcint_reg & DWCOTGHS_HCINTx_NAK) {
         p_reg->HCH[ch_nbr].HCINTx = DWCOTGHS_HCINTx_NAK;        /* Clear int.                                           */
+        USBH_EP_STAT_NAK_INC(p_urb->EP_Ptr);
 
         p_ch_info->EP_TxErrCnt = 0;
         if (ep_type == USBH_EP_TYPE_INTR) {
@@ -2742,6 +2813,7 @@ static  void  DWCOTGHS_ISR_HostChIN (USBH_DWCOTGHS_REG  *p_reg,
         }
 
         p_ch_info->EP_TxErrCnt++;
+        USBH_EP_STAT_RETRY_INC(p_urb->EP_Ptr);
 
         DEF_BIT_SET(p_reg->HCH[ch_nbr].HCINTMSKx, DWCOTGHS_HCINTx_CHH);
         p_reg->HCH[ch_nbr].HCCHARx |= DWCOTGHS_HCCHARx_CHDIS;
@@ -2762,6 +2834,7 @@ static  void  DWCOTGHS_ISR_HostChIN (USBH_DWCOTGHS_REG  *p_reg,
 
     } else if (hcint_reg & DWCOTGHS_HCINTx_NAK) {
         p_reg->HCH[ch_nbr].HCINTx = DWCOTGHS_HCINTx_NAK;        /* Clear int.                                           */
+        USBH_EP_STAT_NAK_INC(p_urb->EP_Ptr);
 
         p_ch_info->EP_TxErrCnt = 0;
         if (ep_type == USBH_EP_TYPE_INTR) {
@@ -2893,7 +2966,13 @@ static  void  DWCOTGHS_ChSplitHandler (USBH_DWCOTGHS_REG  *p_reg,
 *
 * Return(s)   : None.
 *
-* Note(s)     : None
+* Note(s)     : (1) The user buffer is used by the channel DMA when the core flagged it as reachable by
+*                   the host controller and it is aligned on a 32-bit boundary. Direct DMA also requires
+*                   the system memory region reachable by the DMA to be described by 'DMA_MemAddr' and
+*                   'DMA_MemSize' in the host controller configuration. Otherwise, the driver memory pool
+*                   is always used. For IN transfers, the buffer length must also be a multiple of the
+*                   maximum packet size since the channel is always programmed with a whole number of
+*                   packets (see 'DWCOTGHS_ChXferStart() Note #2').
 *********************************************************************************************************
 */
 
@@ -2902,15 +2981,19 @@ static  void  DWCOTGHS_ChInit (USBH_DWCOTGHS_REG  *p_reg,
                                CPU_INT08U          ch_nbr,
                                USBH_ERR           *p_err)
 {
+    USBH_HC_DRV    *p_hc_drv;
     USBH_DRV_DATA  *p_drv_data;
     CPU_INT32U      reg_val;
     CPU_INT08U      ep_nbr;
     CPU_INT08U      ep_type;
     CPU_INT16U      ep_pkt_size;
+    CPU_BOOLEAN     dma_direct;
     LIB_ERR         err_lib;
+    CPU_SR_ALLOC();
 
 
-    p_drv_data  = (USBH_DRV_DATA *)p_urb->EP_Ptr->DevPtr->HC_Ptr->HC_Drv.DataPtr;
+    p_hc_drv    = &p_urb->EP_Ptr->DevPtr->HC_Ptr->HC_Drv;
+    p_drv_data  = (USBH_DRV_DATA *)p_hc_drv->DataPtr;
     ep_nbr      =  USBH_EP_LogNbrGet(p_urb->EP_Ptr);
     ep_type     =  USBH_EP_TypeGet(p_urb->EP_Ptr);
     ep_pkt_size =  USBH_EP_MaxPktSizeGet(p_urb->EP_Ptr);
@@ -2927,7 +3010,23 @@ static  void  DWCOTGHS_ChInit (USBH_DWCOTGHS_REG  *p_reg,
     }
 #endif
 
-    if (p_urb->DMA_BufPtr == (void *)0u) {
+    dma_direct = p_urb->DMA_Direct;                             /* See Note #1.                                         */
+    if ((p_hc_drv->HC_CfgPtr->DMA_MemSize   == 0u) ||
+        (p_urb->UserBufLen                  == 0u) ||
+        (((CPU_ADDR)p_urb->UserBufPtr % 4u) != 0u)) {
+        dma_direct = DEF_NO;
+    }
+    if ((p_urb->Token                       == USBH_TOKEN_IN) &&
+        ((p_urb->UserBufLen % ep_pkt_size) != 0u           )) {
+        dma_direct = DEF_NO;
+    }
+    p_drv_data->ChInfoTbl[ch_nbr].DMA_Direct = dma_direct;
+
+    if (dma_direct == DEF_YES) {
+        CPU_CRITICAL_ENTER();
+        p_hc_drv->DMA_Stat.DirectCnt++;
+        CPU_CRITICAL_EXIT();
+    } else if (p_urb->DMA_BufPtr == (void *)0u) {
         p_urb->DMA_BufPtr = Mem_PoolBlkGet(&p_drv_data->DrvMemPool,
                                             p_drv_data->DrvMemPool.BlkSize,
                                            &err_lib);
@@ -2935,6 +3034,11 @@ static  void  DWCOTGHS_ChInit (USBH_DWCOTGHS_REG  *p_reg,
            *p_err = USBH_ERR_HC_ALLOC;
             return;
         }
+        if (p_urb->UserBufLen != 0u) {
+            CPU_CRITICAL_ENTER();
+            p_hc_drv->DMA_Stat.BounceCnt++;
+            CPU_CRITICAL_EXIT();
+        }
     }
 
     p_reg->HCH[ch_nbr].HCINTx    =  0x000007FFu;                /* Clear old interrupt conditions for this host channel */
@@ -2997,6 +3101,9 @@ static  void  DWCOTGHS_ChInit (USBH_DWCOTGHS_REG  *p_reg,
 *               (2) For an IN, HCTSIZx[XferSize] contains the buffer size that the application has
 *                   reserved for the transfer. The application is expected to program this field as an
 *                   integer multiple of the maximum size for IN transactions (periodic and non-periodic).
+*               (3) When the channel uses the user buffer directly (see 'DWCOTGHS_ChInit() Note #1'), the
+*                   DMA address is moved to the next chunk of the user buffer instead of copying the data
+*                   into the driver buffer.
 *********************************************************************************************************
 */
 
@@ -3052,11 +3159,15 @@ static  void  DWCOTGHS_ChXferStart (USBH_DWCOTGHS_REG      *p_reg,
     reg_val |= (p_ch_info->AppBufLen & DWCOTGHS_HCTSIZx_XFRSIZ_MSK); /* Transfer Size                                   */
     p_reg->HCH[ch_nbr].HCTSIZx = reg_val;
 
-    Mem_Clr(p_urb->DMA_BufPtr, p_ch_info->NextXferLen);
-    if (p_urb->Token != USBH_TOKEN_IN) {
-        Mem_Copy(                     p_urb->DMA_BufPtr,
-                 (void *)((CPU_INT32U)p_urb->UserBufPtr + p_urb->XferLen),
-                                      p_ch_info->NextXferLen);
+    if (p_ch_info->DMA_Direct == DEF_YES) {                     /* See Note #3.                                         */
+        p_urb->DMA_BufPtr = (void *)((CPU_INT32U)p_urb->UserBufPtr + p_urb->XferLen);
+    } else {
+        Mem_Clr(p_urb->DMA_BufPtr, p_ch_info->NextXferLen);
+        if (p_urb->Token != USBH_TOKEN_IN) {
+            Mem_Copy(                     p_urb->DMA_BufPtr,
+                     (void *)((CPU_INT32U)p_urb->UserBufPtr + p_urb->XferLen),
+                                          p_ch_info->NextXferLen);
+        }
     }
 
     is_oddframe = (p_reg->HFNUM & 0x01u) ? 0u : 1u;             /* Host perform a xfer in an odd/even (micro)frame.     */
@@ -3064,7 +3175,7 @@ static  void  DWCOTGHS_ChXferStart (USBH_DWCOTGHS_REG      *p_reg,
     p_reg->HCH[ch_nbr].HCCHARx |= (is_oddframe << 29u);
 
     DEF_BIT_SET(p_reg->HCH[ch_nbr].HCINTMSKx, DWCOTGHS_HCINTx_CHH);
-    p_reg->HCH[ch_nbr].HCDMAx = (CPU_INT32U)p_urb->DMA_BufPtr;
+    p_reg->HCH[ch_nbr].HCDMAx = (CPU_INT32U)USBH_OS_VirToBus(p_urb->DMA_BufPtr);
 
     if (ep_type == USBH_EP_TYPE_INTR) {
         *p_err = USBH_OS_TmrStart(p_drv_data->ChInfoTbl[ch_nbr].Tmr);
@@ -3115,7 +3226,7 @@ static  void  DWCOTGHS_ChEnable (USBH_DWCOTGHS_HOST_CH_REG  *p_ch_reg,
     }
 
     if (p_urb->Token != USBH_TOKEN_IN) {
-        p_ch_reg->HCDMAx = (CPU_INT32U)p_urb->DMA_BufPtr;       /* Rewind buffer.                                       */
+        p_ch_reg->HCDMAx = (CPU_INT32U)USBH_OS_VirToBus(p_urb->DMA_BufPtr);   /* Rewind buffer.                         */
     }
                                                                 /* --------------- ENABLE HOST CHANNEL ---------------- */
 #if (DWCOTGHS_DRV_DEBUG == DEF_ENABLED)                         /* Check if Channel is in unknown state.                */
@@ -3203,6 +3314,120 @@ static  CPU_INT08U  DWCOTGHS_GetFreeChNbr (USBH_DRV_DATA  *p_drv_data,
 }
 
 
+/*
+*********************************************************************************************************
+*                                      DWCOTGHS_PendURB_Remove()
+*
+* Description : Remove URB(s) from the queue of URBs waiting for their endpoint channel.
+*
+* Argument(s) : p_drv_data     Pointer to host driver data structure.
+*
+*               p_ep           Pointer to endpoint structure.
+*
+*               p_urb          Pointer to URB structure to remove, or null pointer to remove all the URBs
+*                              of the endpoint.
+*
+* Return(s)   : DEF_YES, if at least one URB has been removed.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : (1) This function MUST be called with interrupts disabled.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  DWCOTGHS_PendURB_Remove (USBH_DRV_DATA  *p_drv_data,
+                                              USBH_EP        *p_ep,
+                                              USBH_URB       *p_urb)
+{
+    USBH_URB     *p_cur_urb;
+    USBH_URB     *p_prev_urb;
+    CPU_BOOLEAN   removed;
+
+
+    removed    =  DEF_NO;
+    p_prev_urb = (USBH_URB *)0;
+    p_cur_urb  =  p_drv_data->PendURB_HeadPtr;
+
+    while (p_cur_urb != (USBH_URB *)0) {
+        if ((p_cur_urb          == p_urb) ||
+            ((p_urb             == (USBH_URB *)0) &&
+             (p_cur_urb->EP_Ptr == p_ep         ))) {
+                                                                /* Unlink URB from the queue.                           */
+            if (p_prev_urb == (USBH_URB *)0) {
+                p_drv_data->PendURB_HeadPtr = p_cur_urb->NxtPtr;
+            } else {
+                p_prev_urb->NxtPtr          = p_cur_urb->NxtPtr;
+            }
+            if (p_drv_data->PendURB_TailPtr == p_cur_urb) {
+                p_drv_data->PendURB_TailPtr = p_prev_urb;
+            }
+            removed = DEF_YES;
+        } else {
+            p_prev_urb = p_cur_urb;
+        }
+
+        p_cur_urb = p_cur_urb->NxtPtr;
+    }
+
+    return (removed);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       DWCOTGHS_PendURB_Start()
+*
+* Description : Start the next URB waiting for the channel of the given endpoint, if any.
+*
+* Argument(s) : p_hc_drv       Pointer to host controller driver structure.
+*
+*               p_ep           Pointer to endpoint structure.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) URBs that cannot be started are returned to the core with an error.
+*********************************************************************************************************
+*/
+
+static  void  DWCOTGHS_PendURB_Start (USBH_HC_DRV  *p_hc_drv,
+                                      USBH_EP      *p_ep)
+{
+    USBH_DRV_DATA  *p_drv_data;
+    USBH_URB       *p_urb;
+    USBH_ERR        err;
+    CPU_SR_ALLOC();
+
+
+    p_drv_data = (USBH_DRV_DATA *)p_hc_drv->DataPtr;
+
+    while (DEF_TRUE) {
+        CPU_CRITICAL_ENTER();                                   /* Get first URB queued on this EP.                     */
+        p_urb = p_drv_data->PendURB_HeadPtr;
+        while ((p_urb         != (USBH_URB *)0) &&
+               (p_urb->EP_Ptr != p_ep         )) {
+            p_urb = p_urb->NxtPtr;
+        }
+        if (p_urb != (USBH_URB *)0) {
+            (void)DWCOTGHS_PendURB_Remove(p_drv_data, p_ep, p_urb);
+        }
+        CPU_CRITICAL_EXIT();
+
+        if (p_urb == (USBH_URB *)0) {
+            return;
+        }
+
+        p_urb->NxtPtr = (USBH_URB *)0;
+        USBH_DWCOTGHS_HCD_URB_Submit(p_hc_drv, p_urb, &err);
+        if (err == USBH_ERR_NONE) {
+            return;
+        }
+
+        p_urb->Err     = err;                                   /* See Note #1.                                         */
+        p_urb->XferLen = 0u;
+        USBH_URB_Done(p_urb);
+    }
+}
+
+
 /*
 *********************************************************************************************************
 *                                       DWCOTGHS_URB_ProcTask()
@@ -3258,9 +3483,11 @@ static void  DWCOTGHS_URB_ProcTask (void  *p_arg)
             xfer_len = (p_drv_data->ChInfoTbl[ch_nbr].AppBufLen - xfer_len);
 
             if (p_urb->Token == USBH_TOKEN_IN) {                /* -------------- HANDLE IN TRANSACTIONS -------------- */
-                Mem_Copy((void *)((CPU_INT32U)p_urb->UserBufPtr + p_urb->XferLen),
-                                              p_urb->DMA_BufPtr,
-                                              xfer_len);
+                if (p_drv_data->ChInfoTbl[ch_nbr].DMA_Direct == DEF_NO) {
+                    Mem_Copy((void *)((CPU_INT32U)p_urb->UserBufPtr + p_urb->XferLen),
+                                                  p_urb->DMA_BufPtr,
+                                                  xfer_len);
+                }
 
                 if (xfer_len > p_drv_data->ChInfoTbl[ch_nbr].NextXferLen) {  /* Rx'd more data than what was expected   */
                     p_urb->XferLen += p_drv_data->ChInfoTbl[ch_nbr].NextXferLen;
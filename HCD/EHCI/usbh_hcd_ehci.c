@@ -672,9 +672,25 @@ static  EHCI_QTD      *EHCI_QTDListPrepare      (USBH_HC_DRV           *p_hc_drv
                                                  CPU_INT32U             buf_len,
                                                  USBH_ERR              *p_err);
 
+static  EHCI_QTD      *EHCI_QTDListSG_Prepare   (USBH_HC_DRV           *p_hc_drv,
+                                                 USBH_EP               *p_ep,
+                                                 USBH_URB              *p_urb,
+                                                 USBH_ERR              *p_err);
+
+static  void           EHCI_SG_DCacheSync       (USBH_URB              *p_urb,
+                                                 CPU_INT32U             len,
+                                                 CPU_BOOLEAN            inv);
+
 static  CPU_INT32U     EHCI_QTDRemove           (USBH_HC_DRV           *p_hc_drv,
                                                  EHCI_QH               *p_qh);
 
+static  CPU_INT32U     EHCI_QTDSegRemove        (USBH_HC_DRV           *p_hc_drv,
+                                                 EHCI_QH               *p_qh);
+
+static  void           EHCI_QTDSegUnlink        (USBH_HC_DRV           *p_hc_drv,
+                                                 EHCI_QH               *p_qh,
+                                                 EHCI_QTD              *p_seg_head);
+
 #if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
 static  USBH_ERR       EHCI_PeriodicListInit    (USBH_HC_DRV           *p_hc_drv);
 #endif
@@ -702,6 +718,41 @@ static  USBH_ERR       EHCI_BW_Get              (USBH_HC_DRV           *p_hc_drv
                                                  USBH_EP               *p_ep,
                                                  void                  *p_data);
 
+static  USBH_ERR       EHCI_BW_SplitGet         (USBH_HC_DRV           *p_hc_drv,
+                                                 USBH_EP               *p_ep,
+                                                 void                  *p_data,
+                                                 CPU_INT16U             frame_interval);
+
+static  CPU_INT16U     EHCI_BW_MaskAvail        (EHCI_DEV              *p_ehci,
+                                                 CPU_INT16U             start_frame,
+                                                 CPU_INT16U             frame_interval,
+                                                 CPU_INT08U             mask);
+
+static  EHCI_TT       *EHCI_TT_Get              (EHCI_DEV              *p_ehci,
+                                                 USBH_EP               *p_ep,
+                                                 CPU_BOOLEAN            alloc);
+
+static  CPU_INT16U     EHCI_TT_LenGet           (USBH_EP               *p_ep);
+
+static  CPU_BOOLEAN    EHCI_TT_MaskGet          (USBH_EP               *p_ep,
+                                                 CPU_INT08U             micro_frame_nbr,
+                                                 CPU_INT08U            *p_s_mask,
+                                                 CPU_INT08U            *p_c_mask);
+
+static  CPU_BOOLEAN    EHCI_TT_BW_Avail         (EHCI_TT               *p_tt,
+                                                 CPU_INT16U             start_frame,
+                                                 CPU_INT16U             frame_interval,
+                                                 CPU_INT08U             micro_frame_nbr,
+                                                 CPU_INT16U             fs_len,
+                                                 CPU_INT16U            *p_min_avail);
+
+static  void           EHCI_TT_BW_Update        (EHCI_TT               *p_tt,
+                                                 CPU_INT16U             start_frame,
+                                                 CPU_INT16U             frame_interval,
+                                                 CPU_INT08U             micro_frame_nbr,
+                                                 CPU_INT16U             fs_len,
+                                                 CPU_BOOLEAN            bw_use);
+
 static  USBH_ERR       EHCI_SITDListPrepare     (USBH_HC_DRV           *p_hc_drv,
                                                  USBH_DEV              *p_dev,
                                                  USBH_EP               *p_ep,
@@ -971,6 +1022,7 @@ static  void  EHCI_InitHandler (USBH_HC_DRV  *p_hc_drv,
 #if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
     CPU_INT16U        frame_nbr;
     CPU_INT08U        micro_frame_nbr;
+    CPU_INT08U        tt_ix;
 #endif
 
 
@@ -986,6 +1038,7 @@ static  void  EHCI_InitHandler (USBH_HC_DRV  *p_hc_drv,
     Mem_Clr(p_ehci, sizeof(EHCI_DEV));
 
     p_hc_drv->DataPtr  = (void *)p_ehci;
+    p_hc_drv->SG_En    =  DEF_TRUE;                             /* qTD lists are built from SG seg tbl.                 */
     p_ehci->HC_Started =  DEF_FALSE;
     p_hc_cfg           =  p_hc_drv->HC_CfgPtr;
     p_bsp_api          =  p_hc_drv->BSP_API_Ptr;
@@ -1045,6 +1098,11 @@ static  void  EHCI_InitHandler (USBH_HC_DRV  *p_hc_drv,
         }
     }
 
+    for (tt_ix = 0u; tt_ix < EHCI_CFG_TT_NBR; tt_ix++) {        /* No TT has split xacts scheduled.                     */
+        p_ehci->TT_Tbl[tt_ix].HubPtr = (void *)0;
+        p_ehci->TT_Tbl[tt_ix].EP_Cnt = 0u;
+    }
+
     EHCI_PeriodicOrderPrepare(0u, 7u, 256u);
     EHCI_PeriodicListInit(p_hc_drv);
 #endif
@@ -1312,7 +1370,8 @@ static  CPU_INT32U  EHCI_FrameNbrGet (USBH_HC_DRV  *p_hc_drv,
 * Note(s)     : (1) Handle Cache Coherency for the p_ehci->AsyncQHHead data structure
 *
 *               (2) See USB2.0 specification, section 9.6.6. Interval for polling endpoint for data
-*                   transfers can be obtained from the equataion 2 POW (bInterval - 1)
+*                   transfers can be obtained from the equataion 2 POW (bInterval - 1). The polling interval
+*                   of interrupt endpoints is the one set by the core (see EHCI_BW_Get() Note #2).
 *********************************************************************************************************
 */
 
@@ -1479,7 +1538,7 @@ static  CPU_BOOLEAN  EHCI_IsHalt_EP (USBH_HC_DRV  *p_hc_drv,
 *********************************************************************************************************
 *                                          EHCI_URB_Submit()
 *
-* Description : Insert the QTD list head into the appropriate QH.
+* Description : Insert the QTD list into the appropriate QH.
 *
 * Argument(s) : p_hc_drv     Pointer to host controller driver structure.
 *
@@ -1496,6 +1555,20 @@ static  CPU_BOOLEAN  EHCI_IsHalt_EP (USBH_HC_DRV  *p_hc_drv,
 *                   start address is computed. This address is aligned on the cache line. The number of
 *                   octets to flush or invalidate will be increased accordingly to take into account
 *                   the buffer size plus the address adjustment.
+*
+*               (2) Several URBs can be queued on the same QH. The qTD list of each URB is appended to the
+*                   last qTD of the previous list, so the host controller moves from one URB to the next
+*                   without software intervention. The last qTD of each list has its IOC bit set, which
+*                   delimits the URBs in the chain. If the host controller already retired the previous
+*                   list, the QH is restarted from 'EHCI_QHDone()'.
+*
+*               (3) Scatter-gather URBs are built with one qTD list per segment when the data buffer is
+*                   in system memory (see 'EHCI_QTDListSG_Prepare()'). When the data buffer comes from
+*                   dedicated memory, the segments are gathered into the DMA buffer instead.
+*
+*               (4) When the core flagged the URB data buffer as reachable by the host controller DMA,
+*                   the bounce buffer from dedicated memory is skipped and the user buffer is handled as
+*                   a system memory buffer.
 *********************************************************************************************************
 */
 
@@ -1506,7 +1579,10 @@ static  void  EHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
     EHCI_DEV           *p_ehci;
     EHCI_QH            *p_qh;
     EHCI_QTD           *p_head_qtd;
+    EHCI_QTD           *p_tail_qtd;
+    EHCI_QTD           *p_prev_qtd;
     CPU_INT08U          ep_type;
+    CPU_BOOLEAN         sg_en;
     LIB_ERR             err_lib;
     USBH_HC_CFG        *p_hc_cfg;
     USBH_EP            *p_ep;
@@ -1524,10 +1600,12 @@ static  void  EHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
     p_dev    = p_ep->DevPtr;
 #endif
     ep_type  = USBH_EP_TypeGet(p_ep);
+    sg_en    = DEF_FALSE;
 
                                                                 /* ----------- DATA BUF FROM DEDICATED MEM ------------ */
-    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0) &&
-        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED)) {
+    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0 ) &&
+        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED) &&
+        (p_urb->DMA_Direct             == DEF_FALSE   )) {      /* See Note #4.                                         */
 
         if (ep_type == USBH_EP_TYPE_ISOC) {
             if (p_urb->UserBufLen > p_hc_cfg->DataBufMaxLen) {
@@ -1545,6 +1623,9 @@ static  void  EHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
                *p_err = USBH_ERR_ALLOC;
                 return;
             }
+            CPU_CRITICAL_ENTER();
+            p_hc_drv->DMA_Stat.BounceCnt++;
+            CPU_CRITICAL_EXIT();
 
             p_urb->DMA_BufLen = DEF_MIN(p_urb->UserBufLen,
                                         p_hc_cfg->DataBufMaxLen);
@@ -1552,9 +1633,15 @@ static  void  EHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
             if ((p_urb->Token == USBH_TOKEN_OUT  ) ||
                 (p_urb->Token == USBH_TOKEN_SETUP)) {
 
-                Mem_Copy(p_urb->DMA_BufPtr,
-                         p_urb->UserBufPtr,
-                         p_urb->DMA_BufLen);
+                if (USBH_URB_IS_SG(p_urb)) {                    /* See Note #3.                                         */
+                    (void)USBH_URB_SG_Gather(p_urb,
+                                             p_urb->DMA_BufPtr,
+                                             p_urb->DMA_BufLen);
+                } else {
+                    Mem_Copy(p_urb->DMA_BufPtr,
+                             p_urb->UserBufPtr,
+                             p_urb->DMA_BufLen);
+                }
 
                 CPU_DCACHE_RANGE_FLUSH(p_urb->DMA_BufPtr, p_urb->DMA_BufLen);
             } else {
@@ -1572,24 +1659,41 @@ static  void  EHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
         p_urb->DMA_BufPtr = p_urb->UserBufPtr;
         p_urb->DMA_BufLen = p_urb->UserBufLen;
 
-#if (CPU_CFG_CACHE_MGMT_EN == DEF_ENABLED)                      /* See Note #1.                                         */
-        remainder = (CPU_INT08U)(((CPU_INT32U)p_urb->DMA_BufPtr) % CPU_Cache_Linesize);
-        if (remainder != 0u) {
-            p_cache_aligned_buf_addr = ((CPU_INT08U *)p_urb->DMA_BufPtr) - remainder;
-            len                      =   p_urb->DMA_BufLen + remainder;
-        } else {
-            p_cache_aligned_buf_addr = (CPU_INT08U *)p_urb->DMA_BufPtr;
-            len                      =  p_urb->DMA_BufLen;
+        if (p_urb->UserBufLen != 0u) {
+            CPU_CRITICAL_ENTER();
+            p_hc_drv->DMA_Stat.DirectCnt++;
+            CPU_CRITICAL_EXIT();
         }
 
-        if (((p_urb->Token     == USBH_TOKEN_OUT  )  ||
-             (p_urb->Token     == USBH_TOKEN_SETUP)) &&
-            (p_urb->DMA_BufLen != 0u)) {
+        if (USBH_URB_IS_SG(p_urb)) {                            /* See Note #3.                                         */
+            sg_en             = DEF_TRUE;
+            p_urb->DMA_BufPtr = p_urb->SG_SegTblPtr[0u].BufPtr;
+        }
 
-            CPU_DCACHE_RANGE_FLUSH(p_cache_aligned_buf_addr, len);
+#if (CPU_CFG_CACHE_MGMT_EN == DEF_ENABLED)                      /* See Note #1.                                         */
+        if (sg_en == DEF_TRUE) {
+            EHCI_SG_DCacheSync(p_urb,
+                               p_urb->DMA_BufLen,
+                              (p_urb->Token == USBH_TOKEN_IN) ? DEF_TRUE : DEF_FALSE);
         } else {
-            CPU_DCACHE_RANGE_FLUSH(p_cache_aligned_buf_addr, len);
-            CPU_DCACHE_RANGE_INV(p_cache_aligned_buf_addr, len);
+            remainder = (CPU_INT08U)(((CPU_INT32U)p_urb->DMA_BufPtr) % CPU_Cache_Linesize);
+            if (remainder != 0u) {
+                p_cache_aligned_buf_addr = ((CPU_INT08U *)p_urb->DMA_BufPtr) - remainder;
+                len                      =   p_urb->DMA_BufLen + remainder;
+            } else {
+                p_cache_aligned_buf_addr = (CPU_INT08U *)p_urb->DMA_BufPtr;
+                len                      =  p_urb->DMA_BufLen;
+            }
+
+            if (((p_urb->Token     == USBH_TOKEN_OUT  )  ||
+                 (p_urb->Token     == USBH_TOKEN_SETUP)) &&
+                (p_urb->DMA_BufLen != 0u)) {
+
+                CPU_DCACHE_RANGE_FLUSH(p_cache_aligned_buf_addr, len);
+            } else {
+                CPU_DCACHE_RANGE_FLUSH(p_cache_aligned_buf_addr, len);
+                CPU_DCACHE_RANGE_INV(p_cache_aligned_buf_addr, len);
+            }
         }
 #endif
     }
@@ -1600,19 +1704,42 @@ static  void  EHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
 
         p_qh = (EHCI_QH *)p_ep->ArgPtr;
 
-        p_head_qtd = EHCI_QTDListPrepare(p_hc_drv,
-                                         p_ep,
-                                         p_urb,
-                                        (p_urb->DMA_BufLen) ? (CPU_INT08U *)(p_urb->DMA_BufPtr) : (CPU_INT08U *)0,
-                                         p_urb->DMA_BufLen,
-                                         p_err);
+        if (sg_en == DEF_TRUE) {
+            p_head_qtd = EHCI_QTDListSG_Prepare(p_hc_drv,
+                                                p_ep,
+                                                p_urb,
+                                                p_err);
+        } else {
+            p_head_qtd = EHCI_QTDListPrepare(p_hc_drv,
+                                             p_ep,
+                                             p_urb,
+                                            (p_urb->DMA_BufLen) ? (CPU_INT08U *)(p_urb->DMA_BufPtr) : (CPU_INT08U *)0,
+                                             p_urb->DMA_BufLen,
+                                             p_err);
+        }
         if (p_head_qtd == 0) {
             return;
         }
 
+        p_tail_qtd = p_head_qtd;                                /* Find last qTD of the list.                           */
+        while ((p_tail_qtd->QTDNxtPtr & QTD_N_QTD_PTR_T(1u)) == 0u) {
+            p_tail_qtd = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_tail_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+        }
+
+        p_urb->ArgPtr = (void *)p_head_qtd;                     /* Used to retrieve the URB on completion.              */
+
         CPU_CRITICAL_ENTER();
-        p_qh->QTDHead     = (CPU_INT32U)p_head_qtd;
-        p_qh->QHNxtQTDPtr = (CPU_INT32U)USBH_OS_VirToBus((void *)p_head_qtd);
+        CPU_DCACHE_RANGE_INV(p_qh, sizeof(EHCI_QH));
+        if (p_qh->QTDHead == 0u) {                              /* No URB in progress on this QH.                       */
+            p_qh->QTDHead     = (CPU_INT32U)p_head_qtd;
+            p_qh->QTDTail     = (CPU_INT32U)p_tail_qtd;
+            p_qh->QHNxtQTDPtr = (CPU_INT32U)USBH_OS_VirToBus((void *)p_head_qtd);
+        } else {                                                /* Append qTD list to the chain (see Note #2).          */
+            p_prev_qtd            = (EHCI_QTD *)p_qh->QTDTail;
+            p_prev_qtd->QTDNxtPtr = (CPU_INT32U)USBH_OS_VirToBus((void *)p_head_qtd);
+            CPU_DCACHE_RANGE_FLUSH(p_prev_qtd, sizeof(EHCI_QTD));
+            p_qh->QTDTail         = (CPU_INT32U)p_tail_qtd;
+        }
         CPU_DCACHE_RANGE_FLUSH(p_qh, sizeof(EHCI_QH));
         CPU_CRITICAL_EXIT();
 
@@ -1658,6 +1785,8 @@ static  void  EHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
 * Return(s)   : None
 *
 * Note(s)     : (1) See Note #1 in function 'EHCI_URB_Submit()'.
+*
+*               (2) See Note #4 in function 'EHCI_URB_Submit()'.
 *********************************************************************************************************
 */
 
@@ -1673,8 +1802,9 @@ static  void  EHCI_URB_Complete (USBH_HC_DRV  *p_hc_drv,
     p_ehci   = (EHCI_DEV *)p_hc_drv->DataPtr;
     p_hc_cfg = p_hc_drv->HC_CfgPtr;
                                                                 /* ----------- DATA BUF FROM DEDICATED MEM ------------ */
-    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0) &&
-        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED)) {
+    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0 ) &&
+        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED) &&
+        (p_urb->DMA_Direct             == DEF_FALSE   )) {      /* See Note #2.                                         */
 
          if ((p_urb->UserBufPtr  != p_urb->DMA_BufPtr) &&
              (p_urb->DMA_BufPtr  != (void *)0        )) {
@@ -1687,21 +1817,28 @@ static  void  EHCI_URB_Complete (USBH_HC_DRV  *p_hc_drv,
                 CPU_INT08U   remainder;
 #endif
 
-                Mem_Copy(p_urb->UserBufPtr,
-                         p_urb->DMA_BufPtr,
-                         p_urb->XferLen);
+                if (USBH_URB_IS_SG(p_urb)) {
+                    (void)USBH_URB_SG_Scatter(p_urb,
+                                              p_urb->DMA_BufPtr,
+                                              p_urb->XferLen);
+                    EHCI_SG_DCacheSync(p_urb, p_urb->XferLen, DEF_FALSE);
+                } else {
+                    Mem_Copy(p_urb->UserBufPtr,
+                             p_urb->DMA_BufPtr,
+                             p_urb->XferLen);
 
 #if (CPU_CFG_CACHE_MGMT_EN == DEF_ENABLED)                      /* See Note #1.                                         */
-                remainder = (CPU_INT08U)(((CPU_INT32U)p_urb->UserBufPtr) % CPU_Cache_Linesize);
-                if (remainder != 0u) {
-                    p_cache_aligned_buf_addr = ((CPU_INT08U *)p_urb->UserBufPtr) - remainder;
-                    len                      =   p_urb->XferLen + remainder;
-                } else {
-                    p_cache_aligned_buf_addr = (CPU_INT08U *)p_urb->UserBufPtr;
-                    len                      =  p_urb->XferLen;
-                }
+                    remainder = (CPU_INT08U)(((CPU_INT32U)p_urb->UserBufPtr) % CPU_Cache_Linesize);
+                    if (remainder != 0u) {
+                        p_cache_aligned_buf_addr = ((CPU_INT08U *)p_urb->UserBufPtr) - remainder;
+                        len                      =   p_urb->XferLen + remainder;
+                    } else {
+                        p_cache_aligned_buf_addr = (CPU_INT08U *)p_urb->UserBufPtr;
+                        len                      =  p_urb->XferLen;
+                    }
 #endif
-                CPU_DCACHE_RANGE_FLUSH(p_cache_aligned_buf_addr, len);
+                    CPU_DCACHE_RANGE_FLUSH(p_cache_aligned_buf_addr, len);
+                }
             }
 
             Mem_PoolBlkFree(&p_ehci->BufPool,
@@ -1714,7 +1851,11 @@ static  void  EHCI_URB_Complete (USBH_HC_DRV  *p_hc_drv,
         if ((p_urb->Token   == USBH_TOKEN_IN) &&
             (p_urb->XferLen != 0u           )) {
 
-            CPU_DCACHE_RANGE_INV(p_urb->DMA_BufPtr, p_urb->XferLen);
+            if (USBH_URB_IS_SG(p_urb)) {
+                EHCI_SG_DCacheSync(p_urb, p_urb->XferLen, DEF_TRUE);
+            } else {
+                CPU_DCACHE_RANGE_INV(p_urb->DMA_BufPtr, p_urb->XferLen);
+            }
         }
     }
 
@@ -1738,7 +1879,7 @@ static  void  EHCI_URB_Complete (USBH_HC_DRV  *p_hc_drv,
 *
 * Return(s)   : None
 *
-* Note(s)     : None.
+* Note(s)     : (1) The qTD list of the aborted URB is removed from the QH chain. See 'EHCI_QTDSegUnlink()'.
 *********************************************************************************************************
 */
 
@@ -1748,16 +1889,29 @@ static  void  EHCI_URB_Abort (USBH_HC_DRV  *p_hc_drv,
 {
     EHCI_DEV     *p_ehci;
     USBH_HC_CFG  *p_hc_cfg;
+    CPU_INT08U    ep_type;
     LIB_ERR       err_lib;
 
 
     p_ehci     = (EHCI_DEV *)p_hc_drv->DataPtr;
     p_hc_cfg   = p_hc_drv->HC_CfgPtr;
+    ep_type    = USBH_EP_TypeGet(p_urb->EP_Ptr);
     p_urb->Err = USBH_ERR_URB_ABORT;
 
-    if (p_hc_cfg->DedicatedMemAddr != (CPU_ADDR)0) {
+    if ((ep_type       != USBH_EP_TYPE_ISOC) &&
+        (p_urb->ArgPtr != (void *)0        )) {                 /* See Note #1.                                         */
+        EHCI_QTDSegUnlink(        p_hc_drv,
+                          (EHCI_QH  *)p_urb->EP_Ptr->ArgPtr,
+                          (EHCI_QTD *)p_urb->ArgPtr);
+        p_urb->ArgPtr = (void *)0;
+    }
+
+    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0 ) &&      /* Free DMA buf only if it was taken from the pool.     */
+        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED) &&
+        (p_urb->DMA_Direct             == DEF_FALSE   )) {
 
-        if (p_urb->DMA_BufPtr != (void *)0) {
+        if ((p_urb->DMA_BufPtr != (void *)0        ) &&
+            (p_urb->DMA_BufPtr != p_urb->UserBufPtr)) {
 
             Mem_PoolBlkFree(&p_ehci->BufPool,
                              p_urb->DMA_BufPtr,
@@ -2003,6 +2157,9 @@ static  USBH_ERR  EHCI_IntrEP_Open (USBH_HC_DRV  *p_hc_drv,
     USBH_DEV        *ptemp_dev;
     EHCI_INTR_INFO  *p_intr_info;
     EHCI_INTR_INFO  *p_temp_intr_info;
+    CPU_INT08U       s_mask;
+    CPU_INT08U       c_mask;
+    CPU_BOOLEAN      mask_ok;
     CPU_SR_ALLOC();
 
 
@@ -2110,6 +2267,17 @@ static  USBH_ERR  EHCI_IntrEP_Open (USBH_HC_DRV  *p_hc_drv,
                                p_ep,
                        (void *)p_new_qh);
 
+    if ((err          == USBH_ERR_NONE     ) &&
+        (p_ep->DevSpd != USBH_DEV_SPD_HIGH)) {                  /* C-mask of split xact follows its S-mask.             */
+        mask_ok = EHCI_TT_MaskGet( p_ep,
+                                  (CPU_INT08U)CPU_CntTrailZeros(p_new_qh->SMask),
+                                  &s_mask,
+                                  &c_mask);
+        if (mask_ok == DEF_NO) {                                /* See EHCI_TT_MaskGet() Note #3.                       */
+            err = USBH_ERR_BW_NOT_AVAIL;
+        }
+    }
+
     if (err != USBH_ERR_NONE) {
         Mem_PoolBlkFree(       &p_ehci->HC_QHPool,
                         (void *)p_new_qh,
@@ -2121,8 +2289,11 @@ static  USBH_ERR  EHCI_IntrEP_Open (USBH_HC_DRV  *p_hc_drv,
         return (err);
     }
 
-    p_new_qh->QHEpCapChar[1] |= p_new_qh->SMask |
-                                DWORD3_QH_PS_CSPLIT_UFRAME_2345 << 8;
+    p_new_qh->QHEpCapChar[1] |= QH_EPCAP_SMASK(p_new_qh->SMask);
+
+    if (p_ep->DevSpd != USBH_DEV_SPD_HIGH) {
+        p_new_qh->QHEpCapChar[1] |= QH_EPCAP_CMASK(c_mask);
+    }
 
     CPU_DCACHE_RANGE_FLUSH(p_new_qh, sizeof(EHCI_QH));
 
@@ -2771,6 +2942,163 @@ static  EHCI_QTD  *EHCI_QTDListPrepare (USBH_HC_DRV  *p_hc_drv,
 }
 
 
+/*
+*********************************************************************************************************
+*                                       EHCI_QTDListSG_Prepare()
+*
+* Description : Prepare a QTD list from the scatter-gather segment table of an URB.
+*
+* Argument(s) : p_hc_drv     Pointer to host controller driver structure.
+*
+*               p_ep         Pointer to endpoint structure
+*
+*               p_urb        Pointer to URB structure.
+*
+*               p_err        Pointer to variable that will receive the return error code from this function
+*                                USBH_ERR_NONE          QTD list prepared successfully.
+*                                Specific error code    otherwise.
+*
+* Return(s)   : Pointer to the head of the QTD list.
+*
+* Note(s)     : (1) A qTD list is built for each segment with 'EHCI_QTDListPrepare()' and the lists are
+*                   linked together. Only the last qTD of the last segment keeps its IOC and terminate
+*                   bits, so the whole table is seen as a single URB by 'EHCI_QHDone()'.
+*
+*               (2) The core ensures every segment but the last one is a multiple of the maximum packet
+*                   size, so the end of an intermediate qTD list never produces a short packet.
+*
+*               (3) Empty segments are skipped. If all segments are empty, a single zero-length qTD is
+*                   built.
+*********************************************************************************************************
+*/
+
+static  EHCI_QTD  *EHCI_QTDListSG_Prepare (USBH_HC_DRV  *p_hc_drv,
+                                           USBH_EP      *p_ep,
+                                           USBH_URB     *p_urb,
+                                           USBH_ERR     *p_err)
+{
+    EHCI_DEV     *p_ehci;
+    EHCI_QTD     *p_head_qtd;
+    EHCI_QTD     *p_tail_qtd;
+    EHCI_QTD     *p_seg_qtd;
+    EHCI_QTD     *p_free_qtd;
+    USBH_SG_SEG  *p_seg;
+    CPU_INT08U    seg_ix;
+    LIB_ERR       err_lib;
+
+
+    p_ehci     = (EHCI_DEV *)p_hc_drv->DataPtr;
+    p_head_qtd = (EHCI_QTD *)0;
+    p_tail_qtd = (EHCI_QTD *)0;
+
+    for (seg_ix = 0u; seg_ix < p_urb->SG_SegNbr; seg_ix++) {
+        p_seg = &p_urb->SG_SegTblPtr[seg_ix];
+
+        if ((p_seg->BufLen == 0u) &&                            /* See Note #3.                                         */
+            ((p_head_qtd != (EHCI_QTD *)0) || ((seg_ix + 1u) < p_urb->SG_SegNbr))) {
+            continue;
+        }
+
+        p_seg_qtd = EHCI_QTDListPrepare(p_hc_drv,
+                                        p_ep,
+                                        p_urb,
+                                        (p_seg->BufLen != 0u) ? (CPU_INT08U *)p_seg->BufPtr : (CPU_INT08U *)0,
+                                        p_seg->BufLen,
+                                        p_err);
+        if (p_seg_qtd == (EHCI_QTD *)0) {
+            while (p_head_qtd != (EHCI_QTD *)0) {               /* Free the qTD lists already built.                    */
+                p_free_qtd = p_head_qtd;
+                if ((p_head_qtd->QTDNxtPtr & QTD_N_QTD_PTR_T(1u)) != 0u) {
+                    p_head_qtd = (EHCI_QTD *)0;
+                } else {
+                    p_head_qtd = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_head_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+                }
+                Mem_PoolBlkFree(&p_ehci->HC_QTDPool,
+                                 p_free_qtd,
+                                &err_lib);
+            }
+            return ((EHCI_QTD *)0);
+        }
+
+        if (p_tail_qtd == (EHCI_QTD *)0) {
+            p_head_qtd = p_seg_qtd;
+        } else {                                                /* Link seg list to prev one (see Note #1).             */
+            p_tail_qtd->QTDToken     &= ~QTD_TOKEN_IOC(1u);
+            p_tail_qtd->QTDNxtPtr     = (CPU_INT32U)USBH_OS_VirToBus(p_seg_qtd);
+            p_tail_qtd->QTDAltNxtPtr  = QTD_ALT_QTD_PTR_T(1u);
+            CPU_DCACHE_RANGE_FLUSH(p_tail_qtd, sizeof(EHCI_QTD));
+        }
+
+        p_tail_qtd = p_seg_qtd;                                 /* Find last qTD of seg list.                           */
+        while ((p_tail_qtd->QTDNxtPtr & QTD_N_QTD_PTR_T(1u)) == 0u) {
+            p_tail_qtd = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_tail_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+        }
+    }
+
+    if (p_head_qtd == (EHCI_QTD *)0) {
+       *p_err = USBH_ERR_NULL_PTR;
+        return ((EHCI_QTD *)0);
+    }
+
+   *p_err = USBH_ERR_NONE;
+
+    return (p_head_qtd);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        EHCI_SG_DCacheSync()
+*
+* Description : Flush and optionally invalidate the data cache over the segments of a scatter-gather URB.
+*
+* Argument(s) : p_urb        Pointer to URB structure.
+*
+*               len          Number of octets to synchronize, from the start of the first segment.
+*
+*               inv          DEF_TRUE to also invalidate the cache lines.
+*
+* Return(s)   : None
+*
+* Note(s)     : (1) See Note #1 in function 'EHCI_URB_Submit()'.
+*********************************************************************************************************
+*/
+
+static  void  EHCI_SG_DCacheSync (USBH_URB     *p_urb,
+                                  CPU_INT32U    len,
+                                  CPU_BOOLEAN   inv)
+{
+#if (CPU_CFG_CACHE_MGMT_EN == DEF_ENABLED)
+    CPU_INT08U  *p_cache_aligned_buf_addr;
+    CPU_INT32U   seg_len;
+    CPU_INT08U   remainder;
+    CPU_INT08U   seg_ix;
+
+
+    for (seg_ix = 0u; (seg_ix < p_urb->SG_SegNbr) && (len > 0u); seg_ix++) {
+        seg_len = DEF_MIN(p_urb->SG_SegTblPtr[seg_ix].BufLen, len);
+        len    -= seg_len;
+        if (seg_len == 0u) {
+            continue;
+        }
+                                                                /* See Note #1.                                         */
+        remainder                = (CPU_INT08U)(((CPU_INT32U)p_urb->SG_SegTblPtr[seg_ix].BufPtr) % CPU_Cache_Linesize);
+        p_cache_aligned_buf_addr = ((CPU_INT08U *)p_urb->SG_SegTblPtr[seg_ix].BufPtr) - remainder;
+        seg_len                 += remainder;
+
+        CPU_DCACHE_RANGE_FLUSH(p_cache_aligned_buf_addr, seg_len);
+        if (inv == DEF_TRUE) {
+            CPU_DCACHE_RANGE_INV(p_cache_aligned_buf_addr, seg_len);
+        }
+    }
+#else
+    (void)p_urb;
+    (void)len;
+    (void)inv;
+#endif
+}
+
+
 /*
 *********************************************************************************************************
 *                                        EHCI_SITDListPrepare()
@@ -3870,6 +4198,7 @@ static  void  EHCI_QH_Clr (EHCI_QH  *p_qh)
     p_qh->QHBufPagePtrList[3] = (CPU_INT32U)0;
     p_qh->QHBufPagePtrList[4] = (CPU_INT32U)0;
     p_qh->QTDHead             = (CPU_INT32U)0;
+    p_qh->QTDTail             = (CPU_INT32U)0;
 }
 
 
@@ -4026,6 +4355,7 @@ static  CPU_INT32U  EHCI_QTDRemove (USBH_HC_DRV  *p_hc_drv,
 
     p_ehci        = (EHCI_DEV *)p_hc_drv->DataPtr;
     p_qh->QTDHead = 0u;
+    p_qh->QTDTail = 0u;
     terminate     = 0u;
     rem_len       = 0u;
 
@@ -4050,6 +4380,175 @@ static  CPU_INT32U  EHCI_QTDRemove (USBH_HC_DRV  *p_hc_drv,
 }
 
 
+/*
+*********************************************************************************************************
+*                                         EHCI_QTDSegRemove()
+*
+* Description : Free the QTDs of the first URB in the QTD chain of a QH and calculate the bytes that were
+*               not transfered by these QTDs.
+*
+* Argument(s) : p_hc_drv      Pointer to host controller driver structure.
+*
+*               p_qh          Pointer to EHCI_QH structure.
+*
+* Return(s)   : Number of bytes not transferred.
+*
+* Note(s)     : (1) The QTD list of an URB ends with the QTD that has its IOC bit set. See Note #2 of
+*                   'EHCI_URB_Submit()'.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  EHCI_QTDSegRemove (USBH_HC_DRV  *p_hc_drv,
+                                       EHCI_QH      *p_qh)
+{
+    EHCI_QTD     *p_qtd;
+    EHCI_QTD     *p_qtd_next;
+    EHCI_DEV     *p_ehci;
+    CPU_INT32U    rem_len;
+    CPU_BOOLEAN   last;
+    LIB_ERR       err_lib;
+
+
+    p_qtd = (EHCI_QTD *)p_qh->QTDHead;
+    if (p_qtd == (EHCI_QTD *)0) {
+        return (0u);
+    }
+
+    p_ehci  = (EHCI_DEV *)p_hc_drv->DataPtr;
+    rem_len = 0u;
+    last    = DEF_NO;
+
+    while (last == DEF_NO) {
+        CPU_DCACHE_RANGE_INV(p_qtd, sizeof(EHCI_QTD));
+        rem_len += ((p_qtd->QTDToken >> 16u) & 0x7FFFu);        /* Bits 16-30 represent, bytes that are not transferred */
+                                                                /* Last QTD of this URB (see Note #1).                  */
+        if ((p_qtd->QTDToken & QTD_TOKEN_IOC(1u)) != 0u) {
+            last = DEF_YES;
+        }
+
+        if ((CPU_INT32U)p_qtd == p_qh->QTDTail) {               /* Last QTD of the chain.                               */
+            p_qtd_next = (EHCI_QTD *)0;
+            last       =  DEF_YES;
+        } else {
+            p_qtd_next = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+        }
+                                                                /* Free the QTD                                         */
+        Mem_PoolBlkFree(&p_ehci->HC_QTDPool, (void *)p_qtd, (LIB_ERR *)&err_lib);
+
+        p_qtd = p_qtd_next;
+    }
+
+    p_qh->QTDHead = (CPU_INT32U)p_qtd;
+    if (p_qtd == (EHCI_QTD *)0) {
+        p_qh->QTDTail = 0u;
+    }
+
+    return (rem_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         EHCI_QTDSegUnlink()
+*
+* Description : Remove the QTD list of an aborted URB from the QTD chain of a QH.
+*
+* Argument(s) : p_hc_drv      Pointer to host controller driver structure.
+*
+*               p_qh          Pointer to EHCI_QH structure.
+*
+*               p_seg_head    Pointer to first QTD of the URB's QTD list.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The QTD list at the head of the chain may be in use by the host controller. It is left
+*                   in place and freed by 'EHCI_QHDone()' once retired; since the URB no longer references
+*                   it, no completion is reported for it.
+*
+*               (2) If the host controller already loaded the previous QTD in the QH overlay, the overlay's
+*                   Next qTD Pointer still references the removed list and must be updated as well.
+*********************************************************************************************************
+*/
+
+static  void  EHCI_QTDSegUnlink (USBH_HC_DRV  *p_hc_drv,
+                                 EHCI_QH      *p_qh,
+                                 EHCI_QTD     *p_seg_head)
+{
+    EHCI_QTD    *p_prev_qtd;
+    EHCI_QTD    *p_qtd;
+    EHCI_QTD    *p_qtd_next;
+    EHCI_DEV    *p_ehci;
+    CPU_INT32U   seg_head_addr;
+    CPU_INT32U   nxt_ptr;
+    LIB_ERR      err_lib;
+    CPU_SR_ALLOC();
+
+
+    if (p_qh == (EHCI_QH *)0) {
+        return;
+    }
+
+    p_ehci        = (EHCI_DEV *)p_hc_drv->DataPtr;
+    seg_head_addr = (CPU_INT32U)USBH_OS_VirToBus((void *)p_seg_head);
+
+    CPU_CRITICAL_ENTER();
+    CPU_DCACHE_RANGE_INV(p_qh, sizeof(EHCI_QH));
+    if ((p_qh->QTDHead == 0u) ||
+        (p_qh->QTDHead == (CPU_INT32U)p_seg_head)) {            /* See Note #1.                                         */
+        CPU_CRITICAL_EXIT();
+        return;
+    }
+                                                                /* Find QTD preceding the list to remove.               */
+    p_prev_qtd = (EHCI_QTD *)p_qh->QTDHead;
+    CPU_DCACHE_RANGE_INV(p_prev_qtd, sizeof(EHCI_QTD));
+    while ((p_prev_qtd->QTDNxtPtr & 0xFFFFFFE0u) != seg_head_addr) {
+        if ((CPU_INT32U)p_prev_qtd == p_qh->QTDTail) {          /* List not found in chain.                             */
+            CPU_CRITICAL_EXIT();
+            return;
+        }
+        p_prev_qtd = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_prev_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+        CPU_DCACHE_RANGE_INV(p_prev_qtd, sizeof(EHCI_QTD));
+    }
+                                                                /* Find last QTD of the list to remove.                 */
+    p_qtd = p_seg_head;
+    CPU_DCACHE_RANGE_INV(p_qtd, sizeof(EHCI_QTD));
+    while (((p_qtd->QTDToken & QTD_TOKEN_IOC(1u)) == 0u) &&
+           ((CPU_INT32U)p_qtd != p_qh->QTDTail)) {
+        p_qtd = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+        CPU_DCACHE_RANGE_INV(p_qtd, sizeof(EHCI_QTD));
+    }
+
+    if ((CPU_INT32U)p_qtd == p_qh->QTDTail) {                   /* Removed list is the last one of the chain.           */
+        nxt_ptr       = QTD_N_QTD_PTR_T(1u);
+        p_qh->QTDTail = (CPU_INT32U)p_prev_qtd;
+    } else {
+        nxt_ptr       = p_qtd->QTDNxtPtr;
+    }
+
+    p_prev_qtd->QTDNxtPtr = nxt_ptr;                            /* Unlink list from the chain.                          */
+    CPU_DCACHE_RANGE_FLUSH(p_prev_qtd, sizeof(EHCI_QTD));
+
+    if ((p_qh->QHNxtQTDPtr & 0xFFFFFFE0u) == seg_head_addr) {   /* See Note #2.                                         */
+        p_qh->QHNxtQTDPtr = nxt_ptr;
+    }
+    CPU_DCACHE_RANGE_FLUSH(p_qh, sizeof(EHCI_QH));
+    CPU_CRITICAL_EXIT();
+
+    p_qtd = p_seg_head;                                         /* Free the QTDs of the removed list.                   */
+    while (p_qtd != (EHCI_QTD *)0) {
+        if ((p_qtd->QTDToken & QTD_TOKEN_IOC(1u)) != 0u) {
+            p_qtd_next = (EHCI_QTD *)0;
+        } else {
+            p_qtd_next = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+        }
+
+        Mem_PoolBlkFree(&p_ehci->HC_QTDPool, (void *)p_qtd, (LIB_ERR *)&err_lib);
+
+        p_qtd = p_qtd_next;
+    }
+}
+
+
 /*
 *********************************************************************************************************
 *                                       EHCI_PeriodicListInit()
@@ -4290,7 +4789,14 @@ static  USBH_ERR  EHCI_AsyncListInit (USBH_HC_DRV  *p_hc_drv)
 *
 * Return(s)   : None.
 *
-* Note(s)     : None
+* Note(s)     : (1) The QTD lists chained on the QH are processed in submission order. A list is completed
+*                   when its last QTD is retired, or when one of its QTDs is halted.
+*
+*               (2) When a QTD is halted, the QH stops processing the chain. The URBs queued after the
+*                   halted one are completed with an abort error.
+*
+*               (3) If the host controller retired the previous list before the next one was appended,
+*                   the overlay's Next qTD Pointer has its T-bit set and the QH must be restarted.
 *********************************************************************************************************
 */
 
@@ -4299,60 +4805,99 @@ static  void  EHCI_QHDone (USBH_HC_DRV  *p_hc_drv,
 {
     CPU_INT32U     err_sts;
     CPU_INT32U     bytes_to_xfer;
-    CPU_INT32U     qtd_head_addr;
-    CPU_INT32U     qtd_head_addr_tmp;
+    EHCI_QTD      *p_seg_head;
+    EHCI_QTD      *p_qtd;
+    CPU_BOOLEAN    seg_done;
+    CPU_BOOLEAN    halted;
     USBH_URB      *p_urb;
     USBH_EP       *p_ep;
 
 
     CPU_DCACHE_RANGE_INV(p_qh, sizeof(EHCI_QH));
-    p_ep    = p_qh->EPPtr;
-    err_sts = (p_qh->QHToken) & 0x000000FFu;
-                                                                /* Search the URB associated with this transfer */
-    qtd_head_addr = (CPU_INT32U)p_qh->QTDHead;
-    p_urb         = &p_ep->URB;
+    p_ep   = p_qh->EPPtr;
+    halted = DEF_NO;
 
-    if (p_urb->AsyncURB_NxtPtr != 0) {                          /* Extra URB has been allocated for this EP             */
+    while (p_qh->QTDHead != 0u) {                               /* See Note #1.                                         */
+        p_seg_head = (EHCI_QTD *)p_qh->QTDHead;
+        err_sts    = 0u;
 
-        while (p_urb->AsyncURB_NxtPtr != 0) {
+        if (halted == DEF_NO) {
+            p_qtd    = p_seg_head;
+            seg_done = DEF_NO;
 
-            qtd_head_addr_tmp = (CPU_INT32U)p_urb->ArgPtr;
-            if(qtd_head_addr_tmp == qtd_head_addr) {            /* URB associated with this transfer found              */
-                break;
-            }
+            while (DEF_TRUE) {                                  /* Retrieve status of this URB's QTD list.              */
+                CPU_DCACHE_RANGE_INV(p_qtd, sizeof(EHCI_QTD));
+                err_sts = p_qtd->QTDToken & 0x000000FFu;
 
-            p_urb = p_urb->AsyncURB_NxtPtr;                     /* Get the next extra URB in the queue                  */
-        }
-    }
+                if ((err_sts & O_QH_STS_HALTED) != 0u) {
+                    halted   = DEF_YES;
+                    seg_done = DEF_YES;
+                    break;
+                }
 
+                if ((err_sts & O_QH_STS_ACTIVE) != 0u) {
+                    break;
+                }
 
-    if ((err_sts & O_QH_STS_HALTED) != 0u) {                    /* If QTD status is halted, retrieve error.             */
-                                                                /* EP corresponding to this QH                          */
-        if ((err_sts & O_QH_STS_DBE) != 0u) {                   /* Data Buffer Error                                    */
-            p_urb->Err = USBH_ERR_HC_IO;
-        } else if (((err_sts & O_QH_STS_BD)       != 0u) ||
-                   ((err_sts & O_QH_STS_XACT_ERR) != 0u) ||
-                   ((err_sts & O_QH_STS_MMF)      != 0u) ||
-                   ((err_sts & O_QH_STS_PE)       != 0u)) {    /* Babble Detected                                      */
-            p_urb->Err = USBH_ERR_HC_IO;
-        } else {                                                /* If not the above errors, then it is stall            */
-            p_urb->Err = USBH_ERR_EP_STALL;
-        }
+                if (((p_qtd->QTDToken & QTD_TOKEN_IOC(1u)) != 0u) ||
+                     ((CPU_INT32U)p_qtd == p_qh->QTDTail)) {
+                    seg_done = DEF_YES;
+                    break;
+                }
+
+                p_qtd = (EHCI_QTD *)USBH_OS_BusToVir((void *)(p_qtd->QTDNxtPtr & 0xFFFFFFE0u));
+            }
+
+            if (seg_done == DEF_NO) {                           /* Transfer still in progress.                          */
+                break;
+            }
+        }
+
+        bytes_to_xfer = EHCI_QTDSegRemove(p_hc_drv, p_qh);      /* Remove and free the QTDs of this URB                 */
+                                                                /* Search the URB associated with this transfer         */
+        p_urb = &p_ep->URB;
+        while ((p_urb != (USBH_URB *)0) &&
+               ((p_urb->State  != USBH_URB_STATE_SCHEDULED) ||
+                (p_urb->ArgPtr != (void *)p_seg_head      ))) {
+            p_urb = p_urb->AsyncURB_NxtPtr;
+        }
+
+        if (p_urb == (USBH_URB *)0) {                           /* URB aborted, nothing to report.                      */
+            continue;
+        }
+
+        p_urb->ArgPtr  = (void *)0;
+        p_urb->XferLen = p_urb->DMA_BufLen - bytes_to_xfer;
+
+        if ((err_sts & O_QH_STS_HALTED) != 0u) {                /* If QTD status is halted, retrieve error.             */
+            if ((err_sts & O_QH_STS_DBE) != 0u) {               /* Data Buffer Error                                    */
+                p_urb->Err = USBH_ERR_HC_IO;
+            } else if (((err_sts & O_QH_STS_BD)       != 0u) ||
+                       ((err_sts & O_QH_STS_XACT_ERR) != 0u) ||
+                       ((err_sts & O_QH_STS_MMF)      != 0u) ||
+                       ((err_sts & O_QH_STS_PE)       != 0u)) { /* Babble Detected                                      */
+                p_urb->Err = USBH_ERR_HC_IO;
+            } else {                                            /* If not the above errors, then it is stall            */
+                p_urb->Err = USBH_ERR_EP_STALL;
+            }
+        } else if (halted == DEF_YES) {                         /* URB queued after a halted one (see Note #2).         */
+            p_urb->Err     = USBH_ERR_URB_ABORT;
+            p_urb->XferLen = 0u;
+        } else {                                                /* The transaction completed successfully               */
+            p_urb->Err     = USBH_ERR_NONE;
+        }
 
-        bytes_to_xfer     = EHCI_QTDRemove(p_hc_drv, p_qh);     /* Remove and free all QTDs from the QTD list           */
-        p_qh->QHCurQTDPtr = 0u;
-        p_urb->XferLen    = p_urb->DMA_BufLen - bytes_to_xfer;
         USBH_URB_Done(p_urb);
+    }
 
-    } else if ((err_sts & O_QH_STS_ACTIVE) == 0u){              /* The transaction completed successfully               */
-                                                                /* EP corresponding to this QH                          */
-        p_urb->Err        = USBH_ERR_NONE;
-        bytes_to_xfer     = EHCI_QTDRemove(p_hc_drv, p_qh);     /* Remove and free all QTDs from the QTD list           */
+    if (p_qh->QTDHead == 0u) {
         p_qh->QHCurQTDPtr = 0u;
-        p_urb->XferLen    = p_urb->DMA_BufLen - bytes_to_xfer;
-        USBH_URB_Done(p_urb);
+    } else if (((p_qh->QHToken     & O_QH_STS_ACTIVE)       == 0u) &&
+               ((p_qh->QHNxtQTDPtr & QTD_N_QTD_PTR_T(1u))   != 0u)) {
+                                                                /* Restart QH on next QTD list (see Note #3).           */
+        p_qh->QHNxtQTDPtr = (CPU_INT32U)USBH_OS_VirToBus((void *)p_qh->QTDHead);
     } else {
-                                                                /* Empty Else Statement                                 */        
+                                                                /* Empty Else Statement                                 */
     }
 
     CPU_DCACHE_RANGE_FLUSH(p_qh, sizeof(EHCI_QH));
@@ -4618,7 +5163,13 @@ static  CPU_INT32U  EHCI_ITDDone (USBH_HC_DRV        *p_hc_drv,
 * Return(s)   : USBH_ERR_NONE          If successful.
 *               Specific error code    otherwise.
 *
-* Note(s)     : None
+* Note(s)     : (1) Full & low speed endpoints are reached through the transaction translator (TT) of a high
+*                   speed hub & are scheduled by EHCI_BW_SplitGet().
+*
+*               (2) Interrupt endpoints are polled at the interval set by the core when the endpoint is
+*                   opened (see 'usbh_core.c  USBH_EP_IntervalGet()'), rounded down to a power of 2 frames or
+*                   micro frames, and up to 256 frames. The interval achieved is written back to the endpoint,
+*                   in both 'IntervalUs' and 'Interval'.
 *********************************************************************************************************
 */
 
@@ -4631,19 +5182,13 @@ static  USBH_ERR  EHCI_BW_Get (USBH_HC_DRV  *p_hc_drv,
     CPU_INT32U          max_of_min_avail;                       /* Maximum value of all minimum available BW            */
     CPU_INT08U          mask_nbr;
     CPU_INT16U          branch_nbr;
-    CPU_INT16U          frame_nbr;
-    CPU_INT08U          micro_frame_nbr;
     CPU_INT08U          nbr_mask = 0u;
     CPU_INT16U          nbr_branch;
-    CPU_INT16U          frames_per_branch;
     CPU_INT08U          s_mask = 0u;
-    CPU_INT08U          c_mask = 0u;
     CPU_INT32U          interval;
     CPU_INT32U          frame_interval;
-    CPU_BOOLEAN         enough_BW;
     CPU_INT16U          ep_max_pkt_size;
     CPU_INT08U          ep_type;
-    CPU_INT08U          ep_dir;
     EHCI_QH            *p_qh;
     EHCI_ISOC_EP_DESC  *p_ep_desc;
     EHCI_DEV           *p_ehci;
@@ -4653,15 +5198,17 @@ static  USBH_ERR  EHCI_BW_Get (USBH_HC_DRV  *p_hc_drv,
 
     ep_max_pkt_size = USBH_EP_MaxPktSizeGet(p_ep);
     ep_type         = USBH_EP_TypeGet(p_ep);
-    ep_dir          = USBH_EP_DirGet(p_ep);
     p_ehci          = (EHCI_DEV *)p_hc_drv->DataPtr;
 
-    if ((ep_type      == USBH_EP_TYPE_INTR  ) &&
-        (p_ep->DevSpd != USBH_DEV_SPD_HIGH)) {
-
-        interval = p_ep->Desc.bInterval;
+    if (ep_type == USBH_EP_TYPE_INTR) {                         /* See Note #2.                                         */
+        if (p_ep->DevSpd != USBH_DEV_SPD_HIGH) {
+            interval = p_ep->IntervalUs / 1000u;                /* Interval in frames.                                  */
+        } else {
+            interval = p_ep->IntervalUs / 125u;                 /* Interval in micro frames.                            */
+        }
+        interval = DEF_MAX(interval, 1u);
         j        = 0u;
-        for (i = 0u; i < 8u; i++) {
+        for (i = 0u; i < 16u; i++) {                            /* Round down to a power of 2.                          */
             if (((0x01u << i) & interval) != 0u) {
                 j = i;
             }
@@ -4714,49 +5261,45 @@ static  USBH_ERR  EHCI_BW_Get (USBH_HC_DRV  *p_hc_drv,
     if (ep_type == USBH_EP_TYPE_INTR) {
         p_qh                = (EHCI_QH *)p_data;                /* For intr EP p_data var points to EHCI_QH struct.     */
         p_qh->FrameInterval = frame_interval;
+                                                                /* Report interval achieved (see Note #2).              */
+        if ((p_ep->DevSpd == USBH_DEV_SPD_HIGH) &&
+            (interval      < 8u)) {
+            p_ep->IntervalUs = interval * 125u;
+        } else {
+            p_ep->IntervalUs = frame_interval * 1000u;
+        }
+                                                                /* Keep 'Interval' in sync, see USBH_EP_Open() Note #5. */
+        if (p_ep->DevSpd == USBH_DEV_SPD_HIGH) {
+            p_ep->Interval = (CPU_INT16U)(p_ep->IntervalUs / 125u);
+        } else if (p_ep->DevPtr->HubHS_Ptr != (USBH_HUB_DEV *)0) {
+            p_ep->Interval = (CPU_INT16U)(8u * (p_ep->IntervalUs / 1000u));
+        } else {
+            p_ep->Interval = (CPU_INT16U)(p_ep->IntervalUs / 1000u);
+        }
     } else {
         p_ep_desc                = (EHCI_ISOC_EP_DESC *)p_data; /* For isoc EP p_data pts to EHCI_ISOC_EP_DESC struct.  */
         p_ep_desc->FrameInterval = frame_interval;
     }
 
+    if (p_ep->DevSpd != USBH_DEV_SPD_HIGH) {                    /* See Note #1.                                         */
+        return (EHCI_BW_SplitGet(p_hc_drv, p_ep, p_data, frame_interval));
+    }
+
     max_of_min_avail  = 0u;
     nbr_branch        = frame_interval;
-    frames_per_branch = 256u / nbr_branch;
 
     if (ep_type == USBH_EP_TYPE_INTR) {
                                                                 /* For each possible S-Mask                             */
         for (mask_nbr = 0u; mask_nbr < nbr_mask; mask_nbr++) {
                                                                 /* Starting from a frame number                         */
             for (branch_nbr = 0u; branch_nbr < nbr_branch; branch_nbr++) {
-                enough_BW = 1u;
-                min_avail = EHCI_MAX_BW_PER_MICRO_FRAME;
-                                                                /* For each frame after the interval                    */
-                frame_nbr = branch_nbr;
-                for (i = 0u; i < frames_per_branch; i++) {
-                                                                /* For each micro frame                                 */
-                    for (micro_frame_nbr = 0u; micro_frame_nbr < 8u; micro_frame_nbr++) {
-
-                        if ((s_mask & (1u << micro_frame_nbr)) != 0u) { /* If corresponding bit is set in S-Mask                */
-                                                                /* Take BW in this frame number and micro frame number  */
-                            min_avail = DEF_MIN(min_avail, p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr]);
-
-                            if (min_avail < ep_max_pkt_size) {  /* If BW is not available                               */
-                                enough_BW = 0u;
-                                break;
-                            } else {
+                min_avail = EHCI_BW_MaskAvail(p_ehci,
+                                              branch_nbr,
+                                              frame_interval,
+                                              s_mask);
 
-                            }
-                        }
-                    }
-
-                    if (enough_BW == 0) {                       /* If BW is not available, go to next starting frame nbr*/
-                        break;
-                    }
-
-                    frame_nbr += frame_interval;
-                }
-
-                if ((min_avail > max_of_min_avail) && (enough_BW != 0)) {
+                if ((min_avail >  max_of_min_avail) &&
+                    (min_avail >= ep_max_pkt_size)) {
                     max_of_min_avail   = min_avail;             /* Take maximum of all minimum available                */
                     p_qh->BWStartFrame = branch_nbr;            /* Update starting frame number                         */
                     p_qh->SMask        = s_mask;                /* Update S-Mask                                        */
@@ -4770,138 +5313,210 @@ static  USBH_ERR  EHCI_BW_Get (USBH_HC_DRV  *p_hc_drv,
         if (max_of_min_avail < ep_max_pkt_size) {
             return (USBH_ERR_BW_NOT_AVAIL);
         }
+    }
 
-    } else if ((ep_type      == USBH_EP_TYPE_ISOC  ) &&
-               (p_ep->DevSpd == USBH_DEV_SPD_FULL)) {
+    return (USBH_ERR_NONE);
+}
+#endif
 
-        p_ep_desc->TCnt = (ep_max_pkt_size / 188) + 1;
 
-        if (ep_dir == USBH_EP_DIR_IN) {
-            s_mask = S_MASK_SPLIT_0_MICROFRM;
+/*
+*********************************************************************************************************
+*                                         EHCI_BW_SplitGet()
+*
+* Description : Get bandwidth allocation of a full or low speed endpoint scheduled with split transactions.
+*
+* Argument(s) : p_hc_drv         Pointer to host controller driver structure.
+*
+*               p_ep             Pointer to endpoint structure.
+*
+*               p_data           Pointer to EHCI_QH structure (interrupt EP) or isochronous endpoint structure.
+*
+*               frame_interval   Polling interval of the endpoint, in frames.
+*
+* Return(s)   : USBH_ERR_NONE,          if a placement was found.
+*               USBH_ERR_BW_NOT_AVAIL,  if the placement would overrun the TT or the high speed micro frames.
+*
+* Note(s)     : (1) Each placement is defined by a branch (first frame) & the micro frame of the start-split.
+*                   The full speed data of the transaction is budgeted in the following micro frames of the
+*                   TT (see section 11.18.4, USB 2.0 spec) & the complete-splits, if any, are scheduled
+*                   in the micro frames after it. The high speed bandwidth of every start-split & complete-
+*                   split micro frame must be available too.
+*
+*               (2) Among the valid placements, the one leaving the most bandwidth on the TT is selected, so
+*                   that endpoints sharing a TT are spread across its micro frames.
+*
+*               (3) A TT entry is only taken by EHCI_BW_Update() once the endpoint is scheduled. If the
+*                   TT is not tracked yet, the placement is checked against an idle TT.
+*
+*               (4) The complete-splits of later start-splits would run past the end of the frame (see
+*                   EHCI_TT_MaskGet() Note #3), so the search of the branch stops at the first of them.
+*********************************************************************************************************
+*/
 
-        } else if (ep_dir == USBH_EP_DIR_OUT) {
-            c_mask = 0u;
-        } else {
-                                                                /* Empty Else Statement                                 */            
-        }
+#if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+static  USBH_ERR  EHCI_BW_SplitGet (USBH_HC_DRV  *p_hc_drv,
+                                    USBH_EP      *p_ep,
+                                    void         *p_data,
+                                    CPU_INT16U    frame_interval)
+{
+    EHCI_DEV           *p_ehci;
+    EHCI_TT            *p_tt;
+    EHCI_QH            *p_qh;
+    EHCI_ISOC_EP_DESC  *p_ep_desc;
+    CPU_INT16U          ep_max_pkt_size;
+    CPU_INT08U          ep_type;
+    CPU_INT16U          fs_len;
+    CPU_INT08U          nbr_slot;
+    CPU_INT16U          nbr_branch;
+    CPU_INT16U          branch_nbr;
+    CPU_INT08U          micro_frame_nbr;
+    CPU_INT08U          s_mask;
+    CPU_INT08U          c_mask;
+    CPU_BOOLEAN         mask_ok;
+    CPU_INT16U          hs_avail;
+    CPU_INT16U          tt_avail;
+    CPU_BOOLEAN         tt_fit;
+    CPU_BOOLEAN         found;
+    CPU_INT16U          best_avail;
+    CPU_INT16U          best_branch;
+    CPU_INT08U          best_s_mask;
+    CPU_INT08U          best_c_mask;
 
-        switch (p_ep_desc->TCnt) {
 
-            case 1:
-                if (ep_dir == USBH_EP_DIR_OUT) {
-                    s_mask = S_MASK_SPLIT_0_MICROFRM;
-                } else if (ep_dir == USBH_EP_DIR_IN) {
-                    c_mask = C_MASK_SPLIT_0_MICROFRM;
-                } else {
-                                                                /* Empty Else Statement                                 */                    
-                }
-                break;
+    p_ehci          = (EHCI_DEV *)p_hc_drv->DataPtr;
+    ep_max_pkt_size =  USBH_EP_MaxPktSizeGet(p_ep);
+    ep_type         =  USBH_EP_TypeGet(p_ep);
+    fs_len          =  EHCI_TT_LenGet(p_ep);
+    nbr_slot        = (CPU_INT08U)((fs_len + EHCI_TT_BW_PER_MICRO_FRAME - 1u) / EHCI_TT_BW_PER_MICRO_FRAME);
 
-            case 2:
-                 if (ep_dir == USBH_EP_DIR_OUT) {
-                     s_mask = S_MASK_SPLIT_01_MICROFRM;
-                 } else if (ep_dir == USBH_EP_DIR_IN) {
-                     c_mask = C_MASK_SPLIT_01_MICROFRM;
-                 } else {
-                                                                /* Empty Else Statement                                 */
-                 }
-                 break;
+    if (nbr_slot > (EHCI_TT_MICRO_FRAME_LAST - EHCI_TT_MICRO_FRAME_FIRST + 1u)) {
+        return (USBH_ERR_BW_NOT_AVAIL);                         /* Xact does not fit in a TT frame.                     */
+    }
 
-            case 3:
-                 if (ep_dir == USBH_EP_DIR_OUT) {
-                     s_mask = S_MASK_SPLIT_012_MICROFRM;
-                 } else if (ep_dir == USBH_EP_DIR_IN) {
-                     c_mask = C_MASK_SPLIT_012_MICROFRM;
-                 } else {
-                                                                /* Empty Else Statement                                 */                     
-                 }
-                 break;
+    p_tt = EHCI_TT_Get(p_ehci, p_ep, DEF_NO);                   /* See Note #3.                                         */
+    if (p_tt == (EHCI_TT *)0) {
+        p_tt = EHCI_TT_Get(p_ehci, p_ep, DEF_YES);
+        if (p_tt == (EHCI_TT *)0) {
+            return (USBH_ERR_BW_NOT_AVAIL);                     /* No free entry to track the TT.                       */
+        }
+        p_tt->HubPtr = (void *)0;                               /* Entry is only claimed by EHCI_BW_Update().           */
+    }
 
-            case 4:
-                 if (ep_dir == USBH_EP_DIR_OUT) {
-                     s_mask = S_MASK_SPLIT_0123_MICROFRM;
-                 } else if (ep_dir == USBH_EP_DIR_IN) {
-                     c_mask = C_MASK_SPLIT_0123_MICROFRM;
-                 } else {
-                                                                /* Empty Else Statement                                 */                     
-                 }
-                 break;
+    if (ep_type == USBH_EP_TYPE_INTR) {
+        nbr_branch = frame_interval;
+    } else {
+        nbr_branch = 1u;                                        /* Isoc siTDs are budgeted from frame 0.                */
+    }
 
-            case 5:
-                 if (ep_dir == USBH_EP_DIR_OUT) {
-                     s_mask = S_MASK_SPLIT_01234_MICROFRM;
-                 } else if (ep_dir == USBH_EP_DIR_IN) {
-                     c_mask = C_MASK_SPLIT_01234_MICROFRM;
-                 } else {
-                                                                /* Empty Else Statement                                 */                     
-                 }
-                 break;
+    found       = DEF_NO;
+    best_avail  = 0u;
+    best_branch = 0u;
+    best_s_mask = 0u;
+    best_c_mask = 0u;
+                                                                /* See Note #1.                                         */
+    for (branch_nbr = 0u; branch_nbr < nbr_branch; branch_nbr++) {
+        for (micro_frame_nbr  = EHCI_TT_MICRO_FRAME_FIRST - 1u;
+             micro_frame_nbr +  nbr_slot <= EHCI_TT_MICRO_FRAME_LAST;
+             micro_frame_nbr++) {
+
+            mask_ok = EHCI_TT_MaskGet( p_ep,
+                                       micro_frame_nbr,
+                                      &s_mask,
+                                      &c_mask);
+            if (mask_ok == DEF_NO) {                            /* See Note #4.                                         */
+                break;
+            }
 
-            case 6:
-                 if (ep_dir == USBH_EP_DIR_OUT) {
-                     s_mask = S_MASK_SPLIT_012345_MICROFRM;
-                 } else if (ep_dir == USBH_EP_DIR_IN) {
-                     c_mask = C_MASK_SPLIT_012345_MICROFRM;
-                 } else {
-                                                                /* Empty Else Statement                                 */                     
-                 }
-                 break;
+            hs_avail = EHCI_BW_MaskAvail(p_ehci,
+                                         branch_nbr,
+                                         frame_interval,
+                                        (s_mask | c_mask));
+            if (hs_avail < ep_max_pkt_size) {
+                continue;
+            }
 
-            default:
-                 break;
+            tt_fit = EHCI_TT_BW_Avail( p_tt,
+                                       branch_nbr,
+                                       frame_interval,
+                                       micro_frame_nbr,
+                                       fs_len,
+                                      &tt_avail);
+                                                                /* See Note #2.                                         */
+            if ((tt_fit == DEF_YES) &&
+                ((found == DEF_NO) || (tt_avail > best_avail))) {
+                found       = DEF_YES;
+                best_avail  = tt_avail;
+                best_branch = branch_nbr;
+                best_s_mask = s_mask;
+                best_c_mask = c_mask;
+            }
         }
+    }
 
-        nbr_mask = 7 - p_ep_desc->TCnt;
-                                                                /* For each possible S-Mask                             */
-        for (mask_nbr = 0u; mask_nbr < nbr_mask; mask_nbr++) {
-            enough_BW = 1u;
-            min_avail = EHCI_MAX_BW_PER_MICRO_FRAME;
+    if (found == DEF_NO) {
+        return (USBH_ERR_BW_NOT_AVAIL);
+    }
 
-            for (frame_nbr = 0u; frame_nbr < 256u; frame_nbr++) {
+    if (ep_type == USBH_EP_TYPE_INTR) {
+        p_qh               = (EHCI_QH *)p_data;
+        p_qh->BWStartFrame = best_branch;
+        p_qh->SMask        = best_s_mask;
+        CPU_DCACHE_RANGE_FLUSH(p_qh, sizeof(EHCI_QH));
+    } else {
+        p_ep_desc        = (EHCI_ISOC_EP_DESC *)p_data;
+        p_ep_desc->TCnt  = (ep_max_pkt_size / EHCI_TT_BW_PER_MICRO_FRAME) + 1u;
+        p_ep_desc->SMask =  best_s_mask;
+        p_ep_desc->CMask =  best_c_mask;
+    }
 
-                for (micro_frame_nbr = 0u; micro_frame_nbr < 8u; micro_frame_nbr++) {
+    return (USBH_ERR_NONE);
+}
+#endif
 
-                    if ((s_mask & (1 << micro_frame_nbr)) != 0u) { /* If corresponding bit is set in S-Mask                */
-                        min_avail = DEF_MIN(min_avail, p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr]);
 
-                        if (min_avail < ep_max_pkt_size) {      /* If BW is not available                               */
-                            enough_BW = 0u;
-                            break;
-                        }
-                    }
+/*
+*********************************************************************************************************
+*                                         EHCI_BW_MaskAvail()
+*
+* Description : Get the high speed bandwidth available in a set of micro frames of a branch.
+*
+* Argument(s) : p_ehci           Pointer to EHCI device.
+*
+*               start_frame      First frame of the branch.
+*
+*               frame_interval   Interval between the frames of the branch.
+*
+*               mask             Micro frames to check (bit N for micro frame N).
+*
+* Return(s)   : Minimum bandwidth available, in bytes, across the selected micro frames of the branch.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
 
-                    if ((c_mask & (1u << micro_frame_nbr)) != 0u) { /* If corresponding bit is set in S-Mask                */
-                        min_avail = DEF_MIN(min_avail, p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr]);
+#if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+static  CPU_INT16U  EHCI_BW_MaskAvail (EHCI_DEV    *p_ehci,
+                                       CPU_INT16U   start_frame,
+                                       CPU_INT16U   frame_interval,
+                                       CPU_INT08U   mask)
+{
+    CPU_INT16U  frame_nbr;
+    CPU_INT08U  micro_frame_nbr;
+    CPU_INT16U  min_avail;
 
-                        if (min_avail < ep_max_pkt_size) {      /* If BW is not available                               */
-                            enough_BW = 0u;
-                            break;
-                        }
-                    }
-                }
 
-                if (enough_BW == 0u) {                          /* If BW is not available, go to next starting frame nbr*/
-                    break;
-                }
-            }
+    min_avail = EHCI_MAX_BW_PER_MICRO_FRAME;
 
-            if ((min_avail  > max_of_min_avail) &&
-                (enough_BW !=               0u)) {
-                max_of_min_avail   = min_avail;                 /* Take max of all min available                        */
-                p_ep_desc->SMask   = s_mask;                    /* Update S-Mask                                        */
-                p_ep_desc->CMask   = c_mask;
+    for (frame_nbr = start_frame; frame_nbr < 256u; frame_nbr += frame_interval) {
+        for (micro_frame_nbr = 0u; micro_frame_nbr < 8u; micro_frame_nbr++) {
+            if ((mask & (1u << micro_frame_nbr)) != 0u) {
+                min_avail = DEF_MIN(min_avail, p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr]);
             }
-
-            s_mask = s_mask << 1u;
-            c_mask = c_mask << 1u;
-        }
-
-        if (max_of_min_avail < ep_max_pkt_size) {
-            return (USBH_ERR_BW_NOT_AVAIL);
         }
     }
 
-    return (USBH_ERR_NONE);
+    return (min_avail);
 }
 #endif
 
@@ -4922,7 +5537,8 @@ static  USBH_ERR  EHCI_BW_Get (USBH_HC_DRV  *p_hc_drv,
 *
 * Return(s)   : None
 *
-* Note(s)     : None
+* Note(s)     : (1) The C-mask & the TT budget of a split interrupt endpoint are derived from its S-mask,
+*                   the same way EHCI_BW_SplitGet() selected them.
 *********************************************************************************************************
 */
 
@@ -4935,6 +5551,7 @@ static  void  EHCI_BW_Update(USBH_HC_DRV  *p_hc_drv,
     EHCI_QH            *p_qh;
     EHCI_ISOC_EP_DESC  *p_ep_desc;
     EHCI_DEV           *p_ehci;
+    EHCI_TT            *p_tt;
     CPU_INT16U          frame_nbr;
     CPU_INT08U          micro_frame_nbr;
     CPU_INT08U          start_frame_nbr;
@@ -4950,6 +5567,7 @@ static  void  EHCI_BW_Update(USBH_HC_DRV  *p_hc_drv,
     p_ehci          = (EHCI_DEV *)p_hc_drv->DataPtr;
     ep_max_pkt_size = USBH_EP_MaxPktSizeGet(p_ep);
     ep_type         = USBH_EP_TypeGet(p_ep);
+    c_mask          = 0u;
 
     if (ep_type == USBH_EP_TYPE_INTR) {
         p_qh            = (EHCI_QH *)p_data;
@@ -4958,6 +5576,13 @@ static  void  EHCI_BW_Update(USBH_HC_DRV  *p_hc_drv,
         s_mask          = p_qh->SMask;
         frame_interval  = p_qh->FrameInterval;
         start_frame_nbr = p_qh->BWStartFrame;
+
+        if (p_ep->DevSpd != USBH_DEV_SPD_HIGH) {                /* See Note #1.                                         */
+            (void)EHCI_TT_MaskGet( p_ep,                        /* Placement checked by EHCI_BW_SplitGet().             */
+                                  (CPU_INT08U)CPU_CntTrailZeros(s_mask),
+                                  &s_mask,
+                                  &c_mask);
+        }
     } else {
         p_ep_desc       = (EHCI_ISOC_EP_DESC *)p_data;
         s_mask          = p_ep_desc->SMask;
@@ -4972,29 +5597,362 @@ static  void  EHCI_BW_Update(USBH_HC_DRV  *p_hc_drv,
     for (i = 0u; i < frames_per_branch; i++) {
                                                                 /* For each micro frame                                 */
         for (micro_frame_nbr = 0u; micro_frame_nbr < 8u; micro_frame_nbr++) {
-            if ((s_mask & (1 << micro_frame_nbr)) != 0u) {      /* If corresponding bit is set in S-Mask                */
+            if (((s_mask | c_mask) & (1 << micro_frame_nbr)) != 0u) {
                 if (bw_use == DEF_TRUE) {                       /* If BW is used, decrement BW in periodic BW array     */
                     p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr] -= ep_max_pkt_size;
                 } else {                                        /* If BW is released, increment BW in periodic BW array */
                     p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr] += ep_max_pkt_size;
                 }
             }
+        }
 
-            if ((ep_type      == USBH_EP_TYPE_ISOC   ) &&
-                (p_ep->DevSpd == USBH_DEV_SPD_FULL)) {
-                if ((c_mask & (1 << micro_frame_nbr)) != 0u) {  /* If corresponding bit is set in S-Mask                */
-                    if (bw_use == DEF_TRUE) {
-                                                                /* If BW is used, decrement the BW in periodicBW array  */
-                        p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr] -= ep_max_pkt_size;
-                    } else {
-                                                                /* If BW is released, increment the BW in periodic BW array*/
-                        p_ehci->MaxPeriodicBWArr[frame_nbr][micro_frame_nbr] += ep_max_pkt_size;
-                    }
-                }
+        frame_nbr += frame_interval;
+    }
+
+    if (p_ep->DevSpd == USBH_DEV_SPD_HIGH) {
+        return;
+    }
+                                                                /* ---------------- UPDATE TT BUDGET ------------------ */
+    p_tt = EHCI_TT_Get(p_ehci, p_ep, bw_use);
+    if (p_tt == (EHCI_TT *)0) {
+        return;
+    }
+
+    EHCI_TT_BW_Update(                 p_tt,
+                                       start_frame_nbr,
+                                       frame_interval,
+                      (CPU_INT08U)CPU_CntTrailZeros(s_mask),
+                                       EHCI_TT_LenGet(p_ep),
+                                       bw_use);
+
+    if (bw_use == DEF_TRUE) {
+        p_tt->EP_Cnt++;
+    } else if (p_tt->EP_Cnt > 0u) {
+        p_tt->EP_Cnt--;
+        if (p_tt->EP_Cnt == 0u) {
+            p_tt->HubPtr = (void *)0;                           /* Last EP closed, free TT entry.                       */
+        }
+    } else {
+                                                                /* Empty Else Statement                                 */
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            EHCI_TT_Get()
+*
+* Description : Get the transaction translator entry used by a full or low speed endpoint.
+*
+* Argument(s) : p_ehci       Pointer to EHCI device.
+*
+*               p_ep         Pointer to endpoint structure.
+*
+*               alloc        DEF_YES, take & reset a free entry if the TT is not tracked yet.
+*                            DEF_NO,  only look up the TT.
+*
+* Return(s)   : Pointer to TT entry, if found or allocated.
+*               Null pointer,        otherwise.
+*
+* Note(s)     : (1) The TT is identified by the nearest upstream high speed hub. Devices attached to the
+*                   root hub go through the TT integrated in the host controller, if any. Multi-TT hubs are
+*                   left in their default single-TT setting by the hub class, so all the ports of a hub
+*                   share the same TT.
+*********************************************************************************************************
+*/
+
+#if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+static  EHCI_TT  *EHCI_TT_Get (EHCI_DEV     *p_ehci,
+                               USBH_EP      *p_ep,
+                               CPU_BOOLEAN   alloc)
+{
+    void        *p_hub;
+    EHCI_TT     *p_tt;
+    EHCI_TT     *p_tt_free;
+    CPU_INT08U   tt_ix;
+    CPU_INT16U   frame_nbr;
+    CPU_INT08U   micro_frame_nbr;
+
+
+    p_hub = (void *)p_ep->DevPtr->HubHS_Ptr;                    /* See Note #1.                                         */
+    if (p_hub == (void *)0) {
+        p_hub = (void *)p_ep->DevPtr->HC_Ptr->RH_ClassDevPtr;
+    }
+
+    p_tt_free = (EHCI_TT *)0;
+    for (tt_ix = 0u; tt_ix < EHCI_CFG_TT_NBR; tt_ix++) {
+        p_tt = &p_ehci->TT_Tbl[tt_ix];
+        if (p_tt->HubPtr == p_hub) {
+            return (p_tt);
+        }
+        if ((p_tt->HubPtr == (void    *)0) &&
+            (p_tt_free    == (EHCI_TT *)0)) {
+            p_tt_free = p_tt;
+        }
+    }
+
+    if ((alloc     == DEF_NO) ||
+        (p_tt_free == (EHCI_TT *)0)) {
+        return ((EHCI_TT *)0);
+    }
+
+    p_tt_free->HubPtr = p_hub;
+    p_tt_free->EP_Cnt = 0u;
+    for (frame_nbr = 0u; frame_nbr < 256u; frame_nbr++) {
+        for (micro_frame_nbr = 0u; micro_frame_nbr < 8u; micro_frame_nbr++) {
+            if ((micro_frame_nbr >= EHCI_TT_MICRO_FRAME_FIRST) &&
+                (micro_frame_nbr <= EHCI_TT_MICRO_FRAME_LAST)) {
+                p_tt_free->BW[frame_nbr][micro_frame_nbr] = EHCI_TT_BW_PER_MICRO_FRAME;
+            } else {
+                p_tt_free->BW[frame_nbr][micro_frame_nbr] = 0u;
             }
         }
+    }
 
-        frame_nbr += frame_interval;
+    return (p_tt_free);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          EHCI_TT_LenGet()
+*
+* Description : Get the full speed bus time taken by one transaction of an endpoint.
+*
+* Argument(s) : p_ep         Pointer to endpoint structure.
+*
+* Return(s)   : Transaction length, in full speed bytes.
+*
+* Note(s)     : (1) Low speed bytes take 8 times longer than full speed bytes on the bus.
+*********************************************************************************************************
+*/
+
+#if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+static  CPU_INT16U  EHCI_TT_LenGet (USBH_EP  *p_ep)
+{
+    CPU_INT16U  fs_len;
+
+
+    fs_len = USBH_EP_MaxPktSizeGet(p_ep);
+
+    if (USBH_EP_TypeGet(p_ep) == USBH_EP_TYPE_ISOC) {
+        fs_len += EHCI_TT_OVERHEAD_ISOC;
+    } else {
+        fs_len += EHCI_TT_OVERHEAD_INTR;
+    }
+
+    if (p_ep->DevSpd == USBH_DEV_SPD_LOW) {                     /* See Note #1.                                         */
+        fs_len *= 8u;
+    }
+
+    return (fs_len);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          EHCI_TT_MaskGet()
+*
+* Description : Get the S-mask & C-mask of a split transaction starting in given micro frame.
+*
+* Argument(s) : p_ep              Pointer to endpoint structure.
+*
+*               micro_frame_nbr   Micro frame of the (first) start-split.
+*
+*               p_s_mask          Pointer to variable that will receive the S-mask.
+*
+*               p_c_mask          Pointer to variable that will receive the C-mask.
+*
+* Return(s)   : DEF_YES, if the masks fit in the frame.
+*               DEF_NO,  otherwise (see Note #3).
+*
+* Note(s)     : (1) An isochronous OUT transaction has no complete-split. Its data is sent in up to 188 byte
+*                   pieces by consecutive start-splits (see section 11.18.4, USB 2.0 spec).
+*
+*               (2) Complete-splits are scheduled from the second micro frame following the start-split up
+*                   to two micro frames past the end of the budgeted full speed data.
+*
+*               (3) Splits past micro frame 7 would require a frame span traversal node (QH) or the siTD
+*                   back pointer, which are not used. Such a placement is rejected: a C-mask cut at the
+*                   end of the frame would miss the end of the transaction.
+*********************************************************************************************************
+*/
+
+#if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+static  CPU_BOOLEAN  EHCI_TT_MaskGet (USBH_EP     *p_ep,
+                                      CPU_INT08U   micro_frame_nbr,
+                                      CPU_INT08U  *p_s_mask,
+                                      CPU_INT08U  *p_c_mask)
+{
+    CPU_INT16U  fs_len;
+    CPU_INT08U  nbr_slot;
+    CPU_INT08U  t_cnt;
+    CPU_INT08U  c_start;
+    CPU_INT08U  c_end;
+    CPU_INT08U  ix;
+
+
+    fs_len   = EHCI_TT_LenGet(p_ep);
+    nbr_slot = (CPU_INT08U)((fs_len + EHCI_TT_BW_PER_MICRO_FRAME - 1u) / EHCI_TT_BW_PER_MICRO_FRAME);
+
+   *p_s_mask = 0u;
+   *p_c_mask = 0u;
+
+    if ((USBH_EP_TypeGet(p_ep) == USBH_EP_TYPE_ISOC) &&         /* See Note #1.                                         */
+        (USBH_EP_DirGet(p_ep)  == USBH_EP_DIR_OUT)) {
+        t_cnt = (USBH_EP_MaxPktSizeGet(p_ep) / EHCI_TT_BW_PER_MICRO_FRAME) + 1u;
+        if ((micro_frame_nbr + t_cnt) > 8u) {                   /* See Note #3.                                         */
+            return (DEF_NO);
+        }
+       *p_s_mask = (CPU_INT08U)(((1u << t_cnt) - 1u) << micro_frame_nbr);
+        return (DEF_YES);
+    }
+                                                                /* See Note #2.                                         */
+    c_start = micro_frame_nbr + 2u;
+    c_end   = micro_frame_nbr + nbr_slot + 3u;
+    if (c_end > 7u) {                                           /* See Note #3.                                         */
+        return (DEF_NO);
+    }
+
+   *p_s_mask = (CPU_INT08U)(1u << micro_frame_nbr);
+    for (ix = c_start; ix <= c_end; ix++) {
+       *p_c_mask |= (CPU_INT08U)(1u << ix);
+    }
+
+    return (DEF_YES);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         EHCI_TT_BW_Avail()
+*
+* Description : Check if a TT can carry a split transaction in every frame of a branch.
+*
+* Argument(s) : p_tt              Pointer to TT entry.
+*
+*               start_frame       First frame of the branch.
+*
+*               frame_interval    Interval between the frames of the branch.
+*
+*               micro_frame_nbr   Micro frame of the (first) start-split.
+*
+*               fs_len            Transaction length, in full speed bytes.
+*
+*               p_min_avail       Pointer to variable that will receive the minimum bandwidth left on the TT
+*                                 micro frames used by the transaction, once it is scheduled.
+*
+* Return(s)   : DEF_YES, if the transaction fits.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : (1) The full speed data is budgeted from the micro frame following the start-split, in
+*                   consecutive 188 byte micro frames (see section 11.18.1, USB 2.0 spec).
+*********************************************************************************************************
+*/
+
+#if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+static  CPU_BOOLEAN  EHCI_TT_BW_Avail (EHCI_TT     *p_tt,
+                                       CPU_INT16U   start_frame,
+                                       CPU_INT16U   frame_interval,
+                                       CPU_INT08U   micro_frame_nbr,
+                                       CPU_INT16U   fs_len,
+                                       CPU_INT16U  *p_min_avail)
+{
+    CPU_INT16U  frame_nbr;
+    CPU_INT08U  slot;
+    CPU_INT16U  len_rem;
+    CPU_INT16U  len;
+    CPU_INT16U  avail;
+
+
+   *p_min_avail = EHCI_TT_BW_PER_MICRO_FRAME;
+
+    for (frame_nbr = start_frame; frame_nbr < 256u; frame_nbr += frame_interval) {
+        len_rem = fs_len;
+        slot    = micro_frame_nbr + 1u;                         /* See Note #1.                                         */
+
+        while (len_rem > 0u) {
+            if (slot > EHCI_TT_MICRO_FRAME_LAST) {
+                return (DEF_NO);
+            }
+
+            len   = DEF_MIN(len_rem, EHCI_TT_BW_PER_MICRO_FRAME);
+            avail = p_tt->BW[frame_nbr][slot];
+            if (avail < len) {
+                return (DEF_NO);
+            }
+
+           *p_min_avail = DEF_MIN(*p_min_avail, avail - len);
+            len_rem    -= len;
+            slot++;
+        }
+    }
+
+    return (DEF_YES);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         EHCI_TT_BW_Update()
+*
+* Description : Take or release the TT bandwidth of a split transaction in every frame of a branch.
+*
+* Argument(s) : p_tt              Pointer to TT entry.
+*
+*               start_frame       First frame of the branch.
+*
+*               frame_interval    Interval between the frames of the branch.
+*
+*               micro_frame_nbr   Micro frame of the (first) start-split.
+*
+*               fs_len            Transaction length, in full speed bytes.
+*
+*               bw_use            DEF_TRUE,  bandwidth is taken.
+*                                 DEF_FALSE, bandwidth is released.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The bandwidth is split over the micro frames the same way EHCI_TT_BW_Avail() checks it.
+*********************************************************************************************************
+*/
+
+#if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+static  void  EHCI_TT_BW_Update (EHCI_TT      *p_tt,
+                                 CPU_INT16U    start_frame,
+                                 CPU_INT16U    frame_interval,
+                                 CPU_INT08U    micro_frame_nbr,
+                                 CPU_INT16U    fs_len,
+                                 CPU_BOOLEAN   bw_use)
+{
+    CPU_INT16U  frame_nbr;
+    CPU_INT08U  slot;
+    CPU_INT16U  len_rem;
+    CPU_INT08U  len;
+
+
+    for (frame_nbr = start_frame; frame_nbr < 256u; frame_nbr += frame_interval) {
+        len_rem = fs_len;
+        slot    = micro_frame_nbr + 1u;                         /* See Note #1.                                         */
+
+        while ((len_rem >  0u) &&
+               (slot    <= EHCI_TT_MICRO_FRAME_LAST)) {
+            len = (CPU_INT08U)DEF_MIN(len_rem, EHCI_TT_BW_PER_MICRO_FRAME);
+
+            if (bw_use == DEF_TRUE) {
+                p_tt->BW[frame_nbr][slot] -= len;
+            } else {
+                p_tt->BW[frame_nbr][slot] += len;
+            }
+
+            len_rem -= len;
+            slot++;
+        }
     }
 }
 #endif
@@ -70,6 +70,12 @@
 
 #define  EHCI_MAX_BW_PER_MICRO_FRAME                    3072u
 
+#define  EHCI_TT_BW_PER_MICRO_FRAME                      188u   /* Best case FS bytes a TT moves per micro frame.       */
+#define  EHCI_TT_MICRO_FRAME_FIRST                         1u   /* First & last micro frames in which FS data can be    */
+#define  EHCI_TT_MICRO_FRAME_LAST                          6u   /* ... budgeted without splits wrapping to next frame.  */
+#define  EHCI_TT_OVERHEAD_ISOC                             9u   /* FS protocol overhead of an isoc xact, in bytes.      */
+#define  EHCI_TT_OVERHEAD_INTR                            13u   /* FS protocol overhead of an intr xact, in bytes.      */
+
 #define  EHCI_BW_FLAG_CONSUME                              1u
 #define  EHCI_BW_FLAG_PRODUCE                              2u
 
@@ -106,6 +112,10 @@
 
 #define  USBH_EHCI_CFG_PERIODIC_EN            DEF_ENABLED
 
+#ifndef  EHCI_CFG_TT_NBR                                        /* Max nbr of TTs with periodic split xacts scheduled.  */
+#define  EHCI_CFG_TT_NBR                      2u
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -143,7 +153,7 @@ typedef  struct  ehci_qh {
     CPU_INT08U   SMask;
     CPU_INT08U   BWStartFrame;
     CPU_INT16U   FrameInterval;
-    CPU_INT08U   Rsvd[4];                                       /* Padding to align the struct on a 32-byte boundary    */
+    CPU_INT32U   QTDTail;                                       /* Last qTD of the chained qTD lists.                   */
 } EHCI_QH;
 
 
@@ -230,6 +240,13 @@ typedef  struct  ehci_dma {
 
 
 #if (USBH_EHCI_CFG_PERIODIC_EN == DEF_ENABLED)
+typedef  struct  ehci_tt {                                      /* ------------- TRANSACTION TRANSLATOR -------------- */
+    void               *HubPtr;                                 /* HS hub owning the TT, null if entry is free.         */
+    CPU_INT16U          EP_Cnt;                                 /* Nbr of periodic EPs scheduled through the TT.        */
+    CPU_INT08U          BW[256][8];                             /* Remaining FS bytes per frame & micro frame.          */
+} EHCI_TT;
+
+
 struct  ehci_intr_info {
     CPU_INT08U       IntrPlaceholderIx;                         /* Index of Intr placeholder in QHLists array.          */
     CPU_INT16U       FrameInterval;
@@ -266,6 +283,7 @@ typedef  struct  ehci_dev {                                     /* -------------
     MEM_POOL            HC_Isoc_EP_URBPool;
 
     CPU_INT16U          MaxPeriodicBWArr[256][8];               /* Maximum Periodic Bandwidth                           */
+    EHCI_TT             TT_Tbl[EHCI_CFG_TT_NBR];                /* FS bandwidth of TTs used by split xacts.             */
     EHCI_ISOC_EP_DESC  *HeadIsocEPDesc;                         /* Isochronous list head pointer                        */
     EHCI_INTR_INFO     *HeadIntrInfo;                           /* Intr info list head pointer.                         */
 #endif
@@ -635,6 +635,7 @@ static  void  OHCI_Init (USBH_HC_DRV  *p_hc_drv,
     Mem_Clr(p_ohci, sizeof(OHCI_DEV));
 
     p_hc_drv->DataPtr = (void *)p_ohci;
+    p_hc_drv->SG_En   = DEF_TRUE;                               /* TDs are built from SG seg tbl.                       */
     p_bsp_api         = p_hc_drv->BSP_API_Ptr;
 
     if ((p_bsp_api       != (USBH_HC_BSP_API *)0) &&
@@ -1022,7 +1023,10 @@ static  CPU_INT32U  OHCI_FrameNbrGet (USBH_HC_DRV  *p_hc_drv,
 *               USBH_ERR_HW_DESC_ALLOC If ED is not created due to insufficient memory
 *               Specific error code    Otherwise
 *
-* Note(s)     : None
+* Note(s)     : (1) Periodic endpoints are inserted in the interrupt ED tree at the interval set by the core
+*                   when the endpoint is opened, which may differ from the endpoint descriptor (see
+*                   'usbh_core.c  USBH_IntrInIntervalOpen()'). The interval achieved in the tree is written
+*                   back to the endpoint.
 *********************************************************************************************************
 */
 
@@ -1094,13 +1098,15 @@ static  void  OHCI_EP_Open (USBH_HC_DRV  *p_hc_drv,
         }
 
     } else {
-       *p_err = OHCI_PeriodicEPOpen(p_hc_drv,                     /* Periodic ep open                                     */
+       *p_err = OHCI_PeriodicEPOpen(p_hc_drv,                   /* Periodic ep open (see Note #1).                      */
                                     p_new_hcd_ed,
                                     p_ep->Interval);
         if (*p_err != USBH_ERR_NONE) {
             OHCI_HCD_ED_Destroy(p_hc_drv, p_new_hcd_ed);
             return;
         }
+        p_ep->IntervalUs = p_new_hcd_ed->ListInterval * 1000u;  /* Report interval achieved, in us & in frames.         */
+        p_ep->Interval   = (CPU_INT16U)p_new_hcd_ed->ListInterval;
     }
 
     p_ep->ArgPtr = (void *)p_new_hcd_ed;
@@ -1351,6 +1357,16 @@ static  CPU_BOOLEAN  OHCI_IsHalt_EP (USBH_HC_DRV  *p_hc_drv,
 * Note(s)     : (1) Both the General TD and the Isochronous TD provide a means of specifying a buffer
 *                   that is from 0 to 8,192 bytes long. Additionally, the data buffer described in a
 *                   single TD can span up to two physically disjoint pages.
+*
+*               (2) Scatter-gather URBs are built with one or more TDs per segment when the data buffer is
+*                   in system memory. Only the last TD of the last segment interrupts on completion. The
+*                   core ensures every segment but the last one is a multiple of the maximum packet size.
+*                   When the data buffer comes from dedicated memory, the segments are gathered into the
+*                   DMA buffer instead.
+*
+*               (3) When the core flagged the URB data buffer as reachable by the host controller DMA,
+*                   the bounce buffer from dedicated memory is skipped and the user buffer is given to
+*                   the host controller directly.
 *********************************************************************************************************
 */
 
@@ -1380,6 +1396,9 @@ static  void  OHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
     CPU_INT16U    nbr_hc_tds_avail;
     CPU_INT32U    nbr_bytes;
     CPU_INT32U    td_ctrl;
+    CPU_INT32U    rem_len;
+    CPU_INT08U    seg_ix;
+    CPU_BOOLEAN   sg_en;
     LIB_ERR       err_lib;
     USBH_HC_CFG  *p_hc_cfg;
     USBH_EP      *p_ep;
@@ -1393,13 +1412,15 @@ static  void  OHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
     dly_int    = 0u;
     td_toggle  = 0u;
     frame      = 0u;
+    sg_en      = DEF_FALSE;
 
     ep_type         = USBH_EP_TypeGet(p_ep);
     ep_max_pkt_size = USBH_EP_MaxPktSizeGet(p_ep);
 
 
-    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0) &&
-        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED)) {
+    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0 ) &&
+        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED) &&
+        (p_urb->DMA_Direct             == DEF_FALSE   )) {      /* See Note #3.                                         */
 
         if (p_urb->UserBufLen != 0u) {
             p_urb->DMA_BufPtr = Mem_PoolBlkGet((MEM_POOL  *)&p_ohci->BufPool,
@@ -1409,29 +1430,66 @@ static  void  OHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
                *p_err = USBH_ERR_ALLOC;
                 return;
             }
+            CPU_CRITICAL_ENTER();
+            p_hc_drv->DMA_Stat.BounceCnt++;
+            CPU_CRITICAL_EXIT();
 
             p_urb->DMA_BufLen = DEF_MIN(p_urb->UserBufLen, p_hc_cfg->DataBufMaxLen);
 
             if ((p_urb->Token == USBH_TOKEN_OUT  ) ||
                 (p_urb->Token == USBH_TOKEN_SETUP)) {
 
-                Mem_Copy((void      *)p_urb->DMA_BufPtr,
-                         (void      *)p_urb->UserBufPtr,
-                         (CPU_SIZE_T )p_urb->DMA_BufLen);
+                if (USBH_URB_IS_SG(p_urb)) {                    /* Gather SG seg into DMA buf.                          */
+                    (void)USBH_URB_SG_Gather(p_urb,
+                                             p_urb->DMA_BufPtr,
+                                             p_urb->DMA_BufLen);
+                } else {
+                    Mem_Copy((void      *)p_urb->DMA_BufPtr,
+                             (void      *)p_urb->UserBufPtr,
+                             (CPU_SIZE_T )p_urb->DMA_BufLen);
+                }
             }
         }
     } else {
         p_urb->DMA_BufPtr = p_urb->UserBufPtr;
         p_urb->DMA_BufLen = p_urb->UserBufLen;
+
+        if (p_urb->UserBufLen != 0u) {
+            CPU_CRITICAL_ENTER();
+            p_hc_drv->DMA_Stat.DirectCnt++;
+            CPU_CRITICAL_EXIT();
+        }
+
+        if (USBH_URB_IS_SG(p_urb)) {                            /* See Note #2.                                         */
+            sg_en             = DEF_TRUE;
+            p_urb->DMA_BufPtr = p_urb->SG_SegTblPtr[0u].BufPtr;
+        }
     }
 
     buf_len =  p_urb->DMA_BufLen;
     buf     = (p_urb->DMA_BufLen) ? (CPU_INT32U) VIR2BUS(p_urb->DMA_BufPtr) : 0u;
-
-
-    nbr_tds = ((buf + buf_len) - (buf & 0xFFFFF000u)) / 0x2000u;  /* Calculate number of TDs needed for this xfer         */
-    if ((((buf + buf_len) - (buf & 0xFFFFF000u)) % 0x2000u) != 0u) {
-        nbr_tds++;
+    rem_len =  p_urb->DMA_BufLen;
+
+    if (sg_en == DEF_TRUE) {                                    /* Calculate number of TDs needed for each SG seg       */
+        nbr_tds = 0u;
+        for (seg_ix = 0u; seg_ix < p_urb->SG_SegNbr; seg_ix++) {
+            buf_len = p_urb->SG_SegTblPtr[seg_ix].BufLen;
+            if (buf_len == 0u) {
+                continue;
+            }
+            buf      = (CPU_INT32U)VIR2BUS(p_urb->SG_SegTblPtr[seg_ix].BufPtr);
+            nbr_tds += ((buf + buf_len) - (buf & 0xFFFFF000u)) / 0x2000u;
+            if ((((buf + buf_len) - (buf & 0xFFFFF000u)) % 0x2000u) != 0u) {
+                nbr_tds++;
+            }
+        }
+        buf_len = 0u;
+    } else {
+                                                                /* Calculate number of TDs needed for this xfer         */
+        nbr_tds = ((buf + buf_len) - (buf & 0xFFFFF000u)) / 0x2000u;
+        if ((((buf + buf_len) - (buf & 0xFFFFF000u)) % 0x2000u) != 0u) {
+            nbr_tds++;
+        }
     }
 
     CPU_CRITICAL_ENTER();
@@ -1550,7 +1608,16 @@ static  void  OHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
             return;
         }
 
-        while (buf_len) {
+        seg_ix = 0u;
+        while ((buf_len != 0u) ||                               /* Init TDs of each SG seg (see Note #2).               */
+               ((sg_en == DEF_TRUE) && (seg_ix < p_urb->SG_SegNbr))) {
+
+            if (buf_len == 0u) {                                /* Move to next SG seg.                                 */
+                buf_len = p_urb->SG_SegTblPtr[seg_ix].BufLen;
+                buf     = (buf_len != 0u) ? (CPU_INT32U)VIR2BUS(p_urb->SG_SegTblPtr[seg_ix].BufPtr) : 0u;
+                seg_ix++;
+                continue;
+            }
                                                                 /* Max TD Len is 8192 if the buffer is 4K aligned       */
             max_td_len = 0x2000u - (buf & 0x00000FFFu);
 
@@ -1560,7 +1627,8 @@ static  void  OHCI_URB_Submit (USBH_HC_DRV  *p_hc_drv,
                 max_td_len = buf_len;
             }
 
-            if (buf_len - max_td_len) {
+            rem_len -= max_td_len;
+            if (rem_len != 0u) {
                 dly_int = 7u;                                   /* No interrupt for TDs in the middle                   */
             } else {
                 dly_int = 0u;                                   /* Interrupt on last TD. No delay                       */
@@ -1889,16 +1957,23 @@ static  void  OHCI_URB_Complete (USBH_HC_DRV  *p_hc_drv,
         }
     }
 
-    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0) &&
-        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED)) {
+    if ((p_hc_cfg->DedicatedMemAddr    != (CPU_ADDR)0 ) &&      /* Copy from DMA buf only if it was bounced.            */
+        (p_hc_cfg->DataBufFromSysMemEn == DEF_DISABLED) &&
+        (p_urb->DMA_Direct             == DEF_FALSE   )) {
 
         if (p_urb->DMA_BufPtr != (void *)0) {
 
             if ((p_urb->Token   == USBH_TOKEN_IN) &&
                 (p_urb->XferLen != 0u)) {
-                Mem_Copy((void      *)p_urb->UserBufPtr,
-                         (void      *)p_urb->DMA_BufPtr,
-                         (CPU_SIZE_T )p_urb->XferLen);
+                if (USBH_URB_IS_SG(p_urb)) {
+                    (void)USBH_URB_SG_Scatter(p_urb,
+                                              p_urb->DMA_BufPtr,
+                                              p_urb->XferLen);
+                } else {
+                    Mem_Copy((void      *)p_urb->UserBufPtr,
+                             (void      *)p_urb->DMA_BufPtr,
+                             (CPU_SIZE_T )p_urb->XferLen);
+                }
             }
 
             Mem_PoolBlkFree((MEM_POOL *)&p_ohci->BufPool,
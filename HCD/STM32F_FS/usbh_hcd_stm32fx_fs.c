@@ -329,6 +329,8 @@ typedef  struct  usbh_stm32fx_ch_info {
     CPU_INT32U            AppBufLen;                            /* ... for multi-transaction transfer                   */
     CPU_INT08U           *AppBufPtr;                            /* Ptr to buf supplied by app.                          */
     USBH_URB             *URB_Ptr;
+    USBH_URB             *PendHeadPtr;                          /* URBs waiting for the channel to be free.             */
+    USBH_URB             *PendTailPtr;
 } USBH_STM32FX_CH_INFO;
 
 
@@ -494,6 +496,16 @@ static  CPU_INT08U  STM32FX_GetHostChNbr      (USBH_DRV_DATA     *p_drv_data,
 static  CPU_INT08U  STM32FX_GetFreeHostChNbr  (USBH_DRV_DATA     *p_drv_data,
                                                USBH_ERR          *p_err);
 
+static  CPU_INT08U  STM32FX_GetURB_ChNbr      (USBH_DRV_DATA     *p_drv_data,
+                                               USBH_URB          *p_urb);
+
+static  CPU_BOOLEAN STM32FX_PendURB_Remove    (USBH_STM32FX_CH_INFO  *p_ch_info,
+                                               USBH_EP               *p_ep,
+                                               USBH_URB              *p_urb);
+
+static  void        STM32FX_ChNxtURB_Start    (USBH_HC_DRV           *p_hc_drv,
+                                               USBH_STM32FX_CH_INFO  *p_ch_info);
+
 static  void        STM32FX_ChStartXfer       (USBH_STM32FX_REG  *p_reg,
                                                USBH_DRV_DATA     *p_drv_data,
                                                USBH_URB          *p_urb,
@@ -1307,6 +1319,8 @@ static  void  USBH_STM32FX_HCD_EP_Close (USBH_HC_DRV  *p_hc_drv,
     ep_dir     =  USBH_EP_DirGet(p_ep);
     dev_addr   = (p_ep->DevAddr << 8u);
 
+    USBH_STM32FX_HCD_EP_Abort(p_hc_drv, p_ep, p_err);           /* Drop URBs of this EP waiting for a channel.          */
+
     if (ep_nbr != 0u) {                                         /* Non-Control EPs.                                     */
         ch_nbr = STM32FX_GetHostChNbr(p_drv_data, (dev_addr | ep_nbr | ep_dir));
         if (ch_nbr != 0xFFu) {
@@ -1319,6 +1333,7 @@ static  void  USBH_STM32FX_HCD_EP_Close (USBH_HC_DRV  *p_hc_drv,
             p_drv_data->ChInfoTbl[ch_nbr].EP_Addr   = 0xFFFFu;
             p_drv_data->ChInfoTbl[ch_nbr].EP_PktCnt = 0u;
             p_drv_data->ChInfoTbl[ch_nbr].DataTgl   = REG_PID_DATA1;
+            p_drv_data->ChInfoTbl[ch_nbr].URB_Ptr   = (USBH_URB *)0;
             DEF_BIT_CLR(p_drv_data->ChUsed, DEF_BIT(ch_nbr));
         }
 
@@ -1360,8 +1375,18 @@ static  void  USBH_STM32FX_HCD_EP_Abort (USBH_HC_DRV  *p_hc_drv,
                                          USBH_EP      *p_ep,
                                          USBH_ERR     *p_err)
 {
-    (void)p_hc_drv;
-    (void)p_ep;
+    USBH_DRV_DATA  *p_drv_data;
+    CPU_INT08U      ch_nbr;
+    CPU_SR_ALLOC();
+
+
+    p_drv_data = (USBH_DRV_DATA *)p_hc_drv->DataPtr;
+
+    CPU_CRITICAL_ENTER();                                       /* Drop URBs of this EP waiting for a channel.          */
+    for (ch_nbr = 0u; ch_nbr < p_drv_data->ChMaxNbr; ch_nbr++) {
+        (void)STM32FX_PendURB_Remove(&p_drv_data->ChInfoTbl[ch_nbr], p_ep, (USBH_URB *)0);
+    }
+    CPU_CRITICAL_EXIT();
 
    *p_err = USBH_ERR_NONE;
 }
@@ -1434,6 +1459,9 @@ static  CPU_BOOLEAN  USBH_STM32FX_HCD_IsHalt_EP (USBH_HC_DRV  *p_hc_drv,
 *                   alternate between DATA0 and DATA1.
 *               (3) Bit HCCHARx[Oddfrm] set to '1'. OTG host perform a transfer in an odd frame. But the channel
 *                   must be enabled in the even frame preceding the odd frame.
+*               (4) A host channel processes one URB at a time. If the channel is busy with another URB, the
+*                   URB is queued on the channel and started from the interrupt handler once the current
+*                   URB is completed (see 'STM32FX_ChNxtURB_Start()').
 *********************************************************************************************************
 */
 
@@ -1452,6 +1480,8 @@ static  void  USBH_STM32FX_HCD_URB_Submit (USBH_HC_DRV  *p_hc_drv,
     CPU_INT16U         ep_max_pkt_size;
     CPU_INT16U         dev_addr;
     CPU_INT32U         reg_val;
+    USBH_STM32FX_CH_INFO  *p_ch_info;
+    CPU_SR_ALLOC();
 
 
     p_reg           = (USBH_STM32FX_REG *)p_hc_drv->HC_CfgPtr->BaseAddr;
@@ -1472,6 +1502,29 @@ static  void  USBH_STM32FX_HCD_URB_Submit (USBH_HC_DRV  *p_hc_drv,
         return;
     }
 
+    ch_nbr = STM32FX_GetURB_ChNbr(p_drv_data, p_urb);
+    if (ch_nbr != 0xFFu) {
+        p_ch_info = &p_drv_data->ChInfoTbl[ch_nbr];
+
+        CPU_CRITICAL_ENTER();
+        if ((p_ch_info->URB_Ptr != (USBH_URB *)0) &&
+            (p_ch_info->URB_Ptr != p_urb        )) {            /* Channel busy, queue URB (see Note #4).               */
+            p_urb->NxtPtr = (USBH_URB *)0;
+            if (p_ch_info->PendTailPtr == (USBH_URB *)0) {
+                p_ch_info->PendHeadPtr = p_urb;
+            } else {
+                p_ch_info->PendTailPtr->NxtPtr = p_urb;
+            }
+            p_ch_info->PendTailPtr = p_urb;
+            CPU_CRITICAL_EXIT();
+
+           *p_err = USBH_ERR_NONE;
+            return;
+        }
+        p_ch_info->URB_Ptr = p_urb;
+        CPU_CRITICAL_EXIT();
+    }
+
     reg_val  =  0u;
     reg_val  = (CPU_INT32U)(dev_addr << 22u);                   /* Set the device address to which the channel belongs  */
     reg_val |= (CPU_INT32U)(ep_nbr   << 11u);                   /* Set the associated EP address                        */
@@ -1691,6 +1744,7 @@ static  void  USBH_STM32FX_HCD_URB_Abort (USBH_HC_DRV  *p_hc_drv,
     CPU_INT16U             dev_addr;
     CPU_INT16U             retry_cnt;
     CPU_BOOLEAN            ch_halt_status;
+    CPU_BOOLEAN            removed;
     CPU_SR_ALLOC();
 
 
@@ -1713,6 +1767,21 @@ static  void  USBH_STM32FX_HCD_URB_Abort (USBH_HC_DRV  *p_hc_drv,
         ch_nbr    =  STM32FX_GetHostChNbr(p_drv_data, (dev_addr | ep_nbr | ep_dir));
         p_ch_info = &p_drv_data->ChInfoTbl[ch_nbr];
     }
+                                                                /* ------------ REMOVE URB FROM CH QUEUE -------------- */
+    CPU_CRITICAL_ENTER();
+    if (ep_dir == USBH_EP_DIR_NONE) {
+        removed  = STM32FX_PendURB_Remove(p_ch_info_ctrl_in,  p_urb->EP_Ptr, p_urb);
+        removed |= STM32FX_PendURB_Remove(p_ch_info_ctrl_out, p_urb->EP_Ptr, p_urb);
+    } else {
+        removed  = STM32FX_PendURB_Remove(p_ch_info,          p_urb->EP_Ptr, p_urb);
+    }
+    CPU_CRITICAL_EXIT();
+
+    if (removed == DEF_YES) {                                   /* URB not started on channel, no need to halt it.      */
+        p_urb->State = USBH_URB_STATE_ABORTED;
+       *p_err        = USBH_ERR_NONE;
+        return;
+    }
 
                                                                 /* --------------- WAIT FOR CH HALT END --------------- */
     retry_cnt      = 0u;
@@ -2716,6 +2785,8 @@ static  void  STM32FX_SW_Reset (USBH_DRV_DATA  *p_drv_data)
         p_drv_data->ChInfoTbl[i].EP_PktCnt       = 0u;
         p_drv_data->ChInfoTbl[i].HaltSrc         = REG_HCINTx_HALT_SRC_NONE;
         p_drv_data->ChInfoTbl[i].Halting         = DEF_FALSE;
+        p_drv_data->ChInfoTbl[i].PendHeadPtr     = (USBH_URB *)0;
+        p_drv_data->ChInfoTbl[i].PendTailPtr     = (USBH_URB *)0;
         p_drv_data->ChInfoTbl[i].Aborted         = DEF_FALSE;
     }
 
@@ -2797,6 +2868,158 @@ static  CPU_INT08U  STM32FX_GetFreeHostChNbr (USBH_DRV_DATA  *p_drv_data,
 }
 
 
+/*
+*********************************************************************************************************
+*                                        STM32FX_GetURB_ChNbr()
+*
+* Description : Get the host channel number that will process the given URB.
+*
+* Argument(s) : p_drv_data   Pointer to host driver data structure.
+*
+*               p_urb        Pointer to URB structure.
+*
+* Return(s)   : Host channel number or 0xFF if no host channel is found
+*
+* Note(s)     : (1) Control endpoints use a channel per direction. The direction of the channel depends on
+*                   the URB token.
+*********************************************************************************************************
+*/
+
+static  CPU_INT08U  STM32FX_GetURB_ChNbr (USBH_DRV_DATA  *p_drv_data,
+                                          USBH_URB       *p_urb)
+{
+    CPU_INT08U  ch_nbr;
+    CPU_INT08U  ep_nbr;
+    CPU_INT08U  ep_dir;
+    CPU_INT16U  dev_addr;
+
+
+    ep_nbr   =  USBH_EP_LogNbrGet(p_urb->EP_Ptr);
+    ep_dir   =  USBH_EP_DirGet(p_urb->EP_Ptr);
+    dev_addr = (p_urb->EP_Ptr->DevAddr);
+
+    if (USBH_EP_TypeGet(p_urb->EP_Ptr) == USBH_EP_TYPE_CTRL) {  /* See Note #1.                                         */
+        if (p_urb->Token == USBH_TOKEN_IN) {
+            ch_nbr = STM32FX_GetHostChNbr(p_drv_data, (ep_nbr | USBH_EP_DIR_IN));
+        } else {
+            ch_nbr = STM32FX_GetHostChNbr(p_drv_data, p_urb->EP_Ptr->Desc.bEndpointAddress);
+        }
+    } else {
+        ch_nbr = STM32FX_GetHostChNbr(p_drv_data, ((dev_addr << 8u) | ep_nbr | ep_dir));
+    }
+
+    return (ch_nbr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       STM32FX_PendURB_Remove()
+*
+* Description : Remove URB(s) from the queue of URBs waiting for a host channel.
+*
+* Argument(s) : p_ch_info    Pointer to host channel information structure.
+*
+*               p_ep         Pointer to endpoint structure.
+*
+*               p_urb        Pointer to URB structure to remove, or null pointer to remove all the URBs of
+*                            the endpoint.
+*
+* Return(s)   : DEF_YES, if at least one URB has been removed.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : (1) This function MUST be called with interrupts disabled.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  STM32FX_PendURB_Remove (USBH_STM32FX_CH_INFO  *p_ch_info,
+                                             USBH_EP               *p_ep,
+                                             USBH_URB              *p_urb)
+{
+    USBH_URB     *p_cur_urb;
+    USBH_URB     *p_prev_urb;
+    CPU_BOOLEAN   removed;
+
+
+    removed    =  DEF_NO;
+    p_prev_urb = (USBH_URB *)0;
+    p_cur_urb  =  p_ch_info->PendHeadPtr;
+
+    while (p_cur_urb != (USBH_URB *)0) {
+        if ((p_cur_urb         == p_urb) ||
+            ((p_urb            == (USBH_URB *)0) &&
+             (p_cur_urb->EP_Ptr == p_ep        ))) {
+                                                                /* Unlink URB from the channel queue.                   */
+            if (p_prev_urb == (USBH_URB *)0) {
+                p_ch_info->PendHeadPtr = p_cur_urb->NxtPtr;
+            } else {
+                p_prev_urb->NxtPtr     = p_cur_urb->NxtPtr;
+            }
+            if (p_ch_info->PendTailPtr == p_cur_urb) {
+                p_ch_info->PendTailPtr = p_prev_urb;
+            }
+            removed = DEF_YES;
+        } else {
+            p_prev_urb = p_cur_urb;
+        }
+
+        p_cur_urb = p_cur_urb->NxtPtr;
+    }
+
+    return (removed);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       STM32FX_ChNxtURB_Start()
+*
+* Description : Release the host channel and start the next URB waiting for it, if any.
+*
+* Argument(s) : p_hc_drv     Pointer to host controller driver structure.
+*
+*               p_ch_info    Pointer to host channel information structure.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function is called from the interrupt handler, right after the current URB has
+*                   been returned to the core, so that the channel is re-armed without waiting for the
+*                   completion to be processed by the asynchronous task.
+*********************************************************************************************************
+*/
+
+static  void  STM32FX_ChNxtURB_Start (USBH_HC_DRV           *p_hc_drv,
+                                      USBH_STM32FX_CH_INFO  *p_ch_info)
+{
+    USBH_URB  *p_urb;
+    USBH_ERR   err;
+
+
+    p_ch_info->URB_Ptr = (USBH_URB *)0;
+    p_urb              =  p_ch_info->PendHeadPtr;
+
+    while (p_urb != (USBH_URB *)0) {
+        p_ch_info->PendHeadPtr = p_urb->NxtPtr;
+        if (p_ch_info->PendHeadPtr == (USBH_URB *)0) {
+            p_ch_info->PendTailPtr = (USBH_URB *)0;
+        }
+        p_urb->NxtPtr = (USBH_URB *)0;
+
+        USBH_STM32FX_HCD_URB_Submit(p_hc_drv, p_urb, &err);
+        if (err == USBH_ERR_NONE) {
+            break;
+        }
+
+        p_ch_info->URB_Ptr = (USBH_URB *)0;                     /* URB could not be started, return it to the core.     */
+        p_urb->Err         =  USBH_ERR_HC_IO;
+        p_urb->XferLen     =  0u;
+        USBH_URB_Done(p_urb);
+
+        p_urb = p_ch_info->PendHeadPtr;
+    }
+}
+
+
 /*
 *********************************************************************************************************
 *                                        STM32FX_ChStartXfer()
@@ -3074,6 +3297,7 @@ static  void  STM32FX_ISR_HostChOUT (USBH_STM32FX_REG  *p_reg,
         p_reg->HCH[ch_nbr].HCINTx = REG_HCINTx_NAK;             /* Ack int.                                             */
         p_ch_info->HaltSrc        = REG_HCINTx_HALT_SRC_NAK;
         p_ch_info->CurXferErrCnt  = 0u;                         /* Reset err cnt.                                       */
+        USBH_EP_STAT_NAK_INC(p_urb->EP_Ptr);
         halt_ch                   = DEF_TRUE;
 
     } else if ((hcint_reg & REG_HCINTx_TXERR) != 0u) {          /* Transaction Error. See Note #2                       */
@@ -3082,6 +3306,7 @@ static  void  STM32FX_ISR_HostChOUT (USBH_STM32FX_REG  *p_reg,
         halt_ch                   = DEF_TRUE;
 
         p_ch_info->CurXferErrCnt++;                             /* Increment err cnt in case of transaction err.        */
+        USBH_EP_STAT_RETRY_INC(p_urb->EP_Ptr);
         if (p_ch_info->CurXferErrCnt < 3u) {
             p_ch_info->HaltSrc = REG_HCINTx_HALT_SRC_NAK;       /* Notify core to retry xfer.                           */
         } else {
@@ -3119,7 +3344,7 @@ static  void  STM32FX_ISR_HostChOUT (USBH_STM32FX_REG  *p_reg,
 
                  if (p_urb->XferLen == p_urb->UserBufLen) {
                      USBH_URB_Done(p_urb);                      /* Notify the Core layer about the URB completion       */
-                     p_ch_info->URB_Ptr = (USBH_URB *)0;
+                     STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
 
                  } else if (p_urb->XferLen < p_urb->UserBufLen){/* Send more data                                       */
 
@@ -3136,7 +3361,7 @@ static  void  STM32FX_ISR_HostChOUT (USBH_STM32FX_REG  *p_reg,
                  p_urb->XferLen           = 0u;
 
                  USBH_URB_Done(p_urb);                          /* Notify the Core layer about the STALL condition      */
-                 p_ch_info->URB_Ptr = (USBH_URB *)0;
+                 STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  break;
 
 
@@ -3146,7 +3371,7 @@ static  void  STM32FX_ISR_HostChOUT (USBH_STM32FX_REG  *p_reg,
                  p_urb->XferLen           = 0u;
 
                  USBH_URB_Done(p_urb);                          /* Notify the Core layer about the URB abort            */
-                 p_ch_info->URB_Ptr = (USBH_URB *)0;
+                 STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  break;
 
 
@@ -3191,15 +3416,21 @@ static  void  STM32FX_ISR_HostChOUT (USBH_STM32FX_REG  *p_reg,
                      p_urb->Err     = USBH_ERR_HC_IO;
                      p_urb->XferLen = 0u;
 
-                     USBH_URB_Done(p_urb);                      /* Notify the Core layer about the URB abort            */
-                     p_ch_info->URB_Ptr       = (USBH_URB *)0;
                      p_ch_info->CurXferErrCnt =  0u;            /* Reset error count                                    */
+                     USBH_URB_Done(p_urb);                      /* Notify the Core layer about the URB abort            */
+                     STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  }
                  break;
 
 
             case REG_HCINTx_HALT_SRC_ABORT:
             case REG_HCINTx_HALT_SRC_NONE:
+                 if (p_ch_info->Aborted == DEF_TRUE) {          /* Start next URB queued on the aborted channel.        */
+                     STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
+                 }
+                 break;
+
+
             default:
                  break;
         }
@@ -3306,6 +3537,7 @@ static  void  STM32FX_ISR_HostChIN (USBH_STM32FX_REG  *p_reg,
         p_reg->HCH[ch_nbr].HCINTx = REG_HCINTx_NAK;             /* Ack int.                                             */
         p_ch_info->HaltSrc        = REG_HCINTx_HALT_SRC_NAK;
         p_ch_info->CurXferErrCnt  = 0u;                         /* Reset err cnt.                                       */
+        USBH_EP_STAT_NAK_INC(p_urb->EP_Ptr);
         halt_ch                   = DEF_TRUE;
 
     } else if ((hcint_reg & REG_HCINTx_TXERR) != 0u) {          /* Transaction Error. See Note #2                       */
@@ -3314,6 +3546,7 @@ static  void  STM32FX_ISR_HostChIN (USBH_STM32FX_REG  *p_reg,
         halt_ch                   = DEF_TRUE;
 
         p_ch_info->CurXferErrCnt++;                             /* Increment err cnt in case of transaction err.        */
+        USBH_EP_STAT_RETRY_INC(p_urb->EP_Ptr);
         if (p_ch_info->CurXferErrCnt < 3u) {
             p_ch_info->HaltSrc = REG_HCINTx_HALT_SRC_NAK;       /* Notify core to retry xfer.                           */
         } else {
@@ -3365,7 +3598,7 @@ static  void  STM32FX_ISR_HostChIN (USBH_STM32FX_REG  *p_reg,
                                                 &p_err);
                  } else {
                      USBH_URB_Done(p_urb);                      /* Notify the Core layer about the URB completion       */
-                     p_ch_info->URB_Ptr = (USBH_URB *)0;
+                     STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  }
                  break;
 
@@ -3376,7 +3609,7 @@ static  void  STM32FX_ISR_HostChIN (USBH_STM32FX_REG  *p_reg,
                  p_urb->XferLen           = 0u;
 
                  USBH_URB_Done(p_urb);                          /* Notify the Core layer about the STALL condition      */
-                 p_ch_info->URB_Ptr = (USBH_URB *)0;
+                 STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  break;
 
 
@@ -3386,7 +3619,7 @@ static  void  STM32FX_ISR_HostChIN (USBH_STM32FX_REG  *p_reg,
                  p_urb->XferLen           = 0u;
 
                  USBH_URB_Done(p_urb);                          /* Notify the Core layer about the URB abort            */
-                 p_ch_info->URB_Ptr = (USBH_URB *)0;
+                 STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  break;
 
 
@@ -3396,7 +3629,7 @@ static  void  STM32FX_ISR_HostChIN (USBH_STM32FX_REG  *p_reg,
                  p_urb->XferLen           = 0u;
 
                  USBH_URB_Done(p_urb);                          /* Notify the Core layer about the babble condition     */
-                 p_ch_info->URB_Ptr = (USBH_URB *)0;
+                 STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  break;
 
 
@@ -3420,15 +3653,21 @@ static  void  STM32FX_ISR_HostChIN (USBH_STM32FX_REG  *p_reg,
                      p_urb->Err     = USBH_ERR_HC_IO;
                      p_urb->XferLen = 0u;
 
-                     USBH_URB_Done(p_urb);                      /* Notify the Core layer about the URB abort            */
-                     p_ch_info->URB_Ptr       = (USBH_URB *)0;
                      p_ch_info->CurXferErrCnt =  0u;            /* Reset error count                                    */
+                     USBH_URB_Done(p_urb);                      /* Notify the Core layer about the URB abort            */
+                     STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
                  }
                  break;
 
 
             case REG_HCINTx_HALT_SRC_ABORT:
             case REG_HCINTx_HALT_SRC_NONE:
+                 if (p_ch_info->Aborted == DEF_TRUE) {          /* Start next URB queued on the aborted channel.        */
+                     STM32FX_ChNxtURB_Start(p_hc_drv, p_ch_info);
+                 }
+                 break;
+
+
             default:
                  break;
         }
@@ -0,0 +1,160 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                        USB HOST DRIVER BOARD SUPPORT PACKAGE (BSP) FUNCTIONS
+*
+*                                     SIMULATED HOST CONTROLLER
+*
+* Filename : bsp_usbh_sim.c
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) The simulated host controller has no hardware to set up and is driven by its frame task
+*                instead of an interrupt. These functions only satisfy the BSP interface of the core.
+*********************************************************************************************************
+*/
+
+/*
+**************************************************************************************************************
+*                                            INCLUDE FILES
+**************************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <lib_def.h>
+#include  <usbh_cfg.h>
+#include  "bsp_usbh_sim.h"
+
+
+/*
+**************************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+**************************************************************************************************************
+*/
+
+static  void  BSP_USBH_Sim_Init          (USBH_HC_DRV   *p_drv,
+                                          USBH_ERR      *p_err);
+
+static  void  BSP_USBH_Sim_ISR_Register  (CPU_FNCT_PTR   isr_fnct,
+                                          USBH_ERR      *p_err);
+
+static  void  BSP_USBH_Sim_ISR_Unregister(USBH_ERR      *p_err);
+
+
+/*
+*********************************************************************************************************
+*                                    USB HOST DRIVER BSP INTERFACE
+*********************************************************************************************************
+*/
+
+USBH_HC_BSP_API  USBH_DrvBSP_Sim = {
+    BSP_USBH_Sim_Init,
+    BSP_USBH_Sim_ISR_Register,
+    BSP_USBH_Sim_ISR_Unregister
+};
+
+
+/*
+**************************************************************************************************************
+**************************************************************************************************************
+*                                           LOCAL FUNCTION
+**************************************************************************************************************
+**************************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         BSP_USBH_Sim_Init()
+*
+* Description : Board specific initialization of the simulated host controller.
+*
+* Argument(s) : p_drv    Pointer to host controller driver structure.
+*
+*               p_err    Pointer to variable that will receive the return error code from this function
+*
+*                            USBH_ERR_NONE    BSP init successfull.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BSP_USBH_Sim_Init (USBH_HC_DRV  *p_drv,
+                                 USBH_ERR     *p_err)
+{
+    (void)p_drv;
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     BSP_USBH_Sim_ISR_Register()
+*
+* Description : Registers Interrupt Service Routine.
+*
+* Argument(s) : isr_fnct    Host controller ISR address.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function
+*
+*                               USBH_ERR_NONE    ISR registered successfully.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The simulated host controller does not use interrupts (see 'bsp_usbh_sim.c  Note #1').
+*********************************************************************************************************
+*/
+
+static  void  BSP_USBH_Sim_ISR_Register (CPU_FNCT_PTR   isr_fnct,
+                                         USBH_ERR      *p_err)
+{
+    (void)isr_fnct;
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                    BSP_USBH_Sim_ISR_Unregister()
+*
+* Description : Unregisters Interrupt Service Routine.
+*
+* Argument(s) : p_err    Pointer to variable that will receive the return error code from this function
+*
+*                            USBH_ERR_NONE    ISR unregistered successfully.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BSP_USBH_Sim_ISR_Unregister (USBH_ERR  *p_err)
+{
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+**************************************************************************************************************
+*                                                  END
+**************************************************************************************************************
+*/
@@ -0,0 +1,93 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                        USB HOST DRIVER BOARD SUPPORT PACKAGE (BSP) FUNCTIONS
+*
+*                                     SIMULATED HOST CONTROLLER
+*
+* Filename : bsp_usbh_sim.h
+* Version  : V3.42.01
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*
+* Note(s) : (1) This USB host driver board-specific function header file is protected from multiple
+*               pre-processor inclusion through use of the USB host configuration module present pre-
+*               processor macro definition.
+*********************************************************************************************************
+*/
+
+#ifndef  BSP_USBH_PRESENT                                       /* See Note #1.                                         */
+#define  BSP_USBH_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "usbh_hcd_sim.h"
+#include  "../../Source/usbh_core.h"
+
+
+/*
+*********************************************************************************************************
+*                                     EXTERNAL C LANGUAGE LINKAGE
+*
+* Note(s) : (1) C++ compilers MUST 'extern'ally declare ALL C function prototypes & variable/object
+*               declarations for correct C language linkage.
+*********************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern  "C" {                                                   /* See Note #1.                                         */
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+extern  USBH_HC_BSP_API  USBH_DrvBSP_Sim;
+
+
+/*
+*********************************************************************************************************
+*                                   EXTERNAL C LANGUAGE LINKAGE END
+*********************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}                                                               /* End of 'extern'al C lang linkage.                    */
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif
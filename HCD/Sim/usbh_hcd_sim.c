@@ -0,0 +1,2151 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                  SIMULATED HOST CONTROLLER DRIVER
+*
+* Filename : usbh_hcd_sim.c
+* Version  : V3.42.01
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  USBH_HCD_SIM_MODULE
+#include  "usbh_hcd_sim.h"
+#include  "../../Source/usbh_hub.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  USBH_HCD_SIM_EP_NBR          (((USBH_CFG_MAX_NBR_EPS * USBH_CFG_MAX_NBR_IFS) + 1u) * (USBH_MAX_NBR_DEVS))
+#define  USBH_HCD_SIM_URB_Q_LEN                     USBH_CFG_MAX_QUEUED_URB_PER_EP
+
+#define  USBH_HCD_SIM_XACT_OVERHEAD                        20u  /* Token, handshake and CRC, in octets.                 */
+
+#if     (USBH_HCD_SIM_CFG_HS_EN == DEF_ENABLED)
+#define  USBH_HCD_SIM_FRM_PER_MS                            8u
+#else
+#define  USBH_HCD_SIM_FRM_PER_MS                            1u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL CONSTANTS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         SIMULATED ENDPOINT
+*
+* Note(s) : (1) Submitted URBs are kept in a circular queue and transferred in submission order.
+*
+*           (2) 'Period' and 'NxtFrm' are only used by interrupt endpoints.
+*
+*           (3) 'NakFrm' holds the frame in which the endpoint last NAK'd. The endpoint is not retried
+*               before the next frame.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_hcd_sim_ep {
+    USBH_EP      *EP_Ptr;                                       /* Ptr to EP, 0 if sim EP free.                         */
+    CPU_INT08U    Type;                                         /* EP type.                                             */
+    CPU_INT16U    MaxPktSize;
+    CPU_BOOLEAN   Halt;                                         /* EP halted by a STALL handshake.                      */
+    CPU_INT32U    Period;                                       /* Polling period, in frames (see Note #2).             */
+    CPU_INT32U    NxtFrm;                                       /* Next polling frame.                                  */
+    CPU_INT32U    NakFrm;                                       /* See Note #3.                                         */
+
+    USBH_URB     *URB_Q[USBH_HCD_SIM_URB_Q_LEN];                /* URB queue (see Note #1).                             */
+    CPU_INT32U    URB_StartFrm[USBH_HCD_SIM_URB_Q_LEN];         /* Frame of first xact of each URB.                     */
+    CPU_INT08U    URB_Ix;                                       /* Ix of oldest URB.                                    */
+    CPU_INT08U    URB_Cnt;                                      /* Nbr of queued URBs.                                  */
+} USBH_HCD_SIM_EP;
+
+
+/*
+*********************************************************************************************************
+*                                             DRIVER DATA
+*
+* Note(s) : (1) 'FrmNbr' counts micro-frames for a high-speed controller.
+*
+*           (2) URBs completed during a frame are linked through their 'ArgPtr' field and given to the core
+*               once the simulation lock is released.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_hcd_sim_drv_data {
+    USBH_HC_DRV        *HC_DrvPtr;
+    USBH_HSEM           FrmSem;                                 /* Wakes up the idle frame task.                        */
+    CPU_BOOLEAN         Run;                                    /* Controller started.                                  */
+    CPU_BOOLEAN         Idle;                                   /* No xact ACK'd in the last frame.                     */
+    CPU_BOOLEAN         RH_IntEn;                               /* Root hub port change notification en.               */
+
+    CPU_INT32U          FrmNbr;                                 /* Current frame nbr (see Note #1).                     */
+    CPU_INT32U          FrmPeriodUs;                            /* Frame period, in us. 0 if free-running.              */
+    CPU_INT32U          FrmBW;                                  /* Octets per frame. 0 if unlimited.                    */
+    CPU_INT32U          LatFrm;                                 /* Latency added to each URB, in frames.                */
+
+    USBH_SIM_PORT       PortTbl[USBH_HCD_SIM_CFG_NBR_PORTS];    /* Root hub ports.                                      */
+    USBH_HCD_SIM_EP     EP_Tbl[USBH_HCD_SIM_EP_NBR];
+    CPU_INT16U          EP_RR_Ix;                               /* Ix of first async EP served in next frame.           */
+
+    USBH_URB           *DoneHeadPtr;                            /* URBs completed during frame (see Note #2).           */
+    USBH_URB           *DoneTailPtr;
+
+    USBH_HCD_SIM_STAT   Stat;
+} USBH_HCD_SIM_DRV_DATA;
+
+
+/*
+*********************************************************************************************************
+*                                             LOCAL TABLES
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                        LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  USBH_HCD_SIM_DRV_DATA  *USBH_SimHCD_DataTbl[USBH_CFG_MAX_NBR_HC];
+
+static  CPU_STK                 USBH_SimHCD_TaskStk[USBH_CFG_MAX_NBR_HC][USBH_HCD_SIM_CFG_TASK_STK_SIZE];
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+                                                                /* --------------- DRIVER API FUNCTIONS --------------- */
+static  void           USBH_SimHCD_Init            (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_Start           (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_Stop            (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_ERR              *p_err);
+
+static  USBH_DEV_SPD   USBH_SimHCD_SpdGet          (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_Suspend         (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_Resume          (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_ERR              *p_err);
+
+static  CPU_INT32U     USBH_SimHCD_FrameNbrGet     (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_EP_Open         (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_EP               *p_ep,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_EP_Close        (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_EP               *p_ep,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_EP_Abort        (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_EP               *p_ep,
+                                                    USBH_ERR              *p_err);
+
+static  CPU_BOOLEAN    USBH_SimHCD_IsHalt_EP       (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_EP               *p_ep,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_URB_Submit      (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_URB              *p_urb,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_URB_Complete    (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_URB              *p_urb,
+                                                    USBH_ERR              *p_err);
+
+static  void           USBH_SimHCD_URB_Abort       (USBH_HC_DRV           *p_hc_drv,
+                                                    USBH_URB              *p_urb,
+                                                    USBH_ERR              *p_err);
+
+                                                                /* -------------- ROOT HUB API FUNCTIONS -------------- */
+static  CPU_BOOLEAN    USBH_SimHCD_PortStatusGet   (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr,
+                                                    USBH_HUB_PORT_STATUS  *p_port_status);
+
+static  CPU_BOOLEAN    USBH_SimHCD_HubDescGet      (USBH_HC_DRV           *p_hc_drv,
+                                                    void                  *p_buf,
+                                                    CPU_INT08U             buf_len);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortEnSet       (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortEnClr       (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortEnChngClr   (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortPwrSet      (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortPwrClr      (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortResetSet    (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortResetChngClr(USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortSuspendClr  (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortConnChngClr (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr);
+
+static  CPU_BOOLEAN    USBH_SimHCD_RHSC_IntEn      (USBH_HC_DRV           *p_hc_drv);
+
+static  CPU_BOOLEAN    USBH_SimHCD_RHSC_IntDis     (USBH_HC_DRV           *p_hc_drv);
+
+                                                                /* ----------------- LOCAL FUNCTIONS ------------------ */
+static  void           USBH_SimHCD_FrmTask         (void                  *p_arg);
+
+static  CPU_BOOLEAN    USBH_SimHCD_FrmProc         (USBH_HCD_SIM_DRV_DATA *p_drv_data);
+
+static  void           USBH_SimHCD_FrmSkip         (USBH_HCD_SIM_DRV_DATA *p_drv_data);
+
+static  USBH_SIM_STATUS  USBH_SimHCD_Xact          (USBH_HCD_SIM_DRV_DATA *p_drv_data,
+                                                    USBH_HCD_SIM_EP       *p_sim_ep,
+                                                    CPU_INT32U            *p_bw);
+
+static  void           USBH_SimHCD_URB_Done        (USBH_HCD_SIM_DRV_DATA *p_drv_data,
+                                                    USBH_HCD_SIM_EP       *p_sim_ep,
+                                                    USBH_ERR               err);
+
+static  CPU_BOOLEAN    USBH_SimHCD_PortFeature     (USBH_HC_DRV           *p_hc_drv,
+                                                    CPU_INT08U             port_nbr,
+                                                    CPU_INT16U             feature,
+                                                    CPU_BOOLEAN            set);
+
+static  USBH_HCD_SIM_DRV_DATA  *USBH_SimHCD_DataGet(CPU_INT08U             hc_nbr);
+
+
+/*
+*********************************************************************************************************
+*                                     INITIALIZED GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+USBH_HC_DRV_API  USBH_SimHCD_DrvAPI = {
+    USBH_SimHCD_Init,
+    USBH_SimHCD_Start,
+    USBH_SimHCD_Stop,
+    USBH_SimHCD_SpdGet,
+    USBH_SimHCD_Suspend,
+    USBH_SimHCD_Resume,
+    USBH_SimHCD_FrameNbrGet,
+
+    USBH_SimHCD_EP_Open,
+    USBH_SimHCD_EP_Close,
+    USBH_SimHCD_EP_Abort,
+    USBH_SimHCD_IsHalt_EP,
+
+    USBH_SimHCD_URB_Submit,
+    USBH_SimHCD_URB_Complete,
+    USBH_SimHCD_URB_Abort,
+};
+
+USBH_HC_RH_API  USBH_SimHCD_RH_API = {
+    USBH_SimHCD_PortStatusGet,
+    USBH_SimHCD_HubDescGet,
+
+    USBH_SimHCD_PortEnSet,
+    USBH_SimHCD_PortEnClr,
+    USBH_SimHCD_PortEnChngClr,
+
+    USBH_SimHCD_PortPwrSet,
+    USBH_SimHCD_PortPwrClr,
+
+    USBH_SimHCD_PortResetSet,
+    USBH_SimHCD_PortResetChngClr,
+
+    USBH_SimHCD_PortSuspendClr,
+    USBH_SimHCD_PortConnChngClr,
+
+    USBH_SimHCD_RHSC_IntEn,
+    USBH_SimHCD_RHSC_IntDis
+};
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           GLOBAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_PortConn()
+*
+* Description : Connect an emulated device to a root hub port of the simulated host controller.
+*
+* Argument(s) : hc_nbr          Host controller number, as returned by USBH_HC_Add().
+*
+*               port_nbr        Root hub port number, starting at 1.
+*
+*               p_dev           Pointer to emulated device.
+*
+* Return(s)   : USBH_ERR_NONE,          if the device was connected.
+*               USBH_ERR_INVALID_ARG,   if the host controller or port number is invalid.
+*
+* Note(s)     : (1) The root hub reports the connection to the core on the next frame, if port change
+*                   notifications are enabled.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_PortConn (CPU_INT08U     hc_nbr,
+                                CPU_INT08U     port_nbr,
+                                USBH_SIM_DEV  *p_dev)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if ((p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) ||
+        (p_dev      == (USBH_SIM_DEV          *)0) ||
+        (port_nbr   == 0u)                         ||
+        (port_nbr   >  USBH_HCD_SIM_CFG_NBR_PORTS)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    USBH_SimDev_PortConn(&p_drv_data->PortTbl[port_nbr - 1u], p_dev);
+    USBH_SimDev_Unlock();
+
+    (void)USBH_OS_SemPost(p_drv_data->FrmSem);                  /* See Note #1.                                         */
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimHCD_PortDisconn()
+*
+* Description : Disconnect the emulated device connected to a root hub port.
+*
+* Argument(s) : hc_nbr          Host controller number.
+*
+*               port_nbr        Root hub port number, starting at 1.
+*
+* Return(s)   : USBH_ERR_NONE,          if the device was disconnected.
+*               USBH_ERR_INVALID_ARG,   if the host controller or port number is invalid.
+*
+* Note(s)     : (1) Pending transfers to the device and to the devices behind it fail with
+*                   USBH_ERR_HC_IO until the core closes their endpoints.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_PortDisconn (CPU_INT08U  hc_nbr,
+                                   CPU_INT08U  port_nbr)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if ((p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) ||
+        (port_nbr   == 0u)                         ||
+        (port_nbr   >  USBH_HCD_SIM_CFG_NBR_PORTS)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    USBH_SimDev_PortDisconn(&p_drv_data->PortTbl[port_nbr - 1u]);
+    USBH_SimDev_Unlock();
+
+    (void)USBH_OS_SemPost(p_drv_data->FrmSem);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_SimHCD_FrmPeriodSet()
+*
+* Description : Set the frame period of the simulated host controller.
+*
+* Argument(s) : hc_nbr          Host controller number.
+*
+*               frm_period_us   Frame period, in us. 0 runs the frames back to back while transfers are
+*                               pending.
+*
+* Return(s)   : USBH_ERR_NONE,          if the frame period was set.
+*               USBH_ERR_INVALID_ARG,   if the host controller number is invalid.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_FrmPeriodSet (CPU_INT08U  hc_nbr,
+                                    CPU_INT32U  frm_period_us)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if (p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    p_drv_data->FrmPeriodUs = frm_period_us;
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_FrmBW_Set()
+*
+* Description : Set the bandwidth of each frame of the simulated host controller.
+*
+* Argument(s) : hc_nbr          Host controller number.
+*
+*               frm_bw          Number of octets that can be transferred per frame, including a fixed
+*                               overhead per transaction. 0 is unlimited.
+*
+* Return(s)   : USBH_ERR_NONE,          if the bandwidth was set.
+*               USBH_ERR_INVALID_ARG,   if the host controller number is invalid.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_FrmBW_Set (CPU_INT08U  hc_nbr,
+                                 CPU_INT32U  frm_bw)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if (p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    p_drv_data->FrmBW = frm_bw;
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimHCD_LatSet()
+*
+* Description : Set the latency added to each URB submitted to the simulated host controller.
+*
+* Argument(s) : hc_nbr          Host controller number.
+*
+*               lat_frm         Number of frames between the submission of a URB and its first transaction.
+*
+* Return(s)   : USBH_ERR_NONE,          if the latency was set.
+*               USBH_ERR_INVALID_ARG,   if the host controller number is invalid.
+*
+* Note(s)     : (1) Applies to the URBs submitted after the call.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_LatSet (CPU_INT08U  hc_nbr,
+                              CPU_INT32U  lat_frm)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if (p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    p_drv_data->LatFrm = lat_frm;                               /* See Note #1.                                         */
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_SimHCD_Wake()
+*
+* Description : Run the next frame of the simulated host controller without waiting.
+*
+* Argument(s) : hc_nbr          Host controller number.
+*
+* Return(s)   : USBH_ERR_NONE,          if the frame task was woken up.
+*               USBH_ERR_INVALID_ARG,   if the host controller number is invalid.
+*
+* Note(s)     : (1) To be called after the application changed the state of an emulated device, e.g. with
+*                   USBH_SimDev_HID_ReportSet(), so that a free-running controller does not wait for the end
+*                   of an idle frame to see the change.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_Wake (CPU_INT08U  hc_nbr)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if (p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    (void)USBH_OS_SemPost(p_drv_data->FrmSem);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_StatGet()
+*
+* Description : Get the statistics of the simulated host controller.
+*
+* Argument(s) : hc_nbr          Host controller number.
+*
+*               p_stat          Variable that will receive the statistics.
+*
+* Return(s)   : USBH_ERR_NONE,          if the statistics were copied.
+*               USBH_ERR_INVALID_ARG,   if the host controller number is invalid.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_StatGet (CPU_INT08U          hc_nbr,
+                               USBH_HCD_SIM_STAT  *p_stat)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if ((p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) ||
+        (p_stat     == (USBH_HCD_SIM_STAT     *)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+   *p_stat = p_drv_data->Stat;
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_StatClr()
+*
+* Description : Clear the statistics of the simulated host controller.
+*
+* Argument(s) : hc_nbr          Host controller number.
+*
+* Return(s)   : USBH_ERR_NONE,          if the statistics were cleared.
+*               USBH_ERR_INVALID_ARG,   if the host controller number is invalid.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_StatClr (CPU_INT08U  hc_nbr)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = USBH_SimHCD_DataGet(hc_nbr);
+    if (p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    Mem_Clr((void *)&p_drv_data->Stat, sizeof(USBH_HCD_SIM_STAT));
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                      DRIVER INTERFACE FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimHCD_Init()
+*
+* Description : Initialize the simulated host controller.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE           Host controller successfully initialized.
+*                   USBH_ERR_ALLOC          Driver data could not be allocated.
+*                   USBH_ERR_INVALID_ARG    Host controller number too high.
+*
+*                                           ----- RETURNED BY USBH_OS_SemCreate() : -----
+*                   USBH_ERR_OS_SIGNAL_CREATE,  if semaphore creation failed.
+*
+*                                           ----- RETURNED BY USBH_OS_TaskCreate() : -----
+*                   USBH_ERR_OS_TASK_CREATE,    if task creation failed.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Buffers are read and written in place, so the segment tables of scatter-gather URBs are
+*                   used directly.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_Init (USBH_HC_DRV  *p_hc_drv,
+                                USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+    USBH_HTASK              htask;
+    CPU_SIZE_T              octets_reqd;
+    LIB_ERR                 err_lib;
+
+
+    if (p_hc_drv->Nbr >= USBH_CFG_MAX_NBR_HC) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return;
+    }
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)Mem_HeapAlloc(sizeof(USBH_HCD_SIM_DRV_DATA),
+                                                        sizeof(CPU_ALIGN),
+                                                       &octets_reqd,
+                                                       &err_lib);
+    if (p_drv_data == (USBH_HCD_SIM_DRV_DATA *)0) {
+       *p_err = USBH_ERR_ALLOC;
+        return;
+    }
+
+    Mem_Clr(p_drv_data, sizeof(USBH_HCD_SIM_DRV_DATA));
+
+    p_drv_data->HC_DrvPtr   = p_hc_drv;
+    p_drv_data->Idle        = DEF_TRUE;
+    p_drv_data->FrmPeriodUs = USBH_HCD_SIM_CFG_FRM_PERIOD_US;
+    p_drv_data->FrmBW       = USBH_HCD_SIM_CFG_FRM_BW;
+    p_drv_data->LatFrm      = USBH_HCD_SIM_CFG_LAT_FRM;
+
+    p_hc_drv->DataPtr = (void *)p_drv_data;
+    p_hc_drv->SG_En   =  DEF_TRUE;                              /* See Note #1.                                         */
+
+   *p_err = USBH_SimDev_Init();
+    if (*p_err != USBH_ERR_NONE) {
+        return;
+    }
+
+   *p_err = USBH_OS_SemCreate(&p_drv_data->FrmSem, 0u);
+    if (*p_err != USBH_ERR_NONE) {
+        return;
+    }
+
+    USBH_SimHCD_DataTbl[p_hc_drv->Nbr] = p_drv_data;
+                                                                /* Create frame task.                                   */
+   *p_err = USBH_OS_TaskCreate(              "USBH Sim HCD Frame",
+                                              USBH_HCD_SIM_CFG_TASK_PRIO,
+                                             &USBH_SimHCD_FrmTask,
+                               (void       *) p_drv_data,
+                               (CPU_INT32U *)&USBH_SimHCD_TaskStk[p_hc_drv->Nbr][0u],
+                                              USBH_HCD_SIM_CFG_TASK_STK_SIZE,
+                                             &htask);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimHCD_Start()
+*
+* Description : Start the simulated host controller.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Host controller successfully started.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_Start (USBH_HC_DRV  *p_hc_drv,
+                                 USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+
+    USBH_SimDev_Lock();
+    p_drv_data->Run = DEF_TRUE;
+    USBH_SimDev_Unlock();
+
+    (void)USBH_OS_SemPost(p_drv_data->FrmSem);
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_SimHCD_Stop()
+*
+* Description : Stop the simulated host controller. No frames are generated until it is started again.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Host controller successfully stopped.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_Stop (USBH_HC_DRV  *p_hc_drv,
+                                USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+
+    USBH_SimDev_Lock();
+    p_drv_data->Run = DEF_FALSE;
+    USBH_SimDev_Unlock();
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimHCD_SpdGet()
+*
+* Description : Return the speed of the simulated host controller.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Host controller speed successfully returned.
+*
+* Return(s)   : USBH_DEV_SPD_HIGH or USBH_DEV_SPD_FULL (see 'usbh_hcd_sim.h  DEFINES  Note #1a').
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_DEV_SPD  USBH_SimHCD_SpdGet (USBH_HC_DRV  *p_hc_drv,
+                                          USBH_ERR     *p_err)
+{
+    (void)p_hc_drv;
+
+   *p_err = USBH_ERR_NONE;
+
+#if (USBH_HCD_SIM_CFG_HS_EN == DEF_ENABLED)
+    return (USBH_DEV_SPD_HIGH);
+#else
+    return (USBH_DEV_SPD_FULL);
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_Suspend()
+*
+* Description : Suspend the simulated host controller.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Host controller successfully suspended.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_Suspend (USBH_HC_DRV  *p_hc_drv,
+                                   USBH_ERR     *p_err)
+{
+    USBH_SimHCD_Stop(p_hc_drv, p_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimHCD_Resume()
+*
+* Description : Resume the simulated host controller.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Host controller successfully resumed.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_Resume (USBH_HC_DRV  *p_hc_drv,
+                                  USBH_ERR     *p_err)
+{
+    USBH_SimHCD_Start(p_hc_drv, p_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimHCD_FrameNbrGet()
+*
+* Description : Retrieve the current frame number.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Frame number successfully retrieved.
+*
+* Return(s)   : Frame number, in ms frames.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_SimHCD_FrameNbrGet (USBH_HC_DRV  *p_hc_drv,
+                                             USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+    CPU_INT32U              frm_nbr;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+    frm_nbr    = p_drv_data->FrmNbr / USBH_HCD_SIM_FRM_PER_MS;
+
+   *p_err = USBH_ERR_NONE;
+
+    return (frm_nbr & 0x7FFu);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_EP_Open()
+*
+* Description : Allocate a simulated endpoint for given endpoint.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_ep        Pointer to endpoint structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE           Endpoint successfully opened.
+*                   USBH_ERR_EP_ALLOC       No simulated endpoint available.
+*                   USBH_ERR_NOT_SUPPORTED  Isochronous endpoint.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The polling period of interrupt endpoints is computed in frames of the controller, from
+*                   the interval set by the core when the endpoint is opened (see 'usbh_core.c
+*                   USBH_EP_IntervalGet()'):
+*
+*                   (a) High-speed endpoints are polled every 2^(bInterval - 1) micro-frames, unless another
+*                       interval is requested.
+*
+*                   (b) Full- and low-speed endpoints are polled every bInterval ms, unless another interval
+*                       is requested.
+*
+*                   The interval achieved is written back to the endpoint, in both 'IntervalUs' and 'Interval'.
+*
+*               (2) Isochronous transfers are not supported, none of the emulated devices use them.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_EP_Open (USBH_HC_DRV  *p_hc_drv,
+                                   USBH_EP      *p_ep,
+                                   USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+    USBH_HCD_SIM_EP        *p_sim_ep;
+    CPU_INT08U              ep_type;
+    CPU_INT16U              ix;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+    ep_type    =  USBH_EP_TypeGet(p_ep);
+
+    if (ep_type == USBH_EP_TYPE_ISOC) {                         /* See Note #2.                                         */
+       *p_err = USBH_ERR_NOT_SUPPORTED;
+        return;
+    }
+
+    USBH_SimDev_Lock();
+    p_sim_ep = (USBH_HCD_SIM_EP *)0;
+    for (ix = 0u; ix < USBH_HCD_SIM_EP_NBR; ix++) {
+        if (p_drv_data->EP_Tbl[ix].EP_Ptr == (USBH_EP *)0) {
+            p_sim_ep = &p_drv_data->EP_Tbl[ix];
+            break;
+        }
+    }
+
+    if (p_sim_ep == (USBH_HCD_SIM_EP *)0) {
+        USBH_SimDev_Unlock();
+       *p_err = USBH_ERR_EP_ALLOC;
+        return;
+    }
+
+    Mem_Clr(p_sim_ep, sizeof(USBH_HCD_SIM_EP));
+    p_sim_ep->EP_Ptr     = p_ep;
+    p_sim_ep->Type       = ep_type;
+    p_sim_ep->MaxPktSize = USBH_EP_MaxPktSizeGet(p_ep);
+    p_sim_ep->NakFrm     = p_drv_data->FrmNbr - 1u;
+
+    if (ep_type == USBH_EP_TYPE_INTR) {                         /* See Note #1.                                         */
+        p_sim_ep->Period = DEF_MAX((p_ep->IntervalUs * USBH_HCD_SIM_FRM_PER_MS) / 1000u, 1u);
+        p_sim_ep->NxtFrm = p_drv_data->FrmNbr + 1u;
+        p_ep->IntervalUs = (p_sim_ep->Period * 1000u) / USBH_HCD_SIM_FRM_PER_MS;
+                                                                /* Keep 'Interval' in sync, see USBH_EP_Open() Note #5. */
+        if (p_ep->DevSpd == USBH_DEV_SPD_HIGH) {
+            p_ep->Interval = (CPU_INT16U)(p_ep->IntervalUs / 125u);
+        } else if (p_ep->DevPtr->HubHS_Ptr != (USBH_HUB_DEV *)0) {
+            p_ep->Interval = (CPU_INT16U)(8u * (p_ep->IntervalUs / 1000u));
+        } else {
+            p_ep->Interval = (CPU_INT16U)(p_ep->IntervalUs / 1000u);
+        }
+    }
+
+    p_ep->ArgPtr = (void *)p_sim_ep;
+    USBH_SimDev_Unlock();
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_EP_Close()
+*
+* Description : Free the simulated endpoint of given endpoint.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_ep        Pointer to endpoint structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Endpoint successfully closed.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_EP_Close (USBH_HC_DRV  *p_hc_drv,
+                                    USBH_EP      *p_ep,
+                                    USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_EP  *p_sim_ep;
+
+
+    (void)p_hc_drv;
+
+    p_sim_ep = (USBH_HCD_SIM_EP *)p_ep->ArgPtr;
+    if (p_sim_ep != (USBH_HCD_SIM_EP *)0) {
+        USBH_SimDev_Lock();
+        p_sim_ep->EP_Ptr  = (USBH_EP *)0;
+        p_sim_ep->URB_Cnt = 0u;
+        USBH_SimDev_Unlock();
+
+        p_ep->ArgPtr = (void *)0;
+    }
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_EP_Abort()
+*
+* Description : Drop the URBs queued on given endpoint.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_ep        Pointer to endpoint structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Endpoint successfully aborted.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The core completes the dropped URBs as aborted.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_EP_Abort (USBH_HC_DRV  *p_hc_drv,
+                                    USBH_EP      *p_ep,
+                                    USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_EP  *p_sim_ep;
+
+
+    (void)p_hc_drv;
+
+    p_sim_ep = (USBH_HCD_SIM_EP *)p_ep->ArgPtr;
+    if (p_sim_ep != (USBH_HCD_SIM_EP *)0) {
+        USBH_SimDev_Lock();
+        p_sim_ep->URB_Cnt = 0u;                                 /* See Note #1.                                         */
+        USBH_SimDev_Unlock();
+    }
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_IsHalt_EP()
+*
+* Description : Retrieve the halt state of given endpoint.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_ep        Pointer to endpoint structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   Endpoint halt status successfully retrieved.
+*
+* Return(s)   : DEF_TRUE,   if the endpoint is halted.
+*               DEF_FALSE,  otherwise.
+*
+* Note(s)     : (1) The halt state is set when a non-control endpoint returns a STALL handshake, and cleared
+*                   when the next URB is submitted.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_IsHalt_EP (USBH_HC_DRV  *p_hc_drv,
+                                            USBH_EP      *p_ep,
+                                            USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_EP  *p_sim_ep;
+    CPU_BOOLEAN       halt;
+
+
+    (void)p_hc_drv;
+
+    p_sim_ep = (USBH_HCD_SIM_EP *)p_ep->ArgPtr;
+    halt     = (p_sim_ep != (USBH_HCD_SIM_EP *)0) ? p_sim_ep->Halt : DEF_FALSE;
+
+   *p_err = USBH_ERR_NONE;
+
+    return (halt);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_URB_Submit()
+*
+* Description : Queue a URB on its simulated endpoint.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_urb       Pointer to URB structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE               URB successfully submitted.
+*                   USBH_ERR_EP_INVALID_STATE   Endpoint not opened.
+*                   USBH_ERR_EP_QUEUE_FULL      URB queue of endpoint full.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The first transaction of the URB takes place 'LatFrm' frames after the current frame
+*                   (see USBH_SimHCD_LatSet()).
+*
+*               (2) The frame task is woken up when it is idle and running back to back frames.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_URB_Submit (USBH_HC_DRV  *p_hc_drv,
+                                      USBH_URB     *p_urb,
+                                      USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+    USBH_HCD_SIM_EP        *p_sim_ep;
+    CPU_INT08U              q_ix;
+    CPU_BOOLEAN             wake;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+    p_sim_ep   = (USBH_HCD_SIM_EP       *)p_urb->EP_Ptr->ArgPtr;
+
+    if (p_sim_ep == (USBH_HCD_SIM_EP *)0) {
+       *p_err = USBH_ERR_EP_INVALID_STATE;
+        return;
+    }
+
+    USBH_SimDev_Lock();
+    if (p_sim_ep->URB_Cnt >= USBH_HCD_SIM_URB_Q_LEN) {
+        USBH_SimDev_Unlock();
+       *p_err = USBH_ERR_EP_QUEUE_FULL;
+        return;
+    }
+
+    p_urb->XferLen    = 0u;
+    p_urb->DMA_BufPtr = p_urb->UserBufPtr;                      /* Bufs are accessed in place.                          */
+    p_urb->DMA_BufLen = p_urb->UserBufLen;
+    if (p_urb->UserBufLen != 0u) {
+        p_hc_drv->DMA_Stat.DirectCnt++;
+    }
+
+    q_ix = (p_sim_ep->URB_Ix + p_sim_ep->URB_Cnt) % USBH_HCD_SIM_URB_Q_LEN;
+    p_sim_ep->URB_Q[q_ix]        = p_urb;
+                                                                /* See Note #1.                                         */
+    p_sim_ep->URB_StartFrm[q_ix] = p_drv_data->FrmNbr + p_drv_data->LatFrm + 1u;
+    p_sim_ep->URB_Cnt++;
+    p_sim_ep->Halt               = DEF_FALSE;
+
+    wake = p_drv_data->Idle;
+    USBH_SimDev_Unlock();
+
+    if (wake == DEF_TRUE) {                                     /* See Note #2.                                         */
+        (void)USBH_OS_SemPost(p_drv_data->FrmSem);
+    }
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimHCD_URB_Complete()
+*
+* Description : Finish a completed URB.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_urb       Pointer to URB structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   URB successfully completed.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The URB was removed from its endpoint queue by the frame task; data was transferred in
+*                   place.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_URB_Complete (USBH_HC_DRV  *p_hc_drv,
+                                        USBH_URB     *p_urb,
+                                        USBH_ERR     *p_err)
+{
+    (void)p_hc_drv;
+
+    p_urb->DMA_BufPtr = (void *)0;                              /* See Note #1.                                         */
+    p_urb->ArgPtr     = (void *)0;
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_URB_Abort()
+*
+* Description : Remove an aborted URB from its simulated endpoint queue.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_urb       Pointer to URB structure.
+*
+*               p_err       Pointer to variable that will receive the return error code from this function.
+*
+*                   USBH_ERR_NONE   URB successfully aborted.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The URBs queued after the aborted URB keep their order.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_URB_Abort (USBH_HC_DRV  *p_hc_drv,
+                                     USBH_URB     *p_urb,
+                                     USBH_ERR     *p_err)
+{
+    USBH_HCD_SIM_EP  *p_sim_ep;
+    CPU_INT08U        cnt;
+    CPU_INT08U        q_ix;
+    CPU_INT08U        nxt_ix;
+    CPU_INT08U        i;
+
+
+    (void)p_hc_drv;
+
+    p_sim_ep = (USBH_HCD_SIM_EP *)p_urb->EP_Ptr->ArgPtr;
+    if (p_sim_ep != (USBH_HCD_SIM_EP *)0) {
+        USBH_SimDev_Lock();
+        cnt = p_sim_ep->URB_Cnt;
+        for (i = 0u; i < cnt; i++) {
+            q_ix = (p_sim_ep->URB_Ix + i) % USBH_HCD_SIM_URB_Q_LEN;
+            if (p_sim_ep->URB_Q[q_ix] != p_urb) {
+                continue;
+            }
+            for (; i + 1u < cnt; i++) {                         /* See Note #1.                                         */
+                q_ix   = (p_sim_ep->URB_Ix + i)      % USBH_HCD_SIM_URB_Q_LEN;
+                nxt_ix = (p_sim_ep->URB_Ix + i + 1u) % USBH_HCD_SIM_URB_Q_LEN;
+                p_sim_ep->URB_Q[q_ix]        = p_sim_ep->URB_Q[nxt_ix];
+                p_sim_ep->URB_StartFrm[q_ix] = p_sim_ep->URB_StartFrm[nxt_ix];
+            }
+            p_sim_ep->URB_Cnt--;
+            break;
+        }
+        USBH_SimDev_Unlock();
+    }
+
+    p_urb->DMA_BufPtr = (void *)0;
+
+   *p_err = USBH_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                          ROOT HUB FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                     USBH_SimHCD_PortStatusGet()
+*
+* Description : Retrieve the status of a root hub port.
+*
+* Argument(s) : p_hc_drv        Pointer to host controller driver structure.
+*
+*               port_nbr        Port number.
+*
+*               p_port_status   Pointer to structure that will receive the port status.
+*
+* Return(s)   : DEF_OK,     if the port number is valid.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : (1) The port status is read by the core in little-endian format.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortStatusGet (USBH_HC_DRV           *p_hc_drv,
+                                                CPU_INT08U             port_nbr,
+                                                USBH_HUB_PORT_STATUS  *p_port_status)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+    USBH_SIM_PORT          *p_port;
+
+
+    if ((port_nbr == 0u) ||
+        (port_nbr >  USBH_HCD_SIM_CFG_NBR_PORTS)) {
+        return (DEF_FAIL);
+    }
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+    p_port     = &p_drv_data->PortTbl[port_nbr - 1u];
+
+    USBH_SimDev_Lock();                                         /* See Note #1.                                         */
+    MEM_VAL_SET_INT16U_LITTLE(&p_port_status->wPortStatus, p_port->Status);
+    MEM_VAL_SET_INT16U_LITTLE(&p_port_status->wPortChange, p_port->Chng);
+    USBH_SimDev_Unlock();
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_HubDescGet()
+*
+* Description : Retrieve the root hub descriptor.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               p_buf       Pointer to buffer that will receive the hub descriptor.
+*
+*               buf_len     Buffer length in octets.
+*
+* Return(s)   : DEF_OK.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_HubDescGet (USBH_HC_DRV  *p_hc_drv,
+                                             void         *p_buf,
+                                             CPU_INT08U    buf_len)
+{
+    USBH_HUB_DESC  hub_desc;
+    CPU_INT08U     desc_buf[sizeof(USBH_HUB_DESC)];
+
+
+    (void)p_hc_drv;
+
+    Mem_Clr(&hub_desc, sizeof(USBH_HUB_DESC));
+
+    hub_desc.bDescLength         = USBH_HUB_LEN_HUB_DESC;
+    hub_desc.bDescriptorType     = USBH_HUB_DESC_TYPE_HUB;
+    hub_desc.bNbrPorts           = USBH_HCD_SIM_CFG_NBR_PORTS;
+    hub_desc.wHubCharacteristics = 0x0009u;                     /* Individual pwr switching and over-current prot.      */
+    hub_desc.bPwrOn2PwrGood      = 1u;
+    hub_desc.bHubContrCurrent    = 0u;
+
+    USBH_HUB_FmtHubDesc(&hub_desc, desc_buf);
+
+    Mem_Copy(p_buf, desc_buf, DEF_MIN(buf_len, sizeof(USBH_HUB_DESC)));
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_PortEnSet()
+*
+* Description : Enable a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the port was enabled.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortEnSet (USBH_HC_DRV  *p_hc_drv,
+                                            CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_PORT_EN, DEF_TRUE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_PortEnClr()
+*
+* Description : Disable a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the port was disabled.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortEnClr (USBH_HC_DRV  *p_hc_drv,
+                                            CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_PORT_EN, DEF_FALSE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_SimHCD_PortEnChngClr()
+*
+* Description : Clear the port enable status change of a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the status change was cleared.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortEnChngClr (USBH_HC_DRV  *p_hc_drv,
+                                                CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_C_PORT_EN, DEF_FALSE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_PortPwrSet()
+*
+* Description : Power a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the port was powered.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortPwrSet (USBH_HC_DRV  *p_hc_drv,
+                                             CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_PORT_PWR, DEF_TRUE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_PortPwrClr()
+*
+* Description : Remove power from a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the port power was removed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortPwrClr (USBH_HC_DRV  *p_hc_drv,
+                                             CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_PORT_PWR, DEF_FALSE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimHCD_PortResetSet()
+*
+* Description : Reset a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the reset was started.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : (1) The reset completes on the next frame, which sets the reset status change.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortResetSet (USBH_HC_DRV  *p_hc_drv,
+                                               CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_PORT_RESET, DEF_TRUE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                    USBH_SimHCD_PortResetChngClr()
+*
+* Description : Clear the port reset status change of a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the status change was cleared.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortResetChngClr (USBH_HC_DRV  *p_hc_drv,
+                                                   CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_C_PORT_RESET, DEF_FALSE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_SimHCD_PortSuspendClr()
+*
+* Description : Resume a suspended root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the port was resumed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortSuspendClr (USBH_HC_DRV  *p_hc_drv,
+                                                 CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_PORT_SUSPEND, DEF_FALSE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                    USBH_SimHCD_PortConnChngClr()
+*
+* Description : Clear the connect status change of a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+* Return(s)   : DEF_OK,     if the status change was cleared.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortConnChngClr (USBH_HC_DRV  *p_hc_drv,
+                                                  CPU_INT08U    port_nbr)
+{
+    return (USBH_SimHCD_PortFeature(p_hc_drv, port_nbr, USBH_HUB_FEATURE_SEL_C_PORT_CONN, DEF_FALSE));
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimHCD_RHSC_IntEn()
+*
+* Description : Enable root hub port change notifications.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+* Return(s)   : DEF_OK.
+*
+* Note(s)     : (1) Pending port changes are reported on the next frame.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_RHSC_IntEn (USBH_HC_DRV  *p_hc_drv)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+
+    USBH_SimDev_Lock();
+    p_drv_data->RH_IntEn = DEF_TRUE;
+    USBH_SimDev_Unlock();
+
+    (void)USBH_OS_SemPost(p_drv_data->FrmSem);                  /* See Note #1.                                         */
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimHCD_RHSC_IntDis()
+*
+* Description : Disable root hub port change notifications.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+* Return(s)   : DEF_OK.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_RHSC_IntDis (USBH_HC_DRV  *p_hc_drv)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+
+    USBH_SimDev_Lock();
+    p_drv_data->RH_IntEn = DEF_FALSE;
+    USBH_SimDev_Unlock();
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_FrmTask()
+*
+* Description : Generate the frames of the simulated host controller.
+*
+* Argument(s) : p_arg       Pointer to driver data.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) When free-running, the task waits for a URB submission, or for at most 1 ms, after a
+*                   frame in which no transaction was acknowledged. Frames in which no interrupt endpoint is
+*                   due are skipped (see 'USBH_SimHCD_FrmSkip()  Note #1').
+*
+*               (2) Completed URBs and root hub events are given to the core after the simulation lock is
+*                   released, since the core calls back into the driver.
+*
+*               (3) The next pointer of a completed URB must be read before the URB is given to the core,
+*                   which may submit it again right away.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_FrmTask (void  *p_arg)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+    USBH_URB               *p_urb;
+    USBH_URB               *p_urb_nxt;
+    CPU_BOOLEAN             rh_event;
+    CPU_INT32U              frm_period_us;
+    CPU_BOOLEAN             idle;
+    CPU_BOOLEAN             run;
+
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_arg;
+
+    while (DEF_TRUE) {
+        USBH_SimDev_Lock();
+        frm_period_us = p_drv_data->FrmPeriodUs;
+        idle          = p_drv_data->Idle;
+        run           = p_drv_data->Run;
+        USBH_SimDev_Unlock();
+
+        if (run == DEF_FALSE) {
+            (void)USBH_OS_SemWait(p_drv_data->FrmSem, 1u);
+            continue;
+        }
+
+        if (frm_period_us != 0u) {
+            USBH_OS_DlyUS(frm_period_us);
+        } else if (idle == DEF_TRUE) {                          /* See Note #1.                                         */
+            (void)USBH_OS_SemWait(p_drv_data->FrmSem, 1u);
+            USBH_SimDev_Lock();
+            USBH_SimHCD_FrmSkip(p_drv_data);
+            USBH_SimDev_Unlock();
+        } else {
+                                                                /* Empty Else Statement                                 */
+        }
+
+        USBH_SimDev_Lock();
+        rh_event = USBH_SimHCD_FrmProc(p_drv_data);
+        p_urb    = p_drv_data->DoneHeadPtr;
+        p_drv_data->DoneHeadPtr = (USBH_URB *)0;
+        p_drv_data->DoneTailPtr = (USBH_URB *)0;
+        USBH_SimDev_Unlock();
+
+        while (p_urb != (USBH_URB *)0) {                        /* See Note #2.                                         */
+            p_urb_nxt     = (USBH_URB *)p_urb->ArgPtr;          /* See Note #3.                                         */
+            p_urb->ArgPtr = (void *)0;
+            USBH_URB_Done(p_urb);
+            p_urb = p_urb_nxt;
+        }
+
+        if (rh_event == DEF_TRUE) {
+            USBH_HUB_RH_Event(p_drv_data->HC_DrvPtr->RH_DevPtr);
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_FrmProc()
+*
+* Description : Execute the transactions of one frame.
+*
+* Argument(s) : p_drv_data  Pointer to driver data.
+*
+* Return(s)   : DEF_TRUE,   if a root hub port change must be reported to the core.
+*               DEF_FALSE,  otherwise.
+*
+* Note(s)     : (1) Must be called with the simulation lock held.
+*
+*               (2) Interrupt endpoints are served first, once per polling period. Control and bulk
+*                   endpoints then share the remaining bandwidth: each pass gives one transaction to every
+*                   endpoint with a pending URB, starting at a different endpoint on each frame. An endpoint
+*                   that NAKs is not retried before the next frame.
+*
+*               (3) Root hub port changes are reported once per enable of the notifications.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_FrmProc (USBH_HCD_SIM_DRV_DATA  *p_drv_data)
+{
+    USBH_HCD_SIM_EP  *p_sim_ep;
+    USBH_SIM_STATUS   status;
+    CPU_INT32U        bw;
+    CPU_INT32U        frm_nbr;
+    CPU_INT16U        ix;
+    CPU_INT16U        i;
+    CPU_INT08U        port_ix;
+    CPU_BOOLEAN       ack;
+    CPU_BOOLEAN       pass_ack;
+    CPU_BOOLEAN       rh_event;
+
+
+    p_drv_data->FrmNbr++;
+    p_drv_data->Stat.FrmCnt++;
+    frm_nbr = p_drv_data->FrmNbr;
+    bw      = (p_drv_data->FrmBW == 0u) ? DEF_INT_32U_MAX_VAL : p_drv_data->FrmBW;
+    ack     = DEF_FALSE;
+
+    USBH_SimDev_PortTick(p_drv_data->PortTbl,
+                         USBH_HCD_SIM_CFG_NBR_PORTS,
+                         frm_nbr);
+
+    for (ix = 0u; ix < USBH_HCD_SIM_EP_NBR; ix++) {             /* See Note #2.                                         */
+        p_sim_ep = &p_drv_data->EP_Tbl[ix];
+        if ((p_sim_ep->EP_Ptr  == (USBH_EP *)0)       ||
+            (p_sim_ep->Type    != USBH_EP_TYPE_INTR)  ||
+            (p_sim_ep->URB_Cnt == 0u)                 ||
+            ((CPU_INT32S)(frm_nbr - p_sim_ep->NxtFrm) < 0)) {
+            continue;
+        }
+
+        status = USBH_SimHCD_Xact(p_drv_data, p_sim_ep, &bw);
+        if (status == USBH_SIM_STATUS_ACK) {
+            ack = DEF_TRUE;
+        }
+        if (bw == 0u) {
+            break;
+        }
+        p_sim_ep->NxtFrm = frm_nbr + p_sim_ep->Period;
+    }
+
+    pass_ack = DEF_TRUE;
+    while ((pass_ack == DEF_TRUE) && (bw > 0u)) {
+        pass_ack = DEF_FALSE;
+        for (i = 0u; (i < USBH_HCD_SIM_EP_NBR) && (bw > 0u); i++) {
+            ix       = (p_drv_data->EP_RR_Ix + i) % USBH_HCD_SIM_EP_NBR;
+            p_sim_ep = &p_drv_data->EP_Tbl[ix];
+            if ((p_sim_ep->EP_Ptr  == (USBH_EP *)0)       ||
+                (p_sim_ep->Type    == USBH_EP_TYPE_INTR)  ||
+                (p_sim_ep->URB_Cnt == 0u)                 ||
+                (p_sim_ep->NakFrm  == frm_nbr)) {
+                continue;
+            }
+
+            status = USBH_SimHCD_Xact(p_drv_data, p_sim_ep, &bw);
+            if (status == USBH_SIM_STATUS_ACK) {
+                pass_ack = DEF_TRUE;
+                ack      = DEF_TRUE;
+            } else if (status == USBH_SIM_STATUS_NAK) {
+                p_sim_ep->NakFrm = frm_nbr;
+            } else {
+                                                                /* Empty Else Statement                                 */
+            }
+        }
+    }
+    p_drv_data->EP_RR_Ix = (p_drv_data->EP_RR_Ix + 1u) % USBH_HCD_SIM_EP_NBR;
+
+    if (bw == 0u) {
+        p_drv_data->Stat.BW_LimitCnt++;
+    }
+    p_drv_data->Idle = (ack == DEF_TRUE) ? DEF_FALSE : DEF_TRUE;
+
+    rh_event = DEF_FALSE;                                       /* See Note #3.                                         */
+    if (p_drv_data->RH_IntEn == DEF_TRUE) {
+        for (port_ix = 0u; port_ix < USBH_HCD_SIM_CFG_NBR_PORTS; port_ix++) {
+            if (p_drv_data->PortTbl[port_ix].Chng != 0u) {
+                rh_event = DEF_TRUE;
+                break;
+            }
+        }
+        if (rh_event == DEF_TRUE) {
+            p_drv_data->RH_IntEn = DEF_FALSE;
+        }
+    }
+
+    return (rh_event);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_FrmSkip()
+*
+* Description : Advance a free-running controller to the frame before the next interrupt endpoint poll.
+*
+* Argument(s) : p_drv_data  Pointer to driver data.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Frames are only skipped when interrupt URBs are the only queued URBs. The skipped
+*                   frames are not counted in the statistics and the emulated devices do not see them.
+*
+*               (2) Must be called with the simulation lock held.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_FrmSkip (USBH_HCD_SIM_DRV_DATA  *p_drv_data)
+{
+    USBH_HCD_SIM_EP  *p_sim_ep;
+    CPU_INT32U        skip;
+    CPU_INT32S        dly;
+    CPU_INT16U        ix;
+
+
+    skip = DEF_INT_32U_MAX_VAL;
+    for (ix = 0u; ix < USBH_HCD_SIM_EP_NBR; ix++) {             /* See Note #1.                                         */
+        p_sim_ep = &p_drv_data->EP_Tbl[ix];
+        if ((p_sim_ep->EP_Ptr  == (USBH_EP *)0) ||
+            (p_sim_ep->URB_Cnt == 0u)) {
+            continue;
+        }
+        if (p_sim_ep->Type != USBH_EP_TYPE_INTR) {
+            return;
+        }
+
+        dly = (CPU_INT32S)(p_sim_ep->NxtFrm - p_drv_data->FrmNbr) - 1;
+        if (dly <= 0) {
+            return;
+        }
+        skip = DEF_MIN(skip, (CPU_INT32U)dly);
+    }
+
+    if (skip != DEF_INT_32U_MAX_VAL) {
+        p_drv_data->FrmNbr += skip;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_SimHCD_Xact()
+*
+* Description : Execute the next transaction of the oldest URB queued on a simulated endpoint.
+*
+* Argument(s) : p_drv_data  Pointer to driver data.
+*
+*               p_sim_ep    Pointer to simulated endpoint.
+*
+*               p_bw        Pointer to the bandwidth left in the frame. Set to 0 when the transaction does not
+*                           fit in the frame.
+*
+* Return(s)   : USBH_SIM_STATUS_ACK,    if data was transferred.
+*               USBH_SIM_STATUS_NAK,    if the device, the URB latency or the frame bandwidth delayed the
+*                                       transaction.
+*               USBH_SIM_STATUS_STALL,  if the transaction failed.
+*
+* Note(s)     : (1) Scatter-gather segments, except the last one, are multiples of the maximum packet size
+*                   (see 'usbh_core.c  USBH_URB_SG_Prepare()  Note #1'), so a packet never spans segments.
+*
+*               (2) A device that is not reachable (disconnected or behind a disabled port) does not answer.
+*                   The URB fails as a real host controller would after its transaction retries.
+*
+*               (3) A transfer ends on a short packet or when the buffer is full. A SETUP transfer is a
+*                   single transaction.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimHCD_Xact (USBH_HCD_SIM_DRV_DATA  *p_drv_data,
+                                           USBH_HCD_SIM_EP        *p_sim_ep,
+                                           CPU_INT32U             *p_bw)
+{
+    USBH_URB         *p_urb;
+    USBH_EP          *p_ep;
+    USBH_SIM_DEV     *p_dev;
+    USBH_SG_SEG      *p_seg;
+    CPU_INT08U       *p_buf;
+    CPU_INT32U        offset;
+    CPU_INT32U        pkt_len;
+    CPU_INT32U        xfer_len;
+    CPU_INT32U        cost;
+    CPU_INT08U        ep_addr;
+    CPU_INT08U        seg_ix;
+    USBH_SIM_STATUS   status;
+    CPU_BOOLEAN       done;
+
+
+    p_urb = p_sim_ep->URB_Q[p_sim_ep->URB_Ix];
+    p_ep  = p_sim_ep->EP_Ptr;
+
+    if ((CPU_INT32S)(p_drv_data->FrmNbr - p_sim_ep->URB_StartFrm[p_sim_ep->URB_Ix]) < 0) {
+        return (USBH_SIM_STATUS_NAK);                           /* URB latency not elapsed.                             */
+    }
+
+    p_dev = USBH_SimDev_PortLookup(p_drv_data->PortTbl,
+                                   USBH_HCD_SIM_CFG_NBR_PORTS,
+                                   p_ep->DevAddr);
+    if (p_dev == (USBH_SIM_DEV *)0) {                           /* See Note #2.                                         */
+        p_drv_data->Stat.ErrCnt++;
+        USBH_SimHCD_URB_Done(p_drv_data, p_sim_ep, USBH_ERR_HC_IO);
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    offset  = p_urb->XferLen;
+    pkt_len = (p_urb->Token == USBH_TOKEN_SETUP) ? p_urb->UserBufLen
+                                                 : DEF_MIN(p_urb->UserBufLen - offset, p_sim_ep->MaxPktSize);
+    cost    = pkt_len + USBH_HCD_SIM_XACT_OVERHEAD;
+    if (cost > *p_bw) {
+       *p_bw = 0u;
+        return (USBH_SIM_STATUS_NAK);
+    }
+   *p_bw -= cost;
+
+    if (USBH_URB_IS_SG(p_urb)) {                                /* See Note #1.                                         */
+        p_seg = p_urb->SG_SegTblPtr;
+        for (seg_ix = 0u; (seg_ix + 1u < p_urb->SG_SegNbr) && (offset >= p_seg[seg_ix].BufLen); seg_ix++) {
+            offset -= p_seg[seg_ix].BufLen;
+        }
+        p_buf   = (CPU_INT08U *)p_seg[seg_ix].BufPtr + offset;
+        pkt_len = DEF_MIN(pkt_len, p_seg[seg_ix].BufLen - offset);
+    } else {
+        p_buf   = (CPU_INT08U *)p_urb->UserBufPtr + offset;
+    }
+
+    ep_addr  = p_ep->Desc.bEndpointAddress;
+    xfer_len = 0u;
+    status   = USBH_SimDev_Xact(p_dev,
+                                ep_addr,
+                                p_urb->Token,
+                                p_buf,
+                                pkt_len,
+                               &xfer_len);
+
+    switch (status) {
+        case USBH_SIM_STATUS_ACK:
+             p_drv_data->Stat.XactCnt++;
+             p_drv_data->Stat.OctetCnt += xfer_len;
+             p_urb->XferLen            += xfer_len;
+                                                                /* See Note #3.                                         */
+             done = ((p_urb->Token   == USBH_TOKEN_SETUP) ||
+                     (p_urb->XferLen >= p_urb->UserBufLen) ||
+                     ((p_urb->Token  == USBH_TOKEN_IN) && (xfer_len < pkt_len))) ? DEF_TRUE : DEF_FALSE;
+             if (done == DEF_TRUE) {
+                 USBH_SimHCD_URB_Done(p_drv_data, p_sim_ep, USBH_ERR_NONE);
+             }
+             break;
+
+        case USBH_SIM_STATUS_NAK:
+             p_drv_data->Stat.NakCnt++;
+             break;
+
+        case USBH_SIM_STATUS_STALL:
+        default:
+             p_drv_data->Stat.StallCnt++;
+             if (p_sim_ep->Type != USBH_EP_TYPE_CTRL) {
+                 p_sim_ep->Halt = DEF_TRUE;
+             }
+             USBH_SimHCD_URB_Done(p_drv_data, p_sim_ep, USBH_ERR_EP_STALL);
+             break;
+    }
+
+    return (status);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_URB_Done()
+*
+* Description : Remove the oldest URB from a simulated endpoint queue and add it to the completed URBs.
+*
+* Argument(s) : p_drv_data  Pointer to driver data.
+*
+*               p_sim_ep    Pointer to simulated endpoint.
+*
+*               err         URB completion status.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The URB is given to the core by the frame task (see USBH_SimHCD_FrmTask()).
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimHCD_URB_Done (USBH_HCD_SIM_DRV_DATA  *p_drv_data,
+                                    USBH_HCD_SIM_EP        *p_sim_ep,
+                                    USBH_ERR                err)
+{
+    USBH_URB  *p_urb;
+
+
+    p_urb = p_sim_ep->URB_Q[p_sim_ep->URB_Ix];
+    p_sim_ep->URB_Ix = (p_sim_ep->URB_Ix + 1u) % USBH_HCD_SIM_URB_Q_LEN;
+    p_sim_ep->URB_Cnt--;
+
+    p_urb->Err    = err;
+    p_urb->ArgPtr = (void *)0;
+    p_drv_data->Stat.URB_Cnt++;
+                                                                /* See Note #1.                                         */
+    if (p_drv_data->DoneHeadPtr == (USBH_URB *)0) {
+        p_drv_data->DoneHeadPtr = p_urb;
+    } else {
+        p_drv_data->DoneTailPtr->ArgPtr = (void *)p_urb;
+    }
+    p_drv_data->DoneTailPtr = p_urb;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimHCD_PortFeature()
+*
+* Description : Set or clear a feature of a root hub port.
+*
+* Argument(s) : p_hc_drv    Pointer to host controller driver structure.
+*
+*               port_nbr    Port number.
+*
+*               feature     Feature selector.
+*
+*               set         DEF_TRUE to set the feature, DEF_FALSE to clear it.
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimHCD_PortFeature (USBH_HC_DRV  *p_hc_drv,
+                                              CPU_INT08U    port_nbr,
+                                              CPU_INT16U    feature,
+                                              CPU_BOOLEAN   set)
+{
+    USBH_HCD_SIM_DRV_DATA  *p_drv_data;
+    USBH_SIM_PORT          *p_port;
+    CPU_BOOLEAN             ok;
+
+
+    if ((port_nbr == 0u) ||
+        (port_nbr >  USBH_HCD_SIM_CFG_NBR_PORTS)) {
+        return (DEF_FAIL);
+    }
+
+    p_drv_data = (USBH_HCD_SIM_DRV_DATA *)p_hc_drv->DataPtr;
+    p_port     = &p_drv_data->PortTbl[port_nbr - 1u];
+
+    USBH_SimDev_Lock();
+    if (set == DEF_TRUE) {
+        ok = USBH_SimDev_PortFeatureSet(p_port, feature);
+    } else {
+        ok = USBH_SimDev_PortFeatureClr(p_port, feature);
+    }
+    USBH_SimDev_Unlock();
+
+    return (ok);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimHCD_DataGet()
+*
+* Description : Get the driver data of a simulated host controller.
+*
+* Argument(s) : hc_nbr      Host controller number.
+*
+* Return(s)   : Pointer to driver data, if the host controller exists.
+*               0,                      otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_HCD_SIM_DRV_DATA  *USBH_SimHCD_DataGet (CPU_INT08U  hc_nbr)
+{
+    if (hc_nbr >= USBH_CFG_MAX_NBR_HC) {
+        return ((USBH_HCD_SIM_DRV_DATA *)0);
+    }
+
+    return (USBH_SimHCD_DataTbl[hc_nbr]);
+}
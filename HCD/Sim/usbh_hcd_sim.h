@@ -0,0 +1,213 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                  SIMULATED HOST CONTROLLER DRIVER
+*
+* Filename : usbh_hcd_sim.h
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) The simulated host controller runs the USB host stack against emulated devices (see
+*                'usbh_sim_dev.h') in the same process, without any USB hardware. It is intended to
+*                benchmark and test the stack on a hosted platform, together with the POSIX port of the
+*                OS abstraction layer ('OS/POSIX/usbh_os.c').
+*
+*            (2) A frame task emulates the host controller schedule. On each frame (or micro-frame, for a
+*                high-speed controller), it executes the due periodic transactions, then the control and
+*                bulk transactions in round-robin order, until the frame bandwidth is used.
+*
+*            (3) The frame period, the frame bandwidth and the latency added to each URB can be changed
+*                at run-time, to model slower or faster controllers.
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_HCD_SIM_H
+#define  USBH_HCD_SIM_H
+
+
+/*
+*********************************************************************************************************
+*                                              INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "../../Source/usbh_core.h"
+#include  "usbh_sim_dev.h"
+
+
+/*
+*********************************************************************************************************
+*                                                 EXTERNS
+*********************************************************************************************************
+*/
+
+#ifdef   USBH_HCD_SIM_MODULE
+#define  USBH_HCD_SIM_EXT
+#else
+#define  USBH_HCD_SIM_EXT  extern
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                                 DEFINES
+*
+* Note(s) : (1) The simulated host controller may be configured from 'usbh_cfg.h':
+*
+*               (a) USBH_HCD_SIM_CFG_HS_EN          DEF_ENABLED for a high-speed controller, DEF_DISABLED for
+*                                                   a full-speed controller.
+*
+*               (b) USBH_HCD_SIM_CFG_NBR_PORTS      Number of root hub ports.
+*
+*               (c) USBH_HCD_SIM_CFG_FRM_PERIOD_US  Duration of a frame, in us. 0 runs the frames back to
+*                                                   back while transfers are pending.
+*
+*               (d) USBH_HCD_SIM_CFG_FRM_BW         Octets that can be transferred per frame, including a
+*                                                   fixed overhead per transaction. 0 is unlimited.
+*
+*               (e) USBH_HCD_SIM_CFG_LAT_FRM        Nbr of frames between the submission of a URB and its
+*                                                   first transaction.
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_HCD_SIM_CFG_HS_EN
+#define  USBH_HCD_SIM_CFG_HS_EN                   DEF_ENABLED
+#endif
+
+#ifndef  USBH_HCD_SIM_CFG_NBR_PORTS
+#define  USBH_HCD_SIM_CFG_NBR_PORTS                         3u
+#endif
+
+#ifndef  USBH_HCD_SIM_CFG_FRM_PERIOD_US
+#if     (USBH_HCD_SIM_CFG_HS_EN == DEF_ENABLED)
+#define  USBH_HCD_SIM_CFG_FRM_PERIOD_US                   125u
+#else
+#define  USBH_HCD_SIM_CFG_FRM_PERIOD_US                  1000u
+#endif
+#endif
+
+#ifndef  USBH_HCD_SIM_CFG_FRM_BW
+#if     (USBH_HCD_SIM_CFG_HS_EN == DEF_ENABLED)
+#define  USBH_HCD_SIM_CFG_FRM_BW                         7500u  /* 480 Mbit/s.                                          */
+#else
+#define  USBH_HCD_SIM_CFG_FRM_BW                         1500u  /*  12 Mbit/s.                                          */
+#endif
+#endif
+
+#ifndef  USBH_HCD_SIM_CFG_LAT_FRM
+#define  USBH_HCD_SIM_CFG_LAT_FRM                           0u
+#endif
+
+#ifndef  USBH_HCD_SIM_CFG_TASK_PRIO
+#define  USBH_HCD_SIM_CFG_TASK_PRIO                        10u
+#endif
+
+#ifndef  USBH_HCD_SIM_CFG_TASK_STK_SIZE
+#define  USBH_HCD_SIM_CFG_TASK_STK_SIZE                  1024u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_hcd_sim_stat {
+    CPU_INT32U  FrmCnt;                                         /* Nbr of frames.                                       */
+    CPU_INT32U  XactCnt;                                        /* Nbr of ACK'd transactions.                           */
+    CPU_INT32U  NakCnt;                                         /* Nbr of NAK'd transactions.                           */
+    CPU_INT32U  StallCnt;                                       /* Nbr of STALL'd transactions.                         */
+    CPU_INT32U  ErrCnt;                                         /* Nbr of transactions to a missing dev.                */
+    CPU_INT32U  URB_Cnt;                                        /* Nbr of completed URBs.                               */
+    CPU_INT64U  OctetCnt;                                       /* Nbr of data octets xfer'd.                           */
+    CPU_INT32U  BW_LimitCnt;                                    /* Nbr of frames ended by the frame bandwidth.          */
+} USBH_HCD_SIM_STAT;
+
+
+/*
+*********************************************************************************************************
+*                                            GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+USBH_HCD_SIM_EXT  USBH_HC_DRV_API  USBH_SimHCD_DrvAPI;
+USBH_HCD_SIM_EXT  USBH_HC_RH_API   USBH_SimHCD_RH_API;
+
+
+/*
+*********************************************************************************************************
+*                                                 MACROS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                           FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimHCD_PortConn     (CPU_INT08U          hc_nbr,
+                                    CPU_INT08U          port_nbr,
+                                    USBH_SIM_DEV       *p_dev);
+
+USBH_ERR  USBH_SimHCD_PortDisconn  (CPU_INT08U          hc_nbr,
+                                    CPU_INT08U          port_nbr);
+
+USBH_ERR  USBH_SimHCD_FrmPeriodSet (CPU_INT08U          hc_nbr,
+                                    CPU_INT32U          frm_period_us);
+
+USBH_ERR  USBH_SimHCD_FrmBW_Set    (CPU_INT08U          hc_nbr,
+                                    CPU_INT32U          frm_bw);
+
+USBH_ERR  USBH_SimHCD_LatSet       (CPU_INT08U          hc_nbr,
+                                    CPU_INT32U          lat_frm);
+
+USBH_ERR  USBH_SimHCD_Wake         (CPU_INT08U          hc_nbr);
+
+USBH_ERR  USBH_SimHCD_StatGet      (CPU_INT08U          hc_nbr,
+                                    USBH_HCD_SIM_STAT  *p_stat);
+
+USBH_ERR  USBH_SimHCD_StatClr      (CPU_INT08U          hc_nbr);
+
+
+/*
+*********************************************************************************************************
+*                                          CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+#if     ((USBH_HCD_SIM_CFG_HS_EN != DEF_ENABLED ) && \
+         (USBH_HCD_SIM_CFG_HS_EN != DEF_DISABLED))
+#error  "USBH_HCD_SIM_CFG_HS_EN                illegally #define'd in 'usbh_cfg.h' [MUST be DEF_ENABLED || DEF_DISABLED]"
+#endif
+
+#if     ((USBH_HCD_SIM_CFG_NBR_PORTS < 1u) || \
+         (USBH_HCD_SIM_CFG_NBR_PORTS > USBH_CFG_MAX_HUB_PORTS))
+#error  "USBH_HCD_SIM_CFG_NBR_PORTS            illegally #define'd in 'usbh_cfg.h' [MUST be >= 1 && <= USBH_CFG_MAX_HUB_PORTS]"
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE END
+*********************************************************************************************************
+*/
+
+#endif
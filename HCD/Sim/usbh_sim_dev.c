@@ -0,0 +1,3770 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                  SIMULATED HOST CONTROLLER DRIVER
+*                                         EMULATED USB DEVICES
+*
+* Filename : usbh_sim_dev.c
+* Version  : V3.42.01
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  USBH_SIM_DEV_MODULE
+#include  "usbh_sim_dev.h"
+#include  <lib_mem.h>
+#include  <lib_ascii.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  USBH_SIM_DEV_ID_VENDOR                     0xF055u     /* Test vendor ID of emulated devices.                  */
+#define  USBH_SIM_DEV_ID_PRODUCT_HUB                0x0001u
+#define  USBH_SIM_DEV_ID_PRODUCT_MSC                0x0002u
+#define  USBH_SIM_DEV_ID_PRODUCT_MOUSE              0x0003u
+#define  USBH_SIM_DEV_ID_PRODUCT_KBD                0x0004u
+#define  USBH_SIM_DEV_ID_PRODUCT_ACM                0x0005u
+#define  USBH_SIM_DEV_ID_PRODUCT_UAS                0x0006u
+
+#define  USBH_SIM_FTDI_ID_VENDOR                    0x0403u     /* FT232R vendor and product IDs.                       */
+#define  USBH_SIM_FTDI_ID_PRODUCT                   0x6001u
+
+                                                                /* ---------------- CTRL XFER STATES ------------------ */
+#define  USBH_SIM_DEV_CTRL_STATE_IDLE                   0u
+#define  USBH_SIM_DEV_CTRL_STATE_DATA_IN                1u
+#define  USBH_SIM_DEV_CTRL_STATE_DATA_OUT               2u
+#define  USBH_SIM_DEV_CTRL_STATE_STATUS_IN              3u
+
+#define  USBH_SIM_DEV_LEN_SETUP_PKT                     8u
+#define  USBH_SIM_DEV_LANGID_EN_US                 0x0409u
+
+                                                                /* -------------------- MSC (BOT) --------------------- */
+#define  USBH_SIM_MSC_STATE_CBW                         0u
+#define  USBH_SIM_MSC_STATE_DATA_IN                     1u
+#define  USBH_SIM_MSC_STATE_DATA_OUT                    2u
+#define  USBH_SIM_MSC_STATE_CSW                         3u
+
+#define  USBH_SIM_MSC_EP_NBR_IN                         1u
+#define  USBH_SIM_MSC_EP_NBR_OUT                        2u
+
+#define  USBH_SIM_MSC_REQ_GET_MAX_LUN                0xFEu
+#define  USBH_SIM_MSC_REQ_BOMSR                      0xFFu
+
+#define  USBH_SIM_MSC_SIG_CBW                  0x43425355u
+#define  USBH_SIM_MSC_SIG_CSW                  0x53425355u
+#define  USBH_SIM_MSC_LEN_CBW                          31u
+#define  USBH_SIM_MSC_LEN_CSW                          13u
+
+#define  USBH_SIM_MSC_CSW_STATUS_PASSED              0x00u
+#define  USBH_SIM_MSC_CSW_STATUS_FAILED              0x01u
+#define  USBH_SIM_MSC_CSW_STATUS_PHASE_ERR           0x02u
+
+#define  USBH_SIM_SCSI_CMD_TEST_UNIT_READY           0x00u
+#define  USBH_SIM_SCSI_CMD_REQUEST_SENSE             0x03u
+#define  USBH_SIM_SCSI_CMD_INQUIRY                   0x12u
+#define  USBH_SIM_SCSI_CMD_MODE_SENSE_06             0x1Au
+#define  USBH_SIM_SCSI_CMD_START_STOP_UNIT           0x1Bu
+#define  USBH_SIM_SCSI_CMD_PREVENT_ALLOW             0x1Eu
+#define  USBH_SIM_SCSI_CMD_READ_CAPACITY_10          0x25u
+#define  USBH_SIM_SCSI_CMD_READ_10                   0x28u
+#define  USBH_SIM_SCSI_CMD_WRITE_10                  0x2Au
+#define  USBH_SIM_SCSI_CMD_VERIFY_10                 0x2Fu
+#define  USBH_SIM_SCSI_CMD_SYNC_CACHE_10             0x35u
+#define  USBH_SIM_SCSI_CMD_READ_16                   0x88u
+#define  USBH_SIM_SCSI_CMD_WRITE_16                  0x8Au
+#define  USBH_SIM_SCSI_CMD_SERVICE_ACTION_IN_16      0x9Eu
+#define  USBH_SIM_SCSI_CMD_REPORT_LUNS               0xA0u
+
+#define  USBH_SIM_SCSI_SA_READ_CAPACITY_16           0x10u
+
+#define  USBH_SIM_SCSI_VPD_PAGE_SUPPORTED            0x00u
+#define  USBH_SIM_SCSI_VPD_PAGE_BLK_LIMITS           0xB0u
+
+#define  USBH_SIM_SCSI_SENSE_KEY_NONE                0x00u
+#define  USBH_SIM_SCSI_SENSE_KEY_ILLEGAL_REQUEST     0x05u
+#define  USBH_SIM_SCSI_ASC_INVALID_CMD_OP_CODE       0x20u
+#define  USBH_SIM_SCSI_ASC_LBA_OUT_OF_RANGE          0x21u
+#define  USBH_SIM_SCSI_ASC_INVALID_FIELD_IN_CDB      0x24u
+
+                                                                /* -------------------- MSC (UAS) --------------------- */
+#define  USBH_SIM_UAS_STATE_IDLE                        0u      /* No cmd being executed.                               */
+#define  USBH_SIM_UAS_STATE_READY                       1u      /* READ READY or WRITE READY IU pending.                */
+#define  USBH_SIM_UAS_STATE_DATA_IN                     2u
+#define  USBH_SIM_UAS_STATE_DATA_OUT                    3u
+#define  USBH_SIM_UAS_STATE_SENSE                       4u      /* SENSE IU pending.                                    */
+
+#define  USBH_SIM_UAS_EP_NBR_CMD                        3u
+#define  USBH_SIM_UAS_EP_NBR_STATUS                     4u
+#define  USBH_SIM_UAS_EP_NBR_DATA_IN                    5u
+#define  USBH_SIM_UAS_EP_NBR_DATA_OUT                   6u
+
+#define  USBH_SIM_UAS_IU_ID_CMD                      0x01u
+#define  USBH_SIM_UAS_IU_ID_SENSE                    0x03u
+#define  USBH_SIM_UAS_IU_ID_READ_READY               0x06u
+#define  USBH_SIM_UAS_IU_ID_WRITE_READY              0x07u
+
+#define  USBH_SIM_UAS_LEN_CMD_IU                       32u
+#define  USBH_SIM_UAS_LEN_READY_IU                      4u
+#define  USBH_SIM_UAS_LEN_SENSE_IU                     16u      /* SENSE IU hdr, without sense data.                    */
+#define  USBH_SIM_UAS_LEN_SENSE_DATA                   18u
+
+#define  USBH_SIM_UAS_DESC_TYPE_PIPE_USAGE           0x24u
+#define  USBH_SIM_UAS_LEN_DESC_PIPE_USAGE               4u
+#define  USBH_SIM_UAS_PIPE_ID_CMD                       1u
+#define  USBH_SIM_UAS_PIPE_ID_STATUS                    2u
+#define  USBH_SIM_UAS_PIPE_ID_DATA_IN                   3u
+#define  USBH_SIM_UAS_PIPE_ID_DATA_OUT                  4u
+
+#define  USBH_SIM_SCSI_STATUS_GOOD                   0x00u
+#define  USBH_SIM_SCSI_STATUS_CHECK_CONDITION        0x02u
+
+                                                                /* ----------------------- HID ------------------------ */
+#define  USBH_SIM_HID_EP_NBR_IN                         1u
+
+#define  USBH_SIM_HID_DESC_TYPE_HID                  0x21u
+#define  USBH_SIM_HID_DESC_TYPE_REPORT               0x22u
+#define  USBH_SIM_HID_LEN_DESC_HID                      9u
+
+#define  USBH_SIM_HID_REQ_GET_REPORT                 0x01u
+#define  USBH_SIM_HID_REQ_GET_IDLE                   0x02u
+#define  USBH_SIM_HID_REQ_GET_PROTOCOL               0x03u
+#define  USBH_SIM_HID_REQ_SET_REPORT                 0x09u
+#define  USBH_SIM_HID_REQ_SET_IDLE                   0x0Au
+#define  USBH_SIM_HID_REQ_SET_PROTOCOL               0x0Bu
+
+#define  USBH_SIM_HID_LEN_REPORT_MOUSE                  3u
+#define  USBH_SIM_HID_LEN_REPORT_KBD                    8u
+#define  USBH_SIM_HID_KBD_USAGE_A                    0x04u
+
+                                                                /* --------------------- CDC ACM ---------------------- */
+#define  USBH_SIM_ACM_EP_NBR_NOTIFY                     1u
+#define  USBH_SIM_ACM_EP_NBR_DATA                       2u
+#define  USBH_SIM_ACM_MAX_PKT_SIZE                     64u
+
+#define  USBH_SIM_ACM_REQ_SET_LINE_CODING            0x20u
+#define  USBH_SIM_ACM_REQ_GET_LINE_CODING            0x21u
+#define  USBH_SIM_ACM_REQ_SET_CTRL_LINE_STATE        0x22u
+#define  USBH_SIM_ACM_REQ_SEND_BREAK                 0x23u
+
+#define  USBH_SIM_ACM_NOTIFY_SERIAL_STATE            0x20u
+#define  USBH_SIM_ACM_LEN_NOTIFY_SERIAL_STATE          10u
+#define  USBH_SIM_ACM_CTRL_LINE_STATE_DTR          0x0001u
+#define  USBH_SIM_ACM_SERIAL_STATE_DCD_DSR           0x03u
+
+                                                                /* ----------------------- FTDI ----------------------- */
+#define  USBH_SIM_FTDI_EP_NBR_IN                        1u
+#define  USBH_SIM_FTDI_EP_NBR_OUT                       2u
+#define  USBH_SIM_FTDI_LEN_STATUS                       2u
+
+#define  USBH_SIM_FTDI_REQ_RESET                     0x00u
+#define  USBH_SIM_FTDI_REQ_SET_MODEM_CTRL            0x01u
+#define  USBH_SIM_FTDI_REQ_SET_FLOW_CTRL             0x02u
+#define  USBH_SIM_FTDI_REQ_SET_BAUD_RATE             0x03u
+#define  USBH_SIM_FTDI_REQ_SET_DATA                  0x04u
+#define  USBH_SIM_FTDI_REQ_GET_MODEM_STATUS          0x05u
+#define  USBH_SIM_FTDI_REQ_SET_LAT_TMR               0x09u
+#define  USBH_SIM_FTDI_REQ_GET_LAT_TMR               0x0Au
+
+#define  USBH_SIM_FTDI_RESET_SIO                        0u
+#define  USBH_SIM_FTDI_RESET_PURGE_RX                   1u
+
+#define  USBH_SIM_FTDI_DFLT_MODEM_STATUS             0x31u      /* CTS and DSR set.                                     */
+#define  USBH_SIM_FTDI_DFLT_LINE_STATUS              0x60u      /* Tx holding and Tx shift registers empty.             */
+#define  USBH_SIM_FTDI_DFLT_LAT_TMR                    16u
+
+
+/*
+*********************************************************************************************************
+*                                               MACROS
+*********************************************************************************************************
+*/
+
+#define  USBH_SIM_DEV_HALT_BIT(ep_addr)     ((((ep_addr) & USBH_EP_DIR_MASK) == USBH_EP_DIR_IN)       \
+                                             ? DEF_BIT((((ep_addr) & 0x0Fu) + 16u))                  \
+                                             : DEF_BIT(((ep_addr) & 0x0Fu)))
+
+
+/*
+*********************************************************************************************************
+*                                             LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  const  CPU_INT08U  USBH_SimDev_HID_ReportDescMouse[] = {       /* Boot mouse report desc (HID 1.11, App. E.10). */
+    0x05u, 0x01u, 0x09u, 0x02u, 0xA1u, 0x01u, 0x09u, 0x01u,
+    0xA1u, 0x00u, 0x05u, 0x09u, 0x19u, 0x01u, 0x29u, 0x03u,
+    0x15u, 0x00u, 0x25u, 0x01u, 0x95u, 0x03u, 0x75u, 0x01u,
+    0x81u, 0x02u, 0x95u, 0x01u, 0x75u, 0x05u, 0x81u, 0x01u,
+    0x05u, 0x01u, 0x09u, 0x30u, 0x09u, 0x31u, 0x15u, 0x81u,
+    0x25u, 0x7Fu, 0x75u, 0x08u, 0x95u, 0x02u, 0x81u, 0x06u,
+    0xC0u, 0xC0u
+};
+
+static  const  CPU_INT08U  USBH_SimDev_HID_ReportDescKbd[] = {         /* Boot kbd report desc (HID 1.11, App. E.6).    */
+    0x05u, 0x01u, 0x09u, 0x06u, 0xA1u, 0x01u, 0x05u, 0x07u,
+    0x19u, 0xE0u, 0x29u, 0xE7u, 0x15u, 0x00u, 0x25u, 0x01u,
+    0x75u, 0x01u, 0x95u, 0x08u, 0x81u, 0x02u, 0x95u, 0x01u,
+    0x75u, 0x08u, 0x81u, 0x01u, 0x95u, 0x05u, 0x75u, 0x01u,
+    0x05u, 0x08u, 0x19u, 0x01u, 0x29u, 0x05u, 0x91u, 0x02u,
+    0x95u, 0x01u, 0x75u, 0x03u, 0x91u, 0x01u, 0x95u, 0x06u,
+    0x75u, 0x08u, 0x15u, 0x00u, 0x25u, 0x65u, 0x05u, 0x07u,
+    0x19u, 0x00u, 0x29u, 0x65u, 0x81u, 0x00u, 0xC0u
+};
+
+static  const  CPU_INT08U  USBH_SimDev_ACM_FnctDesc[] = {
+    0x05u, 0x24u, 0x00u, 0x10u, 0x01u,                          /* Header functional desc, CDC 1.10.                    */
+    0x05u, 0x24u, 0x01u, 0x00u, 0x01u,                          /* Call mgmt functional desc, data IF 1.                */
+    0x04u, 0x24u, 0x02u, 0x02u,                                 /* ACM functional desc, line coding & serial state.     */
+    0x05u, 0x24u, 0x06u, 0x00u, 0x01u                           /* Union functional desc, master IF 0, slave IF 1.      */
+};
+
+
+/*
+*********************************************************************************************************
+*                                        LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  USBH_HMUTEX  USBH_SimDev_LockHandle;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+                                                                /* ------------- DEVICE FRAMEWORK FUNCTIONS ----------- */
+static  void             USBH_SimDev_DevInit        (USBH_SIM_DEV            *p_dev,
+                                                     const  USBH_SIM_DEV_API *p_api,
+                                                     USBH_DEV_SPD             spd,
+                                                     CPU_INT08U               dev_class,
+                                                     CPU_INT08U               dev_protocol,
+                                                     CPU_INT16U               vid,
+                                                     CPU_INT16U               pid,
+                                                     const  CPU_CHAR         *p_product);
+
+static  void             USBH_SimDev_CfgDescAdd     (USBH_SIM_DEV            *p_dev,
+                                                     const  CPU_INT08U       *p_desc,
+                                                     CPU_INT08U               len);
+
+static  void             USBH_SimDev_IF_DescAdd     (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               if_nbr,
+                                                     CPU_INT08U               alt_nbr,
+                                                     CPU_INT08U               nbr_ep,
+                                                     CPU_INT08U               if_class,
+                                                     CPU_INT08U               if_subclass,
+                                                     CPU_INT08U               if_protocol);
+
+static  void             USBH_SimDev_EP_DescAdd     (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_addr,
+                                                     CPU_INT08U               ep_type,
+                                                     CPU_INT16U               max_pkt_size,
+                                                     CPU_INT08U               interval);
+
+static  void             USBH_SimDev_BusReset       (USBH_SIM_DEV            *p_dev);
+
+static  USBH_SIM_STATUS  USBH_SimDev_CtrlXact       (USBH_SIM_DEV            *p_dev,
+                                                     USBH_TOKEN               token,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               len,
+                                                     CPU_INT32U              *p_xfer_len);
+
+static  CPU_BOOLEAN      USBH_SimDev_ReqProc        (USBH_SIM_DEV            *p_dev);
+
+static  CPU_BOOLEAN      USBH_SimDev_StrDescGet     (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               str_ix,
+                                                     CPU_INT16U              *p_len);
+
+static  CPU_INT32U       USBH_SimDev_FIFO_Put       (USBH_SIM_FIFO           *p_fifo,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               len);
+
+static  CPU_INT32U       USBH_SimDev_FIFO_Get       (USBH_SIM_FIFO           *p_fifo,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               len);
+
+                                                                /* ---------------- EMULATED DEVICES ------------------ */
+static  CPU_BOOLEAN      USBH_SimDev_HubCtrlReq     (USBH_SIM_DEV            *p_dev,
+                                                     USBH_SETUP_REQ          *p_setup,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT16U              *p_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_HubDataIn      (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               buf_len,
+                                                     CPU_INT32U              *p_xfer_len);
+
+static  CPU_BOOLEAN      USBH_SimDev_MSC_CtrlReq    (USBH_SIM_DEV            *p_dev,
+                                                     USBH_SETUP_REQ          *p_setup,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT16U              *p_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_MSC_DataIn     (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               buf_len,
+                                                     CPU_INT32U              *p_xfer_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_MSC_DataOut    (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               len);
+
+static  void             USBH_SimDev_MSC_Reset      (USBH_SIM_DEV            *p_dev);
+
+static  void             USBH_SimDev_MSC_Frm        (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT32U               frm_nbr);
+
+static  void             USBH_SimDev_MSC_CmdProc    (USBH_SIM_MSC            *p_msc,
+                                                     CPU_INT08U              *p_cb,
+                                                     CPU_BOOLEAN              dir_in);
+
+static  CPU_BOOLEAN      USBH_SimDev_UAS_CtrlReq    (USBH_SIM_DEV            *p_dev,
+                                                     USBH_SETUP_REQ          *p_setup,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT16U              *p_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_UAS_DataIn     (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               buf_len,
+                                                     CPU_INT32U              *p_xfer_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_UAS_DataOut    (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               len);
+
+static  void             USBH_SimDev_UAS_Reset      (USBH_SIM_DEV            *p_dev);
+
+static  void             USBH_SimDev_UAS_Frm        (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT32U               frm_nbr);
+
+static  void             USBH_SimDev_UAS_CmdStart   (USBH_SIM_UAS            *p_uas);
+
+static  CPU_BOOLEAN      USBH_SimDev_HID_CtrlReq    (USBH_SIM_DEV            *p_dev,
+                                                     USBH_SETUP_REQ          *p_setup,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT16U              *p_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_HID_DataIn     (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               buf_len,
+                                                     CPU_INT32U              *p_xfer_len);
+
+static  void             USBH_SimDev_HID_Frm        (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT32U               frm_nbr);
+
+static  CPU_BOOLEAN      USBH_SimDev_ACM_CtrlReq    (USBH_SIM_DEV            *p_dev,
+                                                     USBH_SETUP_REQ          *p_setup,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT16U              *p_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_ACM_DataIn     (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               buf_len,
+                                                     CPU_INT32U              *p_xfer_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_ACM_DataOut    (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               len);
+
+static  CPU_BOOLEAN      USBH_SimDev_FTDI_CtrlReq   (USBH_SIM_DEV            *p_dev,
+                                                     USBH_SETUP_REQ          *p_setup,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT16U              *p_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_FTDI_DataIn    (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               buf_len,
+                                                     CPU_INT32U              *p_xfer_len);
+
+static  USBH_SIM_STATUS  USBH_SimDev_FTDI_DataOut   (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT08U               ep_nbr,
+                                                     CPU_INT08U              *p_buf,
+                                                     CPU_INT32U               len);
+
+static  void             USBH_SimDev_FTDI_Frm       (USBH_SIM_DEV            *p_dev,
+                                                     CPU_INT32U               frm_nbr);
+
+
+/*
+*********************************************************************************************************
+*                                     INITIALIZED GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  const  USBH_SIM_DEV_API  USBH_SimDev_HubAPI = {
+    USBH_SimDev_HubCtrlReq,
+    USBH_SimDev_HubDataIn,
+    DEF_NULL,
+    DEF_NULL,
+    DEF_NULL
+};
+
+static  const  USBH_SIM_DEV_API  USBH_SimDev_MSC_API = {
+    USBH_SimDev_MSC_CtrlReq,
+    USBH_SimDev_MSC_DataIn,
+    USBH_SimDev_MSC_DataOut,
+    USBH_SimDev_MSC_Reset,
+    USBH_SimDev_MSC_Frm
+};
+
+static  const  USBH_SIM_DEV_API  USBH_SimDev_UAS_API = {
+    USBH_SimDev_UAS_CtrlReq,
+    USBH_SimDev_UAS_DataIn,
+    USBH_SimDev_UAS_DataOut,
+    USBH_SimDev_UAS_Reset,
+    USBH_SimDev_UAS_Frm
+};
+
+static  const  USBH_SIM_DEV_API  USBH_SimDev_HID_API = {
+    USBH_SimDev_HID_CtrlReq,
+    USBH_SimDev_HID_DataIn,
+    DEF_NULL,
+    DEF_NULL,
+    USBH_SimDev_HID_Frm
+};
+
+static  const  USBH_SIM_DEV_API  USBH_SimDev_ACM_API = {
+    USBH_SimDev_ACM_CtrlReq,
+    USBH_SimDev_ACM_DataIn,
+    USBH_SimDev_ACM_DataOut,
+    DEF_NULL,
+    DEF_NULL
+};
+
+static  const  USBH_SIM_DEV_API  USBH_SimDev_FTDI_API = {
+    USBH_SimDev_FTDI_CtrlReq,
+    USBH_SimDev_FTDI_DataIn,
+    USBH_SimDev_FTDI_DataOut,
+    DEF_NULL,
+    USBH_SimDev_FTDI_Frm
+};
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           GLOBAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          USBH_SimDev_Init()
+*
+* Description : Initialize the emulated devices framework.
+*
+* Argument(s) : None.
+*
+* Return(s)   : USBH_ERR_NONE,      if the framework was successfully initialized.
+*
+*                                   ----- RETURNED BY USBH_OS_MutexCreate() : -----
+*               USBH_ERR_OS_SIGNAL_CREATE,      if mutex creation failed.
+*
+* Note(s)     : (1) Called by each simulated host controller. The simulation lock is created only once.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimDev_Init (void)
+{
+    USBH_ERR  err;
+
+
+    if (USBH_SimDev_LockHandle != (USBH_HMUTEX)0) {             /* See Note #1.                                         */
+        return (USBH_ERR_NONE);
+    }
+
+    err = USBH_OS_MutexCreate(&USBH_SimDev_LockHandle);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_SimDev_Lock()
+*
+* Description : Acquire the simulation lock.
+*
+* Argument(s) : None.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The simulation lock protects the state of all emulated devices and ports. It must
+*                   never be held while calling into the USB host stack.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_Lock (void)
+{
+    (void)USBH_OS_MutexLock(USBH_SimDev_LockHandle);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimDev_Unlock()
+*
+* Description : Release the simulation lock.
+*
+* Argument(s) : None.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_Unlock (void)
+{
+    (void)USBH_OS_MutexUnlock(USBH_SimDev_LockHandle);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_SimDev_Xact()
+*
+* Description : Perform one transaction with an emulated device.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+*               ep_addr         Endpoint address, including direction bit.
+*
+*               token           Transaction token (SETUP, IN or OUT).
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               len             Length of OUT/SETUP packet, or maximum length of IN packet.
+*
+*               p_xfer_len      Variable that will receive the number of octets transferred.
+*
+* Return(s)   : USBH_SIM_STATUS_ACK,    if the packet was transferred.
+*               USBH_SIM_STATUS_NAK,    if the device is not ready.
+*               USBH_SIM_STATUS_STALL,  if the endpoint is halted or the request is not supported.
+*
+* Note(s)     : (1) A STALL returned by a non-control endpoint halts that endpoint until the host clears
+*                   the halt feature.
+*********************************************************************************************************
+*/
+
+USBH_SIM_STATUS  USBH_SimDev_Xact (USBH_SIM_DEV  *p_dev,
+                                   CPU_INT08U     ep_addr,
+                                   USBH_TOKEN     token,
+                                   CPU_INT08U    *p_buf,
+                                   CPU_INT32U     len,
+                                   CPU_INT32U    *p_xfer_len)
+{
+    CPU_INT08U        ep_nbr;
+    CPU_INT32U        halt_bit;
+    USBH_SIM_STATUS   status;
+
+
+   *p_xfer_len = 0u;
+    ep_nbr     = ep_addr & 0x0Fu;
+
+    if (ep_nbr == 0u) {
+        status = USBH_SimDev_CtrlXact(p_dev,
+                                      token,
+                                      p_buf,
+                                      len,
+                                      p_xfer_len);
+        return (status);
+    }
+
+    halt_bit = USBH_SIM_DEV_HALT_BIT(ep_addr);
+    if ((p_dev->CfgNbr == 0u) ||
+        (DEF_BIT_IS_SET(p_dev->HaltMask, halt_bit) == DEF_YES)) {
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    if (token == USBH_TOKEN_IN) {
+        if (p_dev->API_Ptr->DataIn == DEF_NULL) {
+            status = USBH_SIM_STATUS_STALL;
+        } else {
+            status = p_dev->API_Ptr->DataIn(p_dev, ep_nbr, p_buf, len, p_xfer_len);
+        }
+    } else {
+        if (p_dev->API_Ptr->DataOut == DEF_NULL) {
+            status = USBH_SIM_STATUS_STALL;
+        } else {
+            status = p_dev->API_Ptr->DataOut(p_dev, ep_nbr, p_buf, len);
+            if (status == USBH_SIM_STATUS_ACK) {
+               *p_xfer_len = len;
+            }
+        }
+    }
+
+    if (status == USBH_SIM_STATUS_STALL) {                      /* See Note #1.                                         */
+        DEF_BIT_SET(p_dev->HaltMask, halt_bit);
+    }
+
+    return (status);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_PortLookup()
+*
+* Description : Find the enabled device with given address, below given ports.
+*
+* Argument(s) : p_port_tbl      Pointer to port table.
+*
+*               port_nbr        Number of ports in table.
+*
+*               dev_addr        Device address.
+*
+* Return(s)   : Pointer to emulated device, if found.
+*               0,                          otherwise.
+*
+* Note(s)     : (1) Downstream ports of emulated hubs are searched recursively.
+*********************************************************************************************************
+*/
+
+USBH_SIM_DEV  *USBH_SimDev_PortLookup (USBH_SIM_PORT  *p_port_tbl,
+                                       CPU_INT08U      port_nbr,
+                                       CPU_INT08U      dev_addr)
+{
+    CPU_INT08U      ix;
+    USBH_SIM_PORT  *p_port;
+    USBH_SIM_DEV   *p_dev;
+
+
+    for (ix = 0u; ix < port_nbr; ix++) {
+        p_port = &p_port_tbl[ix];
+        p_dev  =  p_port->DevPtr;
+
+        if ((p_dev == DEF_NULL) ||
+            (DEF_BIT_IS_CLR(p_port->Status, USBH_HUB_STATUS_PORT_EN)    == DEF_YES) ||
+            (DEF_BIT_IS_SET(p_port->Status, USBH_HUB_STATUS_PORT_RESET) == DEF_YES)) {
+            continue;
+        }
+
+        if (p_dev->Addr == dev_addr) {
+            return (p_dev);
+        }
+
+        if (p_dev->PortTblPtr != DEF_NULL) {                    /* See Note #1.                                         */
+            p_dev = USBH_SimDev_PortLookup(p_dev->PortTblPtr,
+                                           p_dev->PortNbr,
+                                           dev_addr);
+            if (p_dev != DEF_NULL) {
+                return (p_dev);
+            }
+        }
+    }
+
+    return (DEF_NULL);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_PortTick()
+*
+* Description : Advance the state of given ports by one frame.
+*
+* Argument(s) : p_port_tbl      Pointer to port table.
+*
+*               port_nbr        Number of ports in table.
+*
+*               frm_nbr         Current frame number.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) A port reset completes one frame after it was requested. The device is then in the
+*                   default state and the port is enabled.
+*
+*               (2) Devices behind a suspended or disabled port do not see start of frames.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_PortTick (USBH_SIM_PORT  *p_port_tbl,
+                            CPU_INT08U      port_nbr,
+                            CPU_INT32U      frm_nbr)
+{
+    CPU_INT08U      ix;
+    USBH_SIM_PORT  *p_port;
+    USBH_SIM_DEV   *p_dev;
+
+
+    for (ix = 0u; ix < port_nbr; ix++) {
+        p_port = &p_port_tbl[ix];
+        p_dev  =  p_port->DevPtr;
+
+        if (DEF_BIT_IS_SET(p_port->Status, USBH_HUB_STATUS_PORT_RESET) == DEF_YES) {
+            DEF_BIT_CLR(p_port->Status, USBH_HUB_STATUS_PORT_RESET);
+            if (p_dev != DEF_NULL) {                            /* See Note #1.                                         */
+                DEF_BIT_SET(p_port->Status, USBH_HUB_STATUS_PORT_EN);
+                USBH_SimDev_BusReset(p_dev);
+            }
+            DEF_BIT_SET(p_port->Chng, USBH_HUB_STATUS_C_PORT_RESET);
+            continue;
+        }
+
+        if ((p_dev == DEF_NULL) ||                              /* See Note #2.                                         */
+            (DEF_BIT_IS_CLR(p_port->Status, USBH_HUB_STATUS_PORT_EN)      == DEF_YES) ||
+            (DEF_BIT_IS_SET(p_port->Status, USBH_HUB_STATUS_PORT_SUSPEND) == DEF_YES)) {
+            continue;
+        }
+
+        if (p_dev->API_Ptr->Frm != DEF_NULL) {
+            p_dev->API_Ptr->Frm(p_dev, frm_nbr);
+        }
+
+        if (p_dev->PortTblPtr != DEF_NULL) {
+            USBH_SimDev_PortTick(p_dev->PortTblPtr,
+                                 p_dev->PortNbr,
+                                 frm_nbr);
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_PortConn()
+*
+* Description : Connect an emulated device to a port.
+*
+* Argument(s) : p_port          Pointer to port.
+*
+*               p_dev           Pointer to emulated device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_PortConn (USBH_SIM_PORT  *p_port,
+                            USBH_SIM_DEV   *p_dev)
+{
+    p_port->DevPtr = p_dev;
+    p_port->Status = (p_port->Status & USBH_HUB_STATUS_PORT_PWR) | USBH_HUB_STATUS_PORT_CONN;
+
+    switch (p_dev->Spd) {
+        case USBH_DEV_SPD_LOW:
+             DEF_BIT_SET(p_port->Status, USBH_HUB_STATUS_PORT_LOW_SPD);
+             break;
+
+        case USBH_DEV_SPD_HIGH:
+             DEF_BIT_SET(p_port->Status, USBH_HUB_STATUS_PORT_HIGH_SPD);
+             break;
+
+        case USBH_DEV_SPD_FULL:
+        default:
+             break;
+    }
+
+    DEF_BIT_SET(p_port->Chng, USBH_HUB_STATUS_C_PORT_CONN);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_PortDisconn()
+*
+* Description : Disconnect the emulated device connected to a port.
+*
+* Argument(s) : p_port          Pointer to port.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_PortDisconn (USBH_SIM_PORT  *p_port)
+{
+    p_port->DevPtr = DEF_NULL;
+    p_port->Status = p_port->Status & USBH_HUB_STATUS_PORT_PWR;
+
+    DEF_BIT_SET(p_port->Chng, USBH_HUB_STATUS_C_PORT_CONN);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_SimDev_PortFeatureSet()
+*
+* Description : Process a SetPortFeature request.
+*
+* Argument(s) : p_port          Pointer to port.
+*
+*               feature         Feature selector.
+*
+* Return(s)   : DEF_OK,     if the feature is supported.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : (1) The reset completes on the next frame (see USBH_SimDev_PortTick()).
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  USBH_SimDev_PortFeatureSet (USBH_SIM_PORT  *p_port,
+                                         CPU_INT16U      feature)
+{
+    switch (feature) {
+        case USBH_HUB_FEATURE_SEL_PORT_RESET:                   /* See Note #1.                                         */
+             if (DEF_BIT_IS_SET(p_port->Status, USBH_HUB_STATUS_PORT_CONN) == DEF_YES) {
+                 DEF_BIT_CLR(p_port->Status, USBH_HUB_STATUS_PORT_EN);
+                 DEF_BIT_SET(p_port->Status, USBH_HUB_STATUS_PORT_RESET);
+             }
+             break;
+
+        case USBH_HUB_FEATURE_SEL_PORT_EN:
+             if (DEF_BIT_IS_SET(p_port->Status, USBH_HUB_STATUS_PORT_CONN) == DEF_YES) {
+                 DEF_BIT_SET(p_port->Status, USBH_HUB_STATUS_PORT_EN);
+             }
+             break;
+
+        case USBH_HUB_FEATURE_SEL_PORT_SUSPEND:
+             DEF_BIT_SET(p_port->Status, USBH_HUB_STATUS_PORT_SUSPEND);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_PORT_PWR:
+             DEF_BIT_SET(p_port->Status, USBH_HUB_STATUS_PORT_PWR);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_PORT_INDICATOR:
+        case USBH_HUB_FEATURE_SEL_PORT_TEST:
+             break;
+
+        default:
+             return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_SimDev_PortFeatureClr()
+*
+* Description : Process a ClearPortFeature request.
+*
+* Argument(s) : p_port          Pointer to port.
+*
+*               feature         Feature selector.
+*
+* Return(s)   : DEF_OK,     if the feature is supported.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  USBH_SimDev_PortFeatureClr (USBH_SIM_PORT  *p_port,
+                                         CPU_INT16U      feature)
+{
+    switch (feature) {
+        case USBH_HUB_FEATURE_SEL_PORT_EN:
+             DEF_BIT_CLR(p_port->Status, USBH_HUB_STATUS_PORT_EN);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_PORT_SUSPEND:
+             DEF_BIT_CLR(p_port->Status, USBH_HUB_STATUS_PORT_SUSPEND);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_PORT_PWR:
+             DEF_BIT_CLR(p_port->Status, USBH_HUB_STATUS_PORT_PWR);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_C_PORT_CONN:
+             DEF_BIT_CLR(p_port->Chng, USBH_HUB_STATUS_C_PORT_CONN);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_C_PORT_EN:
+             DEF_BIT_CLR(p_port->Chng, USBH_HUB_STATUS_C_PORT_EN);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_C_PORT_SUSPEND:
+             DEF_BIT_CLR(p_port->Chng, USBH_HUB_STATUS_C_PORT_SUSPEND);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_C_PORT_OVER_CUR:
+             DEF_BIT_CLR(p_port->Chng, USBH_HUB_STATUS_C_PORT_OVER_CUR);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_C_PORT_RESET:
+             DEF_BIT_CLR(p_port->Chng, USBH_HUB_STATUS_C_PORT_RESET);
+             break;
+
+        case USBH_HUB_FEATURE_SEL_PORT_INDICATOR:
+             break;
+
+        default:
+             return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimDev_HubInit()
+*
+* Description : Initialize an emulated hub.
+*
+* Argument(s) : p_hub           Pointer to emulated hub.
+*
+*               spd             Hub speed, USBH_DEV_SPD_FULL or USBH_DEV_SPD_HIGH.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The downstream ports are powered by the host stack through SetPortFeature(PORT_POWER).
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_HubInit (USBH_SIM_HUB  *p_hub,
+                           USBH_DEV_SPD   spd)
+{
+    USBH_SIM_DEV  *p_dev;
+
+
+    p_dev = &p_hub->Dev;
+    USBH_SimDev_DevInit(p_dev,
+                       &USBH_SimDev_HubAPI,
+                        spd,
+                        USBH_CLASS_CODE_HUB,
+                        (spd == USBH_DEV_SPD_HIGH) ? 1u : 0u,   /* Single TT hub when high-speed.                       */
+                        USBH_SIM_DEV_ID_VENDOR,
+                        USBH_SIM_DEV_ID_PRODUCT_HUB,
+                        "Simulated Hub");
+
+    p_dev->CfgDesc[7] = 0xE0u;                                  /* Self-powered, remote wakeup.                         */
+
+    USBH_SimDev_IF_DescAdd(p_dev, 0u, 0u, 1u, USBH_CLASS_CODE_HUB, 0u, 0u);
+    USBH_SimDev_EP_DescAdd(p_dev,                               /* Status change EP, polled every 16 ms.                */
+                           0x81u,
+                           USBH_EP_TYPE_INTR,
+                           1u,
+                           (spd == USBH_DEV_SPD_HIGH) ? 8u : 16u);
+
+    Mem_Clr((void *)p_hub->PortTbl, sizeof(p_hub->PortTbl));    /* See Note #1.                                         */
+    p_dev->PortTblPtr = p_hub->PortTbl;
+    p_dev->PortNbr    = USBH_SIM_HUB_NBR_PORTS;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_HubPortConn()
+*
+* Description : Connect an emulated device to a downstream port of an emulated hub.
+*
+* Argument(s) : p_hub           Pointer to emulated hub.
+*
+*               port_nbr        Port number, starting at 1.
+*
+*               p_dev           Pointer to emulated device.
+*
+* Return(s)   : USBH_ERR_NONE,          if the device was connected.
+*               USBH_ERR_INVALID_ARG,   if the port number is invalid.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimDev_HubPortConn (USBH_SIM_HUB  *p_hub,
+                                   CPU_INT08U     port_nbr,
+                                   USBH_SIM_DEV  *p_dev)
+{
+    if ((port_nbr == 0u) ||
+        (port_nbr >  USBH_SIM_HUB_NBR_PORTS)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    USBH_SimDev_PortConn(&p_hub->PortTbl[port_nbr - 1u], p_dev);
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_SimDev_HubPortDisconn()
+*
+* Description : Disconnect the emulated device connected to a downstream port of an emulated hub.
+*
+* Argument(s) : p_hub           Pointer to emulated hub.
+*
+*               port_nbr        Port number, starting at 1.
+*
+* Return(s)   : USBH_ERR_NONE,          if the device was disconnected.
+*               USBH_ERR_INVALID_ARG,   if the port number is invalid.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimDev_HubPortDisconn (USBH_SIM_HUB  *p_hub,
+                                      CPU_INT08U     port_nbr)
+{
+    if ((port_nbr == 0u) ||
+        (port_nbr >  USBH_SIM_HUB_NBR_PORTS)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    USBH_SimDev_PortDisconn(&p_hub->PortTbl[port_nbr - 1u]);
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_MSC_Init()
+*
+* Description : Initialize an emulated mass storage device.
+*
+* Argument(s) : p_msc           Pointer to emulated mass storage device.
+*
+*               spd             Device speed, USBH_DEV_SPD_FULL or USBH_DEV_SPD_HIGH.
+*
+*               p_disk          Pointer to RAM disk of 'blk_size' * 'blk_nbr' octets.
+*
+*               blk_size        Block size, in octets.
+*
+*               blk_nbr         Number of blocks.
+*
+*               cmd_lat_frm     Command latency, in frames.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_MSC_Init (USBH_SIM_MSC  *p_msc,
+                            USBH_DEV_SPD   spd,
+                            CPU_INT08U    *p_disk,
+                            CPU_INT32U     blk_size,
+                            CPU_INT32U     blk_nbr,
+                            CPU_INT32U     cmd_lat_frm)
+{
+    USBH_SIM_DEV  *p_dev;
+    CPU_INT16U     max_pkt_size;
+
+
+    Mem_Clr((void *)p_msc, sizeof(USBH_SIM_MSC));
+
+    p_dev = &p_msc->Dev;
+    USBH_SimDev_DevInit(p_dev,
+                       &USBH_SimDev_MSC_API,
+                        spd,
+                        USBH_CLASS_CODE_USE_IF_DESC,
+                        0u,
+                        USBH_SIM_DEV_ID_VENDOR,
+                        USBH_SIM_DEV_ID_PRODUCT_MSC,
+                        "Simulated Disk");
+
+    max_pkt_size = (spd == USBH_DEV_SPD_HIGH) ? 512u : 64u;
+    USBH_SimDev_IF_DescAdd(p_dev, 0u, 0u, 2u, USBH_CLASS_CODE_MASS_STORAGE, 0x06u, 0x50u);
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_IN | USBH_SIM_MSC_EP_NBR_IN,
+                           USBH_EP_TYPE_BULK,
+                           max_pkt_size,
+                           0u);
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_OUT | USBH_SIM_MSC_EP_NBR_OUT,
+                           USBH_EP_TYPE_BULK,
+                           max_pkt_size,
+                           0u);
+
+    p_msc->DiskPtr   = p_disk;
+    p_msc->BlkSize   = blk_size;
+    p_msc->BlkNbr    = blk_nbr;
+    p_msc->CmdLatFrm = cmd_lat_frm;
+    p_msc->State     = USBH_SIM_MSC_STATE_CBW;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_UAS_Init()
+*
+* Description : Initialize an emulated USB Attached SCSI device.
+*
+* Argument(s) : p_uas           Pointer to emulated USB Attached SCSI device.
+*
+*               spd             Device speed, USBH_DEV_SPD_FULL or USBH_DEV_SPD_HIGH.
+*
+*               p_disk          Pointer to RAM disk of 'blk_size' * 'blk_nbr' octets.
+*
+*               blk_size        Block size, in octets.
+*
+*               blk_nbr         Number of blocks.
+*
+*               cmd_lat_frm     Command latency, in frames.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Alternate setting 0 is the bulk-only transport IF of the emulated mass storage device.
+*                   Alternate setting 1 follows, with a pipe usage descriptor after each endpoint
+*                   descriptor (see 'Universal Serial Bus Attached SCSI Protocol', section 5.3.3.1).
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_UAS_Init (USBH_SIM_UAS  *p_uas,
+                            USBH_DEV_SPD   spd,
+                            CPU_INT08U    *p_disk,
+                            CPU_INT32U     blk_size,
+                            CPU_INT32U     blk_nbr,
+                            CPU_INT32U     cmd_lat_frm)
+{
+    static  const  CPU_INT08U  ep_tbl[4u][2u] = {
+        { USBH_EP_DIR_OUT | USBH_SIM_UAS_EP_NBR_CMD,      USBH_SIM_UAS_PIPE_ID_CMD      },
+        { USBH_EP_DIR_IN  | USBH_SIM_UAS_EP_NBR_STATUS,   USBH_SIM_UAS_PIPE_ID_STATUS   },
+        { USBH_EP_DIR_IN  | USBH_SIM_UAS_EP_NBR_DATA_IN,  USBH_SIM_UAS_PIPE_ID_DATA_IN  },
+        { USBH_EP_DIR_OUT | USBH_SIM_UAS_EP_NBR_DATA_OUT, USBH_SIM_UAS_PIPE_ID_DATA_OUT }
+    };
+    USBH_SIM_DEV  *p_dev;
+    CPU_INT08U     pipe_desc[USBH_SIM_UAS_LEN_DESC_PIPE_USAGE];
+    CPU_INT16U     max_pkt_size;
+    CPU_INT08U     ix;
+
+
+    Mem_Clr((void *)p_uas, sizeof(USBH_SIM_UAS));
+
+    USBH_SimDev_MSC_Init(&p_uas->MSC,                           /* See Note #1.                                         */
+                          spd,
+                          p_disk,
+                          blk_size,
+                          blk_nbr,
+                          cmd_lat_frm);
+
+    p_dev              = &p_uas->MSC.Dev;
+    p_dev->API_Ptr     = &USBH_SimDev_UAS_API;
+    p_dev->DevDesc[10] = (CPU_INT08U)(USBH_SIM_DEV_ID_PRODUCT_UAS & 0xFFu);
+    p_dev->DevDesc[11] = (CPU_INT08U)(USBH_SIM_DEV_ID_PRODUCT_UAS >> 8u);
+    p_dev->StrTbl[1]   = "Simulated UAS Disk";
+
+    max_pkt_size = (spd == USBH_DEV_SPD_HIGH) ? 512u : 64u;
+    USBH_SimDev_IF_DescAdd(p_dev, 0u, 1u, 4u, USBH_CLASS_CODE_MASS_STORAGE, 0x06u, 0x62u);
+    for (ix = 0u; ix < 4u; ix++) {
+        USBH_SimDev_EP_DescAdd(p_dev,
+                               ep_tbl[ix][0],
+                               USBH_EP_TYPE_BULK,
+                               max_pkt_size,
+                               0u);
+
+        pipe_desc[0] = USBH_SIM_UAS_LEN_DESC_PIPE_USAGE;
+        pipe_desc[1] = USBH_SIM_UAS_DESC_TYPE_PIPE_USAGE;
+        pipe_desc[2] = ep_tbl[ix][1];                           /* bPipeID.                                             */
+        pipe_desc[3] = 0u;
+        USBH_SimDev_CfgDescAdd(p_dev, pipe_desc, USBH_SIM_UAS_LEN_DESC_PIPE_USAGE);
+    }
+
+    p_uas->State = USBH_SIM_UAS_STATE_IDLE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_HID_Init()
+*
+* Description : Initialize an emulated boot protocol mouse or keyboard.
+*
+* Argument(s) : p_hid               Pointer to emulated HID device.
+*
+*               type                USBH_SIM_HID_TYPE_MOUSE or USBH_SIM_HID_TYPE_KBD.
+*
+*               auto_en             DEF_ENABLED to generate reports every 'report_period_frm' frames.
+*
+*               report_period_frm   Report generation period, in frames.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_HID_Init (USBH_SIM_HID  *p_hid,
+                            CPU_INT08U     type,
+                            CPU_BOOLEAN    auto_en,
+                            CPU_INT32U     report_period_frm)
+{
+    USBH_SIM_DEV  *p_dev;
+    CPU_INT08U     hid_desc[USBH_SIM_HID_LEN_DESC_HID];
+    CPU_INT16U     report_desc_len;
+
+
+    Mem_Clr((void *)p_hid, sizeof(USBH_SIM_HID));
+
+    p_dev = &p_hid->Dev;
+    USBH_SimDev_DevInit(p_dev,
+                       &USBH_SimDev_HID_API,
+                        USBH_DEV_SPD_FULL,
+                        USBH_CLASS_CODE_USE_IF_DESC,
+                        0u,
+                        USBH_SIM_DEV_ID_VENDOR,
+                        (type == USBH_SIM_HID_TYPE_KBD) ? USBH_SIM_DEV_ID_PRODUCT_KBD
+                                                        : USBH_SIM_DEV_ID_PRODUCT_MOUSE,
+                        (type == USBH_SIM_HID_TYPE_KBD) ? "Simulated Keyboard"
+                                                        : "Simulated Mouse");
+
+    if (type == USBH_SIM_HID_TYPE_KBD) {
+        report_desc_len = sizeof(USBH_SimDev_HID_ReportDescKbd);
+        p_hid->ReportLen = USBH_SIM_HID_LEN_REPORT_KBD;
+    } else {
+        report_desc_len = sizeof(USBH_SimDev_HID_ReportDescMouse);
+        p_hid->ReportLen = USBH_SIM_HID_LEN_REPORT_MOUSE;
+    }
+
+    hid_desc[0] = USBH_SIM_HID_LEN_DESC_HID;
+    hid_desc[1] = USBH_SIM_HID_DESC_TYPE_HID;
+    hid_desc[2] = 0x11u;                                        /* bcdHID 1.11.                                         */
+    hid_desc[3] = 0x01u;
+    hid_desc[4] = 0u;                                           /* Not localized.                                       */
+    hid_desc[5] = 1u;
+    hid_desc[6] = USBH_SIM_HID_DESC_TYPE_REPORT;
+    hid_desc[7] = (CPU_INT08U)(report_desc_len & 0xFFu);
+    hid_desc[8] = (CPU_INT08U)(report_desc_len >> 8u);
+
+    USBH_SimDev_IF_DescAdd(p_dev,
+                           0u,
+                           0u,
+                           1u,
+                           USBH_CLASS_CODE_HID,
+                           0x01u,                               /* Boot IF subclass.                                    */
+                           (type == USBH_SIM_HID_TYPE_KBD) ? 0x01u : 0x02u);
+    USBH_SimDev_CfgDescAdd(p_dev, hid_desc, USBH_SIM_HID_LEN_DESC_HID);
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_IN | USBH_SIM_HID_EP_NBR_IN,
+                           USBH_EP_TYPE_INTR,
+                           USBH_SIM_HID_REPORT_LEN_MAX,
+                           1u);
+
+    p_hid->Type            = type;
+    p_hid->AutoEn          = auto_en;
+    p_hid->ReportPeriodFrm = (report_period_frm == 0u) ? 1u : report_period_frm;
+    p_hid->Protocol        = 1u;                                /* Report protocol.                                     */
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimDev_HID_ReportSet()
+*
+* Description : Supply the next input report of an emulated HID device.
+*
+* Argument(s) : p_hid           Pointer to emulated HID device.
+*
+*               p_report        Pointer to report.
+*
+*               report_len      Report length, in octets.
+*
+* Return(s)   : USBH_ERR_NONE,          if the report was set.
+*               USBH_ERR_INVALID_ARG,   if the report is too long.
+*
+* Note(s)     : (1) A report not read by the host yet is overwritten, as on a real device.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_SimDev_HID_ReportSet (USBH_SIM_HID  *p_hid,
+                                     CPU_INT08U    *p_report,
+                                     CPU_INT08U     report_len)
+{
+    if (report_len > USBH_SIM_HID_REPORT_LEN_MAX) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_SimDev_Lock();
+    Mem_Copy((void *)p_hid->Report,
+             (void *)p_report,
+                     report_len);
+    p_hid->ReportLen = report_len;
+    p_hid->ReportRdy = DEF_TRUE;                                /* See Note #1.                                         */
+    p_hid->ReportCnt++;
+    USBH_SimDev_Unlock();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_ACM_Init()
+*
+* Description : Initialize an emulated CDC ACM modem.
+*
+* Argument(s) : p_acm           Pointer to emulated ACM device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_ACM_Init (USBH_SIM_ACM  *p_acm)
+{
+    USBH_SIM_DEV  *p_dev;
+
+
+    Mem_Clr((void *)p_acm, sizeof(USBH_SIM_ACM));
+
+    p_dev = &p_acm->Dev;
+    USBH_SimDev_DevInit(p_dev,
+                       &USBH_SimDev_ACM_API,
+                        USBH_DEV_SPD_FULL,
+                        USBH_CLASS_CODE_CDC_CTRL,
+                        0u,
+                        USBH_SIM_DEV_ID_VENDOR,
+                        USBH_SIM_DEV_ID_PRODUCT_ACM,
+                        "Simulated Modem");
+
+    USBH_SimDev_IF_DescAdd(p_dev, 0u, 0u, 1u, USBH_CLASS_CODE_CDC_CTRL, 0x02u, 0x01u);
+    USBH_SimDev_CfgDescAdd(p_dev, USBH_SimDev_ACM_FnctDesc, sizeof(USBH_SimDev_ACM_FnctDesc));
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_IN | USBH_SIM_ACM_EP_NBR_NOTIFY,
+                           USBH_EP_TYPE_INTR,
+                           16u,
+                           10u);
+
+    USBH_SimDev_IF_DescAdd(p_dev, 1u, 0u, 2u, USBH_CLASS_CODE_CDC_DATA, 0u, 0u);
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_IN | USBH_SIM_ACM_EP_NBR_DATA,
+                           USBH_EP_TYPE_BULK,
+                           USBH_SIM_ACM_MAX_PKT_SIZE,
+                           0u);
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_OUT | USBH_SIM_ACM_EP_NBR_DATA,
+                           USBH_EP_TYPE_BULK,
+                           USBH_SIM_ACM_MAX_PKT_SIZE,
+                           0u);
+
+    p_acm->LineCoding[0] = 0x00u;                               /* 115200 bps, 1 stop bit, no parity, 8 data bits.      */
+    p_acm->LineCoding[1] = 0xC2u;
+    p_acm->LineCoding[2] = 0x01u;
+    p_acm->LineCoding[3] = 0x00u;
+    p_acm->LineCoding[6] = 8u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_FTDI_Init()
+*
+* Description : Initialize an emulated FTDI FT232R serial adapter.
+*
+* Argument(s) : p_ftdi          Pointer to emulated FTDI device.
+*
+*               frm_per_ms      Number of frames per ms of the simulated host controller.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+void  USBH_SimDev_FTDI_Init (USBH_SIM_FTDI  *p_ftdi,
+                             CPU_INT32U      frm_per_ms)
+{
+    USBH_SIM_DEV  *p_dev;
+
+
+    Mem_Clr((void *)p_ftdi, sizeof(USBH_SIM_FTDI));
+
+    p_dev = &p_ftdi->Dev;
+    USBH_SimDev_DevInit(p_dev,
+                       &USBH_SimDev_FTDI_API,
+                        USBH_DEV_SPD_FULL,
+                        USBH_CLASS_CODE_USE_IF_DESC,
+                        0u,
+                        USBH_SIM_FTDI_ID_VENDOR,
+                        USBH_SIM_FTDI_ID_PRODUCT,
+                        "FT232R USB UART");
+
+    p_dev->DevDesc[12] = 0x00u;                                 /* bcdDevice 6.00, as reported by the FT232R.           */
+    p_dev->DevDesc[13] = 0x06u;
+
+    USBH_SimDev_IF_DescAdd(p_dev,
+                           0u,
+                           0u,
+                           2u,
+                           USBH_CLASS_CODE_VENDOR_SPECIFIC,
+                           USBH_SUBCLASS_CODE_VENDOR_SPECIFIC,
+                           USBH_PROTOCOL_CODE_VENDOR_SPECIFIC);
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_IN | USBH_SIM_FTDI_EP_NBR_IN,
+                           USBH_EP_TYPE_BULK,
+                           64u,
+                           0u);
+    USBH_SimDev_EP_DescAdd(p_dev,
+                           USBH_EP_DIR_OUT | USBH_SIM_FTDI_EP_NBR_OUT,
+                           USBH_EP_TYPE_BULK,
+                           64u,
+                           0u);
+
+    p_ftdi->ModemStatus = USBH_SIM_FTDI_DFLT_MODEM_STATUS;
+    p_ftdi->LineStatus  = USBH_SIM_FTDI_DFLT_LINE_STATUS;
+    p_ftdi->LatTmr      = USBH_SIM_FTDI_DFLT_LAT_TMR;
+    p_ftdi->FrmPerMs    = (frm_per_ms == 0u) ? 1u : frm_per_ms;
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_DevInit()
+*
+* Description : Initialize the framework part of an emulated device.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+*               p_api           Pointer to device type API.
+*
+*               spd             Device speed.
+*
+*               dev_class       Device class code.
+*
+*               dev_protocol    Device protocol code.
+*
+*               vid             Vendor ID.
+*
+*               pid             Product ID.
+*
+*               p_product       Product string.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The configuration descriptor header is built here. Interface, endpoint and class
+*                   descriptors are appended by the device type and update 'wTotalLength'.
+*
+*               (2) The serial number string may be replaced by the application before the device is
+*                   connected, to give each instance a unique serial number.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_DevInit (USBH_SIM_DEV            *p_dev,
+                                   const  USBH_SIM_DEV_API *p_api,
+                                   USBH_DEV_SPD             spd,
+                                   CPU_INT08U               dev_class,
+                                   CPU_INT08U               dev_protocol,
+                                   CPU_INT16U               vid,
+                                   CPU_INT16U               pid,
+                                   const  CPU_CHAR         *p_product)
+{
+    CPU_INT08U  *p_desc;
+
+
+    Mem_Clr((void *)p_dev, sizeof(USBH_SIM_DEV));
+
+    p_dev->API_Ptr   = p_api;
+    p_dev->Spd       = spd;
+    p_dev->AddrPend  = USBH_SIM_DEV_ADDR_NONE;
+    p_dev->CtrlState = USBH_SIM_DEV_CTRL_STATE_IDLE;
+
+    p_desc     = p_dev->DevDesc;
+    p_desc[0]  = USBH_LEN_DESC_DEV;
+    p_desc[1]  = USBH_DESC_TYPE_DEV;
+    p_desc[2]  = 0x00u;                                         /* bcdUSB 2.00.                                         */
+    p_desc[3]  = 0x02u;
+    p_desc[4]  = dev_class;
+    p_desc[5]  = 0u;
+    p_desc[6]  = dev_protocol;
+    p_desc[7]  = (spd == USBH_DEV_SPD_LOW) ? 8u : 64u;
+    p_desc[8]  = (CPU_INT08U)(vid & 0xFFu);
+    p_desc[9]  = (CPU_INT08U)(vid >> 8u);
+    p_desc[10] = (CPU_INT08U)(pid & 0xFFu);
+    p_desc[11] = (CPU_INT08U)(pid >> 8u);
+    p_desc[12] = 0x00u;                                         /* bcdDevice 1.00.                                      */
+    p_desc[13] = 0x01u;
+    p_desc[14] = 1u;                                            /* iManufacturer.                                       */
+    p_desc[15] = 2u;                                            /* iProduct.                                            */
+    p_desc[16] = 3u;                                            /* iSerialNumber.                                       */
+    p_desc[17] = 1u;                                            /* bNumConfigurations.                                  */
+
+    p_desc    = p_dev->CfgDesc;                                 /* See Note #1.                                         */
+    p_desc[0] = USBH_LEN_DESC_CFG;
+    p_desc[1] = USBH_DESC_TYPE_CFG;
+    p_desc[2] = USBH_LEN_DESC_CFG;
+    p_desc[3] = 0u;
+    p_desc[4] = 0u;                                             /* bNumInterfaces.                                      */
+    p_desc[5] = 1u;                                             /* bConfigurationValue.                                 */
+    p_desc[6] = 0u;
+    p_desc[7] = 0x80u;                                          /* Bus-powered.                                         */
+    p_desc[8] = 50u;                                            /* 100 mA.                                              */
+    p_dev->CfgDescLen = USBH_LEN_DESC_CFG;
+
+    p_dev->StrTbl[0] = "Micrium";
+    p_dev->StrTbl[1] = p_product;
+    p_dev->StrTbl[2] = "0001";                                  /* See Note #2.                                         */
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_CfgDescAdd()
+*
+* Description : Append a descriptor to the configuration descriptor of an emulated device.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+*               p_desc          Pointer to descriptor(s).
+*
+*               len             Length of descriptor(s), in octets.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Descriptors that do not fit in USBH_SIM_DEV_CFG_DESC_LEN_MAX are dropped.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_CfgDescAdd (USBH_SIM_DEV      *p_dev,
+                                      const  CPU_INT08U *p_desc,
+                                      CPU_INT08U         len)
+{
+    if ((p_dev->CfgDescLen + len) > USBH_SIM_DEV_CFG_DESC_LEN_MAX) {
+        return;                                                 /* See Note #1.                                         */
+    }
+
+    Mem_Copy((void *)&p_dev->CfgDesc[p_dev->CfgDescLen],
+             (void *) p_desc,
+                      len);
+    p_dev->CfgDescLen += len;
+
+    p_dev->CfgDesc[2]  = (CPU_INT08U)(p_dev->CfgDescLen & 0xFFu);
+    p_dev->CfgDesc[3]  = (CPU_INT08U)(p_dev->CfgDescLen >> 8u);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_IF_DescAdd()
+*
+* Description : Append an interface descriptor to the configuration descriptor of an emulated device.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+*               if_nbr          Interface number.
+*
+*               alt_nbr         Alternate setting number (see Note #1).
+*
+*               nbr_ep          Number of endpoints.
+*
+*               if_class        Interface class code.
+*
+*               if_subclass     Interface subclass code.
+*
+*               if_protocol     Interface protocol code.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Alternate settings other than 0 are appended after alternate setting 0 of the same
+*                   interface and are not counted in bNumInterfaces.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_IF_DescAdd (USBH_SIM_DEV  *p_dev,
+                                      CPU_INT08U     if_nbr,
+                                      CPU_INT08U     alt_nbr,
+                                      CPU_INT08U     nbr_ep,
+                                      CPU_INT08U     if_class,
+                                      CPU_INT08U     if_subclass,
+                                      CPU_INT08U     if_protocol)
+{
+    CPU_INT08U  desc[USBH_LEN_DESC_IF];
+
+
+    desc[0] = USBH_LEN_DESC_IF;
+    desc[1] = USBH_DESC_TYPE_IF;
+    desc[2] = if_nbr;
+    desc[3] = alt_nbr;                                          /* bAlternateSetting.                                   */
+    desc[4] = nbr_ep;
+    desc[5] = if_class;
+    desc[6] = if_subclass;
+    desc[7] = if_protocol;
+    desc[8] = 0u;
+
+    USBH_SimDev_CfgDescAdd(p_dev, desc, USBH_LEN_DESC_IF);
+    if (alt_nbr == 0u) {                                        /* See Note #1.                                         */
+        p_dev->CfgDesc[4]++;                                    /* bNumInterfaces.                                      */
+    }
+    p_dev->AltNbr = DEF_MAX(p_dev->AltNbr, alt_nbr + 1u);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_EP_DescAdd()
+*
+* Description : Append an endpoint descriptor to the configuration descriptor of an emulated device.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+*               ep_addr         Endpoint address, including direction bit.
+*
+*               ep_type         Endpoint type.
+*
+*               max_pkt_size    Maximum packet size.
+*
+*               interval        Polling interval (bInterval).
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_EP_DescAdd (USBH_SIM_DEV  *p_dev,
+                                      CPU_INT08U     ep_addr,
+                                      CPU_INT08U     ep_type,
+                                      CPU_INT16U     max_pkt_size,
+                                      CPU_INT08U     interval)
+{
+    CPU_INT08U  desc[USBH_LEN_DESC_EP];
+
+
+    desc[0] = USBH_LEN_DESC_EP;
+    desc[1] = USBH_DESC_TYPE_EP;
+    desc[2] = ep_addr;
+    desc[3] = ep_type;
+    desc[4] = (CPU_INT08U)(max_pkt_size & 0xFFu);
+    desc[5] = (CPU_INT08U)(max_pkt_size >> 8u);
+    desc[6] = interval;
+
+    USBH_SimDev_CfgDescAdd(p_dev, desc, USBH_LEN_DESC_EP);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_BusReset()
+*
+* Description : Bring an emulated device back to the default state after a bus reset.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_BusReset (USBH_SIM_DEV  *p_dev)
+{
+    p_dev->Addr      = 0u;
+    p_dev->AddrPend  = USBH_SIM_DEV_ADDR_NONE;
+    p_dev->CfgNbr    = 0u;
+    p_dev->AltSel    = 0u;
+    p_dev->HaltMask  = 0u;
+    p_dev->CtrlState = USBH_SIM_DEV_CTRL_STATE_IDLE;
+    p_dev->CtrlStall = DEF_FALSE;
+
+    if (p_dev->API_Ptr->Reset != DEF_NULL) {
+        p_dev->API_Ptr->Reset(p_dev);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_CtrlXact()
+*
+* Description : Perform one transaction on the default endpoint of an emulated device.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+*               token           Transaction token (SETUP, IN or OUT).
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               len             Length of OUT/SETUP packet, or maximum length of IN packet.
+*
+*               p_xfer_len      Variable that will receive the number of octets transferred.
+*
+* Return(s)   : Transaction status.
+*
+* Note(s)     : (1) A SETUP packet is always acknowledged and aborts the current control transfer.
+*                   Device-to-host and no-data requests are processed when the SETUP packet is received;
+*                   host-to-device requests are processed once the whole data stage is received.
+*
+*               (2) The new device address takes effect when the status stage of SET_ADDRESS completes.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_CtrlXact (USBH_SIM_DEV  *p_dev,
+                                               USBH_TOKEN     token,
+                                               CPU_INT08U    *p_buf,
+                                               CPU_INT32U     len,
+                                               CPU_INT32U    *p_xfer_len)
+{
+    USBH_SETUP_REQ  *p_setup;
+    CPU_INT32U       n;
+    CPU_BOOLEAN      ok;
+
+
+    p_setup = &p_dev->CtrlSetup;
+
+    switch (token) {
+        case USBH_TOKEN_SETUP:                                  /* See Note #1.                                         */
+             if (len != USBH_SIM_DEV_LEN_SETUP_PKT) {
+                 return (USBH_SIM_STATUS_STALL);
+             }
+             p_setup->bmRequestType = p_buf[0];
+             p_setup->bRequest      = p_buf[1];
+             p_setup->wValue        = MEM_VAL_GET_INT16U_LITTLE(&p_buf[2]);
+             p_setup->wIndex        = MEM_VAL_GET_INT16U_LITTLE(&p_buf[4]);
+             p_setup->wLength       = MEM_VAL_GET_INT16U_LITTLE(&p_buf[6]);
+
+             p_dev->CtrlStall  = DEF_FALSE;
+             p_dev->CtrlLen    = 0u;
+             p_dev->CtrlOffset = 0u;
+
+             if ((p_setup->wLength != 0u) &&
+                 ((p_setup->bmRequestType & USBH_REQ_DIR_MASK) == USBH_REQ_DIR_HOST_TO_DEV)) {
+                 p_dev->CtrlStall = (p_setup->wLength > USBH_SIM_DEV_CTRL_BUF_LEN) ? DEF_TRUE : DEF_FALSE;
+                 p_dev->CtrlState = USBH_SIM_DEV_CTRL_STATE_DATA_OUT;
+             } else {
+                 ok               = USBH_SimDev_ReqProc(p_dev);
+                 p_dev->CtrlStall = (ok == DEF_OK) ? DEF_FALSE : DEF_TRUE;
+                 p_dev->CtrlState = (p_setup->wLength != 0u) ? USBH_SIM_DEV_CTRL_STATE_DATA_IN
+                                                             : USBH_SIM_DEV_CTRL_STATE_STATUS_IN;
+             }
+            *p_xfer_len = USBH_SIM_DEV_LEN_SETUP_PKT;
+             return (USBH_SIM_STATUS_ACK);
+
+
+        case USBH_TOKEN_OUT:
+             if (p_dev->CtrlStall == DEF_TRUE) {
+                 return (USBH_SIM_STATUS_STALL);
+             }
+
+             if (p_dev->CtrlState == USBH_SIM_DEV_CTRL_STATE_DATA_OUT) {
+                 n = DEF_MIN(len, (CPU_INT32U)(p_setup->wLength - p_dev->CtrlLen));
+                 Mem_Copy((void *)&p_dev->CtrlBuf[p_dev->CtrlLen],
+                          (void *) p_buf,
+                                   n);
+                 p_dev->CtrlLen += (CPU_INT16U)n;
+                *p_xfer_len      = len;
+
+                 if (p_dev->CtrlLen >= p_setup->wLength) {
+                     ok               = USBH_SimDev_ReqProc(p_dev);
+                     p_dev->CtrlStall = (ok == DEF_OK) ? DEF_FALSE : DEF_TRUE;
+                     p_dev->CtrlState = USBH_SIM_DEV_CTRL_STATE_STATUS_IN;
+                 }
+                 return (USBH_SIM_STATUS_ACK);
+             }
+
+             if (p_dev->CtrlState == USBH_SIM_DEV_CTRL_STATE_DATA_IN) {
+                 p_dev->CtrlState = USBH_SIM_DEV_CTRL_STATE_IDLE;   /* Status stage of device-to-host req.              */
+                 return (USBH_SIM_STATUS_ACK);
+             }
+             return (USBH_SIM_STATUS_STALL);
+
+
+        case USBH_TOKEN_IN:
+             if (p_dev->CtrlStall == DEF_TRUE) {
+                 return (USBH_SIM_STATUS_STALL);
+             }
+
+             if (p_dev->CtrlState == USBH_SIM_DEV_CTRL_STATE_DATA_IN) {
+                 n = DEF_MIN(len, (CPU_INT32U)(p_dev->CtrlLen - p_dev->CtrlOffset));
+                 Mem_Copy((void *) p_buf,
+                          (void *)&p_dev->CtrlBuf[p_dev->CtrlOffset],
+                                   n);
+                 p_dev->CtrlOffset += (CPU_INT16U)n;
+                *p_xfer_len         = n;
+                 return (USBH_SIM_STATUS_ACK);
+             }
+
+             if (p_dev->CtrlState == USBH_SIM_DEV_CTRL_STATE_STATUS_IN) {
+                 if (p_dev->AddrPend != USBH_SIM_DEV_ADDR_NONE) {   /* See Note #2.                                     */
+                     p_dev->Addr     = p_dev->AddrPend;
+                     p_dev->AddrPend = USBH_SIM_DEV_ADDR_NONE;
+                 }
+                 p_dev->CtrlState = USBH_SIM_DEV_CTRL_STATE_IDLE;
+                 return (USBH_SIM_STATUS_ACK);
+             }
+             return (USBH_SIM_STATUS_STALL);
+
+
+        default:
+             return (USBH_SIM_STATUS_STALL);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_ReqProc()
+*
+* Description : Process the request of the current control transfer.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   if the request must be stalled.
+*
+* Note(s)     : (1) Standard requests that depend on the device type (e.g. class-specific descriptors
+*                   requested with GET_DESCRIPTOR) are forwarded to the device type.
+*
+*               (2) SET_INTERFACE clears the halt condition of the endpoints and resets the device type,
+*                   which aborts any command in progress.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_ReqProc (USBH_SIM_DEV  *p_dev)
+{
+    USBH_SETUP_REQ  *p_setup;
+    CPU_INT08U       recipient;
+    CPU_INT08U       desc_type;
+    CPU_INT32U       halt_bit;
+    CPU_INT16U       len;
+    CPU_BOOLEAN      ok;
+    CPU_BOOLEAN      dir_in;
+    CPU_BOOLEAN      fwd;
+
+
+    p_setup   = &p_dev->CtrlSetup;
+    recipient =  p_setup->bmRequestType & 0x1Fu;
+    dir_in    = ((p_setup->bmRequestType & USBH_REQ_DIR_MASK) == USBH_REQ_DIR_DEV_TO_HOST) ? DEF_TRUE : DEF_FALSE;
+    len       =  dir_in ? USBH_SIM_DEV_CTRL_BUF_LEN : p_dev->CtrlLen;
+    ok        =  DEF_OK;
+    fwd       =  DEF_FALSE;
+
+    if ((p_setup->bmRequestType & USBH_REQ_TYPE_RSVD) != USBH_REQ_TYPE_STD) {
+        fwd = DEF_TRUE;
+    } else {
+        switch (p_setup->bRequest) {
+            case USBH_REQ_GET_DESC:
+                 desc_type = (CPU_INT08U)(p_setup->wValue >> 8u);
+                 if (recipient != USBH_REQ_RECIPIENT_DEV) {
+                     fwd = DEF_TRUE;                            /* See Note #1.                                         */
+                     break;
+                 }
+                 switch (desc_type) {
+                     case USBH_DESC_TYPE_DEV:
+                          Mem_Copy((void *)p_dev->CtrlBuf, (void *)p_dev->DevDesc, USBH_LEN_DESC_DEV);
+                          len = USBH_LEN_DESC_DEV;
+                          break;
+
+                     case USBH_DESC_TYPE_CFG:
+                          Mem_Copy((void *)p_dev->CtrlBuf, (void *)p_dev->CfgDesc, p_dev->CfgDescLen);
+                          len = p_dev->CfgDescLen;
+                          break;
+
+                     case USBH_DESC_TYPE_STR:
+                          ok = USBH_SimDev_StrDescGet(p_dev,
+                                                      (CPU_INT08U)(p_setup->wValue & 0xFFu),
+                                                     &len);
+                          break;
+
+                     default:
+                          fwd = DEF_TRUE;
+                          break;
+                 }
+                 break;
+
+            case USBH_REQ_SET_ADDR:
+                 p_dev->AddrPend = (CPU_INT08U)(p_setup->wValue & 0x7Fu);
+                 break;
+
+            case USBH_REQ_GET_CFG:
+                 p_dev->CtrlBuf[0] = p_dev->CfgNbr;
+                 len               = 1u;
+                 break;
+
+            case USBH_REQ_SET_CFG:
+                 if (p_setup->wValue > 1u) {
+                     ok = DEF_FAIL;
+                     break;
+                 }
+                 p_dev->CfgNbr   = (CPU_INT08U)p_setup->wValue;
+                 p_dev->AltSel   = 0u;
+                 p_dev->HaltMask = 0u;
+                 break;
+
+            case USBH_REQ_GET_STATUS:
+                 p_dev->CtrlBuf[0] = 0u;
+                 p_dev->CtrlBuf[1] = 0u;
+                 if (recipient == USBH_REQ_RECIPIENT_EP) {
+                     halt_bit = USBH_SIM_DEV_HALT_BIT(p_setup->wIndex);
+                     p_dev->CtrlBuf[0] = DEF_BIT_IS_SET(p_dev->HaltMask, halt_bit) ? 1u : 0u;
+                 }
+                 len = 2u;
+                 break;
+
+            case USBH_REQ_CLR_FEATURE:
+            case USBH_REQ_SET_FEATURE:
+                 if ((recipient         == USBH_REQ_RECIPIENT_EP) &&
+                     (p_setup->wValue   == USBH_FEATURE_SEL_EP_HALT)) {
+                     halt_bit = USBH_SIM_DEV_HALT_BIT(p_setup->wIndex);
+                     if (p_setup->bRequest == USBH_REQ_CLR_FEATURE) {
+                         DEF_BIT_CLR(p_dev->HaltMask, halt_bit);
+                     } else {
+                         DEF_BIT_SET(p_dev->HaltMask, halt_bit);
+                     }
+                 }
+                 break;
+
+            case USBH_REQ_GET_IF:
+                 p_dev->CtrlBuf[0] = p_dev->AltSel;
+                 len               = 1u;
+                 break;
+
+            case USBH_REQ_SET_IF:
+                 if (p_setup->wValue >= p_dev->AltNbr) {
+                     ok = DEF_FAIL;
+                     break;
+                 }
+                 p_dev->AltSel   = (CPU_INT08U)p_setup->wValue; /* See Note #2.                                         */
+                 p_dev->HaltMask =  0u;
+                 if (p_dev->API_Ptr->Reset != DEF_NULL) {
+                     p_dev->API_Ptr->Reset(p_dev);
+                 }
+                 break;
+
+            default:
+                 fwd = DEF_TRUE;
+                 break;
+        }
+    }
+
+    if (fwd == DEF_TRUE) {
+        if (p_dev->API_Ptr->CtrlReq == DEF_NULL) {
+            return (DEF_FAIL);
+        }
+        ok = p_dev->API_Ptr->CtrlReq(p_dev, p_setup, p_dev->CtrlBuf, &len);
+    }
+
+    if ((ok == DEF_OK) && (dir_in == DEF_TRUE)) {
+        p_dev->CtrlLen = DEF_MIN(len, p_setup->wLength);
+    }
+
+    return (ok);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_StrDescGet()
+*
+* Description : Build a string descriptor in the data stage buffer of an emulated device.
+*
+* Argument(s) : p_dev           Pointer to emulated device.
+*
+*               str_ix          String index. Index 0 returns the supported language IDs.
+*
+*               p_len           Variable that will receive the descriptor length.
+*
+* Return(s)   : DEF_OK,     if the string exists.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_StrDescGet (USBH_SIM_DEV  *p_dev,
+                                             CPU_INT08U     str_ix,
+                                             CPU_INT16U    *p_len)
+{
+    const  CPU_CHAR  *p_str;
+    CPU_INT16U        ix;
+
+
+    if (str_ix == 0u) {
+        p_dev->CtrlBuf[0] = 4u;
+        p_dev->CtrlBuf[1] = USBH_DESC_TYPE_STR;
+        p_dev->CtrlBuf[2] = (CPU_INT08U)(USBH_SIM_DEV_LANGID_EN_US & 0xFFu);
+        p_dev->CtrlBuf[3] = (CPU_INT08U)(USBH_SIM_DEV_LANGID_EN_US >> 8u);
+       *p_len             = 4u;
+        return (DEF_OK);
+    }
+
+    if (str_ix > USBH_SIM_DEV_STR_NBR_MAX) {
+        return (DEF_FAIL);
+    }
+
+    p_str = p_dev->StrTbl[str_ix - 1u];
+    if (p_str == DEF_NULL) {
+        return (DEF_FAIL);
+    }
+
+    ix = 2u;
+    while ((*p_str != ASCII_CHAR_NULL) &&                       /* Convert to UTF-16LE.                                 */
+           (ix     <  (USBH_SIM_DEV_CTRL_BUF_LEN - 2u))) {
+        p_dev->CtrlBuf[ix]      = (CPU_INT08U)*p_str;
+        p_dev->CtrlBuf[ix + 1u] = 0u;
+        ix += 2u;
+        p_str++;
+    }
+
+    p_dev->CtrlBuf[0] = (CPU_INT08U)ix;
+    p_dev->CtrlBuf[1] = USBH_DESC_TYPE_STR;
+   *p_len             = ix;
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_FIFO_Put()
+*
+* Description : Write data to a loopback FIFO.
+*
+* Argument(s) : p_fifo          Pointer to FIFO.
+*
+*               p_buf           Pointer to data.
+*
+*               len             Number of octets to write.
+*
+* Return(s)   : Number of octets written.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_SimDev_FIFO_Put (USBH_SIM_FIFO  *p_fifo,
+                                          CPU_INT08U     *p_buf,
+                                          CPU_INT32U      len)
+{
+    CPU_INT32U  n;
+    CPU_INT32U  ix;
+
+
+    n = DEF_MIN(len, USBH_SIM_FIFO_LEN - p_fifo->Cnt);
+    for (ix = 0u; ix < n; ix++) {
+        p_fifo->Buf[p_fifo->InIx] = p_buf[ix];
+        p_fifo->InIx              = (p_fifo->InIx + 1u) % USBH_SIM_FIFO_LEN;
+    }
+    p_fifo->Cnt += n;
+
+    return (n);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_FIFO_Get()
+*
+* Description : Read data from a loopback FIFO.
+*
+* Argument(s) : p_fifo          Pointer to FIFO.
+*
+*               p_buf           Pointer to destination buffer.
+*
+*               len             Maximum number of octets to read.
+*
+* Return(s)   : Number of octets read.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  USBH_SimDev_FIFO_Get (USBH_SIM_FIFO  *p_fifo,
+                                          CPU_INT08U     *p_buf,
+                                          CPU_INT32U      len)
+{
+    CPU_INT32U  n;
+    CPU_INT32U  ix;
+
+
+    n = DEF_MIN(len, p_fifo->Cnt);
+    for (ix = 0u; ix < n; ix++) {
+        p_buf[ix]     = p_fifo->Buf[p_fifo->OutIx];
+        p_fifo->OutIx = (p_fifo->OutIx + 1u) % USBH_SIM_FIFO_LEN;
+    }
+    p_fifo->Cnt -= n;
+
+    return (n);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_HubCtrlReq()
+*
+* Description : Process a hub class request.
+*
+* Argument(s) : p_dev           Pointer to emulated hub.
+*
+*               p_setup         Pointer to setup request.
+*
+*               p_buf           Pointer to data stage buffer.
+*
+*               p_len           Data stage length (see 'usbh_sim_dev.h  DEVICE TYPE API  Note #1').
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : (1) The hub descriptor is returned in the format of the USB 2.0 specification, section
+*                   11.23.2.1.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_HubCtrlReq (USBH_SIM_DEV    *p_dev,
+                                             USBH_SETUP_REQ  *p_setup,
+                                             CPU_INT08U      *p_buf,
+                                             CPU_INT16U      *p_len)
+{
+    USBH_SIM_PORT  *p_port;
+    CPU_INT08U      recipient;
+
+
+    if ((p_setup->bmRequestType & USBH_REQ_TYPE_RSVD) != USBH_REQ_TYPE_CLASS) {
+        return (DEF_FAIL);
+    }
+
+    recipient = p_setup->bmRequestType & 0x1Fu;
+
+    if (recipient == USBH_REQ_RECIPIENT_DEV) {
+        switch (p_setup->bRequest) {
+            case USBH_REQ_GET_DESC:                             /* See Note #1.                                         */
+                 p_buf[0] = 9u;
+                 p_buf[1] = USBH_HUB_DESC_TYPE_HUB;
+                 p_buf[2] = USBH_SIM_HUB_NBR_PORTS;
+                 p_buf[3] = 0x09u;                              /* Individual pwr switching and over-current prot.      */
+                 p_buf[4] = 0x00u;
+                 p_buf[5] = 5u;                                 /* bPwrOn2PwrGood, 10 ms.                               */
+                 p_buf[6] = 0u;                                 /* bHubContrCurrent.                                    */
+                 p_buf[7] = 0x00u;                              /* All ports removable.                                 */
+                 p_buf[8] = 0xFFu;                              /* PortPwrCtrlMask.                                     */
+                *p_len    = 9u;
+                 return (DEF_OK);
+
+            case USBH_REQ_GET_STATUS:
+                 Mem_Clr((void *)p_buf, USBH_HUB_LEN_HUB_STATUS);
+                *p_len = USBH_HUB_LEN_HUB_STATUS;
+                 return (DEF_OK);
+
+            case USBH_REQ_CLR_FEATURE:
+            case USBH_REQ_SET_FEATURE:
+                 return (DEF_OK);
+
+            default:
+                 return (DEF_FAIL);
+        }
+    }
+
+    if ((recipient       != USBH_REQ_RECIPIENT_OTHER) ||
+        (p_setup->wIndex == 0u)                       ||
+        (p_setup->wIndex >  p_dev->PortNbr)) {
+        return (DEF_FAIL);
+    }
+
+    p_port = &p_dev->PortTblPtr[p_setup->wIndex - 1u];
+
+    switch (p_setup->bRequest) {
+        case USBH_REQ_GET_STATUS:
+             MEM_VAL_SET_INT16U_LITTLE(&p_buf[0], p_port->Status);
+             MEM_VAL_SET_INT16U_LITTLE(&p_buf[2], p_port->Chng);
+            *p_len = USBH_HUB_LEN_HUB_PORT_STATUS;
+             return (DEF_OK);
+
+        case USBH_REQ_SET_FEATURE:
+             return (USBH_SimDev_PortFeatureSet(p_port, p_setup->wValue));
+
+        case USBH_REQ_CLR_FEATURE:
+             return (USBH_SimDev_PortFeatureClr(p_port, p_setup->wValue));
+
+        default:
+             return (DEF_FAIL);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_HubDataIn()
+*
+* Description : Return the status change bitmap of an emulated hub.
+*
+* Argument(s) : p_dev           Pointer to emulated hub.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               buf_len         Packet buffer length.
+*
+*               p_xfer_len      Variable that will receive the number of octets returned.
+*
+* Return(s)   : USBH_SIM_STATUS_ACK, if a port status changed.
+*               USBH_SIM_STATUS_NAK, otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_HubDataIn (USBH_SIM_DEV  *p_dev,
+                                                CPU_INT08U     ep_nbr,
+                                                CPU_INT08U    *p_buf,
+                                                CPU_INT32U     buf_len,
+                                                CPU_INT32U    *p_xfer_len)
+{
+    CPU_INT08U  bitmap;
+    CPU_INT08U  ix;
+
+
+    (void)ep_nbr;
+
+    bitmap = 0u;
+    for (ix = 0u; ix < p_dev->PortNbr; ix++) {
+        if (p_dev->PortTblPtr[ix].Chng != 0u) {
+            DEF_BIT_SET(bitmap, DEF_BIT(ix + 1u));
+        }
+    }
+
+    if ((bitmap == 0u) || (buf_len == 0u)) {
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    p_buf[0]    = bitmap;
+   *p_xfer_len  = 1u;
+
+    return (USBH_SIM_STATUS_ACK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_MSC_CtrlReq()
+*
+* Description : Process a mass storage class request.
+*
+* Argument(s) : p_dev           Pointer to emulated mass storage device.
+*
+*               p_setup         Pointer to setup request.
+*
+*               p_buf           Pointer to data stage buffer.
+*
+*               p_len           Data stage length.
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_MSC_CtrlReq (USBH_SIM_DEV    *p_dev,
+                                              USBH_SETUP_REQ  *p_setup,
+                                              CPU_INT08U      *p_buf,
+                                              CPU_INT16U      *p_len)
+{
+    if ((p_setup->bmRequestType & USBH_REQ_TYPE_RSVD) != USBH_REQ_TYPE_CLASS) {
+        return (DEF_FAIL);
+    }
+
+    switch (p_setup->bRequest) {
+        case USBH_SIM_MSC_REQ_GET_MAX_LUN:
+             p_buf[0] = 0u;                                     /* Single LUN.                                          */
+            *p_len    = 1u;
+             return (DEF_OK);
+
+        case USBH_SIM_MSC_REQ_BOMSR:
+             USBH_SimDev_MSC_Reset(p_dev);
+             return (DEF_OK);
+
+        default:
+             return (DEF_FAIL);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_MSC_DataIn()
+*
+* Description : Return the next IN packet of the data or status stage of the current command.
+*
+* Argument(s) : p_dev           Pointer to emulated mass storage device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               buf_len         Packet buffer length.
+*
+*               p_xfer_len      Variable that will receive the number of octets returned.
+*
+* Return(s)   : Transaction status.
+*
+* Note(s)     : (1) When the device has less data than requested by the host, it ends the data stage by
+*                   stalling the bulk IN endpoint. The host clears the halt and reads the CSW.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_MSC_DataIn (USBH_SIM_DEV  *p_dev,
+                                                 CPU_INT08U     ep_nbr,
+                                                 CPU_INT08U    *p_buf,
+                                                 CPU_INT32U     buf_len,
+                                                 CPU_INT32U    *p_xfer_len)
+{
+    USBH_SIM_MSC  *p_msc;
+    CPU_INT32U     n;
+
+
+    p_msc = (USBH_SIM_MSC *)p_dev;
+
+    if (ep_nbr != USBH_SIM_MSC_EP_NBR_IN) {
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    if (p_msc->LatCnt > 0u) {
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    switch (p_msc->State) {
+        case USBH_SIM_MSC_STATE_DATA_IN:
+             if (p_msc->DataXferLen >= p_msc->DataAvail) {      /* See Note #1.                                         */
+                 p_msc->State = USBH_SIM_MSC_STATE_CSW;
+                 return (USBH_SIM_STATUS_STALL);
+             }
+
+             n = DEF_MIN(buf_len, p_msc->DataAvail - p_msc->DataXferLen);
+             Mem_Copy((void *) p_buf,
+                      (void *)&p_msc->DataPtr[p_msc->DataXferLen],
+                               n);
+             p_msc->DataXferLen += n;
+            *p_xfer_len          = n;
+
+             if (p_msc->DataXferLen >= p_msc->DataLen) {
+                 p_msc->State = USBH_SIM_MSC_STATE_CSW;
+             } else if ((p_msc->DataXferLen >= p_msc->DataAvail) &&
+                        (n                  <  buf_len)) {
+                 p_msc->State = USBH_SIM_MSC_STATE_CSW;         /* Short pkt ends the data stage.                       */
+             }
+             return (USBH_SIM_STATUS_ACK);
+
+
+        case USBH_SIM_MSC_STATE_CSW:
+             if (buf_len < USBH_SIM_MSC_LEN_CSW) {
+                 return (USBH_SIM_STATUS_STALL);
+             }
+             MEM_VAL_SET_INT32U_LITTLE(&p_buf[0], USBH_SIM_MSC_SIG_CSW);
+             MEM_VAL_SET_INT32U_LITTLE(&p_buf[4], p_msc->Tag);
+             MEM_VAL_SET_INT32U_LITTLE(&p_buf[8], p_msc->DataLen - p_msc->DataXferLen);
+             p_buf[12]    = p_msc->CSW_Status;
+            *p_xfer_len   = USBH_SIM_MSC_LEN_CSW;
+             p_msc->State = USBH_SIM_MSC_STATE_CBW;
+             return (USBH_SIM_STATUS_ACK);
+
+
+        case USBH_SIM_MSC_STATE_CBW:
+        case USBH_SIM_MSC_STATE_DATA_OUT:
+        default:
+             return (USBH_SIM_STATUS_NAK);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_MSC_DataOut()
+*
+* Description : Process an OUT packet of a CBW or of the data stage of the current command.
+*
+* Argument(s) : p_dev           Pointer to emulated mass storage device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet.
+*
+*               len             Packet length.
+*
+* Return(s)   : Transaction status.
+*
+* Note(s)     : (1) An invalid CBW halts both bulk endpoints until a reset recovery.
+*
+*               (2) Data beyond the end of the media is accepted and discarded.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_MSC_DataOut (USBH_SIM_DEV  *p_dev,
+                                                  CPU_INT08U     ep_nbr,
+                                                  CPU_INT08U    *p_buf,
+                                                  CPU_INT32U     len)
+{
+    USBH_SIM_MSC  *p_msc;
+    CPU_INT32U     n;
+    CPU_BOOLEAN    dir_in;
+
+
+    p_msc = (USBH_SIM_MSC *)p_dev;
+
+    if (ep_nbr != USBH_SIM_MSC_EP_NBR_OUT) {
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    switch (p_msc->State) {
+        case USBH_SIM_MSC_STATE_CBW:
+             if ((len                             != USBH_SIM_MSC_LEN_CBW) ||
+                 (MEM_VAL_GET_INT32U_LITTLE(p_buf) != USBH_SIM_MSC_SIG_CBW)) {
+                 DEF_BIT_SET(p_dev->HaltMask,                   /* See Note #1.                                         */
+                             USBH_SIM_DEV_HALT_BIT(USBH_EP_DIR_IN | USBH_SIM_MSC_EP_NBR_IN));
+                 return (USBH_SIM_STATUS_STALL);
+             }
+
+             p_msc->Tag         = MEM_VAL_GET_INT32U_LITTLE(&p_buf[4]);
+             p_msc->DataLen     = MEM_VAL_GET_INT32U_LITTLE(&p_buf[8]);
+             p_msc->DataXferLen = 0u;
+             p_msc->DataAvail   = 0u;
+             p_msc->DataPtr     = p_msc->RespBuf;
+             p_msc->LatCnt      = p_msc->CmdLatFrm;
+             dir_in             = DEF_BIT_IS_SET(p_buf[12], DEF_BIT_07);
+
+             USBH_SimDev_MSC_CmdProc(p_msc, &p_buf[15], dir_in);
+             return (USBH_SIM_STATUS_ACK);
+
+
+        case USBH_SIM_MSC_STATE_DATA_OUT:
+             if (p_msc->LatCnt > 0u) {
+                 return (USBH_SIM_STATUS_NAK);
+             }
+
+             if (p_msc->DataXferLen < p_msc->DataAvail) {       /* See Note #2.                                         */
+                 n = DEF_MIN(len, p_msc->DataAvail - p_msc->DataXferLen);
+                 Mem_Copy((void *)&p_msc->DataPtr[p_msc->DataXferLen],
+                          (void *) p_buf,
+                                   n);
+             }
+             p_msc->DataXferLen += len;
+
+             if (p_msc->DataXferLen >= p_msc->DataLen) {
+                 p_msc->DataXferLen = p_msc->DataLen;
+                 p_msc->State       = USBH_SIM_MSC_STATE_CSW;
+             }
+             return (USBH_SIM_STATUS_ACK);
+
+
+        case USBH_SIM_MSC_STATE_DATA_IN:
+        case USBH_SIM_MSC_STATE_CSW:
+        default:
+             return (USBH_SIM_STATUS_STALL);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_MSC_Reset()
+*
+* Description : Reset the bulk-only transport state of an emulated mass storage device.
+*
+* Argument(s) : p_dev           Pointer to emulated mass storage device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Halted endpoints stay halted; the host clears them as part of the reset recovery.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_MSC_Reset (USBH_SIM_DEV  *p_dev)
+{
+    USBH_SIM_MSC  *p_msc;
+
+
+    p_msc              = (USBH_SIM_MSC *)p_dev;
+    p_msc->State       = USBH_SIM_MSC_STATE_CBW;
+    p_msc->LatCnt      = 0u;
+    p_msc->DataLen     = 0u;
+    p_msc->DataXferLen = 0u;
+    p_msc->DataAvail   = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimDev_MSC_Frm()
+*
+* Description : Count down the latency of the current command of an emulated mass storage device.
+*
+* Argument(s) : p_dev           Pointer to emulated mass storage device.
+*
+*               frm_nbr         Current frame number.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_MSC_Frm (USBH_SIM_DEV  *p_dev,
+                                   CPU_INT32U     frm_nbr)
+{
+    USBH_SIM_MSC  *p_msc;
+
+
+    (void)frm_nbr;
+
+    p_msc = (USBH_SIM_MSC *)p_dev;
+    if (p_msc->LatCnt > 0u) {
+        p_msc->LatCnt--;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_MSC_CmdProc()
+*
+* Description : Execute the SCSI command of a CBW and prepare its data and status stages.
+*
+* Argument(s) : p_msc           Pointer to emulated mass storage device.
+*
+*               p_cb            Pointer to command block.
+*
+*               dir_in          DEF_TRUE if the CBW data stage is device-to-host.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) A data stage in the direction opposite to the one the command requires is a phase
+*                   error (see 'Universal Serial Bus Mass Storage Class Bulk-Only Transport', section
+*                   6.7). The device stalls the data stage endpoint.
+*
+*               (2) When a command fails, no data is returned. An IN data stage is stalled and an OUT data
+*                   stage is stalled, so that the host proceeds to the status stage.
+*
+*               (3) The device claims SPC-3 compliance and supports the Supported VPD Pages and Block Limits
+*                   VPD pages.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_MSC_CmdProc (USBH_SIM_MSC  *p_msc,
+                                       CPU_INT08U    *p_cb,
+                                       CPU_BOOLEAN    dir_in)
+{
+    CPU_INT08U   *p_resp;
+    CPU_INT32U    lba;
+    CPU_INT32U    lba_msb;
+    CPU_INT32U    blk_cnt;
+    CPU_INT32U    len;
+    CPU_BOOLEAN   cmd_dir_in;
+    CPU_INT32U    halt_bit;
+    CPU_INT08U    asc;
+
+
+    p_resp            = p_msc->RespBuf;
+    p_msc->CSW_Status = USBH_SIM_MSC_CSW_STATUS_PASSED;
+    cmd_dir_in        = DEF_TRUE;
+    len               = 0u;
+    asc               = 0u;
+
+    switch (p_cb[0]) {
+        case USBH_SIM_SCSI_CMD_TEST_UNIT_READY:
+        case USBH_SIM_SCSI_CMD_START_STOP_UNIT:
+        case USBH_SIM_SCSI_CMD_PREVENT_ALLOW:
+        case USBH_SIM_SCSI_CMD_VERIFY_10:
+        case USBH_SIM_SCSI_CMD_SYNC_CACHE_10:
+             break;
+
+        case USBH_SIM_SCSI_CMD_REQUEST_SENSE:
+             Mem_Clr((void *)p_resp, 18u);
+             p_resp[0]       = 0x70u;                           /* Current error, fixed format.                         */
+             p_resp[2]       = p_msc->SenseKey;
+             p_resp[7]       = 10u;
+             p_resp[12]      = p_msc->ASC;
+             p_resp[13]      = p_msc->ASCQ;
+             len             = 18u;
+             p_msc->SenseKey = USBH_SIM_SCSI_SENSE_KEY_NONE;
+             p_msc->ASC      = 0u;
+             p_msc->ASCQ     = 0u;
+             break;
+
+        case USBH_SIM_SCSI_CMD_INQUIRY:
+                                                                /* VPD page (see Note #3).                              */
+             if (DEF_BIT_IS_SET(p_cb[1], DEF_BIT_00) == DEF_YES) {
+                 Mem_Clr((void *)p_resp, sizeof(p_msc->RespBuf));
+                 p_resp[1] = p_cb[2];
+                 if (p_cb[2] == USBH_SIM_SCSI_VPD_PAGE_SUPPORTED) {
+                     p_resp[3] = 2u;
+                     p_resp[4] = USBH_SIM_SCSI_VPD_PAGE_SUPPORTED;
+                     p_resp[5] = USBH_SIM_SCSI_VPD_PAGE_BLK_LIMITS;
+                     len       = 6u;
+                 } else if (p_cb[2] == USBH_SIM_SCSI_VPD_PAGE_BLK_LIMITS) {
+                     p_resp[3] = 0x3Cu;
+                     MEM_VAL_SET_INT32U_BIG(&p_resp[8], p_msc->XferBlkMax);
+                     len       = 64u;
+                 } else {
+                     asc       = USBH_SIM_SCSI_ASC_INVALID_FIELD_IN_CDB;
+                 }
+                 break;
+             }
+             Mem_Clr((void *)p_resp, 36u);
+             p_resp[0] = 0x00u;                                 /* Direct access block dev.                             */
+             p_resp[1] = 0x80u;                                 /* Removable media.                                     */
+             p_resp[2] = 0x05u;                                 /* SPC-3.                                               */
+             p_resp[3] = 0x02u;
+             p_resp[4] = 31u;
+             Mem_Copy((void *)&p_resp[8],  (void *)"Micrium ",         8u);
+             Mem_Copy((void *)&p_resp[16], (void *)"Simulated Disk  ", 16u);
+             Mem_Copy((void *)&p_resp[32], (void *)"1.00",             4u);
+             len = 36u;
+             break;
+
+        case USBH_SIM_SCSI_CMD_MODE_SENSE_06:
+             Mem_Clr((void *)p_resp, 4u);
+             p_resp[0] = 3u;                                    /* Mode data len, no blk desc, not write protected.     */
+             len       = 4u;
+             break;
+
+        case USBH_SIM_SCSI_CMD_READ_CAPACITY_10:
+             MEM_VAL_SET_INT32U_BIG(&p_resp[0], p_msc->BlkNbr - 1u);
+             MEM_VAL_SET_INT32U_BIG(&p_resp[4], p_msc->BlkSize);
+             len = 8u;
+             break;
+
+        case USBH_SIM_SCSI_CMD_REPORT_LUNS:
+             Mem_Clr((void *)p_resp, 16u);
+             p_resp[3] = 8u;                                    /* LUN list len: LUN 0 only.                            */
+             len       = 16u;
+             break;
+
+        case USBH_SIM_SCSI_CMD_SERVICE_ACTION_IN_16:
+             if ((p_cb[1] & 0x1Fu) != USBH_SIM_SCSI_SA_READ_CAPACITY_16) {
+                 asc = USBH_SIM_SCSI_ASC_INVALID_FIELD_IN_CDB;
+                 break;
+             }
+             Mem_Clr((void *)p_resp, 32u);
+             MEM_VAL_SET_INT32U_BIG(&p_resp[4], p_msc->BlkNbr - 1u);
+             MEM_VAL_SET_INT32U_BIG(&p_resp[8], p_msc->BlkSize);
+             len = 32u;
+             break;
+
+        case USBH_SIM_SCSI_CMD_READ_10:
+        case USBH_SIM_SCSI_CMD_WRITE_10:
+        case USBH_SIM_SCSI_CMD_READ_16:
+        case USBH_SIM_SCSI_CMD_WRITE_16:
+             if ((p_cb[0] == USBH_SIM_SCSI_CMD_READ_10) ||
+                 (p_cb[0] == USBH_SIM_SCSI_CMD_WRITE_10)) {
+                 lba_msb = 0u;
+                 lba     = MEM_VAL_GET_INT32U_BIG(&p_cb[2]);
+                 blk_cnt = MEM_VAL_GET_INT16U_BIG(&p_cb[7]);
+             } else {
+                 lba_msb = MEM_VAL_GET_INT32U_BIG(&p_cb[2]);
+                 lba     = MEM_VAL_GET_INT32U_BIG(&p_cb[6]);
+                 blk_cnt = MEM_VAL_GET_INT32U_BIG(&p_cb[10]);
+             }
+             if ((lba_msb       != 0u)            ||
+                 (lba           >  p_msc->BlkNbr) ||
+                 (blk_cnt       > (p_msc->BlkNbr - lba))) {
+                 asc = USBH_SIM_SCSI_ASC_LBA_OUT_OF_RANGE;
+                 break;
+             }
+             if ((p_msc->XferBlkMax != 0u) &&
+                 (blk_cnt           >  p_msc->XferBlkMax)) {
+                 asc = USBH_SIM_SCSI_ASC_INVALID_FIELD_IN_CDB;
+                 break;
+             }
+             p_resp     = &p_msc->DiskPtr[lba * p_msc->BlkSize];
+             len        =  blk_cnt * p_msc->BlkSize;
+             cmd_dir_in = ((p_cb[0] == USBH_SIM_SCSI_CMD_READ_10) ||
+                           (p_cb[0] == USBH_SIM_SCSI_CMD_READ_16)) ? DEF_TRUE : DEF_FALSE;
+             break;
+
+        default:
+             asc = USBH_SIM_SCSI_ASC_INVALID_CMD_OP_CODE;
+             break;
+    }
+
+    if (asc != 0u) {                                            /* Cmd failed (see Note #2).                            */
+        p_msc->CSW_Status = USBH_SIM_MSC_CSW_STATUS_FAILED;
+        p_msc->SenseKey   = USBH_SIM_SCSI_SENSE_KEY_ILLEGAL_REQUEST;
+        p_msc->ASC        = asc;
+        p_msc->ASCQ       = 0u;
+        p_resp            = p_msc->RespBuf;
+        len               = 0u;
+    }
+
+    p_msc->DataPtr   = p_resp;
+    p_msc->DataAvail = DEF_MIN(len, p_msc->DataLen);
+
+    if (p_msc->DataLen == 0u) {
+        p_msc->DataAvail = 0u;
+        p_msc->State     = USBH_SIM_MSC_STATE_CSW;
+        return;
+    }
+
+    if ((len != 0u) && (cmd_dir_in != dir_in)) {                /* See Note #1.                                         */
+        p_msc->CSW_Status = USBH_SIM_MSC_CSW_STATUS_PHASE_ERR;
+        p_msc->DataAvail  = 0u;
+    }
+
+    if (dir_in == DEF_TRUE) {
+        p_msc->State = USBH_SIM_MSC_STATE_DATA_IN;              /* Stalls on first IN if no data (see Note #2).         */
+        return;
+    }
+
+    if (p_msc->CSW_Status != USBH_SIM_MSC_CSW_STATUS_PASSED) {  /* See Note #2.                                         */
+        halt_bit = USBH_SIM_DEV_HALT_BIT(USBH_EP_DIR_OUT | USBH_SIM_MSC_EP_NBR_OUT);
+        DEF_BIT_SET(p_msc->Dev.HaltMask, halt_bit);
+        p_msc->State = USBH_SIM_MSC_STATE_CSW;
+        return;
+    }
+
+    p_msc->State = USBH_SIM_MSC_STATE_DATA_OUT;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_UAS_CtrlReq()
+*
+* Description : Process a mass storage class request.
+*
+* Argument(s) : p_dev           Pointer to emulated USB Attached SCSI device.
+*
+*               p_setup         Pointer to setup request.
+*
+*               p_buf           Pointer to data stage buffer.
+*
+*               p_len           Data stage length.
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : (1) Bulk-only transport class requests are only supported on alternate setting 0.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_UAS_CtrlReq (USBH_SIM_DEV    *p_dev,
+                                              USBH_SETUP_REQ  *p_setup,
+                                              CPU_INT08U      *p_buf,
+                                              CPU_INT16U      *p_len)
+{
+    if (p_dev->AltSel != 0u) {                                  /* See Note #1.                                         */
+        return (DEF_FAIL);
+    }
+
+    return (USBH_SimDev_MSC_CtrlReq(p_dev, p_setup, p_buf, p_len));
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_UAS_DataIn()
+*
+* Description : Return the next IN packet of the status or data-in pipe of the current command.
+*
+* Argument(s) : p_dev           Pointer to emulated USB Attached SCSI device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               buf_len         Packet buffer length.
+*
+*               p_xfer_len      Variable that will receive the number of octets returned.
+*
+* Return(s)   : Transaction status.
+*
+* Note(s)     : (1) On alternate setting 0, the device behaves as the bulk-only transport device.
+*
+*               (2) The status pipe returns a READ READY or WRITE READY IU before the data phase of a
+*                   command and a SENSE IU at the end of the command. Sense data is only included when the
+*                   command failed.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_UAS_DataIn (USBH_SIM_DEV  *p_dev,
+                                                 CPU_INT08U     ep_nbr,
+                                                 CPU_INT08U    *p_buf,
+                                                 CPU_INT32U     buf_len,
+                                                 CPU_INT32U    *p_xfer_len)
+{
+    USBH_SIM_UAS  *p_uas;
+    USBH_SIM_MSC  *p_msc;
+    CPU_INT16U     tag;
+    CPU_INT32U     len;
+    CPU_INT32U     n;
+
+
+    if (p_dev->AltSel == 0u) {                                  /* See Note #1.                                         */
+        return (USBH_SimDev_MSC_DataIn(p_dev, ep_nbr, p_buf, buf_len, p_xfer_len));
+    }
+
+    p_uas = (USBH_SIM_UAS *)p_dev;
+    p_msc = &p_uas->MSC;
+    tag   =  p_uas->CmdTbl[p_uas->CmdIx].Tag;
+
+    switch (ep_nbr) {
+        case USBH_SIM_UAS_EP_NBR_STATUS:                        /* See Note #2.                                         */
+             if (p_uas->State == USBH_SIM_UAS_STATE_READY) {
+                 if (buf_len < USBH_SIM_UAS_LEN_READY_IU) {
+                     return (USBH_SIM_STATUS_STALL);
+                 }
+                 p_buf[0] = (p_msc->State == USBH_SIM_MSC_STATE_DATA_IN) ? USBH_SIM_UAS_IU_ID_READ_READY
+                                                                         : USBH_SIM_UAS_IU_ID_WRITE_READY;
+                 p_buf[1] = 0u;
+                 MEM_VAL_SET_INT16U_BIG(&p_buf[2], tag);
+                *p_xfer_len   = USBH_SIM_UAS_LEN_READY_IU;
+                 p_uas->State = (p_msc->State == USBH_SIM_MSC_STATE_DATA_IN) ? USBH_SIM_UAS_STATE_DATA_IN
+                                                                             : USBH_SIM_UAS_STATE_DATA_OUT;
+                 return (USBH_SIM_STATUS_ACK);
+             }
+
+             if (p_uas->State != USBH_SIM_UAS_STATE_SENSE) {
+                 return (USBH_SIM_STATUS_NAK);
+             }
+
+             len = USBH_SIM_UAS_LEN_SENSE_IU;
+             if (p_uas->Status != USBH_SIM_SCSI_STATUS_GOOD) {
+                 len += USBH_SIM_UAS_LEN_SENSE_DATA;
+             }
+             if (buf_len < len) {
+                 return (USBH_SIM_STATUS_STALL);
+             }
+             Mem_Clr((void *)p_buf, len);
+             p_buf[0] = USBH_SIM_UAS_IU_ID_SENSE;
+             MEM_VAL_SET_INT16U_BIG(&p_buf[2], tag);
+             p_buf[6] = p_uas->Status;
+             if (p_uas->Status != USBH_SIM_SCSI_STATUS_GOOD) {
+                 MEM_VAL_SET_INT16U_BIG(&p_buf[14], USBH_SIM_UAS_LEN_SENSE_DATA);
+                 p_buf[16] = 0x70u;                             /* Current error, fixed format.                         */
+                 p_buf[18] = p_msc->SenseKey;
+                 p_buf[23] = 10u;
+                 p_buf[28] = p_msc->ASC;
+                 p_buf[29] = p_msc->ASCQ;
+                 p_msc->SenseKey = USBH_SIM_SCSI_SENSE_KEY_NONE;
+                 p_msc->ASC      = 0u;
+                 p_msc->ASCQ     = 0u;
+             }
+            *p_xfer_len = len;
+
+             p_uas->CmdIx = (p_uas->CmdIx + 1u) % USBH_SIM_UAS_CMD_NBR_MAX;
+             p_uas->CmdCnt--;
+             p_uas->State = USBH_SIM_UAS_STATE_IDLE;
+             USBH_SimDev_UAS_CmdStart(p_uas);
+             return (USBH_SIM_STATUS_ACK);
+
+
+        case USBH_SIM_UAS_EP_NBR_DATA_IN:
+             if (p_uas->State != USBH_SIM_UAS_STATE_DATA_IN) {
+                 return (USBH_SIM_STATUS_NAK);
+             }
+
+             n = DEF_MIN(buf_len, p_msc->DataAvail - p_msc->DataXferLen);
+             Mem_Copy((void *) p_buf,
+                      (void *)&p_msc->DataPtr[p_msc->DataXferLen],
+                               n);
+             p_msc->DataXferLen += n;
+            *p_xfer_len          = n;
+
+             if (p_msc->DataXferLen >= p_msc->DataAvail) {
+                 p_uas->State = USBH_SIM_UAS_STATE_SENSE;
+             }
+             return (USBH_SIM_STATUS_ACK);
+
+
+        default:
+             return (USBH_SIM_STATUS_STALL);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_UAS_DataOut()
+*
+* Description : Process an OUT packet of the command or data-out pipe.
+*
+* Argument(s) : p_dev           Pointer to emulated USB Attached SCSI device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet.
+*
+*               len             Packet length.
+*
+* Return(s)   : Transaction status.
+*
+* Note(s)     : (1) On alternate setting 0, the device behaves as the bulk-only transport device.
+*
+*               (2) An invalid COMMAND IU halts the command pipe. COMMAND IUs are NAKed while the command
+*                   queue is full.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_UAS_DataOut (USBH_SIM_DEV  *p_dev,
+                                                  CPU_INT08U     ep_nbr,
+                                                  CPU_INT08U    *p_buf,
+                                                  CPU_INT32U     len)
+{
+    USBH_SIM_UAS      *p_uas;
+    USBH_SIM_MSC      *p_msc;
+    USBH_SIM_UAS_CMD  *p_cmd;
+    CPU_INT32U         n;
+
+
+    if (p_dev->AltSel == 0u) {                                  /* See Note #1.                                         */
+        return (USBH_SimDev_MSC_DataOut(p_dev, ep_nbr, p_buf, len));
+    }
+
+    p_uas = (USBH_SIM_UAS *)p_dev;
+    p_msc = &p_uas->MSC;
+
+    switch (ep_nbr) {
+        case USBH_SIM_UAS_EP_NBR_CMD:                           /* See Note #2.                                         */
+             if ((len      != USBH_SIM_UAS_LEN_CMD_IU) ||
+                 (p_buf[0] != USBH_SIM_UAS_IU_ID_CMD)) {
+                 return (USBH_SIM_STATUS_STALL);
+             }
+             if (p_uas->CmdCnt >= USBH_SIM_UAS_CMD_NBR_MAX) {
+                 return (USBH_SIM_STATUS_NAK);
+             }
+
+             p_cmd         = &p_uas->CmdTbl[(p_uas->CmdIx + p_uas->CmdCnt) % USBH_SIM_UAS_CMD_NBR_MAX];
+             p_cmd->Tag    =  MEM_VAL_GET_INT16U_BIG(&p_buf[2]);
+             p_cmd->LatCnt =  p_msc->CmdLatFrm;
+             Mem_Copy((void *)p_cmd->CDB, (void *)&p_buf[16], USBH_SIM_UAS_LEN_CDB);
+             p_uas->CmdCnt++;
+
+             USBH_SimDev_UAS_CmdStart(p_uas);
+             return (USBH_SIM_STATUS_ACK);
+
+
+        case USBH_SIM_UAS_EP_NBR_DATA_OUT:
+             if (p_uas->State != USBH_SIM_UAS_STATE_DATA_OUT) {
+                 return (USBH_SIM_STATUS_NAK);
+             }
+
+             n = DEF_MIN(len, p_msc->DataAvail - p_msc->DataXferLen);
+             Mem_Copy((void *)&p_msc->DataPtr[p_msc->DataXferLen],
+                      (void *) p_buf,
+                               n);
+             p_msc->DataXferLen += n;
+
+             if (p_msc->DataXferLen >= p_msc->DataAvail) {
+                 p_uas->State = USBH_SIM_UAS_STATE_SENSE;
+             }
+             return (USBH_SIM_STATUS_ACK);
+
+
+        default:
+             return (USBH_SIM_STATUS_STALL);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_UAS_Reset()
+*
+* Description : Abort all queued commands of an emulated USB Attached SCSI device.
+*
+* Argument(s) : p_dev           Pointer to emulated USB Attached SCSI device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Called on bus reset and when an alternate setting is selected.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_UAS_Reset (USBH_SIM_DEV  *p_dev)
+{
+    USBH_SIM_UAS  *p_uas;
+
+
+    p_uas         = (USBH_SIM_UAS *)p_dev;
+    p_uas->CmdIx  = 0u;
+    p_uas->CmdCnt = 0u;
+    p_uas->State  = USBH_SIM_UAS_STATE_IDLE;
+
+    USBH_SimDev_MSC_Reset(p_dev);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimDev_UAS_Frm()
+*
+* Description : Count down the latency of the queued commands of an emulated USB Attached SCSI device.
+*
+* Argument(s) : p_dev           Pointer to emulated USB Attached SCSI device.
+*
+*               frm_nbr         Current frame number.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_UAS_Frm (USBH_SIM_DEV  *p_dev,
+                                   CPU_INT32U     frm_nbr)
+{
+    USBH_SIM_UAS      *p_uas;
+    USBH_SIM_UAS_CMD  *p_cmd;
+    CPU_INT08U         ix;
+
+
+    p_uas = (USBH_SIM_UAS *)p_dev;
+    if (p_dev->AltSel == 0u) {
+        USBH_SimDev_MSC_Frm(p_dev, frm_nbr);
+        return;
+    }
+
+    for (ix = 0u; ix < p_uas->CmdCnt; ix++) {
+        p_cmd = &p_uas->CmdTbl[(p_uas->CmdIx + ix) % USBH_SIM_UAS_CMD_NBR_MAX];
+        if (p_cmd->LatCnt > 0u) {
+            p_cmd->LatCnt--;
+        }
+    }
+
+    USBH_SimDev_UAS_CmdStart(p_uas);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimDev_UAS_CmdStart()
+*
+* Description : Execute the oldest queued command, if no command is being executed and its latency elapsed.
+*
+* Argument(s) : p_uas           Pointer to emulated USB Attached SCSI device.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) UAS has no data transfer length in the COMMAND IU. The length expected by the host is
+*                   taken from the allocation length of the CDB; read and write commands transfer all the
+*                   blocks of the command.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_UAS_CmdStart (USBH_SIM_UAS  *p_uas)
+{
+    USBH_SIM_MSC      *p_msc;
+    USBH_SIM_UAS_CMD  *p_cmd;
+    CPU_INT08U        *p_cb;
+    CPU_BOOLEAN        dir_in;
+
+
+    if ((p_uas->State  != USBH_SIM_UAS_STATE_IDLE) ||
+        (p_uas->CmdCnt == 0u)) {
+        return;
+    }
+
+    p_cmd = &p_uas->CmdTbl[p_uas->CmdIx];
+    if (p_cmd->LatCnt > 0u) {
+        return;
+    }
+
+    p_msc = &p_uas->MSC;
+    p_cb  =  p_cmd->CDB;
+
+    switch (p_cb[0]) {                                          /* See Note #1.                                         */
+        case USBH_SIM_SCSI_CMD_REQUEST_SENSE:
+        case USBH_SIM_SCSI_CMD_MODE_SENSE_06:
+             p_msc->DataLen = p_cb[4];
+             break;
+
+        case USBH_SIM_SCSI_CMD_INQUIRY:
+             p_msc->DataLen = MEM_VAL_GET_INT16U_BIG(&p_cb[3]);
+             break;
+
+        case USBH_SIM_SCSI_CMD_READ_CAPACITY_10:
+             p_msc->DataLen = 8u;
+             break;
+
+        case USBH_SIM_SCSI_CMD_SERVICE_ACTION_IN_16:
+             p_msc->DataLen = MEM_VAL_GET_INT32U_BIG(&p_cb[10]);
+             break;
+
+        case USBH_SIM_SCSI_CMD_REPORT_LUNS:
+             p_msc->DataLen = MEM_VAL_GET_INT32U_BIG(&p_cb[6]);
+             break;
+
+        case USBH_SIM_SCSI_CMD_READ_10:
+        case USBH_SIM_SCSI_CMD_WRITE_10:
+        case USBH_SIM_SCSI_CMD_READ_16:
+        case USBH_SIM_SCSI_CMD_WRITE_16:
+             p_msc->DataLen = DEF_INT_32U_MAX_VAL;
+             break;
+
+        default:
+             p_msc->DataLen = 0u;
+             break;
+    }
+
+    dir_in             = ((p_cb[0] == USBH_SIM_SCSI_CMD_WRITE_10) ||
+                          (p_cb[0] == USBH_SIM_SCSI_CMD_WRITE_16)) ? DEF_FALSE : DEF_TRUE;
+    p_msc->DataXferLen = 0u;
+    p_msc->DataAvail   = 0u;
+    p_msc->DataPtr     = p_msc->RespBuf;
+
+    USBH_SimDev_MSC_CmdProc(p_msc, p_cb, dir_in);
+
+    if (p_msc->CSW_Status != USBH_SIM_MSC_CSW_STATUS_PASSED) {
+        p_uas->Status = USBH_SIM_SCSI_STATUS_CHECK_CONDITION;
+        p_uas->State  = USBH_SIM_UAS_STATE_SENSE;
+    } else {
+        p_uas->Status = USBH_SIM_SCSI_STATUS_GOOD;
+        p_uas->State  = (p_msc->DataAvail == 0u) ? USBH_SIM_UAS_STATE_SENSE
+                                                 : USBH_SIM_UAS_STATE_READY;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_HID_CtrlReq()
+*
+* Description : Process a HID class request or a GET_DESCRIPTOR request for a HID class descriptor.
+*
+* Argument(s) : p_dev           Pointer to emulated HID device.
+*
+*               p_setup         Pointer to setup request.
+*
+*               p_buf           Pointer to data stage buffer.
+*
+*               p_len           Data stage length.
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_HID_CtrlReq (USBH_SIM_DEV    *p_dev,
+                                              USBH_SETUP_REQ  *p_setup,
+                                              CPU_INT08U      *p_buf,
+                                              CPU_INT16U      *p_len)
+{
+    USBH_SIM_HID  *p_hid;
+    CPU_INT08U     desc_type;
+    CPU_INT08U     req_type;
+
+
+    p_hid    = (USBH_SIM_HID *)p_dev;
+    req_type = p_setup->bmRequestType & USBH_REQ_TYPE_RSVD;
+
+    if (req_type == USBH_REQ_TYPE_STD) {
+        if (p_setup->bRequest != USBH_REQ_GET_DESC) {
+            return (DEF_FAIL);
+        }
+
+        desc_type = (CPU_INT08U)(p_setup->wValue >> 8u);
+        switch (desc_type) {
+            case USBH_SIM_HID_DESC_TYPE_REPORT:
+                 if (p_hid->Type == USBH_SIM_HID_TYPE_KBD) {
+                     Mem_Copy((void *)p_buf,
+                              (void *)USBH_SimDev_HID_ReportDescKbd,
+                                      sizeof(USBH_SimDev_HID_ReportDescKbd));
+                    *p_len = sizeof(USBH_SimDev_HID_ReportDescKbd);
+                 } else {
+                     Mem_Copy((void *)p_buf,
+                              (void *)USBH_SimDev_HID_ReportDescMouse,
+                                      sizeof(USBH_SimDev_HID_ReportDescMouse));
+                    *p_len = sizeof(USBH_SimDev_HID_ReportDescMouse);
+                 }
+                 return (DEF_OK);
+
+            case USBH_SIM_HID_DESC_TYPE_HID:                    /* HID desc follows the IF desc in the cfg desc.        */
+                 Mem_Copy((void *) p_buf,
+                          (void *)&p_dev->CfgDesc[USBH_LEN_DESC_CFG + USBH_LEN_DESC_IF],
+                                   USBH_SIM_HID_LEN_DESC_HID);
+                *p_len = USBH_SIM_HID_LEN_DESC_HID;
+                 return (DEF_OK);
+
+            default:
+                 return (DEF_FAIL);
+        }
+    }
+
+    if (req_type != USBH_REQ_TYPE_CLASS) {
+        return (DEF_FAIL);
+    }
+
+    switch (p_setup->bRequest) {
+        case USBH_SIM_HID_REQ_GET_REPORT:
+             Mem_Copy((void *)p_buf, (void *)p_hid->Report, p_hid->ReportLen);
+            *p_len = p_hid->ReportLen;
+             break;
+
+        case USBH_SIM_HID_REQ_SET_REPORT:
+             if (*p_len > 0u) {
+                 p_hid->OutReport = p_buf[0];
+             }
+             break;
+
+        case USBH_SIM_HID_REQ_GET_IDLE:
+             p_buf[0] = p_hid->IdleRate;
+            *p_len    = 1u;
+             break;
+
+        case USBH_SIM_HID_REQ_SET_IDLE:
+             p_hid->IdleRate = (CPU_INT08U)(p_setup->wValue >> 8u);
+             break;
+
+        case USBH_SIM_HID_REQ_GET_PROTOCOL:
+             p_buf[0] = p_hid->Protocol;
+            *p_len    = 1u;
+             break;
+
+        case USBH_SIM_HID_REQ_SET_PROTOCOL:
+             p_hid->Protocol = (CPU_INT08U)(p_setup->wValue & 0xFFu);
+             break;
+
+        default:
+             return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_HID_DataIn()
+*
+* Description : Return the current input report of an emulated HID device, if not read yet.
+*
+* Argument(s) : p_dev           Pointer to emulated HID device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               buf_len         Packet buffer length.
+*
+*               p_xfer_len      Variable that will receive the number of octets returned.
+*
+* Return(s)   : USBH_SIM_STATUS_ACK, if a new report was returned.
+*               USBH_SIM_STATUS_NAK, otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_HID_DataIn (USBH_SIM_DEV  *p_dev,
+                                                 CPU_INT08U     ep_nbr,
+                                                 CPU_INT08U    *p_buf,
+                                                 CPU_INT32U     buf_len,
+                                                 CPU_INT32U    *p_xfer_len)
+{
+    USBH_SIM_HID  *p_hid;
+    CPU_INT32U     n;
+
+
+    (void)ep_nbr;
+
+    p_hid = (USBH_SIM_HID *)p_dev;
+    if (p_hid->ReportRdy == DEF_FALSE) {
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    n = DEF_MIN(buf_len, p_hid->ReportLen);
+    Mem_Copy((void *)p_buf, (void *)p_hid->Report, n);
+    p_hid->ReportRdy = DEF_FALSE;
+   *p_xfer_len       = n;
+
+    return (USBH_SIM_STATUS_ACK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_SimDev_HID_Frm()
+*
+* Description : Generate the next input report of an emulated HID device, when automatic reports are
+*               enabled.
+*
+* Argument(s) : p_dev           Pointer to emulated HID device.
+*
+*               frm_nbr         Current frame number.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The mouse moves back and forth along the X axis. The keyboard alternately presses and
+*                   releases the 'a' key.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_HID_Frm (USBH_SIM_DEV  *p_dev,
+                                   CPU_INT32U     frm_nbr)
+{
+    USBH_SIM_HID  *p_hid;
+    CPU_BOOLEAN    odd;
+
+
+    (void)frm_nbr;
+
+    p_hid = (USBH_SIM_HID *)p_dev;
+    if ((p_hid->AutoEn  == DEF_DISABLED) ||
+        (p_dev->CfgNbr  == 0u)) {
+        return;
+    }
+
+    p_hid->FrmCnt++;
+    if (p_hid->FrmCnt < p_hid->ReportPeriodFrm) {
+        return;
+    }
+    p_hid->FrmCnt = 0u;
+
+    odd = ((p_hid->ReportCnt & 1u) != 0u) ? DEF_TRUE : DEF_FALSE;
+    Mem_Clr((void *)p_hid->Report, USBH_SIM_HID_REPORT_LEN_MAX);    /* See Note #1.                                     */
+    if (p_hid->Type == USBH_SIM_HID_TYPE_KBD) {
+        p_hid->Report[2] = (odd == DEF_TRUE) ? 0u : USBH_SIM_HID_KBD_USAGE_A;
+        p_hid->ReportLen = USBH_SIM_HID_LEN_REPORT_KBD;
+    } else {
+        p_hid->Report[1] = (odd == DEF_TRUE) ? 0xFFu : 0x01u;
+        p_hid->ReportLen = USBH_SIM_HID_LEN_REPORT_MOUSE;
+    }
+
+    p_hid->ReportRdy = DEF_TRUE;
+    p_hid->ReportCnt++;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_ACM_CtrlReq()
+*
+* Description : Process a CDC ACM class request.
+*
+* Argument(s) : p_dev           Pointer to emulated ACM device.
+*
+*               p_setup         Pointer to setup request.
+*
+*               p_buf           Pointer to data stage buffer.
+*
+*               p_len           Data stage length.
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_ACM_CtrlReq (USBH_SIM_DEV    *p_dev,
+                                              USBH_SETUP_REQ  *p_setup,
+                                              CPU_INT08U      *p_buf,
+                                              CPU_INT16U      *p_len)
+{
+    USBH_SIM_ACM  *p_acm;
+
+
+    p_acm = (USBH_SIM_ACM *)p_dev;
+
+    if ((p_setup->bmRequestType & USBH_REQ_TYPE_RSVD) != USBH_REQ_TYPE_CLASS) {
+        return (DEF_FAIL);
+    }
+
+    switch (p_setup->bRequest) {
+        case USBH_SIM_ACM_REQ_SET_LINE_CODING:
+             if (*p_len < sizeof(p_acm->LineCoding)) {
+                 return (DEF_FAIL);
+             }
+             Mem_Copy((void *)p_acm->LineCoding, (void *)p_buf, sizeof(p_acm->LineCoding));
+             break;
+
+        case USBH_SIM_ACM_REQ_GET_LINE_CODING:
+             Mem_Copy((void *)p_buf, (void *)p_acm->LineCoding, sizeof(p_acm->LineCoding));
+            *p_len = sizeof(p_acm->LineCoding);
+             break;
+
+        case USBH_SIM_ACM_REQ_SET_CTRL_LINE_STATE:
+             p_acm->CtrlLineState = p_setup->wValue;
+             p_acm->NotifyPend    = DEF_TRUE;
+             break;
+
+        case USBH_SIM_ACM_REQ_SEND_BREAK:
+             break;
+
+        default:
+             return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_SimDev_ACM_DataIn()
+*
+* Description : Return a SERIAL_STATE notification or loopback data of an emulated ACM device.
+*
+* Argument(s) : p_dev           Pointer to emulated ACM device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               buf_len         Packet buffer length.
+*
+*               p_xfer_len      Variable that will receive the number of octets returned.
+*
+* Return(s)   : Transaction status.
+*
+* Note(s)     : (1) DCD and DSR follow DTR.
+*
+*               (2) A max pkt that empties the FIFO is followed by a zero-length pkt, so that the host
+*                   transfer ends.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_ACM_DataIn (USBH_SIM_DEV  *p_dev,
+                                                 CPU_INT08U     ep_nbr,
+                                                 CPU_INT08U    *p_buf,
+                                                 CPU_INT32U     buf_len,
+                                                 CPU_INT32U    *p_xfer_len)
+{
+    USBH_SIM_ACM  *p_acm;
+    CPU_INT32U     n;
+
+
+    p_acm = (USBH_SIM_ACM *)p_dev;
+
+    if (ep_nbr == USBH_SIM_ACM_EP_NBR_NOTIFY) {
+        if ((p_acm->NotifyPend == DEF_FALSE) ||
+            (buf_len           <  USBH_SIM_ACM_LEN_NOTIFY_SERIAL_STATE)) {
+            return (USBH_SIM_STATUS_NAK);
+        }
+
+        p_buf[0] = 0xA1u;
+        p_buf[1] = USBH_SIM_ACM_NOTIFY_SERIAL_STATE;
+        MEM_VAL_SET_INT16U_LITTLE(&p_buf[2], 0u);
+        MEM_VAL_SET_INT16U_LITTLE(&p_buf[4], 0u);               /* Comm IF nbr.                                         */
+        MEM_VAL_SET_INT16U_LITTLE(&p_buf[6], 2u);
+        p_buf[8] = DEF_BIT_IS_SET(p_acm->CtrlLineState, USBH_SIM_ACM_CTRL_LINE_STATE_DTR)
+                 ? USBH_SIM_ACM_SERIAL_STATE_DCD_DSR            /* See Note #1.                                         */
+                 : 0u;
+        p_buf[9] = 0u;
+
+        p_acm->NotifyPend = DEF_FALSE;
+       *p_xfer_len        = USBH_SIM_ACM_LEN_NOTIFY_SERIAL_STATE;
+        return (USBH_SIM_STATUS_ACK);
+    }
+
+    if (ep_nbr != USBH_SIM_ACM_EP_NBR_DATA) {
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    if (p_acm->FIFO.Cnt == 0u) {
+        if (p_acm->ZLP_Pend == DEF_TRUE) {                      /* See Note #2.                                         */
+            p_acm->ZLP_Pend = DEF_FALSE;
+            return (USBH_SIM_STATUS_ACK);
+        }
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    n = USBH_SimDev_FIFO_Get(&p_acm->FIFO,
+                              p_buf,
+                              DEF_MIN(buf_len, USBH_SIM_ACM_MAX_PKT_SIZE));
+    p_acm->ZLP_Pend = ((n == USBH_SIM_ACM_MAX_PKT_SIZE) && (p_acm->FIFO.Cnt == 0u)) ? DEF_TRUE : DEF_FALSE;
+   *p_xfer_len      = n;
+
+    return (USBH_SIM_STATUS_ACK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimDev_ACM_DataOut()
+*
+* Description : Store data received by an emulated ACM device in its loopback FIFO.
+*
+* Argument(s) : p_dev           Pointer to emulated ACM device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet.
+*
+*               len             Packet length.
+*
+* Return(s)   : USBH_SIM_STATUS_ACK, if the packet was stored.
+*               USBH_SIM_STATUS_NAK, if the FIFO cannot hold the packet.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_ACM_DataOut (USBH_SIM_DEV  *p_dev,
+                                                  CPU_INT08U     ep_nbr,
+                                                  CPU_INT08U    *p_buf,
+                                                  CPU_INT32U     len)
+{
+    USBH_SIM_ACM  *p_acm;
+
+
+    p_acm = (USBH_SIM_ACM *)p_dev;
+
+    if (ep_nbr != USBH_SIM_ACM_EP_NBR_DATA) {
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    if ((USBH_SIM_FIFO_LEN - p_acm->FIFO.Cnt) < len) {
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    (void)USBH_SimDev_FIFO_Put(&p_acm->FIFO, p_buf, len);
+
+    return (USBH_SIM_STATUS_ACK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimDev_FTDI_CtrlReq()
+*
+* Description : Process an FTDI vendor request.
+*
+* Argument(s) : p_dev           Pointer to emulated FTDI device.
+*
+*               p_setup         Pointer to setup request.
+*
+*               p_buf           Pointer to data stage buffer.
+*
+*               p_len           Data stage length.
+*
+* Return(s)   : DEF_OK,     if the request was processed.
+*               DEF_FAIL,   otherwise.
+*
+* Note(s)     : (1) Bits 8 and 9 of the SET_MODEM_CTRL value enable the update of DTR (bit 0) and RTS
+*                   (bit 1).
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_SimDev_FTDI_CtrlReq (USBH_SIM_DEV    *p_dev,
+                                               USBH_SETUP_REQ  *p_setup,
+                                               CPU_INT08U      *p_buf,
+                                               CPU_INT16U      *p_len)
+{
+    USBH_SIM_FTDI  *p_ftdi;
+    CPU_INT16U      mask;
+
+
+    p_ftdi = (USBH_SIM_FTDI *)p_dev;
+
+    if ((p_setup->bmRequestType & USBH_REQ_TYPE_RSVD) != USBH_REQ_TYPE_VENDOR) {
+        return (DEF_FAIL);
+    }
+
+    switch (p_setup->bRequest) {
+        case USBH_SIM_FTDI_REQ_RESET:
+             if ((p_setup->wValue == USBH_SIM_FTDI_RESET_SIO) ||
+                 (p_setup->wValue == USBH_SIM_FTDI_RESET_PURGE_RX)) {
+                 Mem_Clr((void *)&p_ftdi->FIFO, sizeof(USBH_SIM_FIFO));
+             }
+             break;
+
+        case USBH_SIM_FTDI_REQ_SET_MODEM_CTRL:                  /* See Note #1.                                         */
+             mask = (p_setup->wValue >> 8u) & 0x03u;
+             p_ftdi->ModemCtrl = (p_ftdi->ModemCtrl & ~mask) | (p_setup->wValue & mask);
+             break;
+
+        case USBH_SIM_FTDI_REQ_SET_FLOW_CTRL:
+             break;
+
+        case USBH_SIM_FTDI_REQ_SET_BAUD_RATE:
+             p_ftdi->BaudDiv = p_setup->wValue;
+             break;
+
+        case USBH_SIM_FTDI_REQ_SET_DATA:
+             p_ftdi->DataCfg = p_setup->wValue;
+             break;
+
+        case USBH_SIM_FTDI_REQ_GET_MODEM_STATUS:
+             p_buf[0] = p_ftdi->ModemStatus;
+             p_buf[1] = p_ftdi->LineStatus;
+            *p_len    = 2u;
+             break;
+
+        case USBH_SIM_FTDI_REQ_SET_LAT_TMR:
+             p_ftdi->LatTmr = (CPU_INT08U)(p_setup->wValue & 0xFFu);
+             break;
+
+        case USBH_SIM_FTDI_REQ_GET_LAT_TMR:
+             p_buf[0] = p_ftdi->LatTmr;
+            *p_len    = 1u;
+             break;
+
+        default:
+             return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimDev_FTDI_DataIn()
+*
+* Description : Return loopback data of an emulated FTDI device, preceded by the 2 status octets.
+*
+* Argument(s) : p_dev           Pointer to emulated FTDI device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet buffer.
+*
+*               buf_len         Packet buffer length.
+*
+*               p_xfer_len      Variable that will receive the number of octets returned.
+*
+* Return(s)   : Transaction status.
+*
+* Note(s)     : (1) When no data is available, a status-only pkt is returned once the latency timer
+*                   expires.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_FTDI_DataIn (USBH_SIM_DEV  *p_dev,
+                                                  CPU_INT08U     ep_nbr,
+                                                  CPU_INT08U    *p_buf,
+                                                  CPU_INT32U     buf_len,
+                                                  CPU_INT32U    *p_xfer_len)
+{
+    USBH_SIM_FTDI  *p_ftdi;
+    CPU_INT32U      n;
+
+
+    p_ftdi = (USBH_SIM_FTDI *)p_dev;
+
+    if (ep_nbr != USBH_SIM_FTDI_EP_NBR_IN) {
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    if (buf_len < USBH_SIM_FTDI_LEN_STATUS) {
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    if ((p_ftdi->FIFO.Cnt == 0u) &&                             /* See Note #1.                                         */
+        (p_ftdi->LatCnt   <  ((CPU_INT32U)p_ftdi->LatTmr * p_ftdi->FrmPerMs))) {
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    p_buf[0] = p_ftdi->ModemStatus;
+    p_buf[1] = p_ftdi->LineStatus;
+    n        = USBH_SimDev_FIFO_Get(&p_ftdi->FIFO,
+                                    &p_buf[USBH_SIM_FTDI_LEN_STATUS],
+                                     buf_len - USBH_SIM_FTDI_LEN_STATUS);
+
+    p_ftdi->LatCnt = 0u;
+   *p_xfer_len     = n + USBH_SIM_FTDI_LEN_STATUS;
+
+    return (USBH_SIM_STATUS_ACK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_SimDev_FTDI_DataOut()
+*
+* Description : Store data received by an emulated FTDI device in its loopback FIFO.
+*
+* Argument(s) : p_dev           Pointer to emulated FTDI device.
+*
+*               ep_nbr          Endpoint number.
+*
+*               p_buf           Pointer to packet.
+*
+*               len             Packet length.
+*
+* Return(s)   : USBH_SIM_STATUS_ACK, if the packet was stored.
+*               USBH_SIM_STATUS_NAK, if the FIFO cannot hold the packet.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_SIM_STATUS  USBH_SimDev_FTDI_DataOut (USBH_SIM_DEV  *p_dev,
+                                                   CPU_INT08U     ep_nbr,
+                                                   CPU_INT08U    *p_buf,
+                                                   CPU_INT32U     len)
+{
+    USBH_SIM_FTDI  *p_ftdi;
+
+
+    p_ftdi = (USBH_SIM_FTDI *)p_dev;
+
+    if (ep_nbr != USBH_SIM_FTDI_EP_NBR_OUT) {
+        return (USBH_SIM_STATUS_STALL);
+    }
+
+    if ((USBH_SIM_FIFO_LEN - p_ftdi->FIFO.Cnt) < len) {
+        return (USBH_SIM_STATUS_NAK);
+    }
+
+    (void)USBH_SimDev_FIFO_Put(&p_ftdi->FIFO, p_buf, len);
+
+    return (USBH_SIM_STATUS_ACK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_SimDev_FTDI_Frm()
+*
+* Description : Advance the latency timer of an emulated FTDI device.
+*
+* Argument(s) : p_dev           Pointer to emulated FTDI device.
+*
+*               frm_nbr         Current frame number.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_SimDev_FTDI_Frm (USBH_SIM_DEV  *p_dev,
+                                    CPU_INT32U     frm_nbr)
+{
+    USBH_SIM_FTDI  *p_ftdi;
+
+
+    (void)frm_nbr;
+
+    p_ftdi = (USBH_SIM_FTDI *)p_dev;
+    if (p_ftdi->LatCnt < DEF_INT_32U_MAX_VAL) {
+        p_ftdi->LatCnt++;
+    }
+}
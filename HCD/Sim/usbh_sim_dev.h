@@ -0,0 +1,474 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                  SIMULATED HOST CONTROLLER DRIVER
+*                                         EMULATED USB DEVICES
+*
+* Filename : usbh_sim_dev.h
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) Emulated devices are connected to the ports of the simulated host controller (see
+*                'usbh_hcd_sim.h') or to the ports of an emulated hub. Each device is described by a
+*                USBH_SIM_DEV structure, embedded as the first member of the device type structure.
+*
+*            (2) The device framework answers the standard requests and runs the control transfer state
+*                machine of the default endpoint. Class and vendor requests, non-control endpoints and
+*                per-frame processing are handled by the device type through its USBH_SIM_DEV_API.
+*
+*            (3) Device functions are called by the simulated host controller with the simulation lock
+*                held (see USBH_SimDev_Lock()). Functions called by the application take the lock.
+*********************************************************************************************************
+*/
+
+#ifndef  USBH_SIM_DEV_H
+#define  USBH_SIM_DEV_H
+
+
+/*
+*********************************************************************************************************
+*                                              INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "../../Source/usbh_core.h"
+
+
+/*
+*********************************************************************************************************
+*                                                 EXTERNS
+*********************************************************************************************************
+*/
+
+#ifdef   USBH_SIM_DEV_MODULE
+#define  USBH_SIM_DEV_EXT
+#else
+#define  USBH_SIM_DEV_EXT  extern
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                                 DEFINES
+*********************************************************************************************************
+*/
+
+#define  USBH_SIM_DEV_CFG_DESC_LEN_MAX                  128u    /* Max len of cfg desc, incl IF, EP and class desc.     */
+#define  USBH_SIM_DEV_CTRL_BUF_LEN                      256u    /* Len of dflt EP data stage buf.                       */
+#define  USBH_SIM_DEV_STR_NBR_MAX                         3u    /* Nbr of str desc (manufacturer, product, serial).     */
+
+#define  USBH_SIM_DEV_ADDR_NONE                        0xFFu    /* No SET_ADDRESS pending.                              */
+
+#define  USBH_SIM_HUB_NBR_PORTS                           4u    /* Nbr of downstream ports of emulated hub.             */
+
+#define  USBH_SIM_FIFO_LEN                             1024u    /* Len of loopback FIFO of emulated serial devices.     */
+
+#define  USBH_SIM_HID_TYPE_MOUSE                          0u    /* Boot protocol mouse.                                 */
+#define  USBH_SIM_HID_TYPE_KBD                            1u    /* Boot protocol keyboard.                              */
+#define  USBH_SIM_HID_REPORT_LEN_MAX                      8u
+
+#define  USBH_SIM_UAS_CMD_NBR_MAX                         8u    /* Nbr of cmds queued by emulated UAS dev.              */
+#define  USBH_SIM_UAS_LEN_CDB                            16u
+
+
+/*
+*********************************************************************************************************
+*                                               DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_dev  USBH_SIM_DEV;
+
+
+/*
+*********************************************************************************************************
+*                                         TRANSACTION STATUS
+*********************************************************************************************************
+*/
+
+typedef  enum  usbh_sim_status {
+    USBH_SIM_STATUS_ACK = 0u,                                   /* Pkt xfer'd.                                          */
+    USBH_SIM_STATUS_NAK,                                        /* Dev not ready, retry later.                          */
+    USBH_SIM_STATUS_STALL                                       /* EP halted or req not supported.                      */
+} USBH_SIM_STATUS;
+
+
+/*
+*********************************************************************************************************
+*                                           DEVICE TYPE API
+*
+* Note(s) : (1) 'CtrlReq' handles class and vendor requests, and standard requests the framework does not
+*               handle. For device-to-host requests, '*p_len' holds the size of 'p_buf' on entry and must
+*               be set to the nbr of octets to return. For host-to-device requests, 'p_buf' holds the
+*               'wLength' octets of the data stage. Returns DEF_FAIL to stall the request.
+*
+*           (2) 'DataIn' returns at most 'buf_len' octets, which is at most one max pkt. A pkt shorter than
+*               the max pkt size ends the transfer.
+*
+*           (3) 'Frm' is called once per frame, before any transaction of that frame.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_dev_api {
+    CPU_BOOLEAN      (*CtrlReq)(USBH_SIM_DEV    *p_dev,         /* Class/vendor req (see Note #1).                      */
+                                USBH_SETUP_REQ  *p_setup,
+                                CPU_INT08U      *p_buf,
+                                CPU_INT16U      *p_len);
+
+    USBH_SIM_STATUS  (*DataIn) (USBH_SIM_DEV    *p_dev,         /* IN  pkt on non-ctrl EP (see Note #2).                */
+                                CPU_INT08U       ep_nbr,
+                                CPU_INT08U      *p_buf,
+                                CPU_INT32U       buf_len,
+                                CPU_INT32U      *p_xfer_len);
+
+    USBH_SIM_STATUS  (*DataOut)(USBH_SIM_DEV    *p_dev,         /* OUT pkt on non-ctrl EP.                              */
+                                CPU_INT08U       ep_nbr,
+                                CPU_INT08U      *p_buf,
+                                CPU_INT32U       len);
+
+    void             (*Reset)  (USBH_SIM_DEV    *p_dev);        /* Bus reset.                                           */
+
+    void             (*Frm)    (USBH_SIM_DEV    *p_dev,         /* Start of frame (see Note #3).                        */
+                                CPU_INT32U       frm_nbr);
+} USBH_SIM_DEV_API;
+
+
+/*
+*********************************************************************************************************
+*                                            PORT STATE
+*
+* Note(s) : (1) Used for the root hub ports of the simulated host controller and for the downstream
+*               ports of emulated hubs. 'Status' and 'Chng' use the wPortStatus and wPortChange bits
+*               (see 'usbh_core.h  HUB PORT STATUS BITS').
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_port {
+    USBH_SIM_DEV  *DevPtr;                                      /* Dev connected to port.                               */
+    CPU_INT16U     Status;                                      /* Port status.                                         */
+    CPU_INT16U     Chng;                                        /* Port status change.                                  */
+} USBH_SIM_PORT;
+
+
+/*
+*********************************************************************************************************
+*                                          EMULATED DEVICE
+*********************************************************************************************************
+*/
+
+struct  usbh_sim_dev {
+    const  USBH_SIM_DEV_API  *API_Ptr;                          /* Dev type API.                                        */
+    USBH_DEV_SPD              Spd;                              /* Dev spd.                                             */
+    CPU_INT08U                Addr;                             /* Dev addr.                                            */
+    CPU_INT08U                AddrPend;                         /* Addr set when SET_ADDRESS status stage completes.    */
+    CPU_INT08U                CfgNbr;                           /* Selected cfg, 0 if not configured.                   */
+    CPU_INT08U                AltNbr;                           /* Nbr of alternate settings of each IF.                */
+    CPU_INT08U                AltSel;                           /* Selected alternate setting.                         */
+    CPU_INT32U                HaltMask;                         /* Halted EPs: bit n for OUT EP n, n + 16 for IN EP n.  */
+
+    CPU_INT08U                DevDesc[USBH_LEN_DESC_DEV];       /* Dev desc.                                            */
+    CPU_INT08U                CfgDesc[USBH_SIM_DEV_CFG_DESC_LEN_MAX];  /* Cfg desc and all its sub-desc.               */
+    CPU_INT16U                CfgDescLen;
+    const  CPU_CHAR          *StrTbl[USBH_SIM_DEV_STR_NBR_MAX]; /* Str desc, from index 1.                              */
+
+    USBH_SIM_PORT            *PortTblPtr;                       /* Downstream ports (hub only).                         */
+    CPU_INT08U                PortNbr;                          /* Nbr of downstream ports.                             */
+
+    CPU_INT08U                CtrlState;                        /* Dflt EP ctrl xfer state.                             */
+    USBH_SETUP_REQ            CtrlSetup;                        /* Setup pkt of current ctrl xfer.                      */
+    CPU_BOOLEAN               CtrlStall;                        /* Stall data and status stages of current ctrl xfer.   */
+    CPU_INT16U                CtrlLen;                          /* Nbr of octets in data stage buf.                     */
+    CPU_INT16U                CtrlOffset;                       /* Nbr of octets xfer'd during IN data stage.           */
+    CPU_INT08U                CtrlBuf[USBH_SIM_DEV_CTRL_BUF_LEN];
+};
+
+
+/*
+*********************************************************************************************************
+*                                        LOOPBACK FIFO DATA TYPE
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_fifo {
+    CPU_INT08U  Buf[USBH_SIM_FIFO_LEN];
+    CPU_INT32U  InIx;
+    CPU_INT32U  OutIx;
+    CPU_INT32U  Cnt;
+} USBH_SIM_FIFO;
+
+
+/*
+*********************************************************************************************************
+*                                           EMULATED HUB
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_hub {
+    USBH_SIM_DEV   Dev;
+    USBH_SIM_PORT  PortTbl[USBH_SIM_HUB_NBR_PORTS];
+} USBH_SIM_HUB;
+
+
+/*
+*********************************************************************************************************
+*                                   EMULATED MASS STORAGE DEVICE
+*
+* Note(s) : (1) Bulk-only transport device with a single LUN, backed by an application supplied RAM disk.
+*
+*           (2) When 'CmdLatFrm' is not 0, the device NAKs the data and status stages of each command for
+*               'CmdLatFrm' frames after the CBW is received, to model media access latency.
+*
+*           (3) 'XferBlkMax' is the MAXIMUM TRANSFER LENGTH reported in the Block Limits VPD page. Read and
+*               write commands of more blocks fail. It is 0 (no limit) after USBH_SimDev_MSC_Init() and
+*               may be set by the application before the device is connected.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_msc {
+    USBH_SIM_DEV   Dev;
+    CPU_INT08U    *DiskPtr;                                     /* RAM disk.                                            */
+    CPU_INT32U     BlkSize;                                     /* Blk size, in octets.                                 */
+    CPU_INT32U     BlkNbr;                                      /* Nbr of blks.                                         */
+    CPU_INT32U     CmdLatFrm;                                   /* Cmd latency, in frames (see Note #2).                */
+    CPU_INT32U     XferBlkMax;                                  /* Max nbr of blks per cmd (see Note #3).               */
+
+    CPU_INT08U     State;                                       /* BOT state.                                           */
+    CPU_INT32U     LatCnt;                                      /* Remaining latency of current cmd, in frames.         */
+    CPU_INT32U     Tag;                                         /* Tag of current CBW.                                  */
+    CPU_INT32U     DataLen;                                     /* dCBWDataTransferLength of current CBW.               */
+    CPU_INT32U     DataXferLen;                                 /* Nbr of octets xfer'd in data stage.                  */
+    CPU_INT08U    *DataPtr;                                     /* Data stage buf.                                      */
+    CPU_INT32U     DataAvail;                                   /* Nbr of octets available in data stage buf.           */
+    CPU_INT08U     CSW_Status;                                  /* Status of current cmd.                               */
+
+    CPU_INT08U     SenseKey;                                    /* Sense data of last failed cmd.                       */
+    CPU_INT08U     ASC;
+    CPU_INT08U     ASCQ;
+
+    CPU_INT08U     RespBuf[64];                                 /* Buf for non-media data stages.                       */
+} USBH_SIM_MSC;
+
+
+/*
+*********************************************************************************************************
+*                                  EMULATED USB ATTACHED SCSI DEVICE
+*
+* Note(s) : (1) Mass storage device whose IF has two alternate settings: bulk-only transport on alternate
+*               setting 0, handled as by USBH_SIM_MSC, and USB Attached SCSI on alternate setting 1, with
+*               the command, status, data-in and data-out pipes of a high-speed device (no streams).
+*
+*           (2) Up to USBH_SIM_UAS_CMD_NBR_MAX commands are queued. The latency of each command
+*               ('MSC.CmdLatFrm') elapses from the reception of its COMMAND IU, concurrently with the
+*               latency of the other queued commands. Commands are then executed in order, one at a time.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_uas_cmd {
+    CPU_INT16U    Tag;                                          /* Tag of COMMAND IU.                                   */
+    CPU_INT32U    LatCnt;                                       /* Remaining latency, in frames.                        */
+    CPU_INT08U    CDB[USBH_SIM_UAS_LEN_CDB];
+} USBH_SIM_UAS_CMD;
+
+typedef  struct  usbh_sim_uas {
+    USBH_SIM_MSC      MSC;                                      /* BOT alt setting and SCSI target (see Note #1).       */
+    USBH_SIM_UAS_CMD  CmdTbl[USBH_SIM_UAS_CMD_NBR_MAX];         /* Queued cmds (see Note #2).                           */
+    CPU_INT08U        CmdIx;                                    /* Ix of oldest queued cmd.                             */
+    CPU_INT08U        CmdCnt;                                   /* Nbr of queued cmds.                                  */
+    CPU_INT08U        State;                                    /* State of oldest queued cmd.                          */
+    CPU_INT08U        Status;                                   /* SCSI status of oldest queued cmd.                    */
+} USBH_SIM_UAS;
+
+
+/*
+*********************************************************************************************************
+*                                  EMULATED HUMAN INTERFACE DEVICE
+*
+* Note(s) : (1) Boot protocol mouse or keyboard. When 'AutoEn' is DEF_ENABLED, a new report is generated
+*               every 'ReportPeriodFrm' frames. Otherwise, reports are supplied by the application with
+*               USBH_SimDev_HID_ReportSet().
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_hid {
+    USBH_SIM_DEV  Dev;
+    CPU_INT08U    Type;                                         /* Mouse or kbd.                                        */
+    CPU_BOOLEAN   AutoEn;                                       /* Generate reports (see Note #1).                      */
+    CPU_INT32U    ReportPeriodFrm;                              /* Report generation period, in frames.                 */
+    CPU_INT32U    FrmCnt;
+    CPU_INT32U    ReportCnt;                                    /* Nbr of reports generated.                            */
+
+    CPU_INT08U    Report[USBH_SIM_HID_REPORT_LEN_MAX];          /* Current input report.                                */
+    CPU_INT08U    ReportLen;
+    CPU_BOOLEAN   ReportRdy;                                    /* Input report not read yet by host.                   */
+    CPU_INT08U    OutReport;                                    /* Last output report (kbd LEDs).                       */
+    CPU_INT08U    IdleRate;
+    CPU_INT08U    Protocol;
+} USBH_SIM_HID;
+
+
+/*
+*********************************************************************************************************
+*                                    EMULATED CDC ACM DEVICE
+*
+* Note(s) : (1) Data received on the bulk OUT EP is sent back on the bulk IN EP. A SERIAL_STATE
+*               notification is sent on the interrupt EP when the control line state changes.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_acm {
+    USBH_SIM_DEV   Dev;
+    CPU_INT08U     LineCoding[7];                               /* Line coding, in USB format.                          */
+    CPU_INT16U     CtrlLineState;                               /* Last SET_CONTROL_LINE_STATE value.                   */
+    CPU_BOOLEAN    NotifyPend;                                  /* SERIAL_STATE notification pending.                   */
+    CPU_BOOLEAN    ZLP_Pend;                                    /* Zero-len pkt must end the current IN xfer.           */
+    USBH_SIM_FIFO  FIFO;                                        /* Loopback data.                                       */
+} USBH_SIM_ACM;
+
+
+/*
+*********************************************************************************************************
+*                                       EMULATED FTDI DEVICE
+*
+* Note(s) : (1) Data received on the bulk OUT EP is sent back on the bulk IN EP. As on the real device,
+*               each IN pkt starts with 2 status octets, and a status-only pkt is returned when no data is
+*               available for 'LatTmr' ms.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sim_ftdi {
+    USBH_SIM_DEV   Dev;
+    CPU_INT08U     ModemStatus;                                 /* First  status octet.                                 */
+    CPU_INT08U     LineStatus;                                  /* Second status octet.                                 */
+    CPU_INT16U     ModemCtrl;                                   /* Last SET_MODEM_CTRL value.                           */
+    CPU_INT16U     BaudDiv;                                     /* Last SET_BAUDRATE value.                             */
+    CPU_INT16U     DataCfg;                                     /* Last SET_DATA value.                                 */
+    CPU_INT08U     LatTmr;                                      /* Latency timer, in ms.                                */
+    CPU_INT32U     LatCnt;                                      /* Frames elapsed since last IN pkt.                    */
+    CPU_INT32U     FrmPerMs;                                    /* Nbr of frames per ms.                                */
+    USBH_SIM_FIFO  FIFO;                                        /* Loopback data.                                       */
+} USBH_SIM_FTDI;
+
+
+/*
+*********************************************************************************************************
+*                                            GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                                 MACROS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                           FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+                                                                /* --------------- DEVICE FRAMEWORK ------------------- */
+USBH_ERR          USBH_SimDev_Init         (void);
+
+void              USBH_SimDev_Lock         (void);
+
+void              USBH_SimDev_Unlock       (void);
+
+USBH_SIM_STATUS   USBH_SimDev_Xact         (USBH_SIM_DEV   *p_dev,
+                                            CPU_INT08U      ep_addr,
+                                            USBH_TOKEN      token,
+                                            CPU_INT08U     *p_buf,
+                                            CPU_INT32U      len,
+                                            CPU_INT32U     *p_xfer_len);
+
+                                                                /* ------------------ PORT FUNCTIONS ------------------ */
+USBH_SIM_DEV     *USBH_SimDev_PortLookup   (USBH_SIM_PORT  *p_port_tbl,
+                                            CPU_INT08U      port_nbr,
+                                            CPU_INT08U      dev_addr);
+
+void              USBH_SimDev_PortTick     (USBH_SIM_PORT  *p_port_tbl,
+                                            CPU_INT08U      port_nbr,
+                                            CPU_INT32U      frm_nbr);
+
+void              USBH_SimDev_PortConn     (USBH_SIM_PORT  *p_port,
+                                            USBH_SIM_DEV   *p_dev);
+
+void              USBH_SimDev_PortDisconn  (USBH_SIM_PORT  *p_port);
+
+CPU_BOOLEAN       USBH_SimDev_PortFeatureSet(USBH_SIM_PORT *p_port,
+                                             CPU_INT16U     feature);
+
+CPU_BOOLEAN       USBH_SimDev_PortFeatureClr(USBH_SIM_PORT *p_port,
+                                             CPU_INT16U     feature);
+
+                                                                /* ------------------ EMULATED DEVICES ---------------- */
+void              USBH_SimDev_HubInit      (USBH_SIM_HUB   *p_hub,
+                                            USBH_DEV_SPD    spd);
+
+USBH_ERR          USBH_SimDev_HubPortConn  (USBH_SIM_HUB   *p_hub,
+                                            CPU_INT08U      port_nbr,
+                                            USBH_SIM_DEV   *p_dev);
+
+USBH_ERR          USBH_SimDev_HubPortDisconn(USBH_SIM_HUB  *p_hub,
+                                             CPU_INT08U     port_nbr);
+
+void              USBH_SimDev_MSC_Init     (USBH_SIM_MSC   *p_msc,
+                                            USBH_DEV_SPD    spd,
+                                            CPU_INT08U     *p_disk,
+                                            CPU_INT32U      blk_size,
+                                            CPU_INT32U      blk_nbr,
+                                            CPU_INT32U      cmd_lat_frm);
+
+void              USBH_SimDev_UAS_Init     (USBH_SIM_UAS   *p_uas,
+                                            USBH_DEV_SPD    spd,
+                                            CPU_INT08U     *p_disk,
+                                            CPU_INT32U      blk_size,
+                                            CPU_INT32U      blk_nbr,
+                                            CPU_INT32U      cmd_lat_frm);
+
+void              USBH_SimDev_HID_Init     (USBH_SIM_HID   *p_hid,
+                                            CPU_INT08U      type,
+                                            CPU_BOOLEAN     auto_en,
+                                            CPU_INT32U      report_period_frm);
+
+USBH_ERR          USBH_SimDev_HID_ReportSet(USBH_SIM_HID   *p_hid,
+                                            CPU_INT08U     *p_report,
+                                            CPU_INT08U      report_len);
+
+void              USBH_SimDev_ACM_Init     (USBH_SIM_ACM   *p_acm);
+
+void              USBH_SimDev_FTDI_Init    (USBH_SIM_FTDI  *p_ftdi,
+                                            CPU_INT32U      frm_per_ms);
+
+
+/*
+*********************************************************************************************************
+*                                          CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE END
+*********************************************************************************************************
+*/
+
+#endif
@@ -448,7 +448,9 @@ static  CPU_INT32U  USBH_TemplateHCD_FrameNbrGet (USBH_HC_DRV  *p_hc_drv,
 *
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Interrupt endpoints should be scheduled at the interval returned by USBH_EP_IntervalGet(),
+*                   in microseconds, which may differ from the endpoint descriptor. If the driver rounds it,
+*                   the interval achieved should be written back to 'p_ep->IntervalUs'.
 *********************************************************************************************************
 */
 
@@ -0,0 +1,1459 @@
+/*
+*********************************************************************************************************
+*                                             uC/USB-Host
+*                                     The Embedded USB Host Stack
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                   USB HOST OPERATING SYSTEM LAYER
+*                                            POSIX (pthreads)
+*
+* Filename : usbh_os.c
+* Version  : V3.42.01
+*********************************************************************************************************
+* Note(s)  : (1) This port lets the stack run as a regular process on a POSIX host (e.g. Linux), together
+*                with the simulated host controller driver (see 'HCD/Sim'). It requires the POSIX port of
+*                uC/CPU, which implements CPU_CRITICAL_ENTER()/CPU_CRITICAL_EXIT() with a process-wide
+*                lock.
+*
+*            (2) OS objects are kept in static tables. The handle of an object is its index in the table
+*                plus one, so that handles fit in 32 bits on 64-bit hosts and 0 is never a valid handle.
+*
+*            (3) Task priorities and stacks are not used: tasks are created as detached threads of the
+*                default scheduling policy, with the default stack size.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define   USBH_OS_MODULE
+#define   MICRIUM_SOURCE
+#define  _GNU_SOURCE
+
+#include  <pthread.h>
+#include  <errno.h>
+#include  <time.h>
+#include  <usbh_cfg.h>
+#include  "../../Source/usbh_os.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  USBH_OS_MUTEX_NBR_MAX              ((((USBH_CFG_MAX_NBR_EPS * USBH_CFG_MAX_NBR_IFS) + 1u) * USBH_CFG_MAX_NBR_DEVS) + \
+                                             USBH_CFG_MAX_NBR_DEVS + USBH_CFG_MAX_NBR_HC +                                    \
+                                             USBH_CDC_CFG_MAX_DEV + USBH_HID_CFG_MAX_DEV + USBH_MSC_CFG_MAX_DEV +             \
+                                            (USBH_FTDI_CFG_MAX_DEV * 2u) + 8u)
+#define  USBH_OS_SEM_NBR_MAX                (8u + (((USBH_CFG_MAX_NBR_EPS * USBH_CFG_MAX_NBR_IFS) + 1u) * USBH_CFG_MAX_NBR_DEVS))
+#define  USBH_OS_TASK_NBR_MAX                16u
+#define  USBH_OS_Q_NBR_MAX                    8u
+#define  USBH_OS_TMR_NBR_MAX                (3u + (((USBH_CFG_MAX_NBR_EPS * USBH_CFG_MAX_NBR_IFS) + 1u) * USBH_CFG_MAX_NBR_DEVS))
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL CONSTANTS
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                          LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_os_mutex {
+    CPU_BOOLEAN       Used;                                     /* Obj allocated.                                       */
+    pthread_mutex_t   Mutex;                                    /* Recursive pthread mutex.                             */
+} USBH_OS_MUTEX;
+
+
+typedef  struct  usbh_os_sem {
+    CPU_BOOLEAN       Used;                                     /* Obj allocated.                                       */
+    pthread_mutex_t   Lock;                                     /* Protects the fields below.                           */
+    pthread_cond_t    Cond;                                     /* Signaled on post and on abort.                       */
+    CPU_INT32U        Cnt;                                      /* Sem cnt.                                             */
+    CPU_INT32U        AbortCtr;                                 /* Incremented by USBH_OS_SemWaitAbort().               */
+} USBH_OS_SEM;
+
+
+typedef  struct  usbh_os_q {
+    CPU_BOOLEAN       Used;                                     /* Obj allocated.                                       */
+    pthread_mutex_t   Lock;                                     /* Protects the fields below.                           */
+    pthread_cond_t    Cond;                                     /* Signaled on put.                                     */
+    void            **BufPtr;                                   /* Msg storage supplied by caller.                      */
+    CPU_INT16U        Size;                                     /* Nbr of msg storage slots.                            */
+    CPU_INT16U        InIx;                                     /* Ix of next slot to put.                              */
+    CPU_INT16U        OutIx;                                    /* Ix of next slot to get.                              */
+    CPU_INT16U        Cnt;                                      /* Nbr of msg in Q.                                     */
+} USBH_OS_Q;
+
+
+typedef  struct  usbh_os_task {
+    CPU_BOOLEAN       Used;                                     /* Obj allocated.                                       */
+    pthread_t         Thread;                                   /* Thread running the task.                             */
+    USBH_TASK_FNCT    Fnct;                                     /* Task fnct.                                           */
+    void             *ArgPtr;                                   /* Arg passed to task fnct.                             */
+} USBH_OS_TASK;
+
+
+typedef  struct  usbh_os_tmr {
+    CPU_BOOLEAN       Used;                                     /* Obj allocated.                                       */
+    CPU_BOOLEAN       Active;                                   /* Tmr started and not expired yet.                     */
+    struct  timespec  Deadline;                                 /* Expiry time (CLOCK_MONOTONIC).                       */
+    CPU_INT32U        IntervalMs;                               /* Tmr interval, in ms.                                 */
+
+    void            (*CallbackFnct)(void  *p_tmr,               /* Tmr registered callback fnct.                        */
+                                    void  *p_arg);
+    void             *CallbackArg;                              /* Arg to pass to callback fnct.                        */
+} USBH_OS_TMR;
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  USBH_OS_MUTEX    USBH_OS_MutexTbl[USBH_OS_MUTEX_NBR_MAX];
+static  USBH_OS_SEM      USBH_OS_SemTbl[USBH_OS_SEM_NBR_MAX];
+static  USBH_OS_Q        USBH_OS_Q_Tbl[USBH_OS_Q_NBR_MAX];
+static  USBH_OS_TASK     USBH_OS_TaskTbl[USBH_OS_TASK_NBR_MAX];
+static  USBH_OS_TMR      USBH_OS_TmrTbl[USBH_OS_TMR_NBR_MAX];
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  pthread_mutex_t  USBH_OS_TblLock = PTHREAD_MUTEX_INITIALIZER;  /* Protects obj alloc in all tbls.           */
+
+static  pthread_mutex_t  USBH_OS_TmrLock = PTHREAD_MUTEX_INITIALIZER;  /* Protects tmr tbl state.                   */
+static  pthread_cond_t   USBH_OS_TmrCond;                       /* Signaled when a tmr is started or deleted.           */
+static  pthread_t        USBH_OS_TmrThread;                     /* Tmr service thread.                                  */
+static  CPU_BOOLEAN      USBH_OS_TmrThreadRun = DEF_FALSE;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         USBH_OS_AbsTimeGet   (struct  timespec  *p_ts,
+                                           CPU_INT32U         dly_ms);
+
+static  CPU_BOOLEAN  USBH_OS_AbsTimeIsPast(struct  timespec  *p_ts,
+                                           struct  timespec  *p_now);
+
+static  USBH_ERR     USBH_OS_CondInit     (pthread_cond_t    *p_cond);
+
+static  void        *USBH_OS_TaskStart    (void              *p_arg);
+
+static  void        *USBH_OS_TmrTask      (void              *p_arg);
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_LayerInit()
+*
+* Description : Initialize OS layer.
+*
+* Argument(s) : none.
+*
+* Return(s)   : USBH_ERR_NONE,              if successful.
+*               USBH_ERR_OS_SIGNAL_CREATE,  if timer service signal could not be created.
+*               USBH_ERR_OS_TASK_CREATE,    if timer service thread could not be created.
+*
+* Note(s)     : (1) The timer service thread is created once, even if this function is called again.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_LayerInit (void)
+{
+    USBH_ERR  err;
+    int       err_posix;
+
+
+    (void)pthread_mutex_lock(&USBH_OS_TmrLock);
+    if (USBH_OS_TmrThreadRun == DEF_TRUE) {                     /* See Note #1.                                         */
+        (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+        return (USBH_ERR_NONE);
+    }
+
+    err = USBH_OS_CondInit(&USBH_OS_TmrCond);
+    if (err != USBH_ERR_NONE) {
+        (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+        return (err);
+    }
+
+    err_posix = pthread_create(&USBH_OS_TmrThread,
+                               (pthread_attr_t *)0,
+                                USBH_OS_TmrTask,
+                               (void *)0);
+    if (err_posix != 0) {
+        (void)pthread_cond_destroy(&USBH_OS_TmrCond);
+        (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+        return (USBH_ERR_OS_TASK_CREATE);
+    }
+
+    (void)pthread_detach(USBH_OS_TmrThread);
+    USBH_OS_TmrThreadRun = DEF_TRUE;
+    (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+**************************************************************************************************************
+*                                       USBH_OS_VirToBus()
+*
+* Description : Convert from virtual address to physical address if the operating system uses
+*               virtual memory
+*
+* Arguments   : x   Virtual address to convert
+*
+* Returns     :     The corresponding physical address
+*
+* Note(s)     : (1) Buffers are only accessed by the simulated host controller, from the same process.
+**************************************************************************************************************
+*/
+
+void  *USBH_OS_VirToBus (void  *x)
+{
+    return (x);                                                 /* See Note #1                                          */
+}
+
+
+/*
+**************************************************************************************************************
+*                                       USBH_OS_BusToVir()
+*
+* Description : Convert from physical address to virtual address if the operating system uses
+*               virtual memory
+*
+* Arguments   : x   Physical address to convert
+*
+* Returns     :     The corresponding virtual address
+*
+* Note(s)     : (1) Buffers are only accessed by the simulated host controller, from the same process.
+**************************************************************************************************************
+*/
+
+void  *USBH_OS_BusToVir (void  *x)
+{
+    return (x);                                                 /* See Note #1                                          */
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           DELAY FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                           USBH_OS_DlyMS()
+*
+* Description : Delay the current task by specified delay.
+*
+* Argument(s) : dly       Delay, in milliseconds.
+*
+* Return(s)   : none.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  USBH_OS_DlyMS (CPU_INT32U  dly)
+{
+    USBH_OS_DlyUS(dly * DEF_TIME_NBR_uS_PER_SEC / DEF_TIME_NBR_mS_PER_SEC);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_OS_DlyUS()
+*
+* Description : Delay the current task by specified delay.
+*
+* Argument(s) : dly       Delay, in microseconds.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The delay is restarted with the remaining time when interrupted by a signal.
+*********************************************************************************************************
+*/
+
+void  USBH_OS_DlyUS (CPU_INT32U  dly)
+{
+    struct  timespec  req;
+    struct  timespec  rem;
+
+
+    req.tv_sec  = (time_t)(dly / DEF_TIME_NBR_uS_PER_SEC);
+    req.tv_nsec = (long)  (dly % DEF_TIME_NBR_uS_PER_SEC) * 1000L;
+
+    while (nanosleep(&req, &rem) != 0) {                        /* See Note #1.                                         */
+        if (errno != EINTR) {
+            break;
+        }
+        req = rem;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_OS_TimeGet()
+*
+* Description : Get current time.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Current time, in milliseconds.
+*
+* Note(s)     : (1) The returned value is taken from CLOCK_MONOTONIC. It wraps around and is only
+*                   meaningful as a difference between two calls.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_OS_TimeGet (void)
+{
+    struct  timespec  now;
+
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((CPU_INT32U)((CPU_INT32U)now.tv_sec  * DEF_TIME_NBR_mS_PER_SEC +
+                         (CPU_INT32U)now.tv_nsec / 1000000u));
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           MUTEX FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_OS_MutexCreate()
+*
+* Description : Create a mutex.
+*
+* Argument(s) : p_mutex    Pointer to variable that will receive handle of the mutex.
+*
+* Return(s)   : USBH_ERR_NONE,              if successful.
+*               USBH_ERR_ALLOC,             if no more mutex available.
+*               USBH_ERR_OS_SIGNAL_CREATE,  if mutex could not be initialized.
+*
+* Note(s)     : (1) Mutexes are recursive, like uC/OS-III mutexes.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_MutexCreate (USBH_HMUTEX  *p_mutex)
+{
+    USBH_OS_MUTEX        *p_os_mutex;
+    pthread_mutexattr_t   attr;
+    CPU_INT32U            ix;
+    int                   err_posix;
+
+
+    (void)pthread_mutex_lock(&USBH_OS_TblLock);
+    for (ix = 0u; ix < USBH_OS_MUTEX_NBR_MAX; ix++) {
+        if (USBH_OS_MutexTbl[ix].Used == DEF_FALSE) {
+            USBH_OS_MutexTbl[ix].Used = DEF_TRUE;
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&USBH_OS_TblLock);
+
+    if (ix >= USBH_OS_MUTEX_NBR_MAX) {
+        return (USBH_ERR_ALLOC);
+    }
+
+    p_os_mutex = &USBH_OS_MutexTbl[ix];
+
+    (void)pthread_mutexattr_init(&attr);
+    (void)pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);  /* See Note #1.                                   */
+    err_posix = pthread_mutex_init(&p_os_mutex->Mutex, &attr);
+    (void)pthread_mutexattr_destroy(&attr);
+    if (err_posix != 0) {
+        p_os_mutex->Used = DEF_FALSE;
+        return (USBH_ERR_OS_SIGNAL_CREATE);
+    }
+
+   *p_mutex = (USBH_HMUTEX)(ix + 1u);                           /* See 'usbh_os.c  Note #2'.                            */
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_MutexLock()
+*
+* Description : Acquire a mutex.
+*
+* Argument(s) : mutex     Mutex handle.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*               USBH_ERR_OS_FAIL,       otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_MutexLock (USBH_HMUTEX  mutex)
+{
+    int  err_posix;
+
+
+    if ((mutex == 0u) ||
+        (mutex >  USBH_OS_MUTEX_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err_posix = pthread_mutex_lock(&USBH_OS_MutexTbl[mutex - 1u].Mutex);
+    if (err_posix != 0) {
+        return (USBH_ERR_OS_FAIL);
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_OS_MutexUnlock()
+*
+* Description : Releases a mutex.
+*
+* Argument(s) : mutex     Mutex handle.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*               USBH_ERR_OS_FAIL,       otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_MutexUnlock (USBH_HMUTEX  mutex)
+{
+    int  err_posix;
+
+
+    if ((mutex == 0u) ||
+        (mutex >  USBH_OS_MUTEX_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    err_posix = pthread_mutex_unlock(&USBH_OS_MutexTbl[mutex - 1u].Mutex);
+    if (err_posix != 0) {
+        return (USBH_ERR_OS_FAIL);
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_OS_MutexDestroy()
+*
+* Description : Destroys a mutex only when no task is holding the mutex.
+*
+* Argument(s) : mutex     Mutex handle.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*               USBH_ERR_OS_FAIL,       if mutex delete failed.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_MutexDestroy (USBH_HMUTEX  mutex)
+{
+    USBH_OS_MUTEX  *p_os_mutex;
+    int             err_posix;
+
+
+    if ((mutex == 0u) ||
+        (mutex >  USBH_OS_MUTEX_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_mutex = &USBH_OS_MutexTbl[mutex - 1u];
+    err_posix  =  pthread_mutex_destroy(&p_os_mutex->Mutex);
+    if (err_posix != 0) {
+        return (USBH_ERR_OS_FAIL);
+    }
+
+    (void)pthread_mutex_lock(&USBH_OS_TblLock);
+    p_os_mutex->Used = DEF_FALSE;
+    (void)pthread_mutex_unlock(&USBH_OS_TblLock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                         SEMAPHORE FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_SemCreate()
+*
+* Description : Create semaphore with given count.
+*
+* Argument(s) : p_sem      Pointer that will receive handle for managing semaphore.
+*
+*               cnt        Value with which the semaphore will be initialized.
+*
+* Return(s)   : USBH_ERR_NONE,              if successful.
+*               USBH_ERR_ALLOC,             if no more semaphore available.
+*               USBH_ERR_OS_SIGNAL_CREATE,  if semaphore could not be initialized.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_SemCreate (USBH_HSEM   *p_sem,
+                             CPU_INT32U   cnt)
+{
+    USBH_OS_SEM  *p_os_sem;
+    CPU_INT32U    ix;
+    USBH_ERR      err;
+
+
+    (void)pthread_mutex_lock(&USBH_OS_TblLock);
+    for (ix = 0u; ix < USBH_OS_SEM_NBR_MAX; ix++) {
+        if (USBH_OS_SemTbl[ix].Used == DEF_FALSE) {
+            USBH_OS_SemTbl[ix].Used = DEF_TRUE;
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&USBH_OS_TblLock);
+
+    if (ix >= USBH_OS_SEM_NBR_MAX) {
+        return (USBH_ERR_ALLOC);
+    }
+
+    p_os_sem           = &USBH_OS_SemTbl[ix];
+    p_os_sem->Cnt      =  cnt;
+    p_os_sem->AbortCtr =  0u;
+
+    if (pthread_mutex_init(&p_os_sem->Lock, (pthread_mutexattr_t *)0) != 0) {
+        p_os_sem->Used = DEF_FALSE;
+        return (USBH_ERR_OS_SIGNAL_CREATE);
+    }
+
+    err = USBH_OS_CondInit(&p_os_sem->Cond);
+    if (err != USBH_ERR_NONE) {
+        (void)pthread_mutex_destroy(&p_os_sem->Lock);
+        p_os_sem->Used = DEF_FALSE;
+        return (err);
+    }
+
+   *p_sem = (USBH_HSEM)(ix + 1u);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_SemDestroy()
+*
+* Description : Destroy a semphore.
+*
+* Argument(s) : sem       Semaphore handle.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_SemDestroy (USBH_HSEM  sem)
+{
+    USBH_OS_SEM  *p_os_sem;
+
+
+    if ((sem == 0u) ||
+        (sem >  USBH_OS_SEM_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_sem = &USBH_OS_SemTbl[sem - 1u];
+
+    (void)pthread_cond_destroy(&p_os_sem->Cond);
+    (void)pthread_mutex_destroy(&p_os_sem->Lock);
+
+    (void)pthread_mutex_lock(&USBH_OS_TblLock);
+    p_os_sem->Used = DEF_FALSE;
+    (void)pthread_mutex_unlock(&USBH_OS_TblLock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_OS_SemWait()
+*
+* Description : Wait on a semaphore to become available.
+*
+* Argument(s) : sem       Semaphore handle.
+*
+*               timeout   Timeout, in milliseconds. 0 means wait forever.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_OS_TIMEOUT,    if timeout error.
+*               USBH_ERR_OS_ABORT,      if wait aborted by USBH_OS_SemWaitAbort().
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*               USBH_ERR_OS_FAIL,       otherwise.
+*
+* Note(s)     : (1) A waiter records the abort counter when it starts waiting. It is aborted when the
+*                   counter changes, so that only the tasks waiting at the time of the abort are resumed.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_SemWait (USBH_HSEM   sem,
+                           CPU_INT32U  timeout)
+{
+    USBH_OS_SEM       *p_os_sem;
+    struct  timespec   deadline;
+    CPU_INT32U         abort_ctr;
+    USBH_ERR           err;
+    int                err_posix;
+
+
+    if ((sem == 0u) ||
+        (sem >  USBH_OS_SEM_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_sem = &USBH_OS_SemTbl[sem - 1u];
+    if (timeout != 0u) {
+        USBH_OS_AbsTimeGet(&deadline, timeout);
+    }
+
+    (void)pthread_mutex_lock(&p_os_sem->Lock);
+    abort_ctr = p_os_sem->AbortCtr;                             /* See Note #1.                                         */
+    err       = USBH_ERR_NONE;
+
+    while (p_os_sem->Cnt == 0u) {
+        if (timeout == 0u) {
+            err_posix = pthread_cond_wait(&p_os_sem->Cond, &p_os_sem->Lock);
+        } else {
+            err_posix = pthread_cond_timedwait(&p_os_sem->Cond, &p_os_sem->Lock, &deadline);
+        }
+
+        if (p_os_sem->AbortCtr != abort_ctr) {
+            err = USBH_ERR_OS_ABORT;
+            break;
+        }
+        if (err_posix == ETIMEDOUT) {
+            if (p_os_sem->Cnt == 0u) {
+                err = USBH_ERR_OS_TIMEOUT;
+            }
+            break;
+        }
+        if ((err_posix != 0) &&
+            (err_posix != EINTR)) {
+            err = USBH_ERR_OS_FAIL;
+            break;
+        }
+    }
+
+    if (err == USBH_ERR_NONE) {
+        p_os_sem->Cnt--;
+    }
+    (void)pthread_mutex_unlock(&p_os_sem->Lock);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_OS_SemWaitAbort()
+*
+* Description : Resume all tasks waiting on specified semaphore.
+*
+* Argument(s) : sem       Semaphore handle.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_SemWaitAbort (USBH_HSEM  sem)
+{
+    USBH_OS_SEM  *p_os_sem;
+
+
+    if ((sem == 0u) ||
+        (sem >  USBH_OS_SEM_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_sem = &USBH_OS_SemTbl[sem - 1u];
+
+    (void)pthread_mutex_lock(&p_os_sem->Lock);
+    p_os_sem->AbortCtr++;
+    (void)pthread_cond_broadcast(&p_os_sem->Cond);
+    (void)pthread_mutex_unlock(&p_os_sem->Lock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_OS_SemPost()
+*
+* Description : Post a semaphore.
+*
+* Argument(s) : sem       Semaphore handle.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_SemPost (USBH_HSEM  sem)
+{
+    USBH_OS_SEM  *p_os_sem;
+
+
+    if ((sem == 0u) ||
+        (sem >  USBH_OS_SEM_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_sem = &USBH_OS_SemTbl[sem - 1u];
+
+    (void)pthread_mutex_lock(&p_os_sem->Lock);
+    p_os_sem->Cnt++;
+    (void)pthread_cond_signal(&p_os_sem->Cond);
+    (void)pthread_mutex_unlock(&p_os_sem->Lock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                          THREAD FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_OS_TaskCreate()
+*
+* Description : Create a thread (or task).
+*
+* Argument(s) : p_name          Pointer to name to assign to thread.
+*
+*               prio            Priority of the thread to be created.
+*
+*               task_fnct       Pointer to the function that will be executed in this thread.
+*
+*               p_data          Pointer to the data that is passed to the thread function.
+*
+*               p_stk           Pointer to the beginning of the stack used by the thread.
+*
+*               stk_size        Size of the stack.
+*
+*               p_task          Pointer that will receive handle for managing thread.
+*
+* Return(s)   : USBH_ERR_NONE,               if successful.
+*               USBH_ERR_ALLOC,              if no more task available.
+*               USBH_ERR_OS_TASK_CREATE,     if thread could not be created.
+*
+* Note(s)     : (1) See 'usbh_os.c  Note #3'.
+*
+*               (2) The thread name is truncated to 15 characters by the host OS.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_TaskCreate (CPU_CHAR        *p_name,
+                              CPU_INT32U       prio,
+                              USBH_TASK_FNCT   task_fnct,
+                              void            *p_data,
+                              CPU_INT32U      *p_stk,
+                              CPU_INT32U       stk_size,
+                              USBH_HTASK      *p_task)
+{
+    USBH_OS_TASK  *p_os_task;
+    CPU_INT32U     ix;
+    CPU_CHAR       name[16];
+    int            err_posix;
+
+
+    (void)prio;                                                 /* See Note #1.                                         */
+    (void)p_stk;
+    (void)stk_size;
+
+    (void)pthread_mutex_lock(&USBH_OS_TblLock);
+    for (ix = 0u; ix < USBH_OS_TASK_NBR_MAX; ix++) {
+        if (USBH_OS_TaskTbl[ix].Used == DEF_FALSE) {
+            USBH_OS_TaskTbl[ix].Used = DEF_TRUE;
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&USBH_OS_TblLock);
+
+    if (ix >= USBH_OS_TASK_NBR_MAX) {
+        return (USBH_ERR_ALLOC);
+    }
+
+    p_os_task         = &USBH_OS_TaskTbl[ix];
+    p_os_task->Fnct   =  task_fnct;
+    p_os_task->ArgPtr =  p_data;
+
+    err_posix = pthread_create(&p_os_task->Thread,
+                               (pthread_attr_t *)0,
+                                USBH_OS_TaskStart,
+                               (void *)p_os_task);
+    if (err_posix != 0) {
+        p_os_task->Used = DEF_FALSE;
+        return (USBH_ERR_OS_TASK_CREATE);
+    }
+
+    (void)pthread_detach(p_os_task->Thread);
+
+    if (p_name != (CPU_CHAR *)0) {                              /* See Note #2.                                         */
+        Mem_Clr((void *)name, sizeof(name));
+        for (ix = 0u; (ix < (sizeof(name) - 1u)) && (p_name[ix] != '\0'); ix++) {
+            name[ix] = p_name[ix];
+        }
+        (void)pthread_setname_np(p_os_task->Thread, name);
+    }
+
+   *p_task = (USBH_HTASK)((p_os_task - &USBH_OS_TaskTbl[0]) + 1u);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                            MESSAGE QUEUE
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                       USBH_OS_MsgQueueCreate()
+*
+* Description : Create a message queue.
+*
+* Argument(s) : p_start         Pointer to the base address of the message queue storage area.
+*
+*               size            Number of elements in the storage area.
+*
+*               p_err           Pointer to variable that will receive the return error code from this function:
+*
+*                                   USBH_ERR_NONE               Message queue created.
+*                                   USBH_ERR_INVALID_ARG        Invalid storage area.
+*                                   USBH_ERR_ALLOC              Message queue creation failed.
+*                                   USBH_ERR_OS_SIGNAL_CREATE
+*
+* Return(s)   : The handle of the message queue.
+*
+* Note(s)     : (1) Messages are stored in the storage area supplied by the caller.
+*********************************************************************************************************
+*/
+
+USBH_HQUEUE  USBH_OS_MsgQueueCreate (void        **p_start,
+                                     CPU_INT16U    size,
+                                     USBH_ERR     *p_err)
+{
+    USBH_OS_Q   *p_os_q;
+    CPU_INT32U   ix;
+
+
+    if ((p_start == (void **)0) ||                              /* See Note #1.                                         */
+        (size    ==  0u)) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return ((USBH_HQUEUE)0);
+    }
+
+    (void)pthread_mutex_lock(&USBH_OS_TblLock);
+    for (ix = 0u; ix < USBH_OS_Q_NBR_MAX; ix++) {
+        if (USBH_OS_Q_Tbl[ix].Used == DEF_FALSE) {
+            USBH_OS_Q_Tbl[ix].Used = DEF_TRUE;
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&USBH_OS_TblLock);
+
+    if (ix >= USBH_OS_Q_NBR_MAX) {
+       *p_err = USBH_ERR_ALLOC;
+        return ((USBH_HQUEUE)0);
+    }
+
+    p_os_q         = &USBH_OS_Q_Tbl[ix];
+    p_os_q->BufPtr =  p_start;
+    p_os_q->Size   =  size;
+    p_os_q->InIx   =  0u;
+    p_os_q->OutIx  =  0u;
+    p_os_q->Cnt    =  0u;
+
+    if (pthread_mutex_init(&p_os_q->Lock, (pthread_mutexattr_t *)0) != 0) {
+        p_os_q->Used = DEF_FALSE;
+       *p_err        = USBH_ERR_OS_SIGNAL_CREATE;
+        return ((USBH_HQUEUE)0);
+    }
+
+   *p_err = USBH_OS_CondInit(&p_os_q->Cond);
+    if (*p_err != USBH_ERR_NONE) {
+        (void)pthread_mutex_destroy(&p_os_q->Lock);
+        p_os_q->Used = DEF_FALSE;
+        return ((USBH_HQUEUE)0);
+    }
+
+    return ((USBH_HQUEUE)(ix + 1u));
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_OS_MsgQueuePut()
+*
+* Description : Post a message to a message queue.
+*
+* Argument(s) : msg_q     Message queue handle.
+*
+*               p_msg     Pointer to the message to send.
+*
+* Return(s)   : USBH_ERR_NONE,          if successful.
+*               USBH_ERR_INVALID_ARG,   if invalid handle.
+*               USBH_ERR_OS_FAIL,       if queue is full.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_MsgQueuePut (USBH_HQUEUE   msg_q,
+                               void         *p_msg)
+{
+    USBH_OS_Q  *p_os_q;
+
+
+    if ((msg_q == 0u) ||
+        (msg_q >  USBH_OS_Q_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_q = &USBH_OS_Q_Tbl[msg_q - 1u];
+
+    (void)pthread_mutex_lock(&p_os_q->Lock);
+    if (p_os_q->Cnt >= p_os_q->Size) {
+        (void)pthread_mutex_unlock(&p_os_q->Lock);
+        return (USBH_ERR_OS_FAIL);
+    }
+
+    p_os_q->BufPtr[p_os_q->InIx] = p_msg;
+    p_os_q->InIx++;
+    if (p_os_q->InIx >= p_os_q->Size) {
+        p_os_q->InIx = 0u;
+    }
+    p_os_q->Cnt++;
+
+    (void)pthread_cond_signal(&p_os_q->Cond);
+    (void)pthread_mutex_unlock(&p_os_q->Lock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_OS_MsgQueueGet()
+*
+* Description : Get a message from a message queue.
+*
+* Argument(s) : msg_q     Message queue handle.
+*
+*               timeout   Time to wait for a message, in milliseconds. 0 means wait forever.
+*
+*               p_err     Pointer to variable that will receive the return error code from this function :
+*
+*                         USBH_ERR_NONE,           if successful.
+*                         USBH_ERR_OS_TIMEOUT,
+*                         USBH_ERR_INVALID_ARG,
+*                         USBH_ERR_OS_FAIL,
+*
+* Return(s)   : Pointer to message, if successful.
+*               Pointer to null,    otherwise.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  *USBH_OS_MsgQueueGet (USBH_HQUEUE   msg_q,
+                            CPU_INT32U    timeout,
+                            USBH_ERR     *p_err)
+{
+    USBH_OS_Q         *p_os_q;
+    struct  timespec   deadline;
+    void              *p_msg;
+    int                err_posix;
+
+
+    if ((msg_q == 0u) ||
+        (msg_q >  USBH_OS_Q_NBR_MAX)) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return ((void *)0);
+    }
+
+    p_os_q = &USBH_OS_Q_Tbl[msg_q - 1u];
+    if (timeout != 0u) {
+        USBH_OS_AbsTimeGet(&deadline, timeout);
+    }
+
+    (void)pthread_mutex_lock(&p_os_q->Lock);
+   *p_err = USBH_ERR_NONE;
+    while (p_os_q->Cnt == 0u) {
+        if (timeout == 0u) {
+            err_posix = pthread_cond_wait(&p_os_q->Cond, &p_os_q->Lock);
+        } else {
+            err_posix = pthread_cond_timedwait(&p_os_q->Cond, &p_os_q->Lock, &deadline);
+        }
+
+        if (err_posix == ETIMEDOUT) {
+            if (p_os_q->Cnt == 0u) {
+               *p_err = USBH_ERR_OS_TIMEOUT;
+            }
+            break;
+        }
+        if ((err_posix != 0) &&
+            (err_posix != EINTR)) {
+           *p_err = USBH_ERR_OS_FAIL;
+            break;
+        }
+    }
+
+    p_msg = (void *)0;
+    if (*p_err == USBH_ERR_NONE) {
+        p_msg = p_os_q->BufPtr[p_os_q->OutIx];
+        p_os_q->OutIx++;
+        if (p_os_q->OutIx >= p_os_q->Size) {
+            p_os_q->OutIx = 0u;
+        }
+        p_os_q->Cnt--;
+    }
+    (void)pthread_mutex_unlock(&p_os_q->Lock);
+
+    return (p_msg);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                    INTERNAL USE TIMER FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_TmrCreate()
+*
+* Description : Create a one-shot timer.
+*
+* Argument(s) : p_name          Pointer to name of the timer.
+*
+*               interval_ms     Delay used by the timer, in milliseconds.
+*
+*               p_callback      Pointer to the callback function that will be called on completion of timer.
+*                               The callback function must be declared as follows:
+*
+*                               void MyCallback (void *ptmr, void *p_arg);
+*
+*               p_callback_arg  Argument passed to callback function.
+*
+*               p_err           Pointer to variable that will receive the return error code from this function:
+*
+*                                   USBH_ERR_NONE               Software timer created.
+*                                   USBH_ERR_ALLOC              Software timer creation failed.
+*
+* Return(s)   : Handle on One-Shot Timer.
+*
+* Note(s)     : (1) Timer callbacks are called from the timer service thread, one at a time.
+*
+*               (2) This function should never be called by your application.
+*********************************************************************************************************
+*/
+
+USBH_HTMR  USBH_OS_TmrCreate (CPU_CHAR     *p_name,
+                              CPU_INT32U    interval_ms,
+                              void        (*p_callback)(void *p_tmr, void *p_arg),
+                              void         *p_callback_arg,
+                              USBH_ERR     *p_err)
+{
+    USBH_OS_TMR  *p_os_tmr;
+    CPU_INT32U    ix;
+
+
+    (void)p_name;
+
+    (void)pthread_mutex_lock(&USBH_OS_TmrLock);
+    for (ix = 0u; ix < USBH_OS_TMR_NBR_MAX; ix++) {
+        if (USBH_OS_TmrTbl[ix].Used == DEF_FALSE) {
+            break;
+        }
+    }
+
+    if (ix >= USBH_OS_TMR_NBR_MAX) {
+        (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+       *p_err = USBH_ERR_ALLOC;
+        return ((USBH_HTMR)0);
+    }
+
+    p_os_tmr               = &USBH_OS_TmrTbl[ix];
+    p_os_tmr->Used         =  DEF_TRUE;
+    p_os_tmr->Active       =  DEF_FALSE;
+    p_os_tmr->IntervalMs   =  interval_ms;
+    p_os_tmr->CallbackFnct =  p_callback;
+    p_os_tmr->CallbackArg  =  p_callback_arg;
+    (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+
+   *p_err = USBH_ERR_NONE;
+
+    return ((USBH_HTMR)(ix + 1u));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_TmrStart()
+*
+* Description : Start a timer.
+*
+* Argument(s) : tmr     Handle on timer.
+*
+* Return(s)   : USBH_ERR_NONE           If timer start was successful.
+*               USBH_ERR_INVALID_ARG    If invalid argument passed to 'tmr'.
+*
+* Note(s)     : (1) Starting an active timer restarts it with its full interval.
+*
+*               (2) This function should never be called by your application.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_TmrStart (USBH_HTMR  tmr)
+{
+    USBH_OS_TMR  *p_os_tmr;
+
+
+    if ((tmr == 0u) ||
+        (tmr >  USBH_OS_TMR_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_tmr = &USBH_OS_TmrTbl[tmr - 1u];
+
+    (void)pthread_mutex_lock(&USBH_OS_TmrLock);
+    if (p_os_tmr->Used == DEF_FALSE) {
+        (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_OS_AbsTimeGet(&p_os_tmr->Deadline, p_os_tmr->IntervalMs);
+    p_os_tmr->Active = DEF_TRUE;                                /* See Note #1.                                         */
+
+    (void)pthread_cond_signal(&USBH_OS_TmrCond);
+    (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_OS_TmrDel()
+*
+* Description : Delete a timer.
+*
+* Argument(s) : tmr     Handle on timer.
+*
+* Return(s)   : USBH_ERR_NONE           If timer delete was successful.
+*               USBH_ERR_INVALID_ARG    If invalid argument passed to 'tmr'.
+*
+* Note(s)     : This function should never be called by your application.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_OS_TmrDel (USBH_HTMR  tmr)
+{
+    USBH_OS_TMR  *p_os_tmr;
+
+
+    if ((tmr == 0u) ||
+        (tmr >  USBH_OS_TMR_NBR_MAX)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    p_os_tmr = &USBH_OS_TmrTbl[tmr - 1u];
+
+    (void)pthread_mutex_lock(&USBH_OS_TmrLock);
+    p_os_tmr->Active = DEF_FALSE;
+    p_os_tmr->Used   = DEF_FALSE;
+    (void)pthread_cond_signal(&USBH_OS_TmrCond);
+    (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                        USBH_OS_AbsTimeGet()
+*
+* Description : Compute the absolute CLOCK_MONOTONIC time at which a delay expires.
+*
+* Argument(s) : p_ts        Pointer to variable that will receive the absolute time.
+*
+*               dly_ms      Delay, in milliseconds.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_OS_AbsTimeGet (struct  timespec  *p_ts,
+                                  CPU_INT32U         dly_ms)
+{
+    (void)clock_gettime(CLOCK_MONOTONIC, p_ts);
+
+    p_ts->tv_sec  += (time_t)(dly_ms / DEF_TIME_NBR_mS_PER_SEC);
+    p_ts->tv_nsec += (long)  (dly_ms % DEF_TIME_NBR_mS_PER_SEC) * 1000000L;
+    if (p_ts->tv_nsec >= 1000000000L) {
+        p_ts->tv_sec++;
+        p_ts->tv_nsec -= 1000000000L;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_OS_AbsTimeIsPast()
+*
+* Description : Determine if an absolute time is reached.
+*
+* Argument(s) : p_ts        Pointer to absolute time.
+*
+*               p_now       Pointer to current time.
+*
+* Return(s)   : DEF_YES, if absolute time is reached.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_OS_AbsTimeIsPast (struct  timespec  *p_ts,
+                                            struct  timespec  *p_now)
+{
+    if (p_ts->tv_sec != p_now->tv_sec) {
+        return ((p_ts->tv_sec < p_now->tv_sec) ? DEF_YES : DEF_NO);
+    }
+
+    return ((p_ts->tv_nsec <= p_now->tv_nsec) ? DEF_YES : DEF_NO);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_CondInit()
+*
+* Description : Initialize a condition variable that measures timeouts on CLOCK_MONOTONIC.
+*
+* Argument(s) : p_cond      Pointer to condition variable.
+*
+* Return(s)   : USBH_ERR_NONE,              if successful.
+*               USBH_ERR_OS_SIGNAL_CREATE,  otherwise.
+*
+* Note(s)     : (1) Timeouts are not affected by changes of the wall clock.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_OS_CondInit (pthread_cond_t  *p_cond)
+{
+    pthread_condattr_t  attr;
+    int                 err_posix;
+
+
+    (void)pthread_condattr_init(&attr);
+    (void)pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);    /* See Note #1.                                         */
+    err_posix = pthread_cond_init(p_cond, &attr);
+    (void)pthread_condattr_destroy(&attr);
+
+    if (err_posix != 0) {
+        return (USBH_ERR_OS_SIGNAL_CREATE);
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_OS_TaskStart()
+*
+* Description : Thread entry point, runs a task function.
+*
+* Argument(s) : p_arg       Pointer to task object.
+*
+* Return(s)   : Pointer to null.
+*
+* Note(s)     : (1) Task functions are not expected to return. If one does, its task object is freed.
+*********************************************************************************************************
+*/
+
+static  void  *USBH_OS_TaskStart (void  *p_arg)
+{
+    USBH_OS_TASK  *p_os_task;
+
+
+    p_os_task = (USBH_OS_TASK *)p_arg;
+    p_os_task->Fnct(p_os_task->ArgPtr);
+
+    (void)pthread_mutex_lock(&USBH_OS_TblLock);                 /* See Note #1.                                         */
+    p_os_task->Used = DEF_FALSE;
+    (void)pthread_mutex_unlock(&USBH_OS_TblLock);
+
+    return ((void *)0);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_OS_TmrTask()
+*
+* Description : Timer service thread. Calls the callback of each timer that expires.
+*
+* Argument(s) : p_arg       Unused.
+*
+* Return(s)   : Pointer to null.
+*
+* Note(s)     : (1) The timer lock is released while a callback runs, so that the callback can start or
+*                   delete timers.
+*********************************************************************************************************
+*/
+
+static  void  *USBH_OS_TmrTask (void  *p_arg)
+{
+    USBH_OS_TMR       *p_os_tmr;
+    USBH_OS_TMR       *p_os_tmr_nxt;
+    struct  timespec   now;
+    CPU_INT32U         ix;
+    void             (*p_callback)(void *p_tmr, void *p_arg);
+    void              *p_callback_arg;
+
+
+    (void)p_arg;
+
+    (void)pthread_mutex_lock(&USBH_OS_TmrLock);
+    while (DEF_TRUE) {
+        (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+        p_os_tmr     = (USBH_OS_TMR *)0;                        /* Find an expired tmr and the next one to expire.      */
+        p_os_tmr_nxt = (USBH_OS_TMR *)0;
+        for (ix = 0u; ix < USBH_OS_TMR_NBR_MAX; ix++) {
+            if (USBH_OS_TmrTbl[ix].Active == DEF_FALSE) {
+                continue;
+            }
+            if (USBH_OS_AbsTimeIsPast(&USBH_OS_TmrTbl[ix].Deadline, &now) == DEF_YES) {
+                p_os_tmr = &USBH_OS_TmrTbl[ix];
+                break;
+            }
+            if ((p_os_tmr_nxt == (USBH_OS_TMR *)0) ||
+                (USBH_OS_AbsTimeIsPast(&USBH_OS_TmrTbl[ix].Deadline, &p_os_tmr_nxt->Deadline) == DEF_YES)) {
+                p_os_tmr_nxt = &USBH_OS_TmrTbl[ix];
+            }
+        }
+
+        if (p_os_tmr != (USBH_OS_TMR *)0) {                     /* Expired tmr: call its callback (see Note #1).        */
+            p_os_tmr->Active = DEF_FALSE;
+            p_callback       = p_os_tmr->CallbackFnct;
+            p_callback_arg   = p_os_tmr->CallbackArg;
+
+            (void)pthread_mutex_unlock(&USBH_OS_TmrLock);
+            if (p_callback != 0) {
+                p_callback((void *)p_os_tmr, p_callback_arg);
+            }
+            (void)pthread_mutex_lock(&USBH_OS_TmrLock);
+
+        } else if (p_os_tmr_nxt != (USBH_OS_TMR *)0) {
+            (void)pthread_cond_timedwait(&USBH_OS_TmrCond, &USBH_OS_TmrLock, &p_os_tmr_nxt->Deadline);
+
+        } else {
+            (void)pthread_cond_wait(&USBH_OS_TmrCond, &USBH_OS_TmrLock);
+        }
+    }
+
+    return ((void *)0);
+}
@@ -197,6 +197,32 @@ void  USBH_OS_DlyUS (CPU_INT32U  dly)
 }
 
 
+/*
+*********************************************************************************************************
+*                                          USBH_OS_TimeGet()
+*
+* Description : Get current time.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Current time, in milliseconds.
+*
+* Note(s)     : (1) This function MUST be implemented. The hub task advances the debounce, reset & recovery
+*                   timers of hub ports with the time elapsed between two calls. A constant value stalls the
+*                   enumeration of devices.
+*
+*               (2) The returned value may wrap around. It is only used as a difference between two calls.
+*                   It must not jump when the underlying tick count wraps around.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_OS_TimeGet (void)
+{
+    /* $$$$ Return a free-running millisecond count from the OS tick or a hardware timer [mandatory]. */
+    return (0u);
+}
+
+
 /*
 *********************************************************************************************************
 *********************************************************************************************************
@@ -78,6 +78,10 @@ typedef  struct  usbh_tmr_handle {
 *********************************************************************************************************
 */
 
+static  CPU_INT32U  USBH_OS_TimeTickPrev;                       /* Tick cnt at last call to USBH_OS_TimeGet().          */
+static  CPU_INT32U  USBH_OS_Time_mS;                            /* Time returned by USBH_OS_TimeGet().                  */
+static  CPU_INT32U  USBH_OS_TimeRem;                            /* Remainder of tick to ms conversion.                  */
+
 
 /*
 *********************************************************************************************************
@@ -112,6 +116,10 @@ typedef  struct  usbh_tmr_handle {
 
 USBH_ERR  USBH_OS_LayerInit (void)
 {
+    USBH_OS_TimeTickPrev = OSTimeGet();
+    USBH_OS_Time_mS      = 0u;
+    USBH_OS_TimeRem      = 0u;
+
     return (USBH_ERR_NONE);
 }
 
@@ -173,6 +181,48 @@ void  USBH_OS_DlyUS (CPU_INT32U  dly)
 }
 
 
+/*
+*********************************************************************************************************
+*                                          USBH_OS_TimeGet()
+*
+* Description : Get current time.
+*
+* Argument(s) : None.
+*
+* Return(s)   : Current time, in milliseconds.
+*
+* Note(s)     : (1) The returned value wraps around and is only meaningful as a difference between two
+*                   calls.
+*
+*               (2) The ticks elapsed since the previous call are converted & accumulated, rather than the
+*                   tick count itself, so that the time does not jump when the tick count wraps around.
+*                   The remainder of the conversion is carried to the next call, so that no time is lost
+*                   when OS_TICKS_PER_SEC does not divide 1000.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_OS_TimeGet (void)
+{
+    CPU_INT32U  ticks;
+    CPU_INT64U  elapsed;
+    CPU_INT32U  time_ms;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    ticks                =  OSTimeGet();                        /* See Note #2.                                         */
+    elapsed              =  (CPU_INT64U)(CPU_INT32U)(ticks - USBH_OS_TimeTickPrev);
+    elapsed              =  (elapsed * 1000u) + USBH_OS_TimeRem;
+    USBH_OS_TimeTickPrev =  ticks;
+    USBH_OS_Time_mS     +=  (CPU_INT32U)(elapsed / OS_TICKS_PER_SEC);
+    USBH_OS_TimeRem      =  (CPU_INT32U)(elapsed % OS_TICKS_PER_SEC);
+    time_ms              =  USBH_OS_Time_mS;
+    CPU_CRITICAL_EXIT();
+
+    return (time_ms);
+}
+
+
 /*
 *********************************************************************************************************
 *********************************************************************************************************
@@ -135,6 +135,10 @@ typedef  struct  usbh_tmr_handle {
 *********************************************************************************************************
 */
 
+static  OS_TICK     USBH_OS_TimeTickPrev;                       /* Tick cnt at last call to USBH_OS_TimeGet().          */
+static  CPU_INT32U  USBH_OS_Time_mS;                            /* Time returned by USBH_OS_TimeGet().                  */
+static  CPU_INT32U  USBH_OS_TimeRem;                            /* Remainder of tick to ms conversion.                  */
+
 MEM_POOL  USBH_OS_MutexPool;
 MEM_POOL  USBH_OS_QPool;
 MEM_POOL  USBH_OS_SemPool;
@@ -169,7 +173,13 @@ USBH_ERR  USBH_OS_LayerInit (void)
 {
     LIB_ERR     err_lib;
     CPU_SIZE_T  octets_reqd;
+    OS_ERR      err_os;
+
 
+    USBH_OS_TimeTickPrev = OSTimeGet(&err_os);
+    USBH_OS_Time_mS      = 0u;
+    USBH_OS_TimeRem      = 0u;
+    (void)err_os;
 
     Mem_PoolCreate(      &USBH_OS_MutexPool,                    /* Init mutex mem pool.                                 */
                   (void *)0,
@@ -352,6 +362,50 @@ void  USBH_OS_DlyUS (CPU_INT32U  dly)
 }
 
 
+/*
+*********************************************************************************************************
+*                                          USBH_OS_TimeGet()
+*
+* Description : Get current time.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Current time, in milliseconds.
+*
+* Note(s)     : (1) The returned value wraps around and is only meaningful as a difference between two
+*                   calls.
+*
+*               (2) The ticks elapsed since the previous call are converted & accumulated, rather than the
+*                   tick count itself, so that the time does not jump when the tick count wraps around.
+*                   The remainder of the conversion is carried to the next call, so that no time is lost
+*                   when OSCfg_TickRate_Hz does not divide 1000.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_OS_TimeGet (void)
+{
+    OS_TICK     ticks;
+    CPU_INT64U  elapsed;
+    CPU_INT32U  time_ms;
+    OS_ERR      err;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    ticks                =  OSTimeGet(&err);                    /* See Note #2.                                         */
+    elapsed              =  (CPU_INT64U)(OS_TICK)(ticks - USBH_OS_TimeTickPrev);
+    elapsed              =  (elapsed * DEF_TIME_NBR_mS_PER_SEC) + USBH_OS_TimeRem;
+    USBH_OS_TimeTickPrev =  ticks;
+    USBH_OS_Time_mS     +=  (CPU_INT32U)(elapsed / OSCfg_TickRate_Hz);
+    USBH_OS_TimeRem      =  (CPU_INT32U)(elapsed % OSCfg_TickRate_Hz);
+    time_ms              =  USBH_OS_Time_mS;
+    CPU_CRITICAL_EXIT();
+    (void)err;
+
+    return (time_ms);
+}
+
+
 /*
 *********************************************************************************************************
 *********************************************************************************************************
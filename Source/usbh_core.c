@@ -35,6 +35,7 @@
 #include  "usbh_core.h"
 #include  "usbh_class.h"
 #include  "usbh_hub.h"
+#include  <cpu_core.h>
 
 
 /*
@@ -43,6 +44,25 @@
 *********************************************************************************************************
 */
 
+#define  USBH_ASYNC_TASK_NAME_BASE_LEN                14u       /* Len of 'USBH_Asynctask'.                             */
+#define  USBH_ASYNC_TASK_NAME_LEN                    (USBH_ASYNC_TASK_NAME_BASE_LEN + 4u)  /* Base + 3 digits + NUL.    */
+
+
+/*
+*********************************************************************************************************
+*                                        ASYNC URB POOL SIZE
+*
+* Note(s) : (1) Each device gets enough extra URBs to fill the submission queue of one endpoint. The URB
+*               embedded in the endpoint holds the first queued transfer.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_MAX_EXTRA_URB_PER_DEV >= (USBH_CFG_MAX_QUEUED_URB_PER_EP - 1u))
+#define  USBH_ASYNC_URB_PER_DEV                 USBH_CFG_MAX_EXTRA_URB_PER_DEV
+#else
+#define  USBH_ASYNC_URB_PER_DEV                (USBH_CFG_MAX_QUEUED_URB_PER_EP - 1u)
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -150,12 +170,46 @@
                                                         } while (0)
 
 
+/*
+*********************************************************************************************************
+*                                         TRANSFER TRACE MACRO
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+#define  USBH_TRACE_REC(evt, p_urb, len)                USBH_TraceRec((evt), (p_urb), (len))
+#else
+#define  USBH_TRACE_REC(evt, p_urb, len)
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      TRANSFER STATISTICS MACROS
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+#define  USBH_STAT_SUBMIT(p_urb)                        USBH_StatSubmit((p_urb))
+#define  USBH_STAT_CMPL(p_urb)                          USBH_StatCmpl((p_urb))
+#define  USBH_STAT_ERR(p_ep, err_ix, err)               USBH_StatErr((p_ep), (err_ix), (err))
+#define  USBH_STAT_STALL_CLR(p_ep)                      USBH_StatStallClr((p_ep))
+#else
+#define  USBH_STAT_SUBMIT(p_urb)
+#define  USBH_STAT_CMPL(p_urb)
+#define  USBH_STAT_ERR(p_ep, err_ix, err)
+#define  USBH_STAT_STALL_CLR(p_ep)
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                           LOCAL CONSTANTS
 *********************************************************************************************************
 */
 
+#define  USBH_DESC_CACHE_SERIAL_LEN                       64u   /* Max len of a cached serial nbr str desc.             */
+
 
 /*
 *********************************************************************************************************
@@ -163,6 +217,58 @@
 *********************************************************************************************************
 */
 
+/*
+*********************************************************************************************************
+*                                   ASYNC COMPLETION WORKER QUEUE
+*
+* Note(s) : (1) Each asynchronous completion task owns one queue of completed URBs. All the URBs of an
+*               endpoint are routed to the same queue to preserve their completion order.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_async_queue {
+    volatile  USBH_URB         *HeadPtr;                        /* Head of completed URB list.                          */
+    volatile  USBH_URB         *TailPtr;                        /* Tail of completed URB list.                          */
+              USBH_HSEM         Sem;                            /* Sem signaling URBs in list.                          */
+#if (USBH_CFG_ASYNC_BATCH_EN == DEF_ENABLED)
+              USBH_ASYNC_STAT   Stat;                           /* Completion batch stats.                              */
+#endif
+} USBH_ASYNC_QUEUE;
+
+
+/*
+*********************************************************************************************************
+*                                   ENUMERATION DESCRIPTOR CACHE ENTRY
+*
+* Note(s) : (1) An entry is keyed by the idVendor, idProduct & bcdDevice fields of the device descriptor and
+*               by the serial number string descriptor, if any. The rest of the device descriptor is used
+*               to validate the entry.
+*
+*           (2) The interfaces are stored as offsets in the configuration data, so that they can be rebased
+*               on the configuration buffer of any device.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+typedef  struct  usbh_desc_cache_cfg {
+    CPU_INT08U   CfgData[USBH_CFG_MAX_CFG_DATA_LEN];            /* Cfg desc data.                                       */
+    CPU_INT16U   CfgDataLen;                                    /* Cfg desc data len.                                   */
+    CPU_INT08U   IF_Nbr;                                        /* Nbr of IFs in cfg.                                   */
+    CPU_INT16U   IF_Off[USBH_CFG_MAX_NBR_IFS];                  /* Offset of each IF in cfg data. See Note #2.          */
+    CPU_INT16U   IF_Len[USBH_CFG_MAX_NBR_IFS];                  /* Len of each IF.                                      */
+} USBH_DESC_CACHE_CFG;
+
+typedef  struct  usbh_desc_cache_entry {
+    CPU_BOOLEAN          Valid;                                 /* Entry holds the desc of a dev.                       */
+    CPU_INT32U           UseSeq;                                /* Seq nbr of last use, for LRU replacement.            */
+    CPU_INT08U           DevDesc[USBH_LEN_DESC_DEV];            /* Dev desc. See Note #1.                               */
+    CPU_INT16U           LangID;                                /* Lang ID used to rd serial nbr.                       */
+    CPU_INT08U           SerialLen;                             /* Serial nbr str desc len; 0 if dev has none.          */
+    CPU_INT08U           Serial[USBH_DESC_CACHE_SERIAL_LEN];    /* Serial nbr str desc.                                 */
+    USBH_DESC_CACHE_CFG  CfgList[USBH_CFG_MAX_NBR_CFGS];        /* Cfg desc of dev.                                     */
+} USBH_DESC_CACHE_ENTRY;
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -177,9 +283,14 @@
 *********************************************************************************************************
 */
 
-static  volatile  USBH_URB   *USBH_URB_HeadPtr;
-static  volatile  USBH_URB   *USBH_URB_TailPtr;
-static  volatile  USBH_HSEM   USBH_URB_Sem;
+static  USBH_ASYNC_QUEUE  USBH_AsyncQueueTbl[USBH_CFG_ASYNC_TASK_NBR];
+                                                                /* Async task names, 'USBH_Asynctask<ix>'.              */
+static  CPU_CHAR          USBH_AsyncTaskNameTbl[USBH_CFG_ASYNC_TASK_NBR][USBH_ASYNC_TASK_NAME_LEN];
+
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+static  USBH_TRACE_REC    USBH_TraceTbl[USBH_CFG_TRACE_REC_NBR];/* Trace ring.                                          */
+static  CPU_INT32U        USBH_TraceSeqLast;                    /* Seq nbr of last trace rec. 0 if ring is empty.       */
+#endif
 
 
 /*
@@ -192,6 +303,20 @@ static  USBH_HOST   USBH_Host;
 static  CPU_INT32U  USBH_Version;
 
 
+/*
+*********************************************************************************************************
+*                                    ENUMERATION DESCRIPTOR CACHE
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+static  USBH_DESC_CACHE_ENTRY  USBH_DescCacheTbl[USBH_CFG_DESC_CACHE_NBR];
+static  USBH_DESC_CACHE_STAT   USBH_DescCacheStat;
+static  CPU_INT32U             USBH_DescCacheSeq;               /* Seq nbr of last cache use.                           */
+static  USBH_HMUTEX            USBH_DescCacheMutex;
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                      LOCAL FUNCTION PROTOTYPES
@@ -202,12 +327,16 @@ static  USBH_ERR        USBH_EP_Open     (USBH_DEV        *p_dev,
                                           USBH_IF         *p_if,
                                           USBH_EP_TYPE     ep_type,
                                           USBH_EP_DIR      ep_dir,
+                                          CPU_INT08U       ep_addr,
+                                          CPU_INT32U       interval_us,
                                           USBH_EP         *p_ep);
 
 static  CPU_INT32U      USBH_SyncXfer    (USBH_EP         *p_ep,
                                           void            *p_buf,
                                           CPU_INT32U       buf_len,
                                           USBH_ISOC_DESC  *p_isoc_desc,
+                                          USBH_SG_SEG     *p_sg_tbl,
+                                          CPU_INT08U       sg_nbr,
                                           USBH_TOKEN       token,
                                           CPU_INT32U       timeout_ms,
                                           USBH_ERR        *p_err);
@@ -216,6 +345,8 @@ static  USBH_ERR        USBH_AsyncXfer   (USBH_EP         *p_ep,
                                           void            *p_buf,
                                           CPU_INT32U       buf_len,
                                           USBH_ISOC_DESC  *p_isoc_desc,
+                                          USBH_SG_SEG     *p_sg_tbl,
+                                          CPU_INT08U       sg_nbr,
                                           USBH_TOKEN       token,
                                           void            *p_fnct,
                                           void            *p_fnct_arg);
@@ -236,8 +367,56 @@ static  void            USBH_URB_Notify  (USBH_URB        *p_urb);
 
 static  USBH_ERR        USBH_URB_Submit  (USBH_URB        *p_urb);
 
+static  USBH_URB       *USBH_URB_Get     (USBH_EP         *p_ep,
+                                          USBH_ERR        *p_err);
+
+static  void            USBH_URB_Release (USBH_EP         *p_ep,
+                                          USBH_URB        *p_urb);
+
 static  void            USBH_URB_Clr     (USBH_URB        *p_urb);
 
+static  CPU_BOOLEAN     USBH_URB_AsyncUnlink(USBH_URB     *p_urb);
+
+static  USBH_ERR        USBH_URB_SG_Prepare(USBH_URB      *p_urb,
+                                            USBH_SG_SEG   *p_sg_tbl,
+                                            CPU_INT08U     sg_nbr);
+
+static  void            USBH_URB_SG_Release(USBH_URB      *p_urb);
+
+static  CPU_BOOLEAN     USBH_URB_DMA_Chk (USBH_URB        *p_urb);
+
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+static  void            USBH_TraceRec    (CPU_INT08U       evt,
+                                          USBH_URB        *p_urb,
+                                          CPU_INT32U       len);
+#endif
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  void            USBH_StatSubmit  (USBH_URB        *p_urb);
+
+static  void            USBH_StatCmpl    (USBH_URB        *p_urb);
+
+static  void            USBH_StatErr     (USBH_EP         *p_ep,
+                                          CPU_INT08U       err_ix,
+                                          USBH_ERR         err);
+
+static  void            USBH_StatStallClr(USBH_EP         *p_ep);
+
+static  CPU_INT08U      USBH_StatErrIxGet(USBH_ERR         err);
+
+static  void            USBH_StatXferAdd (USBH_XFER_STAT  *p_stat,
+                                          CPU_INT32U       xfer_len,
+                                          USBH_ERR         err,
+                                          CPU_INT32U       lat);
+
+static  void            USBH_StatCopy    (USBH_XFER_STAT  *p_dst,
+                                          USBH_XFER_STAT  *p_src);
+#endif
+
+static  CPU_BOOLEAN     USBH_URB_DMA_BufChk(USBH_HC_CFG   *p_hc_cfg,
+                                            void          *p_buf,
+                                            CPU_INT32U     buf_len);
+
 static  USBH_ERR        USBH_DfltEP_Open (USBH_DEV        *p_dev);
 
 static  USBH_ERR        USBH_DevDescRd   (USBH_DEV        *p_dev);
@@ -250,6 +429,18 @@ static  USBH_ERR        USBH_CfgParse    (USBH_DEV        *p_dev,
 
 static  USBH_ERR        USBH_DevAddrSet  (USBH_DEV        *p_dev);
 
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+static  USBH_DESC_CACHE_ENTRY  *USBH_DescCacheRd      (USBH_DEV    *p_dev);
+
+static  void                    USBH_DescCacheWr      (USBH_DEV    *p_dev);
+
+static  void                    USBH_DescCacheInvalidate(USBH_DESC_CACHE_ENTRY  *p_entry);
+
+static  CPU_INT08U              USBH_DescCacheSerialRd(USBH_DEV    *p_dev,
+                                                       CPU_INT16U   lang_id,
+                                                       CPU_INT08U  *p_buf);
+#endif
+
 static  CPU_INT32U      USBH_StrDescGet  (USBH_DEV        *p_dev,
                                           CPU_INT08U       desc_ix,
                                           CPU_INT16U       lang_id,
@@ -281,6 +472,9 @@ static  void            USBH_ParseIF_Desc(USBH_IF_DESC    *p_if_desc,
 static  void            USBH_ParseEP_Desc(USBH_EP_DESC    *p_ep_desc,
                                           void            *p_buf_src);
 
+static  CPU_INT08U      USBH_AsyncPrioGet(USBH_DEV        *p_dev,
+                                          CPU_INT08U       ep_type);
+
 static  void            USBH_AsyncTask   (void            *p_arg);
 
 
@@ -290,6 +484,14 @@ static  void            USBH_AsyncTask   (void            *p_arg);
 *********************************************************************************************************
 */
 
+#if ((USBH_CFG_TRACE_EN == DEF_ENABLED) || \
+     (USBH_CFG_STAT_EN  == DEF_ENABLED))
+#if (CPU_CFG_TS_32_EN != DEF_ENABLED)
+#error  "CPU_CFG_TS_32_EN                      illegally #define'd in 'cpu_cfg.h'"
+#error  "       [MUST be  DEF_ENABLED when USBH_CFG_TRACE_EN or USBH_CFG_STAT_EN]  "
+#endif
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -332,7 +534,8 @@ CPU_INT32U  USBH_VersionGet (void)
 *
 * Description : Allocates and initializes resources required by USB Host stack.
 *
-* Argument(s) : async_task_info     Information on asynchronous task.
+* Argument(s) : async_task_info     Information on asynchronous tasks. Array of USBH_CFG_ASYNC_TASK_NBR
+*                                   entries, highest priority (worker 0) first.
 *
 *               hub_task_info       Information on hub task.
 *
@@ -356,6 +559,11 @@ CPU_INT32U  USBH_VersionGet (void)
 * Note(s)     : USBH_Init() must be called:
 *               (1) Only once from a product s application.
 *               (2) After product s OS has been initialized.
+*
+*               (3) With USBH_CFG_ASYNC_TASK_NBR set to 1, 'async_task_info' may point to a single task info
+*                   structure, as with previous versions of the stack.
+*
+*               (4) Each async task is named 'USBH_Asynctask<ix>', where 'ix' is the worker index.
 *********************************************************************************************************
 */
 
@@ -366,19 +574,33 @@ USBH_ERR  USBH_Init (USBH_KERNEL_TASK_INFO  *async_task_info,
     LIB_ERR     err_lib;
     CPU_SIZE_T  octets_reqd;
     CPU_INT08U  ix;
+    CPU_CHAR   *p_name;
 
 
     USBH_Version = USBH_VERSION;
     (void)USBH_Version;
 
-    USBH_URB_HeadPtr = (USBH_URB *)0;
-    USBH_URB_TailPtr = (USBH_URB *)0;
+    Mem_Clr((void *)USBH_AsyncQueueTbl,                         /* Clr async completion queues.                         */
+                    sizeof(USBH_AsyncQueueTbl));
 
     err = USBH_OS_LayerInit();
     if (err != USBH_ERR_NONE) {
         return (err);
     }
 
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+    Mem_Clr((void *) USBH_DescCacheTbl,                         /* Clr enum desc cache.                                 */
+                     sizeof(USBH_DescCacheTbl));
+    Mem_Clr((void *)&USBH_DescCacheStat,
+                     sizeof(USBH_DescCacheStat));
+    USBH_DescCacheSeq = 0u;
+
+    err = USBH_OS_MutexCreate(&USBH_DescCacheMutex);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+#endif
+
     USBH_Host.HC_NbrNext = 0u;
     USBH_Host.State      = USBH_HOST_STATE_NONE;
 
@@ -396,21 +618,37 @@ USBH_ERR  USBH_Init (USBH_KERNEL_TASK_INFO  *async_task_info,
         return (err);
     }
 
-    err = USBH_OS_SemCreate((USBH_HSEM *)&USBH_URB_Sem,         /* Create a Semaphore for sync I/O req.                 */
-                                          0u);
-    if (err != USBH_ERR_NONE) {
-        return (err);
-    }
+    for (ix = 0u; ix < USBH_CFG_ASYNC_TASK_NBR; ix++) {
+        err = USBH_OS_SemCreate(&USBH_AsyncQueueTbl[ix].Sem,    /* Create a Semaphore for async I/O req.                */
+                                 0u);
+        if (err != USBH_ERR_NONE) {
+            return (err);
+        }
+
+        p_name = &USBH_AsyncTaskNameTbl[ix][0];                 /* Build task name (see Note #4).                       */
+        Mem_Copy((void *)p_name,
+                 (void *)"USBH_Asynctask",
+                         USBH_ASYNC_TASK_NAME_BASE_LEN);
+        p_name += USBH_ASYNC_TASK_NAME_BASE_LEN;
+        if (ix >= 100u) {
+           *p_name++ = (CPU_CHAR)('0' + ( ix / 100u));
+        }
+        if (ix >= 10u) {
+           *p_name++ = (CPU_CHAR)('0' + ((ix /  10u) % 10u));
+        }
+       *p_name++ = (CPU_CHAR)('0' + (ix % 10u));
+       *p_name   = (CPU_CHAR)'\0';
                                                                 /* Create a task for processing async req.              */
-    err = USBH_OS_TaskCreate(             "USBH_Asynctask",
-                                           async_task_info->Prio,
-                                           USBH_AsyncTask,
-                             (void       *)0,
-                             (CPU_INT32U *)async_task_info->StackPtr,
-                                           async_task_info->StackSize,
-                                          &USBH_Host.HAsyncTask);
-    if (err != USBH_ERR_NONE) {
-        return (err);
+        err = USBH_OS_TaskCreate(             &USBH_AsyncTaskNameTbl[ix][0],
+                                               async_task_info[ix].Prio,
+                                               USBH_AsyncTask,
+                                 (void       *)&USBH_AsyncQueueTbl[ix],
+                                 (CPU_INT32U *)async_task_info[ix].StackPtr,
+                                               async_task_info[ix].StackSize,
+                                              &USBH_Host.HAsyncTask[ix]);
+        if (err != USBH_ERR_NONE) {
+            return (err);
+        }
     }
                                                                 /* Create a task for processing hub events.             */
     err = USBH_OS_TaskCreate(             "USBH_HUB_EventTask",
@@ -460,8 +698,8 @@ USBH_ERR  USBH_Init (USBH_KERNEL_TASK_INFO  *async_task_info,
 
     Mem_PoolCreate (       &USBH_Host.AsyncURB_Pool,            /* Create mem pool for extra URB used in async comm.    */
                     (void *)0,
-                           (USBH_CFG_MAX_NBR_DEVS * USBH_CFG_MAX_EXTRA_URB_PER_DEV * sizeof(USBH_URB)),
-                           (USBH_CFG_MAX_NBR_DEVS * USBH_CFG_MAX_EXTRA_URB_PER_DEV),
+                           (USBH_CFG_MAX_NBR_DEVS * USBH_ASYNC_URB_PER_DEV * sizeof(USBH_URB)),
+                           (USBH_CFG_MAX_NBR_DEVS * USBH_ASYNC_URB_PER_DEV),
                             sizeof(USBH_URB),
                             sizeof(CPU_ALIGN),
                            &octets_reqd,
@@ -470,6 +708,20 @@ USBH_ERR  USBH_Init (USBH_KERNEL_TASK_INFO  *async_task_info,
         return (USBH_ERR_ALLOC);
     }
 
+#if (USBH_CFG_SG_BOUNCE_BUF_NBR > 0u)
+    Mem_PoolCreate (       &USBH_Host.SG_BouncePool,            /* Create mem pool for scatter-gather bounce bufs.      */
+                    (void *)0,
+                           (USBH_CFG_SG_BOUNCE_BUF_NBR * USBH_CFG_SG_BOUNCE_BUF_LEN),
+                            USBH_CFG_SG_BOUNCE_BUF_NBR,
+                            USBH_CFG_SG_BOUNCE_BUF_LEN,
+                            sizeof(CPU_ALIGN),
+                           &octets_reqd,
+                           &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+        return (USBH_ERR_ALLOC);
+    }
+#endif
+
     err = USBH_ERR_NONE;
 
     return (err);
@@ -548,6 +800,182 @@ USBH_ERR  USBH_Resume (void)
 }
 
 
+/*
+*********************************************************************************************************
+*                                         USBH_AsyncStatGet()
+*
+* Description : Get a snapshot of the completion batch statistics of an asynchronous completion task.
+*
+* Argument(s) : prio        Index of asynchronous completion task.
+*
+*               p_stat      Pointer to structure that will receive the statistics.
+*
+* Return(s)   : USBH_ERR_NONE,          If statistics were retrieved.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'prio' / 'p_stat'.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_ASYNC_BATCH_EN == DEF_ENABLED)
+USBH_ERR  USBH_AsyncStatGet (CPU_INT08U        prio,
+                             USBH_ASYNC_STAT  *p_stat)
+{
+    CPU_SR_ALLOC();
+
+
+    if ((prio   >= USBH_CFG_ASYNC_TASK_NBR) ||
+        (p_stat == (USBH_ASYNC_STAT *)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    CPU_CRITICAL_ENTER();
+   *p_stat = USBH_AsyncQueueTbl[prio].Stat;
+    CPU_CRITICAL_EXIT();
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_AsyncStatClr()
+*
+* Description : Clear the completion batch statistics of all asynchronous completion tasks.
+*
+* Argument(s) : None.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_ASYNC_BATCH_EN == DEF_ENABLED)
+void  USBH_AsyncStatClr (void)
+{
+    CPU_INT08U  ix;
+    CPU_SR_ALLOC();
+
+
+    for (ix = 0u; ix < USBH_CFG_ASYNC_TASK_NBR; ix++) {
+        CPU_CRITICAL_ENTER();
+        Mem_Clr((void *)&USBH_AsyncQueueTbl[ix].Stat,
+                         sizeof(USBH_ASYNC_STAT));
+        CPU_CRITICAL_EXIT();
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_TraceDump()
+*
+* Description : Copy the content of the transfer trace ring to a buffer.
+*
+* Argument(s) : p_buf       Pointer to buffer that will receive the trace dump.
+*
+*               buf_len     Buffer length, in octets.
+*
+* Return(s)   : Number of octets written to buffer, 0 if buffer is too small.
+*
+* Note(s)     : (1) See 'usbh_core.h  TRANSFER TRACE RECORD  Note #3' for the dump layout. When the buffer
+*                   cannot hold the whole ring, only the most recent records are copied.
+*
+*               (2) Recording continues while the ring is dumped. A record overwritten during the copy is
+*                   detected by the decoder from its sequence number.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+CPU_INT32U  USBH_TraceDump (void        *p_buf,
+                            CPU_INT32U   buf_len)
+{
+    USBH_TRACE_HDR   hdr;
+    CPU_INT08U      *p_dst;
+    CPU_INT32U       seq_last;
+    CPU_INT32U       seq;
+    CPU_INT32U       rec_nbr;
+    CPU_INT32U       rec_ix;
+#if (CPU_CFG_TS_TMR_EN == DEF_ENABLED)
+    CPU_ERR          err_cpu;
+#endif
+    CPU_SR_ALLOC();
+
+
+    if ((p_buf   == (void *)0) ||
+        (buf_len <  sizeof(USBH_TRACE_HDR))) {
+        return (0u);
+    }
+
+    CPU_CRITICAL_ENTER();
+    seq_last = USBH_TraceSeqLast;
+    CPU_CRITICAL_EXIT();
+
+    rec_nbr = DEF_MIN(seq_last, USBH_CFG_TRACE_REC_NBR);        /* See Note #1.                                         */
+    rec_nbr = DEF_MIN(rec_nbr, (buf_len - sizeof(USBH_TRACE_HDR)) / sizeof(USBH_TRACE_REC));
+
+    hdr.Magic   = USBH_TRACE_MAGIC;
+    hdr.Ver     = USBH_TRACE_VER;
+    hdr.RecSize = sizeof(USBH_TRACE_REC);
+    hdr.RecNbr  = rec_nbr;
+#if (CPU_CFG_TS_TMR_EN == DEF_ENABLED)
+    hdr.TS_Freq = (CPU_INT32U)CPU_TS_TmrFreqGet(&err_cpu);
+#else
+    hdr.TS_Freq = 0u;
+#endif
+
+    p_dst = (CPU_INT08U *)p_buf;
+    Mem_Copy((void *) p_dst,
+             (void *)&hdr,
+                      sizeof(USBH_TRACE_HDR));
+    p_dst += sizeof(USBH_TRACE_HDR);
+
+    seq = seq_last - rec_nbr + 1u;                              /* Copy recs from oldest to newest.                     */
+    for (rec_ix = 0u; rec_ix < rec_nbr; rec_ix++) {
+        Mem_Copy((void *) p_dst,
+                 (void *)&USBH_TraceTbl[seq & (USBH_CFG_TRACE_REC_NBR - 1u)],
+                          sizeof(USBH_TRACE_REC));
+        p_dst += sizeof(USBH_TRACE_REC);
+        seq++;
+    }
+
+    return (sizeof(USBH_TRACE_HDR) + (rec_nbr * sizeof(USBH_TRACE_REC)));
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_TraceClr()
+*
+* Description : Empty the transfer trace ring.
+*
+* Argument(s) : None.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+void  USBH_TraceClr (void)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    Mem_Clr((void *)&USBH_TraceTbl[0u],
+                     sizeof(USBH_TraceTbl));
+    USBH_TraceSeqLast = 0u;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                            USBH_HC_Add()
@@ -643,6 +1071,9 @@ CPU_INT08U  USBH_HC_Add (USBH_HC_CFG      *p_hc_cfg,
     p_hc_drv->BSP_API_Ptr = p_hc_bsp_api;
     p_hc_drv->RH_API_Ptr  = p_hc_rh_api;
     p_hc_drv->Nbr         = hc_nbr;
+    p_hc_drv->SG_En       = DEF_FALSE;                          /* Set by HCD Init() if SG is supported.                */
+    Mem_Clr((void *)&p_hc_drv->DMA_Stat,
+                     sizeof(USBH_HC_DMA_STAT));
 
    *p_err = USBH_OS_MutexCreate(&p_hc->HCD_Mutex);              /* Create mutex to sync access to HCD.                  */
     if (*p_err != USBH_ERR_NONE) {
@@ -884,36 +1315,136 @@ CPU_INT32U  USBH_HC_FrameNbrGet (CPU_INT08U   hc_nbr,
 
 /*
 *********************************************************************************************************
-*********************************************************************************************************
-*                                    DEVICE ENUMERATION FUNCTIONS
-*********************************************************************************************************
+*                                         USBH_HC_DMA_StatGet()
+*
+* Description : Get a snapshot of the DMA data path statistics of a host controller.
+*
+* Argument(s) : hc_nbr      Index of Host Controller.
+*
+*               p_stat      Pointer to structure that will receive the statistics.
+*
+* Return(s)   : USBH_ERR_NONE,          If statistics were retrieved.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'hc_nbr' / 'p_stat'.
+*
+* Note(s)     : None.
 *********************************************************************************************************
 */
 
+USBH_ERR  USBH_HC_DMA_StatGet (CPU_INT08U         hc_nbr,
+                               USBH_HC_DMA_STAT  *p_stat)
+{
+    CPU_SR_ALLOC();
+
+
+    if ((hc_nbr >= USBH_Host.HC_NbrNext) ||                     /* Chk if HC nbr is valid.                              */
+        (p_stat == (USBH_HC_DMA_STAT *)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    CPU_CRITICAL_ENTER();
+   *p_stat = USBH_Host.HC_Tbl[hc_nbr].HC_Drv.DMA_Stat;
+    CPU_CRITICAL_EXIT();
+
+    return (USBH_ERR_NONE);
+}
+
+
 /*
 *********************************************************************************************************
-*                                           USBH_DevConn()
+*                                         USBH_HC_DMA_StatClr()
 *
-* Description : Enumerates newly connected USB device. Reads device and configuration descriptor from
-*               device and loads appropriate class driver(s).
+* Description : Clear the DMA data path statistics of a host controller.
 *
-* Argument(s) : p_dev       Pointer to USB device structure.
+* Argument(s) : hc_nbr      Index of Host Controller.
 *
-* Return(s)   : USBH_ERR_NONE                           If device connection is successful.
-*               USBH_ERR_DESC_INVALID                   If device contains 0 configurations
-*               USBH_ERR_CFG_ALLOC                      If maximum number of configurations reached.
+* Return(s)   : USBH_ERR_NONE,          If statistics were cleared.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'hc_nbr'.
 *
-*                                                       ----- RETURNED BY USBH_CfgRd() : -----
-*               USBH_ERR_DESC_INVALID,                  If invalid configuration descriptor was fetched.
-*               USBH_ERR_CFG_MAX_CFG_LEN,               If configuration descriptor length > USBH_CFG_MAX_CFG_DATA_LEN
-*               USBH_ERR_UNKNOWN,                       Unknown error occurred.
-*               USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
-*               USBH_ERR_HC_IO,                         Root hub input/output error.
-*               USBH_ERR_EP_STALL,                      Root hub does not support request.
-*               Host controller drivers error code,     Otherwise.
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_HC_DMA_StatClr (CPU_INT08U  hc_nbr)
+{
+    CPU_SR_ALLOC();
+
+
+    if (hc_nbr >= USBH_Host.HC_NbrNext) {                       /* Chk if HC nbr is valid.                              */
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    CPU_CRITICAL_ENTER();
+    Mem_Clr((void *)&USBH_Host.HC_Tbl[hc_nbr].HC_Drv.DMA_Stat,
+                     sizeof(USBH_HC_DMA_STAT));
+    CPU_CRITICAL_EXIT();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                    DEVICE ENUMERATION FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                           USBH_DevConn()
+*
+* Description : Enumerates newly connected USB device. Reads device and configuration descriptor from
+*               device and loads appropriate class driver(s).
+*
+* Argument(s) : p_dev       Pointer to USB device structure.
+*
+* Return(s)   : USBH_ERR_NONE                           If device connection is successful.
+*
+*                                                       ----- RETURNED BY USBH_DevAddrAssign() : -----
+*               See USBH_DevAddrAssign().
+*
+*                                                       ------ RETURNED BY USBH_DevCfgLoad() : ------
+*               See USBH_DevCfgLoad().
+*
+* Note(s)     : (1) A hub that serializes the use of the default address across its ports calls
+*                   USBH_DevAddrAssign() & USBH_DevCfgLoad() itself, so that the default address is released
+*                   as soon as the device has its own address.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_DevConn (USBH_DEV  *p_dev)
+{
+    USBH_ERR  err;
+
+
+    err = USBH_DevAddrAssign(p_dev);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+
+    err = USBH_DevCfgLoad(p_dev);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_DevAddrAssign()
+*
+* Description : Open default endpoint of newly connected USB device, read its device descriptor and assign
+*               it a new address.
+*
+* Argument(s) : p_dev       Pointer to USB device structure.
+*
+* Return(s)   : USBH_ERR_NONE                           If device address is assigned.
+*
+*                                                       ----- RETURNED BY USBH_DfltEP_Open() : -----
+*               USBH_ERR_OS_SIGNAL_CREATE,              If semaphore or mutex creation failed.
+*               Host controller driver error,           Otherwise.
 *
-*                                                       ----- RETURNED BY USBH_CDC_RespRx() : -----
+*                                                       ----- RETURNED BY USBH_DevDescRd() : -----
 *               USBH_ERR_DESC_INVALID,                  If an invalid device descriptor was fetched.
 *               USBH_ERR_DEV_NOT_RESPONDING,            If device is not responding.
 *               USBH_ERR_UNKNOWN,                       Unknown error occurred.
@@ -931,39 +1462,25 @@ CPU_INT32U  USBH_HC_FrameNbrGet (CPU_INT08U   hc_nbr,
 *               USBH_ERR_EP_STALL,                      Root hub does not support request.
 *               Host controller drivers error code,     Otherwise.
 *
-*
-*                                                       ----- RETURNED BY USBH_ClassDrvConn() : -----
-*               USBH_ERR_DRIVER_NOT_FOUND               If no class driver was found.
-*               USBH_ERR_UNKNOWN                        Unknown error occurred.
-*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*               USBH_ERR_HC_IO,                         Root hub input/output error.
-*               USBH_ERR_EP_STALL,                      Root hub does not support request.
-*               Host controller drivers error code,     Otherwise.
-*
-*                                                       ----- RETURNED BY USBH_DfltEP_Open() : -----
-*               USBH_ERR_OS_SIGNAL_CREATE,              If semaphore or mutex creation failed.
-*               Host controller driver error,           Otherwise.
-*
-*                                                       -------- RETURNED BY USBH_CfgRd() : --------
-*               USBH_ERR_NULL_PTR                       If configuration read returns a null pointer.
-*               Host controller driver error,           Otherwise.
-*
-* Note(s)     : None.
+* Note(s)     : (1) The device responds to the default address until this function returns successfully.
+*                   It no longer uses the default address afterwards, even if USBH_DevCfgLoad() fails.
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_DevConn (USBH_DEV  *p_dev)
+USBH_ERR  USBH_DevAddrAssign (USBH_DEV  *p_dev)
 {
-    USBH_ERR     err;
-    CPU_INT08U   nbr_cfgs;
-    CPU_INT08U   cfg_ix;
+    USBH_ERR  err;
 
 
     p_dev->SelCfg = 0u;
+    p_dev->LangID = 0u;
 
     p_dev->ClassDrvRegPtr = (USBH_CLASS_DRV_REG *)0;
     Mem_Clr(p_dev->DevDesc, USBH_LEN_DESC_DEV);
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+    Mem_Clr((void *)&p_dev->Stat,
+                     sizeof(USBH_XFER_STAT));
+#endif
 
     err = USBH_DfltEP_Open(p_dev);
     if (err != USBH_ERR_NONE) {
@@ -985,6 +1502,60 @@ USBH_ERR  USBH_DevConn (USBH_DEV  *p_dev)
                     p_dev->DevAddr);
 #endif
 
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_DevCfgLoad()
+*
+* Description : Read configuration descriptors of addressed USB device and load appropriate class driver(s).
+*
+* Argument(s) : p_dev       Pointer to USB device structure, address assigned by USBH_DevAddrAssign().
+*
+* Return(s)   : USBH_ERR_NONE                           If device connection is successful.
+*               USBH_ERR_DESC_INVALID                   If device contains 0 configurations
+*               USBH_ERR_CFG_ALLOC                      If maximum number of configurations reached.
+*
+*                                                       ----- RETURNED BY USBH_CfgRd() : -----
+*               USBH_ERR_DESC_INVALID,                  If invalid configuration descriptor was fetched.
+*               USBH_ERR_CFG_MAX_CFG_LEN,               If configuration descriptor length > USBH_CFG_MAX_CFG_DATA_LEN
+*               USBH_ERR_NULL_PTR                       If configuration read returns a null pointer.
+*               USBH_ERR_UNKNOWN,                       Unknown error occurred.
+*               USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+*                                                       ----- RETURNED BY USBH_ClassDrvConn() : -----
+*               USBH_ERR_DRIVER_NOT_FOUND               If no class driver was found.
+*               USBH_ERR_UNKNOWN                        Unknown error occurred.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) If the enumeration descriptor cache holds the configuration descriptors of this device,
+*                   they are copied from the cache instead of being read from the device & parsed again.
+*
+*               (2) A cache entry that led to a failed connection is dropped, so that the next connection
+*                   of the device reads its configuration descriptors again.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_DevCfgLoad (USBH_DEV  *p_dev)
+{
+    USBH_ERR                err;
+    CPU_INT08U              nbr_cfgs;
+    CPU_INT08U              cfg_ix;
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+    USBH_DESC_CACHE_ENTRY  *p_entry;
+#endif
+
+
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
                                                                 /* -------- PRINT MANUFACTURER AND PRODUCT STR -------- */
     if(p_dev->DevDesc[14] != 0u) {                              /* iManufacturer = 0 -> no str desc for manufacturer.   */
@@ -1009,14 +1580,28 @@ USBH_ERR  USBH_DevConn (USBH_DEV  *p_dev)
                                                                 /* Empty Else Statement                                 */
     }
 
-    for (cfg_ix = 0u; cfg_ix < nbr_cfgs; cfg_ix++) {            /* -------------------- RD ALL CFG -------------------- */
-        err = USBH_CfgRd(p_dev, cfg_ix);
-        if (err != USBH_ERR_NONE) {
-            return (err);
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+    p_entry = USBH_DescCacheRd(p_dev);                          /* See Note #1.                                         */
+    if (p_entry == (USBH_DESC_CACHE_ENTRY *)0) {
+#endif
+        for (cfg_ix = 0u; cfg_ix < nbr_cfgs; cfg_ix++) {        /* -------------------- RD ALL CFG -------------------- */
+            err = USBH_CfgRd(p_dev, cfg_ix);
+            if (err != USBH_ERR_NONE) {
+                return (err);
+            }
         }
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+        USBH_DescCacheWr(p_dev);
     }
+#endif
 
     err = USBH_ClassDrvConn(p_dev);                             /* ------------- PROBE/LOAD CLASS DRV(S) -------------- */
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+    if ((err     != USBH_ERR_NONE) &&
+        (p_entry != (USBH_DESC_CACHE_ENTRY *)0)) {
+        USBH_DescCacheInvalidate(p_entry);                      /* See Note #2.                                         */
+    }
+#endif
 
     return (err);
 }
@@ -1089,6 +1674,141 @@ void  USBH_DevDescGet (USBH_DEV       *p_dev,
 }
 
 
+/*
+*********************************************************************************************************
+*                                          USBH_DevStatsGet()
+*
+* Description : Get a snapshot of the transfer statistics of all the endpoints of a USB device.
+*
+* Argument(s) : p_dev       Pointer to USB device.
+*
+*               p_stat      Pointer to structure that will receive the statistics.
+*
+* Return(s)   : USBH_ERR_NONE,          If statistics were retrieved.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_dev' / 'p_stat'.
+*
+* Note(s)     : (1) Statistics are cleared when the device is connected.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+USBH_ERR  USBH_DevStatsGet (USBH_DEV        *p_dev,
+                            USBH_XFER_STAT  *p_stat)
+{
+    if ((p_dev  == (USBH_DEV       *)0) ||
+        (p_stat == (USBH_XFER_STAT *)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_StatCopy(p_stat, &p_dev->Stat);
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_DevStatsClr()
+*
+* Description : Clear the transfer statistics of a USB device.
+*
+* Argument(s) : p_dev       Pointer to USB device.
+*
+* Return(s)   : USBH_ERR_NONE,          If statistics were cleared.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_dev'.
+*
+* Note(s)     : (1) The statistics of the device endpoints are not cleared.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+USBH_ERR  USBH_DevStatsClr (USBH_DEV  *p_dev)
+{
+    CPU_SR_ALLOC();
+
+
+    if (p_dev == (USBH_DEV *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    CPU_CRITICAL_ENTER();
+    Mem_Clr((void *)&p_dev->Stat,
+                     sizeof(USBH_XFER_STAT));
+    CPU_CRITICAL_EXIT();
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_DescCacheStatGet()
+*
+* Description : Get a snapshot of the enumeration descriptor cache statistics.
+*
+* Argument(s) : p_stat      Pointer to structure that will receive the statistics.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+void  USBH_DescCacheStatGet (USBH_DESC_CACHE_STAT  *p_stat)
+{
+    CPU_SR_ALLOC();
+
+
+    if (p_stat == (USBH_DESC_CACHE_STAT *)0) {
+        return;
+    }
+
+    CPU_CRITICAL_ENTER();
+   *p_stat = USBH_DescCacheStat;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_DescCacheClr()
+*
+* Description : Drop all entries of the enumeration descriptor cache & clear its statistics.
+*
+* Argument(s) : None.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Devices connected afterwards have their configuration descriptors read from the device,
+*                   e.g. after the firmware of the devices was updated without changing their bcdDevice.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+void  USBH_DescCacheClr (void)
+{
+    CPU_INT08U  ix;
+    CPU_SR_ALLOC();
+
+
+    (void)USBH_OS_MutexLock(USBH_DescCacheMutex);
+    for (ix = 0u; ix < USBH_CFG_DESC_CACHE_NBR; ix++) {
+        USBH_DescCacheTbl[ix].Valid = DEF_NO;
+    }
+    (void)USBH_OS_MutexUnlock(USBH_DescCacheMutex);
+
+    CPU_CRITICAL_ENTER();
+    Mem_Clr((void *)&USBH_DescCacheStat,
+                     sizeof(USBH_DescCacheStat));
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                             USBH_CfgSet()
@@ -1656,6 +2376,8 @@ USBH_ERR  USBH_BulkInOpen (USBH_DEV  *p_dev,
                        p_if,
                        USBH_EP_TYPE_BULK,
                        USBH_EP_DIR_IN,
+                       0u,
+                       0u,
                        p_ep);
 
     return (err);
@@ -1697,6 +2419,8 @@ USBH_ERR  USBH_BulkOutOpen (USBH_DEV  *p_dev,
                        p_if,
                        USBH_EP_TYPE_BULK,
                        USBH_EP_DIR_OUT,
+                       0u,
+                       0u,
                        p_ep);
 
     return (err);
@@ -1705,39 +2429,53 @@ USBH_ERR  USBH_BulkOutOpen (USBH_DEV  *p_dev,
 
 /*
 *********************************************************************************************************
-*                                          USBH_IntrInOpen()
+*                                         USBH_BulkAddrOpen()
 *
-* Description : Open an interrupt IN endpoint.
+* Description : Open the bulk endpoint with the given address.
 *
 * Argument(s) : p_dev       Pointer to USB device.
 *
 *               p_if        Pointer to USB interface.
 *
+*               ep_addr     Endpoint address (bEndpointAddress), direction bit included.
+*
 *               p_ep        Pointer to endpoint.
 *
-* Return(s)   : USBH_ERR_NONE                       If the interrupt IN endpoint is opened successfully.
+* Return(s)   : USBH_ERR_NONE                       If the bulk endpoint is opened successfully.
+*               USBH_ERR_INVALID_ARG                If the endpoint address is 0.
 *
 *                                                   ----- RETURNED BY USBH_EP_Open() : -----
 *               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
-*               USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
+*               USBH_ERR_EP_NOT_FOUND,              If bulk endpoint with given address not found.
 *               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
 *               Host controller drivers error,      Otherwise.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Used by class drivers whose interface has several bulk endpoints in the same
+*                   direction, identified by class-specific descriptors (e.g. UAS pipe usage descriptors).
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_IntrInOpen (USBH_DEV  *p_dev,
-                           USBH_IF   *p_if,
-                           USBH_EP   *p_ep)
+USBH_ERR  USBH_BulkAddrOpen (USBH_DEV    *p_dev,
+                             USBH_IF     *p_if,
+                             CPU_INT08U   ep_addr,
+                             USBH_EP     *p_ep)
 {
-    USBH_ERR  err;
+    USBH_EP_DIR  ep_dir;
+    USBH_ERR     err;
+
+
+    if ((ep_addr & 0x7Fu) == 0u) {
+        return (USBH_ERR_INVALID_ARG);
+    }
 
+    ep_dir = ((ep_addr & 0x80u) != 0u) ? USBH_EP_DIR_IN : USBH_EP_DIR_OUT;
 
     err = USBH_EP_Open(p_dev,
                        p_if,
-                       USBH_EP_TYPE_INTR,
-                       USBH_EP_DIR_IN,
+                       USBH_EP_TYPE_BULK,
+                       ep_dir,
+                       ep_addr,
+                       0u,
                        p_ep);
 
     return (err);
@@ -1746,9 +2484,9 @@ USBH_ERR  USBH_IntrInOpen (USBH_DEV  *p_dev,
 
 /*
 *********************************************************************************************************
-*                                         USBH_IntrOutOpen()
+*                                          USBH_IntrInOpen()
 *
-* Description : Open and interrupt OUT endpoint.
+* Description : Open an interrupt IN endpoint.
 *
 * Argument(s) : p_dev       Pointer to USB device.
 *
@@ -1756,7 +2494,7 @@ USBH_ERR  USBH_IntrInOpen (USBH_DEV  *p_dev,
 *
 *               p_ep        Pointer to endpoint.
 *
-* Return(s)   : USBH_ERR_NONE                       If the interrupt OUT endpoint is opened successfully.
+* Return(s)   : USBH_ERR_NONE                       If the interrupt IN endpoint is opened successfully.
 *
 *                                                   ----- RETURNED BY USBH_EP_Open() : -----
 *               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
@@ -1768,7 +2506,100 @@ USBH_ERR  USBH_IntrInOpen (USBH_DEV  *p_dev,
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_IntrOutOpen (USBH_DEV  *p_dev,
+USBH_ERR  USBH_IntrInOpen (USBH_DEV  *p_dev,
+                           USBH_IF   *p_if,
+                           USBH_EP   *p_ep)
+{
+    USBH_ERR  err;
+
+
+    err = USBH_EP_Open(p_dev,
+                       p_if,
+                       USBH_EP_TYPE_INTR,
+                       USBH_EP_DIR_IN,
+                       0u,
+                       0u,
+                       p_ep);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_IntrInIntervalOpen()
+*
+* Description : Open an interrupt IN endpoint, polled at the given interval instead of the interval of its
+*               endpoint descriptor.
+*
+* Argument(s) : p_dev           Pointer to USB device.
+*
+*               p_if            Pointer to USB interface.
+*
+*               interval_us     Polling interval, in microseconds (see Note #1). 0 uses the interval of the
+*                               endpoint descriptor.
+*
+*               p_ep            Pointer to endpoint.
+*
+* Return(s)   : USBH_ERR_NONE                       If the interrupt IN endpoint is opened successfully.
+*
+*                                                   ----- RETURNED BY USBH_EP_Open() : -----
+*               USBH_ERR_EP_ALLOC                   If USBH_CFG_MAX_NBR_EPS reached.
+*               USBH_ERR_EP_NOT_FOUND               If endpoint with given type and direction not found.
+*               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*               Host controller drivers error,      Otherwise.
+*
+* Note(s)     : (1) The interval is limited to what the bus speed of the device allows (see USBH_EP_Open()
+*                   Note #4). The host controller driver may round it further to fit its periodic
+*                   schedule. The interval achieved is returned by USBH_EP_IntervalGet().
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_IntrInIntervalOpen (USBH_DEV    *p_dev,
+                                   USBH_IF     *p_if,
+                                   CPU_INT32U   interval_us,
+                                   USBH_EP     *p_ep)
+{
+    USBH_ERR  err;
+
+
+    err = USBH_EP_Open(p_dev,
+                       p_if,
+                       USBH_EP_TYPE_INTR,
+                       USBH_EP_DIR_IN,
+                       0u,
+                       interval_us,
+                       p_ep);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_IntrOutOpen()
+*
+* Description : Open and interrupt OUT endpoint.
+*
+* Argument(s) : p_dev       Pointer to USB device.
+*
+*               p_if        Pointer to USB interface.
+*
+*               p_ep        Pointer to endpoint.
+*
+* Return(s)   : USBH_ERR_NONE                       If the interrupt OUT endpoint is opened successfully.
+*
+*                                                   ----- RETURNED BY USBH_EP_Open() : -----
+*               USBH_ERR_EP_ALLOC,                  If USBH_CFG_MAX_NBR_EPS reached.
+*               USBH_ERR_EP_NOT_FOUND,              If endpoint with given type and direction not found.
+*               USBH_ERR_OS_SIGNAL_CREATE,          if mutex or semaphore creation failed.
+*               Host controller drivers error,      Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_IntrOutOpen (USBH_DEV  *p_dev,
                             USBH_IF   *p_if,
                             USBH_EP   *p_ep)
 {
@@ -1779,6 +2610,8 @@ USBH_ERR  USBH_IntrOutOpen (USBH_DEV  *p_dev,
                        p_if,
                        USBH_EP_TYPE_INTR,
                        USBH_EP_DIR_OUT,
+                       0u,
+                       0u,
                        p_ep);
 
     return (err);
@@ -1820,6 +2653,8 @@ USBH_ERR  USBH_IsocInOpen (USBH_DEV  *p_dev,
                        p_if,
                        USBH_EP_TYPE_ISOC,
                        USBH_EP_DIR_IN,
+                       0u,
+                       0u,
                        p_ep);
 
     return (err);
@@ -1861,6 +2696,8 @@ USBH_ERR  USBH_IsocOutOpen (USBH_DEV  *p_dev,
                        p_if,
                        USBH_EP_TYPE_ISOC,
                        USBH_EP_DIR_OUT,
+                       0u,
+                       0u,
                        p_ep);
 
     return (err);
@@ -2104,6 +2941,8 @@ CPU_INT32U  USBH_BulkTx (USBH_EP     *p_ep,
                                                p_buf,
                                                buf_len,
                              (USBH_ISOC_DESC *)0,
+                             (USBH_SG_SEG    *)0,
+                                               0u,
                                                USBH_TOKEN_OUT,
                                                timeout_ms,
                                                p_err);
@@ -2171,6 +3010,8 @@ USBH_ERR  USBH_BulkTxAsync (USBH_EP              *p_ep,
                                            p_buf,
                                            buf_len,
                          (USBH_ISOC_DESC *)0,
+                         (USBH_SG_SEG    *)0,
+                                           0u,
                                            USBH_TOKEN_OUT,
                          (void           *)fnct,
                                            p_fnct_arg);
@@ -2241,6 +3082,8 @@ CPU_INT32U  USBH_BulkRx (USBH_EP     *p_ep,
                                                p_buf,
                                                buf_len,
                              (USBH_ISOC_DESC *)0,
+                             (USBH_SG_SEG    *)0,
+                                               0u,
                                                USBH_TOKEN_IN,
                                                timeout_ms,
                                                p_err);
@@ -2308,6 +3151,8 @@ USBH_ERR  USBH_BulkRxAsync (USBH_EP              *p_ep,
                                            p_buf,
                                            buf_len,
                          (USBH_ISOC_DESC *)0,
+                         (USBH_SG_SEG    *)0,
+                                           0u,
                                            USBH_TOKEN_IN,
                          (void           *)fnct,
                                            p_fnct_arg);
@@ -2318,64 +3163,74 @@ USBH_ERR  USBH_BulkRxAsync (USBH_EP              *p_ep,
 
 /*
 *********************************************************************************************************
-*                                             USBH_IntrTx()
+*                                            USBH_BulkTxSG()
 *
-* Description : Issue interrupt request to transmit data to device
+* Description : Issue scatter-gather bulk request to transmit data to device.
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
-*               p_buf           Pointer to data buffer to transmit.
+*               p_seg_tbl       Pointer to table of buffer segments to transmit from.
 *
-*               buf_len         Buffer length in octets.
+*               seg_nbr         Number of segments in table.
 *
 *               timeout_ms      Timeout, in milliseconds.
 *
 *               p_err   Pointer to variable that will receive the return error code from this function :
 *
-*                           USBH_ERR_NONE                           Interrupt transfer successfully transmitted.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not OUT.
+*                           USBH_ERR_NONE                           Bulk transfer successfully transmitted.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep', 'p_seg_tbl' or 'seg_nbr'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not OUT.
 *
 *                                                                   ----- RETURNED BY USBH_SyncXfer() : -----
 *                           USBH_ERR_NONE                           Transfer successfully completed.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
 *                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
+*                           USBH_ERR_ALLOC                          Bounce buffer cannot be allocated.
+*                           USBH_ERR_NOT_SUPPORTED                  Segment table cannot be mapped nor bounced.
 *                           Host controller drivers error code,     Otherwise.
 *
 * Return(s)   : Number of octets transmitted.
 *
-* Note(s)     : None.
+* Note(s)     : (1) The segments are sent in table order as a single transfer. Host controllers that
+*                   support it map each segment directly to their transfer descriptors, provided every
+*                   segment but the last one is a multiple of the endpoint's maximum packet size.
+*                   Otherwise, the segments are bounced through a buffer of USBH_CFG_SG_BOUNCE_BUF_LEN
+*                   octets.
 *********************************************************************************************************
 */
 
-CPU_INT32U  USBH_IntrTx (USBH_EP     *p_ep,
-                         void        *p_buf,
-                         CPU_INT32U   buf_len,
-                         CPU_INT32U   timeout_ms,
-                         USBH_ERR    *p_err)
+CPU_INT32U  USBH_BulkTxSG (USBH_EP      *p_ep,
+                          USBH_SG_SEG  *p_seg_tbl,
+                          CPU_INT08U    seg_nbr,
+                          CPU_INT32U    timeout_ms,
+                          USBH_ERR     *p_err)
 {
     CPU_INT08U  ep_type;
     CPU_INT08U  ep_dir;
     CPU_INT32U  xfer_len;
 
 
-    if (p_ep == (USBH_EP *)0) {
-        return (USBH_ERR_INVALID_ARG);
+    if ((p_ep      == (USBH_EP     *)0) ||
+        (p_seg_tbl == (USBH_SG_SEG *)0) ||
+        (seg_nbr   ==  0u)) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (0u);
     }
 
     ep_type = USBH_EP_TypeGet(p_ep);
     ep_dir  = USBH_EP_DirGet(p_ep);
 
-    if ((ep_type != USBH_EP_TYPE_INTR) ||
+    if ((ep_type != USBH_EP_TYPE_BULK) ||
         (ep_dir  != USBH_EP_DIR_OUT  )) {
-        return (USBH_ERR_EP_INVALID_TYPE);
+       *p_err = USBH_ERR_EP_INVALID_TYPE;
+        return (0u);
     }
 
     xfer_len = USBH_SyncXfer(                  p_ep,
-                                               p_buf,
-                                               buf_len,
+                             (void           *)0,
+                                               0u,
                              (USBH_ISOC_DESC *)0,
+                                               p_seg_tbl,
+                                               seg_nbr,
                                                USBH_TOKEN_OUT,
                                                timeout_ms,
                                                p_err);
@@ -2386,63 +3241,70 @@ CPU_INT32U  USBH_IntrTx (USBH_EP     *p_ep,
 
 /*
 *********************************************************************************************************
-*                                          USBH_IntrTxAsync()
+*                                         USBH_BulkTxAsyncSG()
 *
-* Description : Issue asynchronous interrupt request to transmit data to device.
+* Description : Issue asynchronous scatter-gather bulk request to transmit data to device.
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
-*               p_buf           Pointer to data buffer to transmit.
+*               p_seg_tbl       Pointer to table of buffer segments to transmit from.
 *
-*               buf_len         Buffer length in octets.
+*               seg_nbr         Number of segments in table.
 *
 *               fnct            Function that will be invoked upon completion of transmit operation.
 *
-*               p_fnct_arg      Pointer to argument that will be passed as parameter of 'p_fnct'.
+*               p_fnct_arg      Pointer to argument that will be passed as parameter of 'fnct'.
 *
 * Return(s)   : USBH_ERR_NONE                           If request is successfully submitted.
-*               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not interrupt or direction is not OUT.
+*               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep', 'p_seg_tbl' or 'seg_nbr'.
+*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not Bulk or direction is not OUT.
 *
 *                                                       ----- RETURNED BY USBH_AsyncXfer() : -----
 *               USBH_ERR_NONE                           If transfer successfully submitted.
 *               USBH_ERR_EP_INVALID_STATE               If endpoint is not opened.
-*               USBH_ERR_ALLOC                          If URB cannot be allocated.
-*               USBH_ERR_UNKNOWN                        If unknown error occured.
+*               USBH_ERR_ALLOC                          If URB or bounce buffer cannot be allocated.
+*               USBH_ERR_NOT_SUPPORTED                  If segment table cannot be mapped nor bounced.
 *               Host controller drivers error code,     Otherwise.
 *
-* Note(s)     : (1) This function returns immediately. The URB completion will be invoked by the
-*                   asynchronous I/O task when the transfer is completed.
+* Note(s)     : (1) This function returns immediately. The segment table and the segments must remain
+*                   valid until 'fnct' is called. 'fnct' receives the segment table as its buffer
+*                   argument and the total length of the segments as its buffer length argument.
+*
+*               (2) See 'USBH_BulkTxSG() Note #1'.
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_IntrTxAsync (USBH_EP              *p_ep,
-                            void                 *p_buf,
-                            CPU_INT32U            buf_len,
-                            USBH_XFER_CMPL_FNCT   fnct,
-                            void                 *p_fnct_arg)
+USBH_ERR  USBH_BulkTxAsyncSG (USBH_EP              *p_ep,
+                             USBH_SG_SEG          *p_seg_tbl,
+                             CPU_INT08U            seg_nbr,
+                             USBH_XFER_CMPL_FNCT   fnct,
+                             void                 *p_fnct_arg)
 {
-    USBH_ERR     err;
-    CPU_INT08U   ep_type;
-    CPU_INT08U   ep_dir;
+    USBH_ERR    err;
+    CPU_INT08U  ep_type;
+    CPU_INT08U  ep_dir;
 
 
-    if (p_ep == (USBH_EP *)0) {
+    if ((p_ep      == (USBH_EP     *)0) ||
+        (p_seg_tbl == (USBH_SG_SEG *)0) ||
+        (seg_nbr   ==  0u)) {
         return (USBH_ERR_INVALID_ARG);
     }
 
     ep_type = USBH_EP_TypeGet(p_ep);
     ep_dir  = USBH_EP_DirGet(p_ep);
 
-    if ((ep_type != USBH_EP_TYPE_INTR) ||
+    if ((ep_type != USBH_EP_TYPE_BULK) ||
         (ep_dir  != USBH_EP_DIR_OUT  )) {
         return (USBH_ERR_EP_INVALID_TYPE);
     }
 
     err = USBH_AsyncXfer(                  p_ep,
-                                           p_buf,
-                                           buf_len,
+                         (void           *)0,
+                                           0u,
                          (USBH_ISOC_DESC *)0,
+                                           p_seg_tbl,
+                                           seg_nbr,
                                            USBH_TOKEN_OUT,
                          (void           *)fnct,
                                            p_fnct_arg);
@@ -2453,64 +3315,74 @@ USBH_ERR  USBH_IntrTxAsync (USBH_EP              *p_ep,
 
 /*
 *********************************************************************************************************
-*                                             USBH_IntrRx()
+*                                            USBH_BulkRxSG()
 *
-* Description : Issue interrupt request to receive data from device.
+* Description : Issue scatter-gather bulk request to receive data from device.
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
-*               p_buf           Pointer to destination buffer to receive data.
+*               p_seg_tbl       Pointer to table of buffer segments to receive into.
 *
-*               buf_len         Buffer length in octets.
+*               seg_nbr         Number of segments in table.
 *
 *               timeout_ms      Timeout, in milliseconds.
 *
 *               p_err   Pointer to variable that will receive the return error code from this function :
 *
-*                           USBH_ERR_NONE                           Interrupt transfer successfully received.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not IN.
+*                           USBH_ERR_NONE                           Bulk transfer successfully received.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep', 'p_seg_tbl' or 'seg_nbr'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not Bulk or direction is not IN.
 *
 *                                                                   ----- RETURNED BY USBH_SyncXfer() : -----
 *                           USBH_ERR_NONE                           Transfer successfully completed.
-*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
 *                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
-*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
+*                           USBH_ERR_ALLOC                          Bounce buffer cannot be allocated.
+*                           USBH_ERR_NOT_SUPPORTED                  Segment table cannot be mapped nor bounced.
 *                           Host controller drivers error code,     Otherwise.
 *
 * Return(s)   : Number of octets received.
 *
-* Note(s)     : None.
+* Note(s)     : (1) The segments are filled in table order as a single transfer. Host controllers that
+*                   support it map each segment directly to their transfer descriptors, provided every
+*                   segment but the last one is a multiple of the endpoint's maximum packet size.
+*                   Otherwise, the segments are bounced through a buffer of USBH_CFG_SG_BOUNCE_BUF_LEN
+*                   octets.
 *********************************************************************************************************
 */
 
-CPU_INT32U  USBH_IntrRx (USBH_EP     *p_ep,
-                         void        *p_buf,
-                         CPU_INT32U   buf_len,
-                         CPU_INT32U   timeout_ms,
-                         USBH_ERR    *p_err)
+CPU_INT32U  USBH_BulkRxSG (USBH_EP      *p_ep,
+                          USBH_SG_SEG  *p_seg_tbl,
+                          CPU_INT08U    seg_nbr,
+                          CPU_INT32U    timeout_ms,
+                          USBH_ERR     *p_err)
 {
     CPU_INT08U  ep_type;
     CPU_INT08U  ep_dir;
     CPU_INT32U  xfer_len;
 
 
-    if (p_ep == (USBH_EP *)0) {
-        return (USBH_ERR_INVALID_ARG);
+    if ((p_ep      == (USBH_EP     *)0) ||
+        (p_seg_tbl == (USBH_SG_SEG *)0) ||
+        (seg_nbr   ==  0u)) {
+       *p_err = USBH_ERR_INVALID_ARG;
+        return (0u);
     }
 
     ep_type = USBH_EP_TypeGet(p_ep);
     ep_dir  = USBH_EP_DirGet(p_ep);
 
-    if ((ep_type != USBH_EP_TYPE_INTR) ||
+    if ((ep_type != USBH_EP_TYPE_BULK) ||
         (ep_dir  != USBH_EP_DIR_IN   )) {
-        return (USBH_ERR_EP_INVALID_TYPE);
+       *p_err = USBH_ERR_EP_INVALID_TYPE;
+        return (0u);
     }
 
     xfer_len = USBH_SyncXfer(                  p_ep,
-                                               p_buf,
-                                               buf_len,
+                             (void           *)0,
+                                               0u,
                              (USBH_ISOC_DESC *)0,
+                                               p_seg_tbl,
+                                               seg_nbr,
                                                USBH_TOKEN_IN,
                                                timeout_ms,
                                                p_err);
@@ -2521,67 +3393,70 @@ CPU_INT32U  USBH_IntrRx (USBH_EP     *p_ep,
 
 /*
 *********************************************************************************************************
-*                                          USBH_IntrRxAsync()
+*                                         USBH_BulkRxAsyncSG()
 *
-* Description : Issue asynchronous interrupt request to receive data from device.
+* Description : Issue asynchronous scatter-gather bulk request to receive data from device.
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
-*               p_buf           Pointer to data buffer to transmit.
+*               p_seg_tbl       Pointer to table of buffer segments to receive into.
 *
-*               buf_len         Buffer length in octets.
+*               seg_nbr         Number of segments in table.
 *
 *               fnct            Function that will be invoked upon completion of receive operation.
 *
-*               p_fnct_arg      Pointer to argument that will be passed as parameter of 'p_fnct'.
+*               p_fnct_arg      Pointer to argument that will be passed as parameter of 'fnct'.
 *
 * Return(s)   : USBH_ERR_NONE                           If request is successfully submitted.
-*               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not interrupt or direction is not IN.
+*               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep', 'p_seg_tbl' or 'seg_nbr'.
+*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not Bulk or direction is not IN.
 *
 *                                                       ----- RETURNED BY USBH_AsyncXfer() : -----
 *               USBH_ERR_NONE                           If transfer successfully submitted.
 *               USBH_ERR_EP_INVALID_STATE               If endpoint is not opened.
-*               USBH_ERR_ALLOC                          If URB cannot be allocated.
-*               USBH_ERR_UNKNOWN                        If unknown error occured.
+*               USBH_ERR_ALLOC                          If URB or bounce buffer cannot be allocated.
+*               USBH_ERR_NOT_SUPPORTED                  If segment table cannot be mapped nor bounced.
 *               Host controller drivers error code,     Otherwise.
 *
-* Note(s)     : (1) This function returns immediately. The URB completion will be invoked by the
-*                   asynchronous I/O task when the transfer is completed.
+* Note(s)     : (1) This function returns immediately. The segment table and the segments must remain
+*                   valid until 'fnct' is called. 'fnct' receives the segment table as its buffer
+*                   argument and the total length of the segments as its buffer length argument.
+*
+*               (2) See 'USBH_BulkRxSG() Note #1'.
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_IntrRxAsync (USBH_EP              *p_ep,
-                            void                 *p_buf,
-                            CPU_INT32U            buf_len,
-                            USBH_XFER_CMPL_FNCT   fnct,
-                            void                 *p_fnct_arg)
+USBH_ERR  USBH_BulkRxAsyncSG (USBH_EP              *p_ep,
+                             USBH_SG_SEG          *p_seg_tbl,
+                             CPU_INT08U            seg_nbr,
+                             USBH_XFER_CMPL_FNCT   fnct,
+                             void                 *p_fnct_arg)
 {
     USBH_ERR    err;
     CPU_INT08U  ep_type;
     CPU_INT08U  ep_dir;
 
-                                                                /* Argument checks for valid settings                   */
-    if (p_ep == (USBH_EP *)0) {
-        return (USBH_ERR_INVALID_ARG);
-    }
 
-    if (p_ep->IsOpen == DEF_FALSE) {
-        return (USBH_ERR_EP_INVALID_STATE);
+    if ((p_ep      == (USBH_EP     *)0) ||
+        (p_seg_tbl == (USBH_SG_SEG *)0) ||
+        (seg_nbr   ==  0u)) {
+        return (USBH_ERR_INVALID_ARG);
     }
 
     ep_type = USBH_EP_TypeGet(p_ep);
     ep_dir  = USBH_EP_DirGet(p_ep);
 
-    if ((ep_type != USBH_EP_TYPE_INTR) ||
+    if ((ep_type != USBH_EP_TYPE_BULK) ||
         (ep_dir  != USBH_EP_DIR_IN   )) {
         return (USBH_ERR_EP_INVALID_TYPE);
     }
 
     err = USBH_AsyncXfer(                  p_ep,
-                                           p_buf,
-                                           buf_len,
+                         (void           *)0,
+                                           0u,
                          (USBH_ISOC_DESC *)0,
+                                           p_seg_tbl,
+                                           seg_nbr,
                                            USBH_TOKEN_IN,
                          (void           *)fnct,
                                            p_fnct_arg);
@@ -2592,9 +3467,9 @@ USBH_ERR  USBH_IntrRxAsync (USBH_EP              *p_ep,
 
 /*
 *********************************************************************************************************
-*                                             USBH_IsocTx()
+*                                             USBH_IntrTx()
 *
-* Description : Issue isochronous request to transmit data to device.
+* Description : Issue interrupt request to transmit data to device
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
@@ -2602,21 +3477,13 @@ USBH_ERR  USBH_IntrRxAsync (USBH_EP              *p_ep,
 *
 *               buf_len         Buffer length in octets.
 *
-*               start_frm       Transfer start frame number.
-*
-*               nbr_frm         Number of frames.
-*
-*               p_frm_len
-*
-*               p_frm_err
-*
 *               timeout_ms      Timeout, in milliseconds.
 *
 *               p_err   Pointer to variable that will receive the return error code from this function :
 *
-*                           USBH_ERR_NONE                           Isochronous transfer successfully transmitted.
+*                           USBH_ERR_NONE                           Interrupt transfer successfully transmitted.
 *                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not isochronous or direction is not OUT.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not OUT.
 *
 *                                                                   ----- RETURNED BY USBH_SyncXfer() : -----
 *                           USBH_ERR_NONE                           Transfer successfully completed.
@@ -2631,20 +3498,15 @@ USBH_ERR  USBH_IntrRxAsync (USBH_EP              *p_ep,
 *********************************************************************************************************
 */
 
-CPU_INT32U  USBH_IsocTx (USBH_EP     *p_ep,
-                         CPU_INT08U  *p_buf,
+CPU_INT32U  USBH_IntrTx (USBH_EP     *p_ep,
+                         void        *p_buf,
                          CPU_INT32U   buf_len,
-                         CPU_INT32U   start_frm,
-                         CPU_INT32U   nbr_frm,
-                         CPU_INT16U  *p_frm_len,
-                         USBH_ERR    *p_frm_err,
                          CPU_INT32U   timeout_ms,
                          USBH_ERR    *p_err)
 {
-    CPU_INT08U      ep_type;
-    CPU_INT08U      ep_dir;
-    CPU_INT32U      xfer_len;
-    USBH_ISOC_DESC  isoc_desc;
+    CPU_INT08U  ep_type;
+    CPU_INT08U  ep_dir;
+    CPU_INT32U  xfer_len;
 
 
     if (p_ep == (USBH_EP *)0) {
@@ -2654,25 +3516,20 @@ CPU_INT32U  USBH_IsocTx (USBH_EP     *p_ep,
     ep_type = USBH_EP_TypeGet(p_ep);
     ep_dir  = USBH_EP_DirGet(p_ep);
 
-    if ((ep_type != USBH_EP_TYPE_ISOC) ||
+    if ((ep_type != USBH_EP_TYPE_INTR) ||
         (ep_dir  != USBH_EP_DIR_OUT  )) {
         return (USBH_ERR_EP_INVALID_TYPE);
     }
 
-    isoc_desc.BufPtr   = p_buf;
-    isoc_desc.BufLen   = buf_len;
-    isoc_desc.StartFrm = start_frm;
-    isoc_desc.NbrFrm   = nbr_frm;
-    isoc_desc.FrmLen   = p_frm_len;
-    isoc_desc.FrmErr   = p_frm_err;
-
-    xfer_len = USBH_SyncXfer(p_ep,
-                             p_buf,
-                             buf_len,
-                            &isoc_desc,
-                             USBH_TOKEN_OUT,
-                             timeout_ms,
-                             p_err);
+    xfer_len = USBH_SyncXfer(                  p_ep,
+                                               p_buf,
+                                               buf_len,
+                             (USBH_ISOC_DESC *)0,
+                             (USBH_SG_SEG    *)0,
+                                               0u,
+                                               USBH_TOKEN_OUT,
+                                               timeout_ms,
+                                               p_err);
 
     return (xfer_len);
 }
@@ -2680,9 +3537,9 @@ CPU_INT32U  USBH_IsocTx (USBH_EP     *p_ep,
 
 /*
 *********************************************************************************************************
-*                                          USBH_IsocTxAsync()
+*                                          USBH_IntrTxAsync()
 *
-* Description : Issue asynchronous isochronous request to transmit data to device.
+* Description : Issue asynchronous interrupt request to transmit data to device.
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
@@ -2690,21 +3547,13 @@ CPU_INT32U  USBH_IsocTx (USBH_EP     *p_ep,
 *
 *               buf_len         Buffer length in octets.
 *
-*               start_frm
-*
-*               nbr_frm
-*
-*               p_frm_len
-*
-*               p_frm_err
-*
 *               fnct            Function that will be invoked upon completion of transmit operation.
 *
 *               p_fnct_arg      Pointer to argument that will be passed as parameter of 'p_fnct'.
 *
 * Return(s)   : USBH_ERR_NONE                           If request is successfully submitted.
 *               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not isochronous or direction is not OUT.
+*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not interrupt or direction is not OUT.
 *
 *                                                       ----- RETURNED BY USBH_AsyncXfer() : -----
 *               USBH_ERR_NONE                           If transfer successfully submitted.
@@ -2718,22 +3567,15 @@ CPU_INT32U  USBH_IsocTx (USBH_EP     *p_ep,
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_IsocTxAsync (USBH_EP              *p_ep,
-                            CPU_INT08U           *p_buf,
+USBH_ERR  USBH_IntrTxAsync (USBH_EP              *p_ep,
+                            void                 *p_buf,
                             CPU_INT32U            buf_len,
-                            CPU_INT32U            start_frm,
-                            CPU_INT32U            nbr_frm,
-                            CPU_INT16U           *p_frm_len,
-                            USBH_ERR             *p_frm_err,
-                            USBH_ISOC_CMPL_FNCT   fnct,
+                            USBH_XFER_CMPL_FNCT   fnct,
                             void                 *p_fnct_arg)
 {
-    USBH_ERR         err;
-    CPU_INT08U       ep_type;
-    CPU_INT08U       ep_dir;
-    LIB_ERR          err_lib;
-    USBH_ISOC_DESC  *p_isoc_desc;
-    MEM_POOL        *p_isoc_desc_pool;
+    USBH_ERR     err;
+    CPU_INT08U   ep_type;
+    CPU_INT08U   ep_dir;
 
 
     if (p_ep == (USBH_EP *)0) {
@@ -2743,58 +3585,183 @@ USBH_ERR  USBH_IsocTxAsync (USBH_EP              *p_ep,
     ep_type = USBH_EP_TypeGet(p_ep);
     ep_dir  = USBH_EP_DirGet(p_ep);
 
-    if ((ep_type != USBH_EP_TYPE_ISOC) ||
+    if ((ep_type != USBH_EP_TYPE_INTR) ||
         (ep_dir  != USBH_EP_DIR_OUT  )) {
         return (USBH_ERR_EP_INVALID_TYPE);
     }
 
-    p_isoc_desc_pool = &p_ep->DevPtr->HC_Ptr->HostPtr->IsocDescPool;
-    p_isoc_desc      =  Mem_PoolBlkGet(p_isoc_desc_pool,
-                                       sizeof(USBH_ISOC_DESC),
-                                      &err_lib);
-    if (err_lib != LIB_MEM_ERR_NONE) {
-        return (USBH_ERR_DESC_ALLOC);
+    err = USBH_AsyncXfer(                  p_ep,
+                                           p_buf,
+                                           buf_len,
+                         (USBH_ISOC_DESC *)0,
+                         (USBH_SG_SEG    *)0,
+                                           0u,
+                                           USBH_TOKEN_OUT,
+                         (void           *)fnct,
+                                           p_fnct_arg);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             USBH_IntrRx()
+*
+* Description : Issue interrupt request to receive data from device.
+*
+* Argument(s) : p_ep            Pointer to endpoint.
+*
+*               p_buf           Pointer to destination buffer to receive data.
+*
+*               buf_len         Buffer length in octets.
+*
+*               timeout_ms      Timeout, in milliseconds.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                           USBH_ERR_NONE                           Interrupt transfer successfully received.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not interrupt or direction is not IN.
+*
+*                                                                   ----- RETURNED BY USBH_SyncXfer() : -----
+*                           USBH_ERR_NONE                           Transfer successfully completed.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
+*                           Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets received.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_IntrRx (USBH_EP     *p_ep,
+                         void        *p_buf,
+                         CPU_INT32U   buf_len,
+                         CPU_INT32U   timeout_ms,
+                         USBH_ERR    *p_err)
+{
+    CPU_INT08U  ep_type;
+    CPU_INT08U  ep_dir;
+    CPU_INT32U  xfer_len;
+
+
+    if (p_ep == (USBH_EP *)0) {
+        return (USBH_ERR_INVALID_ARG);
     }
 
-    p_isoc_desc->BufPtr   = p_buf;
-    p_isoc_desc->BufLen   = buf_len;
-    p_isoc_desc->StartFrm = start_frm;
-    p_isoc_desc->NbrFrm   = nbr_frm;
-    p_isoc_desc->FrmLen   = p_frm_len;
-    p_isoc_desc->FrmErr   = p_frm_err;
+    ep_type = USBH_EP_TypeGet(p_ep);
+    ep_dir  = USBH_EP_DirGet(p_ep);
 
-    err = USBH_AsyncXfer(        p_ep,
-                                 p_buf,
-                                 buf_len,
-                                 p_isoc_desc,
-                                 USBH_TOKEN_IN,
-                         (void *)fnct,
-                                 p_fnct_arg);
-    if (err != USBH_ERR_NONE) {
-        Mem_PoolBlkFree(p_isoc_desc_pool,
-                        p_isoc_desc,
-                       &err_lib);
+    if ((ep_type != USBH_EP_TYPE_INTR) ||
+        (ep_dir  != USBH_EP_DIR_IN   )) {
+        return (USBH_ERR_EP_INVALID_TYPE);
+    }
+
+    xfer_len = USBH_SyncXfer(                  p_ep,
+                                               p_buf,
+                                               buf_len,
+                             (USBH_ISOC_DESC *)0,
+                             (USBH_SG_SEG    *)0,
+                                               0u,
+                                               USBH_TOKEN_IN,
+                                               timeout_ms,
+                                               p_err);
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_IntrRxAsync()
+*
+* Description : Issue asynchronous interrupt request to receive data from device.
+*
+* Argument(s) : p_ep            Pointer to endpoint.
+*
+*               p_buf           Pointer to data buffer to transmit.
+*
+*               buf_len         Buffer length in octets.
+*
+*               fnct            Function that will be invoked upon completion of receive operation.
+*
+*               p_fnct_arg      Pointer to argument that will be passed as parameter of 'p_fnct'.
+*
+* Return(s)   : USBH_ERR_NONE                           If request is successfully submitted.
+*               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not interrupt or direction is not IN.
+*
+*                                                       ----- RETURNED BY USBH_AsyncXfer() : -----
+*               USBH_ERR_NONE                           If transfer successfully submitted.
+*               USBH_ERR_EP_INVALID_STATE               If endpoint is not opened.
+*               USBH_ERR_ALLOC                          If URB cannot be allocated.
+*               USBH_ERR_UNKNOWN                        If unknown error occured.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) This function returns immediately. The URB completion will be invoked by the
+*                   asynchronous I/O task when the transfer is completed.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_IntrRxAsync (USBH_EP              *p_ep,
+                            void                 *p_buf,
+                            CPU_INT32U            buf_len,
+                            USBH_XFER_CMPL_FNCT   fnct,
+                            void                 *p_fnct_arg)
+{
+    USBH_ERR    err;
+    CPU_INT08U  ep_type;
+    CPU_INT08U  ep_dir;
+
+                                                                /* Argument checks for valid settings                   */
+    if (p_ep == (USBH_EP *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    if (p_ep->IsOpen == DEF_FALSE) {
+        return (USBH_ERR_EP_INVALID_STATE);
+    }
+
+    ep_type = USBH_EP_TypeGet(p_ep);
+    ep_dir  = USBH_EP_DirGet(p_ep);
+
+    if ((ep_type != USBH_EP_TYPE_INTR) ||
+        (ep_dir  != USBH_EP_DIR_IN   )) {
+        return (USBH_ERR_EP_INVALID_TYPE);
     }
 
+    err = USBH_AsyncXfer(                  p_ep,
+                                           p_buf,
+                                           buf_len,
+                         (USBH_ISOC_DESC *)0,
+                         (USBH_SG_SEG    *)0,
+                                           0u,
+                                           USBH_TOKEN_IN,
+                         (void           *)fnct,
+                                           p_fnct_arg);
+
     return (err);
 }
 
 
 /*
 *********************************************************************************************************
-*                                             USBH_IsocRx()
+*                                             USBH_IsocTx()
 *
-* Description : Issue isochronous request to receive data from device.
+* Description : Issue isochronous request to transmit data to device.
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
-*               p_buf           Pointer to destination buffer to receive data.
+*               p_buf           Pointer to data buffer to transmit.
 *
 *               buf_len         Buffer length in octets.
 *
-*               start_frm
+*               start_frm       Transfer start frame number.
 *
-*               nbr_frm
+*               nbr_frm         Number of frames.
 *
 *               p_frm_len
 *
@@ -2804,9 +3771,9 @@ USBH_ERR  USBH_IsocTxAsync (USBH_EP              *p_ep,
 *
 *               p_err   Pointer to variable that will receive the return error code from this function :
 *
-*                           USBH_ERR_NONE                           Isochronous transfer successfully received.
+*                           USBH_ERR_NONE                           Isochronous transfer successfully transmitted.
 *                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
-*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not isochronous or direction is not IN.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not isochronous or direction is not OUT.
 *
 *                                                                   ----- RETURNED BY USBH_SyncXfer() : -----
 *                           USBH_ERR_NONE                           Transfer successfully completed.
@@ -2815,13 +3782,13 @@ USBH_ERR  USBH_IsocTxAsync (USBH_EP              *p_ep,
 *                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
 *                           Host controller drivers error code,     Otherwise.
 *
-* Return(s)   : Number of octets received.
+* Return(s)   : Number of octets transmitted.
 *
 * Note(s)     : None.
 *********************************************************************************************************
 */
 
-CPU_INT32U  USBH_IsocRx (USBH_EP     *p_ep,
+CPU_INT32U  USBH_IsocTx (USBH_EP     *p_ep,
                          CPU_INT08U  *p_buf,
                          CPU_INT32U   buf_len,
                          CPU_INT32U   start_frm,
@@ -2845,7 +3812,7 @@ CPU_INT32U  USBH_IsocRx (USBH_EP     *p_ep,
     ep_dir  = USBH_EP_DirGet(p_ep);
 
     if ((ep_type != USBH_EP_TYPE_ISOC) ||
-        (ep_dir  != USBH_EP_DIR_IN   )) {
+        (ep_dir  != USBH_EP_DIR_OUT  )) {
         return (USBH_ERR_EP_INVALID_TYPE);
     }
 
@@ -2860,7 +3827,9 @@ CPU_INT32U  USBH_IsocRx (USBH_EP     *p_ep,
                              p_buf,
                              buf_len,
                             &isoc_desc,
-                             USBH_TOKEN_IN,
+                             (USBH_SG_SEG *)0,
+                             0u,
+                             USBH_TOKEN_OUT,
                              timeout_ms,
                              p_err);
 
@@ -2870,13 +3839,13 @@ CPU_INT32U  USBH_IsocRx (USBH_EP     *p_ep,
 
 /*
 *********************************************************************************************************
-*                                          USBH_IsocRxAsync()
+*                                          USBH_IsocTxAsync()
 *
-* Description : Issue asynchronous isochronous request to receive data from device.
+* Description : Issue asynchronous isochronous request to transmit data to device.
 *
 * Argument(s) : p_ep            Pointer to endpoint.
 *
-*               p_buf           Pointer to destination buffer to receive data.
+*               p_buf           Pointer to data buffer to transmit.
 *
 *               buf_len         Buffer length in octets.
 *
@@ -2888,13 +3857,13 @@ CPU_INT32U  USBH_IsocRx (USBH_EP     *p_ep,
 *
 *               p_frm_err
 *
-*               fnct            Function that will be invoked upon completion of receive operation.
+*               fnct            Function that will be invoked upon completion of transmit operation.
 *
 *               p_fnct_arg      Pointer to argument that will be passed as parameter of 'p_fnct'.
 *
 * Return(s)   : USBH_ERR_NONE                           If request is successfully submitted.
 *               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep'.
-*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not isochronous or direction is not IN.
+*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not isochronous or direction is not OUT.
 *
 *                                                       ----- RETURNED BY USBH_AsyncXfer() : -----
 *               USBH_ERR_NONE                           If transfer successfully submitted.
@@ -2908,7 +3877,7 @@ CPU_INT32U  USBH_IsocRx (USBH_EP     *p_ep,
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_IsocRxAsync (USBH_EP              *p_ep,
+USBH_ERR  USBH_IsocTxAsync (USBH_EP              *p_ep,
                             CPU_INT08U           *p_buf,
                             CPU_INT32U            buf_len,
                             CPU_INT32U            start_frm,
@@ -2921,9 +3890,9 @@ USBH_ERR  USBH_IsocRxAsync (USBH_EP              *p_ep,
     USBH_ERR         err;
     CPU_INT08U       ep_type;
     CPU_INT08U       ep_dir;
+    LIB_ERR          err_lib;
     USBH_ISOC_DESC  *p_isoc_desc;
     MEM_POOL        *p_isoc_desc_pool;
-    LIB_ERR          err_lib;
 
 
     if (p_ep == (USBH_EP *)0) {
@@ -2934,7 +3903,7 @@ USBH_ERR  USBH_IsocRxAsync (USBH_EP              *p_ep,
     ep_dir  = USBH_EP_DirGet(p_ep);
 
     if ((ep_type != USBH_EP_TYPE_ISOC) ||
-        (ep_dir  != USBH_EP_DIR_IN   )) {
+        (ep_dir  != USBH_EP_DIR_OUT  )) {
         return (USBH_ERR_EP_INVALID_TYPE);
     }
 
@@ -2957,6 +3926,8 @@ USBH_ERR  USBH_IsocRxAsync (USBH_EP              *p_ep,
                                  p_buf,
                                  buf_len,
                                  p_isoc_desc,
+                                 (USBH_SG_SEG *)0,
+                                 0u,
                                  USBH_TOKEN_IN,
                          (void *)fnct,
                                  p_fnct_arg);
@@ -2972,36 +3943,230 @@ USBH_ERR  USBH_IsocRxAsync (USBH_EP              *p_ep,
 
 /*
 *********************************************************************************************************
-*                                         USBH_EP_LogNbrGet()
+*                                             USBH_IsocRx()
 *
-* Description : Get logical number of given endpoint.
+* Description : Issue isochronous request to receive data from device.
 *
-* Argument(s) : p_ep        Pointer to endpoint
+* Argument(s) : p_ep            Pointer to endpoint.
 *
-* Return(s)   : Logical number of given endpoint,
+*               p_buf           Pointer to destination buffer to receive data.
 *
-* Note(s)     : (1) USB2.0 spec, section 9.6.6 states that bits 3...0 in offset 2 of standard endpoint
-*                   descriptor (bEndpointAddress) contains the endpoint logical number.
-*********************************************************************************************************
-*/
-
-CPU_INT08U  USBH_EP_LogNbrGet (USBH_EP  *p_ep)
-{
-    return ((CPU_INT08U )p_ep->Desc.bEndpointAddress & 0x7Fu);  /* See Note (1).                                        */
-}
-
-
-/*
-*********************************************************************************************************
-*                                          USBH_EP_DirGet()
+*               buf_len         Buffer length in octets.
 *
-* Description : Get the direction of given endpoint.
+*               start_frm
 *
-* Argument(s) : p_ep        Pointer to endpoint structure.
+*               nbr_frm
 *
-* Return(s)   : USBH_EP_DIR_NONE,   If endpoint is of type control.
-*               USBH_EP_DIR_OUT,    If endpoint direction is OUT.
-*               USBH_EP_DIR_IN,     If endpoint direction is IN.
+*               p_frm_len
+*
+*               p_frm_err
+*
+*               timeout_ms      Timeout, in milliseconds.
+*
+*               p_err   Pointer to variable that will receive the return error code from this function :
+*
+*                           USBH_ERR_NONE                           Isochronous transfer successfully received.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_TYPE                Endpoint type is not isochronous or direction is not IN.
+*
+*                                                                   ----- RETURNED BY USBH_SyncXfer() : -----
+*                           USBH_ERR_NONE                           Transfer successfully completed.
+*                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
+*                           Host controller drivers error code,     Otherwise.
+*
+* Return(s)   : Number of octets received.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_IsocRx (USBH_EP     *p_ep,
+                         CPU_INT08U  *p_buf,
+                         CPU_INT32U   buf_len,
+                         CPU_INT32U   start_frm,
+                         CPU_INT32U   nbr_frm,
+                         CPU_INT16U  *p_frm_len,
+                         USBH_ERR    *p_frm_err,
+                         CPU_INT32U   timeout_ms,
+                         USBH_ERR    *p_err)
+{
+    CPU_INT08U      ep_type;
+    CPU_INT08U      ep_dir;
+    CPU_INT32U      xfer_len;
+    USBH_ISOC_DESC  isoc_desc;
+
+
+    if (p_ep == (USBH_EP *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    ep_type = USBH_EP_TypeGet(p_ep);
+    ep_dir  = USBH_EP_DirGet(p_ep);
+
+    if ((ep_type != USBH_EP_TYPE_ISOC) ||
+        (ep_dir  != USBH_EP_DIR_IN   )) {
+        return (USBH_ERR_EP_INVALID_TYPE);
+    }
+
+    isoc_desc.BufPtr   = p_buf;
+    isoc_desc.BufLen   = buf_len;
+    isoc_desc.StartFrm = start_frm;
+    isoc_desc.NbrFrm   = nbr_frm;
+    isoc_desc.FrmLen   = p_frm_len;
+    isoc_desc.FrmErr   = p_frm_err;
+
+    xfer_len = USBH_SyncXfer(p_ep,
+                             p_buf,
+                             buf_len,
+                            &isoc_desc,
+                             (USBH_SG_SEG *)0,
+                             0u,
+                             USBH_TOKEN_IN,
+                             timeout_ms,
+                             p_err);
+
+    return (xfer_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_IsocRxAsync()
+*
+* Description : Issue asynchronous isochronous request to receive data from device.
+*
+* Argument(s) : p_ep            Pointer to endpoint.
+*
+*               p_buf           Pointer to destination buffer to receive data.
+*
+*               buf_len         Buffer length in octets.
+*
+*               start_frm
+*
+*               nbr_frm
+*
+*               p_frm_len
+*
+*               p_frm_err
+*
+*               fnct            Function that will be invoked upon completion of receive operation.
+*
+*               p_fnct_arg      Pointer to argument that will be passed as parameter of 'p_fnct'.
+*
+* Return(s)   : USBH_ERR_NONE                           If request is successfully submitted.
+*               USBH_ERR_INVALID_ARG                    If invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_TYPE                If endpoint type is not isochronous or direction is not IN.
+*
+*                                                       ----- RETURNED BY USBH_AsyncXfer() : -----
+*               USBH_ERR_NONE                           If transfer successfully submitted.
+*               USBH_ERR_EP_INVALID_STATE               If endpoint is not opened.
+*               USBH_ERR_ALLOC                          If URB cannot be allocated.
+*               USBH_ERR_UNKNOWN                        If unknown error occured.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) This function returns immediately. The URB completion will be invoked by the
+*                   asynchronous I/O task when the transfer is completed.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_IsocRxAsync (USBH_EP              *p_ep,
+                            CPU_INT08U           *p_buf,
+                            CPU_INT32U            buf_len,
+                            CPU_INT32U            start_frm,
+                            CPU_INT32U            nbr_frm,
+                            CPU_INT16U           *p_frm_len,
+                            USBH_ERR             *p_frm_err,
+                            USBH_ISOC_CMPL_FNCT   fnct,
+                            void                 *p_fnct_arg)
+{
+    USBH_ERR         err;
+    CPU_INT08U       ep_type;
+    CPU_INT08U       ep_dir;
+    USBH_ISOC_DESC  *p_isoc_desc;
+    MEM_POOL        *p_isoc_desc_pool;
+    LIB_ERR          err_lib;
+
+
+    if (p_ep == (USBH_EP *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    ep_type = USBH_EP_TypeGet(p_ep);
+    ep_dir  = USBH_EP_DirGet(p_ep);
+
+    if ((ep_type != USBH_EP_TYPE_ISOC) ||
+        (ep_dir  != USBH_EP_DIR_IN   )) {
+        return (USBH_ERR_EP_INVALID_TYPE);
+    }
+
+    p_isoc_desc_pool = &p_ep->DevPtr->HC_Ptr->HostPtr->IsocDescPool;
+    p_isoc_desc      =  Mem_PoolBlkGet(p_isoc_desc_pool,
+                                       sizeof(USBH_ISOC_DESC),
+                                      &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+        return (USBH_ERR_DESC_ALLOC);
+    }
+
+    p_isoc_desc->BufPtr   = p_buf;
+    p_isoc_desc->BufLen   = buf_len;
+    p_isoc_desc->StartFrm = start_frm;
+    p_isoc_desc->NbrFrm   = nbr_frm;
+    p_isoc_desc->FrmLen   = p_frm_len;
+    p_isoc_desc->FrmErr   = p_frm_err;
+
+    err = USBH_AsyncXfer(        p_ep,
+                                 p_buf,
+                                 buf_len,
+                                 p_isoc_desc,
+                                 (USBH_SG_SEG *)0,
+                                 0u,
+                                 USBH_TOKEN_IN,
+                         (void *)fnct,
+                                 p_fnct_arg);
+    if (err != USBH_ERR_NONE) {
+        Mem_PoolBlkFree(p_isoc_desc_pool,
+                        p_isoc_desc,
+                       &err_lib);
+    }
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_EP_LogNbrGet()
+*
+* Description : Get logical number of given endpoint.
+*
+* Argument(s) : p_ep        Pointer to endpoint
+*
+* Return(s)   : Logical number of given endpoint,
+*
+* Note(s)     : (1) USB2.0 spec, section 9.6.6 states that bits 3...0 in offset 2 of standard endpoint
+*                   descriptor (bEndpointAddress) contains the endpoint logical number.
+*********************************************************************************************************
+*/
+
+CPU_INT08U  USBH_EP_LogNbrGet (USBH_EP  *p_ep)
+{
+    return ((CPU_INT08U )p_ep->Desc.bEndpointAddress & 0x7Fu);  /* See Note (1).                                        */
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_EP_DirGet()
+*
+* Description : Get the direction of given endpoint.
+*
+* Argument(s) : p_ep        Pointer to endpoint structure.
+*
+* Return(s)   : USBH_EP_DIR_NONE,   If endpoint is of type control.
+*               USBH_EP_DIR_OUT,    If endpoint direction is OUT.
+*               USBH_EP_DIR_IN,     If endpoint direction is IN.
 *
 * Note(s)     : (1) USB2.0 spec, section 9.6.6 states that bit 7 in offset 2 of standard endpoint
 *                   descriptor (bEndpointAddress) gives the direction of that endpoint.
@@ -3076,6 +4241,28 @@ CPU_INT08U  USBH_EP_TypeGet (USBH_EP  *p_ep)
 }
 
 
+/*
+*********************************************************************************************************
+*                                          USBH_EP_IntervalGet()
+*
+* Description : Get the polling interval of the given periodic endpoint.
+*
+* Argument(s) : p_ep          Pointer to endpoint
+*
+* Return(s)   : Polling interval in microseconds, 0 if endpoint is not periodic.
+*
+* Note(s)     : (1) The interval is set when the endpoint is opened, from its endpoint descriptor or from
+*                   the interval given to USBH_IntrInIntervalOpen(). Host controller drivers that round it
+*                   to fit their periodic schedule update it with the interval achieved.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_EP_IntervalGet (USBH_EP  *p_ep)
+{
+    return (p_ep->IntervalUs);                                  /* See Note (1).                                        */
+}
+
+
 /*
 *********************************************************************************************************
 *                                            USBH_EP_Get()
@@ -3232,6 +4419,8 @@ USBH_ERR  USBH_EP_StallClr (USBH_EP  *p_ep)
                              &err);
     if (err != USBH_ERR_NONE) {
         USBH_EP_Reset(p_dev, (USBH_EP *)0);
+    } else {
+        USBH_STAT_STALL_CLR(p_ep);
     }
 
     return (err);
@@ -3300,77 +4489,318 @@ USBH_ERR  USBH_EP_Reset (USBH_DEV  *p_dev,
 
 /*
 *********************************************************************************************************
-*                                            USBH_EP_Close()
+*                                            USBH_EP_Abort()
 *
-* Description : Closes given endpoint and makes it unavailable for I/O transfers.
+* Description : Abort all transfers queued on given endpoint. The endpoint remains opened.
 *
 * Argument(s) : p_ep        Pointer to endpoint.
 *
-* Return(s)   : USBH_ERR_NONE,                  If endpoint successfully closed.
+* Return(s)   : USBH_ERR_NONE,                  If transfers successfully aborted.
 *               USBH_ERR_INVALID_ARG,           If invalid argument passed to 'p_ep'.
 *               Host controller driver error,   Otherwise.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Aborted asynchronous transfers are completed with USBH_ERR_URB_ABORT. A transfer whose
+*                   completion is already queued to the asynchronous task is notified by that task; others
+*                   are notified before this function returns, from the caller's context.
 *********************************************************************************************************
 */
 
-USBH_ERR  USBH_EP_Close (USBH_EP  *p_ep)
+USBH_ERR  USBH_EP_Abort (USBH_EP  *p_ep)
 {
     USBH_ERR   err;
     USBH_DEV  *p_dev;
     USBH_URB  *p_async_urb;
-    LIB_ERR    err_lib;
+    USBH_URB  *p_async_urb_nxt;
 
 
-    if(p_ep == (USBH_EP *)0) {
-       return(USBH_ERR_INVALID_ARG);
+    if (p_ep == (USBH_EP *)0) {
+        return (USBH_ERR_INVALID_ARG);
     }
 
-    p_ep->IsOpen = DEF_FALSE;
-    p_dev        = p_ep->DevPtr;
-    err          = USBH_ERR_NONE;
-
-    if (!((p_dev->IsRootHub            == DEF_TRUE) &&
-          (p_dev->HC_Ptr->IsVirRootHub == DEF_TRUE))){
-        USBH_URB_Abort(&p_ep->URB);                             /* Abort any pending URB.                               */
+    p_dev = p_ep->DevPtr;
+    if ((p_dev->IsRootHub            == DEF_TRUE) &&            /* Do nothing if virtual RH.                            */
+        (p_dev->HC_Ptr->IsVirRootHub == DEF_TRUE)) {
+        return (USBH_ERR_NONE);
     }
 
-    if (p_ep->URB.Sem != (USBH_HSEM )0) {                       /* Close EP sem and mutex.                              */
-        (void)USBH_OS_SemDestroy(p_ep->URB.Sem);
-        p_ep->URB.Sem = (USBH_HSEM )0;
-    }
+    USBH_HCD_EP_Abort(p_dev->HC_Ptr,                            /* Abort pending xfers on EP.                           */
+                      p_ep,
+                     &err);
 
-    if (p_ep->Mutex != (USBH_HMUTEX )0) {
-        (void)USBH_OS_MutexDestroy(p_ep->Mutex);
-        p_ep->Mutex = (USBH_HMUTEX )0;
+    USBH_URB_Abort(&p_ep->URB);                                 /* Complete aborted URBs (see Note #1).                 */
+
+    p_async_urb = p_ep->URB.AsyncURB_NxtPtr;
+    while (p_async_urb != 0) {
+        p_async_urb_nxt = p_async_urb->AsyncURB_NxtPtr;
+        if (p_async_urb->FnctPtr != (void *)0) {
+            USBH_URB_Abort(p_async_urb);
+        }
+        p_async_urb = p_async_urb_nxt;
     }
 
-    if (!((p_dev->IsRootHub            == DEF_TRUE) &&          /* Close EP on HC.                                      */
-          (p_dev->HC_Ptr->IsVirRootHub == DEF_TRUE))){
-        USBH_HCD_EP_Close(p_ep->DevPtr->HC_Ptr,
-                          p_ep,
-                         &err);
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            USBH_EP_Close()
+*
+* Description : Closes given endpoint and makes it unavailable for I/O transfers.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+* Return(s)   : USBH_ERR_NONE,                  If endpoint successfully closed.
+*               USBH_ERR_INVALID_ARG,           If invalid argument passed to 'p_ep'.
+*               Host controller driver error,   Otherwise.
+*
+* Note(s)     : (1) An aborted extra URB that is still linked in an async completion queue is unlinked from it
+*                   before being freed. An aborted extra URB already dequeued by an async task is left to that
+*                   task, which frees it once completed.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_EP_Close (USBH_EP  *p_ep)
+{
+    USBH_ERR   err;
+    USBH_DEV  *p_dev;
+    USBH_URB  *p_async_urb;
+    USBH_URB  *p_async_urb_nxt;
+    USBH_URB  *p_free_urb;
+    LIB_ERR    err_lib;
+    CPU_SR_ALLOC();
+
+
+    if(p_ep == (USBH_EP *)0) {
+       return(USBH_ERR_INVALID_ARG);
     }
 
-    if(p_ep->XferNbrInProgress > 1u) {
+    p_ep->IsOpen = DEF_FALSE;
+    p_dev        = p_ep->DevPtr;
+    err          = USBH_ERR_NONE;
+
+    if (!((p_dev->IsRootHub            == DEF_TRUE) &&
+          (p_dev->HC_Ptr->IsVirRootHub == DEF_TRUE))){
+        USBH_URB_Abort(&p_ep->URB);                             /* Abort any pending URB.                               */
 
-        p_async_urb = p_ep->URB.AsyncURB_NxtPtr;
+        p_async_urb = p_ep->URB.AsyncURB_NxtPtr;                /* Abort URBs queued behind it.                         */
         while (p_async_urb != 0) {
-                                                                /* Free extra URB.                                      */
-            Mem_PoolBlkFree(       &p_ep->DevPtr->HC_Ptr->HostPtr->AsyncURB_Pool,
-                            (void *)p_async_urb,
-                                   &err_lib);
+            p_async_urb_nxt = p_async_urb->AsyncURB_NxtPtr;
+            if (p_async_urb->FnctPtr != (void *)0) {
+                USBH_URB_Abort(p_async_urb);
+            }
+            p_async_urb = p_async_urb_nxt;
+        }
+    }
+
+    if (p_ep->URB.Sem != (USBH_HSEM )0) {                       /* Close EP sem and mutex.                              */
+        (void)USBH_OS_SemDestroy(p_ep->URB.Sem);
+        p_ep->URB.Sem = (USBH_HSEM )0;
+    }
+
+    if (p_ep->Mutex != (USBH_HMUTEX )0) {
+        (void)USBH_OS_MutexDestroy(p_ep->Mutex);
+        p_ep->Mutex = (USBH_HMUTEX )0;
+    }
+
+    if (!((p_dev->IsRootHub            == DEF_TRUE) &&          /* Close EP on HC.                                      */
+          (p_dev->HC_Ptr->IsVirRootHub == DEF_TRUE))){
+        USBH_HCD_EP_Close(p_ep->DevPtr->HC_Ptr,
+                          p_ep,
+                         &err);
+    }
+
+    p_free_urb = (USBH_URB *)0;
 
-            p_async_urb = p_async_urb->AsyncURB_NxtPtr;
+    CPU_CRITICAL_ENTER();                                       /* Detach extra URBs from EP.                           */
+    p_async_urb               = p_ep->URB.AsyncURB_NxtPtr;
+    p_ep->URB.AsyncURB_NxtPtr = (USBH_URB *)0;
+    p_ep->XferNbrInProgress   = 0u;
+
+    while (p_async_urb != (USBH_URB *)0) {
+        p_async_urb_nxt = p_async_urb->AsyncURB_NxtPtr;
+
+        if (((p_async_urb->State != USBH_URB_STATE_QUEUED ) &&
+             (p_async_urb->State != USBH_URB_STATE_ABORTED)) ||
+            (USBH_URB_AsyncUnlink(p_async_urb) == DEF_YES)) {   /* See Note #1.                                         */
+            p_async_urb->AsyncURB_NxtPtr = p_free_urb;
+            p_free_urb                   = p_async_urb;
         }
 
-        p_ep->XferNbrInProgress = 0u;
+        p_async_urb = p_async_urb_nxt;
+    }
+    CPU_CRITICAL_EXIT();
+
+    while (p_free_urb != (USBH_URB *)0) {
+        p_async_urb_nxt = p_free_urb->AsyncURB_NxtPtr;
+                                                                /* Free extra URB.                                      */
+        Mem_PoolBlkFree(       &p_ep->DevPtr->HC_Ptr->HostPtr->AsyncURB_Pool,
+                        (void *)p_free_urb,
+                               &err_lib);
+
+        p_free_urb = p_async_urb_nxt;
     }
 
     return (err);
 }
 
 
+/*
+*********************************************************************************************************
+*                                        USBH_EP_AsyncPrioSet()
+*
+* Description : Select the asynchronous completion task used for the transfers on given endpoint.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               prio        Index of asynchronous completion task, from 0 (most latency sensitive) to
+*                           (USBH_CFG_ASYNC_TASK_NBR - 1).
+*
+* Return(s)   : USBH_ERR_NONE,                  If completion task successfully selected.
+*               USBH_ERR_INVALID_ARG,           If invalid argument passed to 'p_ep' / 'prio'.
+*               USBH_ERR_EP_INVALID_STATE,      If endpoint is not opened or has transfers in progress.
+*
+* Note(s)     : (1) The completion task is selected when the endpoint is opened, according to
+*                   USBH_CFG_ASYNC_TASK_ROUTE. This function overrides that selection and must be called
+*                   before any transfer is submitted on the endpoint, so that completions are not reordered.
+*********************************************************************************************************
+*/
+
+USBH_ERR  USBH_EP_AsyncPrioSet (USBH_EP     *p_ep,
+                                CPU_INT08U   prio)
+{
+    CPU_SR_ALLOC();
+
+
+    if ((p_ep == (USBH_EP *)0) ||
+        (prio >= USBH_CFG_ASYNC_TASK_NBR)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    CPU_CRITICAL_ENTER();
+    if ((p_ep->IsOpen            == DEF_FALSE) ||
+        (p_ep->XferNbrInProgress != 0u)) {
+        CPU_CRITICAL_EXIT();
+        return (USBH_ERR_EP_INVALID_STATE);
+    }
+
+    p_ep->AsyncPrio = prio;
+    CPU_CRITICAL_EXIT();
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_EP_StatsGet()
+*
+* Description : Get a snapshot of the transfer statistics of an endpoint.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               p_stat      Pointer to structure that will receive the statistics.
+*
+* Return(s)   : USBH_ERR_NONE,          If statistics were retrieved.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_ep' / 'p_stat'.
+*
+* Note(s)     : (1) Statistics are cleared when the endpoint is opened.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+USBH_ERR  USBH_EP_StatsGet (USBH_EP         *p_ep,
+                            USBH_XFER_STAT  *p_stat)
+{
+    if ((p_ep   == (USBH_EP        *)0) ||
+        (p_stat == (USBH_XFER_STAT *)0)) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    USBH_StatCopy(p_stat, &p_ep->Stat);
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_EP_StatsClr()
+*
+* Description : Clear the transfer statistics of an endpoint.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+* Return(s)   : USBH_ERR_NONE,          If statistics were cleared.
+*               USBH_ERR_INVALID_ARG,   If invalid argument passed to 'p_ep'.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+USBH_ERR  USBH_EP_StatsClr (USBH_EP  *p_ep)
+{
+    CPU_SR_ALLOC();
+
+
+    if (p_ep == (USBH_EP *)0) {
+        return (USBH_ERR_INVALID_ARG);
+    }
+
+    CPU_CRITICAL_ENTER();
+    Mem_Clr((void *)&p_ep->Stat,
+                     sizeof(USBH_XFER_STAT));
+    CPU_CRITICAL_EXIT();
+
+    return (USBH_ERR_NONE);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_EP_StatHCD_Upd()
+*
+* Description : Add NAKs and transaction retries observed by host controller driver to the statistics of
+*               an endpoint.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               nak_cnt     Number of NAKs to add.
+*
+*               retry_cnt   Number of transaction retries to add.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function may be called from the host controller ISR. It should be called through
+*                   USBH_EP_STAT_NAK_INC() and USBH_EP_STAT_RETRY_INC().
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+void  USBH_EP_StatHCD_Upd (USBH_EP     *p_ep,
+                           CPU_INT32U   nak_cnt,
+                           CPU_INT32U   retry_cnt)
+{
+    CPU_SR_ALLOC();
+
+
+    if (p_ep == (USBH_EP *)0) {
+        return;
+    }
+
+    CPU_CRITICAL_ENTER();
+    p_ep->Stat.NAK_Cnt          += nak_cnt;
+    p_ep->Stat.RetryCnt         += retry_cnt;
+    p_ep->DevPtr->Stat.NAK_Cnt  += nak_cnt;
+    p_ep->DevPtr->Stat.RetryCnt += retry_cnt;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                           USBH_URB_Done()
@@ -3381,34 +4811,51 @@ USBH_ERR  USBH_EP_Close (USBH_EP  *p_ep)
 *
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) When async completion batching is enabled, the async task detaches the whole completion
+*                   list on each wakeup. The semaphore is thus only posted when the list goes from empty to
+*                   non-empty; URBs appended to a non-empty list will be picked up by the pending wakeup.
+*
+*               (2) Async URBs are queued to the completion task selected by the endpoint's 'AsyncPrio'.
 *********************************************************************************************************
 */
 
 void  USBH_URB_Done (USBH_URB  *p_urb)
 {
-
+    USBH_ASYNC_QUEUE  *p_queue;
+    CPU_BOOLEAN        post;
     CPU_SR_ALLOC();
 
 
     if (p_urb->State == USBH_URB_STATE_SCHEDULED) {             /* URB must be in scheduled state.                      */
+        USBH_TRACE_REC(USBH_TRACE_EVT_DONE, p_urb, p_urb->XferLen);
+
         p_urb->State = USBH_URB_STATE_QUEUED;                   /* Set URB state to done.                               */
 
         if (p_urb->FnctPtr != (void *)0) {                      /* Check if req is async.                               */
+            p_queue = &USBH_AsyncQueueTbl[p_urb->EP_Ptr->AsyncPrio];    /* See Note #2.                                 */
+
             CPU_CRITICAL_ENTER();
             p_urb->NxtPtr = (USBH_URB *)0;
 
-            if (USBH_URB_HeadPtr == (USBH_URB *)0) {
-                USBH_URB_HeadPtr = p_urb;
-                USBH_URB_TailPtr = p_urb;
+            if (p_queue->HeadPtr == (USBH_URB *)0) {
+                p_queue->HeadPtr = p_urb;
+                p_queue->TailPtr = p_urb;
+                post             = DEF_TRUE;
             } else {
-                USBH_URB_TailPtr->NxtPtr = p_urb;
-                USBH_URB_TailPtr         = p_urb;
+                p_queue->TailPtr->NxtPtr = p_urb;
+                p_queue->TailPtr         = p_urb;
+#if (USBH_CFG_ASYNC_BATCH_EN == DEF_ENABLED)
+                post                     = DEF_FALSE;           /* See Note #1.                                         */
+#else
+                post                     = DEF_TRUE;
+#endif
             }
 
             CPU_CRITICAL_EXIT();
 
-            (void)USBH_OS_SemPost(USBH_URB_Sem);
+            if (post == DEF_TRUE) {
+                (void)USBH_OS_SemPost(p_queue->Sem);
+            }
         } else {
             (void)USBH_OS_SemPost(p_urb->Sem);                  /* Post notification to waiting task.                   */
         }
@@ -3434,9 +4881,6 @@ USBH_ERR  USBH_URB_Complete (USBH_URB  *p_urb)
 {
     USBH_DEV  *p_dev;
     USBH_ERR   err;
-    LIB_ERR    err_lib;
-    USBH_URB  *p_async_urb_to_remove;
-    USBH_URB  *p_prev_async_urb;
     USBH_URB   urb_temp;
     USBH_EP   *p_ep;
     CPU_SR_ALLOC();
@@ -3460,6 +4904,13 @@ USBH_ERR  USBH_URB_Complete (USBH_URB  *p_urb)
                                                                 /* Empty Else Statement                                 */
     }
 
+    if ((p_urb->State == USBH_URB_STATE_QUEUED) ||
+        (p_urb->State == USBH_URB_STATE_ABORTED)) {
+        USBH_STAT_CMPL(p_urb);
+    }
+
+    USBH_URB_SG_Release(p_urb);                                 /* Copy back bounce buf, if any.                        */
+
     Mem_Copy((void *)&urb_temp,                                 /* Copy urb locally before freeing it.                  */
              (void *) p_urb,
                       sizeof(USBH_URB));
@@ -3467,24 +4918,7 @@ USBH_ERR  USBH_URB_Complete (USBH_URB  *p_urb)
                                                                 /* --------- FREE URB BEFORE NOTIFYING CLASS ---------- */
     if((p_urb          != &p_ep->URB) &&                        /* Is the URB an extra URB for async function?          */
        (p_urb->FnctPtr != 0         )) {
-
-        p_async_urb_to_remove = &p_ep->URB;
-        p_prev_async_urb      = &p_ep->URB;
-
-        while (p_async_urb_to_remove->AsyncURB_NxtPtr != 0) {   /* Srch extra URB to remove.                            */
-                                                                /* Extra URB found                                      */
-            if(p_async_urb_to_remove->AsyncURB_NxtPtr == p_urb) {
-                                                                /* Remove from Q.                                       */
-                p_prev_async_urb->AsyncURB_NxtPtr = p_urb->AsyncURB_NxtPtr;
-                break;
-            }
-            p_prev_async_urb      = p_async_urb_to_remove;
-            p_async_urb_to_remove = p_async_urb_to_remove->AsyncURB_NxtPtr;
-        }
-                                                                /* Free extra URB.                                      */
-        Mem_PoolBlkFree(       &p_dev->HC_Ptr->HostPtr->AsyncURB_Pool,
-                        (void *)p_urb,
-                               &err_lib);
+        USBH_URB_Release(p_ep, p_urb);
     }
 
     CPU_CRITICAL_ENTER();
@@ -3496,12 +4930,107 @@ USBH_ERR  USBH_URB_Complete (USBH_URB  *p_urb)
     if ((urb_temp.State == USBH_URB_STATE_QUEUED) ||
         (urb_temp.State == USBH_URB_STATE_ABORTED)) {
         USBH_URB_Notify(&urb_temp);
+
+        USBH_TRACE_REC(USBH_TRACE_EVT_NOTIFY, &urb_temp, urb_temp.XferLen);
     }
 
     return (USBH_ERR_NONE);
 }
 
 
+/*
+*********************************************************************************************************
+*                                        USBH_URB_SG_Gather()
+*
+* Description : Copy the scatter-gather segments of given URB to a contiguous buffer.
+*
+* Argument(s) : p_urb       Pointer to URB.
+*
+*               p_dst       Pointer to destination buffer.
+*
+*               len         Maximum number of octets to copy.
+*
+* Return(s)   : Number of octets copied.
+*
+* Note(s)     : (1) This function is used by the core and host controller drivers that need a contiguous
+*                   copy of a scatter-gather transfer (bounce or dedicated memory buffer).
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_URB_SG_Gather (USBH_URB    *p_urb,
+                                void        *p_dst,
+                                CPU_INT32U   len)
+{
+    CPU_INT08U  *p_dst_08;
+    CPU_INT32U   copy_len;
+    CPU_INT32U   rem_len;
+    CPU_INT08U   seg_ix;
+
+
+    p_dst_08 = (CPU_INT08U *)p_dst;
+    rem_len  =  len;
+
+    for (seg_ix = 0u; (seg_ix < p_urb->SG_SegNbr) && (rem_len > 0u); seg_ix++) {
+        copy_len = DEF_MIN(p_urb->SG_SegTblPtr[seg_ix].BufLen, rem_len);
+
+        Mem_Copy((void      *)p_dst_08,
+                 (void      *)p_urb->SG_SegTblPtr[seg_ix].BufPtr,
+                 (CPU_SIZE_T )copy_len);
+
+        p_dst_08 += copy_len;
+        rem_len  -= copy_len;
+    }
+
+    return (len - rem_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_URB_SG_Scatter()
+*
+* Description : Copy a contiguous buffer to the scatter-gather segments of given URB.
+*
+* Argument(s) : p_urb       Pointer to URB.
+*
+*               p_src       Pointer to source buffer.
+*
+*               len         Number of octets to copy.
+*
+* Return(s)   : Number of octets copied.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  USBH_URB_SG_Scatter (USBH_URB    *p_urb,
+                                 void        *p_src,
+                                 CPU_INT32U   len)
+{
+    CPU_INT08U  *p_src_08;
+    CPU_INT32U   copy_len;
+    CPU_INT32U   rem_len;
+    CPU_INT08U   seg_ix;
+
+
+    p_src_08 = (CPU_INT08U *)p_src;
+    rem_len  =  len;
+
+    for (seg_ix = 0u; (seg_ix < p_urb->SG_SegNbr) && (rem_len > 0u); seg_ix++) {
+        copy_len = DEF_MIN(p_urb->SG_SegTblPtr[seg_ix].BufLen, rem_len);
+
+        Mem_Copy((void      *)p_urb->SG_SegTblPtr[seg_ix].BufPtr,
+                 (void      *)p_src_08,
+                 (CPU_SIZE_T )copy_len);
+
+        p_src_08 += copy_len;
+        rem_len  -= copy_len;
+    }
+
+    return (len - rem_len);
+}
+
+
 /*
 *********************************************************************************************************
 *                                            USBH_StrGet()
@@ -3639,6 +5168,11 @@ CPU_INT32U  USBH_StrGet (USBH_DEV    *p_dev,
 *
 *               ep_dir      Endpoint direction.
 *
+*               ep_addr     Endpoint address (see Note #3).
+*
+*               interval_us Polling interval of interrupt endpoint, in microseconds (see Note #4). 0 uses the
+*                           interval of the endpoint descriptor.
+*
 *               p_ep        Pointer to endpoint passed by class.
 *
 * Return(s)   : USBH_ERR_NONE                       If endpoint is successfully opened.
@@ -3660,6 +5194,18 @@ CPU_INT32U  USBH_StrGet (USBH_DEV    *p_dev,
 *               (2) Full-/high-speed isochronous endpoints must specify a desired period as
 *                   2^(bInterval-1) x F, where bInterval is in the range [1 .. 16] and F is 125us for
 *                   high-speed and 1ms for full-speed.
+*
+*               (3) If 'ep_addr' is 0, the first endpoint of the interface matching the given type and
+*                   direction is opened. Otherwise, the endpoint address must match as well.
+*
+*               (4) An interval given by the caller is rounded down to whole frames (1 ms to 255 ms) for
+*                   low- and full-speed endpoints, and to whole micro-frames (125 us to 4.096 s) for
+*                   high-speed endpoints. It may be shorter than the one of the endpoint descriptor, which
+*                   only gives the longest interval acceptable to the device.
+*
+*               (5) 'Interval' is kept in frames, or in micro-frames for high-speed endpoints & endpoints
+*                   reached through a high-speed hub. 'IntervalUs' gives the same interval in microseconds
+*                   (see USBH_EP_IntervalGet()).
 *********************************************************************************************************
 */
 
@@ -3667,6 +5213,8 @@ static  USBH_ERR  USBH_EP_Open (USBH_DEV      *p_dev,
                                 USBH_IF       *p_if,
                                 USBH_EP_TYPE   ep_type,
                                 USBH_EP_DIR    ep_dir,
+                                CPU_INT08U     ep_addr,
+                                CPU_INT32U     interval_us,
                                 USBH_EP       *p_ep)
 {
     CPU_INT08U   ep_desc_dir;
@@ -3701,6 +5249,11 @@ static  USBH_ERR  USBH_EP_Open (USBH_DEV      *p_dev,
         ep_desc_type = p_ep->Desc.bmAttributes     & 0x03u;     /* EP type from desc.                                   */
         ep_desc_dir  = p_ep->Desc.bEndpointAddress & 0x80u;     /* EP dir from desc.                                    */
 
+        if ((ep_addr != 0u) &&                                  /* See Note #3.                                         */
+            (ep_addr != p_ep->Desc.bEndpointAddress)) {
+            continue;
+        }
+
         if (ep_desc_type == ep_type) {
             if ((ep_desc_type == USBH_EP_TYPE_CTRL) ||
                 (ep_desc_dir  == ep_dir)) {
@@ -3714,32 +5267,50 @@ static  USBH_ERR  USBH_EP_Open (USBH_DEV      *p_dev,
         return (USBH_ERR_EP_NOT_FOUND);                         /* Class specified EP not found.                        */
     }
 
-    p_ep->Interval = 0u;
+    p_ep->Interval   = 0u;
+    p_ep->IntervalUs = 0u;
     if (ep_desc_type == USBH_EP_TYPE_INTR) {                    /* ------------ DETERMINE POLLING INTERVAL ------------ */
 
-        if (p_ep->Desc.bInterval > 0) {                         /* See Note #1.                                         */
+        if ((p_dev->DevSpd == USBH_DEV_SPD_LOW ) ||
+            (p_dev->DevSpd == USBH_DEV_SPD_FULL)) {
 
-            if ((p_dev->DevSpd == USBH_DEV_SPD_LOW ) ||
-                (p_dev->DevSpd == USBH_DEV_SPD_FULL)) {
+            if (interval_us != 0u) {                            /* See Note #4.                                         */
+                p_ep->IntervalUs = DEF_MIN(DEF_MAX(interval_us / 1000u, 1u), 255u) * 1000u;
+            } else {                                            /* See Note #1.                                         */
+                p_ep->IntervalUs = (CPU_INT32U)p_ep->Desc.bInterval * 1000u;
+            }
 
-                if (p_dev->HubHS_Ptr != (USBH_HUB_DEV *) 0) {
-                    p_ep->Interval = 8u * p_ep->Desc.bInterval; /* 1 (1ms)frame = 8 (125us)microframe.                  */
-                } else {
-                    p_ep->Interval = p_ep->Desc.bInterval;
-                }
-            } else {                                            /* DevSpd == USBH_DEV_SPD_HIGH                          */
-                p_ep->Interval = 1 << (p_ep->Desc.bInterval - 1);  /* For HS, interval is 2 ^ (bInterval - 1).          */
+            if (p_dev->HubHS_Ptr != (USBH_HUB_DEV *) 0) {       /* See Note #5.                                         */
+                                                                /* 1 (1ms)frame = 8 (125us)microframe.                  */
+                p_ep->Interval = (CPU_INT16U)(8u * (p_ep->IntervalUs / 1000u));
+            } else {
+                p_ep->Interval = (CPU_INT16U)(p_ep->IntervalUs / 1000u);
+            }
+        } else {                                                /* DevSpd == USBH_DEV_SPD_HIGH                          */
+            if (interval_us != 0u) {
+                p_ep->IntervalUs = DEF_MIN(DEF_MAX(interval_us / 125u, 1u), 32768u) * 125u;
+            } else if (p_ep->Desc.bInterval > 0) {              /* For HS, interval is 2 ^ (bInterval - 1).             */
+                p_ep->IntervalUs = DEF_BIT(DEF_MIN(p_ep->Desc.bInterval, 16u) - 1u) * 125u;
+            } else {
+                                                                /* Empty Else Statement                                 */
             }
+            p_ep->Interval = (CPU_INT16U)(p_ep->IntervalUs / 125u);
         }
     } else if (ep_desc_type == USBH_EP_TYPE_ISOC) {
-        p_ep->Interval = 1 << (p_ep->Desc.bInterval - 1);       /* Isoc interval is 2 ^ (bInterval - 1). See Note #2.   */
+        p_ep->Interval   = 1 << (p_ep->Desc.bInterval - 1);     /* Isoc interval is 2 ^ (bInterval - 1). See Note #2.   */
+        p_ep->IntervalUs = (CPU_INT32U)p_ep->Interval * ((p_dev->DevSpd == USBH_DEV_SPD_HIGH) ? 125u : 1000u);
     } else {
                                                                 /* Empty Else Statement                                 */
     }
 
-    p_ep->DevAddr = p_dev->DevAddr;
-    p_ep->DevSpd  = p_dev->DevSpd;
-    p_ep->DevPtr  = p_dev;
+    p_ep->DevAddr   = p_dev->DevAddr;
+    p_ep->DevSpd    = p_dev->DevSpd;
+    p_ep->DevPtr    = p_dev;
+    p_ep->AsyncPrio = USBH_AsyncPrioGet(p_dev, ep_desc_type);
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+    Mem_Clr((void *)&p_ep->Stat,
+                     sizeof(USBH_XFER_STAT));
+#endif
 
     if (!((p_dev->IsRootHub            == DEF_TRUE) &&
           (p_dev->HC_Ptr->IsVirRootHub == DEF_TRUE))){
@@ -3783,6 +5354,10 @@ static  USBH_ERR  USBH_EP_Open (USBH_DEV      *p_dev,
 *
 *               p_isoc_desc          Pointer to isochronous descriptor.
 *
+*               p_sg_tbl             Pointer to scatter-gather segment table, if any.
+*
+*               sg_nbr               Number of segments in 'p_sg_tbl' (0 if 'p_buf' is used).
+*
 *               token                USB token to issue.
 *
 *               timeout_ms           Timeout, in milliseconds.
@@ -3792,6 +5367,11 @@ static  USBH_ERR  USBH_EP_Open (USBH_DEV      *p_dev,
 *                           USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
 *                           USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
 *
+*                                                                   ----- RETURNED BY USBH_URB_SG_Prepare() : -----
+*                           USBH_ERR_INVALID_ARG                    Invalid segment table.
+*                           USBH_ERR_ALLOC                          Bounce buffer cannot be allocated.
+*                           USBH_ERR_NOT_SUPPORTED                  Segment table cannot be mapped nor bounced.
+*
 *                                                                   ----- RETURNED BY USBH_URB_Submit() : -----
 *                           USBH_ERR_NONE,                          URB is successfully submitted to host controller.
 *                           USBH_ERR_EP_INVALID_STATE,              Endpoint is in halt state.
@@ -3805,7 +5385,10 @@ static  USBH_ERR  USBH_EP_Open (USBH_DEV      *p_dev,
 *
 * Return(s)   : Number of bytes transmitted or received.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Synchronous transfers are serialized by the endpoint mutex, but they are queued behind
+*                   any asynchronous transfer in progress on the endpoint. In that case an extra URB is
+*                   used and signaled through the semaphore of the endpoint URB, which is never pended on
+*                   by asynchronous transfers.
 *********************************************************************************************************
 */
 
@@ -3813,12 +5396,15 @@ static  CPU_INT32U  USBH_SyncXfer (USBH_EP         *p_ep,
                                    void            *p_buf,
                                    CPU_INT32U       buf_len,
                                    USBH_ISOC_DESC  *p_isoc_desc,
+                                   USBH_SG_SEG     *p_sg_tbl,
+                                   CPU_INT08U       sg_nbr,
                                    USBH_TOKEN       token,
                                    CPU_INT32U       timeout_ms,
                                    USBH_ERR        *p_err)
 {
     CPU_INT32U   len;
     USBH_URB    *p_urb;
+    CPU_SR_ALLOC();
 
                                                                 /* Argument checks for valid settings                   */
     if (p_ep == (USBH_EP *)0) {
@@ -3833,7 +5419,12 @@ static  CPU_INT32U  USBH_SyncXfer (USBH_EP         *p_ep,
 
     (void)USBH_OS_MutexLock(p_ep->Mutex);
 
-    p_urb              = &p_ep->URB;
+    p_urb = USBH_URB_Get(p_ep, p_err);                          /* See Note #1.                                         */
+    if (p_urb == (USBH_URB *)0) {
+        (void)USBH_OS_MutexUnlock(p_ep->Mutex);
+        return (0u);
+    }
+
     p_urb->EP_Ptr      =  p_ep;
     p_urb->IsocDescPtr =  p_isoc_desc;
     p_urb->UserBufPtr  =  p_buf;
@@ -3846,22 +5437,45 @@ static  CPU_INT32U  USBH_SyncXfer (USBH_EP         *p_ep,
     p_urb->State       =  USBH_URB_STATE_NONE;
     p_urb->ArgPtr      = (void *)0;
     p_urb->Token       =  token;
+    p_urb->Sem         =  p_ep->URB.Sem;
+
+    USBH_STAT_SUBMIT(p_urb);
 
-   *p_err = USBH_URB_Submit(p_urb);
+   *p_err = USBH_URB_SG_Prepare(p_urb, p_sg_tbl, sg_nbr);
+    if (*p_err == USBH_ERR_NONE) {
+       *p_err = USBH_URB_Submit(p_urb);
+    }
 
     if (*p_err == USBH_ERR_NONE) {                              /* Transfer URB to HC.                                  */
        *p_err = USBH_OS_SemWait(p_urb->Sem, timeout_ms);        /* Wait on URB completion notification.                 */
+        if (*p_err == USBH_ERR_OS_TIMEOUT) {
+            USBH_STAT_ERR(p_ep, USBH_STAT_ERR_IX_TIMEOUT, *p_err);
+        }
+    } else {
+        USBH_STAT_ERR(p_ep, USBH_STAT_ERR_IX_SUBMIT, *p_err);
     }
 
     if (*p_err == USBH_ERR_NONE) {
         USBH_URB_Complete(p_urb);
        *p_err = p_urb->Err;
+    } else if (p_urb->State == USBH_URB_STATE_NONE) {           /* URB was never scheduled.                             */
+        USBH_URB_SG_Release(p_urb);
+
+        CPU_CRITICAL_ENTER();
+        p_ep->XferNbrInProgress--;
+        CPU_CRITICAL_EXIT();
+    } else if (p_urb->State == USBH_URB_STATE_QUEUED) {         /* URB completed after wait timed out.                  */
+        USBH_URB_Complete(p_urb);
     } else {
         USBH_URB_Abort(p_urb);
     }
 
     len          = p_urb->XferLen;
     p_urb->State = USBH_URB_STATE_NONE;
+
+    if (p_urb != &p_ep->URB) {                                  /* Release extra URB used by this xfer.                 */
+        USBH_URB_Release(p_ep, p_urb);
+    }
     (void)USBH_OS_MutexUnlock(p_ep->Mutex);
 
     return (len);
@@ -3882,6 +5496,10 @@ static  CPU_INT32U  USBH_SyncXfer (USBH_EP         *p_ep,
 *
 *               p_isoc_desc     Pointer to isochronous descriptor.
 *
+*               p_sg_tbl        Pointer to scatter-gather segment table, if any.
+*
+*               sg_nbr          Number of segments in 'p_sg_tbl' (0 if 'p_buf' is used).
+*
 *               token           USB token to issue.
 *
 *               p_fnct          Function that will be invoked upon completion of receive operation.
@@ -3890,8 +5508,15 @@ static  CPU_INT32U  USBH_SyncXfer (USBH_EP         *p_ep,
 *
 * Return(s)   : USBH_ERR_NONE                           If transfer successfully submitted.
 *               USBH_ERR_EP_INVALID_STATE               If endpoint is not opened.
+*
+*                                                       ----- RETURNED BY USBH_URB_Get() : -----
 *               USBH_ERR_ALLOC                          If URB cannot be allocated.
-*               USBH_ERR_UNKNOWN                        If unknown error occured.
+*               USBH_ERR_EP_QUEUE_FULL                  If endpoint submission queue is full.
+*
+*                                                       ----- RETURNED BY USBH_URB_SG_Prepare() : -----
+*               USBH_ERR_INVALID_ARG                    If segment table is invalid.
+*               USBH_ERR_ALLOC                          If bounce buffer cannot be allocated.
+*               USBH_ERR_NOT_SUPPORTED                  If segment table cannot be mapped nor bounced.
 *
 *                                                       ----- RETURNED BY USBH_URB_Submit() : -----
 *               USBH_ERR_NONE,                          If URB is successfully submitted to host controller.
@@ -3899,7 +5524,9 @@ static  CPU_INT32U  USBH_SyncXfer (USBH_EP         *p_ep,
 *               Host controller drivers error code,     Otherwise.
 *
 * Note(s)     : (1) This function returns immediately. The URB completion will be invoked by the
-*                   asynchronous I/O task when the transfer is completed.
+*                   asynchronous I/O task when the transfer is completed. Up to USBH_CFG_MAX_QUEUED_URB_PER_EP
+*                   transfers can be queued on the endpoint; the host controller driver processes them
+*                   back to back, in submission order.
 *********************************************************************************************************
 */
 
@@ -3907,49 +5534,25 @@ static  USBH_ERR  USBH_AsyncXfer (USBH_EP         *p_ep,
                                   void            *p_buf,
                                   CPU_INT32U       buf_len,
                                   USBH_ISOC_DESC  *p_isoc_desc,
+                                  USBH_SG_SEG     *p_sg_tbl,
+                                  CPU_INT08U       sg_nbr,
                                   USBH_TOKEN       token,
                                   void            *p_fnct,
                                   void            *p_fnct_arg)
 {
     USBH_ERR     err;
     USBH_URB    *p_urb;
-    USBH_URB    *p_async_urb;
-    MEM_POOL    *p_async_urb_pool;
-    LIB_ERR      err_lib;
+    CPU_SR_ALLOC();
 
 
     if (p_ep->IsOpen == DEF_FALSE) {
         return (USBH_ERR_EP_INVALID_STATE);
     }
 
-    if((p_ep->URB.State         != USBH_URB_STATE_SCHEDULED) && /* Chk if no xfer is pending or in progress on EP.      */
-       (p_ep->XferNbrInProgress == 0u                      )) {
-
-        p_urb = &p_ep->URB;                                     /* Use URB struct associated to EP.                     */
-
-    } else if (p_ep->XferNbrInProgress >= 1u) {
-                                                                /* Get a new URB struct from the URB async pool.        */
-        p_async_urb_pool = &p_ep->DevPtr->HC_Ptr->HostPtr->AsyncURB_Pool;
-        p_urb            = (USBH_URB *)Mem_PoolBlkGet(p_async_urb_pool,
-                                                      sizeof(USBH_URB),
-                                                     &err_lib);
-        if (err_lib != LIB_MEM_ERR_NONE) {
-            return (USBH_ERR_ALLOC);
-        }
-
-        USBH_URB_Clr(p_urb);
-
-        p_async_urb = &p_ep->URB;                               /* Get head of extra async URB Q.                       */
-
-        while (p_async_urb->AsyncURB_NxtPtr != 0) {             /* Srch tail of extra async URB Q.                      */
-            p_async_urb = p_async_urb->AsyncURB_NxtPtr;
-        }
-
-        p_async_urb->AsyncURB_NxtPtr = p_urb;                   /* Insert new URB at end of extra async URB Q.          */
-    } else {
-        return (USBH_ERR_UNKNOWN);
+    p_urb = USBH_URB_Get(p_ep, &err);                           /* Get a free URB from EP submission Q.                 */
+    if (p_urb == (USBH_URB *)0) {
+        return (err);
     }
-    p_ep->XferNbrInProgress++;
 
     p_urb->EP_Ptr      =  p_ep;                                 /* ------------------- PREPARE URB -------------------- */
     p_urb->IsocDescPtr =  p_isoc_desc;
@@ -3962,7 +5565,25 @@ static  USBH_ERR  USBH_AsyncXfer (USBH_EP         *p_ep,
     p_urb->ArgPtr      = (void *)0;
     p_urb->Token       =  token;
 
-    err = USBH_URB_Submit(p_urb);                               /* See Note (1).                                        */
+    USBH_STAT_SUBMIT(p_urb);
+
+    err = USBH_URB_SG_Prepare(p_urb, p_sg_tbl, sg_nbr);
+    if (err == USBH_ERR_NONE) {
+        err = USBH_URB_Submit(p_urb);                           /* See Note (1).                                        */
+    }
+    if (err != USBH_ERR_NONE) {                                 /* URB not accepted by HC, give it back.                */
+        USBH_STAT_ERR(p_ep, USBH_STAT_ERR_IX_SUBMIT, err);
+        USBH_URB_SG_Release(p_urb);
+        p_urb->State = USBH_URB_STATE_NONE;
+
+        CPU_CRITICAL_ENTER();
+        p_ep->XferNbrInProgress--;
+        CPU_CRITICAL_EXIT();
+
+        if (p_urb != &p_ep->URB) {
+            USBH_URB_Release(p_ep, p_urb);
+        }
+    }
 
     return (err);
 }
@@ -4038,6 +5659,8 @@ static  CPU_INT16U  USBH_SyncCtrlXfer (USBH_EP     *p_ep,
                         (void           *)&setup_buf[0u],
                                            USBH_LEN_SETUP_PKT,
                         (USBH_ISOC_DESC *) 0,
+                        (USBH_SG_SEG    *)0,
+                                           0u,
                                            USBH_TOKEN_SETUP,
                                            timeout_ms,
                                            p_err);
@@ -4057,6 +5680,8 @@ static  CPU_INT16U  USBH_SyncCtrlXfer (USBH_EP     *p_ep,
                                 (void           *)p_data_08,
                                                   w_len,
                                 (USBH_ISOC_DESC *)0,
+                                (USBH_SG_SEG    *)0,
+                                                  0u,
                                                  (is_in ? USBH_TOKEN_IN : USBH_TOKEN_OUT),
                                                   timeout_ms,
                                                   p_err);
@@ -4071,6 +5696,8 @@ static  CPU_INT16U  USBH_SyncCtrlXfer (USBH_EP     *p_ep,
                         (void           *)0,
                                           0u,
                         (USBH_ISOC_DESC *)0,
+                        (USBH_SG_SEG    *)0,
+                                          0u,
                                          ((w_len && is_in) ? USBH_TOKEN_OUT : USBH_TOKEN_IN),
                                           timeout_ms,
                                           p_err);
@@ -4223,67 +5850,841 @@ static  void  USBH_URB_Notify (USBH_URB  *p_urb)
 
 /*
 *********************************************************************************************************
-*                                           USBH_URB_Submit()
+*                                           USBH_URB_Submit()
+*
+* Description : Submit given URB to host controller.
+*
+* Argument(s) : p_urb       Pointer to URB.
+*
+* Return(s)   : USBH_ERR_NONE,                          If URB is successfully submitted to host controller.
+*               USBH_ERR_EP_INVALID_STATE,              If endpoint is in halt state.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_URB_Submit (USBH_URB  *p_urb)
+{
+    USBH_ERR      err;
+    CPU_BOOLEAN   ep_is_halt;
+    USBH_DEV     *p_dev;
+
+
+    p_dev = p_urb->EP_Ptr->DevPtr;
+    USBH_HCD_EP_IsHalt(p_dev->HC_Ptr,                           /* Check EP's state.                                    */
+                       p_urb->EP_Ptr,
+                      &ep_is_halt,
+                      &err);
+    if ((ep_is_halt == DEF_TRUE) &&
+        (err        == USBH_ERR_NONE)) {
+        return (USBH_ERR_EP_INVALID_STATE);
+    }
+
+    p_urb->State      = USBH_URB_STATE_SCHEDULED;               /* Set URB state to scheduled.                          */
+    p_urb->Err        = USBH_ERR_NONE;
+    p_urb->DMA_Direct = USBH_URB_DMA_Chk(p_urb);                /* Chk if HC can access data buf without copy.          */
+
+    USBH_TRACE_REC(USBH_TRACE_EVT_SUBMIT, p_urb, p_urb->UserBufLen);
+
+    USBH_HCD_URB_Submit(p_dev->HC_Ptr,
+                        p_urb,
+                       &err);
+
+    return (err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_URB_DMA_Chk()
+*
+* Description : Check if every data buffer of an URB can be accessed by the host controller DMA.
+*
+* Argument(s) : p_urb       Pointer to URB.
+*
+* Return(s)   : DEF_TRUE,   If host controller driver can use the buffer(s) without copy.
+*               DEF_FALSE,  Otherwise.
+*
+* Note(s)     : (1) See 'usbh_core.h  HOST CONTROLLER CONFIGURATION  Note #1'.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_URB_DMA_Chk (USBH_URB  *p_urb)
+{
+    USBH_HC_CFG  *p_hc_cfg;
+    CPU_INT08U    seg_ix;
+    CPU_BOOLEAN   valid;
+
+
+    p_hc_cfg = p_urb->EP_Ptr->DevPtr->HC_Ptr->HC_Drv.HC_CfgPtr;
+
+    if (USBH_URB_IS_SG(p_urb) == DEF_FALSE) {
+        valid = USBH_URB_DMA_BufChk(p_hc_cfg,
+                                    p_urb->UserBufPtr,
+                                    p_urb->UserBufLen);
+        return (valid);
+    }
+
+    for (seg_ix = 0u; seg_ix < p_urb->SG_SegNbr; seg_ix++) {
+        valid = USBH_URB_DMA_BufChk(p_hc_cfg,
+                                    p_urb->SG_SegTblPtr[seg_ix].BufPtr,
+                                    p_urb->SG_SegTblPtr[seg_ix].BufLen);
+        if (valid == DEF_FALSE) {
+            return (DEF_FALSE);
+        }
+    }
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_URB_DMA_BufChk()
+*
+* Description : Check if a data buffer satisfies the DMA constraints of a host controller.
+*
+* Argument(s) : p_hc_cfg    Pointer to host controller configuration.
+*
+*               p_buf       Pointer to data buffer.
+*
+*               buf_len     Buffer length in octets.
+*
+* Return(s)   : DEF_TRUE,   If buffer can be accessed by host controller DMA.
+*               DEF_FALSE,  Otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_URB_DMA_BufChk (USBH_HC_CFG  *p_hc_cfg,
+                                          void         *p_buf,
+                                          CPU_INT32U    buf_len)
+{
+    CPU_ADDR  buf_start;
+    CPU_ADDR  buf_end;
+
+
+    if (buf_len == 0u) {                                        /* No data phase, nothing to copy.                      */
+        return (DEF_TRUE);
+    }
+
+    buf_start = (CPU_ADDR)p_buf;
+    buf_end   =  buf_start + buf_len;
+
+    if ((p_hc_cfg->DMA_BufAlign          >  1u) &&              /* Chk buf alignment.                                   */
+        ((buf_start % p_hc_cfg->DMA_BufAlign) != 0u)) {
+        return (DEF_FALSE);
+    }
+
+    if ((p_hc_cfg->DedicatedMemAddr != (CPU_ADDR)0) &&          /* Buf located in dedicated mem.                        */
+        (buf_start                  >= p_hc_cfg->DedicatedMemAddr) &&
+        (buf_end                    <= p_hc_cfg->DedicatedMemAddr + p_hc_cfg->DedicatedMemSize)) {
+        return (DEF_TRUE);
+    }
+
+    if (p_hc_cfg->DMA_MemSize != 0u) {                          /* Buf located in sys mem region reachable by DMA.      */
+        if ((buf_start >= p_hc_cfg->DMA_MemAddr) &&
+            (buf_end   <= p_hc_cfg->DMA_MemAddr + p_hc_cfg->DMA_MemSize)) {
+            return (DEF_TRUE);
+        }
+    }
+
+    return (DEF_FALSE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_TraceRec()
+*
+* Description : Add a record to the transfer trace ring.
+*
+* Argument(s) : evt         Trace event (see 'usbh_core.h  TRANSFER TRACE EVENTS').
+*
+*               p_urb       Pointer to URB.
+*
+*               len         Length to record.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function is called from the host controller ISR through USBH_URB_Done(). Only the
+*                   sequence number increment and the timestamp are taken in a critical section, which
+*                   reserves a slot in the ring. The slot is then filled without holding any lock. When
+*                   the ring wraps, the oldest records are overwritten.
+*
+*               (2) See 'usbh_core.h  TRANSFER TRACE RECORD  Note #1'.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+static  void  USBH_TraceRec (CPU_INT08U   evt,
+                             USBH_URB    *p_urb,
+                             CPU_INT32U   len)
+{
+    USBH_TRACE_REC  *p_rec;
+    USBH_EP         *p_ep;
+    CPU_INT32U       seq;
+    CPU_TS32         ts;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* Reserve slot in ring (see Note #1).                  */
+    USBH_TraceSeqLast++;
+    if (USBH_TraceSeqLast == 0u) {                              /* Seq nbr 0 marks an invalid rec.                      */
+        USBH_TraceSeqLast = 1u;
+    }
+    seq = USBH_TraceSeqLast;
+    ts  = CPU_TS_Get32();
+    CPU_CRITICAL_EXIT();
+
+    if (evt == USBH_TRACE_EVT_SUBMIT) {
+        p_urb->TraceId = seq;
+    }
+
+    p_ep  =  p_urb->EP_Ptr;
+    p_rec = &USBH_TraceTbl[seq & (USBH_CFG_TRACE_REC_NBR - 1u)];
+
+    p_rec->Seq       = 0u;                                      /* See Note #2.                                         */
+    p_rec->TS        = (CPU_INT32U)ts;
+    p_rec->URB_Id    = p_urb->TraceId;
+    p_rec->Len       = len;
+    p_rec->Err       = (CPU_INT16U)p_urb->Err;
+    p_rec->Evt       = evt;
+    p_rec->DevAddr   = p_ep->DevAddr;
+    p_rec->EP_Addr   = p_ep->Desc.bEndpointAddress;
+    p_rec->Token     = p_urb->Token;
+    p_rec->AsyncPrio = p_ep->AsyncPrio;
+    p_rec->Rsvd      = 0u;
+    p_rec->Seq       = seq;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          USBH_StatSubmit()
+*
+* Description : Account an URB submission in the transfer statistics.
+*
+* Argument(s) : p_urb       Pointer to URB.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  void  USBH_StatSubmit (USBH_URB  *p_urb)
+{
+    USBH_EP  *p_ep;
+    CPU_SR_ALLOC();
+
+
+    p_ep          = p_urb->EP_Ptr;
+    p_urb->StatTS = (CPU_INT32U)CPU_TS_Get32();
+
+    CPU_CRITICAL_ENTER();
+    p_ep->Stat.URB_SubmitCnt++;
+    p_ep->DevPtr->Stat.URB_SubmitCnt++;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_StatCmpl()
+*
+* Description : Account an URB completion in the transfer statistics.
+*
+* Argument(s) : p_urb       Pointer to URB.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  void  USBH_StatCmpl (USBH_URB  *p_urb)
+{
+    USBH_EP     *p_ep;
+    CPU_INT32U   lat;
+    CPU_SR_ALLOC();
+
+
+    p_ep = p_urb->EP_Ptr;
+    lat  = (CPU_INT32U)CPU_TS_Get32() - p_urb->StatTS;
+
+    CPU_CRITICAL_ENTER();
+    USBH_StatXferAdd(&p_ep->Stat,         p_urb->XferLen, p_urb->Err, lat);
+    USBH_StatXferAdd(&p_ep->DevPtr->Stat, p_urb->XferLen, p_urb->Err, lat);
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_StatErr()
+*
+* Description : Account an error that did not complete an URB in the transfer statistics.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               err_ix      Error index (see 'usbh_core.h  TRANSFER STATISTICS ERROR INDEXES').
+*
+*               err         Error code.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  void  USBH_StatErr (USBH_EP     *p_ep,
+                            CPU_INT08U   err_ix,
+                            USBH_ERR     err)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_ep->Stat.ErrCnt++;
+    p_ep->Stat.ErrCntTbl[err_ix]++;
+    p_ep->Stat.ErrLast = err;
+    p_ep->DevPtr->Stat.ErrCnt++;
+    p_ep->DevPtr->Stat.ErrCntTbl[err_ix]++;
+    p_ep->DevPtr->Stat.ErrLast = err;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_StatStallClr()
+*
+* Description : Account a cleared STALL condition in the transfer statistics.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  void  USBH_StatStallClr (USBH_EP  *p_ep)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_ep->Stat.StallClrCnt++;
+    p_ep->DevPtr->Stat.StallClrCnt++;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_StatErrIxGet()
+*
+* Description : Get the statistics error index of an error code.
+*
+* Argument(s) : err         Error code.
+*
+* Return(s)   : Error index (see 'usbh_core.h  TRANSFER STATISTICS ERROR INDEXES').
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  CPU_INT08U  USBH_StatErrIxGet (USBH_ERR  err)
+{
+    CPU_INT08U  err_ix;
+
+
+    switch (err) {
+        case USBH_ERR_EP_STALL:
+             err_ix = USBH_STAT_ERR_IX_STALL;
+             break;
+
+        case USBH_ERR_EP_DATA_TOGGLE:
+             err_ix = USBH_STAT_ERR_IX_DATA_TOGGLE;
+             break;
+
+        case USBH_ERR_HC_IO:
+             err_ix = USBH_STAT_ERR_IX_HC_IO;
+             break;
+
+        case USBH_ERR_DEV_NOT_RESPONDING:
+             err_ix = USBH_STAT_ERR_IX_NOT_RESPONDING;
+             break;
+
+        case USBH_ERR_OS_TIMEOUT:
+             err_ix = USBH_STAT_ERR_IX_TIMEOUT;
+             break;
+
+        case USBH_ERR_URB_ABORT:
+             err_ix = USBH_STAT_ERR_IX_ABORT;
+             break;
+
+        default:
+             err_ix = USBH_STAT_ERR_IX_OTHER;
+             break;
+    }
+
+    return (err_ix);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_StatXferAdd()
+*
+* Description : Add a completed URB to a transfer statistics structure.
+*
+* Argument(s) : p_stat      Pointer to transfer statistics.
+*
+*               xfer_len    Number of octets transferred.
+*
+*               err         URB error code.
+*
+*               lat         URB completion latency.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) This function must be called from a critical section.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  void  USBH_StatXferAdd (USBH_XFER_STAT  *p_stat,
+                                CPU_INT32U       xfer_len,
+                                USBH_ERR         err,
+                                CPU_INT32U       lat)
+{
+    p_stat->URB_CmplCnt++;
+    p_stat->XferBytes += xfer_len;
+
+    if (err != USBH_ERR_NONE) {
+        p_stat->ErrCnt++;
+        p_stat->ErrCntTbl[USBH_StatErrIxGet(err)]++;
+        p_stat->ErrLast = err;
+    }
+
+    if ((p_stat->URB_CmplCnt == 1u) ||
+        (lat                 <  p_stat->LatMin)) {
+        p_stat->LatMin = lat;
+    }
+    if (lat > p_stat->LatMax) {
+        p_stat->LatMax = lat;
+    }
+    p_stat->LatTotal += lat;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_StatCopy()
+*
+* Description : Take a snapshot of a transfer statistics structure.
+*
+* Argument(s) : p_dst       Pointer to structure that will receive the statistics.
+*
+*               p_src       Pointer to transfer statistics.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+static  void  USBH_StatCopy (USBH_XFER_STAT  *p_dst,
+                             USBH_XFER_STAT  *p_src)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+   *p_dst = *p_src;
+    CPU_CRITICAL_EXIT();
+
+    if (p_dst->URB_CmplCnt != 0u) {
+        p_dst->LatAvg = (CPU_INT32U)(p_dst->LatTotal / p_dst->URB_CmplCnt);
+    } else {
+        p_dst->LatAvg = 0u;
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_URB_Get()
+*
+* Description : Get a URB from the submission queue of an endpoint.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               p_err       Variable that will receive the return error code from this function.
+*                           USBH_ERR_NONE                   URB successfully allocated.
+*                           USBH_ERR_EP_QUEUE_FULL          Endpoint submission queue is full.
+*                           USBH_ERR_ALLOC                  No extra URB available.
+*
+* Return(s)   : Pointer to URB,     if successful.
+*               Pointer to NULL,    otherwise.
+*
+* Note(s)     : (1) The URB embedded in the endpoint is used when no transfer is in progress. Otherwise, an
+*                   extra URB is taken from the async URB pool and inserted at the end of the endpoint's
+*                   URB list, so that the list reflects the submission order.
+*
+*               (2) The transfer is accounted in 'XferNbrInProgress' until the URB is completed.
+*********************************************************************************************************
+*/
+
+static  USBH_URB  *USBH_URB_Get (USBH_EP   *p_ep,
+                                 USBH_ERR  *p_err)
+{
+    USBH_URB  *p_urb;
+    USBH_URB  *p_async_urb;
+    LIB_ERR    err_lib;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    if (p_ep->XferNbrInProgress >= USBH_CFG_MAX_QUEUED_URB_PER_EP) {
+        CPU_CRITICAL_EXIT();
+       *p_err = USBH_ERR_EP_QUEUE_FULL;
+        return ((USBH_URB *)0);
+    }
+
+    if ((p_ep->URB.State         != USBH_URB_STATE_SCHEDULED) &&
+        (p_ep->XferNbrInProgress == 0u)) {                      /* Use URB struct associated to EP (see Note #1).       */
+        p_ep->XferNbrInProgress++;
+        CPU_CRITICAL_EXIT();
+
+       *p_err = USBH_ERR_NONE;
+        return (&p_ep->URB);
+    }
+
+    p_ep->XferNbrInProgress++;                                  /* Rsv slot in EP submission Q (see Note #2).           */
+    CPU_CRITICAL_EXIT();
+                                                                /* Get a new URB struct from the URB async pool.        */
+    p_urb = (USBH_URB *)Mem_PoolBlkGet(&p_ep->DevPtr->HC_Ptr->HostPtr->AsyncURB_Pool,
+                                        sizeof(USBH_URB),
+                                       &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+        CPU_CRITICAL_ENTER();
+        p_ep->XferNbrInProgress--;
+        CPU_CRITICAL_EXIT();
+
+       *p_err = USBH_ERR_ALLOC;
+        return ((USBH_URB *)0);
+    }
+
+    USBH_URB_Clr(p_urb);
+
+    CPU_CRITICAL_ENTER();
+    p_async_urb = &p_ep->URB;                                   /* Get head of extra async URB Q.                       */
+    while (p_async_urb->AsyncURB_NxtPtr != 0) {                 /* Srch tail of extra async URB Q.                      */
+        p_async_urb = p_async_urb->AsyncURB_NxtPtr;
+    }
+    p_async_urb->AsyncURB_NxtPtr = p_urb;                       /* Insert new URB at end of extra async URB Q.          */
+    CPU_CRITICAL_EXIT();
+
+   *p_err = USBH_ERR_NONE;
+
+    return (p_urb);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_URB_Release()
+*
+* Description : Remove an extra URB from the URB list of an endpoint and free it.
+*
+* Argument(s) : p_ep        Pointer to endpoint.
+*
+*               p_urb       Pointer to extra URB.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_URB_Release (USBH_EP   *p_ep,
+                                USBH_URB  *p_urb)
+{
+    USBH_URB  *p_prev_async_urb;
+    LIB_ERR    err_lib;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_prev_async_urb = &p_ep->URB;
+    while (p_prev_async_urb->AsyncURB_NxtPtr != 0) {            /* Srch extra URB to remove.                            */
+        if (p_prev_async_urb->AsyncURB_NxtPtr == p_urb) {       /* Extra URB found, remove from Q.                      */
+            p_prev_async_urb->AsyncURB_NxtPtr = p_urb->AsyncURB_NxtPtr;
+            break;
+        }
+        p_prev_async_urb = p_prev_async_urb->AsyncURB_NxtPtr;
+    }
+    CPU_CRITICAL_EXIT();
+                                                                /* Free extra URB.                                      */
+    Mem_PoolBlkFree(       &p_ep->DevPtr->HC_Ptr->HostPtr->AsyncURB_Pool,
+                    (void *)p_urb,
+                           &err_lib);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_URB_AsyncUnlink()
+*
+* Description : Remove an URB from the async completion queue it is linked in, if any.
+*
+* Argument(s) : p_urb       Pointer to URB.
+*
+* Return(s)   : DEF_YES, if URB was found and removed from an async completion queue.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : (1) This function MUST be called within a critical section.
+*
+*               (2) All queues are searched since the endpoint's 'AsyncPrio' may have been changed after the
+*                   URB was queued.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_URB_AsyncUnlink (USBH_URB  *p_urb)
+{
+    USBH_ASYNC_QUEUE  *p_queue;
+    USBH_URB          *p_prev_urb;
+    USBH_URB          *p_cur_urb;
+    CPU_INT08U         ix;
+
+
+    for (ix = 0u; ix < USBH_CFG_ASYNC_TASK_NBR; ix++) {         /* See Note #2.                                         */
+        p_queue    = &USBH_AsyncQueueTbl[ix];
+        p_prev_urb = (USBH_URB *)0;
+        p_cur_urb  = (USBH_URB *)p_queue->HeadPtr;
+
+        while (p_cur_urb != (USBH_URB *)0) {
+            if (p_cur_urb == p_urb) {                           /* URB found, remove from Q.                            */
+                if (p_prev_urb == (USBH_URB *)0) {
+                    p_queue->HeadPtr   = p_urb->NxtPtr;
+                } else {
+                    p_prev_urb->NxtPtr = p_urb->NxtPtr;
+                }
+
+                if (p_queue->TailPtr == p_urb) {
+                    p_queue->TailPtr = p_prev_urb;
+                }
+
+                p_urb->NxtPtr = (USBH_URB *)0;
+                return (DEF_YES);
+            }
+
+            p_prev_urb = p_cur_urb;
+            p_cur_urb  = p_cur_urb->NxtPtr;
+        }
+    }
+
+    return (DEF_NO);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           USBH_URB_Clr()
+*
+* Description : Clear URB structure
+*
+* Argument(s) : p_urb       Pointer to URB structure to clear.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_URB_Clr (USBH_URB  *p_urb)
+{
+    p_urb->Err             =  USBH_ERR_NONE;
+    p_urb->State           =  USBH_URB_STATE_NONE;
+    p_urb->AsyncURB_NxtPtr = (USBH_URB *)0;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_URB_SG_Prepare()
 *
-* Description : Submit given URB to host controller.
+* Description : Prepare scatter-gather segment table of given URB.
 *
 * Argument(s) : p_urb       Pointer to URB.
 *
-* Return(s)   : USBH_ERR_NONE,                          If URB is successfully submitted to host controller.
-*               USBH_ERR_EP_INVALID_STATE,              If endpoint is in halt state.
-*               Host controller drivers error code,     Otherwise.
+*               p_sg_tbl    Pointer to scatter-gather segment table.
 *
-* Note(s)     : None.
+*               sg_nbr      Number of segments in table. 0 if the URB uses a contiguous buffer.
+*
+* Return(s)   : USBH_ERR_NONE,              If URB is ready to be submitted.
+*               USBH_ERR_INVALID_ARG,       If a segment is invalid.
+*               USBH_ERR_ALLOC,             If bounce buffer cannot be allocated.
+*               USBH_ERR_NOT_SUPPORTED,     If segment table cannot be mapped nor bounced.
+*
+* Note(s)     : (1) A host controller driver can only map the segment table directly if every segment,
+*                   except the last one, is a multiple of the endpoint's maximum packet size. Otherwise,
+*                   the end of a segment would be seen as a short packet by the device.
+*
+*               (2) When the segments cannot be mapped by the host controller driver, they are copied to
+*                   a bounce buffer, which is then submitted as a regular contiguous buffer.
 *********************************************************************************************************
 */
 
-static  USBH_ERR  USBH_URB_Submit (USBH_URB  *p_urb)
+static  USBH_ERR  USBH_URB_SG_Prepare (USBH_URB     *p_urb,
+                                       USBH_SG_SEG  *p_sg_tbl,
+                                       CPU_INT08U    sg_nbr)
 {
-    USBH_ERR      err;
-    CPU_BOOLEAN   ep_is_halt;
-    USBH_DEV     *p_dev;
+    USBH_EP      *p_ep;
+    USBH_HC      *p_hc;
+    CPU_INT32U    len;
+    CPU_INT16U    max_pkt_size;
+    CPU_INT08U    seg_ix;
+    CPU_BOOLEAN   map_en;
+#if (USBH_CFG_SG_BOUNCE_BUF_NBR > 0u)
+    void         *p_bounce;
+    LIB_ERR       err_lib;
+#endif
 
 
-    p_dev = p_urb->EP_Ptr->DevPtr;
-    USBH_HCD_EP_IsHalt(p_dev->HC_Ptr,                           /* Check EP's state.                                    */
-                       p_urb->EP_Ptr,
-                      &ep_is_halt,
-                      &err);
-    if ((ep_is_halt == DEF_TRUE) &&
-        (err        == USBH_ERR_NONE)) {
-        return (USBH_ERR_EP_INVALID_STATE);
+    p_urb->SG_SegTblPtr = p_sg_tbl;
+    p_urb->SG_SegNbr    = sg_nbr;
+    p_urb->SG_BouncePtr = (void *)0;
+
+    if (sg_nbr == 0u) {
+        return (USBH_ERR_NONE);
+    }
+
+    if (p_sg_tbl == (USBH_SG_SEG *)0) {
+        p_urb->SG_SegNbr = 0u;
+        return (USBH_ERR_INVALID_ARG);
     }
 
-    p_urb->State = USBH_URB_STATE_SCHEDULED;                    /* Set URB state to scheduled.                          */
-    p_urb->Err   = USBH_ERR_NONE;
+    p_ep         =  p_urb->EP_Ptr;
+    p_hc         =  p_ep->DevPtr->HC_Ptr;
+    max_pkt_size =  USBH_EP_MaxPktSizeGet(p_ep);
+    map_en       =  p_hc->HC_Drv.SG_En;
+    len          =  0u;
 
-    USBH_HCD_URB_Submit(p_dev->HC_Ptr,
-                        p_urb,
-                       &err);
+    for (seg_ix = 0u; seg_ix < sg_nbr; seg_ix++) {
+        if ((p_sg_tbl[seg_ix].BufPtr == (void *)0) &&
+            (p_sg_tbl[seg_ix].BufLen != 0u)) {
+            p_urb->SG_SegNbr = 0u;
+            return (USBH_ERR_INVALID_ARG);
+        }
+                                                                /* See Note #1.                                         */
+        if (((seg_ix + 1u)                                  < sg_nbr) &&
+            ((p_sg_tbl[seg_ix].BufLen % max_pkt_size) != 0u)) {
+            map_en = DEF_FALSE;
+        }
+        len += p_sg_tbl[seg_ix].BufLen;
+    }
 
-    return (err);
+    p_urb->UserBufLen = len;
+
+    if (map_en == DEF_TRUE) {                                   /* HCD builds xfer from seg tbl.                        */
+        p_urb->UserBufPtr = (void *)0;
+        return (USBH_ERR_NONE);
+    }
+
+#if (USBH_CFG_SG_BOUNCE_BUF_NBR > 0u)                           /* See Note #2.                                         */
+    if (len > USBH_CFG_SG_BOUNCE_BUF_LEN) {
+        p_urb->SG_SegNbr = 0u;
+        return (USBH_ERR_NOT_SUPPORTED);
+    }
+
+    p_bounce = Mem_PoolBlkGet(&p_hc->HostPtr->SG_BouncePool,
+                               USBH_CFG_SG_BOUNCE_BUF_LEN,
+                              &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+        p_urb->SG_SegNbr = 0u;
+        return (USBH_ERR_ALLOC);
+    }
+
+    p_urb->SG_BouncePtr = p_bounce;
+    p_urb->UserBufPtr   = p_bounce;
+
+    if (p_urb->Token != USBH_TOKEN_IN) {
+        (void)USBH_URB_SG_Gather(p_urb, p_bounce, len);
+    }
+
+    return (USBH_ERR_NONE);
+#else
+    p_urb->SG_SegNbr = 0u;
+    return (USBH_ERR_NOT_SUPPORTED);
+#endif
 }
 
 
 /*
 *********************************************************************************************************
-*                                           USBH_URB_Clr()
+*                                        USBH_URB_SG_Release()
 *
-* Description : Clear URB structure
+* Description : Release scatter-gather resources of given URB.
 *
-* Argument(s) : p_urb       Pointer to URB structure to clear.
+* Argument(s) : p_urb       Pointer to URB.
 *
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Data received in the bounce buffer is copied back to the segments before the buffer
+*                   is freed.
+*
+*               (2) The completion function of a scatter-gather transfer receives the segment table as
+*                   its buffer argument.
 *********************************************************************************************************
 */
 
-static  void  USBH_URB_Clr (USBH_URB  *p_urb)
+static  void  USBH_URB_SG_Release (USBH_URB  *p_urb)
 {
-    p_urb->Err             =  USBH_ERR_NONE;
-    p_urb->State           =  USBH_URB_STATE_NONE;
-    p_urb->AsyncURB_NxtPtr = (USBH_URB *)0;
+#if (USBH_CFG_SG_BOUNCE_BUF_NBR > 0u)
+    LIB_ERR  err_lib;
+#endif
+
+
+    if (p_urb->SG_SegNbr == 0u) {
+        return;
+    }
+
+#if (USBH_CFG_SG_BOUNCE_BUF_NBR > 0u)
+    if (p_urb->SG_BouncePtr != (void *)0) {
+        if ((p_urb->Token   == USBH_TOKEN_IN) &&                /* See Note #1.                                         */
+            (p_urb->XferLen != 0u)) {
+            (void)USBH_URB_SG_Scatter(p_urb, p_urb->SG_BouncePtr, p_urb->XferLen);
+        }
+
+        Mem_PoolBlkFree(&p_urb->EP_Ptr->DevPtr->HC_Ptr->HostPtr->SG_BouncePool,
+                         p_urb->SG_BouncePtr,
+                        &err_lib);
+        p_urb->SG_BouncePtr = (void *)0;
+    }
+#endif
+
+    p_urb->UserBufPtr = (void *)p_urb->SG_SegTblPtr;            /* See Note #2.                                         */
 }
 
 
@@ -4324,9 +6725,14 @@ static  USBH_ERR  USBH_DfltEP_Open (USBH_DEV  *p_dev)
         return (USBH_ERR_NONE);
     }
 
-    p_ep->DevAddr = 0u;
-    p_ep->DevSpd  = p_dev->DevSpd;
-    p_ep->DevPtr  = p_dev;
+    p_ep->DevAddr   = 0u;
+    p_ep->DevSpd    = p_dev->DevSpd;
+    p_ep->DevPtr    = p_dev;
+    p_ep->AsyncPrio = USBH_AsyncPrioGet(p_dev, USBH_EP_TYPE_CTRL);
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+    Mem_Clr((void *)&p_ep->Stat,
+                     sizeof(USBH_XFER_STAT));
+#endif
 
     if (p_dev->DevSpd == USBH_DEV_SPD_LOW) {                    /* See Note (1).                                        */
         ep_max_pkt_size = 8u;
@@ -4734,6 +7140,339 @@ static  USBH_ERR  USBH_CfgParse (USBH_DEV  *p_dev,
 }
 
 
+/*
+*********************************************************************************************************
+*                                         USBH_DescCacheRd()
+*
+* Description : Look up the enumeration descriptor cache for the given device & copy its configuration
+*               descriptors from the cache on a hit.
+*
+* Argument(s) : p_dev       Pointer to USB device. Its device descriptor must have been read.
+*
+* Return(s)   : Pointer to cache entry,     if the configurations of the device were loaded from the cache.
+*               0,                          otherwise.
+*
+* Note(s)     : (1) Root hub devices are not cached.
+*
+*               (2) The serial number string descriptor is read once, with the language ID of the first
+*                   entry matching the idVendor, idProduct & bcdDevice of the device.
+*
+*               (3) An entry whose key matches but whose device descriptor differs is stale and dropped.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+static  USBH_DESC_CACHE_ENTRY  *USBH_DescCacheRd (USBH_DEV  *p_dev)
+{
+    CPU_INT08U              ix;
+    CPU_INT08U              cfg_ix;
+    CPU_INT08U              if_ix;
+    CPU_INT08U              serial_len;
+    CPU_INT16U              lang_id;
+    CPU_BOOLEAN             serial_rd;
+    CPU_BOOLEAN             match;
+    CPU_INT08U              serial[USBH_DESC_CACHE_SERIAL_LEN];
+    USBH_CFG               *p_cfg;
+    USBH_IF                *p_if;
+    USBH_DESC_CACHE_CFG    *p_cache_cfg;
+    USBH_DESC_CACHE_ENTRY  *p_entry;
+    USBH_DESC_CACHE_ENTRY  *p_hit;
+    CPU_SR_ALLOC();
+
+
+    if (p_dev->IsRootHub == DEF_TRUE) {                         /* See Note #1.                                         */
+        return ((USBH_DESC_CACHE_ENTRY *)0);
+    }
+
+    p_hit      = (USBH_DESC_CACHE_ENTRY *)0;
+    serial_rd  =  DEF_NO;
+    serial_len =  0u;
+    lang_id    =  0u;
+
+    (void)USBH_OS_MutexLock(USBH_DescCacheMutex);
+
+    for (ix = 0u; ix < USBH_CFG_DESC_CACHE_NBR; ix++) {
+        p_entry = &USBH_DescCacheTbl[ix];
+        if (p_entry->Valid == DEF_NO) {
+            continue;
+        }
+                                                                /* Cmp idVendor, idProduct & bcdDevice.                 */
+        match = Mem_Cmp((void *)&p_entry->DevDesc[8u],
+                        (void *)&p_dev->DevDesc[8u],
+                                 6u);
+        if (match == DEF_NO) {
+            continue;
+        }
+
+        if (p_dev->DevDesc[16u] != 0u) {                        /* Cmp serial nbr, if any (see Note #2).                */
+            if (serial_rd == DEF_NO) {
+                lang_id    = p_entry->LangID;
+                serial_len = USBH_DescCacheSerialRd(p_dev, lang_id, serial);
+                serial_rd  = DEF_YES;
+            }
+
+            if ((serial_len         == 0u)      ||
+                (p_entry->LangID    != lang_id) ||
+                (p_entry->SerialLen != serial_len)) {
+                continue;
+            }
+
+            match = Mem_Cmp((void *)p_entry->Serial,
+                            (void *)serial,
+                                    serial_len);
+            if (match == DEF_NO) {
+                continue;
+            }
+        } else if (p_entry->SerialLen != 0u) {
+            continue;
+        } else {
+                                                                /* Empty Else Statement                                 */
+        }
+
+        match = Mem_Cmp((void *)p_entry->DevDesc,               /* Validate rest of dev desc (see Note #3).             */
+                        (void *)p_dev->DevDesc,
+                                USBH_LEN_DESC_DEV);
+        if (match == DEF_NO) {
+            USBH_DescCacheInvalidate(p_entry);
+        } else {
+            p_hit = p_entry;
+        }
+        break;
+    }
+
+    if (p_hit != (USBH_DESC_CACHE_ENTRY *)0) {                  /* ------------ LOAD CFG DESC FROM CACHE ------------- */
+        for (cfg_ix = 0u; cfg_ix < p_dev->DevDesc[17u]; cfg_ix++) {
+            p_cfg       =  USBH_CfgGet(p_dev, cfg_ix);
+            p_cache_cfg = &p_hit->CfgList[cfg_ix];
+
+            Mem_Copy((void *)p_cfg->CfgData,
+                     (void *)p_cache_cfg->CfgData,
+                             p_cache_cfg->CfgDataLen);
+            p_cfg->CfgDataLen = p_cache_cfg->CfgDataLen;
+
+            for (if_ix = 0u; if_ix < p_cache_cfg->IF_Nbr; if_ix++) {
+                p_if             = &p_cfg->IF_List[if_ix];
+                p_if->DevPtr     =  p_dev;
+                p_if->IF_DataPtr = &p_cfg->CfgData[p_cache_cfg->IF_Off[if_ix]];
+                p_if->IF_DataLen =  p_cache_cfg->IF_Len[if_ix];
+            }
+        }
+
+        USBH_DescCacheSeq++;
+        p_hit->UseSeq = USBH_DescCacheSeq;
+        p_dev->LangID = lang_id;                                /* Lang ID already known, skip its rd in USBH_StrGet(). */
+    }
+
+    (void)USBH_OS_MutexUnlock(USBH_DescCacheMutex);
+
+    CPU_CRITICAL_ENTER();
+    if (p_hit != (USBH_DESC_CACHE_ENTRY *)0) {
+        USBH_DescCacheStat.HitCnt++;
+    } else {
+        USBH_DescCacheStat.MissCnt++;
+    }
+    CPU_CRITICAL_EXIT();
+
+    return (p_hit);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_DescCacheWr()
+*
+* Description : Store the configuration descriptors of the given device in the enumeration descriptor cache.
+*
+* Argument(s) : p_dev       Pointer to USB device. Its configuration descriptors must have been read & parsed.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) A device whose serial number string descriptor cannot be read or is longer than
+*                   USBH_DESC_CACHE_SERIAL_LEN octets is not cached.
+*
+*               (2) The least recently used entry is replaced when the cache is full.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+static  void  USBH_DescCacheWr (USBH_DEV  *p_dev)
+{
+    CPU_INT08U              ix;
+    CPU_INT08U              cfg_ix;
+    CPU_INT08U              if_ix;
+    CPU_INT08U              serial_len;
+    CPU_INT32U              len;
+    CPU_INT08U              serial[USBH_DESC_CACHE_SERIAL_LEN];
+    USBH_CFG               *p_cfg;
+    USBH_DESC_CACHE_CFG    *p_cache_cfg;
+    USBH_DESC_CACHE_ENTRY  *p_entry;
+    USBH_ERR                err;
+
+
+    if (p_dev->IsRootHub == DEF_TRUE) {
+        return;
+    }
+
+    serial_len = 0u;
+    if (p_dev->DevDesc[16u] != 0u) {                            /* ---------------- RD SERIAL NBR STR ----------------- */
+        if (p_dev->LangID == 0u) {                              /* Get dflt lang ID used by the dev.                    */
+            len = USBH_StrDescGet(p_dev,
+                                  USBH_STRING_DESC_LANGID,
+                                  0u,
+                                  serial,
+                                  USBH_DESC_CACHE_SERIAL_LEN,
+                                 &err);
+            if ((err != USBH_ERR_NONE) ||
+                (len <  4u)) {
+                return;
+            }
+
+            p_dev->LangID = MEM_VAL_GET_INT16U_LITTLE(&serial[2u]);
+            if (p_dev->LangID == 0u) {
+                return;
+            }
+        }
+
+        serial_len = USBH_DescCacheSerialRd(p_dev, p_dev->LangID, serial);
+        if (serial_len == 0u) {                                 /* See Note #1.                                         */
+            return;
+        }
+    }
+
+    (void)USBH_OS_MutexLock(USBH_DescCacheMutex);
+
+    p_entry = &USBH_DescCacheTbl[0u];                           /* Find free or LRU entry (see Note #2).                */
+    for (ix = 0u; ix < USBH_CFG_DESC_CACHE_NBR; ix++) {
+        if (USBH_DescCacheTbl[ix].Valid == DEF_NO) {
+            p_entry = &USBH_DescCacheTbl[ix];
+            break;
+        }
+        if (USBH_DescCacheTbl[ix].UseSeq < p_entry->UseSeq) {
+            p_entry = &USBH_DescCacheTbl[ix];
+        }
+    }
+
+    Mem_Copy((void *)p_entry->DevDesc,
+             (void *)p_dev->DevDesc,
+                     USBH_LEN_DESC_DEV);
+    Mem_Copy((void *)p_entry->Serial,
+             (void *)serial,
+                     serial_len);
+    p_entry->SerialLen = serial_len;
+    p_entry->LangID    = p_dev->LangID;
+
+    for (cfg_ix = 0u; cfg_ix < p_dev->DevDesc[17u]; cfg_ix++) {
+        p_cfg       =  USBH_CfgGet(p_dev, cfg_ix);
+        p_cache_cfg = &p_entry->CfgList[cfg_ix];
+
+        Mem_Copy((void *)p_cache_cfg->CfgData,
+                 (void *)p_cfg->CfgData,
+                         p_cfg->CfgDataLen);
+        p_cache_cfg->CfgDataLen = p_cfg->CfgDataLen;
+        p_cache_cfg->IF_Nbr     = USBH_CfgIF_NbrGet(p_cfg);
+
+        for (if_ix = 0u; if_ix < p_cache_cfg->IF_Nbr; if_ix++) {
+            p_cache_cfg->IF_Off[if_ix] = (CPU_INT16U)(p_cfg->IF_List[if_ix].IF_DataPtr - p_cfg->CfgData);
+            p_cache_cfg->IF_Len[if_ix] =  p_cfg->IF_List[if_ix].IF_DataLen;
+        }
+    }
+
+    USBH_DescCacheSeq++;
+    p_entry->UseSeq = USBH_DescCacheSeq;
+    p_entry->Valid  = DEF_YES;
+
+    (void)USBH_OS_MutexUnlock(USBH_DescCacheMutex);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                     USBH_DescCacheInvalidate()
+*
+* Description : Drop an entry of the enumeration descriptor cache.
+*
+* Argument(s) : p_entry     Pointer to cache entry.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+static  void  USBH_DescCacheInvalidate (USBH_DESC_CACHE_ENTRY  *p_entry)
+{
+    CPU_SR_ALLOC();
+
+
+    p_entry->Valid = DEF_NO;
+
+    CPU_CRITICAL_ENTER();
+    USBH_DescCacheStat.InvalidCnt++;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_DescCacheSerialRd()
+*
+* Description : Read the serial number string descriptor of a device in a single request.
+*
+* Argument(s) : p_dev       Pointer to USB device.
+*
+*               lang_id     Language ID.
+*
+*               p_buf       Pointer to buffer of USBH_DESC_CACHE_SERIAL_LEN octets that will receive the
+*                           string descriptor.
+*
+* Return(s)   : Length of string descriptor, if it was read entirely.
+*               0,                           otherwise.
+*
+* Note(s)     : (1) Unlike USBH_StrDescGet(), the descriptor header is not read first. A descriptor longer
+*                   than the buffer is reported as unreadable.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+static  CPU_INT08U  USBH_DescCacheSerialRd (USBH_DEV    *p_dev,
+                                            CPU_INT16U   lang_id,
+                                            CPU_INT08U  *p_buf)
+{
+    CPU_INT16U  len;
+    USBH_ERR    err;
+
+
+    len = USBH_CtrlRx(p_dev,                                    /* See Note #1.                                         */
+                      USBH_REQ_GET_DESC,
+                      USBH_REQ_DIR_DEV_TO_HOST  | USBH_REQ_RECIPIENT_DEV,
+                     (USBH_DESC_TYPE_STR << 8u) | p_dev->DevDesc[16u],
+                      lang_id,
+                      p_buf,
+                      USBH_DESC_CACHE_SERIAL_LEN,
+                      USBH_CFG_STD_REQ_TIMEOUT,
+                     &err);
+    if ((len == 0u) ||
+        (err == USBH_ERR_EP_STALL)) {
+        USBH_EP_Reset(p_dev, (USBH_EP *)0);                     /* Rst EP to clr HC halt state.                         */
+    }
+
+    if ((err      != USBH_ERR_NONE)      ||
+        (len      <  USBH_LEN_DESC_HDR)  ||
+        (p_buf[1] != USBH_DESC_TYPE_STR) ||
+        (p_buf[0] <  USBH_LEN_DESC_HDR)  ||
+        (p_buf[0] >  len)) {
+        return (0u);
+    }
+
+    return (p_buf[0]);
+}
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                          USBH_DevAddrSet()
@@ -5208,44 +7947,144 @@ static  void  USBH_ParseEP_Desc (USBH_EP_DESC  *p_ep_desc,
 }
 
 
+/*
+*********************************************************************************************************
+*                                         USBH_AsyncPrioGet()
+*
+* Description : Select the default asynchronous completion task of an endpoint.
+*
+* Argument(s) : p_dev       Pointer to USB device.
+*
+*               ep_type     Endpoint type.
+*
+* Return(s)   : Index of asynchronous completion task.
+*
+* Note(s)     : (1) See 'usbh_core.h  ASYNC COMPLETION WORKER ROUTING MODES'.
+*********************************************************************************************************
+*/
+
+static  CPU_INT08U  USBH_AsyncPrioGet (USBH_DEV    *p_dev,
+                                       CPU_INT08U   ep_type)
+{
+    CPU_INT08U  prio;
+
+
+#if (USBH_CFG_ASYNC_TASK_ROUTE == USBH_ASYNC_ROUTE_HC)
+    (void)ep_type;
+
+    prio = p_dev->HC_Ptr->HC_Drv.Nbr % USBH_CFG_ASYNC_TASK_NBR;
+#else
+    (void)p_dev;
+
+    switch (ep_type) {
+        case USBH_EP_TYPE_INTR:
+        case USBH_EP_TYPE_ISOC:
+             prio = 0u;
+             break;
+
+        case USBH_EP_TYPE_CTRL:
+             prio = 1u;
+             break;
+
+        case USBH_EP_TYPE_BULK:
+        default:
+             prio = USBH_CFG_ASYNC_TASK_NBR - 1u;
+             break;
+    }
+
+    if (prio >= USBH_CFG_ASYNC_TASK_NBR) {
+        prio = USBH_CFG_ASYNC_TASK_NBR - 1u;
+    }
+#endif
+
+    return (prio);
+}
+
+
 /*
 *********************************************************************************************************
 *                                          USBH_AsyncTask()
 *
 * Description : Task that process asynchronous URBs
 *
-* Argument(s) : p_arg       Pointer to a variable (Here it is 0)
+* Argument(s) : p_arg       Pointer to the async completion queue served by this task.
 *
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) When async completion batching is enabled, every URB queued by USBH_URB_Done() since the
+*                   last wakeup is detached in a single critical section and completed in order. This
+*                   amortizes the semaphore wait and the critical section over the whole batch.
+*
+*               (2) The completion callback may re-submit the same URB, which overwrites its 'NxtPtr'.
 *********************************************************************************************************
 */
 
 static  void  USBH_AsyncTask (void  *p_arg)
 {
-    USBH_URB  *p_urb;
+    USBH_ASYNC_QUEUE  *p_queue;
+    USBH_URB          *p_urb;
+#if (USBH_CFG_ASYNC_BATCH_EN == DEF_ENABLED)
+    USBH_URB          *p_urb_nxt;
+    CPU_INT32U         batch_len;
+    CPU_INT08U         hist_ix;
+#endif
     CPU_SR_ALLOC();
 
 
-    (void)p_arg;
+    p_queue = (USBH_ASYNC_QUEUE *)p_arg;
 
     while (DEF_TRUE) {
-        (void)USBH_OS_SemWait(USBH_URB_Sem, 0u);                /* Wait for URBs processed by HC.                       */
+        (void)USBH_OS_SemWait(p_queue->Sem, 0u);                /* Wait for URBs processed by HC.                       */
+
+#if (USBH_CFG_ASYNC_BATCH_EN == DEF_ENABLED)
+        CPU_CRITICAL_ENTER();                                   /* Detach whole completion list (see Note #1).          */
+        p_urb            = (USBH_URB *)p_queue->HeadPtr;
+        p_queue->HeadPtr = (USBH_URB *)0;
+        p_queue->TailPtr = (USBH_URB *)0;
+        CPU_CRITICAL_EXIT();
+
+        batch_len = 0u;
+        while (p_urb != (USBH_URB *)0) {
+            p_urb_nxt = p_urb->NxtPtr;                          /* Save nxt ptr, URB may be re-submitted (see Note #2). */
+            USBH_TRACE_REC(USBH_TRACE_EVT_DEQUEUE, p_urb, p_urb->XferLen);
+            USBH_URB_Complete(p_urb);
+            p_urb     = p_urb_nxt;
+            batch_len++;
+        }
+
+        if (batch_len > 0u) {                                   /* Update batch stats.                                  */
+            hist_ix = 0u;
+            while ((hist_ix              < (USBH_ASYNC_BATCH_HIST_NBR - 1u)) &&
+                   ((batch_len >> (hist_ix + 1u)) != 0u)) {
+                hist_ix++;
+            }
 
+            CPU_CRITICAL_ENTER();
+            p_queue->Stat.WakeupCnt++;
+            p_queue->Stat.URB_Cnt      += batch_len;
+            p_queue->Stat.BatchLenLast  = batch_len;
+            if (batch_len > p_queue->Stat.BatchLenMax) {
+                p_queue->Stat.BatchLenMax = batch_len;
+            }
+            p_queue->Stat.BatchLenHist[hist_ix]++;
+            CPU_CRITICAL_EXIT();
+        }
+#else
         CPU_CRITICAL_ENTER();
-        p_urb = (USBH_URB *)USBH_URB_HeadPtr;
+        p_urb = (USBH_URB *)p_queue->HeadPtr;
 
-        if (USBH_URB_HeadPtr == USBH_URB_TailPtr) {
-            USBH_URB_HeadPtr = (USBH_URB *)0;
-            USBH_URB_TailPtr = (USBH_URB *)0;
+        if (p_queue->HeadPtr == p_queue->TailPtr) {
+            p_queue->HeadPtr = (USBH_URB *)0;
+            p_queue->TailPtr = (USBH_URB *)0;
         } else {
-            USBH_URB_HeadPtr = USBH_URB_HeadPtr->NxtPtr;
+            p_queue->HeadPtr = p_queue->HeadPtr->NxtPtr;
         }
         CPU_CRITICAL_EXIT();
 
         if (p_urb != (USBH_URB *)0) {
+            USBH_TRACE_REC(USBH_TRACE_EVT_DEQUEUE, p_urb, p_urb->XferLen);
             USBH_URB_Complete(p_urb);
         }
+#endif
     }
 }
@@ -90,6 +90,69 @@
 
 #define  USBH_HC_NBR_NONE                               0xFFu
 
+#define  USBH_ASYNC_BATCH_HIST_NBR                         8u   /* Nbr of buckets in async batch len histogram.         */
+
+
+/*
+*********************************************************************************************************
+*                                        TRANSFER TRACE EVENTS
+*
+* Note(s) : (1) Events are recorded in the trace ring in the order they occur for an URB. Synchronous URBs
+*               have no USBH_TRACE_EVT_DEQUEUE record.
+*********************************************************************************************************
+*/
+
+#define  USBH_TRACE_EVT_SUBMIT                             1u   /* URB submitted to HCD.                                */
+#define  USBH_TRACE_EVT_DONE                               2u   /* URB completed by HCD.                                */
+#define  USBH_TRACE_EVT_DEQUEUE                            3u   /* URB dequeued by async task.                          */
+#define  USBH_TRACE_EVT_NOTIFY                             4u   /* Completion notification returned.                    */
+
+#define  USBH_TRACE_MAGIC                         0x43525455u   /* Trace dump magic, "UTRC" in little endian.           */
+#define  USBH_TRACE_VER                                    1u
+
+
+/*
+*********************************************************************************************************
+*                                 ASYNC COMPLETION WORKER ROUTING MODES
+*
+* Note(s) : (1) Default routing of an endpoint to an asynchronous completion worker, selected by
+*               USBH_CFG_ASYNC_TASK_ROUTE. Worker 0 is the most latency sensitive one.
+*
+*               (a) USBH_ASYNC_ROUTE_EP_TYPE    Interrupt and isochronous endpoints are routed to worker 0,
+*                                               control endpoints to worker 1 and bulk endpoints to the last
+*                                               worker. Indexes are clamped to the number of workers.
+*
+*               (b) USBH_ASYNC_ROUTE_HC         Endpoints are routed according to their host controller
+*                                               number, modulo the number of workers.
+*
+*           (2) The routing of an endpoint can be overridden after it is opened with USBH_EP_AsyncPrioSet().
+*********************************************************************************************************
+*/
+
+#define  USBH_ASYNC_ROUTE_EP_TYPE                          0u
+#define  USBH_ASYNC_ROUTE_HC                               1u
+
+
+/*
+*********************************************************************************************************
+*                                  TRANSFER STATISTICS ERROR INDEXES
+*
+* Note(s) : (1) Index in 'ErrCntTbl' of USBH_XFER_STAT where an error is counted, according to its
+*               USBH_ERR code.
+*********************************************************************************************************
+*/
+
+#define  USBH_STAT_ERR_IX_STALL                            0u   /* USBH_ERR_EP_STALL.                                   */
+#define  USBH_STAT_ERR_IX_DATA_TOGGLE                      1u   /* USBH_ERR_EP_DATA_TOGGLE.                             */
+#define  USBH_STAT_ERR_IX_HC_IO                            2u   /* USBH_ERR_HC_IO.                                      */
+#define  USBH_STAT_ERR_IX_NOT_RESPONDING                   3u   /* USBH_ERR_DEV_NOT_RESPONDING.                         */
+#define  USBH_STAT_ERR_IX_TIMEOUT                          4u   /* USBH_ERR_OS_TIMEOUT.                                 */
+#define  USBH_STAT_ERR_IX_ABORT                            5u   /* USBH_ERR_URB_ABORT.                                  */
+#define  USBH_STAT_ERR_IX_SUBMIT                           6u   /* URB could not be submitted.                          */
+#define  USBH_STAT_ERR_IX_OTHER                            7u   /* Any other err.                                       */
+
+#define  USBH_STAT_ERR_NBR                                 8u
+
 
 /*
 *********************************************************************************************************
@@ -1002,9 +1065,63 @@ typedef  struct  usbh_isoc_desc {
 } USBH_ISOC_DESC;
 
 
+/*
+*********************************************************************************************************
+*                                         TRANSFER STATISTICS
+*
+* Note(s) : (1) Latencies are measured from the submission of an URB to its completion by the core, in
+*               CPU_TS_Get32() timestamp ticks.
+*
+*           (2) 'NAK_Cnt' and 'RetryCnt' are reported by host controller drivers that can observe them
+*               (see USBH_EP_STAT_NAK_INC() and USBH_EP_STAT_RETRY_INC()).
+*
+*           (3) A synchronous transfer that times out is counted as a timeout, then its URB is counted
+*               as aborted.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_xfer_stat {
+    CPU_INT64U  XferBytes;                                      /* Nbr of octets xfer'd.                                */
+    CPU_INT32U  URB_SubmitCnt;                                  /* Nbr of URBs submitted.                               */
+    CPU_INT32U  URB_CmplCnt;                                    /* Nbr of URBs completed, with or without err.          */
+    CPU_INT32U  ErrCnt;                                         /* Nbr of errs.                                         */
+    CPU_INT32U  ErrCntTbl[USBH_STAT_ERR_NBR];                   /* Nbr of errs per USBH_STAT_ERR_IX_xxx.                */
+    USBH_ERR    ErrLast;                                        /* Last err.                                            */
+    CPU_INT32U  NAK_Cnt;                                        /* Nbr of NAKs (see Note #2).                           */
+    CPU_INT32U  RetryCnt;                                       /* Nbr of transaction retries (see Note #2).            */
+    CPU_INT32U  StallClrCnt;                                    /* Nbr of STALL conditions cleared.                     */
+    CPU_INT32U  LatMin;                                         /* Min completion latency (see Note #1).                */
+    CPU_INT32U  LatAvg;                                         /* Avg completion latency.                              */
+    CPU_INT32U  LatMax;                                         /* Max completion latency.                              */
+    CPU_INT64U  LatTotal;                                       /* Sum of completion latencies.                         */
+} USBH_XFER_STAT;
+
+
+/*
+*********************************************************************************************************
+*                                     SCATTER-GATHER SEGMENT
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_sg_seg {
+    void        *BufPtr;                                        /* Ptr to seg buf.                                      */
+    CPU_INT32U   BufLen;                                        /* Seg buf len in octets.                               */
+} USBH_SG_SEG;
+
+
 /*
 *********************************************************************************************************
 *                                 USB REQUEST BLOCK (URB) INFORMATION
+*
+* Note(s) : (1) 'SG_SegTblPtr' is set for scatter-gather transfers only. When 'SG_BouncePtr' is null, the
+*               host controller driver maps the segments itself and 'UserBufPtr' is null; otherwise the core
+*               copied the segments into the bounce buffer, which 'UserBufPtr' points to. See also
+*               USBH_URB_IS_SG().
+*
+*           (2) 'DMA_Direct' is set by the core before the URB is submitted, when every data buffer of the
+*               URB satisfies the DMA constraints of the host controller (see 'HOST CONTROLLER
+*               CONFIGURATION Note #1'). Host controller drivers then program the user buffer address
+*               directly instead of copying it through their bounce buffer.
 *********************************************************************************************************
 */
 
@@ -1021,6 +1138,17 @@ struct  usbh_urb {
 
               USBH_ISOC_DESC  *IsocDescPtr;                     /* Isoc xfer desc.                                      */
 
+              USBH_SG_SEG     *SG_SegTblPtr;                    /* Scatter-gather seg tbl (see Note #1).                */
+              CPU_INT08U       SG_SegNbr;                       /* Nbr of seg in SG seg tbl.                            */
+              void            *SG_BouncePtr;                    /* Bounce buf used when HC cannot map the seg tbl.      */
+              CPU_BOOLEAN      DMA_Direct;                      /* User buf can be used by HC DMA (see Note #2).        */
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+              CPU_INT32U       TraceId;                         /* URB id in trace ring.                                */
+#endif
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+              CPU_INT32U       StatTS;                          /* Submit timestamp, for latency stats.                 */
+#endif
+
               void            *FnctPtr;                         /* Fnct ptr, called when I/O is completed.              */
               void            *FnctArgPtr;                      /* Fnct context.                                        */
 
@@ -1048,6 +1176,7 @@ struct  usbh_ep {
     USBH_DEV      *DevPtr;                                      /* Ptr to USB dev struct.                               */
     USBH_EP_DESC   Desc;                                        /* EP desc.                                             */
     CPU_INT16U     Interval;                                    /* EP interval.                                         */
+    CPU_INT32U     IntervalUs;                                  /* EP interval, in us.                                  */
     CPU_INT32U     HC_RefFrame;                                 /* Initial HC ref frame nbr.                            */
     void          *ArgPtr;                                      /* HCD private data.                                    */
     USBH_URB       URB;                                         /* URB used for data xfer on this endpoint.             */
@@ -1055,6 +1184,10 @@ struct  usbh_ep {
     CPU_BOOLEAN    IsOpen;                                      /* EP state.                                            */
     CPU_INT32U     XferNbrInProgress;                           /* Nbr of URB(s) in progress. Used for async omm.       */
     CPU_INT08U     DataPID;                                     /* EP Data Toggle PID tracker.                          */
+    CPU_INT08U     AsyncPrio;                                   /* Ix of async completion worker used by this EP.       */
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+    USBH_XFER_STAT Stat;                                        /* EP xfer statistics.                                  */
+#endif
 };
 
 
@@ -1109,6 +1242,9 @@ struct  usbh_dev {
     CPU_INT32U           PortNbr;                               /* Port nbr to which this dev is connected.             */
     CPU_BOOLEAN          IsRootHub;                             /* Indicate if this is a RH dev.                        */
     USBH_HUB_DEV        *HubHS_Ptr;                             /* Ptr to prev HS Hub.                                  */
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+    USBH_XFER_STAT       Stat;                                  /* Xfer stats of all dev EPs.                           */
+#endif
 };
 
 
@@ -1130,12 +1266,33 @@ struct  usbh_hub_dev {
     CPU_INT08U      RefCnt;
     USBH_HUB_DEV   *NxtPtr;
     CPU_INT08U      ConnCnt;                                    /* Re-connection counter                                */
+    CPU_INT08U      PortState[USBH_CFG_MAX_HUB_PORTS];          /* Enum state of each port.                             */
+    CPU_INT16U      PortTmr[USBH_CFG_MAX_HUB_PORTS];            /* Remaining time (ms) of each port enum tmr.           */
+    CPU_INT08U      PortChngMap;                                /* Bitmap of ports with pending status chng.            */
+    CPU_BOOLEAN     EventPend;                                  /* Hub is queued for event processing.                  */
 };
 
 
+/*
+*********************************************************************************************************
+*                                   HOST CONTROLLER DMA STATISTICS
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_hc_dma_stat {
+    CPU_INT32U  DirectCnt;                                      /* Nbr of URBs xfer'd directly from/to user buf.        */
+    CPU_INT32U  BounceCnt;                                      /* Nbr of URBs copied through HC drv bounce buf.        */
+} USBH_HC_DMA_STAT;
+
+
 /*
 *********************************************************************************************************
 *                                 HOST CONTROLLER DRIVER INFORMATION
+*
+* Note(s) : (1) 'SG_En' is cleared by the core before the driver's Init() function is called. A driver
+*               that can build its transfer descriptors directly from a scatter-gather segment table sets
+*               it to DEF_TRUE from Init(). Otherwise, the core bounces scatter-gather transfers through a
+*               contiguous buffer.
 *********************************************************************************************************
 */
 
@@ -1147,12 +1304,20 @@ struct  usbh_hc_drv {
     USBH_HC_DRV_API  *API_Ptr;                                  /* Ptr to HC drv API struct.                            */
     USBH_HC_RH_API   *RH_API_Ptr;                               /* Ptr to RH drv API struct.                            */
     USBH_HC_BSP_API  *BSP_API_Ptr;                              /* Ptr to HC BSP API struct.                            */
+    CPU_BOOLEAN       SG_En;                                    /* HC drv maps scatter-gather seg tbl (see Note #1).    */
+    USBH_HC_DMA_STAT  DMA_Stat;                                 /* DMA data path stats, updated by HC drv.              */
 };
 
 
 /*
 *********************************************************************************************************
 *                                    HOST CONTROLLER CONFIGURATION
+*
+* Note(s) : (1) A data buffer is given to the host controller without copy when it is aligned on
+*               'DMA_BufAlign' octets and lies either in the dedicated memory or in the system memory
+*               region described by 'DMA_MemAddr' and 'DMA_MemSize'. If 'DMA_MemSize' is 0, no system
+*               memory buffer qualifies, so configurations that do not initialize these fields keep the
+*               previous behavior.
 *********************************************************************************************************
 */
 
@@ -1165,6 +1330,9 @@ struct  usbh_hc_cfg {
     CPU_INT32U   MaxNbrEP_BulkOpen;                             /* Max nbr of opened bulk EP.                           */
     CPU_INT32U   MaxNbrEP_IntrOpen;                             /* Max nbr of opened intr EP.                           */
     CPU_INT32U   MaxNbrEP_IsocOpen;                             /* Max nbr of opened isoc EP.                           */
+    CPU_ADDR     DMA_MemAddr;                                   /* Start addr of sys mem reachable by HC DMA.           */
+    CPU_INT32U   DMA_MemSize;                                   /* Size of sys mem reachable by HC DMA (see Note #1).   */
+    CPU_INT32U   DMA_BufAlign;                                  /* Alignment required for HC DMA data buf, in octets.   */
 };
 
 
@@ -1197,15 +1365,85 @@ struct  usbh_host {
     MEM_POOL         IsocDescPool;
     USBH_ISOC_DESC   IsocDesc[USBH_CFG_MAX_ISOC_DESC];
     MEM_POOL         AsyncURB_Pool;                             /* Pool of extra URB when using async comm.             */
+    MEM_POOL         SG_BouncePool;                             /* Pool of scatter-gather bounce bufs.                  */
 
     USBH_HC          HC_Tbl[USBH_CFG_MAX_NBR_HC];               /* Array of HC structs.                                 */
     CPU_INT08U       HC_NbrNext;
 
-    USBH_HTASK       HAsyncTask;                                /* Async task handle.                                   */
+    USBH_HTASK       HAsyncTask[USBH_CFG_ASYNC_TASK_NBR];       /* Async task handles.                                  */
     USBH_HTASK       HHubTask;                                  /* Hub event task handle.                               */
 };
 
 
+/*
+*********************************************************************************************************
+*                                  ASYNC COMPLETION BATCH STATISTICS
+*
+* Note(s) : (1) Bucket 'n' of 'BatchLenHist' counts the wakeups of the async task that completed between
+*               2^n and (2^(n + 1) - 1) URBs. The last bucket also counts every larger batch.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_async_stat {
+    CPU_INT32U  WakeupCnt;                                      /* Nbr of async task wakeups.                           */
+    CPU_INT32U  URB_Cnt;                                        /* Nbr of URBs completed by async task.                 */
+    CPU_INT32U  BatchLenLast;                                   /* Nbr of URBs completed on last wakeup.                */
+    CPU_INT32U  BatchLenMax;                                    /* Max nbr of URBs completed on a single wakeup.        */
+    CPU_INT32U  BatchLenHist[USBH_ASYNC_BATCH_HIST_NBR];        /* Batch len histogram. See Note #1.                    */
+} USBH_ASYNC_STAT;
+
+
+/*
+*********************************************************************************************************
+*                                  ENUMERATION DESCRIPTOR CACHE STATISTICS
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_desc_cache_stat {
+    CPU_INT32U  HitCnt;                                         /* Nbr of conn that skipped cfg desc rd & parse.        */
+    CPU_INT32U  MissCnt;                                        /* Nbr of conn with no matching cache entry.            */
+    CPU_INT32U  InvalidCnt;                                     /* Nbr of entries dropped on a desc mismatch.           */
+} USBH_DESC_CACHE_STAT;
+
+
+/*
+*********************************************************************************************************
+*                                        TRANSFER TRACE RECORD
+*
+* Note(s) : (1) 'Seq' is written last. A record with a 'Seq' of 0 is empty or was being written when the
+*               ring was dumped, and must be discarded.
+*
+*           (2) All the records of an URB share the same 'URB_Id', which is the 'Seq' of its
+*               USBH_TRACE_EVT_SUBMIT record.
+*
+*           (3) A trace dump is made of an USBH_TRACE_HDR followed by 'RecNbr' records, oldest first.
+*               Fields are stored in CPU endianness.
+*********************************************************************************************************
+*/
+
+typedef  struct  usbh_trace_rec {
+    CPU_INT32U  Seq;                                            /* Rec sequence nbr (see Note #1).                      */
+    CPU_INT32U  TS;                                             /* Timestamp, from CPU_TS_Get32().                      */
+    CPU_INT32U  URB_Id;                                         /* URB identifier (see Note #2).                        */
+    CPU_INT32U  Len;                                            /* Buf len on submit, xfer'd len otherwise.             */
+    CPU_INT16U  Err;                                            /* URB err.                                             */
+    CPU_INT08U  Evt;                                            /* Trace evt.                                           */
+    CPU_INT08U  DevAddr;                                        /* USB dev addr.                                        */
+    CPU_INT08U  EP_Addr;                                        /* EP addr.                                             */
+    CPU_INT08U  Token;                                          /* Token (SETUP, IN, or OUT).                           */
+    CPU_INT08U  AsyncPrio;                                      /* Async completion task index of EP.                   */
+    CPU_INT08U  Rsvd;
+} USBH_TRACE_REC;
+
+typedef  struct  usbh_trace_hdr {
+    CPU_INT32U  Magic;                                          /* USBH_TRACE_MAGIC.                                    */
+    CPU_INT16U  Ver;                                            /* USBH_TRACE_VER.                                      */
+    CPU_INT16U  RecSize;                                        /* Size of a trace rec, in octets.                      */
+    CPU_INT32U  RecNbr;                                         /* Nbr of trace recs following hdr.                     */
+    CPU_INT32U  TS_Freq;                                        /* Timestamp freq, in Hz. 0 if unknown.                 */
+} USBH_TRACE_HDR;
+
+
 /*
 *********************************************************************************************************
 *                                       KERNEL TASK INFORMATION
@@ -1355,6 +1593,37 @@ typedef  void  (*USBH_XFER_CMPL_FNCT)(USBH_EP     *p_ep,
                                                                                         (p_err))
 
 
+/*
+*********************************************************************************************************
+*                                     SCATTER-GATHER URB MACROS
+*
+* Note(s) : (1) USBH_URB_IS_SG() is used by host controller drivers to determine if they must build the
+*               transfer from the URB's segment table rather than from 'UserBufPtr'.
+*********************************************************************************************************
+*/
+
+#define  USBH_URB_IS_SG(p_urb)                  (((p_urb)->SG_SegNbr    != 0u        ) && \
+                                                 ((p_urb)->SG_BouncePtr == (void *)0))
+
+
+/*
+*********************************************************************************************************
+*                                    TRANSFER STATISTICS HCD MACROS
+*
+* Note(s) : (1) Host controller drivers report the NAKs and transaction retries they observe on an
+*               endpoint with these macros. They compile to nothing when USBH_CFG_STAT_EN is disabled.
+*********************************************************************************************************
+*/
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+#define  USBH_EP_STAT_NAK_INC(p_ep)             USBH_EP_StatHCD_Upd((p_ep), 1u, 0u)
+#define  USBH_EP_STAT_RETRY_INC(p_ep)           USBH_EP_StatHCD_Upd((p_ep), 0u, 1u)
+#else
+#define  USBH_EP_STAT_NAK_INC(p_ep)
+#define  USBH_EP_STAT_RETRY_INC(p_ep)
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                         FUNCTION PROTOTYPES
@@ -1371,6 +1640,20 @@ USBH_ERR        USBH_Suspend          (void);
 
 USBH_ERR        USBH_Resume           (void);
 
+#if (USBH_CFG_ASYNC_BATCH_EN == DEF_ENABLED)
+USBH_ERR        USBH_AsyncStatGet     (CPU_INT08U              prio,
+                                       USBH_ASYNC_STAT        *p_stat);
+
+void            USBH_AsyncStatClr     (void);
+#endif
+
+#if (USBH_CFG_TRACE_EN == DEF_ENABLED)
+CPU_INT32U      USBH_TraceDump        (void                   *p_buf,
+                                       CPU_INT32U              buf_len);
+
+void            USBH_TraceClr         (void);
+#endif
+
                                                                 /* ------------ HOST CONTROLLER FUNCTIONS ------------- */
 CPU_INT08U      USBH_HC_Add           (USBH_HC_CFG            *p_hc_cfg,
                                        USBH_HC_DRV_API        *p_drv_api,
@@ -1391,9 +1674,18 @@ USBH_ERR        USBH_HC_PortDis       (CPU_INT08U              hc_nbr,
 CPU_INT32U      USBH_HC_FrameNbrGet   (CPU_INT08U              hc_nbr,
                                        USBH_ERR               *p_err);
 
+USBH_ERR        USBH_HC_DMA_StatGet   (CPU_INT08U              hc_nbr,
+                                       USBH_HC_DMA_STAT       *p_stat);
+
+USBH_ERR        USBH_HC_DMA_StatClr   (CPU_INT08U              hc_nbr);
+
                                                                 /* ------------- DEVICE CONTROL FUNCTIONS ------------- */
 USBH_ERR        USBH_DevConn          (USBH_DEV               *p_dev);
 
+USBH_ERR        USBH_DevAddrAssign    (USBH_DEV               *p_dev);
+
+USBH_ERR        USBH_DevCfgLoad       (USBH_DEV               *p_dev);
+
 void            USBH_DevDisconn       (USBH_DEV               *p_dev);
 
 CPU_INT08U      USBH_DevCfgNbrGet     (USBH_DEV               *p_dev);
@@ -1401,6 +1693,19 @@ CPU_INT08U      USBH_DevCfgNbrGet     (USBH_DEV               *p_dev);
 void            USBH_DevDescGet       (USBH_DEV               *p_dev,
                                        USBH_DEV_DESC          *p_dev_desc);
 
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+USBH_ERR        USBH_DevStatsGet      (USBH_DEV               *p_dev,
+                                       USBH_XFER_STAT         *p_stat);
+
+USBH_ERR        USBH_DevStatsClr      (USBH_DEV               *p_dev);
+#endif
+
+#if (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+void            USBH_DescCacheStatGet (USBH_DESC_CACHE_STAT   *p_stat);
+
+void            USBH_DescCacheClr     (void);
+#endif
+
                                                                 /* ---------- DEVICE CONFIGURATION FUNCTIONS ---------- */
 USBH_ERR        USBH_CfgSet           (USBH_DEV               *p_dev,
                                        CPU_INT08U              cfg_nbr);
@@ -1447,10 +1752,20 @@ USBH_ERR        USBH_BulkOutOpen      (USBH_DEV               *p_dev,
                                        USBH_IF                *p_if,
                                        USBH_EP                *p_ep);
 
+USBH_ERR        USBH_BulkAddrOpen     (USBH_DEV               *p_dev,
+                                       USBH_IF                *p_if,
+                                       CPU_INT08U              ep_addr,
+                                       USBH_EP                *p_ep);
+
 USBH_ERR        USBH_IntrInOpen       (USBH_DEV               *p_dev,
                                        USBH_IF                *p_if,
                                        USBH_EP                *p_ep);
 
+USBH_ERR        USBH_IntrInIntervalOpen(USBH_DEV              *p_dev,
+                                       USBH_IF                *p_if,
+                                       CPU_INT32U              interval_us,
+                                       USBH_EP                *p_ep);
+
 USBH_ERR        USBH_IntrOutOpen      (USBH_DEV               *p_dev,
                                        USBH_IF                *p_if,
                                        USBH_EP                *p_ep);
@@ -1508,6 +1823,30 @@ USBH_ERR        USBH_BulkRxAsync      (USBH_EP                *p_ep,
                                        USBH_XFER_CMPL_FNCT     fnct,
                                        void                   *p_fnct_arg);
 
+CPU_INT32U      USBH_BulkTxSG         (USBH_EP                *p_ep,
+                                       USBH_SG_SEG            *p_seg_tbl,
+                                       CPU_INT08U              seg_nbr,
+                                       CPU_INT32U              timeout_ms,
+                                       USBH_ERR               *p_err);
+
+USBH_ERR        USBH_BulkTxAsyncSG    (USBH_EP                *p_ep,
+                                       USBH_SG_SEG            *p_seg_tbl,
+                                       CPU_INT08U              seg_nbr,
+                                       USBH_XFER_CMPL_FNCT     fnct,
+                                       void                   *p_fnct_arg);
+
+CPU_INT32U      USBH_BulkRxSG         (USBH_EP                *p_ep,
+                                       USBH_SG_SEG            *p_seg_tbl,
+                                       CPU_INT08U              seg_nbr,
+                                       CPU_INT32U              timeout_ms,
+                                       USBH_ERR               *p_err);
+
+USBH_ERR        USBH_BulkRxAsyncSG    (USBH_EP                *p_ep,
+                                       USBH_SG_SEG            *p_seg_tbl,
+                                       CPU_INT08U              seg_nbr,
+                                       USBH_XFER_CMPL_FNCT     fnct,
+                                       void                   *p_fnct_arg);
+
 CPU_INT32U      USBH_IntrTx           (USBH_EP                *p_ep,
                                        void                   *p_buf,
                                        CPU_INT32U              buf_len,
@@ -1581,6 +1920,8 @@ CPU_INT16U      USBH_EP_MaxPktSizeGet (USBH_EP                *p_ep);
 
 CPU_INT08U      USBH_EP_TypeGet       (USBH_EP                *p_ep);
 
+CPU_INT32U      USBH_EP_IntervalGet   (USBH_EP                *p_ep);
+
 USBH_ERR        USBH_EP_Get           (USBH_IF                *p_if,
                                        CPU_INT08U              alt_ix,
                                        CPU_INT08U              ep_ix,
@@ -1593,13 +1934,37 @@ USBH_ERR        USBH_EP_StallClr      (USBH_EP                *p_ep);
 USBH_ERR        USBH_EP_Reset         (USBH_DEV               *p_dev,
                                        USBH_EP                *p_ep);
 
+USBH_ERR        USBH_EP_Abort         (USBH_EP                *p_ep);
+
 USBH_ERR        USBH_EP_Close         (USBH_EP                *p_ep);
 
+USBH_ERR        USBH_EP_AsyncPrioSet  (USBH_EP                *p_ep,
+                                       CPU_INT08U              prio);
+
+#if (USBH_CFG_STAT_EN == DEF_ENABLED)
+USBH_ERR        USBH_EP_StatsGet      (USBH_EP                *p_ep,
+                                       USBH_XFER_STAT         *p_stat);
+
+USBH_ERR        USBH_EP_StatsClr      (USBH_EP                *p_ep);
+
+void            USBH_EP_StatHCD_Upd   (USBH_EP                *p_ep,
+                                       CPU_INT32U              nak_cnt,
+                                       CPU_INT32U              retry_cnt);
+#endif
+
                                                                 /* ----------- USB REQUEST BLOCK FUNCTIONS ------------ */
 void            USBH_URB_Done         (USBH_URB               *p_urb);
 
 USBH_ERR        USBH_URB_Complete     (USBH_URB               *p_urb);
 
+CPU_INT32U      USBH_URB_SG_Gather    (USBH_URB               *p_urb,
+                                       void                   *p_dst,
+                                       CPU_INT32U              len);
+
+CPU_INT32U      USBH_URB_SG_Scatter   (USBH_URB               *p_urb,
+                                       void                   *p_src,
+                                       CPU_INT32U              len);
+
                                                                 /* ------------- MISCELLENEOUS FUNCTIONS -------------- */
 CPU_INT32U      USBH_StrGet           (USBH_DEV               *p_dev,
                                        CPU_INT08U              desc_ix,
@@ -1720,6 +2085,96 @@ CPU_INT32U      USBH_StrGet           (USBH_DEV               *p_dev,
 #error  "USBH_CFG_MAX_NUM_DEV_RECONN           not #define'd in 'usbh_cfg.h'"
 #endif
 
+#ifndef  USBH_CFG_MAX_QUEUED_URB_PER_EP
+#error  "USBH_CFG_MAX_QUEUED_URB_PER_EP        not #define'd in 'usbh_cfg.h'"
+#elif   (USBH_CFG_MAX_QUEUED_URB_PER_EP < 1u)
+#error  "USBH_CFG_MAX_QUEUED_URB_PER_EP        illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1]                     "
+#endif
+
+#ifndef  USBH_CFG_SG_BOUNCE_BUF_NBR
+#error  "USBH_CFG_SG_BOUNCE_BUF_NBR            not #define'd in 'usbh_cfg.h'"
+#endif
+
+#ifndef  USBH_CFG_SG_BOUNCE_BUF_LEN
+#error  "USBH_CFG_SG_BOUNCE_BUF_LEN            not #define'd in 'usbh_cfg.h'"
+#elif  ((USBH_CFG_SG_BOUNCE_BUF_NBR >  0u) && \
+        (USBH_CFG_SG_BOUNCE_BUF_LEN <  1u))
+#error  "USBH_CFG_SG_BOUNCE_BUF_LEN            illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1]                     "
+#endif
+
+#ifndef  USBH_CFG_ASYNC_TASK_NBR
+#error  "USBH_CFG_ASYNC_TASK_NBR               not #define'd in 'usbh_cfg.h'"
+#elif   (USBH_CFG_ASYNC_TASK_NBR < 1u)
+#error  "USBH_CFG_ASYNC_TASK_NBR               illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1]                     "
+#endif
+
+#ifndef  USBH_CFG_ASYNC_TASK_ROUTE
+#error  "USBH_CFG_ASYNC_TASK_ROUTE             not #define'd in 'usbh_cfg.h'"
+#elif  ((USBH_CFG_ASYNC_TASK_ROUTE != USBH_ASYNC_ROUTE_EP_TYPE) && \
+        (USBH_CFG_ASYNC_TASK_ROUTE != USBH_ASYNC_ROUTE_HC     ))
+#error  "USBH_CFG_ASYNC_TASK_ROUTE             illegally #define'd in 'usbh_cfg.h'"
+#error  "                  [MUST be USBH_ASYNC_ROUTE_EP_TYPE || USBH_ASYNC_ROUTE_HC]"
+#endif
+
+#ifndef  USBH_CFG_ASYNC_BATCH_EN
+#error  "USBH_CFG_ASYNC_BATCH_EN               not #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#elif  ((USBH_CFG_ASYNC_BATCH_EN != DEF_DISABLED) && \
+        (USBH_CFG_ASYNC_BATCH_EN != DEF_ENABLED ))
+#error  "USBH_CFG_ASYNC_BATCH_EN               illegally #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#endif
+
+#ifndef  USBH_CFG_TRACE_EN
+#error  "USBH_CFG_TRACE_EN                     not #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#elif  ((USBH_CFG_TRACE_EN != DEF_DISABLED) && \
+        (USBH_CFG_TRACE_EN != DEF_ENABLED ))
+#error  "USBH_CFG_TRACE_EN                     illegally #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#elif   (USBH_CFG_TRACE_EN == DEF_ENABLED)
+
+#ifndef  USBH_CFG_TRACE_REC_NBR
+#error  "USBH_CFG_TRACE_REC_NBR                not #define'd in 'usbh_cfg.h'"
+#elif  ((USBH_CFG_TRACE_REC_NBR < 2u) || \
+       ((USBH_CFG_TRACE_REC_NBR & (USBH_CFG_TRACE_REC_NBR - 1u)) != 0u))
+#error  "USBH_CFG_TRACE_REC_NBR                illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be a power of 2, >= 2]       "
+#endif
+
+#endif
+
+#ifndef  USBH_CFG_STAT_EN
+#error  "USBH_CFG_STAT_EN                      not #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#elif  ((USBH_CFG_STAT_EN != DEF_DISABLED) && \
+        (USBH_CFG_STAT_EN != DEF_ENABLED ))
+#error  "USBH_CFG_STAT_EN                      illegally #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#endif
+
+#ifndef  USBH_CFG_DESC_CACHE_EN
+#error  "USBH_CFG_DESC_CACHE_EN                not #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#elif  ((USBH_CFG_DESC_CACHE_EN != DEF_DISABLED) && \
+        (USBH_CFG_DESC_CACHE_EN != DEF_ENABLED ))
+#error  "USBH_CFG_DESC_CACHE_EN                illegally #define'd in 'usbh_cfg.h'"
+#error  "                                [MUST be  DEF_DISABLED || DEF_ENABLED]   "
+#elif   (USBH_CFG_DESC_CACHE_EN == DEF_ENABLED)
+
+#ifndef  USBH_CFG_DESC_CACHE_NBR
+#error  "USBH_CFG_DESC_CACHE_NBR               not #define'd in 'usbh_cfg.h'"
+#elif  ((USBH_CFG_DESC_CACHE_NBR < 1u) || \
+        (USBH_CFG_DESC_CACHE_NBR > 255u))
+#error  "USBH_CFG_DESC_CACHE_NBR               illegally #define'd in 'usbh_cfg.h'"
+#error  "                                      [MUST be >= 1 && <= 255]           "
+#endif
+
+#endif
+
 
 /*
 *********************************************************************************************************
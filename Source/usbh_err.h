@@ -119,6 +119,7 @@ typedef  enum  usbh_err {
     USBH_ERR_EP_NACK                            =   405u,
     USBH_ERR_EP_NOT_FOUND                       =   406u,
     USBH_ERR_EP_DATA_TOGGLE                     =   407u,
+    USBH_ERR_EP_QUEUE_FULL                      =   408u,
 
 
 /*
@@ -43,6 +43,23 @@
 *********************************************************************************************************
 */
 
+#define  USBH_HUB_DLY_DEBOUNCE                           100u   /* Conn debounce interval (see USB 2.0 spec 7.1.7.3).   */
+#define  USBH_HUB_DLY_RESET_RECOVERY                      50u   /* Dly between end of port reset & first dev req.       */
+#define  USBH_HUB_DLY_TMR_TICK                            10u   /* Port enum tmr resolution.                            */
+
+
+/*
+*********************************************************************************************************
+*                                        HUB PORT ENUM STATES
+*********************************************************************************************************
+*/
+
+#define  USBH_HUB_PORT_STATE_IDLE                          0u   /* No enum in progress on port.                         */
+#define  USBH_HUB_PORT_STATE_DEBOUNCE                      1u   /* Conn detected, debounce tmr running.                 */
+#define  USBH_HUB_PORT_STATE_RESET_PEND                    2u   /* Debounced, waiting for addr 0 to be free.            */
+#define  USBH_HUB_PORT_STATE_RESET                         3u   /* Port reset in progress, owns addr 0.                 */
+#define  USBH_HUB_PORT_STATE_RECOVERY                      4u   /* Reset recovery tmr running, owns addr 0.             */
+
 
 /*
 *********************************************************************************************************
@@ -160,6 +177,9 @@ static  volatile  USBH_HUB_DEV  *USBH_HUB_HeadPtr;
 static  volatile  USBH_HUB_DEV  *USBH_HUB_TailPtr;
 static  volatile  USBH_HSEM      USBH_HUB_EventSem;
 
+static            USBH_HUB_DEV  *USBH_HUB_EnumHubPtr;           /* Hub whose port currently owns dflt addr 0.           */
+static            CPU_INT16U     USBH_HUB_EnumPortNbr;          /* Port nbr that currently owns dflt addr 0.            */
+
 
 /*
 *********************************************************************************************************
@@ -196,8 +216,30 @@ static  void       USBH_HUB_ISR             (USBH_EP               *p_ep,
                                              void                  *p_arg,
                                              USBH_ERR               err);
 
+static  void       USBH_HUB_EventQueue      (USBH_HUB_DEV          *p_hub_dev,
+                                             CPU_INT08U             chng_map);
+
 static  void       USBH_HUB_EventProcess    (void);
 
+static  USBH_ERR   USBH_HUB_PortEvent       (USBH_HUB_DEV          *p_hub_dev,
+                                             CPU_INT16U             port_nbr,
+                                             USBH_HUB_PORT_STATUS  *p_port_status);
+
+static  void       USBH_HUB_PortConn        (USBH_HUB_DEV          *p_hub_dev,
+                                             CPU_INT16U             port_nbr);
+
+static  CPU_BOOLEAN  USBH_HUB_PortTmrActive (void);
+
+static  void       USBH_HUB_PortTmrTick     (CPU_INT16U             elapsed);
+
+static  void       USBH_HUB_PortTmrExp      (USBH_HUB_DEV          *p_hub_dev,
+                                             CPU_INT16U             port_nbr);
+
+static  void       USBH_HUB_EnumNxt         (void);
+
+static  void       USBH_HUB_EnumRel         (USBH_HUB_DEV          *p_hub_dev,
+                                             CPU_INT16U             port_nbr);
+
 static  USBH_ERR   USBH_HUB_DescGet         (USBH_HUB_DEV          *p_hub_dev);
 
 static  USBH_ERR   USBH_HUB_PortsInit       (USBH_HUB_DEV          *p_hub_dev);
@@ -218,6 +260,10 @@ static  USBH_ERR   USBH_HUB_PortEnChngClr   (USBH_HUB_DEV          *p_hub_dev,
 static  USBH_ERR   USBH_HUB_PortConnChngClr (USBH_HUB_DEV          *p_hub_dev,
                                              CPU_INT16U             port_nbr);
 
+static  USBH_ERR   USBH_HUB_PortChngClr     (USBH_HUB_DEV          *p_hub_dev,
+                                             CPU_INT16U             port_nbr,
+                                             CPU_INT16U             port_chng);
+
 static  USBH_ERR   USBH_HUB_PortPwrSet      (USBH_HUB_DEV          *p_hub_dev,
                                              CPU_INT16U             port_nbr);
 
@@ -279,18 +325,50 @@ USBH_CLASS_DRV  USBH_HUB_Drv = {
 *
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) Port enumeration timers (debounce, reset & reset recovery) of all hubs run concurrently
+*                   and are advanced by the time actually elapsed since the previous wakeup, whether the
+*                   wait for a hub event timed out or not. The time spent processing events and expired
+*                   timers is not accounted, so a port delay can be lengthened, but never shortened.
+*
+*               (2) A wait that timed out lasted at least USBH_HUB_DLY_TMR_TICK, even if the OS time
+*                   source has a coarser resolution.
 *********************************************************************************************************
 */
 
 void  USBH_HUB_EventTask (void  *p_arg)
 {
+    CPU_INT32U  timeout;
+    CPU_INT32U  time_prev;
+    CPU_INT32U  elapsed;
+    USBH_ERR    err;
+
+
     (void)p_arg;
 
+    time_prev = USBH_OS_TimeGet();
+
     while (DEF_TRUE) {
-        (void)USBH_OS_SemWait(USBH_HUB_EventSem, 0u);
+        timeout = (USBH_HUB_PortTmrActive() == DEF_YES) ? USBH_HUB_DLY_TMR_TICK : 0u;
+        err     =  USBH_OS_SemWait(USBH_HUB_EventSem, timeout);
+        elapsed =  USBH_OS_TimeGet() - time_prev;               /* See Note #1.                                         */
+
+        if ((err     == USBH_ERR_OS_TIMEOUT  ) &&               /* See Note #2.                                         */
+            (elapsed <  USBH_HUB_DLY_TMR_TICK)) {
+            elapsed = USBH_HUB_DLY_TMR_TICK;
+        }
+        if (elapsed > DEF_INT_16U_MAX_VAL) {
+            elapsed = DEF_INT_16U_MAX_VAL;
+        }
 
-        USBH_HUB_EventProcess();
+        USBH_HUB_PortTmrTick((CPU_INT16U)elapsed);
+
+        if (err != USBH_ERR_OS_TIMEOUT) {
+            USBH_HUB_EventProcess();
+        }
+
+        USBH_HUB_EnumNxt();                                     /* Grant addr 0 to next debounced port, if free.        */
+
+        time_prev = USBH_OS_TimeGet();
     }
 }
 
@@ -432,8 +510,10 @@ static  void  USBH_HUB_GlobalInit (USBH_ERR  *p_err)
    *p_err = USBH_OS_SemCreate((USBH_HSEM *)&USBH_HUB_EventSem,
                                             0u);
 
-    USBH_HUB_HeadPtr = (USBH_HUB_DEV *)0;
-    USBH_HUB_TailPtr = (USBH_HUB_DEV *)0;
+    USBH_HUB_HeadPtr     = (USBH_HUB_DEV *)0;
+    USBH_HUB_TailPtr     = (USBH_HUB_DEV *)0;
+    USBH_HUB_EnumHubPtr  = (USBH_HUB_DEV *)0;
+    USBH_HUB_EnumPortNbr =  0u;
 
     Mem_Clr((void *)USBH_HUB_DescBuf,
                     USBH_HUB_MAX_DESC_LEN);
@@ -750,6 +830,10 @@ static  void  USBH_HUB_Uninit (USBH_HUB_DEV  *p_hub_dev)
                         USBH_CFG_MAX_HUB_PORTS);
 
     for (port_ix = 0u; port_ix < nbr_ports; port_ix++) {
+        USBH_HUB_EnumRel(p_hub_dev, port_ix + 1u);              /* Abort any enum in progress on port.                  */
+        p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_IDLE;
+        p_hub_dev->PortTmr[port_ix]   = 0u;
+
         p_dev = (USBH_DEV *)p_hub_dev->DevPtrList[port_ix];
 
         if (p_dev != (USBH_DEV *)0){
@@ -900,7 +984,9 @@ static  USBH_ERR  USBH_HUB_EventReq (USBH_HUB_DEV  *p_hub_dev)
 *
 * Return(s)   : None.
 *
-* Note(s)     : None.
+* Note(s)     : (1) The status change bitmap holds one bit per port, bit 0 being the hub itself (see section
+*                   11.12.4, USB 2.0 spec). Only the first octet is used since at most 7 ports are managed
+*                   per hub. An empty report is treated as a change on every port.
 *********************************************************************************************************
 */
 
@@ -912,13 +998,11 @@ static  void  USBH_HUB_ISR (USBH_EP     *p_ep,
                             USBH_ERR     err)
 {
     USBH_HUB_DEV  *p_hub_dev;
-    CPU_SR_ALLOC();
+    CPU_INT08U     chng_map;
 
 
     (void)buf_len;
-    (void)p_buf;
     (void)p_ep;
-    (void)xfer_len;
 
     p_hub_dev = (USBH_HUB_DEV *)p_arg;
 
@@ -940,6 +1024,50 @@ static  void  USBH_HUB_ISR (USBH_EP     *p_ep,
 
     p_hub_dev->ErrCnt = 0u;
 
+    if (xfer_len > 0u) {                                        /* See Note #1.                                         */
+        chng_map = ((CPU_INT08U *)p_buf)[0];
+    } else {
+        chng_map = DEF_INT_08U_MAX_VAL;
+    }
+
+    USBH_HUB_EventQueue(p_hub_dev, chng_map);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_HUB_EventQueue()
+*
+* Description : Record status change of given hub ports & queue hub for event processing.
+*
+* Argument(s) : p_hub_dev       Pointer to hub device.
+*
+*               chng_map        Bitmap of ports with a status change (bit N for port N).
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Changes reported while the hub is still queued are merged into its pending bitmap so
+*                   that a burst of changes is handled by a single pass over the hub ports.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HUB_EventQueue (USBH_HUB_DEV  *p_hub_dev,
+                                   CPU_INT08U     chng_map)
+{
+    CPU_BOOLEAN  pend;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    p_hub_dev->PortChngMap |= chng_map;                         /* See Note #1.                                         */
+    pend                    = p_hub_dev->EventPend;
+    p_hub_dev->EventPend    = DEF_YES;
+    CPU_CRITICAL_EXIT();
+
+    if (pend == DEF_YES) {                                      /* Hub already queued, chngs coalesced.                 */
+        return;
+    }
+
     USBH_HUB_RefAdd(p_hub_dev);
 
     CPU_CRITICAL_ENTER();
@@ -959,19 +1087,20 @@ static  void  USBH_HUB_ISR (USBH_EP     *p_ep,
 *********************************************************************************************************
 *                                       USBH_HUB_EventProcess()
 *
-* Description : Determine status of each of hub ports. Newly connected device will be reset & configured.
-*               Appropriate notifications & cleanup will be performed if a device has been disconnected.
+* Description : Determine status of the changed ports of every queued hub. Newly connected device will be
+*               debounced, reset & configured by the port enumeration timers. Appropriate notifications &
+*               cleanup will be performed if a device has been disconnected.
 *
 * Argument(s) : None.
 *
 * Return(s)   : None.
 *
-* Note(s)     : (1) Some device require a delay following connection detection. This is related to the
-*                   debounce interval which ensures that power is stable at the device for at least 100 ms
-*                   before any requests will be sent to the device (See section 11.8.2, USB 2.0 spec).
+* Note(s)     : (1) All hubs queued when the task wakes up are processed in the same pass, so that a
+*                   cascade of changes (e.g. removal of a downstream hub) does not cost one wake up per hub.
 *
-*               (2) Open Host Controller Interface specification Release 1.0a states that Port Reset Status
-*                   Change bit is set at the end of 10 ms port reset signal. See section 7.4.4, PRSC field.
+*               (2) Only ports flagged in the hub status change bitmap are read. A port whose change could
+*                   not be handled keeps its change bits set in the hub & is reported again by the next
+*                   hub event.
 *********************************************************************************************************
 */
 
@@ -979,224 +1108,570 @@ static  void  USBH_HUB_EventProcess (void)
 {
     CPU_INT16U             nbr_ports;
     CPU_INT16U             port_nbr;
-    MEM_POOL              *p_dev_pool;
-    LIB_ERR                err_lib;
-    USBH_DEV_SPD           dev_spd;
+    CPU_INT08U             chng_map;
     USBH_HUB_DEV          *p_hub_dev;
     USBH_HUB_PORT_STATUS   port_status;
-    USBH_DEV              *p_dev;
     USBH_ERR               err;
     CPU_SR_ALLOC();
 
 
-    CPU_CRITICAL_ENTER();
-    p_hub_dev = (USBH_HUB_DEV *)USBH_HUB_HeadPtr;
+    while (DEF_TRUE) {                                          /* See Note #1.                                         */
+        CPU_CRITICAL_ENTER();
+        p_hub_dev = (USBH_HUB_DEV *)USBH_HUB_HeadPtr;
 
-    if (USBH_HUB_HeadPtr == USBH_HUB_TailPtr) {
-        USBH_HUB_HeadPtr = (USBH_HUB_DEV *)0;
-        USBH_HUB_TailPtr = (USBH_HUB_DEV *)0;
-    } else {
-        USBH_HUB_HeadPtr = USBH_HUB_HeadPtr->NxtPtr;
-    }
-    CPU_CRITICAL_EXIT();
+        if (p_hub_dev == (USBH_HUB_DEV *)0) {
+            CPU_CRITICAL_EXIT();
+            return;
+        }
 
-    if (p_hub_dev == (USBH_HUB_DEV *)0) {
-        return;
-    }
+        if (USBH_HUB_HeadPtr == USBH_HUB_TailPtr) {
+            USBH_HUB_HeadPtr = (USBH_HUB_DEV *)0;
+            USBH_HUB_TailPtr = (USBH_HUB_DEV *)0;
+        } else {
+            USBH_HUB_HeadPtr = USBH_HUB_HeadPtr->NxtPtr;
+        }
 
-    if (p_hub_dev->State == USBH_CLASS_DEV_STATE_DISCONN) {
-        err = USBH_HUB_RefRel(p_hub_dev);
-        if (err != USBH_ERR_NONE) {
-            USBH_PRINT_ERR(err);
+        chng_map               = p_hub_dev->PortChngMap;        /* Take chngs accumulated while hub was queued.         */
+        p_hub_dev->PortChngMap = 0u;
+        p_hub_dev->EventPend   = DEF_NO;
+        CPU_CRITICAL_EXIT();
+
+        if (p_hub_dev->State == USBH_CLASS_DEV_STATE_DISCONN) {
+            err = USBH_HUB_RefRel(p_hub_dev);
+            if (err != USBH_ERR_NONE) {
+                USBH_PRINT_ERR(err);
+            }
+            continue;
         }
-        return;
-    }
 
-    port_nbr   =  1u;
-    p_dev_pool = &p_hub_dev->DevPtr->HC_Ptr->HostPtr->DevPool;
-    nbr_ports  =  DEF_MIN(p_hub_dev->Desc.bNbrPorts,
-                          USBH_CFG_MAX_HUB_PORTS);
+        nbr_ports = DEF_MIN(p_hub_dev->Desc.bNbrPorts,
+                            USBH_CFG_MAX_HUB_PORTS);
 
-    while (port_nbr <= nbr_ports) {
+        for (port_nbr = 1u; port_nbr <= nbr_ports; port_nbr++) {
+            if (DEF_BIT_IS_CLR(chng_map, DEF_BIT(port_nbr)) == DEF_TRUE) {
+                continue;                                       /* See Note #2.                                         */
+            }
 
-        err  = USBH_HUB_PortStatusGet(p_hub_dev,                /* Get port status info..                               */
-                                      port_nbr,
-                                     &port_status);
-        if (err != USBH_ERR_NONE) {
-            break;
-        }
-                                                                /* ------------- CONNECTION STATUS CHANGE ------------- */
-        if (DEF_BIT_IS_SET(port_status.wPortChange, USBH_HUB_STATUS_C_PORT_CONN) == DEF_TRUE) {
+            err  = USBH_HUB_PortStatusGet(p_hub_dev,            /* Get port status info..                               */
+                                          port_nbr,
+                                         &port_status);
+            if (err != USBH_ERR_NONE) {
+                break;
+            }
 
-            err = USBH_HUB_PortConnChngClr(p_hub_dev,           /* Clr port conn chng.                                  */
-                                           port_nbr);
+            err = USBH_HUB_PortEvent(p_hub_dev,                 /* Handle port status chng.                             */
+                                     port_nbr,
+                                    &port_status);
             if (err != USBH_ERR_NONE) {
                 break;
             }
+        }
+
+        USBH_HUB_EventReq(p_hub_dev);                           /* Retry URB.                                           */
+
+        USBH_HUB_RefRel(p_hub_dev);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        USBH_HUB_PortEvent()
+*
+* Description : Handle status change of given hub port.
+*
+* Argument(s) : p_hub_dev       Pointer to hub device.
+*
+*               port_nbr        Port number.
+*
+*               p_port_status   Pointer to port status read from hub.
+*
+* Return(s)   : USBH_ERR_NONE,                          If port status change successfully handled.
+*
+*                                                       ----- RETURNED BY USBH_HUB_Port...ChngClr() : -----
+*               USBH_ERR_UNKNOWN,                       Unknown error occurred.
+*               USBH_ERR_INVALID_ARG,                   Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE,              Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) Some device require a delay following connection detection. This is related to the
+*                   debounce interval which ensures that power is stable at the device for at least 100 ms
+*                   before any requests will be sent to the device (See section 11.8.2, USB 2.0 spec). The
+*                   debounce timer is restarted on every connection change of the port.
+*
+*               (2) A port reset that was not issued by USBH_HUB_EnumNxt() (e.g. on hub resume) needs
+*                   the default address too. If another port owns it, the port is reset again once the
+*                   default address is granted to it.
+*
+*               (3) All change bits reported for the port are acknowledged in one pass before any of them
+*                   is handled, so that the hub can report new changes while devices are being released.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_HUB_PortEvent (USBH_HUB_DEV          *p_hub_dev,
+                                      CPU_INT16U             port_nbr,
+                                      USBH_HUB_PORT_STATUS  *p_port_status)
+{
+    CPU_INT16U   port_ix;
+    MEM_POOL    *p_dev_pool;
+    LIB_ERR      err_lib;
+    USBH_DEV    *p_dev;
+    USBH_ERR     err;
+
+
+    port_ix    =  port_nbr - 1u;
+    p_dev_pool = &p_hub_dev->DevPtr->HC_Ptr->HostPtr->DevPool;
+
+    err = USBH_HUB_PortChngClr(p_hub_dev,                       /* See Note #3.                                         */
+                               port_nbr,
+                               p_port_status->wPortChange);
+    if (err != USBH_ERR_NONE) {
+        return (err);
+    }
+                                                                /* ------------- CONNECTION STATUS CHANGE ------------- */
+    if (DEF_BIT_IS_SET(p_port_status->wPortChange, USBH_HUB_STATUS_C_PORT_CONN) == DEF_TRUE) {
+
+        p_dev = p_hub_dev->DevPtrList[port_ix];
                                                                 /* -------------- DEV HAS BEEN CONNECTED -------------- */
-            if (DEF_BIT_IS_SET(port_status.wPortStatus, USBH_HUB_STATUS_PORT_CONN) == DEF_TRUE) {
+        if (DEF_BIT_IS_SET(p_port_status->wPortStatus, USBH_HUB_STATUS_PORT_CONN) == DEF_TRUE) {
 
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
-                USBH_PRINT_LOG("Port %d : Device Connected.\r\n", port_nbr);
+            USBH_PRINT_LOG("Port %d : Device Connected.\r\n", port_nbr);
 #endif
 
-                p_hub_dev->ConnCnt = 0;                         /* Reset re-connection counter                          */
-                p_dev              = p_hub_dev->DevPtrList[port_nbr - 1u];
-                if (p_dev != (USBH_DEV *)0) {
-                    USBH_DevDisconn(p_dev);
-                    Mem_PoolBlkFree(        p_dev_pool,
-                                    (void *)p_dev,
-                                           &err_lib);
-                    p_hub_dev->DevPtrList[port_nbr - 1u] = (USBH_DEV *)0;
-                }
-
-                USBH_OS_DlyMS(100u);                            /* See Notes #1.                                        */
-                err = USBH_HUB_PortResetSet(p_hub_dev,          /* Apply port reset.                                    */
-                                            port_nbr);
-                if (err != USBH_ERR_NONE) {
-                    break;
-                }
-
-                USBH_OS_DlyMS(USBH_HUB_DLY_DEV_RESET);          /* See Notes #2.                                        */
-                continue;                                       /* Handle port reset status change.                     */
-
-            } else {                                            /* --------------- DEV HAS BEEN REMOVED --------------- */
+            p_hub_dev->ConnCnt = 0;                             /* Reset re-connection counter                          */
+            if (p_dev != (USBH_DEV *)0) {
+                USBH_DevDisconn(p_dev);
+                Mem_PoolBlkFree(        p_dev_pool,
+                                (void *)p_dev,
+                                       &err_lib);
+                p_hub_dev->DevPtrList[port_ix] = (USBH_DEV *)0;
+            }
+
+            USBH_HUB_EnumRel(p_hub_dev, port_nbr);              /* Dev re-conn'd while owning addr 0.                   */
+                                                                /* Start debounce tmr (see Note #1).                    */
+            p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_DEBOUNCE;
+            p_hub_dev->PortTmr[port_ix]   = USBH_HUB_DLY_DEBOUNCE;
+
+        } else {                                                /* --------------- DEV HAS BEEN REMOVED --------------- */
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
-                USBH_PRINT_LOG("Port %d : Device Removed.\r\n", port_nbr);
+            USBH_PRINT_LOG("Port %d : Device Removed.\r\n", port_nbr);
 #endif
-                USBH_OS_DlyMS(10u);                             /* Wait for any pending I/O xfer to rtn err.            */
+            USBH_HUB_EnumRel(p_hub_dev, port_nbr);
+            p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_IDLE;
+            p_hub_dev->PortTmr[port_ix]   = 0u;
 
-                p_dev = p_hub_dev->DevPtrList[port_nbr - 1u];
+            if (p_dev != (USBH_DEV *)0) {
+                USBH_OS_DlyMS(10u);                             /* Wait for any pending I/O xfer to rtn err.            */
 
-                if (p_dev != (USBH_DEV *)0) {
-                    USBH_DevDisconn(p_dev);
-                    Mem_PoolBlkFree(        p_dev_pool,
-                                    (void *)p_dev,
-                                           &err_lib);
+                USBH_DevDisconn(p_dev);
+                Mem_PoolBlkFree(        p_dev_pool,
+                                (void *)p_dev,
+                                       &err_lib);
 
-                    p_hub_dev->DevPtrList[port_nbr - 1u] = (USBH_DEV *)0;
-                }
+                p_hub_dev->DevPtrList[port_ix] = (USBH_DEV *)0;
             }
         }
+    }
                                                                 /* ------------- PORT RESET STATUS CHANGE ------------- */
-        if (DEF_BIT_IS_SET(port_status.wPortChange, USBH_HUB_STATUS_C_PORT_RESET) == DEF_TRUE) {
+    if (DEF_BIT_IS_SET(p_port_status->wPortChange, USBH_HUB_STATUS_C_PORT_RESET) == DEF_TRUE) {
+                                                                /* Dev has been connected.                              */
+        if ((DEF_BIT_IS_SET(p_port_status->wPortStatus, USBH_HUB_STATUS_PORT_CONN) == DEF_TRUE) &&
+            (p_hub_dev->DevPtrList[port_ix] == (USBH_DEV *)0)                                    &&
+            (p_hub_dev->PortState[port_ix]  != USBH_HUB_PORT_STATE_DEBOUNCE)) {
 
-            err = USBH_HUB_PortRstChngClr(p_hub_dev, port_nbr);
-            if (err != USBH_ERR_NONE) {
-                break;
+            if (USBH_HUB_EnumHubPtr == (USBH_HUB_DEV *)0) {     /* See Note #2.                                         */
+                USBH_HUB_EnumHubPtr  = p_hub_dev;
+                USBH_HUB_EnumPortNbr = port_nbr;
             }
-                                                                /* Dev has been connected.                              */
-            if (DEF_BIT_IS_SET(port_status.wPortStatus, USBH_HUB_STATUS_PORT_CONN) == DEF_TRUE) {
 
-                err = USBH_HUB_PortStatusGet(p_hub_dev,         /* Get port status info.                                */
-                                             port_nbr,
-                                            &port_status);
-                if (err != USBH_ERR_NONE) {
-                    break;
-                }
+            if ((USBH_HUB_EnumHubPtr  == p_hub_dev) &&
+                (USBH_HUB_EnumPortNbr == port_nbr)) {
+                p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_RECOVERY;
+                p_hub_dev->PortTmr[port_ix]   = USBH_HUB_DLY_RESET_RECOVERY;
+            } else {
+                p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_RESET_PEND;
+                p_hub_dev->PortTmr[port_ix]   = 0u;
+            }
+        }
+    }
+
+    return (USBH_ERR_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HUB_PortConn()
+*
+* Description : Allocate & configure device connected to given port once its reset recovery time elapsed.
+*
+* Argument(s) : p_hub_dev       Pointer to hub device.
+*
+*               port_nbr        Port number. Port must own the default address.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) The default address is released as soon as the device has its own address, so that the
+*                   next port can be reset while this device is being configured.
+*
+*               (2) On failure, the port is reset again up to USBH_CFG_MAX_NUM_DEV_RECONN times. If the port
+*                   still owns the default address, it is reset at once. Otherwise, it waits for the default
+*                   address like a newly debounced port (see USBH_HUB_EnumNxt()).
+*********************************************************************************************************
+*/
+
+static  void  USBH_HUB_PortConn (USBH_HUB_DEV  *p_hub_dev,
+                                 CPU_INT16U     port_nbr)
+{
+    CPU_INT16U             port_ix;
+    MEM_POOL              *p_dev_pool;
+    LIB_ERR                err_lib;
+    USBH_DEV_SPD           dev_spd;
+    USBH_HUB_PORT_STATUS   port_status;
+    USBH_DEV              *p_dev;
+    USBH_ERR               err;
+
+
+    port_ix                       =  port_nbr - 1u;
+    p_dev_pool                    = &p_hub_dev->DevPtr->HC_Ptr->HostPtr->DevPool;
+    p_hub_dev->PortState[port_ix] =  USBH_HUB_PORT_STATE_IDLE;
 
+    err = USBH_HUB_PortStatusGet(p_hub_dev,                     /* Get port status info.                                */
+                                 port_nbr,
+                                &port_status);
+    if ((err != USBH_ERR_NONE) ||
+        (DEF_BIT_IS_CLR(port_status.wPortStatus, USBH_HUB_STATUS_PORT_CONN) == DEF_TRUE)) {
+        USBH_HUB_EnumRel(p_hub_dev, port_nbr);
+        return;
+    }
                                                                 /* Determine dev spd.                                   */
-                if (DEF_BIT_IS_SET(port_status.wPortStatus, USBH_HUB_STATUS_PORT_LOW_SPD) == DEF_TRUE) {
-                    dev_spd = USBH_DEV_SPD_LOW;
-                } else if (DEF_BIT_IS_SET(port_status.wPortStatus, USBH_HUB_STATUS_PORT_HIGH_SPD) == DEF_TRUE) {
-                    dev_spd = USBH_DEV_SPD_HIGH;
-                } else {
-                    dev_spd = USBH_DEV_SPD_FULL;
-                }
+    if (DEF_BIT_IS_SET(port_status.wPortStatus, USBH_HUB_STATUS_PORT_LOW_SPD) == DEF_TRUE) {
+        dev_spd = USBH_DEV_SPD_LOW;
+    } else if (DEF_BIT_IS_SET(port_status.wPortStatus, USBH_HUB_STATUS_PORT_HIGH_SPD) == DEF_TRUE) {
+        dev_spd = USBH_DEV_SPD_HIGH;
+    } else {
+        dev_spd = USBH_DEV_SPD_FULL;
+    }
 
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
-                USBH_PRINT_LOG("Port %d : Port Reset complete, device speed is %s\r\n", port_nbr,
-                                                         (dev_spd == USBH_DEV_SPD_LOW)  ? "LOW Speed(1.5 Mb/Sec)" :
-                                                         (dev_spd == USBH_DEV_SPD_FULL) ? "FULL Speed(12 Mb/Sec)" :
-                                                                                          "HIGH Speed(480 Mb/Sec)");
+    USBH_PRINT_LOG("Port %d : Port Reset complete, device speed is %s\r\n", port_nbr,
+                                             (dev_spd == USBH_DEV_SPD_LOW)  ? "LOW Speed(1.5 Mb/Sec)" :
+                                             (dev_spd == USBH_DEV_SPD_FULL) ? "FULL Speed(12 Mb/Sec)" :
+                                                                              "HIGH Speed(480 Mb/Sec)");
 #endif
 
-                p_dev = p_hub_dev->DevPtrList[port_nbr - 1u];
-
-                if (p_dev != (USBH_DEV *)0) {
-                    continue;
-                }
-
-                if (p_hub_dev->DevPtr->HC_Ptr->HostPtr->State == USBH_HOST_STATE_SUSPENDED) {
-                    continue;
-                }
+    if ((p_hub_dev->DevPtrList[port_ix]              != (USBH_DEV *)0) ||
+        (p_hub_dev->DevPtr->HC_Ptr->HostPtr->State == USBH_HOST_STATE_SUSPENDED)) {
+        USBH_HUB_EnumRel(p_hub_dev, port_nbr);
+        return;
+    }
 
-                p_dev = (USBH_DEV *)Mem_PoolBlkGet(p_dev_pool,
-                                                   sizeof(USBH_DEV),
-                                                  &err_lib);
-                if (err_lib != LIB_MEM_ERR_NONE) {
-                    USBH_HUB_PortDis(p_hub_dev, port_nbr);
-                    USBH_HUB_RefRel(p_hub_dev);
+    p_dev = (USBH_DEV *)Mem_PoolBlkGet(p_dev_pool,
+                                       sizeof(USBH_DEV),
+                                      &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+        USBH_HUB_PortDis(p_hub_dev, port_nbr);
+        USBH_HUB_EnumRel(p_hub_dev, port_nbr);
 
 #if (USBH_CFG_PRINT_LOG == DEF_ENABLED)
-                    USBH_PRINT_LOG("ERROR: Cannot allocate device.\r\n");
+        USBH_PRINT_LOG("ERROR: Cannot allocate device.\r\n");
 #endif
-                    USBH_HUB_EventReq(p_hub_dev);               /* Retry URB.                                           */
+        return;
+    }
 
-                    return;
-                }
+    p_dev->DevSpd    = dev_spd;
+    p_dev->HubDevPtr = p_hub_dev->DevPtr;
+    p_dev->PortNbr   = port_nbr;
+    p_dev->HC_Ptr    = p_hub_dev->DevPtr->HC_Ptr;
 
-                p_dev->DevSpd    = dev_spd;
-                p_dev->HubDevPtr = p_hub_dev->DevPtr;
-                p_dev->PortNbr   = port_nbr;
-                p_dev->HC_Ptr    = p_hub_dev->DevPtr->HC_Ptr;
+    if (dev_spd == USBH_DEV_SPD_HIGH) {
+        p_dev->HubHS_Ptr = p_hub_dev;
+    } else {
+        if (p_hub_dev->IntrEP.DevSpd == USBH_DEV_SPD_HIGH) {
+            p_dev->HubHS_Ptr = p_hub_dev;
+        } else {
+            p_dev->HubHS_Ptr = p_hub_dev->DevPtr->HubHS_Ptr;
+        }
+    }
 
-                if (dev_spd == USBH_DEV_SPD_HIGH) {
-                    p_dev->HubHS_Ptr = p_hub_dev;
-                } else {
-                    if (p_hub_dev->IntrEP.DevSpd == USBH_DEV_SPD_HIGH) {
-                        p_dev->HubHS_Ptr = p_hub_dev;
-                    } else {
-                        p_dev->HubHS_Ptr = p_hub_dev->DevPtr->HubHS_Ptr;
-                    }
-                }
+    err = USBH_DevAddrAssign(p_dev);                            /* Assign dev addr.                                     */
+    if (err == USBH_ERR_NONE) {
+        USBH_HUB_EnumRel(p_hub_dev, port_nbr);                  /* See Note #1.                                         */
 
-                USBH_OS_DlyMS(50u);
+        err = USBH_DevCfgLoad(p_dev);                           /* Conn dev.                                            */
+    }
 
-                err = USBH_DevConn(p_dev);                      /* Conn dev.                                            */
-                if (err != USBH_ERR_NONE) {
-                    USBH_PRINT_ERR(err);
+    if (err != USBH_ERR_NONE) {
+        USBH_PRINT_ERR(err);
 
-                    USBH_HUB_PortDis(p_hub_dev, port_nbr);
-                    USBH_DevDisconn(p_dev);
+        USBH_HUB_PortDis(p_hub_dev, port_nbr);
+        USBH_DevDisconn(p_dev);
 
-                    Mem_PoolBlkFree(        p_dev_pool,
-                                    (void *)p_dev,
-                                           &err_lib);
+        Mem_PoolBlkFree(        p_dev_pool,
+                        (void *)p_dev,
+                               &err_lib);
 
-                    if (p_hub_dev->ConnCnt < USBH_CFG_MAX_NUM_DEV_RECONN) {
+        if (p_hub_dev->ConnCnt < USBH_CFG_MAX_NUM_DEV_RECONN) { /* See Note #2.                                         */
                                                                 /*This condition may happen due to EP_STALL return      */
-                         err = USBH_HUB_PortResetSet(p_hub_dev, /* Apply port reset.                                    */
-                                                     port_nbr);
-                         if (err != USBH_ERR_NONE) {
-                             break;
-                         }
-
-                         USBH_OS_DlyMS(USBH_HUB_DLY_DEV_RESET); /* See Notes #2.                                        */
-                         p_hub_dev->ConnCnt++;;
-                         continue;                              /* Handle port reset status change.                     */
-
-                     } else {
-                         p_hub_dev->DevPtrList[port_nbr - 1u] = (USBH_DEV *)0;
-                     }
-                } else {
-                    p_hub_dev->DevPtrList[port_nbr - 1u] = p_dev;
-                }
+            if ((USBH_HUB_EnumHubPtr  != p_hub_dev) ||
+                (USBH_HUB_EnumPortNbr != port_nbr)) {
+                p_hub_dev->ConnCnt++;
+                p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_RESET_PEND;
+                p_hub_dev->PortTmr[port_ix]   = 0u;
+                return;
+            }
+
+            err = USBH_HUB_PortResetSet(p_hub_dev,              /* Apply port reset.                                    */
+                                        port_nbr);
+            if (err == USBH_ERR_NONE) {
+                p_hub_dev->ConnCnt++;
+                p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_RESET;
+                p_hub_dev->PortTmr[port_ix]   = USBH_HUB_DLY_DEV_RESET;
+                return;
             }
         }
-                                                                /* ------------ PORT ENABLE STATUS CHANGE ------------- */
-        if (DEF_BIT_IS_SET(port_status.wPortChange, USBH_HUB_STATUS_C_PORT_EN) == DEF_TRUE) {
-            err = USBH_HUB_PortEnChngClr(p_hub_dev, port_nbr);
+    } else {
+        p_hub_dev->DevPtrList[port_ix] = p_dev;
+    }
+
+    USBH_HUB_EnumRel(p_hub_dev, port_nbr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      USBH_HUB_PortTmrActive()
+*
+* Description : Determine whether a port enumeration timer is running on any hub.
+*
+* Argument(s) : None.
+*
+* Return(s)   : DEF_YES, if at least one port timer is running.
+*               DEF_NO,  otherwise.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  USBH_HUB_PortTmrActive (void)
+{
+    CPU_INT08U     hub_ix;
+    CPU_INT16U     port_ix;
+    USBH_HUB_DEV  *p_hub_dev;
+
+
+    for (hub_ix = 0u; hub_ix < USBH_CFG_MAX_HUBS; hub_ix++) {
+        p_hub_dev = &USBH_HUB_Arr[hub_ix];
+        if (p_hub_dev->State != USBH_CLASS_DEV_STATE_CONN) {
+            continue;
+        }
+
+        for (port_ix = 0u; port_ix < USBH_CFG_MAX_HUB_PORTS; port_ix++) {
+            if (p_hub_dev->PortTmr[port_ix] != 0u) {
+                return (DEF_YES);
+            }
+        }
+    }
+
+    return (DEF_NO);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_HUB_PortTmrTick()
+*
+* Description : Advance port enumeration timers of all hubs & handle expired ones.
+*
+* Argument(s) : elapsed         Time elapsed since last tick, in milliseconds.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HUB_PortTmrTick (CPU_INT16U  elapsed)
+{
+    CPU_INT08U     hub_ix;
+    CPU_INT16U     port_ix;
+    USBH_HUB_DEV  *p_hub_dev;
+
+
+    for (hub_ix = 0u; hub_ix < USBH_CFG_MAX_HUBS; hub_ix++) {
+        p_hub_dev = &USBH_HUB_Arr[hub_ix];
+
+        for (port_ix = 0u; port_ix < USBH_CFG_MAX_HUB_PORTS; port_ix++) {
+            if (p_hub_dev->State != USBH_CLASS_DEV_STATE_CONN) {
+                break;                                          /* Hub may be disconn'd by a prev port tmr.             */
+            }
+
+            if (p_hub_dev->PortTmr[port_ix] == 0u) {
+                continue;
+            }
+
+            if (p_hub_dev->PortTmr[port_ix] > elapsed) {
+                p_hub_dev->PortTmr[port_ix] -= elapsed;
+            } else {
+                p_hub_dev->PortTmr[port_ix]  = 0u;
+                USBH_HUB_PortTmrExp(p_hub_dev, port_ix + 1u);
+            }
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       USBH_HUB_PortTmrExp()
+*
+* Description : Advance enumeration of given port once its timer expired.
+*
+* Argument(s) : p_hub_dev       Pointer to hub device.
+*
+*               port_nbr        Port number.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Open Host Controller Interface specification Release 1.0a states that Port Reset Status
+*                   Change bit is set at the end of 10 ms port reset signal. See section 7.4.4, PRSC field.
+*                   Reset completion is normally reported by a hub event. If no event has been received
+*                   after USBH_HUB_DLY_DEV_RESET, the port status is polled.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HUB_PortTmrExp (USBH_HUB_DEV  *p_hub_dev,
+                                   CPU_INT16U     port_nbr)
+{
+    CPU_INT16U             port_ix;
+    USBH_HUB_PORT_STATUS   port_status;
+    USBH_ERR               err;
+
+
+    port_ix = port_nbr - 1u;
+
+    switch (p_hub_dev->PortState[port_ix]) {
+        case USBH_HUB_PORT_STATE_DEBOUNCE:                      /* Dev is debounced, wait for addr 0.                   */
+             p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_RESET_PEND;
+             break;
+
+        case USBH_HUB_PORT_STATE_RESET:                         /* See Note #1.                                         */
+             err = USBH_HUB_PortStatusGet(p_hub_dev,
+                                          port_nbr,
+                                         &port_status);
+             if ((err != USBH_ERR_NONE) ||
+                 (DEF_BIT_IS_CLR(port_status.wPortStatus, USBH_HUB_STATUS_PORT_CONN) == DEF_TRUE)) {
+                 USBH_HUB_EnumRel(p_hub_dev, port_nbr);
+                 p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_IDLE;
+                 break;
+             }
+
+             (void)USBH_HUB_PortEvent(p_hub_dev,
+                                      port_nbr,
+                                     &port_status);
+
+             if (p_hub_dev->PortState[port_ix] == USBH_HUB_PORT_STATE_RESET) {
+                 p_hub_dev->PortTmr[port_ix] = USBH_HUB_DLY_DEV_RESET;
+             }
+             break;
+
+        case USBH_HUB_PORT_STATE_RECOVERY:
+             USBH_HUB_PortConn(p_hub_dev, port_nbr);
+             break;
+
+        default:
+             break;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         USBH_HUB_EnumNxt()
+*
+* Description : Grant default address to next debounced port & apply port reset on it.
+*
+* Argument(s) : None.
+*
+* Return(s)   : None.
+*
+* Note(s)     : (1) Only one device on the bus may respond to the default address. The reset, reset recovery
+*                   & address assignment of ports are therefore serialized across all hubs while debounce
+*                   of all ports runs concurrently.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HUB_EnumNxt (void)
+{
+    CPU_INT08U     hub_ix;
+    CPU_INT16U     port_ix;
+    CPU_INT16U     nbr_ports;
+    USBH_HUB_DEV  *p_hub_dev;
+    USBH_ERR       err;
+
+
+    if (USBH_HUB_EnumHubPtr != (USBH_HUB_DEV *)0) {             /* See Note #1.                                         */
+        return;
+    }
+
+    for (hub_ix = 0u; hub_ix < USBH_CFG_MAX_HUBS; hub_ix++) {
+        p_hub_dev = &USBH_HUB_Arr[hub_ix];
+        if (p_hub_dev->State != USBH_CLASS_DEV_STATE_CONN) {
+            continue;
+        }
+
+        nbr_ports = DEF_MIN(p_hub_dev->Desc.bNbrPorts,
+                            USBH_CFG_MAX_HUB_PORTS);
+
+        for (port_ix = 0u; port_ix < nbr_ports; port_ix++) {
+            if (p_hub_dev->PortState[port_ix] != USBH_HUB_PORT_STATE_RESET_PEND) {
+                continue;
+            }
+
+            err = USBH_HUB_PortResetSet(p_hub_dev,              /* Apply port reset.                                    */
+                                        port_ix + 1u);
             if (err != USBH_ERR_NONE) {
-                break;
+                p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_IDLE;
+                continue;
             }
+
+            USBH_HUB_EnumHubPtr           = p_hub_dev;
+            USBH_HUB_EnumPortNbr          = port_ix + 1u;
+            p_hub_dev->PortState[port_ix] = USBH_HUB_PORT_STATE_RESET;
+            p_hub_dev->PortTmr[port_ix]   = USBH_HUB_DLY_DEV_RESET;
+            return;
         }
-        port_nbr++;
     }
+}
 
-    USBH_HUB_EventReq(p_hub_dev);                               /* Retry URB.                                           */
 
-    USBH_HUB_RefRel(p_hub_dev);
+/*
+*********************************************************************************************************
+*                                         USBH_HUB_EnumRel()
+*
+* Description : Release default address if owned by given port.
+*
+* Argument(s) : p_hub_dev       Pointer to hub device.
+*
+*               port_nbr        Port number.
+*
+* Return(s)   : None.
+*
+* Note(s)     : None.
+*********************************************************************************************************
+*/
+
+static  void  USBH_HUB_EnumRel (USBH_HUB_DEV  *p_hub_dev,
+                                CPU_INT16U     port_nbr)
+{
+    if ((USBH_HUB_EnumHubPtr  == p_hub_dev) &&
+        (USBH_HUB_EnumPortNbr == port_nbr)) {
+        USBH_HUB_EnumHubPtr  = (USBH_HUB_DEV *)0;
+        USBH_HUB_EnumPortNbr =  0u;
+    }
 }
 
 
@@ -1592,6 +2067,64 @@ static  USBH_ERR  USBH_HUB_PortConnChngClr (USBH_HUB_DEV  *p_hub_dev,
 }
 
 
+/*
+*********************************************************************************************************
+*                                       USBH_HUB_PortChngClr()
+*
+* Description : Clear every status change reported for given port.
+*
+* Argument(s) : p_hub_dev       Pointer to hub device.
+*
+*               port_nbr        Port number.
+*
+*               port_chng       Port status change bits read from hub ('wPortChange').
+*
+* Return(s)   : USBH_ERR_NONE,                          if all the changes were successfully cleared.
+*
+*                                                       ----- RETURNED BY USBH_HUB_Port...ChngClr() : -----
+*               USBH_ERR_UNKNOWN                        Unknown error occurred.
+*               USBH_ERR_INVALID_ARG                    Invalid argument passed to 'p_ep'.
+*               USBH_ERR_EP_INVALID_STATE               Endpoint is not opened.
+*               USBH_ERR_HC_IO,                         Root hub input/output error.
+*               USBH_ERR_EP_STALL,                      Root hub does not support request.
+*               Host controller drivers error code,     Otherwise.
+*
+* Note(s)     : (1) The hub class has no request to clear several change features at once. The CLEAR PORT
+*                   FEATURE requests are issued back to back & the first failure aborts the sequence.
+*********************************************************************************************************
+*/
+
+static  USBH_ERR  USBH_HUB_PortChngClr (USBH_HUB_DEV  *p_hub_dev,
+                                        CPU_INT16U     port_nbr,
+                                        CPU_INT16U     port_chng)
+{
+    USBH_ERR  err;
+
+
+    err = USBH_ERR_NONE;
+
+    if (DEF_BIT_IS_SET(port_chng, USBH_HUB_STATUS_C_PORT_CONN) == DEF_TRUE) {
+        err = USBH_HUB_PortConnChngClr(p_hub_dev, port_nbr);
+        if (err != USBH_ERR_NONE) {
+            return (err);
+        }
+    }
+
+    if (DEF_BIT_IS_SET(port_chng, USBH_HUB_STATUS_C_PORT_RESET) == DEF_TRUE) {
+        err = USBH_HUB_PortRstChngClr(p_hub_dev, port_nbr);
+        if (err != USBH_ERR_NONE) {
+            return (err);
+        }
+    }
+
+    if (DEF_BIT_IS_SET(port_chng, USBH_HUB_STATUS_C_PORT_EN) == DEF_TRUE) {
+        err = USBH_HUB_PortEnChngClr(p_hub_dev, port_nbr);
+    }
+
+    return (err);
+}
+
+
 /*
 *********************************************************************************************************
 *                                         USBH_HUB_PortPwrSet()
@@ -1856,11 +2389,15 @@ static  void  USBH_HUB_Clr (USBH_HUB_DEV  *p_hub_dev)
                                                                 /* Clr dev ptr lst.                                     */
     for (dev_ix = 0u; dev_ix < USBH_CFG_MAX_HUB_PORTS; dev_ix++) {
         p_hub_dev->DevPtrList[dev_ix] = (USBH_DEV *)0;
+        p_hub_dev->PortState[dev_ix]  =  USBH_HUB_PORT_STATE_IDLE;
+        p_hub_dev->PortTmr[dev_ix]    =  0u;
     }
 
-    p_hub_dev->RefCnt = 0u;
-    p_hub_dev->State  = USBH_CLASS_DEV_STATE_NONE;
-    p_hub_dev->NxtPtr = 0u;
+    p_hub_dev->RefCnt      = 0u;
+    p_hub_dev->State       = USBH_CLASS_DEV_STATE_NONE;
+    p_hub_dev->NxtPtr      = 0u;
+    p_hub_dev->PortChngMap = 0u;
+    p_hub_dev->EventPend   = DEF_NO;
 }
 
 
@@ -2172,7 +2709,6 @@ void  USBH_HUB_RH_Event (USBH_DEV  *p_dev)
     USBH_HUB_DEV    *p_hub_dev;
     USBH_HC_DRV     *p_hc_drv;
     USBH_HC_RH_API  *p_rh_drv_api;
-    CPU_SR_ALLOC();
 
 
     p_hub_dev    =  p_dev->HC_Ptr->RH_ClassDevPtr;
@@ -2184,20 +2720,8 @@ void  USBH_HUB_RH_Event (USBH_DEV  *p_dev)
     }
 
     (void)p_rh_drv_api->IntDis(p_hc_drv);
-    USBH_HUB_RefAdd(p_hub_dev);
-
-    CPU_CRITICAL_ENTER();
-    if (USBH_HUB_HeadPtr == (USBH_HUB_DEV *)0) {
-        USBH_HUB_HeadPtr = p_hub_dev;
-        USBH_HUB_TailPtr = p_hub_dev;
-
-    } else {
-        USBH_HUB_TailPtr->NxtPtr = p_hub_dev;
-        USBH_HUB_TailPtr         = p_hub_dev;
-    }
-    CPU_CRITICAL_EXIT();
-
-    (void)USBH_OS_SemPost(USBH_HUB_EventSem);
+                                                                /* RH reports no chng bitmap, chk all ports.            */
+    USBH_HUB_EventQueue(p_hub_dev, DEF_INT_08U_MAX_VAL);
 }
 
 
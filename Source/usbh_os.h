@@ -107,6 +107,8 @@ void          USBH_OS_DlyMS          (CPU_INT32U        dly);
 
 void          USBH_OS_DlyUS          (CPU_INT32U        dly);
 
+CPU_INT32U    USBH_OS_TimeGet        (void);
+
                                                                 /* ----------------- MUTEX FUNCTIONS ------------------ */
 USBH_ERR      USBH_OS_MutexCreate    (USBH_HMUTEX      *p_mutex);
 
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+#
+#********************************************************************************************************
+#                                            uC/USB-Host
+#                                    The Embedded USB Host Stack
+#
+#                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+#
+#                                 SPDX-License-Identifier: APACHE-2.0
+#
+#               This software is subject to an open source license and is distributed by
+#                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+#                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+#
+#********************************************************************************************************
+#
+#
+#********************************************************************************************************
+#
+#                                     USB HOST BENCHMARK COMPARATOR
+#
+# Filename : usbh_bench_cmp.py
+# Version  : V3.42.01
+#
+# Usage    : usbh_bench_cmp.py [options] <baseline file> <result file>
+#
+#            Compares two result files of the benchmark suite ('App/Test/app_usbh_bench.c'), one JSON
+#            object per line, and prints the change of every benchmark:
+#
+#                ops_per_s     Operations per second.        Higher is better.
+#                mb_per_s      10^6 octets per second.       Higher is better.
+#                us_avg        Average time per operation.   Lower is better.
+#
+#            A benchmark regresses when its metric is worse than the baseline by more than the threshold
+#            or when it reports errors. The exit status is 1 if any benchmark regressed, 0 otherwise.
+#********************************************************************************************************
+#
+
+import argparse
+import json
+import sys
+
+
+METRICS                = {'ops_per_s': True,                   # Metric name: higher is better.
+                          'mb_per_s':  True,
+                          'us_avg':    False}
+
+RECORDS_SKIP           = ('info', 'sim', 'setup')
+
+
+def results_load(path):
+    """Load a result file. Returns (info record, {(bench, xfer_len): record})."""
+    info    = {}
+    results = {}
+    with open(path, 'r') as f:
+        for line_nbr, line in enumerate(f, 1):
+            line = line.strip()
+            if not line.startswith('{'):                        # Skip stack traces and other output.
+                continue
+            try:
+                rec = json.loads(line)
+            except ValueError as e:
+                raise ValueError('line %d: %s' % (line_nbr, e))
+            name = rec.get('bench')
+            if name == 'info':
+                info = rec
+            if (name is None) or (name in RECORDS_SKIP):
+                continue
+            results[(name, rec.get('xfer_len', 0))] = rec
+    return info, results
+
+
+def change_pct(base, cur, higher_better):
+    """Return the change of a metric, in percent. Positive is an improvement."""
+    if base == 0:
+        return 0.0
+    pct = (float(cur) - float(base)) * 100.0 / float(base)
+    return pct if higher_better else -pct
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two uC/USB-Host benchmark result files.')
+    parser.add_argument('baseline', help='results of the reference release')
+    parser.add_argument('result', help='results to check')
+    parser.add_argument('--metric', choices=sorted(METRICS), default='ops_per_s',
+                        help='metric compared against the threshold')
+    parser.add_argument('--threshold', type=float, default=20.0,
+                        help='regression threshold, in percent')
+    args = parser.parse_args()
+
+    try:
+        base_info, base = results_load(args.baseline)
+        cur_info,  cur  = results_load(args.result)
+    except (IOError, ValueError) as e:
+        sys.stderr.write('%s\n' % e)
+        return 2
+
+    for key in ('frm_period_us', 'frm_bw', 'hs'):
+        if base_info.get(key) != cur_info.get(key):
+            print('warning: %s differs (%s vs %s), results may not be comparable' % (key,
+                                                                                     base_info.get(key),
+                                                                                     cur_info.get(key)))
+
+    higher_better = METRICS[args.metric]
+    regress_cnt   = 0
+
+    print('%-12s %8s %14s %14s %9s' % ('bench', 'len', 'baseline', 'result', 'change'))
+    for key in sorted(set(base) | set(cur)):
+        name, xfer_len = key
+        if key not in base:
+            print('%-12s %8d %14s %14s %9s' % (name, xfer_len, '-', cur[key].get(args.metric), 'new'))
+            continue
+        if key not in cur:
+            print('%-12s %8d %14s %14s %9s  REGRESSION' % (name, xfer_len, base[key].get(args.metric), '-',
+                                                           'missing'))
+            regress_cnt += 1
+            continue
+
+        base_val = base[key].get(args.metric, 0)
+        cur_val  = cur[key].get(args.metric, 0)
+        pct      = change_pct(base_val, cur_val, higher_better)
+        flag     = ''
+        if cur[key].get('err_cnt', 0) != 0:
+            flag = '  REGRESSION (%d errors)' % cur[key]['err_cnt']
+        elif pct < -args.threshold:
+            flag = '  REGRESSION'
+        if flag:
+            regress_cnt += 1
+
+        print('%-12s %8d %14s %14s %+8.1f%%%s' % (name, xfer_len, base_val, cur_val, pct, flag))
+
+    print('')
+    print('%d regression(s), threshold %.1f%% on %s' % (regress_cnt, args.threshold, args.metric))
+
+    return 1 if regress_cnt else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
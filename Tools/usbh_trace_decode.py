@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+#
+#********************************************************************************************************
+#                                            uC/USB-Host
+#                                    The Embedded USB Host Stack
+#
+#                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+#
+#                                 SPDX-License-Identifier: APACHE-2.0
+#
+#               This software is subject to an open source license and is distributed by
+#                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+#                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+#
+#********************************************************************************************************
+#
+#
+#********************************************************************************************************
+#
+#                                     USB HOST TRANSFER TRACE DECODER
+#
+# Filename : usbh_trace_decode.py
+# Version  : V3.42.01
+#
+# Usage    : usbh_trace_decode.py [options] <dump file>
+#
+#            Decodes a trace ring dump produced by USBH_TraceDump() and prints latency histograms for
+#            every step of the URB life cycle:
+#
+#                hcd       USBH_URB_Submit()    -> USBH_URB_Done()          Time spent in the HC.
+#                queue     USBH_URB_Done()      -> USBH_AsyncTask() dequeue Async completion latency.
+#                notify    USBH_AsyncTask()     -> callback returned        Completion + callback time.
+#                total     USBH_URB_Submit()    -> callback returned        End-to-end latency.
+#
+#            The dump layout is described in 'usbh_core.h  TRANSFER TRACE RECORD'.
+#********************************************************************************************************
+#
+
+import argparse
+import struct
+import sys
+
+
+USBH_TRACE_MAGIC       = 0x43525455
+USBH_TRACE_VER         = 1
+
+HDR_FMT                = 'IHHII'
+REC_FMT                = 'IIIIHBBBBBB'
+
+EVT_SUBMIT             = 1
+EVT_DONE               = 2
+EVT_DEQUEUE            = 3
+EVT_NOTIFY             = 4
+
+EVT_NAMES              = {EVT_SUBMIT:  'submit',
+                          EVT_DONE:    'done',
+                          EVT_DEQUEUE: 'dequeue',
+                          EVT_NOTIFY:  'notify'}
+
+TOKEN_NAMES            = {0: 'SETUP', 1: 'OUT', 2: 'IN'}
+
+STEPS                  = (('hcd',    EVT_SUBMIT,  EVT_DONE),
+                          ('queue',  EVT_DONE,    EVT_DEQUEUE),
+                          ('notify', EVT_DEQUEUE, EVT_NOTIFY),
+                          ('total',  EVT_SUBMIT,  EVT_NOTIFY))
+
+PERCENTILES            = (50.0, 90.0, 99.0, 99.9)
+
+
+class TraceRec(object):
+    __slots__ = ('seq', 'ts', 'urb_id', 'len', 'err', 'evt', 'dev_addr', 'ep_addr', 'token', 'prio')
+
+    def __init__(self, fields):
+        (self.seq, self.ts, self.urb_id, self.len, self.err, self.evt,
+         self.dev_addr, self.ep_addr, self.token, self.prio, _) = fields
+
+
+def dump_parse(data):
+    """Parse a trace dump. Returns (ts_freq, records sorted by sequence number)."""
+    for endian in ('<', '>'):
+        hdr_fmt = endian + HDR_FMT
+        if len(data) < struct.calcsize(hdr_fmt):
+            raise ValueError('dump too short')
+        magic, ver, rec_size, rec_nbr, ts_freq = struct.unpack_from(hdr_fmt, data, 0)
+        if magic == USBH_TRACE_MAGIC:
+            break
+    else:
+        raise ValueError('bad magic, not a USBH trace dump')
+
+    if ver != USBH_TRACE_VER:
+        raise ValueError('unsupported trace version %d' % ver)
+
+    rec_fmt = endian + REC_FMT
+    if rec_size < struct.calcsize(rec_fmt):
+        raise ValueError('record size %d too small' % rec_size)
+
+    off  = struct.calcsize(hdr_fmt)
+    recs = {}
+    for ix in range(rec_nbr):
+        if (off + rec_size) > len(data):
+            break
+        rec  = TraceRec(struct.unpack_from(rec_fmt, data, off))
+        off += rec_size
+        if rec.seq == 0:                                        # Empty or torn record.
+            continue
+        recs[rec.seq] = rec
+
+    return ts_freq, [recs[seq] for seq in sorted(recs)]
+
+
+def urb_build(recs):
+    """Group records by URB. Returns a list of dicts {evt: rec}, in submission order."""
+    urbs  = {}
+    order = []
+    for rec in recs:
+        if rec.urb_id == 0:
+            continue
+        urb = urbs.get(rec.urb_id)
+        if urb is None:
+            if rec.evt != EVT_SUBMIT:                           # Submit record was overwritten.
+                continue
+            urb = {}
+            urbs[rec.urb_id] = urb
+            order.append(rec.urb_id)
+        if rec.evt not in urb:
+            urb[rec.evt] = rec
+    return [urbs[urb_id] for urb_id in order]
+
+
+def ts_diff(start, end):
+    return (end - start) & 0xFFFFFFFF
+
+
+def percentile(sorted_vals, pct):
+    if not sorted_vals:
+        return 0
+    ix = int(round((pct / 100.0) * (len(sorted_vals) - 1)))
+    return sorted_vals[ix]
+
+
+def hist_print(name, vals, unit, width):
+    vals = sorted(vals)
+    print('%s: %d samples' % (name, len(vals)))
+    if not vals:
+        print('')
+        return
+
+    line = '  min %s' % fmt_val(vals[0], unit)
+    for pct in PERCENTILES:
+        line += '  p%s %s' % (('%g' % pct), fmt_val(percentile(vals, pct), unit))
+    line += '  max %s' % fmt_val(vals[-1], unit)
+    print(line)
+
+    buckets = {}
+    for val in vals:
+        bucket = val.bit_length()                               # Bucket n holds [2^(n-1), 2^n).
+        buckets[bucket] = buckets.get(bucket, 0) + 1
+
+    cnt_max = max(buckets.values())
+    for bucket in range(min(buckets), max(buckets) + 1):
+        cnt = buckets.get(bucket, 0)
+        lo  = 0 if bucket == 0 else (1 << (bucket - 1))
+        hi  = (1 << bucket) - 1
+        bar = '#' * int(round(float(cnt) * width / cnt_max))
+        print('  %12s .. %-12s %8d  %s' % (fmt_val(lo, unit), fmt_val(hi, unit), cnt, bar))
+    print('')
+
+
+def fmt_val(val, unit):
+    if unit is None:
+        return '%d' % val
+    return '%.1f%s' % (val * unit, 'us')
+
+
+def ep_key(rec):
+    return (rec.dev_addr, rec.ep_addr)
+
+
+def ep_name(key):
+    dev_addr, ep_addr = key
+    return 'dev %d ep 0x%02X' % (dev_addr, ep_addr)
+
+
+def report(urbs, unit, width, top):
+    for step, evt_start, evt_end in STEPS:
+        vals = [ts_diff(urb[evt_start].ts, urb[evt_end].ts)
+                for urb in urbs
+                if (evt_start in urb) and (evt_end in urb)]
+        hist_print(step, vals, unit, width)
+
+    if top > 0:
+        worst = [(ts_diff(urb[EVT_SUBMIT].ts, urb[EVT_NOTIFY].ts), urb)
+                 for urb in urbs
+                 if EVT_NOTIFY in urb]
+        worst.sort(key=lambda item: item[0], reverse=True)
+        print('slowest URBs:')
+        for total, urb in worst[:top]:
+            sub  = urb[EVT_SUBMIT]
+            line = '  id %-8d %s %-5s len %-6d total %s' % (sub.urb_id,
+                                                             ep_name(ep_key(sub)),
+                                                             TOKEN_NAMES.get(sub.token, '?'),
+                                                             sub.len,
+                                                             fmt_val(total, unit))
+            for step, evt_start, evt_end in STEPS[:-1]:
+                if (evt_start in urb) and (evt_end in urb):
+                    line += '  %s %s' % (step, fmt_val(ts_diff(urb[evt_start].ts, urb[evt_end].ts), unit))
+            if urb[EVT_NOTIFY].err != 0:
+                line += '  err %d' % urb[EVT_NOTIFY].err
+            print(line)
+        print('')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a uC/USB-Host transfer trace dump.')
+    parser.add_argument('dump', help='binary file written from USBH_TraceDump() output')
+    parser.add_argument('--freq', type=int, default=None,
+                        help='timestamp frequency in Hz, overrides the value stored in the dump')
+    parser.add_argument('--ticks', action='store_true', help='print raw timestamp ticks')
+    parser.add_argument('--dev', type=int, default=None, help='only keep URBs of this device address')
+    parser.add_argument('--ep', type=lambda x: int(x, 0), default=None,
+                        help='only keep URBs of this endpoint address (e.g. 0x81)')
+    parser.add_argument('--by-ep', action='store_true', help='print one set of histograms per endpoint')
+    parser.add_argument('--top', type=int, default=10, help='number of slowest URBs to list')
+    parser.add_argument('--width', type=int, default=40, help='width of histogram bars')
+    parser.add_argument('--raw', action='store_true', help='print every record')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        data = f.read()
+
+    try:
+        ts_freq, recs = dump_parse(data)
+    except ValueError as e:
+        sys.stderr.write('%s: %s\n' % (args.dump, e))
+        return 1
+
+    if args.freq is not None:
+        ts_freq = args.freq
+
+    unit = None
+    if (ts_freq != 0) and (args.ticks is False):
+        unit = 1000000.0 / ts_freq
+
+    print('%d records, seq %d .. %d, timestamp freq %s' % (len(recs),
+                                                           recs[0].seq if recs else 0,
+                                                           recs[-1].seq if recs else 0,
+                                                           ('%d Hz' % ts_freq) if ts_freq else 'unknown'))
+    print('')
+
+    if args.raw:
+        for rec in recs:
+            print('%10d %10d id %-8d %-8s %s %-5s len %-6d err %d' % (rec.seq,
+                                                                   rec.ts,
+                                                                   rec.urb_id,
+                                                                   EVT_NAMES.get(rec.evt, '?'),
+                                                                   ep_name(ep_key(rec)),
+                                                                   TOKEN_NAMES.get(rec.token, '?'),
+                                                                   rec.len,
+                                                                   rec.err))
+        print('')
+
+    urbs = urb_build(recs)
+    if args.dev is not None:
+        urbs = [urb for urb in urbs if urb[EVT_SUBMIT].dev_addr == args.dev]
+    if args.ep is not None:
+        urbs = [urb for urb in urbs if urb[EVT_SUBMIT].ep_addr == args.ep]
+
+    if args.by_ep:
+        keys = sorted(set(ep_key(urb[EVT_SUBMIT]) for urb in urbs))
+        for key in keys:
+            print('==== %s ====' % ep_name(key))
+            report([urb for urb in urbs if ep_key(urb[EVT_SUBMIT]) == key], unit, args.width, args.top)
+    else:
+        report(urbs, unit, args.width, args.top)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())